@@ -8,8 +8,34 @@
 # coreSNTP library source files.
 set( CORE_SNTP_SOURCES
      "${CMAKE_CURRENT_LIST_DIR}/source/core_sntp_serializer.c"
-     "${CMAKE_CURRENT_LIST_DIR}/source/core_sntp_client.c" )
+     "${CMAKE_CURRENT_LIST_DIR}/source/core_sntp_fixed_point.c"
+     "${CMAKE_CURRENT_LIST_DIR}/source/core_sntp_math.c"
+     "${CMAKE_CURRENT_LIST_DIR}/source/core_sntp_client.c"
+     "${CMAKE_CURRENT_LIST_DIR}/source/core_sntp_clock.c"
+     "${CMAKE_CURRENT_LIST_DIR}/source/core_sntp_filter.c"
+     "${CMAKE_CURRENT_LIST_DIR}/source/core_sntp_stability.c"
+     "${CMAKE_CURRENT_LIST_DIR}/source/core_sntp_batch.c"
+     "${CMAKE_CURRENT_LIST_DIR}/source/core_sntp_histogram.c"
+     "${CMAKE_CURRENT_LIST_DIR}/source/core_sntp_metrics.c"
+     "${CMAKE_CURRENT_LIST_DIR}/source/core_sntp_poll_planner.c"
+     "${CMAKE_CURRENT_LIST_DIR}/source/core_sntp_timeout.c"
+     "${CMAKE_CURRENT_LIST_DIR}/source/core_sntp_health.c" )
+
+# Single translation unit that includes all of the coreSNTP library source
+# files. Build it instead of CORE_SNTP_SOURCES to let the compiler inline the
+# functions of the modules across files without link-time optimization.
+set( CORE_SNTP_AMALGAMATION_SOURCES
+     "${CMAKE_CURRENT_LIST_DIR}/source/core_sntp_amalgamation.c" )
 
 # coreSNTP library Public Include directories.
 set( CORE_SNTP_INCLUDE_PUBLIC_DIRS
      "${CMAKE_CURRENT_LIST_DIR}/source/include" )
+
+# Reference clock discipline backend for Linux. These files are not part of the
+# portable library, and are only built for Linux targets.
+set( CORE_SNTP_LINUX_CLOCK_SOURCES
+     "${CMAKE_CURRENT_LIST_DIR}/source/portable/linux/core_sntp_linux_clock.c" )
+
+# Include directory of the Linux clock backend.
+set( CORE_SNTP_LINUX_CLOCK_INCLUDE_DIRS
+     "${CMAKE_CURRENT_LIST_DIR}/source/portable/linux" )
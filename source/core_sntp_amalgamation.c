@@ -0,0 +1,50 @@
+/*
+ * coreSNTP v1.0.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file core_sntp_amalgamation.c
+ * @brief Single translation unit of the coreSNTP library.
+ *
+ * This file includes every source file of the library, so that the library can
+ * be built as one translation unit instead of the individual source files. The
+ * compiler can then inline the functions that the modules call in each other,
+ * such as the serializer and fixed-point functions called by the client, without
+ * link-time optimization.
+ *
+ * @note Build either this file or the individual source files, but not both.
+ * The static functions and macros of the source files have unique names, or
+ * identical definitions, so that the files can be combined.
+ */
+
+#include "core_sntp_serializer.c"
+#include "core_sntp_fixed_point.c"
+#include "core_sntp_math.c"
+#include "core_sntp_client.c"
+#include "core_sntp_clock.c"
+#include "core_sntp_filter.c"
+#include "core_sntp_stability.c"
+#include "core_sntp_batch.c"
+#include "core_sntp_histogram.c"
+#include "core_sntp_metrics.c"
+#include "core_sntp_poll_planner.c"
+#include "core_sntp_timeout.c"
+#include "core_sntp_health.c"
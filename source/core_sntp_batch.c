@@ -0,0 +1,295 @@
+/*
+ * coreSNTP v1.0.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file core_sntp_batch.c
+ * @brief Implementation of the batch timestamp conversion API of the coreSNTP
+ * library.
+ */
+
+/* Standard includes. */
+#include <assert.h>
+
+/* Include API header. */
+#include "core_sntp_batch.h"
+
+#if !defined( SNTP_BATCH_DISABLE_SIMD ) && defined( __AVX2__ )
+    #include <immintrin.h>
+    #define BATCH_VECTOR_KERNEL
+#elif !defined( SNTP_BATCH_DISABLE_SIMD ) && defined( __ARM_NEON )
+    #include <arm_neon.h>
+    #define BATCH_VECTOR_KERNEL
+#endif
+
+/**
+ * @brief The number of nanoseconds in a second.
+ */
+#define NANOSECONDS_PER_SECOND    ( 1000000000U )
+
+/**
+ * @brief The value of 2^31, half the range of SNTP timestamp seconds.
+ */
+#define HALF_SNTP_ERA_SECS        ( 0x80000000U )
+
+/**
+ * @brief Converts an SNTP timestamp to UNIX time in nanoseconds, with the same
+ * arithmetic as @ref Sntp_ConvertToUnixTime64.
+ *
+ * @param[in] pSntpTime The SNTP timestamp to convert.
+ * @param[in] pivotUnixTimeSecs The pivot time, in seconds of UNIX time.
+ * @param[in] pivotSntpSecs The seconds of the SNTP timestamp of the pivot time.
+ *
+ * @return The UNIX time in nanoseconds.
+ */
+static int64_t convertToUnixNanosecs( const SntpTimestamp_t * pSntpTime,
+                                      int64_t pivotUnixTimeSecs,
+                                      uint32_t pivotSntpSecs )
+{
+    uint32_t secondsFromPivot = pSntpTime->seconds - pivotSntpSecs;
+    int64_t unixTimeSecs;
+
+    if( secondsFromPivot < HALF_SNTP_ERA_SECS )
+    {
+        unixTimeSecs = pivotUnixTimeSecs + ( int64_t ) secondsFromPivot;
+    }
+    else
+    {
+        unixTimeSecs = pivotUnixTimeSecs - ( int64_t ) ( UINT32_MAX - secondsFromPivot ) - 1;
+    }
+
+    return ( unixTimeSecs * ( int64_t ) NANOSECONDS_PER_SECOND ) +
+           ( int64_t ) ( ( ( uint64_t ) pSntpTime->fractions * NANOSECONDS_PER_SECOND ) >> 32 );
+}
+
+#if defined( __AVX2__ ) && defined( BATCH_VECTOR_KERNEL )
+
+/**
+ * @brief Converts SNTP timestamps to UNIX time in nanoseconds, 4 at a time,
+ * with AVX2.
+ *
+ * The seconds are resolved against the pivot by sign extending their 32-bit
+ * modulo difference from the seconds of the pivot, which is the same as the
+ * forwards or backwards difference of @ref convertToUnixNanosecs. As AVX2 has
+ * no 64-bit multiplication, the seconds are multiplied by 10^9 in 32-bit halves,
+ * which gives the same (modulo 2^64) product.
+ *
+ * @param[in] pSntpTimes The array of SNTP timestamps to convert.
+ * @param[in] count The number of elements to convert.
+ * @param[in] pivotUnixTimeSecs The pivot time, in seconds of UNIX time.
+ * @param[in] pivotSntpSecs The seconds of the SNTP timestamp of the pivot time.
+ * @param[out] pUnixTimesNs The array to fill with UNIX times in nanoseconds.
+ *
+ * @return The number of elements converted, which is a multiple of 4.
+ */
+static size_t convertToUnixNanosecsVector( const SntpTimestamp_t * pSntpTimes,
+                                           size_t count,
+                                           int64_t pivotUnixTimeSecs,
+                                           uint32_t pivotSntpSecs,
+                                           int64_t * pUnixTimesNs )
+{
+    const __m256i pivotSecs = _mm256_set1_epi64x( pivotUnixTimeSecs );
+    const __m256i pivotSntp = _mm256_set1_epi32( ( int32_t ) pivotSntpSecs );
+    const __m256i nanosecsPerSec = _mm256_set1_epi64x( ( int64_t ) NANOSECONDS_PER_SECOND );
+    const __m256i secondsLanes = _mm256_setr_epi32( 0, 2, 4, 6, 0, 2, 4, 6 );
+    size_t index;
+
+    for( index = 0U; ( index + 4U ) <= count; index += 4U )
+    {
+        /* Each 64-bit lane holds the seconds of a timestamp in its lower half
+         * and the fractions in its upper half. */
+        __m256i timestamps = _mm256_loadu_si256( ( const __m256i * ) &pSntpTimes[ index ] );
+        __m256i secondsFromPivot = _mm256_sub_epi32( timestamps, pivotSntp );
+        __m256i unixTimeSecs;
+        __m256i nanosecs;
+        __m256i unixTimeNs;
+
+        unixTimeSecs = _mm256_add_epi64( pivotSecs,
+                                         _mm256_cvtepi32_epi64( _mm256_castsi256_si128(
+                                                                    _mm256_permutevar8x32_epi32( secondsFromPivot, secondsLanes ) ) ) );
+        nanosecs = _mm256_srli_epi64( _mm256_mul_epu32( _mm256_srli_epi64( timestamps, 32 ), nanosecsPerSec ), 32 );
+        unixTimeNs = _mm256_add_epi64( _mm256_mul_epu32( unixTimeSecs, nanosecsPerSec ),
+                                       _mm256_slli_epi64( _mm256_mul_epu32( _mm256_srli_epi64( unixTimeSecs, 32 ),
+                                                                            nanosecsPerSec ), 32 ) );
+
+        _mm256_storeu_si256( ( __m256i * ) &pUnixTimesNs[ index ], _mm256_add_epi64( unixTimeNs, nanosecs ) );
+    }
+
+    return index;
+}
+
+#elif defined( __ARM_NEON ) && defined( BATCH_VECTOR_KERNEL )
+
+/**
+ * @brief Converts 2 SNTP timestamps, already resolved to their modulo difference
+ * from the seconds of the pivot, to UNIX time in nanoseconds with NEON.
+ *
+ * @param[in] secondsFromPivot The modulo differences of the seconds of the
+ * timestamps from the seconds of the pivot.
+ * @param[in] fractions The fractions of the timestamps.
+ * @param[in] pivotSecs The pivot time, in seconds of UNIX time, in both lanes.
+ *
+ * @return The UNIX times in nanoseconds.
+ */
+static int64x2_t convertPairToUnixNanosecs( int32x2_t secondsFromPivot,
+                                            uint32x2_t fractions,
+                                            int64x2_t pivotSecs )
+{
+    const uint32x2_t nanosecsPerSec = vdup_n_u32( NANOSECONDS_PER_SECOND );
+    uint64x2_t unixTimeSecs;
+    uint64x2_t unixTimeNs;
+    uint64x2_t nanosecs;
+
+    unixTimeSecs = vreinterpretq_u64_s64( vaddq_s64( pivotSecs, vmovl_s32( secondsFromPivot ) ) );
+    nanosecs = vshrq_n_u64( vmull_u32( fractions, nanosecsPerSec ), 32 );
+    unixTimeNs = vaddq_u64( vmull_u32( vmovn_u64( unixTimeSecs ), nanosecsPerSec ),
+                            vshlq_n_u64( vmull_u32( vshrn_n_u64( unixTimeSecs, 32 ), nanosecsPerSec ), 32 ) );
+
+    return vreinterpretq_s64_u64( vaddq_u64( unixTimeNs, nanosecs ) );
+}
+
+/**
+ * @brief Converts SNTP timestamps to UNIX time in nanoseconds, 4 at a time,
+ * with NEON.
+ *
+ * The seconds are resolved against the pivot by sign extending their 32-bit
+ * modulo difference from the seconds of the pivot, which is the same as the
+ * forwards or backwards difference of @ref convertToUnixNanosecs. As NEON has
+ * no 64-bit multiplication, the seconds are multiplied by 10^9 in 32-bit halves,
+ * which gives the same (modulo 2^64) product.
+ *
+ * @param[in] pSntpTimes The array of SNTP timestamps to convert.
+ * @param[in] count The number of elements to convert.
+ * @param[in] pivotUnixTimeSecs The pivot time, in seconds of UNIX time.
+ * @param[in] pivotSntpSecs The seconds of the SNTP timestamp of the pivot time.
+ * @param[out] pUnixTimesNs The array to fill with UNIX times in nanoseconds.
+ *
+ * @return The number of elements converted, which is a multiple of 4.
+ */
+static size_t convertToUnixNanosecsVector( const SntpTimestamp_t * pSntpTimes,
+                                           size_t count,
+                                           int64_t pivotUnixTimeSecs,
+                                           uint32_t pivotSntpSecs,
+                                           int64_t * pUnixTimesNs )
+{
+    const int64x2_t pivotSecs = vdupq_n_s64( pivotUnixTimeSecs );
+    const uint32x4_t pivotSntp = vdupq_n_u32( pivotSntpSecs );
+    size_t index;
+
+    for( index = 0U; ( index + 4U ) <= count; index += 4U )
+    {
+        /* De-interleave the seconds and fractions of the timestamps. */
+        uint32x4x2_t timestamps = vld2q_u32( &pSntpTimes[ index ].seconds );
+        int32x4_t secondsFromPivot = vreinterpretq_s32_u32( vsubq_u32( timestamps.val[ 0 ], pivotSntp ) );
+
+        vst1q_s64( &pUnixTimesNs[ index ],
+                   convertPairToUnixNanosecs( vget_low_s32( secondsFromPivot ),
+                                              vget_low_u32( timestamps.val[ 1 ] ),
+                                              pivotSecs ) );
+        vst1q_s64( &pUnixTimesNs[ index + 2U ],
+                   convertPairToUnixNanosecs( vget_high_s32( secondsFromPivot ),
+                                              vget_high_u32( timestamps.val[ 1 ] ),
+                                              pivotSecs ) );
+    }
+
+    return index;
+}
+
+#endif /* if defined( __AVX2__ ) && defined( BATCH_VECTOR_KERNEL ) */
+
+SntpStatus_t Sntp_ConvertToUnixNanosecsBatch( const SntpTimestamp_t * pSntpTimes,
+                                              size_t count,
+                                              int64_t pivotUnixTimeSecs,
+                                              int64_t * pUnixTimesNs )
+{
+    SntpStatus_t status = SntpSuccess;
+
+    if( ( ( count > 0U ) && ( ( pSntpTimes == NULL ) || ( pUnixTimesNs == NULL ) ) ) ||
+        ( pivotUnixTimeSecs > SNTP_MAX_BATCH_PIVOT_UNIX_SECS ) ||
+        ( pivotUnixTimeSecs < -SNTP_MAX_BATCH_PIVOT_UNIX_SECS ) )
+    {
+        status = SntpErrorBadParameter;
+    }
+    else
+    {
+        uint32_t pivotSntpSecs = ( uint32_t ) ( ( uint64_t ) pivotUnixTimeSecs + SNTP_TIME_AT_UNIX_EPOCH_SECS );
+        size_t index = 0U;
+
+        #ifdef BATCH_VECTOR_KERNEL
+            index = convertToUnixNanosecsVector( pSntpTimes, count, pivotUnixTimeSecs,
+                                                 pivotSntpSecs, pUnixTimesNs );
+        #endif
+
+        /* Convert the elements left over by the vector kernel, if any. */
+        for( ; index < count; index++ )
+        {
+            pUnixTimesNs[ index ] = convertToUnixNanosecs( &pSntpTimes[ index ],
+                                                           pivotUnixTimeSecs,
+                                                           pivotSntpSecs );
+        }
+    }
+
+    return status;
+}
+
+SntpStatus_t Sntp_ConvertFromUnixNanosecsBatch( const int64_t * pUnixTimesNs,
+                                                size_t count,
+                                                SntpTimestamp_t * pSntpTimes )
+{
+    SntpStatus_t status = SntpSuccess;
+    size_t index;
+
+    if( ( count > 0U ) && ( ( pUnixTimesNs == NULL ) || ( pSntpTimes == NULL ) ) )
+    {
+        status = SntpErrorBadParameter;
+    }
+    else
+    {
+        for( index = 0U; index < count; index++ )
+        {
+            int64_t unixTimeSecs;
+            uint32_t unixTimeNanosecs;
+
+            if( pUnixTimesNs[ index ] >= 0 )
+            {
+                unixTimeSecs = pUnixTimesNs[ index ] / ( int64_t ) NANOSECONDS_PER_SECOND;
+                unixTimeNanosecs = ( uint32_t ) ( pUnixTimesNs[ index ] % ( int64_t ) NANOSECONDS_PER_SECOND );
+            }
+            else
+            {
+                /* Round the seconds of negative times down, with the magnitude
+                 * of ( time + 1 ), which does not overflow for INT64_MIN. */
+                uint64_t magnitude = ( uint64_t ) ( -( pUnixTimesNs[ index ] + 1 ) );
+
+                unixTimeSecs = -( int64_t ) ( magnitude / NANOSECONDS_PER_SECOND ) - 1;
+                unixTimeNanosecs = ( NANOSECONDS_PER_SECOND - 1U ) -
+                                   ( uint32_t ) ( magnitude % NANOSECONDS_PER_SECOND );
+            }
+
+            /* The nanoseconds are always below a second, so the conversion
+             * cannot fail. */
+            status = Sntp_ConvertFromUnixTime64( unixTimeSecs, unixTimeNanosecs, &pSntpTimes[ index ] );
+            assert( status == SntpSuccess );
+        }
+    }
+
+    return status;
+}
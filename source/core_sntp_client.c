@@ -31,6 +31,1169 @@
 
 /* SNTP client library API include. */
 #include "core_sntp_client.h"
+#include "core_sntp_fixed_point.h"
+
+/**
+ * @brief The credit of a whole hedged request, in the percentage units of
+ * #SntpContext_t.maxHedgePercent.
+ */
+#define HEDGE_REQUEST_CREDIT          ( 100U )
+
+/**
+ * @brief The offset basis of the 32-bit FNV-1a hash.
+ */
+#define FNV_OFFSET_BASIS              ( 0x811C9DC5U )
+
+/**
+ * @brief The prime of the 32-bit FNV-1a hash.
+ */
+#define FNV_PRIME                     ( 0x01000193U )
+
+/**
+ * @brief The offset of the "originate timestamp" in an SNTP packet.
+ */
+#define ORIGINATE_TIMESTAMP_OFFSET    ( 24U )
+
+#ifdef SNTP_ENABLE_TRACING
+
+/**
+ * @brief Timestamps an event of a time request and passes it to the trace
+ * function of the context, if any.
+ *
+ * @param[in] pContext The SNTP client context.
+ * @param[in] type The type of the event.
+ * @param[in] pServer The server of the request.
+ * @param[in] status The status of the event.
+ * @param[in] packetSize The size of the request or response.
+ * @param[in] rejectedResponseCode The Kiss-o'-Death code of the response.
+ */
+    static void traceEvent( const SntpContext_t * pContext,
+                            SntpTraceEventType_t type,
+                            const SntpServerInfo_t * pServer,
+                            SntpStatus_t status,
+                            size_t packetSize,
+                            uint32_t rejectedResponseCode )
+    {
+        SntpTraceEvent_t event;
+
+        assert( pContext != NULL );
+
+        if( pContext->traceFunc != NULL )
+        {
+            event.type = type;
+            event.pServer = pServer;
+            event.status = status;
+            event.packetSize = packetSize;
+            event.rejectedResponseCode = rejectedResponseCode;
+
+            if( pContext->getTimeFunc( &event.time ) == false )
+            {
+                event.time.seconds = 0U;
+                event.time.fractions = 0U;
+            }
+
+            pContext->traceFunc( pContext->pTraceContext, &event );
+        }
+    }
+
+/**
+ * @brief Traces an event of a time request.
+ */
+    #define TRACE_EVENT( pContext, type, pServer, status, packetSize, rejectedResponseCode ) \
+    traceEvent( ( pContext ), ( type ), ( pServer ), ( status ), ( packetSize ), ( rejectedResponseCode ) )
+#else
+
+/**
+ * @brief Tracing compiles to nothing when the library is built without
+ * `SNTP_ENABLE_TRACING`.
+ */
+    #define TRACE_EVENT( pContext, type, pServer, status, packetSize, rejectedResponseCode )
+#endif /* ifdef SNTP_ENABLE_TRACING */
+
+/**
+ * @brief Calculates the identifier of a server for its health, with the FNV-1a
+ * hash of its name and port.
+ *
+ * @param[in] pServer The server.
+ *
+ * @return The identifier of the server.
+ */
+static uint32_t hashServerName( const SntpServerInfo_t * pServer )
+{
+    uint32_t hash = FNV_OFFSET_BASIS;
+    size_t index;
+
+    assert( pServer != NULL );
+    assert( pServer->pServerName != NULL );
+
+    for( index = 0U; pServer->pServerName[ index ] != '\0'; index++ )
+    {
+        hash = ( hash ^ ( uint8_t ) pServer->pServerName[ index ] ) * FNV_PRIME;
+    }
+
+    hash = ( hash ^ ( uint8_t ) ( pServer->port >> 8 ) ) * FNV_PRIME;
+    hash = ( hash ^ ( uint8_t ) pServer->port ) * FNV_PRIME;
+
+    return hash;
+}
+
+/**
+ * @brief Selects the server to use after the current server, which is the
+ * healthiest other server if server health is set, or the next server in the
+ * list otherwise.
+ *
+ * @param[in] pContext The SNTP client context.
+ *
+ * @return The index of the selected server.
+ */
+static size_t selectNextServer( const SntpContext_t * pContext )
+{
+    size_t serverIndex;
+
+    assert( pContext != NULL );
+
+    if( pContext->pServerHealth != NULL )
+    {
+        /* The parameters are valid, so the selection cannot fail. */
+        ( void ) Sntp_SelectHealthiestServer( pContext->pServerHealth, pContext->numOfServers,
+                                              pContext->currentServerIndex, &serverIndex );
+    }
+    else
+    {
+        serverIndex = ( pContext->currentServerIndex + 1U ) % pContext->numOfServers;
+    }
+
+    return serverIndex;
+}
+
+/**
+ * @brief Records the outcome of a time request in the health of its server, if
+ * server health is set.
+ *
+ * @param[in, out] pContext The SNTP client context.
+ * @param[in] serverIndex The index of the server of the request.
+ * @param[in] status The outcome of the request.
+ * @param[in] roundTripDelayFractions The round-trip delay of a valid response.
+ */
+static void recordServerHealth( SntpContext_t * pContext,
+                                size_t serverIndex,
+                                SntpStatus_t status,
+                                int64_t roundTripDelayFractions )
+{
+    assert( pContext != NULL );
+    assert( serverIndex < pContext->numOfServers );
+
+    if( pContext->pServerHealth != NULL )
+    {
+        /* The parameters are valid, so the health cannot fail to update. */
+        ( void ) Sntp_RecordServerHealth( &pContext->pServerHealth[ serverIndex ], status,
+                                          roundTripDelayFractions );
+    }
+}
+
+/**
+ * @brief Configures a server for subsequent requests, and resets the state that
+ * represents the network path to the previous server.
+ *
+ * @param[in, out] pContext The SNTP client context.
+ * @param[in] serverIndex The index of the server.
+ */
+static void changeServer( SntpContext_t * pContext,
+                          size_t serverIndex )
+{
+    assert( pContext != NULL );
+    assert( serverIndex < pContext->numOfServers );
+
+    pContext->currentServerIndex = serverIndex;
+
+    LogInfo( ( "Using next time server for requests: Server=%s",
+               pContext->pTimeServers[ serverIndex ].pServerName ) );
+
+    if( pContext->pOutlierGate != NULL )
+    {
+        /* The samples of the previous server do not represent the delay to the
+         * next server. */
+        ( void ) Sntp_ResetOutlierGate( pContext->pOutlierGate );
+    }
+
+    if( pContext->pStabilityEstimator != NULL )
+    {
+        /* The clock offsets measured with the next server are offset by the
+         * difference in the network path asymmetry of the servers. */
+        ( void ) Sntp_MarkStabilityDiscontinuity( pContext->pStabilityEstimator );
+    }
+}
+
+/**
+ * @brief Selects the healthiest server for the next time request, if server
+ * health is set.
+ *
+ * The first request after the health is set uses the healthiest server. Later
+ * requests only switch to it if its score exceeds the score of the current
+ * server by #SNTP_HEALTH_SWITCH_MARGIN, so that servers of similar health are
+ * not alternated.
+ *
+ * @param[in, out] pContext The SNTP client context.
+ */
+static void selectHealthiestServer( SntpContext_t * pContext )
+{
+    size_t serverIndex;
+    uint32_t score = 0U;
+    uint32_t currentScore = 0U;
+
+    assert( pContext != NULL );
+
+    if( pContext->pServerHealth != NULL )
+    {
+        /* The parameters are valid, so the health calls cannot fail. */
+        ( void ) Sntp_SelectHealthiestServer( pContext->pServerHealth, pContext->numOfServers,
+                                              pContext->numOfServers, &serverIndex );
+
+        if( pContext->isServerSelectionPending == true )
+        {
+            /* The health of the servers, which may have been restored, is known
+             * from the first request after it is set. */
+            pContext->currentServerIndex = serverIndex;
+            pContext->isServerSelectionPending = false;
+        }
+        else if( serverIndex != pContext->currentServerIndex )
+        {
+            ( void ) Sntp_GetServerHealthScore( &pContext->pServerHealth[ serverIndex ], &score );
+            ( void ) Sntp_GetServerHealthScore( &pContext->pServerHealth[ pContext->currentServerIndex ],
+                                                &currentScore );
+
+            if( score > ( currentScore + SNTP_HEALTH_SWITCH_MARGIN ) )
+            {
+                changeServer( pContext, serverIndex );
+            }
+        }
+        else
+        {
+            /* Empty else MISRA 15.7 */
+        }
+    }
+}
+
+/**
+ * @brief Handles the failure of a time request to the current server by
+ * configuring the next server in the list, or the healthiest other server, for
+ * subsequent requests.
+ *
+ * When requests to all the configured servers have failed consecutively, the
+ * virtual clock of the context (if any) is put in holdover.
+ *
+ * @param[in, out] pContext The SNTP client context.
+ */
+static void handleServerFailure( SntpContext_t * pContext )
+{
+    assert( pContext != NULL );
+
+    changeServer( pContext, selectNextServer( pContext ) );
+
+    if( pContext->consecutiveServerFailures < pContext->numOfServers )
+    {
+        pContext->consecutiveServerFailures++;
+    }
+
+    if( ( pContext->consecutiveServerFailures == pContext->numOfServers ) &&
+        ( pContext->pVirtualClock != NULL ) )
+    {
+        /* An unsynchronized virtual clock cannot enter holdover, and remains
+         * unsynchronized. */
+        ( void ) Sntp_EnterVirtualClockHoldover( pContext->pVirtualClock );
+    }
+}
+
+/**
+ * @brief Reads the response timeout of a server, from its timeout estimator if
+ * one is set.
+ *
+ * @param[in] pContext The SNTP client context.
+ * @param[in] serverIndex The index of the server.
+ * @param[in] responseTimeoutMs The response timeout, in milliseconds, passed
+ * by the application.
+ *
+ * @return The response timeout of the server, in milliseconds.
+ */
+static uint32_t getResponseTimeout( const SntpContext_t * pContext,
+                                    size_t serverIndex,
+                                    uint32_t responseTimeoutMs )
+{
+    uint32_t timeoutMs = responseTimeoutMs;
+
+    assert( pContext != NULL );
+    assert( serverIndex < pContext->numOfServers );
+
+    if( pContext->pTimeoutEstimators != NULL )
+    {
+        /* The parameters are valid, so the estimator call cannot fail. */
+        ( void ) Sntp_GetResponseTimeout( &pContext->pTimeoutEstimators[ serverIndex ],
+                                          responseTimeoutMs, &timeoutMs );
+    }
+
+    return timeoutMs;
+}
+
+/**
+ * @brief Checks whether the response timeout has expired since sending a
+ * request.
+ *
+ * @param[in] pRequestTime The system time of sending the request.
+ * @param[in] pCurrentTime The current system time.
+ * @param[in] responseTimeoutMs The response timeout in milliseconds.
+ *
+ * @return `true` if the response timeout has expired; `false` otherwise.
+ */
+static bool isResponseTimeoutExpired( const SntpTimestamp_t * pRequestTime,
+                                      const SntpTimestamp_t * pCurrentTime,
+                                      uint32_t responseTimeoutMs )
+{
+    uint64_t elapsedTime;
+    uint64_t timeout;
+
+    assert( pRequestTime != NULL );
+    assert( pCurrentTime != NULL );
+
+    /* The elapsed time is treated as a magnitude so that a step of system time
+     * in either direction does not leave the request waiting indefinitely. */
+    elapsedTime = Sntp_FixedFromTimestamp( *pCurrentTime ) - Sntp_FixedFromTimestamp( *pRequestTime );
+
+    if( elapsedTime > ( ( uint64_t ) 1 << 63 ) )
+    {
+        elapsedTime = 0U - elapsedTime;
+    }
+
+    timeout = ( uint64_t ) Sntp_FixedFromNanoseconds( ( int64_t ) responseTimeoutMs * 1000000 );
+
+    return ( elapsedTime >= timeout ) ? true : false;
+}
+
+/**
+ * @brief Calculates the time remaining until a time since sending a request.
+ *
+ * @param[in] pRequestTime The system time of sending the request.
+ * @param[in] pCurrentTime The current system time.
+ * @param[in] timeSinceRequest The time since sending the request, in units of
+ * SNTP timestamp fractions.
+ *
+ * @return The remaining time in milliseconds, rounded up, or zero if the time
+ * has passed or system time has stepped back before the request.
+ */
+static uint32_t getRemainingTimeMs( const SntpTimestamp_t * pRequestTime,
+                                    const SntpTimestamp_t * pCurrentTime,
+                                    uint64_t timeSinceRequest )
+{
+    uint64_t elapsedTime;
+    uint64_t remainingMs = 0U;
+
+    assert( pRequestTime != NULL );
+    assert( pCurrentTime != NULL );
+
+    elapsedTime = Sntp_FixedFromTimestamp( *pCurrentTime ) - Sntp_FixedFromTimestamp( *pRequestTime );
+
+    /* The elapsed time is a magnitude, as in isResponseTimeoutExpired. */
+    if( elapsedTime > ( ( uint64_t ) 1 << 63 ) )
+    {
+        elapsedTime = 0U - elapsedTime;
+    }
+
+    if( elapsedTime < timeSinceRequest )
+    {
+        remainingMs = ( ( uint64_t ) Sntp_FixedToNanoseconds( ( int64_t ) ( timeSinceRequest - elapsedTime ) ) +
+                        999999U ) / 1000000U;
+    }
+
+    return ( remainingMs > UINT32_MAX ) ? UINT32_MAX : ( uint32_t ) remainingMs;
+}
+
+/**
+ * @brief Records a valid server response in the histograms of its server.
+ *
+ * @param[in, out] pContext The SNTP client context, with histograms set.
+ * @param[in] serverIndex The index of the server of the response.
+ * @param[in] pRequestTime The system time of sending the request.
+ * @param[in] pResponseRxTime The system time of receiving the response.
+ * @param[in] pParsedResponse The parsed response.
+ * @param[in] isOffsetValid Whether the clock offset of the response could be
+ * calculated.
+ */
+static void recordServerHistograms( SntpContext_t * pContext,
+                                    size_t serverIndex,
+                                    const SntpTimestamp_t * pRequestTime,
+                                    const SntpTimestamp_t * pResponseRxTime,
+                                    const SntpResponseData_t * pParsedResponse,
+                                    bool isOffsetValid )
+{
+    SntpServerHistograms_t * pHistograms;
+    uint64_t latency;
+
+    assert( pContext != NULL );
+    assert( pContext->pServerHistograms != NULL );
+    assert( pRequestTime != NULL );
+    assert( pResponseRxTime != NULL );
+    assert( pParsedResponse != NULL );
+
+    pHistograms = &pContext->pServerHistograms[ serverIndex ];
+    latency = Sntp_FixedFromTimestamp( *pResponseRxTime ) - Sntp_FixedFromTimestamp( *pRequestTime );
+
+    /* The parameters are valid, so the histogram calls cannot fail. */
+    ( void ) Sntp_RecordHistogramDuration( &pHistograms->roundTripDelay,
+                                           pParsedResponse->roundTripDelayFractions );
+
+    if( isOffsetValid == true )
+    {
+        ( void ) Sntp_RecordHistogramDuration( &pHistograms->clockOffset,
+                                               pParsedResponse->clockOffsetFractions );
+    }
+
+    /* The latency is not measured across a backward step of system time. */
+    if( latency < ( ( uint64_t ) 1 << 63 ) )
+    {
+        ( void ) Sntp_RecordHistogramDuration( &pHistograms->responseLatency, ( int64_t ) latency );
+    }
+}
+
+/**
+ * @brief Processes an SNTP response received from the current server, or from
+ * the server of the hedged request.
+ *
+ * A hedged response does not update the outlier gate or the stability
+ * estimator, which represent the network path to the current server, and its
+ * rejection does not change the current server.
+ *
+ * @param[in, out] pContext The SNTP client context.
+ * @param[in] serverIndex The index of the server of the response.
+ * @param[in] isHedgedResponse Whether the response is of the hedged request.
+ * @param[in] responseSize The size of the response in the network buffer.
+ *
+ * @return The status of processing the response, as documented for the
+ * @ref Sntp_ReceiveTimeResponse API.
+ */
+static SntpStatus_t processServerResponse( SntpContext_t * pContext,
+                                           size_t serverIndex,
+                                           bool isHedgedResponse,
+                                           size_t responseSize )
+{
+    SntpStatus_t status = SntpSuccess;
+    const SntpServerInfo_t * pServer;
+    const SntpTimestamp_t * pRequestTime;
+    SntpTimestamp_t responseRxTime;
+    SntpResponseData_t parsedResponse;
+
+    assert( pContext != NULL );
+    assert( serverIndex < pContext->numOfServers );
+
+    pServer = &pContext->pTimeServers[ serverIndex ];
+    pRequestTime = ( isHedgedResponse == true ) ? &pContext->hedgeRequestTime : &pContext->lastRequestTime;
+
+    if( responseSize < SNTP_PACKET_BASE_SIZE )
+    {
+        SNTP_LOG_RATE_LIMITED( LogWarn, ( "Response is smaller than an SNTP packet: Server=%s, "
+                                          "ResponseSize=%lu", pServer->pServerName,
+                                          ( unsigned long ) responseSize ) );
+        status = SntpErrorBufferTooSmall;
+    }
+    else if( pContext->getTimeFunc( &responseRxTime ) == false )
+    {
+        LogError( ( "Failed to get system time when receiving response from server" ) );
+        status = SntpErrorSystemClockFailure;
+    }
+    else if( pContext->authIntf.validateServer != NULL )
+    {
+        status = pContext->authIntf.validateServer( pContext->authIntf.pAuthContext,
+                                                    pServer->pServerName,
+                                                    pContext->pNetworkBuffer,
+                                                    responseSize );
+
+        if( status != SntpSuccess )
+        {
+            SNTP_LOG_RATE_LIMITED( LogWarn, ( "Server response failed authentication: Server=%s, "
+                                              "Status=%d", pServer->pServerName, ( int ) status ) );
+        }
+    }
+    else
+    {
+        /* Empty else MISRA 15.7 */
+    }
+
+    if( status == SntpSuccess )
+    {
+        status = Sntp_DeserializeResponse( pRequestTime,
+                                           &responseRxTime,
+                                           pContext->pNetworkBuffer,
+                                           responseSize,
+                                           &parsedResponse );
+    }
+
+    if( ( status == SntpSuccess ) || ( status == SntpClockOffsetOverflow ) )
+    {
+        TRACE_EVENT( pContext, SntpTraceResponseValidated, pServer, status, responseSize,
+                     SNTP_KISS_OF_DEATH_CODE_NONE );
+    }
+
+    if( ( ( status == SntpSuccess ) || ( status == SntpClockOffsetOverflow ) ) &&
+        ( pContext->pServerHistograms != NULL ) )
+    {
+        recordServerHistograms( pContext, serverIndex, pRequestTime, &responseRxTime, &parsedResponse,
+                                ( status == SntpSuccess ) ? true : false );
+    }
+
+    if( ( ( status == SntpSuccess ) || ( status == SntpClockOffsetOverflow ) ) &&
+        ( pContext->pTimeoutEstimators != NULL ) )
+    {
+        /* A latency measured across a backward step of system time is
+         * negative, and is not used by the estimator. */
+        ( void ) Sntp_UpdateTimeoutEstimator( &pContext->pTimeoutEstimators[ serverIndex ],
+                                              Sntp_FixedDifference( Sntp_FixedFromTimestamp( responseRxTime ),
+                                                                    Sntp_FixedFromTimestamp( *pRequestTime ) ) );
+    }
+
+    if( ( status == SntpSuccess ) && ( pContext->pOutlierGate != NULL ) && ( isHedgedResponse == false ) )
+    {
+        status = Sntp_FilterSample( pContext->pOutlierGate,
+                                    parsedResponse.clockOffsetFractions,
+                                    parsedResponse.roundTripDelayFractions );
+
+        if( status == SntpRejectedResponseOutlier )
+        {
+            SNTP_LOG_RATE_LIMITED( LogDebug, ( "Response rejected as an outlier of the delay: Server=%s",
+                                               pServer->pServerName ) );
+
+            /* The server is reachable, even though the sample is discarded. */
+            pContext->consecutiveServerFailures = 0U;
+        }
+    }
+
+    /* The round-trip delay is calculated for any deserialized response. */
+    recordServerHealth( pContext, serverIndex, status,
+                        ( ( status == SntpSuccess ) || ( status == SntpClockOffsetOverflow ) ||
+                          ( status == SntpRejectedResponseOutlier ) ) ?
+                        parsedResponse.roundTripDelayFractions : 0 );
+
+    if( ( status == SntpSuccess ) || ( status == SntpClockOffsetOverflow ) )
+    {
+        /* The server is reachable, even if the system time cannot be corrected. */
+        pContext->consecutiveServerFailures = 0U;
+
+        if( pContext->setTimeFunc( pServer->pServerName,
+                                   &parsedResponse.serverTime,
+                                   parsedResponse.clockOffsetSec ) == false )
+        {
+            LogError( ( "Failed to update system time with server response: Server=%s",
+                        pServer->pServerName ) );
+            status = SntpErrorSystemClockFailure;
+        }
+        else if( status == SntpSuccess )
+        {
+            LogDebug( ( "Updated system time with server response: Server=%s, ClockOffsetSec=%ld",
+                        pServer->pServerName, ( long ) parsedResponse.clockOffsetSec ) );
+            TRACE_EVENT( pContext, SntpTraceClockUpdated, pServer, status, responseSize,
+                         SNTP_KISS_OF_DEATH_CODE_NONE );
+
+            /* The parameters are valid, so the virtual clock and estimator calls
+             * cannot fail. */
+            if( pContext->pVirtualClock != NULL )
+            {
+                ( void ) Sntp_ScheduleVirtualClockLeapSecond( pContext->pVirtualClock,
+                                                              &parsedResponse.serverTime,
+                                                              parsedResponse.leapSecondType );
+                ( void ) Sntp_UpdateVirtualClock( pContext->pVirtualClock,
+                                                  &responseRxTime,
+                                                  parsedResponse.clockOffsetFractions );
+            }
+
+            if( ( pContext->pStabilityEstimator != NULL ) && ( isHedgedResponse == false ) )
+            {
+                ( void ) Sntp_UpdateStabilityEstimator( pContext->pStabilityEstimator,
+                                                        &responseRxTime,
+                                                        parsedResponse.clockOffsetFractions );
+            }
+        }
+        else
+        {
+            TRACE_EVENT( pContext, SntpTraceClockUpdated, pServer, status, responseSize,
+                         SNTP_KISS_OF_DEATH_CODE_NONE );
+        }
+    }
+    else
+    {
+        TRACE_EVENT( pContext, SntpTraceResponseRejected, pServer, status, responseSize,
+                     ( ( status == SntpRejectedResponseChangeServer ) ||
+                       ( status == SntpRejectedResponseRetryWithBackoff ) ||
+                       ( status == SntpRejectedResponseOtherCode ) ) ?
+                     parsedResponse.rejectedResponseCode : SNTP_KISS_OF_DEATH_CODE_NONE );
+
+        if( ( ( status == SntpRejectedResponseChangeServer ) || ( status == SntpServerNotAuthenticated ) ) &&
+            ( isHedgedResponse == false ) )
+        {
+            /* The server MUST NOT be used for further requests. */
+            handleServerFailure( pContext );
+        }
+    }
+
+    if( pContext->pMetrics != NULL )
+    {
+        ( void ) Sntp_RecordResponseMetrics( pContext->pMetrics, serverIndex, status,
+                                             &parsedResponse, &responseRxTime );
+    }
+
+    return status;
+}
+
+/**
+ * @brief Sends a time request to the current server, or the hedged request to
+ * another server.
+ *
+ * The function resolves the DNS name of the server, serializes a request with
+ * the current system time, appends any client authentication data, and sends
+ * the request. The request time and size are stored in the context for
+ * validating the response.
+ *
+ * @param[in, out] pContext The SNTP client context.
+ * @param[in] serverIndex The index of the server in the list of servers.
+ * @param[in] randomNumber The random number of the request.
+ *
+ * @return The status of sending the request, as documented for the
+ * @ref Sntp_SendTimeRequest API.
+ */
+static SntpStatus_t sendRequest( SntpContext_t * pContext,
+                                 size_t serverIndex,
+                                 uint32_t randomNumber )
+{
+    SntpStatus_t status = SntpSuccess;
+    const SntpServerInfo_t * pServer;
+    SntpTimestamp_t * pRequestTime;
+    size_t * pPacketSize;
+    uint32_t * pServerAddr;
+    uint32_t hedgeServerAddr;
+    size_t authDataSize = 0U;
+    int32_t bytesSent;
+
+    assert( pContext != NULL );
+    assert( serverIndex < pContext->numOfServers );
+
+    pServer = &pContext->pTimeServers[ serverIndex ];
+
+    if( serverIndex == pContext->currentServerIndex )
+    {
+        pRequestTime = &pContext->lastRequestTime;
+        pPacketSize = &pContext->sntpPacketSize;
+        pServerAddr = &pContext->currentServerIpV4Addr;
+    }
+    else
+    {
+        pRequestTime = &pContext->hedgeRequestTime;
+        pPacketSize = &pContext->hedgePacketSize;
+        pServerAddr = &hedgeServerAddr;
+    }
+
+    /* As a Best Practice, resolve the DNS name of the server for every request
+     * so that the client follows changes in the server pool. */
+    if( pContext->resolveDnsFunc( pServer->pServerName, pServerAddr ) == false )
+    {
+        SNTP_LOG_RATE_LIMITED( LogError, ( "Unable to send time request: DNS resolution failed: "
+                                           "Server=%s", pServer->pServerName ) );
+        status = SntpErrorDnsFailure;
+    }
+    else if( pContext->getTimeFunc( pRequestTime ) == false )
+    {
+        LogError( ( "Unable to send time request: Could not get system time" ) );
+        status = SntpErrorSystemClockFailure;
+    }
+    else
+    {
+        status = Sntp_SerializeRequest( pRequestTime,
+                                        randomNumber,
+                                        pContext->pNetworkBuffer,
+                                        pContext->bufferSize );
+    }
+
+    if( ( status == SntpSuccess ) && ( pContext->authIntf.generateClientAuth != NULL ) )
+    {
+        status = pContext->authIntf.generateClientAuth( pContext->authIntf.pAuthContext,
+                                                        pServer->pServerName,
+                                                        pContext->pNetworkBuffer,
+                                                        pContext->bufferSize,
+                                                        &authDataSize );
+
+        if( ( status == SntpSuccess ) &&
+            ( authDataSize > ( pContext->bufferSize - SNTP_PACKET_BASE_SIZE ) ) )
+        {
+            LogError( ( "Unable to send time request: Client authentication data does not fit "
+                        "in the network buffer: AuthDataSize=%lu", ( unsigned long ) authDataSize ) );
+            status = SntpErrorBufferTooSmall;
+        }
+    }
+
+    if( status == SntpSuccess )
+    {
+        /* The server response is expected to be of the same size as the request. */
+        *pPacketSize = SNTP_PACKET_BASE_SIZE + authDataSize;
+
+        TRACE_EVENT( pContext, SntpTraceRequestSerialized, pServer, status, *pPacketSize,
+                     SNTP_KISS_OF_DEATH_CODE_NONE );
+
+        bytesSent = pContext->networkIntf.sendTo( pContext->networkIntf.pUserContext,
+                                                  pServer,
+                                                  pContext->pNetworkBuffer,
+                                                  *pPacketSize );
+
+        /* A UDP datagram is sent whole, so anything less represents failure. */
+        if( ( bytesSent < 0 ) || ( ( size_t ) bytesSent != *pPacketSize ) )
+        {
+            SNTP_LOG_RATE_LIMITED( LogError, ( "Unable to send time request: Transport send failed: "
+                                               "Server=%s, BytesSent=%ld", pServer->pServerName,
+                                               ( long ) bytesSent ) );
+            status = SntpErrorNetworkFailure;
+        }
+        else
+        {
+            LogDebug( ( "Sent time request: Server=%s, PacketSize=%lu", pServer->pServerName,
+                        ( unsigned long ) *pPacketSize ) );
+        }
+    }
+
+    if( status == SntpSuccess )
+    {
+        TRACE_EVENT( pContext, SntpTraceRequestSent, pServer, status, *pPacketSize,
+                     SNTP_KISS_OF_DEATH_CODE_NONE );
+    }
+    else
+    {
+        TRACE_EVENT( pContext, SntpTraceRequestFailed, pServer, status, 0U,
+                     SNTP_KISS_OF_DEATH_CODE_NONE );
+    }
+
+    if( pContext->pMetrics != NULL )
+    {
+        ( void ) Sntp_RecordRequestMetrics( pContext->pMetrics, serverIndex, status );
+    }
+
+    if( status != SntpSuccess )
+    {
+        recordServerHealth( pContext, serverIndex, status, 0 );
+    }
+
+    return status;
+}
+
+/**
+ * @brief Gets the time since sending the last time request after which it is
+ * hedged, which is the #SNTP_HEDGE_LATENCY_PERCENTILE percentile of the
+ * response latency of the current server, if the hedging budget allows it.
+ *
+ * @param[in] pContext The SNTP client context.
+ * @param[out] pHedgeDelay The time after which the request is hedged, as a
+ * 32.32 fixed-point duration.
+ *
+ * @return `true` if the last time request can be hedged; `false` otherwise.
+ */
+static bool getHedgeDelay( const SntpContext_t * pContext,
+                           uint64_t * pHedgeDelay )
+{
+    const SntpHistogram_t * pLatencies;
+    uint32_t count = 0U;
+    uint32_t latencyUs = 0U;
+    bool canHedge = false;
+
+    assert( pContext != NULL );
+    assert( pHedgeDelay != NULL );
+
+    if( ( pContext->maxHedgePercent != 0U ) && ( pContext->isHedgeSent == false ) &&
+        ( pContext->hedgeCredit >= HEDGE_REQUEST_CREDIT ) && ( pContext->numOfServers > 1U ) &&
+        ( pContext->pServerHistograms != NULL ) )
+    {
+        pLatencies = &pContext->pServerHistograms[ pContext->currentServerIndex ].responseLatency;
+
+        /* The parameters are valid, so the histogram calls cannot fail other
+         * than for an empty histogram, which has a count of zero. */
+        ( void ) Sntp_GetHistogramCount( pLatencies, &count );
+
+        if( count >= SNTP_HEDGE_MIN_SAMPLES )
+        {
+            ( void ) Sntp_GetHistogramPercentile( pLatencies, SNTP_HEDGE_LATENCY_PERCENTILE, &latencyUs );
+
+            *pHedgeDelay = ( uint64_t ) Sntp_FixedFromNanoseconds( ( int64_t ) latencyUs * 1000 );
+            canHedge = true;
+        }
+    }
+
+    return canHedge;
+}
+
+/**
+ * @brief Checks whether the last time request should be hedged, because its
+ * response is later than the #SNTP_HEDGE_LATENCY_PERCENTILE percentile of the
+ * response latency of the current server, and the hedging budget allows it.
+ *
+ * @param[in] pContext The SNTP client context.
+ * @param[in] pCurrentTime The current system time.
+ *
+ * @return `true` if the hedged request should be sent; `false` otherwise.
+ */
+static bool isHedgeDue( const SntpContext_t * pContext,
+                        const SntpTimestamp_t * pCurrentTime )
+{
+    uint64_t hedgeDelay = 0U;
+    uint64_t elapsedTime;
+    bool isDue = false;
+
+    assert( pContext != NULL );
+    assert( pCurrentTime != NULL );
+
+    if( getHedgeDelay( pContext, &hedgeDelay ) == true )
+    {
+        /* A backward step of system time does not trigger hedging. */
+        elapsedTime = Sntp_FixedFromTimestamp( *pCurrentTime ) -
+                      Sntp_FixedFromTimestamp( pContext->lastRequestTime );
+
+        isDue = ( ( elapsedTime < ( ( uint64_t ) 1 << 63 ) ) && ( elapsedTime >= hedgeDelay ) ) ? true : false;
+    }
+
+    return isDue;
+}
+
+/**
+ * @brief Sends the hedged request of the last time request to the next server
+ * in the list, or the healthiest other server, and spends its credit.
+ *
+ * A failure to send the hedged request does not change the current server;
+ * the response of the last time request is still awaited.
+ *
+ * @param[in, out] pContext The SNTP client context.
+ */
+static void sendHedgedRequest( SntpContext_t * pContext )
+{
+    assert( pContext != NULL );
+    assert( pContext->numOfServers > 1U );
+
+    pContext->isHedgeSent = true;
+    pContext->hedgeCredit -= HEDGE_REQUEST_CREDIT;
+    pContext->hedgeServerIndex = selectNextServer( pContext );
+
+    if( sendRequest( pContext, pContext->hedgeServerIndex, pContext->hedgeRandomNumber ) == SntpSuccess )
+    {
+        LogDebug( ( "Hedged time request to next server: Server=%s",
+                    pContext->pTimeServers[ pContext->hedgeServerIndex ].pServerName ) );
+        pContext->isHedgePending = true;
+    }
+}
+
+/**
+ * @brief Checks whether a response is of the pending hedged request, from its
+ * "originate timestamp".
+ *
+ * Responses are attributed by the timestamp rather than by the read they
+ * arrive through, so that a transport can receive the responses of all the
+ * servers through a single socket.
+ *
+ * @param[in] pContext The SNTP client context.
+ * @param[in] responseSize The size of the response in the network buffer.
+ *
+ * @return `true` if the response is of the hedged request; `false` otherwise.
+ */
+static bool isHedgedResponse( const SntpContext_t * pContext,
+                              size_t responseSize )
+{
+    const uint8_t * pOriginate;
+    uint32_t seconds;
+    uint32_t fractions;
+    bool isHedged = false;
+
+    assert( pContext != NULL );
+
+    if( ( pContext->isHedgePending == true ) && ( responseSize >= SNTP_PACKET_BASE_SIZE ) )
+    {
+        pOriginate = &pContext->pNetworkBuffer[ ORIGINATE_TIMESTAMP_OFFSET ];
+        seconds = ( ( uint32_t ) pOriginate[ 0 ] << 24 ) | ( ( uint32_t ) pOriginate[ 1 ] << 16 ) |
+                  ( ( uint32_t ) pOriginate[ 2 ] << 8 ) | ( uint32_t ) pOriginate[ 3 ];
+        fractions = ( ( uint32_t ) pOriginate[ 4 ] << 24 ) | ( ( uint32_t ) pOriginate[ 5 ] << 16 ) |
+                    ( ( uint32_t ) pOriginate[ 6 ] << 8 ) | ( uint32_t ) pOriginate[ 7 ];
+
+        isHedged = ( ( seconds == pContext->hedgeRequestTime.seconds ) &&
+                     ( fractions == pContext->hedgeRequestTime.fractions ) ) ? true : false;
+    }
+
+    return isHedged;
+}
+
+/**
+ * @brief Gets the size of the responses read from the network, which is the
+ * size of the larger of the pending requests.
+ *
+ * @param[in] pContext The SNTP client context.
+ *
+ * @return The size to read.
+ */
+static size_t getReceiveSize( const SntpContext_t * pContext )
+{
+    size_t receiveSize;
+
+    assert( pContext != NULL );
+
+    receiveSize = pContext->sntpPacketSize;
+
+    if( ( pContext->isHedgePending == true ) && ( pContext->hedgePacketSize > receiveSize ) )
+    {
+        receiveSize = pContext->hedgePacketSize;
+    }
+
+    return receiveSize;
+}
+
+/**
+ * @brief Handles a response read from the network, as a response of the
+ * hedged request or of the last time request.
+ *
+ * An invalid or rejected response of the hedged request only ends the hedged
+ * request. A response of the last time request after it has failed is
+ * discarded.
+ *
+ * @param[in, out] pContext The SNTP client context.
+ * @param[in] responseSize The size of the response in the network buffer.
+ *
+ * @return The status of processing the response, as documented for the
+ * @ref Sntp_ReceiveTimeResponse API, or #SntpNoResponseReceived if the
+ * response does not end the time request.
+ */
+static SntpStatus_t handleServerResponse( SntpContext_t * pContext,
+                                          size_t responseSize )
+{
+    SntpStatus_t status = SntpNoResponseReceived;
+    size_t serverIndex;
+
+    assert( pContext != NULL );
+
+    if( isHedgedResponse( pContext, responseSize ) == true )
+    {
+        serverIndex = pContext->hedgeServerIndex;
+        LogDebug( ( "Received hedged response: Server=%s, ResponseSize=%lu",
+                    pContext->pTimeServers[ serverIndex ].pServerName, ( unsigned long ) responseSize ) );
+        pContext->isHedgePending = false;
+        TRACE_EVENT( pContext, SntpTraceResponseReceived, &pContext->pTimeServers[ serverIndex ], SntpSuccess,
+                     responseSize, SNTP_KISS_OF_DEATH_CODE_NONE );
+        status = processServerResponse( pContext, serverIndex, true, responseSize );
+
+        /* A valid response ends the time request, even if the system time
+         * cannot be corrected with it. */
+        if( ( status != SntpSuccess ) && ( status != SntpClockOffsetOverflow ) &&
+            ( status != SntpErrorSystemClockFailure ) )
+        {
+            status = SntpNoResponseReceived;
+        }
+    }
+    else if( pContext->requestFailureStatus == SntpSuccess )
+    {
+        serverIndex = pContext->currentServerIndex;
+        LogDebug( ( "Received server response: Server=%s, ResponseSize=%lu",
+                    pContext->pTimeServers[ serverIndex ].pServerName, ( unsigned long ) responseSize ) );
+        TRACE_EVENT( pContext, SntpTraceResponseReceived, &pContext->pTimeServers[ serverIndex ], SntpSuccess,
+                     responseSize, SNTP_KISS_OF_DEATH_CODE_NONE );
+        status = processServerResponse( pContext, serverIndex, false, responseSize );
+    }
+    else
+    {
+        LogDebug( ( "Discarded response after the time request failed: ResponseSize=%lu",
+                    ( unsigned long ) responseSize ) );
+    }
+
+    return status;
+}
+
+/**
+ * @brief Receives the response of the last time request, if it has arrived,
+ * and sends its hedged request when it is due.
+ *
+ * @param[in, out] pContext The SNTP client context, awaiting the response of
+ * the last time request.
+ * @param[in] responseTimeoutMs The response timeout in milliseconds.
+ *
+ * @return The status of the time request, as documented for the
+ * @ref Sntp_ReceiveTimeResponse API.
+ */
+static SntpStatus_t receiveResponse( SntpContext_t * pContext,
+                                     uint32_t responseTimeoutMs )
+{
+    SntpStatus_t status = SntpNoResponseReceived;
+    SntpServerInfo_t server;
+    SntpTimestamp_t currentTime;
+    size_t serverIndex;
+    int32_t bytesReceived;
+    uint32_t timeoutMs;
+
+    assert( pContext != NULL );
+    assert( pContext->requestFailureStatus == SntpSuccess );
+
+    /* The transport interface can update the server information. */
+    serverIndex = pContext->currentServerIndex;
+    server = pContext->pTimeServers[ serverIndex ];
+    timeoutMs = getResponseTimeout( pContext, serverIndex, responseTimeoutMs );
+
+    bytesReceived = pContext->networkIntf.recvFrom( pContext->networkIntf.pUserContext,
+                                                    &server,
+                                                    pContext->pNetworkBuffer,
+                                                    getReceiveSize( pContext ) );
+
+    if( bytesReceived < 0 )
+    {
+        SNTP_LOG_RATE_LIMITED( LogError, ( "Unable to receive server response: Transport receive failed: "
+                                           "Server=%s, Code=%ld", server.pServerName,
+                                           ( long ) bytesReceived ) );
+        status = SntpErrorNetworkFailure;
+        TRACE_EVENT( pContext, SntpTraceResponseFailed, &pContext->pTimeServers[ serverIndex ], status, 0U,
+                     SNTP_KISS_OF_DEATH_CODE_NONE );
+        recordServerHealth( pContext, serverIndex, status, 0 );
+        handleServerFailure( pContext );
+    }
+    else if( bytesReceived > 0 )
+    {
+        status = handleServerResponse( pContext, ( size_t ) bytesReceived );
+    }
+    else if( pContext->getTimeFunc( &currentTime ) == false )
+    {
+        status = SntpErrorSystemClockFailure;
+    }
+    else if( isResponseTimeoutExpired( &pContext->lastRequestTime, &currentTime, timeoutMs ) == true )
+    {
+        SNTP_LOG_RATE_LIMITED( LogWarn, ( "Did not receive server response within timeout: "
+                                          "Server=%s, TimeoutMs=%lu", server.pServerName,
+                                          ( unsigned long ) timeoutMs ) );
+        status = SntpErrorResponseTimeout;
+        TRACE_EVENT( pContext, SntpTraceResponseFailed, &pContext->pTimeServers[ serverIndex ], status, 0U,
+                     SNTP_KISS_OF_DEATH_CODE_NONE );
+
+        /* The next response of the server is awaited for longer, in case
+         * its latency has grown. */
+        if( pContext->pTimeoutEstimators != NULL )
+        {
+            ( void ) Sntp_BackOffTimeoutEstimator( &pContext->pTimeoutEstimators[ serverIndex ] );
+        }
+
+        recordServerHealth( pContext, serverIndex, status, 0 );
+        handleServerFailure( pContext );
+    }
+    else if( isHedgeDue( pContext, &currentTime ) == true )
+    {
+        sendHedgedRequest( pContext );
+    }
+    else
+    {
+        /* Empty else MISRA 15.7 */
+    }
+
+    /* The outcome of a received response is recorded while processing it. */
+    if( ( pContext->pMetrics != NULL ) && ( bytesReceived <= 0 ) )
+    {
+        ( void ) Sntp_RecordResponseMetrics( pContext->pMetrics, serverIndex, status, NULL, NULL );
+    }
+
+    return status;
+}
+
+/**
+ * @brief Receives the response of the hedged request, if it has arrived, and
+ * ends the hedged request at its own response timeout once the last time
+ * request has failed.
+ *
+ * An invalid or rejected response of the hedged request, or a failure to read
+ * it, only ends the hedged request.
+ *
+ * @param[in, out] pContext The SNTP client context, with a pending hedged
+ * request.
+ * @param[in] responseTimeoutMs The response timeout in milliseconds.
+ *
+ * @return The status of processing a valid response, as documented for the
+ * @ref Sntp_ReceiveTimeResponse API; #SntpNoResponseReceived otherwise.
+ */
+static SntpStatus_t receiveHedgedResponse( SntpContext_t * pContext,
+                                           uint32_t responseTimeoutMs )
+{
+    SntpStatus_t status = SntpNoResponseReceived;
+    SntpServerInfo_t server;
+    SntpTimestamp_t currentTime;
+    size_t serverIndex;
+    int32_t bytesReceived;
+    uint32_t timeoutMs;
+
+    assert( pContext != NULL );
+    assert( pContext->isHedgePending == true );
+
+    serverIndex = pContext->hedgeServerIndex;
+    server = pContext->pTimeServers[ serverIndex ];
+
+    bytesReceived = pContext->networkIntf.recvFrom( pContext->networkIntf.pUserContext,
+                                                    &server,
+                                                    pContext->pNetworkBuffer,
+                                                    getReceiveSize( pContext ) );
+
+    if( bytesReceived < 0 )
+    {
+        SNTP_LOG_RATE_LIMITED( LogWarn, ( "Unable to receive hedged response: Transport receive failed: "
+                                          "Server=%s, Code=%ld", server.pServerName,
+                                          ( long ) bytesReceived ) );
+        pContext->isHedgePending = false;
+        TRACE_EVENT( pContext, SntpTraceResponseFailed, &pContext->pTimeServers[ serverIndex ],
+                     SntpErrorNetworkFailure, 0U, SNTP_KISS_OF_DEATH_CODE_NONE );
+        recordServerHealth( pContext, serverIndex, SntpErrorNetworkFailure, 0 );
+
+        if( pContext->pMetrics != NULL )
+        {
+            ( void ) Sntp_RecordResponseMetrics( pContext->pMetrics, serverIndex, SntpErrorNetworkFailure,
+                                                 NULL, NULL );
+        }
+    }
+    else if( bytesReceived > 0 )
+    {
+        status = handleServerResponse( pContext, ( size_t ) bytesReceived );
+
+        /* A transport with a single socket can return the response of the last
+         * time request, which then fails it if it is not valid. */
+        if( ( status != SntpSuccess ) && ( status != SntpClockOffsetOverflow ) &&
+            ( status != SntpNoResponseReceived ) && ( pContext->isHedgePending == true ) )
+        {
+            pContext->requestFailureStatus = status;
+            status = SntpNoResponseReceived;
+        }
+    }
+    else if( pContext->requestFailureStatus == SntpSuccess )
+    {
+        /* The response timeout of the last time request bounds the wait. */
+    }
+    else if( pContext->getTimeFunc( &currentTime ) == false )
+    {
+        pContext->isHedgePending = false;
+        status = SntpErrorSystemClockFailure;
+    }
+    else
+    {
+        timeoutMs = getResponseTimeout( pContext, serverIndex, responseTimeoutMs );
+
+        if( isResponseTimeoutExpired( &pContext->hedgeRequestTime, &currentTime, timeoutMs ) == true )
+        {
+            SNTP_LOG_RATE_LIMITED( LogWarn, ( "Did not receive hedged response within timeout: "
+                                              "Server=%s, TimeoutMs=%lu", server.pServerName,
+                                              ( unsigned long ) timeoutMs ) );
+            pContext->isHedgePending = false;
+            TRACE_EVENT( pContext, SntpTraceResponseFailed, &pContext->pTimeServers[ serverIndex ],
+                         SntpErrorResponseTimeout, 0U, SNTP_KISS_OF_DEATH_CODE_NONE );
+
+            if( pContext->pTimeoutEstimators != NULL )
+            {
+                ( void ) Sntp_BackOffTimeoutEstimator( &pContext->pTimeoutEstimators[ serverIndex ] );
+            }
+
+            recordServerHealth( pContext, serverIndex, SntpErrorResponseTimeout, 0 );
+
+            if( pContext->pMetrics != NULL )
+            {
+                ( void ) Sntp_RecordResponseMetrics( pContext->pMetrics, serverIndex, SntpErrorResponseTimeout,
+                                                     NULL, NULL );
+            }
+        }
+    }
+
+    return status;
+}
 
 
 SntpStatus_t Sntp_Init( SntpContext_t * pContext,
@@ -51,11 +1214,16 @@ SntpStatus_t Sntp_Init( SntpContext_t * pContext,
         ( pNetworkBuffer == NULL ) || ( resolveDnsFunc == NULL ) || ( getSystemTimeFunc == NULL ) ||
         ( setSystemTimeFunc == NULL ) || ( pTransportIntf == NULL ) )
     {
+        LogError( ( "Invalid parameter: pContext=%p, pTimeServers=%p, numOfServers=%lu, "
+                    "pNetworkBuffer=%p, and all interface functions MUST be valid",
+                    ( void * ) pContext, ( const void * ) pTimeServers,
+                    ( unsigned long ) numOfServers, ( void * ) pNetworkBuffer ) );
         status = SntpErrorBadParameter;
     }
     /* Validate that the members of the UDP transport interface. */
     else if( ( pTransportIntf->recvFrom == NULL ) || ( pTransportIntf->sendTo == NULL ) )
     {
+        LogError( ( "Invalid parameter: Function members of UDP transport interface cannot be NULL" ) );
         status = SntpErrorBadParameter;
     }
 
@@ -65,10 +1233,13 @@ SntpStatus_t Sntp_Init( SntpContext_t * pContext,
              ( ( pAuthIntf->generateClientAuth == NULL ) ||
                ( pAuthIntf->validateServer == NULL ) ) )
     {
+        LogError( ( "Invalid parameter: Function members of authentication interface cannot be NULL" ) );
         status = SntpErrorBadParameter;
     }
     else if( bufferSize < SNTP_PACKET_BASE_SIZE )
     {
+        LogError( ( "Cannot initialize context: Passed network buffer size is less than %u bytes: "
+                    "bufferSize=%lu", SNTP_PACKET_BASE_SIZE, ( unsigned long ) bufferSize ) );
         status = SntpErrorBufferTooSmall;
     }
     else
@@ -102,3 +1273,339 @@ SntpStatus_t Sntp_Init( SntpContext_t * pContext,
 
     return status;
 }
+
+SntpStatus_t Sntp_SetVirtualClock( SntpContext_t * pContext,
+                                   SntpVirtualClock_t * pVirtualClock )
+{
+    SntpStatus_t status = SntpSuccess;
+
+    if( pContext == NULL )
+    {
+        status = SntpErrorBadParameter;
+    }
+    else
+    {
+        pContext->pVirtualClock = pVirtualClock;
+    }
+
+    return status;
+}
+
+SntpStatus_t Sntp_SetOutlierGate( SntpContext_t * pContext,
+                                  SntpOutlierGate_t * pOutlierGate )
+{
+    SntpStatus_t status = SntpSuccess;
+
+    if( pContext == NULL )
+    {
+        status = SntpErrorBadParameter;
+    }
+    else
+    {
+        pContext->pOutlierGate = pOutlierGate;
+    }
+
+    return status;
+}
+
+SntpStatus_t Sntp_SetStabilityEstimator( SntpContext_t * pContext,
+                                         SntpStabilityEstimator_t * pEstimator )
+{
+    SntpStatus_t status = SntpSuccess;
+
+    if( pContext == NULL )
+    {
+        status = SntpErrorBadParameter;
+    }
+    else
+    {
+        pContext->pStabilityEstimator = pEstimator;
+    }
+
+    return status;
+}
+
+SntpStatus_t Sntp_SetServerHistograms( SntpContext_t * pContext,
+                                       SntpServerHistograms_t * pHistograms )
+{
+    SntpStatus_t status = SntpSuccess;
+
+    if( pContext == NULL )
+    {
+        status = SntpErrorBadParameter;
+    }
+    else
+    {
+        pContext->pServerHistograms = pHistograms;
+    }
+
+    return status;
+}
+
+SntpStatus_t Sntp_SetMetrics( SntpContext_t * pContext,
+                              SntpMetrics_t * pMetrics )
+{
+    SntpStatus_t status = SntpSuccess;
+    size_t index;
+
+    if( pContext == NULL )
+    {
+        status = SntpErrorBadParameter;
+    }
+    else if( ( pMetrics != NULL ) && ( pMetrics->pServers != NULL ) &&
+             ( pMetrics->numOfServers != pContext->numOfServers ) )
+    {
+        status = SntpErrorBadParameter;
+    }
+    else
+    {
+        pContext->pMetrics = pMetrics;
+
+        if( ( pMetrics != NULL ) && ( pMetrics->pServers != NULL ) )
+        {
+            for( index = 0U; index < pMetrics->numOfServers; index++ )
+            {
+                pMetrics->pServers[ index ].pServerName = pContext->pTimeServers[ index ].pServerName;
+            }
+        }
+    }
+
+    return status;
+}
+
+SntpStatus_t Sntp_SetTimeoutEstimators( SntpContext_t * pContext,
+                                        SntpTimeoutEstimator_t * pEstimators )
+{
+    SntpStatus_t status = SntpSuccess;
+
+    if( pContext == NULL )
+    {
+        status = SntpErrorBadParameter;
+    }
+    else
+    {
+        pContext->pTimeoutEstimators = pEstimators;
+    }
+
+    return status;
+}
+
+SntpStatus_t Sntp_SetServerHealth( SntpContext_t * pContext,
+                                   SntpServerHealth_t * pHealth )
+{
+    SntpStatus_t status = SntpSuccess;
+    size_t index;
+
+    if( pContext == NULL )
+    {
+        status = SntpErrorBadParameter;
+    }
+    else
+    {
+        pContext->pServerHealth = pHealth;
+        pContext->isServerSelectionPending = ( pHealth != NULL ) ? true : false;
+
+        for( index = 0U; ( pHealth != NULL ) && ( index < pContext->numOfServers ); index++ )
+        {
+            pHealth[ index ].serverId = hashServerName( &pContext->pTimeServers[ index ] );
+        }
+    }
+
+    return status;
+}
+
+SntpStatus_t Sntp_SetHedging( SntpContext_t * pContext,
+                              uint32_t maxHedgePercent )
+{
+    SntpStatus_t status = SntpSuccess;
+
+    if( ( pContext == NULL ) || ( maxHedgePercent > SNTP_MAX_HEDGE_PERCENT ) )
+    {
+        status = SntpErrorBadParameter;
+    }
+    else
+    {
+        pContext->maxHedgePercent = maxHedgePercent;
+
+        if( maxHedgePercent == 0U )
+        {
+            pContext->hedgeCredit = 0U;
+        }
+    }
+
+    return status;
+}
+
+#ifdef SNTP_ENABLE_TRACING
+    SntpStatus_t Sntp_SetTraceCallback( SntpContext_t * pContext,
+                                        SntpTraceCallback_t traceFunc,
+                                        void * pTraceContext )
+    {
+        SntpStatus_t status = SntpSuccess;
+
+        if( pContext == NULL )
+        {
+            status = SntpErrorBadParameter;
+        }
+        else
+        {
+            pContext->traceFunc = traceFunc;
+            pContext->pTraceContext = pTraceContext;
+        }
+
+        return status;
+    }
+#endif /* ifdef SNTP_ENABLE_TRACING */
+
+SntpStatus_t Sntp_SendTimeRequest( SntpContext_t * pContext,
+                                   uint32_t randomNumber )
+{
+    SntpStatus_t status = SntpSuccess;
+
+    if( pContext == NULL )
+    {
+        status = SntpErrorBadParameter;
+    }
+    else
+    {
+        /* A new time request ends the hedged request of the previous one. */
+        pContext->isHedgeSent = false;
+        pContext->isHedgePending = false;
+        pContext->requestFailureStatus = SntpSuccess;
+
+        /* The serialization of the request only uses the upper bits of the
+         * random number, so the lower bits are unpredictable for the hedged
+         * request. */
+        pContext->hedgeRandomNumber = randomNumber << 16;
+
+        selectHealthiestServer( pContext );
+
+        status = sendRequest( pContext, pContext->currentServerIndex, randomNumber );
+
+        if( status == SntpSuccess )
+        {
+            /* Every request earns a share of a hedged request, and the credit
+             * is limited to a single hedged request so that hedging cannot
+             * burst after a long period without it. */
+            pContext->hedgeCredit += pContext->maxHedgePercent;
+
+            if( pContext->hedgeCredit > HEDGE_REQUEST_CREDIT )
+            {
+                pContext->hedgeCredit = HEDGE_REQUEST_CREDIT;
+            }
+        }
+        else if( ( status == SntpErrorDnsFailure ) || ( status == SntpErrorNetworkFailure ) )
+        {
+            handleServerFailure( pContext );
+        }
+        else
+        {
+            /* Empty else MISRA 15.7 */
+        }
+    }
+
+    return status;
+}
+
+SntpStatus_t Sntp_ReceiveTimeResponse( SntpContext_t * pContext,
+                                       uint32_t responseTimeoutMs )
+{
+    SntpStatus_t status = SntpSuccess;
+    bool isHedgeAwaited;
+
+    if( pContext == NULL )
+    {
+        status = SntpErrorBadParameter;
+    }
+    else
+    {
+        /* A hedged request sent by this call cannot have a response yet. */
+        isHedgeAwaited = pContext->isHedgePending;
+
+        status = ( pContext->requestFailureStatus == SntpSuccess ) ?
+                 receiveResponse( pContext, responseTimeoutMs ) : SntpNoResponseReceived;
+
+        /* Whichever valid response arrives first is used, so any other outcome
+         * of the last time request waits for its hedged request. */
+        if( ( isHedgeAwaited == true ) && ( pContext->isHedgePending == true ) &&
+            ( status != SntpSuccess ) && ( status != SntpClockOffsetOverflow ) )
+        {
+            if( status != SntpNoResponseReceived )
+            {
+                pContext->requestFailureStatus = status;
+            }
+
+            status = receiveHedgedResponse( pContext, responseTimeoutMs );
+        }
+
+        if( ( status == SntpSuccess ) || ( status == SntpClockOffsetOverflow ) )
+        {
+            pContext->isHedgePending = false;
+        }
+        else if( ( status == SntpNoResponseReceived ) && ( pContext->isHedgePending == false ) &&
+                 ( pContext->requestFailureStatus != SntpSuccess ) )
+        {
+            /* The hedged request has ended without a valid response. */
+            status = pContext->requestFailureStatus;
+        }
+        else
+        {
+            /* Empty else MISRA 15.7 */
+        }
+
+        if( status != SntpNoResponseReceived )
+        {
+            pContext->requestFailureStatus = SntpSuccess;
+        }
+    }
+
+    return status;
+}
+
+SntpStatus_t Sntp_GetResponseWaitTime( const SntpContext_t * pContext,
+                                       uint32_t responseTimeoutMs,
+                                       uint32_t * pWaitTimeMs )
+{
+    SntpStatus_t status = SntpSuccess;
+    SntpTimestamp_t currentTime;
+    uint32_t timeoutMs;
+    uint32_t hedgeWaitTimeMs;
+    uint64_t hedgeDelay = 0U;
+
+    if( ( pContext == NULL ) || ( pWaitTimeMs == NULL ) )
+    {
+        status = SntpErrorBadParameter;
+    }
+    else if( pContext->getTimeFunc( &currentTime ) == false )
+    {
+        status = SntpErrorSystemClockFailure;
+    }
+    else if( ( pContext->requestFailureStatus != SntpSuccess ) && ( pContext->isHedgePending == true ) )
+    {
+        /* The last time request has failed, so only the hedged request is
+         * awaited. */
+        timeoutMs = getResponseTimeout( pContext, pContext->hedgeServerIndex, responseTimeoutMs );
+        *pWaitTimeMs = getRemainingTimeMs( &pContext->hedgeRequestTime, &currentTime,
+                                           ( uint64_t ) Sntp_FixedFromNanoseconds( ( int64_t ) timeoutMs * 1000000 ) );
+    }
+    else
+    {
+        timeoutMs = getResponseTimeout( pContext, pContext->currentServerIndex, responseTimeoutMs );
+        *pWaitTimeMs = getRemainingTimeMs( &pContext->lastRequestTime, &currentTime,
+                                           ( uint64_t ) Sntp_FixedFromNanoseconds( ( int64_t ) timeoutMs * 1000000 ) );
+
+        /* The hedged request is only sent from Sntp_ReceiveTimeResponse, so the
+         * wait also ends when it is due. */
+        if( getHedgeDelay( pContext, &hedgeDelay ) == true )
+        {
+            hedgeWaitTimeMs = getRemainingTimeMs( &pContext->lastRequestTime, &currentTime, hedgeDelay );
+
+            if( hedgeWaitTimeMs < *pWaitTimeMs )
+            {
+                *pWaitTimeMs = hedgeWaitTimeMs;
+            }
+        }
+    }
+
+    return status;
+}
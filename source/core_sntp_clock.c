@@ -0,0 +1,798 @@
+/*
+ * coreSNTP v1.0.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file core_sntp_clock.c
+ * @brief Implementation of the virtual clock API of the coreSNTP library.
+ */
+
+/* Standard includes. */
+#include <string.h>
+#include <assert.h>
+
+/* Include API header. */
+#include "core_sntp_clock.h"
+#include "core_sntp_fixed_point.h"
+
+/**
+ * @brief The maximum frequency correction, in units of SNTP timestamp fractions
+ * per second, that is applied by the virtual clock.
+ */
+#define MAX_FREQUENCY_CORRECTION     ( SNTP_CLOCK_MAX_FREQUENCY_PPM * ( int32_t ) SNTP_FRACTION_VALUE_PER_MICROSECOND )
+
+/**
+ * @brief The inverse of the weight given to the frequency error measured from
+ * a new clock offset sample when updating the frequency correction.
+ *
+ * A value of 4 means that a quarter of the measured frequency error is applied
+ * with each sample, which averages out the jitter in the clock offset samples
+ * while converging on the frequency error of the local clock within a few polls.
+ */
+#define FREQUENCY_UPDATE_GAIN        ( 4 )
+
+/**
+ * @brief The inverse of the weight given to a new sample when updating the
+ * averages of the prediction errors of the clock model (i.e. the jitter and the
+ * frequency uncertainty).
+ */
+#define STABILITY_AVERAGE_GAIN       ( 4U )
+
+/**
+ * @brief The number of seconds in a day.
+ */
+#define SECONDS_PER_DAY              ( 86400U )
+
+/**
+ * @brief The number of days from 1st March of year 0 (in the proleptic
+ * Gregorian calendar) to 1st January 1900, the SNTP epoch.
+ */
+#define DAYS_TO_SNTP_EPOCH           ( 693901U )
+
+/**
+ * @brief The number of days in a 400 year cycle of the Gregorian calendar.
+ */
+#define DAYS_PER_400_YEARS           ( 146097U )
+
+/**
+ * @brief The number of bits of the position within the smear window that
+ * select a segment of the cosine smear profile.
+ */
+#define COSINE_SEGMENT_SHIFT         ( 26U )
+
+/**
+ * @brief Memory barrier used for ordering the accesses to the sequence counter
+ * and the clock model of a virtual clock between the writer and the readers.
+ *
+ * @note The default definition uses the GCC (and Clang) full memory barrier
+ * built-in. For other toolchains, the barrier can be defined as the equivalent
+ * intrinsic. Without a barrier definition, the volatile accesses to the clock
+ * model still guarantee consistent reads on single-core systems.
+ */
+#ifndef SNTP_CLOCK_MEMORY_BARRIER
+    #if defined( __GNUC__ )
+        #define SNTP_CLOCK_MEMORY_BARRIER()    __sync_synchronize()
+    #else
+        #define SNTP_CLOCK_MEMORY_BARRIER()
+    #endif
+#endif
+
+/**
+ * @brief The half-cosine leap smear profile, ( 1 - cos( pi * x ) ) / 2, at 65
+ * evenly spaced positions, x, of the smear window, in units of 2^(-16).
+ * Values between the positions are linearly interpolated.
+ */
+static const uint32_t cosineSmearProfile[ 65 ] =
+{
+    0U,     39U,    158U,   355U,   630U,   982U,   1411U,  1915U,
+    2494U,  3146U,  3869U,  4662U,  5522U,  6448U,  7438U,  8489U,
+    9598U,  10762U, 11980U, 13248U, 14563U, 15922U, 17321U, 18758U,
+    20228U, 21729U, 23256U, 24806U, 26375U, 27960U, 29556U, 31160U,
+    32768U, 34376U, 35980U, 37576U, 39161U, 40730U, 42280U, 43807U,
+    45308U, 46778U, 48215U, 49614U, 50973U, 52288U, 53556U, 54774U,
+    55938U, 57047U, 58098U, 59088U, 60014U, 60874U, 61667U, 62390U,
+    63042U, 63621U, 64125U, 64554U, 64906U, 65181U, 65378U, 65497U,
+    65536U
+};
+
+/**
+ * @brief Updates an exponential moving average with a new sample.
+ *
+ * @param[in] average The current average.
+ * @param[in] sample The new sample.
+ *
+ * @return The updated average.
+ */
+static uint64_t updateMovingAverage( uint64_t average,
+                                     uint64_t sample )
+{
+    uint64_t newAverage;
+
+    if( sample >= average )
+    {
+        newAverage = average + ( ( sample - average ) / STABILITY_AVERAGE_GAIN );
+    }
+    else
+    {
+        newAverage = average - ( ( average - sample ) / STABILITY_AVERAGE_GAIN );
+    }
+
+    return newAverage;
+}
+
+/**
+ * @brief Calculates the drift of the local clock over a time duration for a
+ * frequency correction value.
+ *
+ * @param[in] frequency The frequency correction, in units of SNTP timestamp
+ * fractions per second.
+ * @param[in] elapsedTime The signed time duration, in units of SNTP timestamp
+ * fractions.
+ *
+ * @return The drift of the local clock, in units of SNTP timestamp fractions.
+ */
+static int64_t calculateDrift( int32_t frequency,
+                               int64_t elapsedTime )
+{
+    uint64_t elapsedMagnitude;
+    int64_t drift;
+
+    /* Operate on the magnitude of the duration to avoid shift operations on
+     * negative values. */
+    elapsedMagnitude = Sntp_FixedMagnitude( elapsedTime );
+
+    /* Split the duration into whole seconds and fractions so that the products
+     * with the frequency (bounded by #MAX_FREQUENCY_CORRECTION) cannot overflow
+     * 64 bits. */
+    drift = ( ( int64_t ) frequency * ( int64_t ) ( elapsedMagnitude >> 32 ) ) +
+            ( ( ( int64_t ) frequency * ( int64_t ) ( elapsedMagnitude & 0xFFFFFFFFU ) ) / SNTP_FIXED_SECOND );
+
+    return ( elapsedTime < 0 ) ? -drift : drift;
+}
+
+/**
+ * @brief Calculates the start of the UTC month following an SNTP time, which is
+ * the instant at which a leap second announced at that time is applied.
+ *
+ * @param[in] pTime The SNTP time. Times before the UNIX epoch time are
+ * considered to be in SNTP era 1, as done by the @ref Sntp_ConvertToUnixTime API.
+ * @param[out] pMonthEnd This will be filled with the start of the next month.
+ */
+static void calculateEndOfMonth( const SntpTimestamp_t * pTime,
+                                 SntpTimestamp_t * pMonthEnd )
+{
+    static const uint8_t daysInMonth[ 12 ] = { 31U, 28U, 31U, 30U, 31U, 30U, 31U, 31U, 30U, 31U, 30U, 31U };
+    uint64_t seconds;
+    uint64_t days;
+    uint64_t dayOfEra, yearOfEra, dayOfYear, shiftedMonth;
+    uint64_t year, month, dayOfMonth;
+    uint64_t monthLength;
+
+    assert( pTime != NULL );
+    assert( pMonthEnd != NULL );
+
+    seconds = pTime->seconds;
+
+    if( pTime->seconds <= SNTP_TIME_AT_LARGEST_UNIX_TIME_SECS )
+    {
+        /* The time is in era 1, which starts 2^32 seconds after era 0. */
+        seconds += ( uint64_t ) 1 << 32;
+    }
+
+    days = seconds / SECONDS_PER_DAY;
+
+    /* Convert the day to a civil date with a calendar in which years start in
+     * March, so that the leap day is the last day of the year. */
+    dayOfEra = ( days + DAYS_TO_SNTP_EPOCH ) % DAYS_PER_400_YEARS;
+    yearOfEra = ( dayOfEra - ( dayOfEra / 1460U ) + ( dayOfEra / 36524U ) - ( dayOfEra / 146096U ) ) / 365U;
+    dayOfYear = dayOfEra - ( ( 365U * yearOfEra ) + ( yearOfEra / 4U ) - ( yearOfEra / 100U ) );
+    shiftedMonth = ( ( 5U * dayOfYear ) + 2U ) / 153U;
+    dayOfMonth = dayOfYear - ( ( ( 153U * shiftedMonth ) + 2U ) / 5U ) + 1U;
+    month = ( shiftedMonth < 10U ) ? ( shiftedMonth + 3U ) : ( shiftedMonth - 9U );
+
+    /* The year of the 400 year cycle is sufficient for the leap year rule. */
+    year = ( month <= 2U ) ? ( yearOfEra + 1U ) : yearOfEra;
+
+    monthLength = daysInMonth[ month - 1U ];
+
+    if( ( month == 2U ) &&
+        ( ( ( ( year % 4U ) == 0U ) && ( ( year % 100U ) != 0U ) ) || ( ( year % 400U ) == 0U ) ) )
+    {
+        monthLength++;
+    }
+
+    days = days - ( dayOfMonth - 1U ) + monthLength;
+
+    /* The seconds value wraps around into the next SNTP era. */
+    pMonthEnd->seconds = ( uint32_t ) ( days * SECONDS_PER_DAY );
+    pMonthEnd->fractions = 0U;
+}
+
+/**
+ * @brief Calculates the part of a leap second that is applied at a time.
+ *
+ * @param[in] pLeapSmear The leap smear configuration.
+ * @param[in] time The time on the continuous timescale, in units of SNTP
+ * timestamp fractions.
+ *
+ * @return The applied part of the leap second, in units of SNTP timestamp
+ * fractions, in the range [0, 2^32].
+ */
+static uint64_t calculateLeapAdjustment( const SntpLeapSmear_t * pLeapSmear,
+                                         uint64_t time )
+{
+    int64_t sinceLeap;
+    int64_t halfWindow;
+    uint64_t position;
+    uint64_t adjustment;
+    uint64_t segment;
+    uint64_t remainder;
+
+    assert( pLeapSmear != NULL );
+
+    sinceLeap = Sntp_FixedDifference( time, Sntp_FixedFromTimestamp( pLeapSmear->leapTime ) );
+
+    /* The window is centered on the leap second instant, and is empty when the
+     * leap second is applied as a step. */
+    halfWindow = ( pLeapSmear->type == SntpLeapSmearNone ) ? 0 :
+                 ( ( int64_t ) pLeapSmear->windowSecs * ( SNTP_FIXED_SECOND / 2 ) );
+
+    if( sinceLeap < -halfWindow )
+    {
+        adjustment = 0U;
+    }
+    else if( sinceLeap >= halfWindow )
+    {
+        adjustment = ( uint64_t ) SNTP_FIXED_SECOND;
+    }
+    else
+    {
+        /* The position within the window, in units of 2^(-32) of the window. */
+        position = ( uint64_t ) ( sinceLeap + halfWindow ) / pLeapSmear->windowSecs;
+
+        if( pLeapSmear->type == SntpLeapSmearCosine )
+        {
+            segment = position >> COSINE_SEGMENT_SHIFT;
+            remainder = position & ( ( ( uint64_t ) 1 << COSINE_SEGMENT_SHIFT ) - 1U );
+
+            adjustment = cosineSmearProfile[ segment ] +
+                         ( ( ( uint64_t ) ( cosineSmearProfile[ segment + 1U ] - cosineSmearProfile[ segment ] ) *
+                             remainder ) >> COSINE_SEGMENT_SHIFT );
+            adjustment <<= 16;
+        }
+        else
+        {
+            adjustment = position;
+        }
+    }
+
+    return adjustment;
+}
+
+/**
+ * @brief Applies the leap second of a leap smear configuration to a time on the
+ * continuous timescale.
+ *
+ * @param[in] pLeapSmear The leap smear configuration.
+ * @param[in] time The time on the continuous timescale, in units of SNTP
+ * timestamp fractions.
+ *
+ * @return The time with the leap second applied.
+ */
+static uint64_t applyLeapSecond( const SntpLeapSmear_t * pLeapSmear,
+                                 uint64_t time )
+{
+    uint64_t leapTime = time;
+
+    assert( pLeapSmear != NULL );
+
+    /* An inserted leap second holds time back, and a deleted leap second moves
+     * time forward. */
+    if( pLeapSmear->leapSeconds > 0 )
+    {
+        leapTime = time - calculateLeapAdjustment( pLeapSmear, time );
+    }
+    else if( pLeapSmear->leapSeconds < 0 )
+    {
+        leapTime = time + calculateLeapAdjustment( pLeapSmear, time );
+    }
+    else
+    {
+        /* Empty else MISRA 15.7 */
+    }
+
+    return leapTime;
+}
+
+/**
+ * @brief Utility to convert the leap second of a leap smear configuration into
+ * units of SNTP timestamp fractions.
+ *
+ * @param[in] pLeapSmear The leap smear configuration.
+ *
+ * @return The leap second in units of SNTP timestamp fractions.
+ */
+static int64_t leapSecondsToFixedPoint( const SntpLeapSmear_t * pLeapSmear )
+{
+    assert( pLeapSmear != NULL );
+
+    return ( int64_t ) pLeapSmear->leapSeconds * SNTP_FIXED_SECOND;
+}
+
+/**
+ * @brief Reads a consistent copy of the clock model of a virtual clock without
+ * locking out the writer.
+ *
+ * @param[in] pClock The virtual clock to read.
+ * @param[out] pModel This will be filled with the copy of the clock model.
+ */
+static void readClockModel( const SntpVirtualClock_t * pClock,
+                            SntpClockModel_t * pModel )
+{
+    const volatile SntpClockModel_t * pSource = &pClock->model;
+    uint32_t startSequence;
+    uint32_t endSequence;
+
+    assert( pClock != NULL );
+    assert( pModel != NULL );
+
+    /* Retry reading the model if the writer updated it during the read, which is
+     * represented by a change in, or an odd value of, the sequence counter. */
+    do
+    {
+        startSequence = pClock->sequence;
+        SNTP_CLOCK_MEMORY_BARRIER();
+
+        pModel->referenceTime.seconds = pSource->referenceTime.seconds;
+        pModel->referenceTime.fractions = pSource->referenceTime.fractions;
+        pModel->offset = pSource->offset;
+        pModel->frequency = pSource->frequency;
+        pModel->isSynchronized = pSource->isSynchronized;
+        pModel->leapSmear.type = pSource->leapSmear.type;
+        pModel->leapSmear.windowSecs = pSource->leapSmear.windowSecs;
+        pModel->leapSmear.leapTime.seconds = pSource->leapSmear.leapTime.seconds;
+        pModel->leapSmear.leapTime.fractions = pSource->leapSmear.leapTime.fractions;
+        pModel->leapSmear.leapSeconds = pSource->leapSmear.leapSeconds;
+        pModel->isLeapApplied = pSource->isLeapApplied;
+        pModel->jitter = pSource->jitter;
+        pModel->frequencyUncertainty = pSource->frequencyUncertainty;
+        pModel->isHoldover = pSource->isHoldover;
+
+        SNTP_CLOCK_MEMORY_BARRIER();
+        endSequence = pClock->sequence;
+    } while( ( startSequence != endSequence ) || ( ( startSequence & 1U ) != 0U ) );
+}
+
+/**
+ * @brief Publishes a new clock model for the readers of a virtual clock.
+ *
+ * @param[in, out] pClock The virtual clock to update.
+ * @param[in] pModel The new clock model.
+ */
+static void writeClockModel( SntpVirtualClock_t * pClock,
+                             const SntpClockModel_t * pModel )
+{
+    volatile SntpClockModel_t * pDestination = &pClock->model;
+
+    assert( pClock != NULL );
+    assert( pModel != NULL );
+
+    /* Make the sequence counter odd to represent an update in progress. */
+    pClock->sequence++;
+    SNTP_CLOCK_MEMORY_BARRIER();
+
+    pDestination->referenceTime.seconds = pModel->referenceTime.seconds;
+    pDestination->referenceTime.fractions = pModel->referenceTime.fractions;
+    pDestination->offset = pModel->offset;
+    pDestination->frequency = pModel->frequency;
+    pDestination->isSynchronized = pModel->isSynchronized;
+    pDestination->leapSmear.type = pModel->leapSmear.type;
+    pDestination->leapSmear.windowSecs = pModel->leapSmear.windowSecs;
+    pDestination->leapSmear.leapTime.seconds = pModel->leapSmear.leapTime.seconds;
+    pDestination->leapSmear.leapTime.fractions = pModel->leapSmear.leapTime.fractions;
+    pDestination->leapSmear.leapSeconds = pModel->leapSmear.leapSeconds;
+    pDestination->isLeapApplied = pModel->isLeapApplied;
+    pDestination->jitter = pModel->jitter;
+    pDestination->frequencyUncertainty = pModel->frequencyUncertainty;
+    pDestination->isHoldover = pModel->isHoldover;
+
+    /* Make the sequence counter even again to represent a complete update. */
+    SNTP_CLOCK_MEMORY_BARRIER();
+    pClock->sequence++;
+}
+
+SntpStatus_t Sntp_InitVirtualClock( SntpVirtualClock_t * pClock )
+{
+    SntpStatus_t status = SntpSuccess;
+
+    if( pClock == NULL )
+    {
+        status = SntpErrorBadParameter;
+    }
+    else
+    {
+        ( void ) memset( pClock, 0, sizeof( SntpVirtualClock_t ) );
+    }
+
+    return status;
+}
+
+SntpStatus_t Sntp_UpdateVirtualClock( SntpVirtualClock_t * pClock,
+                                      const SntpTimestamp_t * pLocalTime,
+                                      int64_t clockOffset )
+{
+    SntpStatus_t status = SntpSuccess;
+
+    if( ( pClock == NULL ) || ( pLocalTime == NULL ) )
+    {
+        status = SntpErrorBadParameter;
+    }
+    else
+    {
+        SntpClockModel_t model;
+
+        /* As there is a single writer, the model can be read directly. */
+        model = pClock->model;
+
+        if( model.isSynchronized == true )
+        {
+            int64_t elapsedTime = Sntp_FixedDifference( Sntp_FixedFromTimestamp( *pLocalTime ),
+                                                        Sntp_FixedFromTimestamp( model.referenceTime ) );
+            int64_t predictedOffset = model.offset + calculateDrift( model.frequency, elapsedTime );
+
+            /* Server time is stepped by the leap second, so the first sample after
+             * the leap second includes the step in the clock offset. */
+            if( ( model.leapSmear.leapSeconds != 0 ) && ( model.isLeapApplied == false ) &&
+                ( Sntp_FixedCompare( Sntp_FixedFromTimestamp( *pLocalTime ) + ( uint64_t ) predictedOffset,
+                                     Sntp_FixedFromTimestamp( model.leapSmear.leapTime ) ) >= 0 ) )
+            {
+                predictedOffset -= leapSecondsToFixedPoint( &model.leapSmear );
+                model.isLeapApplied = true;
+            }
+
+            /* The prediction errors of the model represent the stability of the
+             * local clock. */
+            model.jitter = updateMovingAverage( model.jitter, Sntp_FixedMagnitude( clockOffset - predictedOffset ) );
+
+            /* Refine the frequency correction only when the samples are at least
+             * a second apart so that the measured frequency error is meaningful. */
+            if( elapsedTime >= SNTP_FIXED_SECOND )
+            {
+                int64_t frequencyError = ( clockOffset - predictedOffset ) /
+                                         ( elapsedTime / SNTP_FIXED_SECOND );
+                int64_t frequency = ( int64_t ) model.frequency + ( frequencyError / FREQUENCY_UPDATE_GAIN );
+                uint64_t frequencyErrorMagnitude = Sntp_FixedMagnitude( frequencyError );
+
+                /* Limit the frequency error to the largest possible difference
+                 * between the frequency correction and the frequency of the clock. */
+                if( frequencyErrorMagnitude > ( 2U * ( uint64_t ) MAX_FREQUENCY_CORRECTION ) )
+                {
+                    frequencyErrorMagnitude = 2U * ( uint64_t ) MAX_FREQUENCY_CORRECTION;
+                }
+
+                model.frequencyUncertainty = ( int32_t ) updateMovingAverage( ( uint64_t ) model.frequencyUncertainty,
+                                                                              frequencyErrorMagnitude );
+
+                if( frequency > MAX_FREQUENCY_CORRECTION )
+                {
+                    frequency = MAX_FREQUENCY_CORRECTION;
+                }
+                else if( frequency < -MAX_FREQUENCY_CORRECTION )
+                {
+                    frequency = -MAX_FREQUENCY_CORRECTION;
+                }
+                else
+                {
+                    /* Empty else MISRA 15.7 */
+                }
+
+                model.frequency = ( int32_t ) frequency;
+            }
+        }
+        else
+        {
+            /* The stability of the local clock is unknown until it is measured
+             * from the prediction errors of later samples. */
+            model.jitter = 0U;
+            model.frequencyUncertainty = SNTP_CLOCK_INITIAL_FREQUENCY_UNCERTAINTY_PPM *
+                                         ( int32_t ) SNTP_FRACTION_VALUE_PER_MICROSECOND;
+        }
+
+        model.referenceTime = *pLocalTime;
+        model.offset = clockOffset;
+        model.isSynchronized = true;
+        model.isHoldover = false;
+
+        /* Clear the leap second once it has been completely applied. */
+        if( ( model.isLeapApplied == true ) &&
+            ( calculateLeapAdjustment( &model.leapSmear,
+                                       Sntp_FixedFromTimestamp( *pLocalTime ) + ( uint64_t ) clockOffset +
+                                       ( uint64_t ) leapSecondsToFixedPoint( &model.leapSmear ) ) ==
+              ( uint64_t ) SNTP_FIXED_SECOND ) )
+        {
+            model.leapSmear.leapSeconds = 0;
+            model.isLeapApplied = false;
+        }
+
+        writeClockModel( pClock, &model );
+    }
+
+    return status;
+}
+
+SntpStatus_t Sntp_GetCorrectedTime( const SntpVirtualClock_t * pClock,
+                                    const SntpTimestamp_t * pLocalTime,
+                                    SntpTimestamp_t * pCorrectedTime )
+{
+    SntpStatus_t status = SntpSuccess;
+
+    if( ( pClock == NULL ) || ( pLocalTime == NULL ) || ( pCorrectedTime == NULL ) )
+    {
+        status = SntpErrorBadParameter;
+    }
+    else
+    {
+        SntpClockModel_t model;
+
+        readClockModel( pClock, &model );
+
+        if( model.isSynchronized == false )
+        {
+            status = SntpClockNotSynchronized;
+        }
+        else
+        {
+            SntpFixedTime_t localTime = Sntp_FixedFromTimestamp( *pLocalTime );
+            int64_t elapsedTime = Sntp_FixedDifference( localTime, Sntp_FixedFromTimestamp( model.referenceTime ) );
+
+            /* Corrected Time = Local Time + Offset + Drift since last update.
+             * The unsigned modulo 2^64 arithmetic handles the SNTP era wrap-around. */
+            SntpFixedTime_t correctedTime = localTime +
+                                     ( uint64_t ) model.offset +
+                                     ( uint64_t ) calculateDrift( model.frequency, elapsedTime );
+
+            if( model.leapSmear.leapSeconds != 0 )
+            {
+                /* Move the corrected time to the continuous timescale if the offset
+                 * already includes the leap second step. */
+                if( model.isLeapApplied == true )
+                {
+                    correctedTime += ( uint64_t ) leapSecondsToFixedPoint( &model.leapSmear );
+                }
+
+                correctedTime = applyLeapSecond( &model.leapSmear, correctedTime );
+            }
+
+            *pCorrectedTime = Sntp_FixedToTimestamp( correctedTime );
+        }
+    }
+
+    return status;
+}
+
+SntpStatus_t Sntp_GetCorrectedUnixTime( const SntpVirtualClock_t * pClock,
+                                        const SntpTimestamp_t * pLocalTime,
+                                        uint32_t * pUnixTimeSecs,
+                                        uint32_t * pUnixTimeMicrosecs )
+{
+    SntpStatus_t status = SntpSuccess;
+    SntpTimestamp_t correctedTime;
+
+    if( ( pUnixTimeSecs == NULL ) || ( pUnixTimeMicrosecs == NULL ) )
+    {
+        status = SntpErrorBadParameter;
+    }
+    else
+    {
+        status = Sntp_GetCorrectedTime( pClock, pLocalTime, &correctedTime );
+    }
+
+    if( status == SntpSuccess )
+    {
+        status = Sntp_ConvertToUnixTime( &correctedTime, pUnixTimeSecs, pUnixTimeMicrosecs );
+    }
+
+    return status;
+}
+
+SntpStatus_t Sntp_EnterVirtualClockHoldover( SntpVirtualClock_t * pClock )
+{
+    SntpStatus_t status = SntpSuccess;
+
+    if( pClock == NULL )
+    {
+        status = SntpErrorBadParameter;
+    }
+    else if( pClock->model.isSynchronized == false )
+    {
+        status = SntpClockNotSynchronized;
+    }
+    else if( pClock->model.isHoldover == false )
+    {
+        SntpClockModel_t model = pClock->model;
+
+        model.isHoldover = true;
+
+        writeClockModel( pClock, &model );
+    }
+    else
+    {
+        /* The virtual clock is already in holdover. */
+    }
+
+    return status;
+}
+
+SntpStatus_t Sntp_GetVirtualClockErrorBound( const SntpVirtualClock_t * pClock,
+                                             const SntpTimestamp_t * pLocalTime,
+                                             SntpClockState_t * pState,
+                                             uint64_t * pErrorBound )
+{
+    SntpStatus_t status = SntpSuccess;
+
+    if( ( pClock == NULL ) || ( pLocalTime == NULL ) || ( pState == NULL ) || ( pErrorBound == NULL ) )
+    {
+        status = SntpErrorBadParameter;
+    }
+    else
+    {
+        SntpClockModel_t model;
+
+        readClockModel( pClock, &model );
+
+        if( model.isSynchronized == false )
+        {
+            *pState = SntpClockStateUnsynchronized;
+            status = SntpClockNotSynchronized;
+        }
+        else
+        {
+            int64_t age = Sntp_FixedDifference( Sntp_FixedFromTimestamp( *pLocalTime ),
+                                                Sntp_FixedFromTimestamp( model.referenceTime ) );
+
+            *pState = ( model.isHoldover == true ) ? SntpClockStateHoldover : SntpClockStateSynchronized;
+
+            /* The error of the predicted time grows with the time since the last
+             * sample, in either direction. */
+            *pErrorBound = model.jitter +
+                           ( uint64_t ) calculateDrift( model.frequencyUncertainty,
+                                                        ( int64_t ) Sntp_FixedMagnitude( age ) );
+        }
+    }
+
+    return status;
+}
+
+SntpStatus_t Sntp_SetVirtualClockLeapSmear( SntpVirtualClock_t * pClock,
+                                            SntpLeapSmearType_t type,
+                                            uint32_t windowSecs )
+{
+    SntpStatus_t status = SntpSuccess;
+
+    if( ( pClock == NULL ) || ( type > SntpLeapSmearCosine ) ||
+        ( ( type != SntpLeapSmearNone ) && ( windowSecs == 0U ) ) )
+    {
+        status = SntpErrorBadParameter;
+    }
+    else
+    {
+        SntpClockModel_t model = pClock->model;
+
+        model.leapSmear.type = type;
+        model.leapSmear.windowSecs = windowSecs;
+
+        writeClockModel( pClock, &model );
+    }
+
+    return status;
+}
+
+SntpStatus_t Sntp_ScheduleVirtualClockLeapSecond( SntpVirtualClock_t * pClock,
+                                                  const SntpTimestamp_t * pServerTime,
+                                                  SntpLeapSecondInfo_t leapSecondType )
+{
+    SntpStatus_t status = SntpSuccess;
+
+    if( pClock == NULL )
+    {
+        status = SntpErrorBadParameter;
+    }
+    else
+    {
+        SntpClockModel_t model = pClock->model;
+
+        /* Once the leap second has occurred, it is kept until it is completely
+         * applied, irrespective of the announcements of servers. */
+        if( model.isLeapApplied == false )
+        {
+            status = Sntp_ScheduleLeapSecond( &model.leapSmear, pServerTime, leapSecondType );
+
+            if( status == SntpSuccess )
+            {
+                writeClockModel( pClock, &model );
+            }
+        }
+    }
+
+    return status;
+}
+
+SntpStatus_t Sntp_ScheduleLeapSecond( SntpLeapSmear_t * pLeapSmear,
+                                      const SntpTimestamp_t * pServerTime,
+                                      SntpLeapSecondInfo_t leapSecondType )
+{
+    SntpStatus_t status = SntpSuccess;
+
+    if( ( pLeapSmear == NULL ) || ( pServerTime == NULL ) ||
+        ( leapSecondType > AlarmServerNotSynchronized ) )
+    {
+        status = SntpErrorBadParameter;
+    }
+    else if( leapSecondType == NoLeapSecond )
+    {
+        pLeapSmear->leapSeconds = 0;
+    }
+    else if( leapSecondType == LastMinuteHas61Seconds )
+    {
+        /* Time is stepped back by the inserted leap second at the end of the
+         * month. */
+        calculateEndOfMonth( pServerTime, &pLeapSmear->leapTime );
+        pLeapSmear->leapSeconds = 1;
+    }
+    else if( leapSecondType == LastMinuteHas59Seconds )
+    {
+        /* Time is stepped forward to the end of the month at the start of the
+         * deleted leap second, i.e. a second before the end of the month. */
+        calculateEndOfMonth( pServerTime, &pLeapSmear->leapTime );
+        pLeapSmear->leapTime.seconds--;
+        pLeapSmear->leapSeconds = -1;
+    }
+    else
+    {
+        /* The server time is not reliable for leap second information. */
+    }
+
+    return status;
+}
+
+SntpStatus_t Sntp_ApplyLeapSmear( const SntpLeapSmear_t * pLeapSmear,
+                                  const SntpTimestamp_t * pTime,
+                                  SntpTimestamp_t * pSmearedTime )
+{
+    SntpStatus_t status = SntpSuccess;
+
+    if( ( pLeapSmear == NULL ) || ( pTime == NULL ) || ( pSmearedTime == NULL ) )
+    {
+        status = SntpErrorBadParameter;
+    }
+    else if( ( pLeapSmear->type > SntpLeapSmearCosine ) ||
+             ( ( pLeapSmear->type != SntpLeapSmearNone ) && ( pLeapSmear->windowSecs == 0U ) ) ||
+             ( pLeapSmear->leapSeconds > 1 ) || ( pLeapSmear->leapSeconds < -1 ) )
+    {
+        status = SntpErrorBadParameter;
+    }
+    else
+    {
+        *pSmearedTime = Sntp_FixedToTimestamp( applyLeapSecond( pLeapSmear, Sntp_FixedFromTimestamp( *pTime ) ) );
+    }
+
+    return status;
+}
@@ -0,0 +1,252 @@
+/*
+ * coreSNTP v1.0.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file core_sntp_filter.c
+ * @brief Implementation of the outlier gate API of the coreSNTP library.
+ */
+
+/* Standard includes. */
+#include <string.h>
+#include <assert.h>
+
+/* Include API header. */
+#include "core_sntp_filter.h"
+
+/**
+ * @brief The lowest jitter used by the outlier gate, in units of SNTP timestamp
+ * fractions.
+ */
+#define MIN_JITTER    ( ( uint64_t ) SNTP_OUTLIER_GATE_MIN_JITTER_US * SNTP_FRACTION_VALUE_PER_MICROSECOND )
+
+/**
+ * @brief Calculates the magnitude of the difference between two values without
+ * overflow.
+ *
+ * @param[in] first The first value.
+ * @param[in] second The second value.
+ *
+ * @return The magnitude of ( @p first - @p second ).
+ */
+static uint64_t absoluteDifference( int64_t first,
+                                    int64_t second )
+{
+    /* The modulo arithmetic of unsigned integers provides the correct magnitude
+     * even if the signed difference does not fit in 64 bits. */
+    return ( first >= second ) ? ( ( uint64_t ) first - ( uint64_t ) second ) :
+           ( ( uint64_t ) second - ( uint64_t ) first );
+}
+
+/**
+ * @brief Calculates the deviation from the reference of a gate beyond which a
+ * sample is an outlier.
+ *
+ * @param[in] jitter The jitter measured in the history of the gate.
+ * @param[in] thresholdMultiplier The multiple of the jitter to use.
+ *
+ * @return The threshold multiple of the jitter, which saturates at UINT64_MAX.
+ */
+static uint64_t calculateThreshold( uint64_t jitter,
+                                    uint32_t thresholdMultiplier )
+{
+    uint64_t threshold = UINT64_MAX;
+
+    assert( thresholdMultiplier > 0U );
+
+    if( jitter < MIN_JITTER )
+    {
+        jitter = MIN_JITTER;
+    }
+
+    if( jitter <= ( UINT64_MAX / thresholdMultiplier ) )
+    {
+        threshold = jitter * thresholdMultiplier;
+    }
+
+    return threshold;
+}
+
+/**
+ * @brief Determines whether a sample deviates from the history of the gate by
+ * more than the threshold multiple of the jitter.
+ *
+ * @param[in] pGate The outlier gate, which MUST have at least
+ * #SNTP_OUTLIER_GATE_MIN_SAMPLES samples in its history.
+ * @param[in] clockOffset The clock offset of the sample.
+ * @param[in] roundTripDelay The round-trip delay of the sample.
+ *
+ * @return `true` if the sample is an outlier; `false` otherwise.
+ */
+static bool isOutlier( const SntpOutlierGate_t * pGate,
+                       int64_t clockOffset,
+                       int64_t roundTripDelay )
+{
+    uint64_t offsetJitter = 0U;
+    uint64_t delayJitter = 0U;
+    int64_t minDelay;
+    int64_t lastOffset;
+    size_t oldestIndex, index, i;
+
+    assert( pGate != NULL );
+    assert( pGate->numOfSamples >= SNTP_OUTLIER_GATE_MIN_SAMPLES );
+
+    oldestIndex = ( pGate->nextSampleIndex + SNTP_OUTLIER_GATE_HISTORY_SIZE - pGate->numOfSamples ) %
+                  SNTP_OUTLIER_GATE_HISTORY_SIZE;
+    lastOffset = pGate->offsetHistory[ oldestIndex ];
+    minDelay = pGate->delayHistory[ oldestIndex ];
+
+    /* Average the differences between successive offsets from the oldest to the
+     * latest sample, which leaves out the trend of a slowly drifting clock. Each
+     * difference is divided before summing to avoid overflow. */
+    for( i = 1U; i < pGate->numOfSamples; i++ )
+    {
+        index = ( oldestIndex + i ) % SNTP_OUTLIER_GATE_HISTORY_SIZE;
+
+        offsetJitter += absoluteDifference( pGate->offsetHistory[ index ], lastOffset ) /
+                        ( pGate->numOfSamples - 1U );
+        lastOffset = pGate->offsetHistory[ index ];
+
+        if( pGate->delayHistory[ index ] < minDelay )
+        {
+            minDelay = pGate->delayHistory[ index ];
+        }
+    }
+
+    /* The lowest delay is the least affected by network queuing, so the delay
+     * jitter is measured as the average excess over it. */
+    for( i = 0U; i < pGate->numOfSamples; i++ )
+    {
+        index = ( oldestIndex + i ) % SNTP_OUTLIER_GATE_HISTORY_SIZE;
+
+        delayJitter += absoluteDifference( pGate->delayHistory[ index ], minDelay ) / pGate->numOfSamples;
+    }
+
+    return ( absoluteDifference( clockOffset, lastOffset ) >
+             calculateThreshold( offsetJitter, pGate->thresholdMultiplier ) ) ||
+           ( ( roundTripDelay > minDelay ) &&
+             ( absoluteDifference( roundTripDelay, minDelay ) >
+               calculateThreshold( delayJitter, pGate->thresholdMultiplier ) ) );
+}
+
+/**
+ * @brief Adds an accepted sample to the history of the gate, replacing the
+ * oldest sample if the history is full.
+ *
+ * @param[in, out] pGate The outlier gate.
+ * @param[in] clockOffset The clock offset of the sample.
+ * @param[in] roundTripDelay The round-trip delay of the sample.
+ */
+static void addSample( SntpOutlierGate_t * pGate,
+                       int64_t clockOffset,
+                       int64_t roundTripDelay )
+{
+    assert( pGate != NULL );
+
+    pGate->offsetHistory[ pGate->nextSampleIndex ] = clockOffset;
+    pGate->delayHistory[ pGate->nextSampleIndex ] = roundTripDelay;
+    pGate->nextSampleIndex = ( pGate->nextSampleIndex + 1U ) % SNTP_OUTLIER_GATE_HISTORY_SIZE;
+
+    if( pGate->numOfSamples < SNTP_OUTLIER_GATE_HISTORY_SIZE )
+    {
+        pGate->numOfSamples++;
+    }
+}
+
+SntpStatus_t Sntp_InitOutlierGate( SntpOutlierGate_t * pGate,
+                                   uint32_t thresholdMultiplier,
+                                   uint32_t maxConsecutiveRejections )
+{
+    SntpStatus_t status = SntpSuccess;
+
+    if( ( pGate == NULL ) || ( thresholdMultiplier == 0U ) )
+    {
+        status = SntpErrorBadParameter;
+    }
+    else
+    {
+        ( void ) memset( pGate, 0, sizeof( SntpOutlierGate_t ) );
+
+        pGate->thresholdMultiplier = thresholdMultiplier;
+        pGate->maxConsecutiveRejections = maxConsecutiveRejections;
+    }
+
+    return status;
+}
+
+SntpStatus_t Sntp_ResetOutlierGate( SntpOutlierGate_t * pGate )
+{
+    SntpStatus_t status = SntpSuccess;
+
+    if( pGate == NULL )
+    {
+        status = SntpErrorBadParameter;
+    }
+    else
+    {
+        pGate->numOfSamples = 0U;
+        pGate->nextSampleIndex = 0U;
+        pGate->consecutiveRejections = 0U;
+    }
+
+    return status;
+}
+
+SntpStatus_t Sntp_FilterSample( SntpOutlierGate_t * pGate,
+                                int64_t clockOffset,
+                                int64_t roundTripDelay )
+{
+    SntpStatus_t status = SntpSuccess;
+
+    if( pGate == NULL )
+    {
+        status = SntpErrorBadParameter;
+    }
+    else
+    {
+        bool isDeviating = false;
+
+        if( pGate->numOfSamples >= SNTP_OUTLIER_GATE_MIN_SAMPLES )
+        {
+            isDeviating = isOutlier( pGate, clockOffset, roundTripDelay );
+        }
+
+        if( ( isDeviating == true ) && ( pGate->consecutiveRejections < pGate->maxConsecutiveRejections ) )
+        {
+            pGate->consecutiveRejections++;
+            status = SntpRejectedResponseOutlier;
+        }
+        else
+        {
+            if( isDeviating == true )
+            {
+                /* The deviation has persisted, so the history no longer represents
+                 * the samples, and is restarted from this sample. */
+                ( void ) Sntp_ResetOutlierGate( pGate );
+            }
+
+            pGate->consecutiveRejections = 0U;
+            addSample( pGate, clockOffset, roundTripDelay );
+        }
+    }
+
+    return status;
+}
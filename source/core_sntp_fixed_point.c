@@ -0,0 +1,155 @@
+/*
+ * coreSNTP v1.0.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file core_sntp_fixed_point.c
+ * @brief Implementation of the fixed-point time arithmetic API of the coreSNTP
+ * library.
+ */
+
+/* Include API header. */
+#include "core_sntp_fixed_point.h"
+
+/**
+ * @brief The number of nanoseconds in a second.
+ */
+#define NANOSECONDS_PER_SECOND    ( 1000000000U )
+
+/**
+ * @brief Calculates the magnitude of a signed 64-bit value without branches.
+ *
+ * The sign bit is read from the unsigned representation, as the right shift
+ * of a negative value is implementation-defined.
+ *
+ * @param[in] value The value.
+ * @param[out] pSignMask This is filled with all bits set if @p value is
+ * negative, and zero otherwise.
+ *
+ * @return The magnitude of @p value, which is correct for INT64_MIN too.
+ */
+static uint64_t magnitudeOf( int64_t value,
+                             uint64_t * pSignMask )
+{
+    uint64_t signMask = 0U - ( ( uint64_t ) value >> 63 );
+
+    *pSignMask = signMask;
+
+    /* Two's complement negation when negative: invert the bits and add one. */
+    return ( ( uint64_t ) value ^ signMask ) - signMask;
+}
+
+/**
+ * @brief Applies the sign of a mask from @ref magnitudeOf to a magnitude,
+ * without branches.
+ *
+ * @param[in] magnitude The magnitude, which MUST fit in 63 bits.
+ * @param[in] signMask The sign mask.
+ *
+ * @return The signed value.
+ */
+static int64_t applySign( uint64_t magnitude,
+                          uint64_t signMask )
+{
+    return ( int64_t ) ( ( magnitude ^ signMask ) - signMask );
+}
+
+SntpFixedTime_t Sntp_FixedFromTimestamp( SntpTimestamp_t time )
+{
+    return ( ( ( uint64_t ) time.seconds ) << 32 ) | ( uint64_t ) time.fractions;
+}
+
+SntpTimestamp_t Sntp_FixedToTimestamp( SntpFixedTime_t time )
+{
+    SntpTimestamp_t timestamp;
+
+    timestamp.seconds = ( uint32_t ) ( time >> 32 );
+    timestamp.fractions = ( uint32_t ) time;
+
+    return timestamp;
+}
+
+int64_t Sntp_FixedDifference( SntpFixedTime_t later,
+                              SntpFixedTime_t earlier )
+{
+    /* The modulo 2^64 subtraction handles the SNTP era wrap-around. */
+    return ( int64_t ) ( later - earlier );
+}
+
+SntpFixedTime_t Sntp_FixedMidpoint( SntpFixedTime_t first,
+                                    SntpFixedTime_t second )
+{
+    uint64_t signMask;
+    uint64_t halfMagnitude = magnitudeOf( Sntp_FixedDifference( second, first ), &signMask ) / 2U;
+
+    /* Add half of the signed duration from the first time. */
+    return first + ( ( halfMagnitude ^ signMask ) - signMask );
+}
+
+int32_t Sntp_FixedCompare( SntpFixedTime_t first,
+                           SntpFixedTime_t second )
+{
+    int64_t difference = Sntp_FixedDifference( first, second );
+
+    return ( int32_t ) ( difference > 0 ) - ( int32_t ) ( difference < 0 );
+}
+
+uint64_t Sntp_FixedMagnitude( int64_t duration )
+{
+    uint64_t signMask;
+
+    return magnitudeOf( duration, &signMask );
+}
+
+uint64_t Sntp_FixedScale( uint64_t duration,
+                          uint32_t factor )
+{
+    /* Split the duration into seconds and fractions, so that neither product
+     * overflows 64 bits. */
+    return ( ( duration >> 32 ) * factor ) +
+           ( ( ( duration & UINT32_MAX ) * factor ) >> 32 );
+}
+
+int64_t Sntp_FixedToNanoseconds( int64_t duration )
+{
+    uint64_t signMask;
+    uint64_t magnitude = magnitudeOf( duration, &signMask );
+
+    /* Split the magnitude into seconds and fractions, so that the products
+     * cannot overflow 64 bits. A magnitude below 2^63 fractions is below
+     * 2^31 seconds, which is less than 2^61 nanoseconds. */
+    magnitude = ( ( magnitude >> 32 ) * NANOSECONDS_PER_SECOND ) +
+                ( ( ( magnitude & UINT32_MAX ) * NANOSECONDS_PER_SECOND ) >> 32 );
+
+    return applySign( magnitude, signMask );
+}
+
+int64_t Sntp_FixedFromNanoseconds( int64_t nanoseconds )
+{
+    uint64_t signMask;
+    uint64_t magnitude = magnitudeOf( nanoseconds, &signMask );
+
+    /* The remainder is below 2^30, so the shifted value fits in 62 bits. */
+    magnitude = ( ( magnitude / NANOSECONDS_PER_SECOND ) << 32 ) +
+                ( ( ( magnitude % NANOSECONDS_PER_SECOND ) << 32 ) / NANOSECONDS_PER_SECOND );
+
+    return applySign( magnitude, signMask );
+}
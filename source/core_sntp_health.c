@@ -0,0 +1,476 @@
+/*
+ * coreSNTP v1.0.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file core_sntp_health.c
+ * @brief Implementation of the server health API of the coreSNTP library.
+ */
+
+/* Standard includes. */
+#include <string.h>
+#include <assert.h>
+
+/* Include API header. */
+#include "core_sntp_health.h"
+#include "core_sntp_fixed_point.h"
+
+/**
+ * @brief The number of nanoseconds in a microsecond.
+ */
+#define NANOSECONDS_PER_MICROSECOND    ( 1000 )
+
+/**
+ * @brief The magic word at the start of the saved health, "SNH1".
+ */
+#define HEALTH_SAVED_MAGIC             ( 0x534E4831U )
+
+/**
+ * @brief The size, in bytes, of a word of the saved health.
+ */
+#define HEALTH_WORD_SIZE               ( 4U )
+
+/**
+ * @brief The number of words of the saved health of a server.
+ */
+#define HEALTH_WORDS_PER_SERVER        ( 6U )
+
+/**
+ * @brief The size, in bytes, of the header of the saved health, made of the
+ * magic word and the number of servers.
+ */
+#define HEALTH_SAVED_HEADER_SIZE       ( 2U * HEALTH_WORD_SIZE )
+
+/**
+ * @brief The size, in bytes, of the saved health of a server.
+ */
+#define HEALTH_SAVED_SERVER_SIZE       ( HEALTH_WORDS_PER_SERVER * HEALTH_WORD_SIZE )
+
+/**
+ * @brief Updates a decaying rate with an outcome.
+ *
+ * @param[in] rate The rate, in parts of #SNTP_HEALTH_MAX_SCORE.
+ * @param[in] isOccurred Whether the outcome counted by the rate occurred.
+ *
+ * @return The updated rate.
+ */
+static uint32_t decayRate( uint32_t rate,
+                           bool isOccurred )
+{
+    uint32_t roundUp = ( 1UL << SNTP_HEALTH_DECAY_SHIFT ) - 1U;
+    uint32_t updatedRate;
+
+    assert( rate <= SNTP_HEALTH_MAX_SCORE );
+
+    /* The step is rounded up, so that the rate reaches both of its limits
+     * instead of stopping short of them. */
+    if( isOccurred == true )
+    {
+        updatedRate = rate + ( ( ( SNTP_HEALTH_MAX_SCORE - rate ) + roundUp ) >> SNTP_HEALTH_DECAY_SHIFT );
+    }
+    else
+    {
+        updatedRate = rate - ( ( rate + roundUp ) >> SNTP_HEALTH_DECAY_SHIFT );
+    }
+
+    return updatedRate;
+}
+
+/**
+ * @brief Records the round-trip delay of a successful response in the decaying
+ * averages of the delay and the jitter of a server.
+ *
+ * @param[in, out] pHealth The health of the server.
+ * @param[in] roundTripDelayFractions The round-trip delay, in SNTP timestamp
+ * fractions.
+ */
+static void recordRoundTripDelay( SntpServerHealth_t * pHealth,
+                                  int64_t roundTripDelayFractions )
+{
+    int64_t delayNs;
+    int64_t delayUs;
+    int64_t deviationUs;
+
+    assert( pHealth != NULL );
+
+    delayNs = Sntp_FixedToNanoseconds( roundTripDelayFractions );
+    delayUs = ( delayNs > 0 ) ? ( delayNs / NANOSECONDS_PER_MICROSECOND ) : 0;
+
+    if( delayUs > ( int64_t ) UINT32_MAX )
+    {
+        delayUs = ( int64_t ) UINT32_MAX;
+    }
+
+    if( pHealth->numOfResponses == 0U )
+    {
+        pHealth->roundTripDelayUs = ( uint32_t ) delayUs;
+        pHealth->jitterUs = 0U;
+    }
+    else
+    {
+        /* The jitter is updated with the deviation from the average delay
+         * before the delay updates it. The division of a negative difference
+         * truncates towards zero, which keeps the averages in range. */
+        deviationUs = delayUs - ( int64_t ) pHealth->roundTripDelayUs;
+        deviationUs = ( deviationUs < 0 ) ? -deviationUs : deviationUs;
+
+        pHealth->jitterUs = ( uint32_t ) ( ( int64_t ) pHealth->jitterUs +
+                                           ( ( deviationUs - ( int64_t ) pHealth->jitterUs ) /
+                                             ( ( int64_t ) 1 << SNTP_HEALTH_DECAY_SHIFT ) ) );
+        pHealth->roundTripDelayUs = ( uint32_t ) ( ( int64_t ) pHealth->roundTripDelayUs +
+                                                   ( ( delayUs - ( int64_t ) pHealth->roundTripDelayUs ) /
+                                                     ( ( int64_t ) 1 << SNTP_HEALTH_DECAY_SHIFT ) ) );
+    }
+
+    if( pHealth->numOfResponses < UINT32_MAX )
+    {
+        pHealth->numOfResponses++;
+    }
+}
+
+/**
+ * @brief Calculates the health score of a server.
+ *
+ * @param[in] pHealth The health of the server.
+ *
+ * @return The score, from 0 to #SNTP_HEALTH_MAX_SCORE.
+ */
+static uint32_t calculateScore( const SntpServerHealth_t * pHealth )
+{
+    uint64_t score;
+    uint64_t delayUs;
+
+    assert( pHealth != NULL );
+    assert( pHealth->successRate <= SNTP_HEALTH_MAX_SCORE );
+    assert( pHealth->kissOfDeathRate <= SNTP_HEALTH_MAX_SCORE );
+
+    score = ( ( uint64_t ) pHealth->successRate *
+              ( SNTP_HEALTH_MAX_SCORE - pHealth->kissOfDeathRate ) ) / SNTP_HEALTH_MAX_SCORE;
+
+    delayUs = ( uint64_t ) pHealth->roundTripDelayUs +
+              ( ( uint64_t ) SNTP_HEALTH_JITTER_MULTIPLIER * pHealth->jitterUs );
+
+    score = ( score * SNTP_HEALTH_REFERENCE_DELAY_US ) / ( SNTP_HEALTH_REFERENCE_DELAY_US + delayUs );
+
+    return ( uint32_t ) score;
+}
+
+/**
+ * @brief Writes a word to a buffer in network byte order.
+ *
+ * @param[out] pBuffer The buffer of at least #HEALTH_WORD_SIZE bytes.
+ * @param[in] word The word to write.
+ */
+static void saveHealthWord( uint8_t * pBuffer,
+                            uint32_t word )
+{
+    assert( pBuffer != NULL );
+
+    pBuffer[ 0 ] = ( uint8_t ) ( word >> 24 );
+    pBuffer[ 1 ] = ( uint8_t ) ( word >> 16 );
+    pBuffer[ 2 ] = ( uint8_t ) ( word >> 8 );
+    pBuffer[ 3 ] = ( uint8_t ) word;
+}
+
+/**
+ * @brief Reads a word from a buffer in network byte order.
+ *
+ * @param[in] pBuffer The buffer of at least #HEALTH_WORD_SIZE bytes.
+ *
+ * @return The word.
+ */
+static uint32_t loadHealthWord( const uint8_t * pBuffer )
+{
+    assert( pBuffer != NULL );
+
+    return ( ( uint32_t ) pBuffer[ 0 ] << 24 ) |
+           ( ( uint32_t ) pBuffer[ 1 ] << 16 ) |
+           ( ( uint32_t ) pBuffer[ 2 ] << 8 ) |
+           ( uint32_t ) pBuffer[ 3 ];
+}
+
+/**
+ * @brief Restores the saved health of a server into the server with the same
+ * identifier, if any.
+ *
+ * @param[in, out] pHealth The array of the health of the servers.
+ * @param[in] numOfServers The number of elements of @p pHealth.
+ * @param[in] pSaved The saved health of the server.
+ */
+static void restoreServer( SntpServerHealth_t * pHealth,
+                           size_t numOfServers,
+                           const uint8_t * pSaved )
+{
+    uint32_t serverId;
+    size_t index;
+    SntpServerHealth_t * pServer;
+
+    assert( pHealth != NULL );
+    assert( pSaved != NULL );
+
+    serverId = loadHealthWord( pSaved );
+
+    for( index = 0U; index < numOfServers; index++ )
+    {
+        pServer = &pHealth[ index ];
+
+        if( pServer->serverId == serverId )
+        {
+            pServer->successRate = loadHealthWord( &pSaved[ HEALTH_WORD_SIZE ] );
+            pServer->kissOfDeathRate = loadHealthWord( &pSaved[ 2U * HEALTH_WORD_SIZE ] );
+            pServer->roundTripDelayUs = loadHealthWord( &pSaved[ 3U * HEALTH_WORD_SIZE ] );
+            pServer->jitterUs = loadHealthWord( &pSaved[ 4U * HEALTH_WORD_SIZE ] );
+            pServer->numOfResponses = loadHealthWord( &pSaved[ 5U * HEALTH_WORD_SIZE ] );
+        }
+    }
+}
+
+SntpStatus_t Sntp_InitServerHealth( SntpServerHealth_t * pHealth,
+                                    size_t numOfServers )
+{
+    SntpStatus_t status = SntpSuccess;
+    size_t index;
+
+    if( ( pHealth == NULL ) || ( numOfServers == 0U ) )
+    {
+        status = SntpErrorBadParameter;
+    }
+    else
+    {
+        ( void ) memset( pHealth, 0, numOfServers * sizeof( SntpServerHealth_t ) );
+
+        /* A server without any outcome has a neutral success rate, so that
+         * it ranks below servers that respond and above servers that fail. */
+        for( index = 0U; index < numOfServers; index++ )
+        {
+            pHealth[ index ].successRate = SNTP_HEALTH_UNKNOWN_SCORE;
+        }
+    }
+
+    return status;
+}
+
+SntpStatus_t Sntp_RecordServerHealth( SntpServerHealth_t * pHealth,
+                                      SntpStatus_t status,
+                                      int64_t roundTripDelayFractions )
+{
+    SntpStatus_t returnStatus = SntpSuccess;
+
+    if( pHealth == NULL )
+    {
+        returnStatus = SntpErrorBadParameter;
+    }
+    else
+    {
+        switch( status )
+        {
+            case SntpSuccess:
+            case SntpClockOffsetOverflow:
+            case SntpRejectedResponseOutlier:
+                pHealth->successRate = decayRate( pHealth->successRate, true );
+                pHealth->kissOfDeathRate = decayRate( pHealth->kissOfDeathRate, false );
+                recordRoundTripDelay( pHealth, roundTripDelayFractions );
+                break;
+
+            case SntpRejectedResponseChangeServer:
+            case SntpRejectedResponseRetryWithBackoff:
+            case SntpRejectedResponseOtherCode:
+                pHealth->successRate = decayRate( pHealth->successRate, false );
+                pHealth->kissOfDeathRate = decayRate( pHealth->kissOfDeathRate, true );
+                break;
+
+            case SntpErrorResponseTimeout:
+            case SntpErrorNetworkFailure:
+            case SntpErrorDnsFailure:
+            case SntpInvalidResponse:
+            case SntpServerNotAuthenticated:
+                pHealth->successRate = decayRate( pHealth->successRate, false );
+                pHealth->kissOfDeathRate = decayRate( pHealth->kissOfDeathRate, false );
+                break;
+
+            default:
+                /* The outcome does not depend on the server. */
+                break;
+        }
+    }
+
+    return returnStatus;
+}
+
+SntpStatus_t Sntp_GetServerHealthScore( const SntpServerHealth_t * pHealth,
+                                        uint32_t * pScore )
+{
+    SntpStatus_t status = SntpSuccess;
+
+    if( ( pHealth == NULL ) || ( pScore == NULL ) )
+    {
+        status = SntpErrorBadParameter;
+    }
+    else
+    {
+        *pScore = calculateScore( pHealth );
+    }
+
+    return status;
+}
+
+SntpStatus_t Sntp_SelectHealthiestServer( const SntpServerHealth_t * pHealth,
+                                          size_t numOfServers,
+                                          size_t excludedIndex,
+                                          size_t * pServerIndex )
+{
+    SntpStatus_t status = SntpSuccess;
+    size_t index;
+    size_t count;
+    size_t selectedIndex;
+    uint32_t score;
+    uint32_t bestScore = 0U;
+    bool isSelected = false;
+
+    if( ( pHealth == NULL ) || ( pServerIndex == NULL ) ||
+        ( numOfServers == 0U ) || ( excludedIndex > numOfServers ) )
+    {
+        status = SntpErrorBadParameter;
+    }
+    else
+    {
+        /* The servers are scanned in their order of priority starting after
+         * the excluded server, so that ties go to the next server. */
+        index = ( excludedIndex < numOfServers ) ? ( ( excludedIndex + 1U ) % numOfServers ) : 0U;
+        selectedIndex = ( excludedIndex < numOfServers ) ? excludedIndex : 0U;
+
+        for( count = 0U; count < numOfServers; count++ )
+        {
+            if( index != excludedIndex )
+            {
+                score = calculateScore( &pHealth[ index ] );
+
+                if( !isSelected || ( score > bestScore ) )
+                {
+                    selectedIndex = index;
+                    bestScore = score;
+                    isSelected = true;
+                }
+            }
+
+            index = ( index + 1U ) % numOfServers;
+        }
+
+        *pServerIndex = selectedIndex;
+    }
+
+    return status;
+}
+
+SntpStatus_t Sntp_SaveServerHealth( const SntpServerHealth_t * pHealth,
+                                    size_t numOfServers,
+                                    uint8_t * pBuffer,
+                                    size_t bufferSize,
+                                    size_t * pSavedSize )
+{
+    SntpStatus_t status = SntpSuccess;
+    size_t index;
+    uint8_t * pSaved;
+
+    if( ( pHealth == NULL ) || ( pBuffer == NULL ) || ( pSavedSize == NULL ) ||
+        ( numOfServers == 0U ) )
+    {
+        status = SntpErrorBadParameter;
+    }
+    else if( ( bufferSize < HEALTH_SAVED_HEADER_SIZE ) ||
+             ( ( ( bufferSize - HEALTH_SAVED_HEADER_SIZE ) / HEALTH_SAVED_SERVER_SIZE ) < numOfServers ) )
+    {
+        status = SntpErrorBufferTooSmall;
+    }
+    else
+    {
+        saveHealthWord( pBuffer, HEALTH_SAVED_MAGIC );
+        saveHealthWord( &pBuffer[ HEALTH_WORD_SIZE ], ( uint32_t ) numOfServers );
+
+        for( index = 0U; index < numOfServers; index++ )
+        {
+            pSaved = &pBuffer[ HEALTH_SAVED_HEADER_SIZE + ( index * HEALTH_SAVED_SERVER_SIZE ) ];
+
+            saveHealthWord( pSaved, pHealth[ index ].serverId );
+            saveHealthWord( &pSaved[ HEALTH_WORD_SIZE ], pHealth[ index ].successRate );
+            saveHealthWord( &pSaved[ 2U * HEALTH_WORD_SIZE ], pHealth[ index ].kissOfDeathRate );
+            saveHealthWord( &pSaved[ 3U * HEALTH_WORD_SIZE ], pHealth[ index ].roundTripDelayUs );
+            saveHealthWord( &pSaved[ 4U * HEALTH_WORD_SIZE ], pHealth[ index ].jitterUs );
+            saveHealthWord( &pSaved[ 5U * HEALTH_WORD_SIZE ], pHealth[ index ].numOfResponses );
+        }
+
+        *pSavedSize = SNTP_HEALTH_SAVED_SIZE( numOfServers );
+    }
+
+    return status;
+}
+
+SntpStatus_t Sntp_RestoreServerHealth( SntpServerHealth_t * pHealth,
+                                       size_t numOfServers,
+                                       const uint8_t * pBuffer,
+                                       size_t savedSize )
+{
+    SntpStatus_t status = SntpSuccess;
+    size_t numOfSaved = 0U;
+    size_t index;
+    const uint8_t * pSaved;
+
+    if( ( pHealth == NULL ) || ( pBuffer == NULL ) || ( numOfServers == 0U ) ||
+        ( savedSize < HEALTH_SAVED_HEADER_SIZE ) ||
+        ( loadHealthWord( pBuffer ) != HEALTH_SAVED_MAGIC ) )
+    {
+        status = SntpErrorBadParameter;
+    }
+    else
+    {
+        numOfSaved = ( size_t ) loadHealthWord( &pBuffer[ HEALTH_WORD_SIZE ] );
+
+        if( ( ( ( savedSize - HEALTH_SAVED_HEADER_SIZE ) % HEALTH_SAVED_SERVER_SIZE ) != 0U ) ||
+            ( ( ( savedSize - HEALTH_SAVED_HEADER_SIZE ) / HEALTH_SAVED_SERVER_SIZE ) != numOfSaved ) )
+        {
+            status = SntpErrorBadParameter;
+        }
+    }
+
+    /* The saved health is validated before any server is changed, so that
+     * corrupted data is rejected as a whole. */
+    for( index = 0U; ( status == SntpSuccess ) && ( index < numOfSaved ); index++ )
+    {
+        pSaved = &pBuffer[ HEALTH_SAVED_HEADER_SIZE + ( index * HEALTH_SAVED_SERVER_SIZE ) ];
+
+        if( ( loadHealthWord( &pSaved[ HEALTH_WORD_SIZE ] ) > SNTP_HEALTH_MAX_SCORE ) ||
+            ( loadHealthWord( &pSaved[ 2U * HEALTH_WORD_SIZE ] ) > SNTP_HEALTH_MAX_SCORE ) )
+        {
+            status = SntpErrorBadParameter;
+        }
+    }
+
+    if( status == SntpSuccess )
+    {
+        for( index = 0U; index < numOfSaved; index++ )
+        {
+            restoreServer( pHealth, numOfServers,
+                           &pBuffer[ HEALTH_SAVED_HEADER_SIZE + ( index * HEALTH_SAVED_SERVER_SIZE ) ] );
+        }
+    }
+
+    return status;
+}
@@ -0,0 +1,319 @@
+/*
+ * coreSNTP v1.0.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file core_sntp_histogram.c
+ * @brief Implementation of the histogram API of the coreSNTP library.
+ */
+
+/* Standard includes. */
+#include <string.h>
+#include <assert.h>
+
+/* Include API header. */
+#include "core_sntp_histogram.h"
+
+/**
+ * @brief The number of microseconds in a second.
+ */
+#define MICROSECONDS_PER_SECOND    ( 1000000U )
+
+/**
+ * @brief The largest value, in microseconds, that the histograms distinguish.
+ */
+#define MAX_HISTOGRAM_VALUE        ( ( ( uint32_t ) 1U << SNTP_HISTOGRAM_VALUE_BITS ) - 1U )
+
+/**
+ * @brief Calculates the index of the bucket of a value.
+ *
+ * Values below #SNTP_HISTOGRAM_SUB_BUCKETS have a bucket each. A value whose
+ * most significant bit is bit (#SNTP_HISTOGRAM_SUB_BUCKET_BITS + e) is counted
+ * with a resolution of 2^e, in the bucket of its #SNTP_HISTOGRAM_SUB_BUCKET_BITS
+ * + 1 most significant bits.
+ *
+ * @param[in] value The value, in microseconds.
+ *
+ * @return The index of the bucket.
+ */
+static uint32_t getBucketIndex( uint32_t value )
+{
+    uint32_t shift = 0U;
+
+    if( value > MAX_HISTOGRAM_VALUE )
+    {
+        value = MAX_HISTOGRAM_VALUE;
+    }
+
+    while( ( value >> shift ) >= ( 2U * SNTP_HISTOGRAM_SUB_BUCKETS ) )
+    {
+        shift++;
+    }
+
+    return ( shift * SNTP_HISTOGRAM_SUB_BUCKETS ) + ( value >> shift );
+}
+
+/**
+ * @brief Calculates the highest value counted in a bucket.
+ *
+ * @param[in] index The index of the bucket.
+ *
+ * @return The highest value of the bucket, in microseconds.
+ */
+static uint32_t getBucketHighestValue( uint32_t index )
+{
+    uint32_t shift;
+    uint32_t highestValue = index;
+
+    assert( index < SNTP_HISTOGRAM_NUM_BUCKETS );
+
+    if( index == ( SNTP_HISTOGRAM_NUM_BUCKETS - 1U ) )
+    {
+        /* The last bucket also counts the values beyond the range. */
+        highestValue = UINT32_MAX;
+    }
+    else if( index >= ( 2U * SNTP_HISTOGRAM_SUB_BUCKETS ) )
+    {
+        shift = ( index / SNTP_HISTOGRAM_SUB_BUCKETS ) - 1U;
+        highestValue = ( ( ( index % SNTP_HISTOGRAM_SUB_BUCKETS ) + SNTP_HISTOGRAM_SUB_BUCKETS + 1U ) << shift ) - 1U;
+    }
+    else
+    {
+        /* Empty else MISRA 15.7 */
+    }
+
+    return highestValue;
+}
+
+/**
+ * @brief Adds two counts, saturating at UINT32_MAX.
+ *
+ * @param[in] first The first count.
+ * @param[in] second The second count.
+ *
+ * @return The sum of the counts.
+ */
+static uint32_t addCounts( uint32_t first,
+                           uint32_t second )
+{
+    return ( second > ( UINT32_MAX - first ) ) ? UINT32_MAX : ( first + second );
+}
+
+SntpStatus_t Sntp_InitHistogram( SntpHistogram_t * pHistogram )
+{
+    SntpStatus_t status = SntpSuccess;
+
+    if( pHistogram == NULL )
+    {
+        status = SntpErrorBadParameter;
+    }
+    else
+    {
+        ( void ) memset( pHistogram, 0, sizeof( SntpHistogram_t ) );
+    }
+
+    return status;
+}
+
+SntpStatus_t Sntp_InitServerHistograms( SntpServerHistograms_t * pHistograms,
+                                        size_t numOfServers )
+{
+    SntpStatus_t status = SntpSuccess;
+
+    if( ( pHistograms == NULL ) || ( numOfServers == 0U ) )
+    {
+        status = SntpErrorBadParameter;
+    }
+    else
+    {
+        ( void ) memset( pHistograms, 0, numOfServers * sizeof( SntpServerHistograms_t ) );
+    }
+
+    return status;
+}
+
+SntpStatus_t Sntp_RecordHistogramValue( SntpHistogram_t * pHistogram,
+                                        uint32_t valueUs )
+{
+    SntpStatus_t status = SntpSuccess;
+    uint32_t index;
+
+    if( pHistogram == NULL )
+    {
+        status = SntpErrorBadParameter;
+    }
+    else if( pHistogram->totalCount < UINT32_MAX )
+    {
+        index = getBucketIndex( valueUs );
+        pHistogram->counts[ index ]++;
+
+        if( ( pHistogram->totalCount == 0U ) || ( valueUs < pHistogram->minValue ) )
+        {
+            pHistogram->minValue = valueUs;
+        }
+
+        if( ( pHistogram->totalCount == 0U ) || ( valueUs > pHistogram->maxValue ) )
+        {
+            pHistogram->maxValue = valueUs;
+        }
+
+        pHistogram->totalCount++;
+    }
+    else
+    {
+        /* Empty else MISRA 15.7 */
+    }
+
+    return status;
+}
+
+SntpStatus_t Sntp_RecordHistogramDuration( SntpHistogram_t * pHistogram,
+                                           int64_t durationFractions )
+{
+    uint64_t magnitude;
+    uint64_t valueUs = UINT32_MAX;
+
+    /* The magnitude of the most negative value is representable as unsigned. */
+    magnitude = ( durationFractions < 0 ) ? ( 0U - ( uint64_t ) durationFractions ) :
+                ( uint64_t ) durationFractions;
+
+    /* Durations of more than UINT32_MAX microseconds are saturated. */
+    if( ( magnitude >> 32 ) < ( UINT32_MAX / MICROSECONDS_PER_SECOND ) )
+    {
+        valueUs = ( ( magnitude >> 32 ) * MICROSECONDS_PER_SECOND ) +
+                  ( ( ( magnitude & UINT32_MAX ) * MICROSECONDS_PER_SECOND ) >> 32 );
+    }
+
+    return Sntp_RecordHistogramValue( pHistogram, ( uint32_t ) valueUs );
+}
+
+SntpStatus_t Sntp_MergeHistograms( SntpHistogram_t * pTotal,
+                                   const SntpHistogram_t * pPart )
+{
+    SntpStatus_t status = SntpSuccess;
+    uint32_t index;
+
+    if( ( pTotal == NULL ) || ( pPart == NULL ) )
+    {
+        status = SntpErrorBadParameter;
+    }
+    else if( pPart->totalCount > 0U )
+    {
+        for( index = 0U; index < SNTP_HISTOGRAM_NUM_BUCKETS; index++ )
+        {
+            pTotal->counts[ index ] = addCounts( pTotal->counts[ index ], pPart->counts[ index ] );
+        }
+
+        if( ( pTotal->totalCount == 0U ) || ( pPart->minValue < pTotal->minValue ) )
+        {
+            pTotal->minValue = pPart->minValue;
+        }
+
+        if( ( pTotal->totalCount == 0U ) || ( pPart->maxValue > pTotal->maxValue ) )
+        {
+            pTotal->maxValue = pPart->maxValue;
+        }
+
+        pTotal->totalCount = addCounts( pTotal->totalCount, pPart->totalCount );
+    }
+    else
+    {
+        /* Empty else MISRA 15.7 */
+    }
+
+    return status;
+}
+
+SntpStatus_t Sntp_GetHistogramCount( const SntpHistogram_t * pHistogram,
+                                     uint32_t * pCount )
+{
+    SntpStatus_t status = SntpSuccess;
+
+    if( ( pHistogram == NULL ) || ( pCount == NULL ) )
+    {
+        status = SntpErrorBadParameter;
+    }
+    else
+    {
+        *pCount = pHistogram->totalCount;
+    }
+
+    return status;
+}
+
+SntpStatus_t Sntp_GetHistogramPercentile( const SntpHistogram_t * pHistogram,
+                                          uint32_t percentilePpm,
+                                          uint32_t * pValueUs )
+{
+    SntpStatus_t status = SntpSuccess;
+    uint64_t rank;
+    uint64_t cumulativeCount = 0U;
+    uint32_t index;
+    uint32_t value;
+
+    if( ( pHistogram == NULL ) || ( pValueUs == NULL ) ||
+        ( percentilePpm > SNTP_HISTOGRAM_MAX_PERCENTILE ) )
+    {
+        status = SntpErrorBadParameter;
+    }
+    else if( pHistogram->totalCount == 0U )
+    {
+        status = SntpInsufficientSamples;
+    }
+    else
+    {
+        /* The rank of the percentile, from 1 for the smallest value. */
+        rank = ( ( ( uint64_t ) pHistogram->totalCount * percentilePpm ) +
+                 ( SNTP_HISTOGRAM_MAX_PERCENTILE - 1U ) ) / SNTP_HISTOGRAM_MAX_PERCENTILE;
+        rank = ( rank == 0U ) ? 1U : rank;
+
+        for( index = 0U; ( index < SNTP_HISTOGRAM_NUM_BUCKETS ) && ( cumulativeCount < rank ); index++ )
+        {
+            cumulativeCount += pHistogram->counts[ index ];
+        }
+
+        /* The bucket counts only fall short of the total count if they
+         * saturate in a merge, in which case the largest value is reported. */
+        if( ( cumulativeCount >= rank ) && ( percentilePpm > 0U ) )
+        {
+            value = getBucketHighestValue( index - 1U );
+        }
+        else if( percentilePpm > 0U )
+        {
+            value = pHistogram->maxValue;
+        }
+        else
+        {
+            value = pHistogram->minValue;
+        }
+
+        /* The largest recorded value is exact. The highest value of a bucket
+         * is never below the smallest recorded value. */
+        if( value > pHistogram->maxValue )
+        {
+            value = pHistogram->maxValue;
+        }
+
+        *pValueUs = value;
+    }
+
+    return status;
+}
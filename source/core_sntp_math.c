@@ -0,0 +1,59 @@
+/*
+ * coreSNTP v1.0.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file core_sntp_math.c
+ * @brief Implementation of the integer math utilities of the coreSNTP library.
+ */
+
+/* Include utility header. */
+#include "core_sntp_math.h"
+
+uint64_t Sntp_SquareRoot64( uint64_t value )
+{
+    uint64_t root = 0U;
+    uint64_t bit = ( uint64_t ) 1U << 62;
+
+    /* Find the highest power of 4 lower than or equal to the value. */
+    while( bit > value )
+    {
+        bit >>= 2;
+    }
+
+    /* Determine the bits of the root from the highest to the lowest. */
+    while( bit != 0U )
+    {
+        if( value >= ( root + bit ) )
+        {
+            value -= root + bit;
+            root = ( root >> 1 ) + bit;
+        }
+        else
+        {
+            root >>= 1;
+        }
+
+        bit >>= 2;
+    }
+
+    return root;
+}
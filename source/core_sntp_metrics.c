@@ -0,0 +1,776 @@
+/*
+ * coreSNTP v1.0.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file core_sntp_metrics.c
+ * @brief Implementation of the statistics API of the coreSNTP library.
+ */
+
+/* Standard includes. */
+#include <string.h>
+#include <assert.h>
+
+/* Include API header. */
+#include "core_sntp_metrics.h"
+#include "core_sntp_fixed_point.h"
+#include "core_sntp_math.h"
+
+/**
+ * @brief The number of nanoseconds in a second.
+ */
+#define NANOSECONDS_PER_SECOND    ( 1000000000U )
+
+/**
+ * @brief The base-2 logarithm of the weight of a new sample in the exponential
+ * average of the squared offset differences (1/4).
+ */
+#define JITTER_WEIGHT_SHIFT       ( 2U )
+
+/**
+ * @brief The largest offset difference, in nanoseconds, used for the jitter, so
+ * that its square fits in 64 bits.
+ */
+#define MAX_JITTER_DIFFERENCE     ( ( int64_t ) INT32_MAX )
+
+/**
+ * @brief The Kiss-o'-Death codes that are counted separately, as 32-bit
+ * values of their ASCII characters.
+ */
+#define KISS_CODE_DENY            ( 0x44454E59U )
+#define KISS_CODE_RSTR            ( 0x52535452U )
+#define KISS_CODE_RATE            ( 0x52415445U )
+
+/**
+ * @brief The statistics rendered for the context and for each server.
+ */
+typedef enum MetricId
+{
+    MetricRequests = 0,
+    MetricAcceptedResponses,
+    MetricTimeouts,
+    MetricNetworkErrors,
+    MetricDnsFailures,
+    MetricKissOfDeath,
+    MetricInvalidResponses,
+    MetricClockOffset,
+    MetricJitter,
+    MetricRoundTripDelay,
+    MetricStratum,
+    MetricLastSyncAge,
+    MetricCurrentServer,
+    NumOfMetrics
+} MetricId_t;
+
+/**
+ * @brief The description of a rendered statistic.
+ */
+typedef struct MetricFamily
+{
+    const char * pName;                /**< @brief The name, after the prefix. */
+    const char * pType;                /**< @brief The Prometheus type. */
+    const char * pHelp;                /**< @brief The description. */
+    const char * pLabelName;           /**< @brief The name of the label that splits
+                                        * the statistic, or NULL. */
+    const char * const * pLabelValues; /**< @brief The values of the label. */
+    size_t numOfValues;                /**< @brief The number of samples of a server. */
+    bool isContextOnly;                /**< @brief Whether the statistic is only
+                                        * rendered for the context. */
+} MetricFamily_t;
+
+/**
+ * @brief A writer of text into a buffer, which counts the length of the text
+ * beyond the end of the buffer.
+ */
+typedef struct TextWriter
+{
+    char * pBuffer;    /**< @brief The buffer. */
+    size_t bufferSize; /**< @brief The size of the buffer. */
+    size_t length;     /**< @brief The length of the text. */
+} TextWriter_t;
+
+/**
+ * @brief The label values of the Kiss-o'-Death codes, in the order of
+ * #SntpMetricsKissCode_t.
+ */
+static const char * const kissCodeLabels[ SntpMetricsNumOfKissCodes ] =
+{
+    "DENY", "RSTR", "RATE", "other"
+};
+
+/**
+ * @brief The label values of the reasons of invalid responses, in the order of
+ * #SntpMetricsInvalidReason_t.
+ */
+static const char * const invalidReasonLabels[ SntpMetricsNumOfInvalidReasons ] =
+{
+    "malformed", "protocol", "unauthenticated", "outlier"
+};
+
+/**
+ * @brief The rendered statistics, in the order of #MetricId_t.
+ */
+static const MetricFamily_t metricFamilies[ NumOfMetrics ] =
+{
+    { "requests_total",            "counter", "Time requests sent.",
+      NULL,                        NULL,                  1U,                             false },
+    { "responses_accepted_total",  "counter", "Server responses used to correct time.",
+      NULL,                        NULL,                  1U,                             false },
+    { "timeouts_total",            "counter", "Time requests without a response within the timeout.",
+      NULL,                        NULL,                  1U,                             false },
+    { "network_errors_total",      "counter", "Failures to send a request or receive a response.",
+      NULL,                        NULL,                  1U,                             false },
+    { "dns_failures_total",        "counter", "Failures to resolve the name of the server.",
+      NULL,                        NULL,                  1U,                             false },
+    { "kiss_of_death_total",       "counter", "Kiss-o'-Death responses, by code.",
+      "code",                      kissCodeLabels,        SntpMetricsNumOfKissCodes,      false },
+    { "invalid_responses_total",   "counter", "Server responses that are not used, by reason.",
+      "reason",                    invalidReasonLabels,   SntpMetricsNumOfInvalidReasons, false },
+    { "offset_seconds",            "gauge",   "Clock offset of the last accepted response.",
+      NULL,                        NULL,                  1U,                             false },
+    { "jitter_seconds",            "gauge",   "Root mean square of the differences between successive clock offsets.",
+      NULL,                        NULL,                  1U,                             false },
+    { "round_trip_delay_seconds",  "gauge",   "Round-trip delay of the last accepted response.",
+      NULL,                        NULL,                  1U,                             false },
+    { "stratum",                   "gauge",   "Stratum of the server in the last accepted response.",
+      NULL,                        NULL,                  1U,                             false },
+    { "last_sync_age_seconds",     "gauge",   "Time since the last accepted response.",
+      NULL,                        NULL,                  1U,                             false },
+    { "current_server_index",      "gauge",   "Index of the server of the last request or response.",
+      NULL,                        NULL,                  1U,                             true  }
+};
+
+/**
+ * @brief Updates statistics with an accepted response.
+ *
+ * @param[in, out] pServer The statistics.
+ * @param[in] pParsedResponse The parsed response.
+ * @param[in] pResponseRxTime The system time of receiving the response.
+ */
+static void recordAcceptedResponse( SntpServerMetrics_t * pServer,
+                                    const SntpResponseData_t * pParsedResponse,
+                                    const SntpTimestamp_t * pResponseRxTime )
+{
+    int64_t offsetNs;
+    int64_t difference;
+    uint64_t square;
+
+    assert( pServer != NULL );
+    assert( pParsedResponse != NULL );
+    assert( pResponseRxTime != NULL );
+
+    offsetNs = Sntp_FixedToNanoseconds( pParsedResponse->clockOffsetFractions );
+
+    if( pServer->isSynchronized == true )
+    {
+        difference = offsetNs - pServer->clockOffsetNs;
+        difference = ( difference > MAX_JITTER_DIFFERENCE ) ? MAX_JITTER_DIFFERENCE : difference;
+        difference = ( difference < -MAX_JITTER_DIFFERENCE ) ? -MAX_JITTER_DIFFERENCE : difference;
+        square = ( uint64_t ) ( difference * difference );
+
+        if( square >= pServer->jitterVariance )
+        {
+            pServer->jitterVariance += ( square - pServer->jitterVariance ) >> JITTER_WEIGHT_SHIFT;
+        }
+        else
+        {
+            pServer->jitterVariance -= ( pServer->jitterVariance - square ) >> JITTER_WEIGHT_SHIFT;
+        }
+
+        pServer->jitterNs = ( int64_t ) Sntp_SquareRoot64( pServer->jitterVariance );
+    }
+
+    pServer->isSynchronized = true;
+    pServer->clockOffsetNs = offsetNs;
+    pServer->roundTripDelayNs = Sntp_FixedToNanoseconds( pParsedResponse->roundTripDelayFractions );
+    pServer->stratum = pParsedResponse->stratum;
+    pServer->lastSyncTime = *pResponseRxTime;
+}
+
+/**
+ * @brief Updates statistics with the outcome of a response.
+ *
+ * @param[in, out] pServer The statistics.
+ * @param[in] status The status of the response.
+ * @param[in] pParsedResponse The parsed response.
+ * @param[in] pResponseRxTime The system time of receiving the response.
+ */
+static void recordResponse( SntpServerMetrics_t * pServer,
+                            SntpStatus_t status,
+                            const SntpResponseData_t * pParsedResponse,
+                            const SntpTimestamp_t * pResponseRxTime )
+{
+    assert( pServer != NULL );
+
+    switch( status )
+    {
+        case SntpSuccess:
+            pServer->acceptedResponses++;
+            recordAcceptedResponse( pServer, pParsedResponse, pResponseRxTime );
+            break;
+
+        case SntpClockOffsetOverflow:
+            /* Time is corrected, without a clock offset to report. */
+            pServer->acceptedResponses++;
+            break;
+
+        case SntpRejectedResponseChangeServer:
+        case SntpRejectedResponseRetryWithBackoff:
+        case SntpRejectedResponseOtherCode:
+            assert( pParsedResponse != NULL );
+
+            if( pParsedResponse->rejectedResponseCode == KISS_CODE_DENY )
+            {
+                pServer->kissOfDeath[ SntpMetricsKissDeny ]++;
+            }
+            else if( pParsedResponse->rejectedResponseCode == KISS_CODE_RSTR )
+            {
+                pServer->kissOfDeath[ SntpMetricsKissRstr ]++;
+            }
+            else if( pParsedResponse->rejectedResponseCode == KISS_CODE_RATE )
+            {
+                pServer->kissOfDeath[ SntpMetricsKissRate ]++;
+            }
+            else
+            {
+                pServer->kissOfDeath[ SntpMetricsKissOther ]++;
+            }
+
+            break;
+
+        case SntpErrorBufferTooSmall:
+            pServer->invalidResponses[ SntpMetricsInvalidMalformed ]++;
+            break;
+
+        case SntpInvalidResponse:
+            pServer->invalidResponses[ SntpMetricsInvalidProtocol ]++;
+            break;
+
+        case SntpServerNotAuthenticated:
+            pServer->invalidResponses[ SntpMetricsInvalidUnauthenticated ]++;
+            break;
+
+        case SntpRejectedResponseOutlier:
+            pServer->invalidResponses[ SntpMetricsInvalidOutlier ]++;
+            break;
+
+        case SntpErrorResponseTimeout:
+            pServer->timeouts++;
+            break;
+
+        case SntpErrorNetworkFailure:
+            pServer->networkErrors++;
+            break;
+
+        default:
+            /* Other statuses are not caused by the server. */
+            break;
+    }
+}
+
+/**
+ * @brief Writes a character, or counts it if the buffer is full.
+ *
+ * @param[in, out] pWriter The writer.
+ * @param[in] character The character.
+ */
+static void writeChar( TextWriter_t * pWriter,
+                       char character )
+{
+    assert( pWriter != NULL );
+
+    if( pWriter->length < pWriter->bufferSize )
+    {
+        pWriter->pBuffer[ pWriter->length ] = character;
+    }
+
+    pWriter->length++;
+}
+
+/**
+ * @brief Writes a string.
+ *
+ * @param[in, out] pWriter The writer.
+ * @param[in] pString The string.
+ */
+static void writeString( TextWriter_t * pWriter,
+                         const char * pString )
+{
+    assert( pString != NULL );
+
+    while( *pString != '\0' )
+    {
+        writeChar( pWriter, *pString );
+        pString++;
+    }
+}
+
+/**
+ * @brief Writes a label value, escaping the characters that are special in the
+ * Prometheus text format.
+ *
+ * @param[in, out] pWriter The writer.
+ * @param[in] pValue The label value.
+ */
+static void writeLabelValue( TextWriter_t * pWriter,
+                             const char * pValue )
+{
+    assert( pValue != NULL );
+
+    writeChar( pWriter, '"' );
+
+    while( *pValue != '\0' )
+    {
+        if( *pValue == '\n' )
+        {
+            writeString( pWriter, "\\n" );
+        }
+        else
+        {
+            if( ( *pValue == '\\' ) || ( *pValue == '"' ) )
+            {
+                writeChar( pWriter, '\\' );
+            }
+
+            writeChar( pWriter, *pValue );
+        }
+
+        pValue++;
+    }
+
+    writeChar( pWriter, '"' );
+}
+
+/**
+ * @brief Writes an unsigned integer in decimal, with at least a number of
+ * digits.
+ *
+ * @param[in, out] pWriter The writer.
+ * @param[in] value The value.
+ * @param[in] minDigits The minimum number of digits, padded with zeros.
+ */
+static void writeUnsigned( TextWriter_t * pWriter,
+                           uint64_t value,
+                           size_t minDigits )
+{
+    char digits[ 20 ];
+    size_t numOfDigits = 0U;
+
+    do
+    {
+        digits[ numOfDigits ] = ( char ) ( '0' + ( char ) ( value % 10U ) );
+        value /= 10U;
+        numOfDigits++;
+    } while( ( value != 0U ) || ( numOfDigits < minDigits ) );
+
+    while( numOfDigits > 0U )
+    {
+        numOfDigits--;
+        writeChar( pWriter, digits[ numOfDigits ] );
+    }
+}
+
+/**
+ * @brief Writes a duration in nanoseconds as a decimal number of seconds.
+ *
+ * @param[in, out] pWriter The writer.
+ * @param[in] nanoseconds The duration.
+ */
+static void writeSeconds( TextWriter_t * pWriter,
+                          int64_t nanoseconds )
+{
+    uint64_t magnitude = ( nanoseconds < 0 ) ? ( 0U - ( uint64_t ) nanoseconds ) : ( uint64_t ) nanoseconds;
+
+    if( nanoseconds < 0 )
+    {
+        writeChar( pWriter, '-' );
+    }
+
+    writeUnsigned( pWriter, magnitude / NANOSECONDS_PER_SECOND, 1U );
+    writeChar( pWriter, '.' );
+    writeUnsigned( pWriter, magnitude % NANOSECONDS_PER_SECOND, 9U );
+}
+
+/**
+ * @brief Writes a sample of a statistic, if the statistic has a value.
+ *
+ * @param[in, out] pWriter The writer.
+ * @param[in] pPrefix The prefix of the name of the statistic.
+ * @param[in] id The statistic.
+ * @param[in] valueIndex The index of the label value of the sample.
+ * @param[in] pServer The statistics of the server, or of the context.
+ * @param[in] pMetrics The statistics of the context.
+ * @param[in] pCurrentTime The current system time, or NULL.
+ */
+static void writeSample( TextWriter_t * pWriter,
+                         const char * pPrefix,
+                         MetricId_t id,
+                         size_t valueIndex,
+                         const SntpServerMetrics_t * pServer,
+                         const SntpMetrics_t * pMetrics,
+                         const SntpTimestamp_t * pCurrentTime )
+{
+    const MetricFamily_t * pFamily = &metricFamilies[ id ];
+    bool isPresent = true;
+    bool isSeconds = false;
+    uint64_t count = 0U;
+    int64_t nanoseconds = 0;
+    int64_t age;
+
+    assert( pServer != NULL );
+    assert( pMetrics != NULL );
+
+    switch( id )
+    {
+        case MetricRequests:
+            count = pServer->requests;
+            break;
+
+        case MetricAcceptedResponses:
+            count = pServer->acceptedResponses;
+            break;
+
+        case MetricTimeouts:
+            count = pServer->timeouts;
+            break;
+
+        case MetricNetworkErrors:
+            count = pServer->networkErrors;
+            break;
+
+        case MetricDnsFailures:
+            count = pServer->dnsFailures;
+            break;
+
+        case MetricKissOfDeath:
+            count = pServer->kissOfDeath[ valueIndex ];
+            break;
+
+        case MetricInvalidResponses:
+            count = pServer->invalidResponses[ valueIndex ];
+            break;
+
+        case MetricClockOffset:
+            isSeconds = true;
+            nanoseconds = pServer->clockOffsetNs;
+            break;
+
+        case MetricJitter:
+            isSeconds = true;
+            nanoseconds = pServer->jitterNs;
+            break;
+
+        case MetricRoundTripDelay:
+            isSeconds = true;
+            nanoseconds = pServer->roundTripDelayNs;
+            break;
+
+        case MetricStratum:
+            count = pServer->stratum;
+            break;
+
+        case MetricLastSyncAge:
+            isSeconds = true;
+            isPresent = ( pCurrentTime != NULL ) ? true : false;
+
+            if( pCurrentTime != NULL )
+            {
+                age = Sntp_FixedDifference( Sntp_FixedFromTimestamp( *pCurrentTime ),
+                                            Sntp_FixedFromTimestamp( pServer->lastSyncTime ) );
+
+                /* A backward step of system time is reported as no age. */
+                nanoseconds = ( age >= 0 ) ? Sntp_FixedToNanoseconds( age ) : 0;
+            }
+
+            break;
+
+        default:
+            count = pMetrics->currentServerIndex;
+            break;
+    }
+
+    /* The gauges of the last accepted response need one. */
+    if( ( id >= MetricClockOffset ) && ( id <= MetricLastSyncAge ) && ( pServer->isSynchronized == false ) )
+    {
+        isPresent = false;
+    }
+
+    if( isPresent == true )
+    {
+        writeString( pWriter, pPrefix );
+        writeString( pWriter, pFamily->pName );
+
+        if( ( pServer->pServerName != NULL ) || ( pFamily->pLabelName != NULL ) )
+        {
+            writeChar( pWriter, '{' );
+
+            if( pServer->pServerName != NULL )
+            {
+                writeString( pWriter, "server=" );
+                writeLabelValue( pWriter, pServer->pServerName );
+            }
+
+            if( pFamily->pLabelName != NULL )
+            {
+                if( pServer->pServerName != NULL )
+                {
+                    writeChar( pWriter, ',' );
+                }
+
+                writeString( pWriter, pFamily->pLabelName );
+                writeChar( pWriter, '=' );
+                writeLabelValue( pWriter, pFamily->pLabelValues[ valueIndex ] );
+            }
+
+            writeChar( pWriter, '}' );
+        }
+
+        writeChar( pWriter, ' ' );
+
+        if( isSeconds == true )
+        {
+            writeSeconds( pWriter, nanoseconds );
+        }
+        else
+        {
+            writeUnsigned( pWriter, count, 1U );
+        }
+
+        writeChar( pWriter, '\n' );
+    }
+}
+
+/**
+ * @brief Writes the description and samples of a statistic for the context or
+ * for the servers.
+ *
+ * @param[in, out] pWriter The writer.
+ * @param[in] id The statistic.
+ * @param[in] isServerScope Whether to write the samples of the servers.
+ * @param[in] pMetrics The statistics of the context.
+ * @param[in] pCurrentTime The current system time, or NULL.
+ */
+static void writeFamily( TextWriter_t * pWriter,
+                         MetricId_t id,
+                         bool isServerScope,
+                         const SntpMetrics_t * pMetrics,
+                         const SntpTimestamp_t * pCurrentTime )
+{
+    const MetricFamily_t * pFamily = &metricFamilies[ id ];
+    const char * pPrefix = ( isServerScope == true ) ? "sntp_server_" : "sntp_client_";
+    SntpServerMetrics_t unnamed;
+    size_t server;
+    size_t value;
+
+    writeString( pWriter, "# HELP " );
+    writeString( pWriter, pPrefix );
+    writeString( pWriter, pFamily->pName );
+    writeChar( pWriter, ' ' );
+    writeString( pWriter, pFamily->pHelp );
+    writeString( pWriter, "\n# TYPE " );
+    writeString( pWriter, pPrefix );
+    writeString( pWriter, pFamily->pName );
+    writeChar( pWriter, ' ' );
+    writeString( pWriter, pFamily->pType );
+    writeChar( pWriter, '\n' );
+
+    if( isServerScope == false )
+    {
+        /* The samples of the context have no server label. */
+        unnamed = pMetrics->context;
+        unnamed.pServerName = NULL;
+
+        for( value = 0U; value < pFamily->numOfValues; value++ )
+        {
+            writeSample( pWriter, pPrefix, id, value, &unnamed, pMetrics, pCurrentTime );
+        }
+    }
+    else
+    {
+        for( server = 0U; server < pMetrics->numOfServers; server++ )
+        {
+            unnamed = pMetrics->pServers[ server ];
+
+            /* Every server sample has a server label. */
+            unnamed.pServerName = ( unnamed.pServerName != NULL ) ? unnamed.pServerName : "";
+
+            for( value = 0U; value < pFamily->numOfValues; value++ )
+            {
+                writeSample( pWriter, pPrefix, id, value, &unnamed, pMetrics, pCurrentTime );
+            }
+        }
+    }
+}
+
+SntpStatus_t Sntp_InitMetrics( SntpMetrics_t * pMetrics,
+                               SntpServerMetrics_t * pServerMetrics,
+                               size_t numOfServers )
+{
+    SntpStatus_t status = SntpSuccess;
+
+    if( ( pMetrics == NULL ) ||
+        ( ( pServerMetrics == NULL ) != ( numOfServers == 0U ) ) )
+    {
+        status = SntpErrorBadParameter;
+    }
+    else
+    {
+        ( void ) memset( pMetrics, 0, sizeof( SntpMetrics_t ) );
+        pMetrics->pServers = pServerMetrics;
+        pMetrics->numOfServers = numOfServers;
+
+        if( pServerMetrics != NULL )
+        {
+            ( void ) memset( pServerMetrics, 0, numOfServers * sizeof( SntpServerMetrics_t ) );
+        }
+    }
+
+    return status;
+}
+
+SntpStatus_t Sntp_RecordRequestMetrics( SntpMetrics_t * pMetrics,
+                                        size_t serverIndex,
+                                        SntpStatus_t status )
+{
+    SntpStatus_t returnStatus = SntpSuccess;
+    SntpServerMetrics_t * pServers[ 2 ];
+    size_t i;
+
+    if( pMetrics == NULL )
+    {
+        returnStatus = SntpErrorBadParameter;
+    }
+    else
+    {
+        pMetrics->currentServerIndex = serverIndex;
+        pServers[ 0 ] = &pMetrics->context;
+        pServers[ 1 ] = ( serverIndex < pMetrics->numOfServers ) ? &pMetrics->pServers[ serverIndex ] : NULL;
+
+        for( i = 0U; ( i < 2U ) && ( pServers[ i ] != NULL ); i++ )
+        {
+            if( status == SntpSuccess )
+            {
+                pServers[ i ]->requests++;
+            }
+            else if( status == SntpErrorDnsFailure )
+            {
+                pServers[ i ]->dnsFailures++;
+            }
+            else if( status == SntpErrorNetworkFailure )
+            {
+                pServers[ i ]->networkErrors++;
+            }
+            else
+            {
+                /* Empty else MISRA 15.7 */
+            }
+        }
+    }
+
+    return returnStatus;
+}
+
+SntpStatus_t Sntp_RecordResponseMetrics( SntpMetrics_t * pMetrics,
+                                         size_t serverIndex,
+                                         SntpStatus_t status,
+                                         const SntpResponseData_t * pParsedResponse,
+                                         const SntpTimestamp_t * pResponseRxTime )
+{
+    SntpStatus_t returnStatus = SntpSuccess;
+    bool isKissOfDeath = ( status == SntpRejectedResponseChangeServer ) ||
+                         ( status == SntpRejectedResponseRetryWithBackoff ) ||
+                         ( status == SntpRejectedResponseOtherCode );
+
+    if( pMetrics == NULL )
+    {
+        returnStatus = SntpErrorBadParameter;
+    }
+    else if( ( ( status == SntpSuccess ) || ( isKissOfDeath == true ) ) && ( pParsedResponse == NULL ) )
+    {
+        returnStatus = SntpErrorBadParameter;
+    }
+    else if( ( status == SntpSuccess ) && ( pResponseRxTime == NULL ) )
+    {
+        returnStatus = SntpErrorBadParameter;
+    }
+    else
+    {
+        pMetrics->currentServerIndex = serverIndex;
+        recordResponse( &pMetrics->context, status, pParsedResponse, pResponseRxTime );
+
+        if( serverIndex < pMetrics->numOfServers )
+        {
+            recordResponse( &pMetrics->pServers[ serverIndex ], status, pParsedResponse, pResponseRxTime );
+        }
+    }
+
+    return returnStatus;
+}
+
+SntpStatus_t Sntp_RenderMetrics( const SntpMetrics_t * pMetrics,
+                                 const SntpTimestamp_t * pCurrentTime,
+                                 char * pBuffer,
+                                 size_t bufferSize,
+                                 size_t * pTextLength )
+{
+    SntpStatus_t status = SntpSuccess;
+    TextWriter_t writer;
+    uint32_t id;
+
+    if( ( pMetrics == NULL ) || ( pBuffer == NULL ) || ( pTextLength == NULL ) )
+    {
+        status = SntpErrorBadParameter;
+    }
+    else
+    {
+        writer.pBuffer = pBuffer;
+        writer.bufferSize = bufferSize;
+        writer.length = 0U;
+
+        for( id = 0U; id < ( uint32_t ) NumOfMetrics; id++ )
+        {
+            writeFamily( &writer, ( MetricId_t ) id, false, pMetrics, pCurrentTime );
+
+            if( ( metricFamilies[ id ].isContextOnly == false ) && ( pMetrics->numOfServers > 0U ) )
+            {
+                writeFamily( &writer, ( MetricId_t ) id, true, pMetrics, pCurrentTime );
+            }
+        }
+
+        *pTextLength = writer.length;
+
+        if( writer.length < bufferSize )
+        {
+            pBuffer[ writer.length ] = '\0';
+        }
+        else
+        {
+            status = SntpErrorBufferTooSmall;
+
+            if( bufferSize > 0U )
+            {
+                pBuffer[ bufferSize - 1U ] = '\0';
+            }
+        }
+    }
+
+    return status;
+}
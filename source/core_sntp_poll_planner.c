@@ -0,0 +1,183 @@
+/*
+ * coreSNTP v1.0.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file core_sntp_poll_planner.c
+ * @brief Implementation of the poll planner API of the coreSNTP library.
+ */
+
+/* Standard includes. */
+#include <assert.h>
+
+/* Include API header. */
+#include "core_sntp_poll_planner.h"
+#include "core_sntp_fixed_point.h"
+
+/**
+ * @brief The offset basis of the 32-bit FNV-1a hash.
+ */
+#define FNV_OFFSET_BASIS    ( 0x811C9DC5U )
+
+/**
+ * @brief The prime of the 32-bit FNV-1a hash.
+ */
+#define FNV_PRIME           ( 0x01000193U )
+
+/**
+ * @brief Calculates the hash of a device identifier, with the FNV-1a hash
+ * followed by the finalizer of MurmurHash3, so that identifiers that differ
+ * only in their last bytes (for example, serial numbers) get unrelated hashes.
+ *
+ * @param[in] pDeviceId The identifier of the device.
+ * @param[in] deviceIdLength The length of @p pDeviceId in bytes.
+ *
+ * @return The hash of the identifier.
+ */
+static uint32_t hashDeviceId( const uint8_t * pDeviceId,
+                              size_t deviceIdLength )
+{
+    uint32_t hash = FNV_OFFSET_BASIS;
+    size_t index;
+
+    assert( pDeviceId != NULL );
+
+    for( index = 0U; index < deviceIdLength; index++ )
+    {
+        hash = ( hash ^ pDeviceId[ index ] ) * FNV_PRIME;
+    }
+
+    hash ^= hash >> 16;
+    hash *= 0x85EBCA6BU;
+    hash ^= hash >> 13;
+    hash *= 0xC2B2AE35U;
+    hash ^= hash >> 16;
+
+    return hash;
+}
+
+/**
+ * @brief Generates the next value of the xorshift32 pseudo-random generator.
+ *
+ * @param[in, out] pState The non-zero state of the generator.
+ *
+ * @return The next pseudo-random value, which is non-zero.
+ */
+static uint32_t nextRandom( uint32_t * pState )
+{
+    uint32_t state;
+
+    assert( pState != NULL );
+    assert( *pState != 0U );
+
+    state = *pState;
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    *pState = state;
+
+    return state;
+}
+
+SntpStatus_t Sntp_InitPollPlanner( SntpPollPlanner_t * pPlanner,
+                                   const void * pDeviceId,
+                                   size_t deviceIdLength,
+                                   uint32_t pollIntervalSecs,
+                                   uint32_t jitterPercent )
+{
+    SntpStatus_t status = SntpSuccess;
+
+    if( ( pPlanner == NULL ) || ( pDeviceId == NULL ) ||
+        ( pollIntervalSecs == 0U ) || ( pollIntervalSecs > SNTP_POLL_PLANNER_MAX_INTERVAL_SECS ) ||
+        ( jitterPercent > SNTP_POLL_PLANNER_MAX_JITTER_PERCENT ) )
+    {
+        status = SntpErrorBadParameter;
+    }
+    else
+    {
+        pPlanner->deviceHash = hashDeviceId( ( const uint8_t * ) pDeviceId, deviceIdLength );
+        pPlanner->pollIntervalSecs = pollIntervalSecs;
+        pPlanner->jitterPercent = jitterPercent;
+
+        /* Seed the jitter from the identifier hash rotated by half its bits, so
+         * that it is not correlated with the phase. Setting the lowest bit keeps
+         * the state of the generator non-zero. */
+        pPlanner->jitterState = ( pPlanner->deviceHash >> 16 ) | ( pPlanner->deviceHash << 16 ) | 1U;
+    }
+
+    return status;
+}
+
+SntpStatus_t Sntp_SetPollPlannerInterval( SntpPollPlanner_t * pPlanner,
+                                          uint32_t pollIntervalSecs )
+{
+    SntpStatus_t status = SntpSuccess;
+
+    if( ( pPlanner == NULL ) || ( pollIntervalSecs == 0U ) ||
+        ( pollIntervalSecs > SNTP_POLL_PLANNER_MAX_INTERVAL_SECS ) )
+    {
+        status = SntpErrorBadParameter;
+    }
+    else
+    {
+        pPlanner->pollIntervalSecs = pollIntervalSecs;
+    }
+
+    return status;
+}
+
+SntpStatus_t Sntp_PlanNextPoll( SntpPollPlanner_t * pPlanner,
+                                const SntpTimestamp_t * pCurrentTime,
+                                SntpTimestamp_t * pNextPollTime )
+{
+    SntpStatus_t status = SntpSuccess;
+
+    if( ( pPlanner == NULL ) || ( pCurrentTime == NULL ) || ( pNextPollTime == NULL ) )
+    {
+        status = SntpErrorBadParameter;
+    }
+    else
+    {
+        SntpFixedTime_t currentTime = Sntp_FixedFromTimestamp( *pCurrentTime );
+        uint64_t interval = ( uint64_t ) pPlanner->pollIntervalSecs << 32;
+        uint64_t phase;
+        uint64_t sincePhase;
+        uint64_t maxJitter;
+        uint64_t jitter;
+
+        /* The phase is the fraction of the interval given by the hash, so it
+         * keeps its relative position when the interval changes. */
+        phase = Sntp_FixedScale( interval, pPlanner->deviceHash );
+
+        /* The slots of the device are at the phase plus multiples of the
+         * interval in SNTP time. The grid restarts at the SNTP era wrap-around. */
+        sincePhase = ( currentTime - phase ) % interval;
+
+        /* The jitter is a random fraction of the largest jitter. The interval
+         * is divided first, so that the product cannot overflow. */
+        maxJitter = ( interval / 100U ) * pPlanner->jitterPercent;
+        jitter = Sntp_FixedScale( maxJitter, nextRandom( &pPlanner->jitterState ) );
+
+        *pNextPollTime = Sntp_FixedToTimestamp( currentTime + ( interval - sincePhase ) + jitter );
+    }
+
+    return status;
+}
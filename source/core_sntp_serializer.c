@@ -32,6 +32,7 @@
 
 /* Include API header. */
 #include "core_sntp_serializer.h"
+#include "core_sntp_fixed_point.h"
 
 /**
  * @brief The version of SNTP supported by the coreSNTP library by complying
@@ -109,17 +110,36 @@
 #define KOD_CODE_RATE_UINT_VALUE                            ( 0x52415445U )
 
 /**
- * @brief The bit mask for the first order difference between system clock and
- * server second part of timestamps to determine whether calculation for
- * system clock-offset relative to server will overflow.
- * If any of the bits represented by the mask are set in the first order timestamp
- * difference value, it represents that clock offset calculations will overflow.
- *
- * @note The bit mask represents the 2 most significant bits of a 32 bit integer
- * as the clock-offset value uses the bits as sign bits, thereby, requiring that
- * the value be representable within 30 bits of the seconds part of timestamp width.
+ * @brief The limit, in units of SNTP timestamp fractions, of the first order
+ * difference between the server and system times for which the system
+ * clock-offset relative to server can be calculated.
+ *
+ * @note The limit is 2^30 seconds (~34 years), which keeps the seconds of the
+ * clock-offset representable within 30 bits, with 2 sign bits to spare for
+ * the arithmetic of the on-wire protocol.
+ */
+#define CLOCK_OFFSET_LIMIT_FRACTIONS                        ( ( uint64_t ) 1 << 62 )
+
+/**
+ * @brief The number of nanoseconds in a second.
  */
-#define CLOCK_OFFSET_FIRST_ORDER_DIFF_OVERFLOW_BITS_MASK    ( 0xC0000000U )
+#define NANOSECONDS_PER_SECOND                              ( 1000000000U )
+
+/**
+ * @brief The number of microseconds in a second.
+ */
+#define MICROSECONDS_PER_SECOND                             ( 1000000U )
+
+/**
+ * @brief The value of 2^31, half the range of SNTP timestamp seconds.
+ */
+#define HALF_SNTP_ERA_SECS                                  ( 0x80000000U )
+
+/**
+ * @brief The alignment, in bytes, of the extension fields and Message
+ * Authentication Code that follow the packet header.
+ */
+#define SNTP_PACKET_FIELD_ALIGNMENT                         ( 4U )
 
 /**
  * @brief Structure representing an SNTP packet header.
@@ -145,6 +165,92 @@ typedef struct SntpPacket
     SntpTimestamp_t transmitTime; /* transmit timestamp */
 } SntpPacket_t;
 
+#if ( SNTP_BYTE_ORDER == SNTP_BYTE_ORDER_LITTLE_ENDIAN )
+
+/**
+ * @brief Utility to fill 32-bit integer in word-sized memory in network
+ * byte (or Big Endian) order, on a little-endian target.
+ *
+ * @param[out] pWordMemory Pointer to the word-sized memory in which
+ * the 32-bit integer will be filled. It does not need to be aligned.
+ * @param[in] data The 32-bit integer to fill in the @p wordMemory
+ * in network byte order.
+ */
+    static void fillWordMemoryInNetworkOrder( uint32_t * pWordMemory,
+                                              uint32_t data )
+    {
+        uint32_t networkWord = __builtin_bswap32( data );
+
+        assert( pWordMemory != NULL );
+
+        /* The copy compiles to a single store, even when unaligned. */
+        ( void ) memcpy( pWordMemory, &networkWord, sizeof( networkWord ) );
+    }
+
+/**
+ * @brief Utility to generate a 32-bit integer from memory containing
+ * integer in network (or Big Endian) byte order, on a little-endian target.
+ *
+ * @param[in] ptr Pointer to the memory containing 32-bit integer in network
+ * byte order. It does not need to be aligned.
+ *
+ * @return The host representation of the 32-bit integer in the passed word
+ * memory.
+ */
+    static uint32_t readWordFromNetworkByteOrderMemory( const uint32_t * ptr )
+    {
+        uint32_t networkWord;
+
+        assert( ptr != NULL );
+
+        /* The copy compiles to a single load, even when unaligned. */
+        ( void ) memcpy( &networkWord, ptr, sizeof( networkWord ) );
+
+        return __builtin_bswap32( networkWord );
+    }
+
+#elif ( SNTP_BYTE_ORDER == SNTP_BYTE_ORDER_BIG_ENDIAN )
+
+/**
+ * @brief Utility to fill 32-bit integer in word-sized memory in network
+ * byte (or Big Endian) order, on a big-endian target.
+ *
+ * @param[out] pWordMemory Pointer to the word-sized memory in which
+ * the 32-bit integer will be filled. It does not need to be aligned.
+ * @param[in] data The 32-bit integer to fill in the @p wordMemory
+ * in network byte order.
+ */
+    static void fillWordMemoryInNetworkOrder( uint32_t * pWordMemory,
+                                              uint32_t data )
+    {
+        assert( pWordMemory != NULL );
+
+        ( void ) memcpy( pWordMemory, &data, sizeof( data ) );
+    }
+
+/**
+ * @brief Utility to generate a 32-bit integer from memory containing
+ * integer in network (or Big Endian) byte order, on a big-endian target.
+ *
+ * @param[in] ptr Pointer to the memory containing 32-bit integer in network
+ * byte order. It does not need to be aligned.
+ *
+ * @return The host representation of the 32-bit integer in the passed word
+ * memory.
+ */
+    static uint32_t readWordFromNetworkByteOrderMemory( const uint32_t * ptr )
+    {
+        uint32_t hostWord;
+
+        assert( ptr != NULL );
+
+        ( void ) memcpy( &hostWord, ptr, sizeof( hostWord ) );
+
+        return hostWord;
+    }
+
+#else /* if ( SNTP_BYTE_ORDER == SNTP_BYTE_ORDER_LITTLE_ENDIAN ) */
+
 /**
  * @brief Utility macro to fill 32-bit integer in word-sized
  * memory in network byte (or Big Endian) order.
@@ -159,16 +265,16 @@ typedef struct SntpPacket
  * (like *pWordMemory = word) can cause undesired side-effect
  * of network-byte ordering getting reversed on Little Endian platforms.
  */
-static void fillWordMemoryInNetworkOrder( uint32_t * pWordMemory,
-                                          uint32_t data )
-{
-    assert( pWordMemory != NULL );
+    static void fillWordMemoryInNetworkOrder( uint32_t * pWordMemory,
+                                              uint32_t data )
+    {
+        assert( pWordMemory != NULL );
 
-    *( ( uint8_t * ) pWordMemory ) = ( uint8_t ) ( data >> 24 );
-    *( ( uint8_t * ) pWordMemory + 1 ) = ( uint8_t ) ( data >> 16 );
-    *( ( uint8_t * ) pWordMemory + 2 ) = ( uint8_t ) ( data >> 8 );
-    *( ( uint8_t * ) pWordMemory + 3 ) = ( uint8_t ) data;
-}
+        *( ( uint8_t * ) pWordMemory ) = ( uint8_t ) ( data >> 24 );
+        *( ( uint8_t * ) pWordMemory + 1 ) = ( uint8_t ) ( data >> 16 );
+        *( ( uint8_t * ) pWordMemory + 2 ) = ( uint8_t ) ( data >> 8 );
+        *( ( uint8_t * ) pWordMemory + 3 ) = ( uint8_t ) data;
+    }
 
 /**
  * @brief Utility macro to generate a 32-bit integer from memory containing
@@ -179,17 +285,19 @@ static void fillWordMemoryInNetworkOrder( uint32_t * pWordMemory,
  * @return The host representation of the 32-bit integer in the passed word
  * memory.
  */
-static uint32_t readWordFromNetworkByteOrderMemory( const uint32_t * ptr )
-{
-    const uint8_t * pMemStartByte = ( const uint8_t * ) ptr;
+    static uint32_t readWordFromNetworkByteOrderMemory( const uint32_t * ptr )
+    {
+        const uint8_t * pMemStartByte = ( const uint8_t * ) ptr;
 
-    assert( ptr != NULL );
+        assert( ptr != NULL );
 
-    return ( uint32_t ) ( ( ( uint32_t ) *( pMemStartByte ) << 24 ) |
-                          ( 0x00FF0000U & ( ( uint32_t ) *( pMemStartByte + 1 ) << 16 ) ) |
-                          ( 0x0000FF00U & ( ( uint32_t ) *( pMemStartByte + 2 ) << 8 ) ) |
-                          ( ( uint32_t ) *( pMemStartByte + 3 ) ) );
-}
+        return ( uint32_t ) ( ( ( uint32_t ) *( pMemStartByte ) << 24 ) |
+                              ( 0x00FF0000U & ( ( uint32_t ) *( pMemStartByte + 1 ) << 16 ) ) |
+                              ( 0x0000FF00U & ( ( uint32_t ) *( pMemStartByte + 2 ) << 8 ) ) |
+                              ( ( uint32_t ) *( pMemStartByte + 3 ) ) );
+    }
+
+#endif /* if ( SNTP_BYTE_ORDER == SNTP_BYTE_ORDER_LITTLE_ENDIAN ) */
 
 /**
  * @brief Utility to calculate clock offset of system relative to the
@@ -246,6 +354,9 @@ static uint32_t readWordFromNetworkByteOrderMemory( const uint32_t * ptr )
  * relative to the server time, if the system clock is within 34 years of
  * server time; otherwise, the seconds part of clock offset is set to
  * #SNTP_CLOCK_OFFSET_OVERFLOW.
+ * @param[out] pClockOffsetFractions The calculated offset value, in units of
+ * SNTP timestamp fractions, if the system clock is within 34 years of server
+ * time; otherwise, it is set to zero.
  *
  * @return #SntpSuccess if clock-offset is calculated; #SntpClockOffsetOverflow
  * otherwise for inability to calculate from arithmetic overflow.
@@ -254,60 +365,54 @@ static SntpStatus_t calculateClockOffset( const SntpTimestamp_t * pClientTxTime,
                                           const SntpTimestamp_t * pServerRxTime,
                                           const SntpTimestamp_t * pServerTxTime,
                                           const SntpTimestamp_t * pClientRxTime,
-                                          int32_t * pClockOffset )
+                                          int32_t * pClockOffset,
+                                          int64_t * pClockOffsetFractions )
 {
     SntpStatus_t status = SntpSuccess;
-
-    /* Variable for storing the first-order difference between timestamps. */
-    uint32_t firstOrderDiff = 0;
+    SntpFixedTime_t clientTxTime;
+    SntpFixedTime_t serverRxTime;
+    SntpFixedTime_t serverTxTime;
+    SntpFixedTime_t clientRxTime;
 
     assert( pClientTxTime != NULL );
     assert( pServerRxTime != NULL );
     assert( pServerTxTime != NULL );
     assert( pClientRxTime != NULL );
     assert( pClockOffset != NULL );
-
-    /* Calculate a sample first order difference value between the
-     * server and system timestamps. */
-    firstOrderDiff = pClientRxTime->seconds - pServerTxTime->seconds;
-
-    /* Determine from the first order difference if the system time is within
-     * 34 years of server time to be able to calculate clock offset.
-     *
-     * Note: As the SNTP timestamp value wraps around after ~136 years (exactly at
-     * 7 Feb 2036 6h 28m 16s), the conditional logic checks first order difference
-     * in both polarities (i.e. as (Server - Client) and (Client - Server) time values )
-     * to support the edge case when the two timestamps are in different SNTP eras (for
-     * example, server time is in 2037 and client time is in 2035 ).
-     */
-    if( ( ( firstOrderDiff & CLOCK_OFFSET_FIRST_ORDER_DIFF_OVERFLOW_BITS_MASK )
-          == 0U ) ||
-        ( ( ( 0U - firstOrderDiff ) & CLOCK_OFFSET_FIRST_ORDER_DIFF_OVERFLOW_BITS_MASK )
-          == 0U ) )
-    {
-        /* Calculate the clock-offset as system time is within 34 years window
-         * of server time. */
-        uint32_t firstOrderDiffSend;
-        uint32_t firstOrderDiffRecv;
-        uint32_t sumOfFirstOrderDiffs;
-
-        /* Perform ( T2 - T1 ) offset calculation of SNTP Request packet path. */
-        firstOrderDiffSend = pServerRxTime->seconds - pClientTxTime->seconds;
-
-        /* Perform ( T3 - T4 ) offset calculation of SNTP Response packet path. */
-        firstOrderDiffRecv = 0U - firstOrderDiff;
-
-        /* Perform second order calculation of using average of the above offsets. */
-        sumOfFirstOrderDiffs = firstOrderDiffSend + firstOrderDiffRecv;
-
-        /* Use division instead of a bit shift to guarantee sign extension
+    assert( pClockOffsetFractions != NULL );
+
+    clientTxTime = Sntp_FixedFromTimestamp( *pClientTxTime );
+    serverRxTime = Sntp_FixedFromTimestamp( *pServerRxTime );
+    serverTxTime = Sntp_FixedFromTimestamp( *pServerTxTime );
+    clientRxTime = Sntp_FixedFromTimestamp( *pClientRxTime );
+
+    /* Determine from the first order difference ( T3 - T4 ) if the system time is
+     * within 34 years of server time to be able to calculate clock offset. Adding
+     * the limit maps the signed range ( -limit, limit ) onto [ 1, 2 * limit ), so
+     * a single unsigned comparison checks both polarities. The difference is
+     * correct even if the two timestamps are in different SNTP eras (for example,
+     * server time is in 2037 and client time is in 2035 ). */
+    if( ( ( ( uint64_t ) Sntp_FixedDifference( serverTxTime, clientRxTime ) + CLOCK_OFFSET_LIMIT_FRACTIONS ) -
+          1U ) < ( ( 2U * CLOCK_OFFSET_LIMIT_FRACTIONS ) - 1U ) )
+    {
+        /* The on-wire clock offset, [( T2 - T1 ) + ( T3 - T4 )] / 2, is the
+         * duration from the midpoint of the client times to the midpoint of the
+         * server times. The midpoints do not overflow, and handle the SNTP era
+         * wrap-around. */
+        *pClockOffsetFractions = Sntp_FixedDifference( Sntp_FixedMidpoint( serverRxTime, serverTxTime ),
+                                                       Sntp_FixedMidpoint( clientTxTime, clientRxTime ) );
+
+        /* Use division instead of a bit shift to truncate towards zero
          * regardless of compiler implementation. */
-        *pClockOffset = ( ( int32_t ) sumOfFirstOrderDiffs / 2 );
+        *pClockOffset = ( int32_t ) ( *pClockOffsetFractions / ( ( int64_t ) 0x100000000 ) );
     }
     else
     {
         /* System clock-offset cannot be calculated as arithmetic operation will overflow. */
+        LogWarn( ( "Clock offset exceeds the range of 32-bit arithmetic: The system time is more "
+                   "than 34 years away from server time" ) );
         *pClockOffset = SNTP_CLOCK_OFFSET_OVERFLOW;
+        *pClockOffsetFractions = 0;
 
         status = SntpClockOffsetOverflow;
     }
@@ -315,6 +420,52 @@ static SntpStatus_t calculateClockOffset( const SntpTimestamp_t * pClientTxTime,
     return status;
 }
 
+/**
+ * @brief Utility to calculate the round-trip delay of an SNTP request and
+ * response on the network, using the on-wire protocol specified in the NTPv4
+ * specification.
+ *
+ * With the timestamps T1 through T4 as described for @ref calculateClockOffset,
+ *
+ *  Round-Trip Delay = ( T4 - T1 ) - ( T3 - T2 )
+ *
+ * @param[in] pClientTxTime The system time of sending the SNTP request ("T1").
+ * @param[in] pServerRxTime The server time of receiving the SNTP request ("T2").
+ * @param[in] pServerTxTime The server time of sending the SNTP response ("T3").
+ * @param[in] pClientRxTime The system time of receiving the SNTP response ("T4").
+ *
+ * @return The round-trip delay in units of SNTP timestamp fractions. If the
+ * timestamps are inconsistent and the delay is negative, zero is returned.
+ */
+static int64_t calculateRoundTripDelay( const SntpTimestamp_t * pClientTxTime,
+                                        const SntpTimestamp_t * pServerRxTime,
+                                        const SntpTimestamp_t * pServerTxTime,
+                                        const SntpTimestamp_t * pClientRxTime )
+{
+    int64_t roundTripDelay;
+
+    assert( pClientTxTime != NULL );
+    assert( pServerRxTime != NULL );
+    assert( pServerTxTime != NULL );
+    assert( pClientRxTime != NULL );
+
+    /* The delay is the duration from the request to the response, less the
+     * processing time of the server. The modulo 2^64 arithmetic of the
+     * fixed-point times handles the SNTP era wrap-around. */
+    roundTripDelay =
+        Sntp_FixedDifference( Sntp_FixedFromTimestamp( *pClientRxTime ) -
+                              ( uint64_t ) Sntp_FixedDifference( Sntp_FixedFromTimestamp( *pServerTxTime ),
+                                                                 Sntp_FixedFromTimestamp( *pServerRxTime ) ),
+                              Sntp_FixedFromTimestamp( *pClientTxTime ) );
+
+    if( roundTripDelay < 0 )
+    {
+        roundTripDelay = 0;
+    }
+
+    return roundTripDelay;
+}
+
 /**
  * @brief Parse a SNTP response packet by determining whether it is a rejected
  * or accepted response to an SNTP request, and accordingly, populate the
@@ -360,6 +511,8 @@ static SntpStatus_t parseValidSntpResponse( const SntpPacket_t * pResponsePacket
     /* Clear the output parameter memory to zero. */
     ( void ) memset( pParsedResponse, 0, sizeof( *pParsedResponse ) );
 
+    pParsedResponse->stratum = pResponsePacket->stratum;
+
     /* Determine if the server has accepted or rejected the request for time. */
     if( pResponsePacket->stratum == SNTP_KISS_OF_DEATH_STRATUM )
     {
@@ -370,6 +523,10 @@ static SntpStatus_t parseValidSntpResponse( const SntpPacket_t * pResponsePacket
         pParsedResponse->rejectedResponseCode =
             readWordFromNetworkByteOrderMemory( &pResponsePacket->refId );
 
+        SNTP_LOG_RATE_LIMITED( LogWarn, ( "Server rejected time request with Kiss-o'-Death: "
+                                          "KissCode=0x%08lx",
+                                          ( unsigned long ) pParsedResponse->rejectedResponseCode ) );
+
         /* Determine the return code based on the Kiss-o'-Death code. */
         switch( pParsedResponse->rejectedResponseCode )
         {
@@ -434,13 +591,174 @@ static SntpStatus_t parseValidSntpResponse( const SntpPacket_t * pResponsePacket
                                        &serverRxTime,
                                        &pParsedResponse->serverTime,
                                        pResponseRxTime,
-                                       &pParsedResponse->clockOffsetSec );
+                                       &pParsedResponse->clockOffsetSec,
+                                       &pParsedResponse->clockOffsetFractions );
+
+        /* Calculate the round-trip delay of the request and response packets
+         * on the network. As the time spent on each side is a difference of
+         * timestamps of the same clock, the delay can be calculated even if the
+         * clock offset overflows. */
+        pParsedResponse->roundTripDelayFractions =
+            calculateRoundTripDelay( pRequestTxTime,
+                                     &serverRxTime,
+                                     &pParsedResponse->serverTime,
+                                     pResponseRxTime );
     }
 
     return status;
 }
 
 
+/**
+ * @brief Validates the segments of a packet for scatter-gather I/O, and
+ * calculates their total size.
+ *
+ * @param[in] pSegments The segments of the packet.
+ * @param[in] segmentCount The number of segments in @p pSegments.
+ * @param[in] checkAlignment Whether the size of each segment has to be a
+ * multiple of #SNTP_PACKET_FIELD_ALIGNMENT bytes.
+ * @param[out] pTotalSize This is filled with the total size of the segments.
+ *
+ * @return `true` if there is at least one segment, the first segment has
+ * memory, every segment of non-zero size has memory and, if checked, every
+ * segment is aligned; `false` otherwise.
+ */
+static bool validateSegments( const SntpIoVector_t * pSegments,
+                              size_t segmentCount,
+                              bool checkAlignment,
+                              size_t * pTotalSize )
+{
+    bool isValid = false;
+    size_t index;
+
+    assert( pTotalSize != NULL );
+
+    *pTotalSize = 0U;
+
+    if( ( pSegments != NULL ) && ( segmentCount > 0U ) && ( pSegments[ 0 ].pBase != NULL ) )
+    {
+        isValid = true;
+
+        for( index = 0U; ( index < segmentCount ) && ( isValid == true ); index++ )
+        {
+            if( ( pSegments[ index ].pBase == NULL ) && ( pSegments[ index ].length > 0U ) )
+            {
+                LogError( ( "Invalid parameter: Segment has no memory: Index=%lu", ( unsigned long ) index ) );
+                isValid = false;
+            }
+            else if( ( checkAlignment == true ) &&
+                     ( ( pSegments[ index ].length % SNTP_PACKET_FIELD_ALIGNMENT ) != 0U ) )
+            {
+                LogError( ( "Invalid parameter: Segment size is not a multiple of %u bytes: "
+                            "Index=%lu, Length=%lu", SNTP_PACKET_FIELD_ALIGNMENT,
+                            ( unsigned long ) index, ( unsigned long ) pSegments[ index ].length ) );
+                isValid = false;
+            }
+            else
+            {
+                *pTotalSize += pSegments[ index ].length;
+            }
+        }
+    }
+
+    return isValid;
+}
+
+/**
+ * @brief Locates the SNTP packet header in the segments of a received packet.
+ *
+ * The header is used in place when the first segment holds all of it;
+ * otherwise, it is gathered from the segments into @p pHeaderCopy.
+ *
+ * @param[in] pSegments The valid segments of the packet.
+ * @param[in] segmentCount The number of segments in @p pSegments.
+ * @param[in] availableSize The number of bytes of the packet in the segments.
+ * @param[out] pHeaderCopy The memory to gather the header into.
+ * @param[out] ppHeader This is filled with the location of the header.
+ *
+ * @return The number of header bytes at @p ppHeader, which is less than
+ * #SNTP_PACKET_BASE_SIZE only if fewer bytes are available.
+ */
+static size_t locatePacketHeader( const SntpIoVector_t * pSegments,
+                                  size_t segmentCount,
+                                  size_t availableSize,
+                                  SntpPacket_t * pHeaderCopy,
+                                  const void ** ppHeader )
+{
+    size_t headerSize = ( availableSize < SNTP_PACKET_BASE_SIZE ) ? availableSize : SNTP_PACKET_BASE_SIZE;
+    size_t copiedSize = 0U;
+    size_t copyLength;
+    size_t index;
+
+    assert( pSegments != NULL );
+    assert( segmentCount > 0U );
+    assert( pHeaderCopy != NULL );
+    assert( ppHeader != NULL );
+
+    if( pSegments[ 0 ].length >= headerSize )
+    {
+        *ppHeader = pSegments[ 0 ].pBase;
+        copiedSize = headerSize;
+    }
+    else
+    {
+        for( index = 0U; ( index < segmentCount ) && ( copiedSize < headerSize ); index++ )
+        {
+            copyLength = headerSize - copiedSize;
+
+            if( pSegments[ index ].length < copyLength )
+            {
+                copyLength = pSegments[ index ].length;
+            }
+
+            if( copyLength > 0U )
+            {
+                ( void ) memcpy( ( uint8_t * ) pHeaderCopy + copiedSize, pSegments[ index ].pBase, copyLength );
+                copiedSize += copyLength;
+            }
+        }
+
+        *ppHeader = pHeaderCopy;
+    }
+
+    return copiedSize;
+}
+
+/**
+ * @brief Locates the bytes after the SNTP packet header in the segments of a
+ * received packet.
+ *
+ * @param[in] pSegments The valid segments of the packet.
+ * @param[in] segmentCount The number of segments in @p pSegments.
+ * @param[in] availableSize The number of bytes of the packet in the segments,
+ * which is at least #SNTP_PACKET_BASE_SIZE.
+ * @param[out] pTail This is filled with the location of the bytes after the
+ * header.
+ */
+static void locatePacketTail( const SntpIoVector_t * pSegments,
+                              size_t segmentCount,
+                              size_t availableSize,
+                              SntpPacketTail_t * pTail )
+{
+    size_t headerLeft = SNTP_PACKET_BASE_SIZE;
+    size_t index = 0U;
+
+    assert( pSegments != NULL );
+    assert( availableSize >= SNTP_PACKET_BASE_SIZE );
+    assert( pTail != NULL );
+
+    /* Skip the segments, including empty ones, that end within the header. */
+    while( ( index < segmentCount ) && ( pSegments[ index ].length <= headerLeft ) )
+    {
+        headerLeft -= pSegments[ index ].length;
+        index++;
+    }
+
+    pTail->segmentIndex = index;
+    pTail->offset = headerLeft;
+    pTail->length = availableSize - SNTP_PACKET_BASE_SIZE;
+}
+
 SntpStatus_t Sntp_SerializeRequest( SntpTimestamp_t * pRequestTime,
                                     uint32_t randomNumber,
                                     void * pBuffer,
@@ -450,14 +768,18 @@ SntpStatus_t Sntp_SerializeRequest( SntpTimestamp_t * pRequestTime,
 
     if( pRequestTime == NULL )
     {
+        LogError( ( "Invalid parameter: pRequestTime cannot be NULL" ) );
         status = SntpErrorBadParameter;
     }
     else if( pBuffer == NULL )
     {
+        LogError( ( "Invalid parameter: pBuffer cannot be NULL" ) );
         status = SntpErrorBadParameter;
     }
     else if( bufferSize < SNTP_PACKET_BASE_SIZE )
     {
+        LogError( ( "Cannot serialize request: Buffer is smaller than an SNTP packet: "
+                    "BufferSize=%lu", ( unsigned long ) bufferSize ) );
         status = SntpErrorBufferTooSmall;
     }
     else
@@ -509,10 +831,15 @@ SntpStatus_t Sntp_DeserializeResponse( const SntpTimestamp_t * pRequestTime,
     if( ( pRequestTime == NULL ) || ( pResponseRxTime == NULL ) ||
         ( pResponseBuffer == NULL ) || ( pParsedResponse == NULL ) )
     {
+        LogError( ( "Invalid parameter: pRequestTime=%p, pResponseRxTime=%p, pResponseBuffer=%p, "
+                    "pParsedResponse=%p cannot be NULL", ( const void * ) pRequestTime,
+                    ( const void * ) pResponseRxTime, pResponseBuffer, ( void * ) pParsedResponse ) );
         status = SntpErrorBadParameter;
     }
     else if( bufferSize < SNTP_PACKET_BASE_SIZE )
     {
+        SNTP_LOG_RATE_LIMITED( LogWarn, ( "Response is smaller than an SNTP packet: BufferSize=%lu",
+                                          ( unsigned long ) bufferSize ) );
         status = SntpErrorBufferTooSmall;
     }
     else
@@ -522,6 +849,9 @@ SntpStatus_t Sntp_DeserializeResponse( const SntpTimestamp_t * pRequestTime,
         /* Check if the packet represents a server in the "Mode" field. */
         if( ( pResponsePacket->leapVersionMode & SNTP_MODE_BITS_MASK ) != SNTP_MODE_SERVER )
         {
+            SNTP_LOG_RATE_LIMITED( LogWarn, ( "Invalid response: Packet is not in server mode: "
+                                              "LeapVersionMode=0x%02x",
+                                              ( unsigned int ) pResponsePacket->leapVersionMode ) );
             status = SntpInvalidResponse;
         }
 
@@ -534,6 +864,8 @@ SntpStatus_t Sntp_DeserializeResponse( const SntpTimestamp_t * pRequestTime,
                 ( pRequestTime->fractions !=
                   readWordFromNetworkByteOrderMemory( &pResponsePacket->originTime.fractions ) ) )
             {
+                SNTP_LOG_RATE_LIMITED( LogWarn, ( "Invalid response: Originate timestamp does not match "
+                                                  "the time request" ) );
                 status = SntpInvalidResponse;
             }
         }
@@ -553,6 +885,97 @@ SntpStatus_t Sntp_DeserializeResponse( const SntpTimestamp_t * pRequestTime,
     return status;
 }
 
+SntpStatus_t Sntp_SerializeRequestVector( SntpTimestamp_t * pRequestTime,
+                                          uint32_t randomNumber,
+                                          const SntpIoVector_t * pSegments,
+                                          size_t segmentCount,
+                                          size_t * pPacketSize )
+{
+    SntpStatus_t status = SntpSuccess;
+    size_t packetSize = 0U;
+
+    if( pPacketSize == NULL )
+    {
+        LogError( ( "Invalid parameter: pPacketSize cannot be NULL" ) );
+        status = SntpErrorBadParameter;
+    }
+    else if( validateSegments( pSegments, segmentCount, true, &packetSize ) == false )
+    {
+        LogError( ( "Invalid parameter: Invalid packet segments: SegmentCount=%lu",
+                    ( unsigned long ) segmentCount ) );
+        status = SntpErrorBadParameter;
+    }
+    else if( pSegments[ 0 ].length > SNTP_PACKET_BASE_SIZE )
+    {
+        /* The packet size counts every byte of the segments, so bytes after the
+         * header in the first segment would be sent without being written. */
+        LogError( ( "Invalid parameter: First segment is larger than the packet header: "
+                    "Length=%lu", ( unsigned long ) pSegments[ 0 ].length ) );
+        status = SntpErrorBadParameter;
+    }
+    else
+    {
+        /* The header is serialized in the first segment, and the remaining
+         * segments of the packet are left to the application. */
+        status = Sntp_SerializeRequest( pRequestTime,
+                                        randomNumber,
+                                        pSegments[ 0 ].pBase,
+                                        pSegments[ 0 ].length );
+    }
+
+    if( status == SntpSuccess )
+    {
+        *pPacketSize = packetSize;
+    }
+
+    return status;
+}
+
+SntpStatus_t Sntp_DeserializeResponseVector( const SntpTimestamp_t * pRequestTime,
+                                             const SntpTimestamp_t * pResponseRxTime,
+                                             const SntpIoVector_t * pSegments,
+                                             size_t segmentCount,
+                                             size_t receivedSize,
+                                             SntpResponseData_t * pParsedResponse,
+                                             SntpPacketTail_t * pTail )
+{
+    SntpStatus_t status = SntpSuccess;
+    SntpPacket_t headerCopy;
+    const void * pHeader = NULL;
+    size_t availableSize = 0U;
+    size_t headerSize;
+
+    if( validateSegments( pSegments, segmentCount, false, &availableSize ) == false )
+    {
+        LogError( ( "Invalid parameter: Invalid packet segments: SegmentCount=%lu",
+                    ( unsigned long ) segmentCount ) );
+        status = SntpErrorBadParameter;
+    }
+    else
+    {
+        /* Only the received bytes of the segments hold the packet. */
+        if( receivedSize < availableSize )
+        {
+            availableSize = receivedSize;
+        }
+
+        headerSize = locatePacketHeader( pSegments, segmentCount, availableSize, &headerCopy, &pHeader );
+
+        if( ( pTail != NULL ) && ( headerSize == SNTP_PACKET_BASE_SIZE ) )
+        {
+            locatePacketTail( pSegments, segmentCount, availableSize, pTail );
+        }
+
+        status = Sntp_DeserializeResponse( pRequestTime,
+                                           pResponseRxTime,
+                                           pHeader,
+                                           headerSize,
+                                           pParsedResponse );
+    }
+
+    return status;
+}
+
 SntpStatus_t Sntp_CalculatePollInterval( uint16_t clockFreqTolerance,
                                          uint16_t desiredAccuracy,
                                          uint32_t * pPollInterval )
@@ -653,8 +1076,76 @@ SntpStatus_t Sntp_ConvertToUnixTime( const SntpTimestamp_t * pSntpTime,
             *pUnixTimeSecs = pSntpTime->seconds - SNTP_TIME_AT_UNIX_EPOCH_SECS;
         }
 
-        /* Convert SNTP fractions to microseconds for UNIX time. */
-        *pUnixTimeMicrosecs = pSntpTime->fractions / SNTP_FRACTION_VALUE_PER_MICROSECOND;
+        /* Convert SNTP fractions to microseconds for UNIX time with a
+         * multiplication and shift, which truncates the exact value. */
+        *pUnixTimeMicrosecs = ( uint32_t ) ( ( ( uint64_t ) pSntpTime->fractions * MICROSECONDS_PER_SECOND ) >> 32 );
+    }
+
+    return status;
+}
+
+SntpStatus_t Sntp_ConvertToUnixTime64( const SntpTimestamp_t * pSntpTime,
+                                       int64_t pivotUnixTimeSecs,
+                                       int64_t * pUnixTimeSecs,
+                                       uint32_t * pUnixTimeNanosecs )
+{
+    SntpStatus_t status = SntpSuccess;
+
+    if( ( pSntpTime == NULL ) || ( pUnixTimeSecs == NULL ) || ( pUnixTimeNanosecs == NULL ) ||
+        ( pivotUnixTimeSecs > SNTP_MAX_ERA_PIVOT_UNIX_SECS ) || ( pivotUnixTimeSecs < -SNTP_MAX_ERA_PIVOT_UNIX_SECS ) )
+    {
+        status = SntpErrorBadParameter;
+    }
+    else
+    {
+        uint32_t secondsFromPivot;
+
+        /* The seconds of the SNTP timestamp are the seconds of the time since the
+         * SNTP epoch modulo 2^32. The modulo difference from the SNTP seconds of
+         * the pivot time is the time from the pivot time, either forwards (for
+         * differences below 2^31) or backwards. */
+        secondsFromPivot = pSntpTime->seconds -
+                           ( uint32_t ) ( ( uint64_t ) pivotUnixTimeSecs + SNTP_TIME_AT_UNIX_EPOCH_SECS );
+
+        if( secondsFromPivot < HALF_SNTP_ERA_SECS )
+        {
+            *pUnixTimeSecs = pivotUnixTimeSecs + ( int64_t ) secondsFromPivot;
+        }
+        else
+        {
+            *pUnixTimeSecs = pivotUnixTimeSecs - ( int64_t ) ( UINT32_MAX - secondsFromPivot ) - 1;
+        }
+
+        /* Convert SNTP fractions to nanoseconds with a multiplication and shift,
+         * which truncates the exact value. */
+        *pUnixTimeNanosecs = ( uint32_t ) ( ( ( uint64_t ) pSntpTime->fractions * NANOSECONDS_PER_SECOND ) >> 32 );
+    }
+
+    return status;
+}
+
+SntpStatus_t Sntp_ConvertFromUnixTime64( int64_t unixTimeSecs,
+                                         uint32_t unixTimeNanosecs,
+                                         SntpTimestamp_t * pSntpTime )
+{
+    SntpStatus_t status = SntpSuccess;
+
+    if( ( pSntpTime == NULL ) || ( unixTimeNanosecs >= NANOSECONDS_PER_SECOND ) )
+    {
+        status = SntpErrorBadParameter;
+    }
+    else
+    {
+        /* The SNTP seconds wrap around into the next (or previous) SNTP era, which
+         * the modulo arithmetic of unsigned integers provides for negative Unix
+         * times as well. */
+        pSntpTime->seconds = ( uint32_t ) ( ( uint64_t ) unixTimeSecs + SNTP_TIME_AT_UNIX_EPOCH_SECS );
+
+        /* As the nanoseconds are below 2^30, the shifted value fits in 62 bits.
+         * The division rounds up so that converting the fractions back to
+         * nanoseconds (with truncation) returns the same nanoseconds value. */
+        pSntpTime->fractions = ( uint32_t ) ( ( ( ( uint64_t ) unixTimeNanosecs << 32 ) +
+                                                ( NANOSECONDS_PER_SECOND - 1U ) ) / NANOSECONDS_PER_SECOND );
     }
 
     return status;
@@ -0,0 +1,362 @@
+/*
+ * coreSNTP v1.0.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file core_sntp_stability.c
+ * @brief Implementation of the clock stability estimator API of the coreSNTP
+ * library.
+ */
+
+/* Standard includes. */
+#include <string.h>
+#include <assert.h>
+
+/* Include API header. */
+#include "core_sntp_stability.h"
+#include "core_sntp_fixed_point.h"
+#include "core_sntp_math.h"
+
+/**
+ * @brief The number of nanoseconds in a second.
+ */
+#define NANOSECONDS_PER_SECOND      ( 1000000000U )
+
+/**
+ * @brief The number of parts per trillion in a frequency error of 1 nanosecond
+ * per millisecond.
+ */
+#define PPT_PER_NS_PER_MS           ( 1000000U )
+
+/**
+ * @brief The number of milliseconds in a second.
+ */
+#define MILLISECONDS_PER_SECOND     ( 1000U )
+
+/**
+ * @brief The longest interval, in milliseconds, between the samples of a level
+ * that is used for measuring frequency (about 49 days).
+ */
+#define MAX_INTERVAL_MS             ( ( uint64_t ) UINT32_MAX )
+
+/**
+ * @brief The number of parts per trillion in an Allan deviation of 1, which
+ * relates the desired accuracy in milliseconds to the accumulated time error.
+ */
+#define PPT_PER_MS_PER_MS           ( 1000000000000U )
+
+/**
+ * @brief Updates a running average, which is the plain average of the first
+ * @p numOfSamples values, with a new value.
+ *
+ * @param[in] average The current average.
+ * @param[in] value The new value.
+ * @param[in] numOfSamples The number of values in the average, including the
+ * new value. This MUST be non-zero.
+ *
+ * @return The updated average.
+ */
+static uint64_t updateAverage( uint64_t average,
+                               uint64_t value,
+                               uint32_t numOfSamples )
+{
+    assert( numOfSamples > 0U );
+
+    /* The differences are calculated in the direction that does not underflow. */
+    if( value >= average )
+    {
+        average += ( value - average ) / numOfSamples;
+    }
+    else
+    {
+        average -= ( average - value ) / numOfSamples;
+    }
+
+    return average;
+}
+
+/**
+ * @brief Restarts the frequency measurements of a level from a sample.
+ *
+ * @param[in, out] pLevel The level of the estimator.
+ * @param[in] localTime The local time of the sample.
+ * @param[in] clockOffset The clock offset of the sample.
+ */
+static void restartLevel( SntpStabilityLevel_t * pLevel,
+                          uint64_t localTime,
+                          int64_t clockOffset )
+{
+    assert( pLevel != NULL );
+
+    pLevel->lastTime = localTime;
+    pLevel->lastOffset = clockOffset;
+    pLevel->numOfPoints = 1U;
+}
+
+/**
+ * @brief Updates a level of the estimator with a sample.
+ *
+ * The frequency error over the interval since the last sample of the level is
+ * measured from the change in clock offset. The Allan variance is half the
+ * average squared difference between the frequency errors of successive
+ * intervals.
+ *
+ * @param[in, out] pLevel The level of the estimator.
+ * @param[in] localTime The local time of the sample.
+ * @param[in] clockOffset The clock offset of the sample.
+ */
+static void updateLevel( SntpStabilityLevel_t * pLevel,
+                         uint64_t localTime,
+                         int64_t clockOffset )
+{
+    uint64_t intervalMs;
+    uint64_t offsetChange;
+    int64_t frequency;
+    uint64_t frequencyDifference;
+
+    assert( pLevel != NULL );
+
+    /* A local time before the last sample results in a very long interval. */
+    intervalMs = Sntp_FixedScale( localTime - pLevel->lastTime, MILLISECONDS_PER_SECOND );
+
+    /* The magnitude of the change in clock offset is calculated with the modulo
+     * arithmetic of unsigned integers, which does not overflow. */
+    offsetChange = ( clockOffset >= pLevel->lastOffset ) ?
+                   ( ( uint64_t ) clockOffset - ( uint64_t ) pLevel->lastOffset ) :
+                   ( ( uint64_t ) pLevel->lastOffset - ( uint64_t ) clockOffset );
+
+    if( pLevel->numOfPoints == 0U )
+    {
+        restartLevel( pLevel, localTime, clockOffset );
+    }
+    else if( ( intervalMs == 0U ) || ( intervalMs > MAX_INTERVAL_MS ) ||
+             ( offsetChange > ( intervalMs * SNTP_FRACTION_VALUE_PER_MICROSECOND ) ) )
+    {
+        /* The samples are too close or too far apart, or the change in clock
+         * offset implies a frequency error beyond 0.1% (i.e. 1 microsecond per
+         * millisecond), which is a discontinuity rather than oscillator drift. */
+        restartLevel( pLevel, localTime, clockOffset );
+    }
+    else
+    {
+        /* The limits checked above keep the frequency error, in parts per
+         * trillion, within 10^9, and its calculation within 64 bits. */
+        frequency = ( int64_t ) ( ( Sntp_FixedScale( offsetChange, NANOSECONDS_PER_SECOND ) *
+                                    PPT_PER_NS_PER_MS ) / intervalMs );
+
+        if( clockOffset < pLevel->lastOffset )
+        {
+            frequency = -frequency;
+        }
+
+        if( pLevel->numOfPoints > 1U )
+        {
+            frequencyDifference = ( frequency >= pLevel->lastFrequency ) ?
+                                  ( uint64_t ) ( frequency - pLevel->lastFrequency ) :
+                                  ( uint64_t ) ( pLevel->lastFrequency - frequency );
+
+            if( pLevel->numOfSamples < SNTP_STABILITY_AVERAGE_SAMPLES )
+            {
+                pLevel->numOfSamples++;
+            }
+
+            pLevel->allanVariance = updateAverage( pLevel->allanVariance,
+                                                   ( frequencyDifference * frequencyDifference ) / 2U,
+                                                   pLevel->numOfSamples );
+        }
+
+        /* Every measured interval contributes to the averaging time. */
+        pLevel->averageIntervalMs = updateAverage( pLevel->averageIntervalMs,
+                                                   intervalMs,
+                                                   pLevel->numOfSamples + 1U );
+
+        pLevel->lastFrequency = frequency;
+        pLevel->lastTime = localTime;
+        pLevel->lastOffset = clockOffset;
+        pLevel->numOfPoints = 2U;
+    }
+}
+
+SntpStatus_t Sntp_InitStabilityEstimator( SntpStabilityEstimator_t * pEstimator )
+{
+    SntpStatus_t status = SntpSuccess;
+
+    if( pEstimator == NULL )
+    {
+        status = SntpErrorBadParameter;
+    }
+    else
+    {
+        ( void ) memset( pEstimator, 0, sizeof( SntpStabilityEstimator_t ) );
+    }
+
+    return status;
+}
+
+SntpStatus_t Sntp_UpdateStabilityEstimator( SntpStabilityEstimator_t * pEstimator,
+                                            const SntpTimestamp_t * pLocalTime,
+                                            int64_t clockOffset )
+{
+    SntpStatus_t status = SntpSuccess;
+
+    if( ( pEstimator == NULL ) || ( pLocalTime == NULL ) )
+    {
+        status = SntpErrorBadParameter;
+    }
+    else
+    {
+        SntpFixedTime_t localTime = Sntp_FixedFromTimestamp( *pLocalTime );
+        size_t i;
+
+        /* Level k uses every 2^k-th sample. As the sample count wraps around at a
+         * power of 2, the selection stays consistent across the wrap-around. */
+        for( i = 0U; i < SNTP_STABILITY_NUM_TAUS; i++ )
+        {
+            if( ( pEstimator->sampleCount & ( ( ( uint32_t ) 1U << i ) - 1U ) ) == 0U )
+            {
+                updateLevel( &pEstimator->levels[ i ], localTime, clockOffset );
+            }
+        }
+
+        pEstimator->sampleCount++;
+    }
+
+    return status;
+}
+
+SntpStatus_t Sntp_MarkStabilityDiscontinuity( SntpStabilityEstimator_t * pEstimator )
+{
+    SntpStatus_t status = SntpSuccess;
+
+    if( pEstimator == NULL )
+    {
+        status = SntpErrorBadParameter;
+    }
+    else
+    {
+        size_t i;
+
+        for( i = 0U; i < SNTP_STABILITY_NUM_TAUS; i++ )
+        {
+            pEstimator->levels[ i ].numOfPoints = 0U;
+        }
+    }
+
+    return status;
+}
+
+SntpStatus_t Sntp_GetAllanDeviation( const SntpStabilityEstimator_t * pEstimator,
+                                     size_t tauIndex,
+                                     uint64_t * pTauMs,
+                                     uint64_t * pAllanDeviation )
+{
+    SntpStatus_t status = SntpSuccess;
+
+    if( ( pEstimator == NULL ) || ( tauIndex >= SNTP_STABILITY_NUM_TAUS ) ||
+        ( pTauMs == NULL ) || ( pAllanDeviation == NULL ) )
+    {
+        status = SntpErrorBadParameter;
+    }
+    else if( pEstimator->levels[ tauIndex ].numOfSamples < SNTP_STABILITY_MIN_SAMPLES )
+    {
+        status = SntpInsufficientSamples;
+    }
+    else
+    {
+        *pTauMs = pEstimator->levels[ tauIndex ].averageIntervalMs;
+        *pAllanDeviation = Sntp_SquareRoot64( pEstimator->levels[ tauIndex ].allanVariance );
+    }
+
+    return status;
+}
+
+SntpStatus_t Sntp_CalculateAdaptivePollInterval( const SntpStabilityEstimator_t * pEstimator,
+                                                 uint16_t desiredAccuracy,
+                                                 uint32_t * pPollInterval )
+{
+    SntpStatus_t status = SntpSuccess;
+    uint64_t shortestTauMs = 0U;
+    uint64_t selectedTauMs = 0U;
+    uint64_t tauMs, allanDeviation;
+    size_t i;
+
+    if( ( pEstimator == NULL ) || ( desiredAccuracy == 0U ) || ( pPollInterval == NULL ) )
+    {
+        status = SntpErrorBadParameter;
+    }
+    else
+    {
+        for( i = 0U; i < SNTP_STABILITY_NUM_TAUS; i++ )
+        {
+            if( Sntp_GetAllanDeviation( pEstimator, i, &tauMs, &allanDeviation ) == SntpSuccess )
+            {
+                if( shortestTauMs == 0U )
+                {
+                    shortestTauMs = tauMs;
+                }
+
+                /* The time error accumulated over tau, in milliseconds, is
+                 * ( tau * Allan deviation / 10^12 ). The product fits in 64 bits
+                 * as both the interval and the frequency error are limited. */
+                if( ( tauMs * allanDeviation ) <= ( ( uint64_t ) desiredAccuracy * PPT_PER_MS_PER_MS ) )
+                {
+                    selectedTauMs = tauMs;
+                }
+            }
+        }
+
+        if( shortestTauMs == 0U )
+        {
+            status = SntpInsufficientSamples;
+        }
+        else
+        {
+            uint32_t tauSecs;
+
+            /* Poll as often as measured if no averaging time achieves the
+             * desired accuracy. */
+            if( selectedTauMs == 0U )
+            {
+                selectedTauMs = shortestTauMs;
+            }
+
+            tauSecs = ( uint32_t ) ( selectedTauMs / MILLISECONDS_PER_SECOND );
+
+            if( tauSecs == 0U )
+            {
+                status = SntpZeroPollInterval;
+            }
+            else
+            {
+                /* Round down to a power of 2. */
+                *pPollInterval = 1U;
+
+                while( tauSecs > 1U )
+                {
+                    *pPollInterval <<= 1;
+                    tauSecs >>= 1;
+                }
+            }
+        }
+    }
+
+    return status;
+}
@@ -0,0 +1,195 @@
+/*
+ * coreSNTP v1.0.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file core_sntp_timeout.c
+ * @brief Implementation of the response timeout estimator API of the coreSNTP
+ * library.
+ */
+
+/* Standard includes. */
+#include <string.h>
+#include <assert.h>
+
+/* Include API header. */
+#include "core_sntp_timeout.h"
+#include "core_sntp_fixed_point.h"
+
+/**
+ * @brief The number of nanoseconds in a microsecond.
+ */
+#define NANOSECONDS_PER_MICROSECOND     ( 1000 )
+
+/**
+ * @brief The number of microseconds in a millisecond.
+ */
+#define MICROSECONDS_PER_MILLISECOND    ( 1000U )
+
+/**
+ * @brief The inverse of the gain of the smoothed round-trip time (1/alpha of
+ * RFC 6298).
+ */
+#define SMOOTHED_RTT_DIVISOR            ( 8U )
+
+/**
+ * @brief The inverse of the gain of the round-trip time variation (1/beta of
+ * RFC 6298).
+ */
+#define RTT_VARIATION_DIVISOR           ( 4U )
+
+/**
+ * @brief Calculates the response timeout from the smoothed round-trip time and
+ * its variation, rounded up to whole milliseconds and limited to the range of
+ * #SNTP_TIMEOUT_MIN_MS and #SNTP_TIMEOUT_MAX_MS.
+ *
+ * @param[in] pEstimator The estimator.
+ *
+ * @return The response timeout, in milliseconds.
+ */
+static uint32_t calculateTimeout( const SntpTimeoutEstimator_t * pEstimator )
+{
+    uint64_t timeoutMs;
+
+    assert( pEstimator != NULL );
+
+    timeoutMs = ( uint64_t ) pEstimator->smoothedRttUs +
+                ( ( uint64_t ) SNTP_TIMEOUT_VARIATION_MULTIPLIER * pEstimator->rttVariationUs );
+    timeoutMs = ( timeoutMs + ( MICROSECONDS_PER_MILLISECOND - 1U ) ) / MICROSECONDS_PER_MILLISECOND;
+
+    if( timeoutMs < SNTP_TIMEOUT_MIN_MS )
+    {
+        timeoutMs = SNTP_TIMEOUT_MIN_MS;
+    }
+    else if( timeoutMs > SNTP_TIMEOUT_MAX_MS )
+    {
+        timeoutMs = SNTP_TIMEOUT_MAX_MS;
+    }
+    else
+    {
+        /* Empty else MISRA 15.7 */
+    }
+
+    return ( uint32_t ) timeoutMs;
+}
+
+SntpStatus_t Sntp_InitTimeoutEstimators( SntpTimeoutEstimator_t * pEstimators,
+                                         size_t numOfServers )
+{
+    SntpStatus_t status = SntpSuccess;
+
+    if( ( pEstimators == NULL ) || ( numOfServers == 0U ) )
+    {
+        status = SntpErrorBadParameter;
+    }
+    else
+    {
+        ( void ) memset( pEstimators, 0, numOfServers * sizeof( SntpTimeoutEstimator_t ) );
+    }
+
+    return status;
+}
+
+SntpStatus_t Sntp_UpdateTimeoutEstimator( SntpTimeoutEstimator_t * pEstimator,
+                                          int64_t latencyFractions )
+{
+    SntpStatus_t status = SntpSuccess;
+    uint64_t latencyUs;
+    uint64_t deviationUs;
+
+    if( ( pEstimator == NULL ) || ( latencyFractions < 0 ) )
+    {
+        status = SntpErrorBadParameter;
+    }
+    else
+    {
+        latencyUs = ( uint64_t ) ( Sntp_FixedToNanoseconds( latencyFractions ) / NANOSECONDS_PER_MICROSECOND );
+
+        if( latencyUs > UINT32_MAX )
+        {
+            latencyUs = UINT32_MAX;
+        }
+
+        if( pEstimator->timeoutMs == 0U )
+        {
+            pEstimator->smoothedRttUs = ( uint32_t ) latencyUs;
+            pEstimator->rttVariationUs = ( uint32_t ) ( latencyUs / 2U );
+        }
+        else
+        {
+            /* The variation is updated with the deviation from the smoothed
+             * round-trip time before the latency updates it. */
+            deviationUs = ( latencyUs >= pEstimator->smoothedRttUs ) ?
+                          ( latencyUs - pEstimator->smoothedRttUs ) :
+                          ( pEstimator->smoothedRttUs - latencyUs );
+
+            pEstimator->rttVariationUs = ( uint32_t ) ( ( ( ( uint64_t ) pEstimator->rttVariationUs *
+                                                            ( RTT_VARIATION_DIVISOR - 1U ) ) + deviationUs ) /
+                                                        RTT_VARIATION_DIVISOR );
+            pEstimator->smoothedRttUs = ( uint32_t ) ( ( ( ( uint64_t ) pEstimator->smoothedRttUs *
+                                                           ( SMOOTHED_RTT_DIVISOR - 1U ) ) + latencyUs ) /
+                                                       SMOOTHED_RTT_DIVISOR );
+        }
+
+        pEstimator->timeoutMs = calculateTimeout( pEstimator );
+    }
+
+    return status;
+}
+
+SntpStatus_t Sntp_BackOffTimeoutEstimator( SntpTimeoutEstimator_t * pEstimator )
+{
+    SntpStatus_t status = SntpSuccess;
+
+    if( pEstimator == NULL )
+    {
+        status = SntpErrorBadParameter;
+    }
+    else if( pEstimator->timeoutMs > ( SNTP_TIMEOUT_MAX_MS / 2U ) )
+    {
+        pEstimator->timeoutMs = SNTP_TIMEOUT_MAX_MS;
+    }
+    else
+    {
+        /* An estimator without a timeout remains without one. */
+        pEstimator->timeoutMs *= 2U;
+    }
+
+    return status;
+}
+
+SntpStatus_t Sntp_GetResponseTimeout( const SntpTimeoutEstimator_t * pEstimator,
+                                      uint32_t defaultTimeoutMs,
+                                      uint32_t * pTimeoutMs )
+{
+    SntpStatus_t status = SntpSuccess;
+
+    if( ( pEstimator == NULL ) || ( pTimeoutMs == NULL ) )
+    {
+        status = SntpErrorBadParameter;
+    }
+    else
+    {
+        *pTimeoutMs = ( pEstimator->timeoutMs == 0U ) ? defaultTimeoutMs : pEstimator->timeoutMs;
+    }
+
+    return status;
+}
@@ -0,0 +1,119 @@
+/*
+ * coreSNTP v1.0.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file core_sntp_batch.h
+ * @brief API for converting arrays of timestamps between SNTP timestamps and
+ * UNIX time in nanoseconds.
+ *
+ * The batch conversions produce the same results as converting each element
+ * with @ref Sntp_ConvertToUnixTime64 and @ref Sntp_ConvertFromUnixTime64, for
+ * applications that convert large numbers of timestamps, for example, from
+ * captured network traffic.
+ *
+ * The conversion to UNIX time uses an AVX2 kernel when the library is compiled
+ * for a target with AVX2 (i.e. `__AVX2__` is defined), or a NEON kernel when it
+ * is compiled for a target with Advanced SIMD (i.e. `__ARM_NEON` is defined).
+ * Otherwise, and for the elements left over by the vector kernels, a scalar
+ * kernel is used. Define `SNTP_BATCH_DISABLE_SIMD` to always use the scalar
+ * kernel.
+ *
+ * The conversion from UNIX time has no vector kernel, as it divides each
+ * element by 10^9 in 64 bits. It is no faster than converting each element
+ * with @ref Sntp_ConvertFromUnixTime64, and only saves the splitting of the
+ * nanoseconds.
+ */
+
+#ifndef CORE_SNTP_BATCH_H_
+#define CORE_SNTP_BATCH_H_
+
+/* Standard include. */
+#include <stdint.h>
+#include <stddef.h>
+
+/* Include coreSNTP Serializer header. */
+#include "core_sntp_serializer.h"
+
+/**
+ * @brief The largest magnitude of the pivot time, in seconds of UNIX time, for
+ * which every SNTP timestamp converts to UNIX time in nanoseconds that fits in
+ * a signed 64-bit integer.
+ *
+ * @note The value, 7075888387 (about the year 2194), is the largest signed
+ * 64-bit value in nanoseconds, in whole seconds, less 2^31 seconds (half an
+ * SNTP era). It is written as a product and sum to avoid a 64-bit integer
+ * constant.
+ */
+#define SNTP_MAX_BATCH_PIVOT_UNIX_SECS    ( ( ( int64_t ) 7 * 1000000000 ) + 75888387 )
+
+/**
+ * @brief Converts an array of SNTP timestamps to UNIX time in nanoseconds.
+ *
+ * Each element is converted as by @ref Sntp_ConvertToUnixTime64, and the
+ * result, in nanoseconds since the UNIX epoch, is
+ * `( unixTimeSecs * 1000000000 ) + unixTimeNanosecs`.
+ *
+ * @param[in] pSntpTimes The array of SNTP timestamps to convert.
+ * @param[in] count The number of elements to convert.
+ * @param[in] pivotUnixTimeSecs The pivot time, in seconds of UNIX time, that
+ * resolves the SNTP era of the timestamps, for example,
+ * #SNTP_DEFAULT_ERA_PIVOT_UNIX_SECS. It must be within
+ * #SNTP_MAX_BATCH_PIVOT_UNIX_SECS of the UNIX epoch.
+ * @param[out] pUnixTimesNs The array, of at least @p count elements, that will
+ * be filled with the UNIX times in nanoseconds. It may not overlap
+ * @p pSntpTimes.
+ *
+ * @return Returns one of the following:
+ * - #SntpSuccess if the timestamps are converted.
+ * - #SntpErrorBadParameter if either array is NULL when @p count is not zero,
+ * or the pivot time is outside the supported range.
+ */
+/* @[define_sntp_converttounixnanosecsbatch] */
+SntpStatus_t Sntp_ConvertToUnixNanosecsBatch( const SntpTimestamp_t * pSntpTimes,
+                                              size_t count,
+                                              int64_t pivotUnixTimeSecs,
+                                              int64_t * pUnixTimesNs );
+/* @[define_sntp_converttounixnanosecsbatch] */
+
+/**
+ * @brief Converts an array of UNIX times in nanoseconds to SNTP timestamps.
+ *
+ * Each element is split into seconds and nanoseconds (rounding the seconds
+ * down, so the nanoseconds are never negative), and converted as by
+ * @ref Sntp_ConvertFromUnixTime64.
+ *
+ * @param[in] pUnixTimesNs The array of UNIX times in nanoseconds to convert.
+ * @param[in] count The number of elements to convert.
+ * @param[out] pSntpTimes The array, of at least @p count elements, that will be
+ * filled with the SNTP timestamps. It may not overlap @p pUnixTimesNs.
+ *
+ * @return Returns one of the following:
+ * - #SntpSuccess if the times are converted.
+ * - #SntpErrorBadParameter if either array is NULL when @p count is not zero.
+ */
+/* @[define_sntp_convertfromunixnanosecsbatch] */
+SntpStatus_t Sntp_ConvertFromUnixNanosecsBatch( const int64_t * pUnixTimesNs,
+                                                size_t count,
+                                                SntpTimestamp_t * pSntpTimes );
+/* @[define_sntp_convertfromunixnanosecsbatch] */
+
+#endif /* ifndef CORE_SNTP_BATCH_H_ */
@@ -40,6 +40,27 @@
 /* Include coreSNTP Serializer header. */
 #include "core_sntp_serializer.h"
 
+/* Include coreSNTP Virtual Clock header. */
+#include "core_sntp_clock.h"
+
+/* Include coreSNTP outlier gate header. */
+#include "core_sntp_filter.h"
+
+/* Include coreSNTP clock stability estimator header. */
+#include "core_sntp_stability.h"
+
+/* Include coreSNTP histogram header. */
+#include "core_sntp_histogram.h"
+
+/* Include coreSNTP statistics header. */
+#include "core_sntp_metrics.h"
+
+/* Include coreSNTP response timeout estimator header. */
+#include "core_sntp_timeout.h"
+
+/* Include coreSNTP server health header. */
+#include "core_sntp_health.h"
+
 /**
  * @ingroup core_sntp_callback_types
  * @brief Interface for user-defined function to resolve time server domain-name
@@ -113,6 +134,25 @@ typedef bool ( * SntpSetTime_t )( const char * pTimeServer,
  */
 #define SNTP_DEFAULT_SERVER_PORT    ( 123U )
 
+/**
+ * @brief The largest percentage of time requests that can be hedged with a
+ * request to the next server, as set with @ref Sntp_SetHedging.
+ */
+#define SNTP_MAX_HEDGE_PERCENT           ( 100U )
+
+/**
+ * @brief The percentile of the response latency of the current server, in
+ * parts per million, after which a time request is hedged.
+ */
+#define SNTP_HEDGE_LATENCY_PERCENTILE    ( 950000U )
+
+/**
+ * @brief The number of response latencies of the current server that must be
+ * recorded before its time requests are hedged, so that the percentile of
+ * #SNTP_HEDGE_LATENCY_PERCENTILE is meaningful.
+ */
+#define SNTP_HEDGE_MIN_SAMPLES           ( 20U )
+
 /**
  * @brief core_sntp_struct_types
  * @brief Structure representing information for a time server.
@@ -322,6 +362,95 @@ typedef struct SntpAuthenticationIntf
     SntpValidateAuthCode_t validateServer;
 } SntpAuthenticationInterface_t;
 
+#ifdef SNTP_ENABLE_TRACING
+
+/**
+ * @ingroup core_sntp_enum_types
+ * @brief The events of a time request traced by the client, when the library is
+ * built with `SNTP_ENABLE_TRACING` defined.
+ */
+    typedef enum SntpTraceEventType
+    {
+        /**
+         * @brief The time request, with any client authentication data, is
+         * written to the network buffer.
+         */
+        SntpTraceRequestSerialized,
+
+        /**
+         * @brief The time request is sent with the UDP transport interface.
+         */
+        SntpTraceRequestSent,
+
+        /**
+         * @brief The time request is not sent. The status of the event is the
+         * reason of the failure.
+         */
+        SntpTraceRequestFailed,
+
+        /**
+         * @brief A response is read with the UDP transport interface.
+         */
+        SntpTraceResponseReceived,
+
+        /**
+         * @brief The response is authenticated and parsed.
+         */
+        SntpTraceResponseValidated,
+
+        /**
+         * @brief The response is not used. The status of the event is the
+         * reason, and the Kiss-o'-Death code of the event is set for the
+         * #SntpRejectedResponseChangeServer, #SntpRejectedResponseRetryWithBackoff
+         * and #SntpRejectedResponseOtherCode statuses.
+         */
+        SntpTraceResponseRejected,
+
+        /**
+         * @brief No response is received within the timeout, or reading a
+         * response fails. The status of the event is the reason.
+         */
+        SntpTraceResponseFailed,
+
+        /**
+         * @brief The system time is corrected with the response.
+         */
+        SntpTraceClockUpdated
+    } SntpTraceEventType_t;
+
+/**
+ * @ingroup core_sntp_struct_types
+ * @brief An event traced by the client.
+ */
+    typedef struct SntpTraceEvent
+    {
+        SntpTraceEventType_t type;       /**< @brief The type of the event. */
+        SntpTimestamp_t time;            /**< @brief The system time of the event, or
+                                          * zero if the system time cannot be read. */
+        const SntpServerInfo_t * pServer; /**< @brief The server of the request. */
+        SntpStatus_t status;             /**< @brief The status of the event. */
+        size_t packetSize;               /**< @brief The size of the request or response. */
+        uint32_t rejectedResponseCode;   /**< @brief The Kiss-o'-Death code of a rejected
+                                          * response, or #SNTP_KISS_OF_DEATH_CODE_NONE. */
+    } SntpTraceEvent_t;
+
+/**
+ * @ingroup core_sntp_callback_types
+ * @brief Interface for a user-defined function that receives the events traced
+ * by the client, for example, to measure the latency of the UDP transport and
+ * authentication interfaces.
+ *
+ * @note The function is called from the coreSNTP API functions, and should
+ * return quickly.
+ *
+ * @param[in] pTraceContext The context set with @ref Sntp_SetTraceCallback.
+ * @param[in] pEvent The event, valid for the duration of the call.
+ */
+    typedef void ( * SntpTraceCallback_t )( void * pTraceContext,
+                                            const SntpTraceEvent_t * pEvent );
+
+#endif /* ifdef SNTP_ENABLE_TRACING */
+
 /**
  * @ingroup core_sntp_struct_types
  * @brief Structure for a context that stores state for managing a long-running
@@ -416,6 +545,135 @@ typedef struct SntpContext
      * from the server.
      */
     size_t sntpPacketSize;
+
+    /**
+     * @brief The virtual clock that is updated with the clock offset of every
+     * accepted server response, if set with @ref Sntp_SetVirtualClock.
+     */
+    SntpVirtualClock_t * pVirtualClock;
+
+    /**
+     * @brief The outlier gate that checks the clock offset of every accepted
+     * server response before it is used to correct time, if set with
+     * @ref Sntp_SetOutlierGate.
+     */
+    SntpOutlierGate_t * pOutlierGate;
+
+    /**
+     * @brief The estimator of the clock stability that is updated with the clock
+     * offset of every accepted server response, if set with
+     * @ref Sntp_SetStabilityEstimator.
+     */
+    SntpStabilityEstimator_t * pStabilityEstimator;
+
+    /**
+     * @brief The histograms of each configured server, in the order of
+     * #SntpContext_t.pTimeServers, if set with @ref Sntp_SetServerHistograms.
+     */
+    SntpServerHistograms_t * pServerHistograms;
+
+    /**
+     * @brief The statistics of the context and of each configured server, if
+     * set with @ref Sntp_SetMetrics.
+     */
+    SntpMetrics_t * pMetrics;
+
+    /**
+     * @brief The response timeout estimators of each configured server, in the
+     * order of #SntpContext_t.pTimeServers, if set with
+     * @ref Sntp_SetTimeoutEstimators.
+     */
+    SntpTimeoutEstimator_t * pTimeoutEstimators;
+
+    /**
+     * @brief The health of each configured server, in the order of
+     * #SntpContext_t.pTimeServers, if set with @ref Sntp_SetServerHealth.
+     */
+    SntpServerHealth_t * pServerHealth;
+
+    /**
+     * @brief Whether the healthiest server is to be selected for the next time
+     * request, after the health of the servers is set.
+     */
+    bool isServerSelectionPending;
+
+    /**
+     * @brief The number of consecutive time requests that have failed. When it
+     * reaches the number of configured servers, every server has failed, and the
+     * virtual clock is put in holdover.
+     */
+    size_t consecutiveServerFailures;
+
+    /**
+     * @brief The largest percentage of time requests that can be hedged, set
+     * with @ref Sntp_SetHedging, or zero when hedging is disabled.
+     */
+    uint32_t maxHedgePercent;
+
+    /**
+     * @brief The credit for hedged requests, in hundredths of a request. Every
+     * time request sent adds #SntpContext_t.maxHedgePercent, up to a single
+     * hedged request, and every hedged request spends a whole request.
+     */
+    uint32_t hedgeCredit;
+
+    /**
+     * @brief Whether a hedged request has been attempted for the last time
+     * request, so that it is hedged at most once.
+     */
+    bool isHedgeSent;
+
+    /**
+     * @brief Whether the response of the hedged request is awaited.
+     */
+    bool isHedgePending;
+
+    /**
+     * @brief The index of the server of the hedged request in
+     * #SntpContext_t.pTimeServers.
+     */
+    size_t hedgeServerIndex;
+
+    /**
+     * @brief The random number of the hedged request, taken from the bits of
+     * the random number of the last time request that its serialization does
+     * not use.
+     */
+    uint32_t hedgeRandomNumber;
+
+    /**
+     * @brief The timestamp of sending the hedged request, checked against the
+     * "originate timestamp" of its response like #SntpContext_t.lastRequestTime.
+     */
+    SntpTimestamp_t hedgeRequestTime;
+
+    /**
+     * @brief The size of the hedged request, including any authentication data
+     * for its server.
+     */
+    size_t hedgePacketSize;
+
+    /**
+     * @brief The failure of the last time request while its hedged request is
+     * pending, which is returned if the hedged request also ends without a
+     * valid response; #SntpSuccess while the response of the last time request
+     * is awaited.
+     */
+    SntpStatus_t requestFailureStatus;
+
+    #ifdef SNTP_ENABLE_TRACING
+
+        /**
+         * @brief The function that receives the traced events, if set with
+         * @ref Sntp_SetTraceCallback.
+         */
+        SntpTraceCallback_t traceFunc;
+
+        /**
+         * @brief The context passed to #SntpContext_t.traceFunc.
+         */
+        void * pTraceContext;
+    #endif
 } SntpContext_t;
 
 /**
@@ -470,5 +728,394 @@ SntpStatus_t Sntp_Init( SntpContext_t * pContext,
                         const SntpAuthenticationInterface_t * pAuthIntf );
 /* @[define_sntp_init] */
 
+/**
+ * @brief Sets a virtual clock that is updated with the clock offset of every
+ * server response accepted by the @ref Sntp_ReceiveTimeResponse API, in addition
+ * to the user-defined @ref SntpSetTime_t function.
+ *
+ * The virtual clock is put in holdover when time requests to all configured
+ * servers fail, and it provides corrected time with a growing error bound until
+ * a server response is accepted again.
+ *
+ * @note The local time of the virtual clock is the system time returned by the
+ * user-defined @ref SntpGetTime_t function.
+ *
+ * @param[in, out] pContext The SNTP client context.
+ * @param[in] pVirtualClock The initialized virtual clock, or NULL to stop
+ * updating a previously set virtual clock. The virtual clock MUST stay in scope
+ * for all the time of use of the context.
+ *
+ * @return This function returns one of the following:
+ * - #SntpSuccess if the virtual clock is set.
+ * - #SntpErrorBadParameter if @p pContext is NULL.
+ */
+/* @[define_sntp_setvirtualclock] */
+SntpStatus_t Sntp_SetVirtualClock( SntpContext_t * pContext,
+                                   SntpVirtualClock_t * pVirtualClock );
+/* @[define_sntp_setvirtualclock] */
+
+/**
+ * @brief Sets an outlier gate that checks the clock offset and round-trip delay
+ * of every server response accepted by the @ref Sntp_ReceiveTimeResponse API,
+ * so that samples that deviate too far from recent samples do not correct time.
+ *
+ * The history of the outlier gate is cleared whenever the client moves to the
+ * next server in the list, as the delay to each server is different.
+ *
+ * @param[in, out] pContext The SNTP client context.
+ * @param[in] pOutlierGate The initialized outlier gate, or NULL to accept every
+ * server response. The outlier gate MUST stay in scope for all the time of use
+ * of the context.
+ *
+ * @return This function returns one of the following:
+ * - #SntpSuccess if the outlier gate is set.
+ * - #SntpErrorBadParameter if @p pContext is NULL.
+ */
+/* @[define_sntp_setoutliergate] */
+SntpStatus_t Sntp_SetOutlierGate( SntpContext_t * pContext,
+                                  SntpOutlierGate_t * pOutlierGate );
+/* @[define_sntp_setoutliergate] */
+
+/**
+ * @brief Sets an estimator of the clock stability that is updated with the
+ * clock offset of every server response accepted by the
+ * @ref Sntp_ReceiveTimeResponse API. The poll interval can then be calculated
+ * from the measured stability with @ref Sntp_CalculateAdaptivePollInterval.
+ *
+ * A discontinuity is marked in the estimator whenever the client moves to the
+ * next server in the list.
+ *
+ * @note The clock offsets are measured against the system time returned by the
+ * user-defined @ref SntpGetTime_t function. For meaningful estimates, the
+ * @ref SntpSetTime_t function SHOULD NOT step that time, for example, when the
+ * application reads time from a virtual clock (@ref Sntp_SetVirtualClock).
+ *
+ * @param[in, out] pContext The SNTP client context.
+ * @param[in] pEstimator The initialized estimator, or NULL to stop updating a
+ * previously set estimator. The estimator MUST stay in scope for all the time
+ * of use of the context.
+ *
+ * @return This function returns one of the following:
+ * - #SntpSuccess if the estimator is set.
+ * - #SntpErrorBadParameter if @p pContext is NULL.
+ */
+/* @[define_sntp_setstabilityestimator] */
+SntpStatus_t Sntp_SetStabilityEstimator( SntpContext_t * pContext,
+                                         SntpStabilityEstimator_t * pEstimator );
+/* @[define_sntp_setstabilityestimator] */
+
+/**
+ * @brief Sets the histograms of the configured servers, which record the
+ * round-trip delay, clock offset and response latency of every valid server
+ * response received by the @ref Sntp_ReceiveTimeResponse API. The percentiles
+ * of each server can then be read with @ref Sntp_GetHistogramPercentile, for
+ * example, to select servers or to detect the degradation of a network path.
+ *
+ * Responses rejected by the outlier gate (@ref Sntp_SetOutlierGate) are
+ * recorded, so that the histograms show the tail of the distributions. The
+ * clock offset is not recorded for a response with #SntpClockOffsetOverflow.
+ *
+ * @param[in, out] pContext The SNTP client context.
+ * @param[in] pHistograms The histograms initialized with
+ * @ref Sntp_InitServerHistograms, with one element for each server configured
+ * with @ref Sntp_Init, in the same order, or NULL to stop recording. The
+ * histograms MUST stay in scope for all the time of use of the context.
+ *
+ * @return This function returns one of the following:
+ * - #SntpSuccess if the histograms are set.
+ * - #SntpErrorBadParameter if @p pContext is NULL.
+ */
+/* @[define_sntp_setserverhistograms] */
+SntpStatus_t Sntp_SetServerHistograms( SntpContext_t * pContext,
+                                       SntpServerHistograms_t * pHistograms );
+/* @[define_sntp_setserverhistograms] */
+
+/**
+ * @brief Sets the statistics that count the outcome of every time request sent
+ * by the @ref Sntp_SendTimeRequest API and of every server response received by
+ * the @ref Sntp_ReceiveTimeResponse API. The statistics can be rendered for
+ * scraping with @ref Sntp_RenderMetrics.
+ *
+ * The server names of the per-server statistics are set from the servers
+ * configured with @ref Sntp_Init.
+ *
+ * @param[in, out] pContext The SNTP client context.
+ * @param[in] pMetrics The statistics initialized with @ref Sntp_InitMetrics,
+ * with either no per-server statistics or one element for each configured
+ * server, or NULL to stop counting. The statistics MUST stay in scope for all
+ * the time of use of the context.
+ *
+ * @return This function returns one of the following:
+ * - #SntpSuccess if the statistics are set.
+ * - #SntpErrorBadParameter if @p pContext is NULL, or the number of per-server
+ * statistics differs from the number of configured servers.
+ */
+/* @[define_sntp_setmetrics] */
+SntpStatus_t Sntp_SetMetrics( SntpContext_t * pContext,
+                              SntpMetrics_t * pMetrics );
+/* @[define_sntp_setmetrics] */
+
+/**
+ * @brief Sets the response timeout estimators of the configured servers, so
+ * that the response timeout of each server adapts to its measured response
+ * latency instead of the timeout passed to the @ref Sntp_ReceiveTimeResponse
+ * API.
+ *
+ * Every valid server response updates the estimator of its server. A server
+ * whose response does not arrive within its estimated timeout is considered
+ * unresponsive, so that the next server is configured for subsequent requests,
+ * and its estimated timeout is doubled until its next response. The timeout
+ * passed to @ref Sntp_ReceiveTimeResponse is used for a server without any
+ * measured response latency.
+ *
+ * @param[in, out] pContext The SNTP client context.
+ * @param[in] pEstimators The estimators initialized with
+ * @ref Sntp_InitTimeoutEstimators, with one element for each server configured
+ * with @ref Sntp_Init, in the same order, or NULL to use the passed timeout for
+ * every server. The estimators MUST stay in scope for all the time of use of
+ * the context.
+ *
+ * @return This function returns one of the following:
+ * - #SntpSuccess if the estimators are set.
+ * - #SntpErrorBadParameter if @p pContext is NULL.
+ */
+/* @[define_sntp_settimeoutestimators] */
+SntpStatus_t Sntp_SetTimeoutEstimators( SntpContext_t * pContext,
+                                        SntpTimeoutEstimator_t * pEstimators );
+/* @[define_sntp_settimeoutestimators] */
+
+/**
+ * @brief Sets the health of the configured servers, so that the client uses
+ * the server with the highest health score instead of the order of priority of
+ * the servers.
+ *
+ * Every outcome of a time request is recorded in the health of its server with
+ * @ref Sntp_RecordServerHealth. The next time request is sent to the healthiest
+ * server, and when the current server fails, the healthiest of the other
+ * servers is configured for subsequent requests instead of the next one in the
+ * list. Servers of equal health, such as servers without any recorded outcome,
+ * are used in their order in the list.
+ *
+ * Every later time request also switches to the healthiest server if its score
+ * exceeds the score of the current server by #SNTP_HEALTH_SWITCH_MARGIN, so
+ * that a server that keeps responding, but slowly or with a large jitter, is
+ * not used indefinitely.
+ *
+ * This function sets the identifier of each server from its name and port, so
+ * that health saved with @ref Sntp_SaveServerHealth can then be restored with
+ * @ref Sntp_RestoreServerHealth, even if the list of servers has changed.
+ *
+ * @param[in, out] pContext The SNTP client context.
+ * @param[in] pHealth The health records initialized with
+ * @ref Sntp_InitServerHealth, with one element for each server configured with
+ * @ref Sntp_Init, in the same order, or NULL to use the servers in their order
+ * of priority. The records MUST stay in scope for all the time of use of the
+ * context.
+ *
+ * @return This function returns one of the following:
+ * - #SntpSuccess if the health records are set.
+ * - #SntpErrorBadParameter if @p pContext is NULL.
+ */
+/* @[define_sntp_setserverhealth] */
+SntpStatus_t Sntp_SetServerHealth( SntpContext_t * pContext,
+                                   SntpServerHealth_t * pHealth );
+/* @[define_sntp_setserverhealth] */
+
+/**
+ * @brief Enables hedging of time requests, so that the tail latency of the
+ * current server does not delay time synchronization.
+ *
+ * When the response to a time request has not arrived within the
+ * #SNTP_HEDGE_LATENCY_PERCENTILE percentile of the response latency of the
+ * current server, the @ref Sntp_ReceiveTimeResponse API sends a second, hedged,
+ * request to the next server in the list (or the healthiest other server, see
+ * @ref Sntp_SetServerHealth), and accepts whichever valid response arrives
+ * first. The current server is not changed by a hedged response, and an
+ * invalid or rejected hedged response is ignored. Any other outcome of the
+ * time request, such as an invalid response or a timeout, is only returned
+ * once the hedged request has also ended without a valid response, at the
+ * latest at the response timeout of its server.
+ *
+ * Responses are attributed to the time request or to its hedged request by
+ * their "originate timestamp", not by the server they are read for, so the
+ * transport interface may receive the responses of all servers through a
+ * single socket.
+ *
+ * The response latency is read from the histograms set with
+ * @ref Sntp_SetServerHistograms, and requests are only hedged once at least
+ * #SNTP_HEDGE_MIN_SAMPLES latencies of the current server are recorded.
+ * Requests are hedged at most once each, and in the long run the hedged
+ * requests are at most @p maxHedgePercent percent of the time requests.
+ *
+ * The hedged request is only sent by @ref Sntp_ReceiveTimeResponse, so the
+ * application has to call it at least as often as the hedging latency of the
+ * server, or wait for the time returned by @ref Sntp_GetResponseWaitTime
+ * between calls, as event loops do. An application that only calls it when a
+ * response is readable never hedges its requests.
+ *
+ * @note Hedged responses do not update the outlier gate or the stability
+ * estimator, as they measure the network path to a different server.
+ *
+ * @param[in, out] pContext The SNTP client context.
+ * @param[in] maxHedgePercent The largest percentage of time requests that can
+ * be hedged, up to #SNTP_MAX_HEDGE_PERCENT, or zero to disable hedging.
+ *
+ * @return This function returns one of the following:
+ * - #SntpSuccess if hedging is configured.
+ * - #SntpErrorBadParameter if @p pContext is NULL or @p maxHedgePercent is
+ * greater than #SNTP_MAX_HEDGE_PERCENT.
+ */
+/* @[define_sntp_sethedging] */
+SntpStatus_t Sntp_SetHedging( SntpContext_t * pContext,
+                              uint32_t maxHedgePercent );
+/* @[define_sntp_sethedging] */
+
+#ifdef SNTP_ENABLE_TRACING
+
+/**
+ * @brief Sets the function that receives the events of time requests and
+ * server responses, as they are traced by the @ref Sntp_SendTimeRequest and
+ * @ref Sntp_ReceiveTimeResponse APIs. Each event is timestamped with the
+ * system time of the context.
+ *
+ * @note This API, and the tracing in the client, only exist when the library
+ * is built with `SNTP_ENABLE_TRACING` defined. Otherwise, tracing compiles to
+ * nothing.
+ *
+ * @param[in, out] pContext The SNTP client context.
+ * @param[in] traceFunc The function that receives the events, or NULL to stop
+ * tracing.
+ * @param[in] pTraceContext The context passed to @p traceFunc.
+ *
+ * @return This function returns one of the following:
+ * - #SntpSuccess if the function is set.
+ * - #SntpErrorBadParameter if @p pContext is NULL.
+ */
+/* @[define_sntp_settracecallback] */
+    SntpStatus_t Sntp_SetTraceCallback( SntpContext_t * pContext,
+                                        SntpTraceCallback_t traceFunc,
+                                        void * pTraceContext );
+/* @[define_sntp_settracecallback] */
+#endif /* ifdef SNTP_ENABLE_TRACING */
+
+/**
+ * @brief Sends a time request to the currently configured time server.
+ *
+ * The function resolves the DNS name of the server, serializes an SNTP request
+ * with the current system time, appends client authentication data if an
+ * authentication interface is configured, and sends the request over the UDP
+ * transport interface.
+ *
+ * If the server cannot be used (due to DNS or network failure), the next server
+ * in the list, or the healthiest other server if server health is set with
+ * @ref Sntp_SetServerHealth, is configured for subsequent requests. With server
+ * health, the request is sent to a healthier server than the current one, see
+ * @ref Sntp_SetServerHealth.
+ *
+ * @param[in, out] pContext The SNTP client context.
+ * @param[in] randomNumber A random number for the SNTP request for protection
+ * against replay attacks. Refer to @ref Sntp_SerializeRequest for more
+ * information.
+ *
+ * @return This function returns one of the following:
+ * - #SntpSuccess if the time request is sent.
+ * - #SntpErrorBadParameter if @p pContext is NULL.
+ * - #SntpErrorDnsFailure if the DNS name of the server cannot be resolved.
+ * - #SntpErrorSystemClockFailure if the system time cannot be obtained.
+ * - #SntpErrorBufferTooSmall if the network buffer is too small for the
+ * authentication data.
+ * - #SntpErrorAuthFailure if the client authentication data cannot be generated.
+ * - #SntpErrorNetworkFailure if the request cannot be sent.
+ */
+/* @[define_sntp_sendtimerequest] */
+SntpStatus_t Sntp_SendTimeRequest( SntpContext_t * pContext,
+                                   uint32_t randomNumber );
+/* @[define_sntp_sendtimerequest] */
+
+/**
+ * @brief Receives the server response to the last time request sent with the
+ * @ref Sntp_SendTimeRequest API, and corrects system time with it.
+ *
+ * This function does not block: it attempts to read the response once, and
+ * returns #SntpNoResponseReceived if no response is available yet. The
+ * application SHOULD call this function repeatedly until a status other than
+ * #SntpNoResponseReceived is returned.
+ *
+ * For an accepted response, the user-defined @ref SntpSetTime_t function is
+ * called, and the virtual clock set with @ref Sntp_SetVirtualClock is updated.
+ * If the server rejects the request with a code that prohibits further requests,
+ * or does not respond within @p responseTimeoutMs, the next server in the list
+ * (or the healthiest other server, see @ref Sntp_SetServerHealth) is configured
+ * for subsequent requests. When requests to all servers have failed
+ * consecutively, the virtual clock is put in holdover.
+ *
+ * If hedging is enabled with @ref Sntp_SetHedging, this function also sends
+ * the hedged request to the next server when the response is late, and
+ * accepts its response if it arrives first. The request is only hedged if this
+ * function is called when it is due, see @ref Sntp_GetResponseWaitTime.
+ *
+ * @param[in, out] pContext The SNTP client context.
+ * @param[in] responseTimeoutMs The time, in milliseconds, since sending the
+ * time request after which the server is considered unresponsive. If response
+ * timeout estimators are set with @ref Sntp_SetTimeoutEstimators, the estimated
+ * timeout of the server is used instead, once it has been measured.
+ *
+ * @return This function returns one of the following:
+ * - #SntpSuccess if an accepted response is received and system time is
+ * corrected.
+ * - #SntpClockOffsetOverflow if an accepted response is received, but the
+ * clock offset cannot be calculated. The @ref SntpSetTime_t function is called
+ * with #SNTP_CLOCK_OFFSET_OVERFLOW as the clock offset.
+ * - #SntpErrorBadParameter if @p pContext is NULL.
+ * - #SntpNoResponseReceived if no response has been received yet.
+ * - #SntpErrorResponseTimeout if no response has been received within
+ * the response timeout.
+ * - #SntpErrorNetworkFailure if the response cannot be read.
+ * - #SntpErrorSystemClockFailure if the system time cannot be obtained or
+ * corrected.
+ * - #SntpServerNotAuthenticated or #SntpErrorAuthFailure if the server cannot
+ * be authenticated.
+ * - #SntpRejectedResponseOutlier if the response is rejected by the outlier gate
+ * set with @ref Sntp_SetOutlierGate. Neither system time nor the virtual clock
+ * is corrected.
+ * - Any of the failure codes of the @ref Sntp_DeserializeResponse API for
+ * invalid or rejected responses.
+ */
+/* @[define_sntp_receivetimeresponse] */
+SntpStatus_t Sntp_ReceiveTimeResponse( SntpContext_t * pContext,
+                                       uint32_t responseTimeoutMs );
+/* @[define_sntp_receivetimeresponse] */
+
+/**
+ * @brief Calculates how long the application can wait for the response to the
+ * last time request, for example in an event loop, before calling the
+ * @ref Sntp_ReceiveTimeResponse API again.
+ *
+ * The wait time ends at the response timeout of the current server, which is
+ * shorter than @p responseTimeoutMs once the timeout estimator of the server
+ * set with @ref Sntp_SetTimeoutEstimators has measured its latency, or earlier
+ * when the request is due to be hedged, see @ref Sntp_SetHedging. After the
+ * time request has failed, the wait ends at the response timeout of its pending
+ * hedged request instead. An event
+ * loop that waits for the full @p responseTimeoutMs instead delays the
+ * failover to the next server, and never hedges its requests.
+ *
+ * @param[in] pContext The SNTP client context.
+ * @param[in] responseTimeoutMs The response timeout passed to the
+ * @ref Sntp_ReceiveTimeResponse API.
+ * @param[out] pWaitTimeMs The time, in milliseconds, until
+ * @ref Sntp_ReceiveTimeResponse has to be called again, or zero if it has to
+ * be called now.
+ *
+ * @return This function returns one of the following:
+ * - #SntpSuccess if the wait time is calculated.
+ * - #SntpErrorBadParameter if @p pContext or @p pWaitTimeMs is NULL.
+ * - #SntpErrorSystemClockFailure if the system time cannot be obtained.
+ */
+/* @[define_sntp_getresponsewaittime] */
+SntpStatus_t Sntp_GetResponseWaitTime( const SntpContext_t * pContext,
+                                       uint32_t responseTimeoutMs,
+                                       uint32_t * pWaitTimeMs );
+/* @[define_sntp_getresponsewaittime] */
 
 #endif /* ifndef CORE_SNTP_CLIENT_H_ */
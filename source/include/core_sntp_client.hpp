@@ -0,0 +1,481 @@
+/*
+ * coreSNTP v1.0.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file core_sntp_client.hpp
+ * @brief Header-only C++17 interface of the coreSNTP library, which wraps the
+ * C API with an RAII client, std::chrono durations and time points, and a
+ * compile-time template of request packets.
+ *
+ * The wrapper does not allocate memory, and its functions are inline calls of
+ * the C API.
+ */
+
+#ifndef CORE_SNTP_CLIENT_HPP_
+#define CORE_SNTP_CLIENT_HPP_
+
+/* Standard includes. */
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <ratio>
+
+/* coreSNTP C API. */
+extern "C" {
+#include "core_sntp_client.h"
+}
+
+namespace sntp
+{
+    /**
+     * @brief Duration in SNTP timestamp fractions (2^-32 seconds), the
+     * resolution of clock offsets and round-trip delays.
+     */
+    using Fractions = std::chrono::duration<std::int64_t, std::ratio<1, 0x100000000> >;
+
+    /**
+     * @brief UNIX time, with nanoseconds resolution.
+     */
+    using SystemTime = std::chrono::time_point<std::chrono::system_clock, std::chrono::nanoseconds>;
+
+    /**
+     * @brief The default pivot time for resolving the SNTP era of timestamps.
+     */
+    constexpr std::chrono::seconds defaultEraPivot { SNTP_DEFAULT_ERA_PIVOT_UNIX_SECS };
+
+    /**
+     * @brief The clock offset of a parsed server response.
+     *
+     * @param[in] response The parsed response.
+     *
+     * @return The offset of the server time from the system time.
+     */
+    inline Fractions clockOffset( const SntpResponseData_t & response ) noexcept
+    {
+        return Fractions { response.clockOffsetFractions };
+    }
+
+    /**
+     * @brief The round-trip delay of a parsed server response.
+     *
+     * @param[in] response The parsed response.
+     *
+     * @return The round-trip delay, excluding the processing time of the server.
+     */
+    inline Fractions roundTripDelay( const SntpResponseData_t & response ) noexcept
+    {
+        return Fractions { response.roundTripDelayFractions };
+    }
+
+    /**
+     * @brief Converts an SNTP timestamp to UNIX time, with
+     * @ref Sntp_ConvertToUnixTime64.
+     *
+     * @param[in] timestamp The SNTP timestamp.
+     * @param[out] time The UNIX time of the timestamp.
+     * @param[in] eraPivot The pivot time that resolves the SNTP era.
+     *
+     * @return The status of @ref Sntp_ConvertToUnixTime64.
+     */
+    inline SntpStatus_t toSystemTime( const SntpTimestamp_t & timestamp,
+                                      SystemTime & time,
+                                      std::chrono::seconds eraPivot = defaultEraPivot ) noexcept
+    {
+        std::int64_t seconds = 0;
+        std::uint32_t nanoseconds = 0U;
+        SntpStatus_t status = Sntp_ConvertToUnixTime64( &timestamp, eraPivot.count(), &seconds, &nanoseconds );
+
+        if( status == SntpSuccess )
+        {
+            time = SystemTime { std::chrono::seconds { seconds } + std::chrono::nanoseconds { nanoseconds } };
+        }
+
+        return status;
+    }
+
+    /**
+     * @brief Converts UNIX time to an SNTP timestamp, with
+     * @ref Sntp_ConvertFromUnixTime64.
+     *
+     * @param[in] time The UNIX time.
+     * @param[out] timestamp The SNTP timestamp of the time.
+     *
+     * @return The status of @ref Sntp_ConvertFromUnixTime64.
+     */
+    inline SntpStatus_t fromSystemTime( SystemTime time,
+                                        SntpTimestamp_t & timestamp ) noexcept
+    {
+        const auto seconds = std::chrono::floor<std::chrono::seconds>( time );
+
+        return Sntp_ConvertFromUnixTime64( seconds.time_since_epoch().count(),
+                                           static_cast<std::uint32_t>( ( time - seconds ).count() ),
+                                           &timestamp );
+    }
+
+    /**
+     * @brief Calculates the poll interval that keeps the system clock within an
+     * accuracy, with @ref Sntp_CalculatePollInterval.
+     *
+     * @param[in] clockFreqTolerancePpm The frequency tolerance of the system
+     * clock, in parts per million.
+     * @param[in] desiredAccuracy The maximum drift of the system clock, up to
+     * 65535 milliseconds.
+     * @param[out] interval The poll interval.
+     *
+     * @return The status of @ref Sntp_CalculatePollInterval, or
+     * #SntpErrorBadParameter if @p desiredAccuracy is out of range.
+     */
+    inline SntpStatus_t pollInterval( std::uint16_t clockFreqTolerancePpm,
+                                      std::chrono::milliseconds desiredAccuracy,
+                                      std::chrono::seconds & interval ) noexcept
+    {
+        std::uint32_t seconds = 0U;
+        SntpStatus_t status = SntpErrorBadParameter;
+
+        if( ( desiredAccuracy.count() >= 0 ) &&
+            ( desiredAccuracy.count() <= std::numeric_limits<std::uint16_t>::max() ) )
+        {
+            status = Sntp_CalculatePollInterval( clockFreqTolerancePpm,
+                                                 static_cast<std::uint16_t>( desiredAccuracy.count() ),
+                                                 &seconds );
+        }
+
+        if( status == SntpSuccess )
+        {
+            interval = std::chrono::seconds { seconds };
+        }
+
+        return status;
+    }
+
+    /**
+     * @brief Template of SNTP request packets, built at compile time.
+     *
+     * The default template has the same header bytes as the requests of
+     * @ref Sntp_SerializeRequest, so that serializing a request with the
+     * template only copies the constant bytes and writes the transmit
+     * timestamp.
+     */
+    class RequestTemplate
+    {
+        public:
+
+            /**
+             * @brief The size of a request packet.
+             */
+            static constexpr std::size_t size = SNTP_PACKET_BASE_SIZE;
+
+            /**
+             * @brief The template of a version 4 client mode request.
+             */
+            constexpr RequestTemplate() noexcept : bytes_ {}
+            {
+                bytes_[ 0 ] = headerByte( 4U );
+            }
+
+            /**
+             * @brief A copy of the template with another version number.
+             *
+             * @param[in] versionNumber The version number, from 1 to 7.
+             */
+            constexpr RequestTemplate version( std::uint8_t versionNumber ) const noexcept
+            {
+                RequestTemplate copy = *this;
+
+                copy.bytes_[ 0 ] = headerByte( versionNumber );
+
+                return copy;
+            }
+
+            /**
+             * @brief A copy of the template with the poll interval of the
+             * client.
+             *
+             * @param[in] exponent The base-2 logarithm of the poll interval,
+             * in seconds.
+             */
+            constexpr RequestTemplate poll( std::int8_t exponent ) const noexcept
+            {
+                RequestTemplate copy = *this;
+
+                copy.bytes_[ pollOffset ] = static_cast<std::uint8_t>( exponent );
+
+                return copy;
+            }
+
+            /**
+             * @brief The bytes of the template.
+             */
+            constexpr const std::array<std::uint8_t, size> & bytes() const noexcept
+            {
+                return bytes_;
+            }
+
+            /**
+             * @brief Serializes a request from the template, as
+             * @ref Sntp_SerializeRequest does with the default template.
+             *
+             * @param[in, out] requestTime The system time of the request,
+             * updated with the random bits added to the fractions.
+             * @param[in] randomNumber The random number of the request.
+             * @param[out] pBuffer The buffer of the request.
+             * @param[in] bufferSize The size of @p pBuffer.
+             *
+             * @return #SntpSuccess, #SntpErrorBadParameter if @p pBuffer is
+             * NULL, or #SntpErrorBufferTooSmall.
+             */
+            SntpStatus_t serialize( SntpTimestamp_t & requestTime,
+                                    std::uint32_t randomNumber,
+                                    void * pBuffer,
+                                    std::size_t bufferSize ) const noexcept
+            {
+                SntpStatus_t status = SntpSuccess;
+
+                if( pBuffer == nullptr )
+                {
+                    status = SntpErrorBadParameter;
+                }
+                else if( bufferSize < size )
+                {
+                    status = SntpErrorBufferTooSmall;
+                }
+                else
+                {
+                    auto * pBytes = static_cast<std::uint8_t *>( pBuffer );
+
+                    requestTime.fractions |= randomNumber >> 16;
+
+                    ( void ) std::memcpy( pBytes, bytes_.data(), transmitOffset );
+                    writeWord( &pBytes[ transmitOffset ], requestTime.seconds );
+                    writeWord( &pBytes[ transmitOffset + 4U ], requestTime.fractions );
+                }
+
+                return status;
+            }
+
+        private:
+
+            /**
+             * @brief The offset of the poll field of the packet.
+             */
+            static constexpr std::size_t pollOffset = 2U;
+
+            /**
+             * @brief The offset of the transmit timestamp of the packet.
+             */
+            static constexpr std::size_t transmitOffset = 40U;
+
+            /**
+             * @brief The first byte of a client mode request, with no leap
+             * second warning.
+             */
+            static constexpr std::uint8_t headerByte( std::uint8_t versionNumber ) noexcept
+            {
+                return static_cast<std::uint8_t>( ( ( versionNumber & 0x07U ) << 3 ) | 3U );
+            }
+
+            /**
+             * @brief Writes a 32-bit word in network byte order.
+             */
+            static void writeWord( std::uint8_t * pBytes,
+                                   std::uint32_t word ) noexcept
+            {
+                pBytes[ 0 ] = static_cast<std::uint8_t>( word >> 24 );
+                pBytes[ 1 ] = static_cast<std::uint8_t>( word >> 16 );
+                pBytes[ 2 ] = static_cast<std::uint8_t>( word >> 8 );
+                pBytes[ 3 ] = static_cast<std::uint8_t>( word );
+            }
+
+            std::array<std::uint8_t, size> bytes_; /**< @brief The packet bytes. */
+    };
+
+    /**
+     * @brief The template of the requests of the coreSNTP library.
+     */
+    inline constexpr RequestTemplate defaultRequest {};
+
+    /**
+     * @brief An SNTP client context, with its network buffer, initialized with
+     * @ref Sntp_Init on construction.
+     *
+     * The client cannot be copied or moved, as the context refers to its
+     * buffer. The servers and the interfaces MUST outlive the client.
+     *
+     * @tparam BufferSize The size of the network buffer, with room for the
+     * authentication data of the requests, if any.
+     */
+    template<std::size_t BufferSize = SNTP_PACKET_BASE_SIZE>
+    class Client
+    {
+        static_assert( BufferSize >= SNTP_PACKET_BASE_SIZE, "The buffer must hold an SNTP packet." );
+
+        public:
+
+            /**
+             * @brief Initializes the client with @ref Sntp_Init. The status
+             * is available from @ref status.
+             */
+            Client( const SntpServerInfo_t * pTimeServers,
+                    std::size_t numOfServers,
+                    SntpResolveDns_t resolveDnsFunc,
+                    SntpGetTime_t getSystemTimeFunc,
+                    SntpSetTime_t setSystemTimeFunc,
+                    const UdpTransportInterface_t & transportIntf,
+                    const SntpAuthenticationInterface_t * pAuthIntf = nullptr ) noexcept
+                : context_ {}, buffer_ {},
+                status_ { Sntp_Init( &context_, pTimeServers, numOfServers, buffer_.data(), buffer_.size(),
+                                     resolveDnsFunc, getSystemTimeFunc, setSystemTimeFunc,
+                                     &transportIntf, pAuthIntf ) }
+            {
+            }
+
+            /**
+             * @brief Initializes the client with an array of servers.
+             */
+            template<std::size_t NumOfServers>
+            Client( const SntpServerInfo_t ( &timeServers )[ NumOfServers ],
+                    SntpResolveDns_t resolveDnsFunc,
+                    SntpGetTime_t getSystemTimeFunc,
+                    SntpSetTime_t setSystemTimeFunc,
+                    const UdpTransportInterface_t & transportIntf,
+                    const SntpAuthenticationInterface_t * pAuthIntf = nullptr ) noexcept
+                : Client( timeServers, NumOfServers, resolveDnsFunc, getSystemTimeFunc, setSystemTimeFunc,
+                          transportIntf, pAuthIntf )
+            {
+            }
+
+            Client( const Client & ) = delete;
+            Client & operator=( const Client & ) = delete;
+
+            /**
+             * @brief The status of the initialization of the client.
+             */
+            SntpStatus_t status() const noexcept
+            {
+                return status_;
+            }
+
+            /**
+             * @brief Whether the client is initialized.
+             */
+            explicit operator bool() const noexcept
+            {
+                return status_ == SntpSuccess;
+            }
+
+            /**
+             * @brief Sends a time request, with @ref Sntp_SendTimeRequest.
+             */
+            SntpStatus_t sendTimeRequest( std::uint32_t randomNumber ) noexcept
+            {
+                return Sntp_SendTimeRequest( &context_, randomNumber );
+            }
+
+            /**
+             * @brief Receives a server response, with
+             * @ref Sntp_ReceiveTimeResponse.
+             *
+             * @param[in] timeout The timeout of the response since the request,
+             * truncated to milliseconds.
+             */
+            template<typename Rep, typename Period>
+            SntpStatus_t receiveTimeResponse( std::chrono::duration<Rep, Period> timeout ) noexcept
+            {
+                return Sntp_ReceiveTimeResponse( &context_, toMilliseconds( timeout ) );
+            }
+
+            /**
+             * @brief The time to wait for the response before calling
+             * @ref receiveTimeResponse again, with
+             * @ref Sntp_GetResponseWaitTime.
+             *
+             * @param[in] timeout The timeout of the response since the request,
+             * as passed to @ref receiveTimeResponse.
+             *
+             * @return The wait time, which is zero if the system time cannot be
+             * obtained, so that @ref receiveTimeResponse reports the failure.
+             */
+            template<typename Rep, typename Period>
+            std::chrono::milliseconds responseWaitTime( std::chrono::duration<Rep, Period> timeout ) const noexcept
+            {
+                std::uint32_t waitTimeMs = 0U;
+
+                if( Sntp_GetResponseWaitTime( &context_, toMilliseconds( timeout ), &waitTimeMs ) != SntpSuccess )
+                {
+                    waitTimeMs = 0U;
+                }
+
+                return std::chrono::milliseconds { waitTimeMs };
+            }
+
+            /**
+             * @brief The context, for the other functions of the C API, such
+             * as @ref Sntp_SetVirtualClock.
+             */
+            SntpContext_t & context() noexcept
+            {
+                return context_;
+            }
+
+            /**
+             * @brief The context, for the other functions of the C API.
+             */
+            const SntpContext_t & context() const noexcept
+            {
+                return context_;
+            }
+
+        private:
+
+            /**
+             * @brief Converts a timeout to milliseconds for the C API,
+             * truncated and limited to the range of `std::uint32_t`.
+             */
+            template<typename Rep, typename Period>
+            static std::uint32_t toMilliseconds( std::chrono::duration<Rep, Period> timeout ) noexcept
+            {
+                const auto milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>( timeout ).count();
+                std::uint32_t timeoutMs = 0U;
+
+                if( milliseconds > static_cast<decltype( milliseconds )>( std::numeric_limits<std::uint32_t>::max() ) )
+                {
+                    timeoutMs = std::numeric_limits<std::uint32_t>::max();
+                }
+                else if( milliseconds > 0 )
+                {
+                    timeoutMs = static_cast<std::uint32_t>( milliseconds );
+                }
+
+                return timeoutMs;
+            }
+
+            SntpContext_t context_;                          /**< @brief The C context. */
+            std::array<std::uint8_t, BufferSize> buffer_; /**< @brief The network buffer. */
+            SntpStatus_t status_;                            /**< @brief The status of
+                                                              * @ref Sntp_Init. */
+    };
+}
+
+#endif /* ifndef CORE_SNTP_CLIENT_HPP_ */
@@ -0,0 +1,527 @@
+/*
+ * coreSNTP v1.0.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file core_sntp_clock.h
+ * @brief API of a software "virtual clock" that provides time corrected with the
+ * clock offset and frequency error estimated from SNTP responses, without
+ * changing the system clock.
+ *
+ * The virtual clock is useful on systems where the application cannot (or should
+ * not) adjust the system clock, for example, in containers without privileges to
+ * change time. The application feeds clock offset samples calculated from server
+ * responses (with @ref Sntp_UpdateVirtualClock), and reads corrected time with
+ * @ref Sntp_GetCorrectedTime as many times as needed. Reading corrected time does
+ * not perform any network operation, and only uses the local time passed by the
+ * caller.
+ */
+
+#ifndef CORE_SNTP_CLOCK_H_
+#define CORE_SNTP_CLOCK_H_
+
+/* Standard include. */
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Include coreSNTP Serializer header. */
+#include "core_sntp_serializer.h"
+
+/**
+ * @brief The maximum frequency error, in parts per million (PPM), of the local
+ * clock that the virtual clock corrects for.
+ *
+ * @note This is the same frequency tolerance limit that is used by NTPv4. For
+ * more information, refer to [RFC 5905 Section 11.3](https://tools.ietf.org/html/rfc5905#section-11.3).
+ */
+#define SNTP_CLOCK_MAX_FREQUENCY_PPM    ( 500 )
+
+/**
+ * @brief The leap smear window, in seconds, used by public smearing time
+ * services (24 hours, centered on the leap second).
+ */
+#define SNTP_LEAP_SMEAR_DEFAULT_WINDOW_SECS    ( 86400U )
+
+/**
+ * @brief The frequency uncertainty, in PPM, assumed for the local clock before
+ * it has been measured from clock offset samples.
+ *
+ * @note This is the frequency tolerance (PHI) that NTPv4 assumes for the clock
+ * dispersion. For more information, refer to
+ * [RFC 5905 Section 7.2](https://tools.ietf.org/html/rfc5905#section-7.2).
+ */
+#define SNTP_CLOCK_INITIAL_FREQUENCY_UNCERTAINTY_PPM    ( 15 )
+
+/**
+ * @ingroup core_sntp_enum_types
+ * @brief Enumeration of the synchronization states of a virtual clock.
+ */
+typedef enum SntpClockState
+{
+    /**
+     * @brief The virtual clock has not received a clock offset sample.
+     */
+    SntpClockStateUnsynchronized = 0,
+
+    /**
+     * @brief The virtual clock is synchronized with clock offset samples from
+     * time servers.
+     */
+    SntpClockStateSynchronized,
+
+    /**
+     * @brief No time server is reachable, and the virtual clock predicts time
+     * from its last clock offset and frequency estimate.
+     */
+    SntpClockStateHoldover
+} SntpClockState_t;
+
+/**
+ * @ingroup core_sntp_enum_types
+ * @brief Enumeration of the methods for applying a leap second to time.
+ */
+typedef enum SntpLeapSmearType
+{
+    /**
+     * @brief The leap second is applied as a step of time at the leap second
+     * instant.
+     */
+    SntpLeapSmearNone = 0,
+
+    /**
+     * @brief The leap second is spread over the smear window with a constant
+     * rate change of time.
+     */
+    SntpLeapSmearLinear,
+
+    /**
+     * @brief The leap second is spread over the smear window with a half-cosine
+     * profile, so that the rate of time changes gradually at the start and the
+     * end of the window.
+     */
+    SntpLeapSmearCosine
+} SntpLeapSmearType_t;
+
+/**
+ * @ingroup core_sntp_struct_types
+ * @brief Structure representing a leap second and the method for applying it
+ * to time.
+ *
+ * The times handled with this structure are on a continuous timescale, i.e. UTC
+ * time that is not stepped by the leap second, such as the time of a clock that
+ * is disciplined to UTC before the leap second and free-runs across it.
+ */
+typedef struct SntpLeapSmear
+{
+    /**
+     * @brief The method of applying the leap second.
+     */
+    SntpLeapSmearType_t type;
+
+    /**
+     * @brief The duration, in seconds, of the window centered on the leap second
+     * instant over which the leap second is spread. Not used when
+     * @ref type is #SntpLeapSmearNone.
+     */
+    uint32_t windowSecs;
+
+    /**
+     * @brief The leap second instant on the continuous timescale, i.e. the time
+     * at which UTC is stepped by the leap second.
+     */
+    SntpTimestamp_t leapTime;
+
+    /**
+     * @brief The leap second adjustment, which is 1 for an inserted leap second,
+     * -1 for a deleted leap second, and 0 if there is no leap second.
+     */
+    int32_t leapSeconds;
+} SntpLeapSmear_t;
+
+/**
+ * @ingroup core_sntp_struct_types
+ * @brief Structure representing the model of the local clock error that the
+ * virtual clock uses to calculate corrected time.
+ *
+ * The corrected time at a local time, t, is calculated as:
+ *
+ *   Corrected Time = t + offset + ( frequency * ( t - referenceTime ) )
+ *
+ * If a leap second is scheduled, it is applied to the corrected time as
+ * configured in @ref leapSmear.
+ */
+typedef struct SntpClockModel
+{
+    /**
+     * @brief The local time at which the model was last updated with a
+     * clock offset sample.
+     */
+    SntpTimestamp_t referenceTime;
+
+    /**
+     * @brief The offset of the local clock relative to server time at
+     * @ref referenceTime, in units of SNTP timestamp fractions (i.e. 2^(-32)
+     * seconds).
+     */
+    int64_t offset;
+
+    /**
+     * @brief The estimated frequency correction of the local clock, in units
+     * of SNTP timestamp fractions per second (i.e. 2^(-32) seconds per second).
+     * A correction of 1 PPM is approximately #SNTP_FRACTION_VALUE_PER_MICROSECOND.
+     */
+    int32_t frequency;
+
+    /**
+     * @brief Whether the model has received a clock offset sample.
+     */
+    bool isSynchronized;
+
+    /**
+     * @brief The scheduled leap second, and the method of applying it to the
+     * corrected time.
+     */
+    SntpLeapSmear_t leapSmear;
+
+    /**
+     * @brief Whether the leap second step is included in @ref offset, i.e. the
+     * model has received a clock offset sample after the leap second.
+     */
+    bool isLeapApplied;
+
+    /**
+     * @brief The average magnitude of the differences between the clock offset
+     * samples and the offsets predicted by the model, in units of SNTP timestamp
+     * fractions.
+     */
+    uint64_t jitter;
+
+    /**
+     * @brief The average magnitude of the frequency errors measured from clock
+     * offset samples, in units of SNTP timestamp fractions per second. This is
+     * the rate at which the error of the predicted time grows.
+     */
+    int32_t frequencyUncertainty;
+
+    /**
+     * @brief Whether the virtual clock is in holdover, i.e. no time server is
+     * reachable.
+     */
+    bool isHoldover;
+} SntpClockModel_t;
+
+/**
+ * @ingroup core_sntp_struct_types
+ * @brief Structure representing a virtual clock that applies the correction
+ * estimated from SNTP responses to the local clock time.
+ *
+ * @note The virtual clock supports a single writer (i.e. the caller of
+ * @ref Sntp_UpdateVirtualClock) and any number of concurrent readers (i.e.
+ * callers of @ref Sntp_GetCorrectedTime) without locks. Readers retry reading
+ * the clock model if it changes while being read.
+ *
+ * @note The members of this structure SHOULD NOT be accessed directly by the
+ * application.
+ */
+typedef struct SntpVirtualClock
+{
+    /**
+     * @brief Sequence counter for lock-free reads of @ref model. The value is odd
+     * while the writer is updating the model.
+     */
+    volatile uint32_t sequence;
+
+    /**
+     * @brief The model of the local clock error.
+     */
+    SntpClockModel_t model;
+} SntpVirtualClock_t;
+
+/**
+ * @brief Initializes a virtual clock in an unsynchronized state.
+ *
+ * @param[out] pClock The virtual clock to initialize.
+ *
+ * @return This function returns one of the following:
+ * - #SntpSuccess if the virtual clock is initialized.
+ * - #SntpErrorBadParameter if @p pClock is NULL.
+ */
+/* @[define_sntp_initvirtualclock] */
+SntpStatus_t Sntp_InitVirtualClock( SntpVirtualClock_t * pClock );
+/* @[define_sntp_initvirtualclock] */
+
+/**
+ * @brief Updates the virtual clock with a clock offset sample calculated from a
+ * server response.
+ *
+ * The first sample sets the offset of the virtual clock. Each subsequent sample
+ * also refines the frequency correction from the difference between the sample
+ * and the offset predicted by the current clock model. A sample also takes the
+ * virtual clock out of holdover.
+ *
+ * @param[in, out] pClock The virtual clock to update.
+ * @param[in] pLocalTime The local time at which the clock offset was measured
+ * (for example, the time of receiving the server response). The local time MUST
+ * be obtained from the same clock that is later passed to @ref Sntp_GetCorrectedTime.
+ * @param[in] clockOffset The offset of the local clock relative to server time,
+ * in units of SNTP timestamp fractions, as calculated in the
+ * #SntpResponseData_t.clockOffsetFractions member by the
+ * @ref Sntp_DeserializeResponse API.
+ *
+ * @note This function MUST NOT be called concurrently for the same virtual
+ * clock.
+ *
+ * @return This function returns one of the following:
+ * - #SntpSuccess if the virtual clock is updated.
+ * - #SntpErrorBadParameter if any of the parameters is NULL.
+ */
+/* @[define_sntp_updatevirtualclock] */
+SntpStatus_t Sntp_UpdateVirtualClock( SntpVirtualClock_t * pClock,
+                                      const SntpTimestamp_t * pLocalTime,
+                                      int64_t clockOffset );
+/* @[define_sntp_updatevirtualclock] */
+
+/**
+ * @brief Calculates the current corrected time, in SNTP timestamp format, from
+ * the local time and the clock model of the virtual clock.
+ *
+ * This function does not perform any network operation or system call, and does
+ * not block the writer of the virtual clock. It can be called concurrently from
+ * any number of threads.
+ *
+ * A leap second scheduled with @ref Sntp_ScheduleVirtualClockLeapSecond is
+ * applied to the corrected time with the method configured with
+ * @ref Sntp_SetVirtualClockLeapSmear.
+ *
+ * @param[in] pClock The virtual clock to read.
+ * @param[in] pLocalTime The current local time, obtained from the same clock used
+ * with @ref Sntp_UpdateVirtualClock. A monotonic clock source is recommended.
+ * @param[out] pCorrectedTime This will be filled with the corrected time.
+ *
+ * @return This function returns one of the following:
+ * - #SntpSuccess if the corrected time is calculated.
+ * - #SntpErrorBadParameter if any of the parameters is NULL.
+ * - #SntpClockNotSynchronized if the virtual clock has not been updated with a
+ * clock offset sample.
+ */
+/* @[define_sntp_getcorrectedtime] */
+SntpStatus_t Sntp_GetCorrectedTime( const SntpVirtualClock_t * pClock,
+                                    const SntpTimestamp_t * pLocalTime,
+                                    SntpTimestamp_t * pCorrectedTime );
+/* @[define_sntp_getcorrectedtime] */
+
+/**
+ * @brief Calculates the current corrected time, in UNIX time format, from the
+ * local time and the clock model of the virtual clock.
+ *
+ * This function is the same as @ref Sntp_GetCorrectedTime, but converts the
+ * corrected time to UNIX time with the @ref Sntp_ConvertToUnixTime API.
+ *
+ * @param[in] pClock The virtual clock to read.
+ * @param[in] pLocalTime The current local time, obtained from the same clock used
+ * with @ref Sntp_UpdateVirtualClock.
+ * @param[out] pUnixTimeSecs This will be filled with the seconds part of the
+ * corrected UNIX time.
+ * @param[out] pUnixTimeMicrosecs This will be filled with the microseconds part
+ * of the corrected UNIX time.
+ *
+ * @return This function returns one of the following:
+ * - #SntpSuccess if the corrected time is calculated.
+ * - #SntpErrorBadParameter if any of the parameters is NULL.
+ * - #SntpClockNotSynchronized if the virtual clock has not been updated with a
+ * clock offset sample.
+ * - #SntpErrorTimeNotSupported if the corrected time does not lie in the time
+ * range supported by @ref Sntp_ConvertToUnixTime.
+ */
+/* @[define_sntp_getcorrectedunixtime] */
+SntpStatus_t Sntp_GetCorrectedUnixTime( const SntpVirtualClock_t * pClock,
+                                        const SntpTimestamp_t * pLocalTime,
+                                        uint32_t * pUnixTimeSecs,
+                                        uint32_t * pUnixTimeMicrosecs );
+/* @[define_sntp_getcorrectedunixtime] */
+
+/**
+ * @brief Puts the virtual clock in holdover, when no time server is reachable.
+ *
+ * In holdover, the virtual clock continues to provide corrected time predicted
+ * from the last clock offset sample and the frequency estimate, with an error
+ * bound that grows with the time since the last sample (refer to
+ * @ref Sntp_GetVirtualClockErrorBound). The virtual clock leaves holdover with
+ * the next call to @ref Sntp_UpdateVirtualClock.
+ *
+ * @note The client API (@ref Sntp_ReceiveTimeResponse) calls this function
+ * when all configured servers have failed, if a virtual clock is set in the
+ * client context.
+ *
+ * @param[in, out] pClock The virtual clock.
+ *
+ * @note This function MUST NOT be called concurrently with the other functions
+ * that update the virtual clock.
+ *
+ * @return This function returns one of the following:
+ * - #SntpSuccess if the virtual clock is in holdover.
+ * - #SntpErrorBadParameter if @p pClock is NULL.
+ * - #SntpClockNotSynchronized if the virtual clock has not been updated with a
+ * clock offset sample, and therefore, cannot predict time.
+ */
+/* @[define_sntp_entervirtualclockholdover] */
+SntpStatus_t Sntp_EnterVirtualClockHoldover( SntpVirtualClock_t * pClock );
+/* @[define_sntp_entervirtualclockholdover] */
+
+/**
+ * @brief Calculates the synchronization state and the error bound of the
+ * corrected time of a virtual clock at a local time.
+ *
+ * The error bound is derived from the measured stability of the local clock:
+ *
+ *   Error Bound = jitter + ( frequency uncertainty * ( t - referenceTime ) )
+ *
+ * where the jitter and the frequency uncertainty are averages of the errors of
+ * the predictions of the clock model for the clock offset samples.
+ *
+ * @param[in] pClock The virtual clock to read.
+ * @param[in] pLocalTime The current local time, obtained from the same clock used
+ * with @ref Sntp_UpdateVirtualClock.
+ * @param[out] pState This will be filled with the synchronization state of the
+ * virtual clock.
+ * @param[out] pErrorBound This will be filled with the error bound of the
+ * corrected time, in units of SNTP timestamp fractions.
+ *
+ * @return This function returns one of the following:
+ * - #SntpSuccess if the state and error bound are calculated.
+ * - #SntpErrorBadParameter if any of the parameters is NULL.
+ * - #SntpClockNotSynchronized if the virtual clock has not been updated with a
+ * clock offset sample. @p pState is set to #SntpClockStateUnsynchronized.
+ */
+/* @[define_sntp_getvirtualclockerrorbound] */
+SntpStatus_t Sntp_GetVirtualClockErrorBound( const SntpVirtualClock_t * pClock,
+                                             const SntpTimestamp_t * pLocalTime,
+                                             SntpClockState_t * pState,
+                                             uint64_t * pErrorBound );
+/* @[define_sntp_getvirtualclockerrorbound] */
+
+/**
+ * @brief Configures the method of applying leap seconds to the corrected time
+ * of a virtual clock.
+ *
+ * With leap smearing, the corrected time runs slightly slower (for an inserted
+ * leap second) or faster (for a deleted leap second) over the smear window, so
+ * that the corrected time never steps and never shows a 61 (or 59) second
+ * minute. Outside the smear window, the corrected time is UTC.
+ *
+ * @param[in, out] pClock The virtual clock.
+ * @param[in] type The method of applying leap seconds.
+ * @param[in] windowSecs The duration, in seconds, of the smear window centered
+ * on the leap second. For example, #SNTP_LEAP_SMEAR_DEFAULT_WINDOW_SECS. Not
+ * used when @p type is #SntpLeapSmearNone.
+ *
+ * @note This function MUST NOT be called concurrently with the other functions
+ * that update the virtual clock.
+ *
+ * @return This function returns one of the following:
+ * - #SntpSuccess if the leap smear method is configured.
+ * - #SntpErrorBadParameter if @p pClock is NULL, @p type is invalid, or
+ * @p windowSecs is zero for a smear type.
+ */
+/* @[define_sntp_setvirtualclockleapsmear] */
+SntpStatus_t Sntp_SetVirtualClockLeapSmear( SntpVirtualClock_t * pClock,
+                                            SntpLeapSmearType_t type,
+                                            uint32_t windowSecs );
+/* @[define_sntp_setvirtualclockleapsmear] */
+
+/**
+ * @brief Schedules a leap second announced in a server response for the
+ * corrected time of a virtual clock.
+ *
+ * The leap second is applied at the end of the UTC month of the server time.
+ * The virtual clock also accounts for the step of server time at the leap second
+ * when updated with clock offset samples after the leap second.
+ *
+ * @param[in, out] pClock The virtual clock.
+ * @param[in] pServerTime The server time from the response, as returned in
+ * #SntpResponseData_t.serverTime by the @ref Sntp_DeserializeResponse API.
+ * @param[in] leapSecondType The leap second information from the response, as
+ * returned in #SntpResponseData_t.leapSecondType. #NoLeapSecond cancels a
+ * scheduled leap second that has not yet occurred, and
+ * #AlarmServerNotSynchronized is ignored.
+ *
+ * @note This function MUST NOT be called concurrently with the other functions
+ * that update the virtual clock.
+ *
+ * @return This function returns one of the following:
+ * - #SntpSuccess if the leap second information is processed.
+ * - #SntpErrorBadParameter if any of the pointer parameters is NULL, or
+ * @p leapSecondType is invalid.
+ */
+/* @[define_sntp_schedulevirtualclockleapsecond] */
+SntpStatus_t Sntp_ScheduleVirtualClockLeapSecond( SntpVirtualClock_t * pClock,
+                                                  const SntpTimestamp_t * pServerTime,
+                                                  SntpLeapSecondInfo_t leapSecondType );
+/* @[define_sntp_schedulevirtualclockleapsecond] */
+
+/**
+ * @brief Schedules a leap second announced in a server response in a leap smear
+ * configuration, for example, of a time responder that serves smeared time.
+ *
+ * The leap second instant is calculated as the end of the UTC month of
+ * @p pServerTime. The @ref SntpLeapSmear_t.type and
+ * @ref SntpLeapSmear_t.windowSecs members are not changed.
+ *
+ * @param[in, out] pLeapSmear The leap smear configuration.
+ * @param[in] pServerTime The server time at which the leap second is announced.
+ * @param[in] leapSecondType The announced leap second. #NoLeapSecond clears
+ * the leap second, and #AlarmServerNotSynchronized is ignored.
+ *
+ * @return This function returns one of the following:
+ * - #SntpSuccess if the leap second information is processed.
+ * - #SntpErrorBadParameter if any of the pointer parameters is NULL, or
+ * @p leapSecondType is invalid.
+ */
+/* @[define_sntp_scheduleleapsecond] */
+SntpStatus_t Sntp_ScheduleLeapSecond( SntpLeapSmear_t * pLeapSmear,
+                                      const SntpTimestamp_t * pServerTime,
+                                      SntpLeapSecondInfo_t leapSecondType );
+/* @[define_sntp_scheduleleapsecond] */
+
+/**
+ * @brief Applies a leap second to a time on the continuous timescale, with the
+ * configured leap smear method.
+ *
+ * A time responder can use this function to serve smeared time to its clients
+ * from a clock that is not stepped by the leap second.
+ *
+ * @param[in] pLeapSmear The leap smear configuration.
+ * @param[in] pTime The time on the continuous timescale.
+ * @param[out] pSmearedTime This will be filled with the time with the leap
+ * second applied.
+ *
+ * @return This function returns one of the following:
+ * - #SntpSuccess if the leap second is applied.
+ * - #SntpErrorBadParameter if any of the parameters is NULL, or the leap smear
+ * configuration is invalid.
+ */
+/* @[define_sntp_applyleapsmear] */
+SntpStatus_t Sntp_ApplyLeapSmear( const SntpLeapSmear_t * pLeapSmear,
+                                  const SntpTimestamp_t * pTime,
+                                  SntpTimestamp_t * pSmearedTime );
+/* @[define_sntp_applyleapsmear] */
+
+#endif /* ifndef CORE_SNTP_CLOCK_H_ */
@@ -0,0 +1,228 @@
+/*
+ * coreSNTP v1.0.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file core_sntp_config_defaults.h
+ * @brief This file represents the default values for the configuration macros
+ * of the coreSNTP library.
+ *
+ * @note This file SHOULD NOT be modified. If custom values are needed for
+ * any configuration macro, a core_sntp_config.h file should be provided to
+ * the SNTP library to override the default values defined in this file.
+ * To build the library without a core_sntp_config.h file, define
+ * the SNTP_DO_NOT_USE_CUSTOM_CONFIG macro.
+ */
+
+#ifndef CORE_SNTP_CONFIG_DEFAULTS_H_
+#define CORE_SNTP_CONFIG_DEFAULTS_H_
+
+/* The macro definition for SNTP_DO_NOT_USE_CUSTOM_CONFIG is for Doxygen
+ * documentation only. */
+
+/**
+ * @brief Define this macro to build the SNTP library without the custom config
+ * file core_sntp_config.h.
+ *
+ * Without the custom config, the SNTP library builds with
+ * default values of config macros defined in core_sntp_config_defaults.h file.
+ *
+ * If a custom config is provided, then SNTP_DO_NOT_USE_CUSTOM_CONFIG should not
+ * be defined.
+ */
+#ifdef DOXYGEN
+    #define SNTP_DO_NOT_USE_CUSTOM_CONFIG
+#endif
+
+/* SNTP_DO_NOT_USE_CUSTOM_CONFIG allows building the SNTP library
+ * without a config file. If a config file is provided,
+ * SNTP_DO_NOT_USE_CUSTOM_CONFIG macro must not be defined.
+ */
+#ifndef SNTP_DO_NOT_USE_CUSTOM_CONFIG
+    #include "core_sntp_config.h"
+#endif
+
+/**
+ * @brief Macro that is called in the SNTP library for logging "Error" level
+ * messages.
+ *
+ * To enable error level logging in the SNTP library, this macro should be
+ * mapped to the application-specific logging implementation that supports
+ * error logging.
+ *
+ * @note This logging macro is called in the SNTP library with parameters
+ * wrapped in double parentheses to be ISO C89/C90 standard compliant. For a
+ * reference POSIX implementation of the logging macros, refer to the
+ * core_sntp_config.h file of the unit tests.
+ *
+ * <b>Default value</b>: Error logging is turned off, and no code is generated
+ * for calls to the macro in the SNTP library on compilation.
+ */
+#ifndef LogError
+    #define LogError( message )
+#endif
+
+/**
+ * @brief Macro that is called in the SNTP library for logging "Warning" level
+ * messages.
+ *
+ * To enable warning level logging in the SNTP library, this macro should be
+ * mapped to the application-specific logging implementation that supports
+ * warning logging.
+ *
+ * @note This logging macro is called in the SNTP library with parameters
+ * wrapped in double parentheses to be ISO C89/C90 standard compliant.
+ *
+ * <b>Default value</b>: Warning logs are turned off, and no code is generated
+ * for calls to the macro in the SNTP library on compilation.
+ */
+#ifndef LogWarn
+    #define LogWarn( message )
+#endif
+
+/**
+ * @brief Macro that is called in the SNTP library for logging "Info" level
+ * messages.
+ *
+ * To enable info level logging in the SNTP library, this macro should be
+ * mapped to the application-specific logging implementation that supports
+ * info logging.
+ *
+ * @note This logging macro is called in the SNTP library with parameters
+ * wrapped in double parentheses to be ISO C89/C90 standard compliant.
+ *
+ * <b>Default value</b>: Info logging is turned off, and no code is generated
+ * for calls to the macro in the SNTP library on compilation.
+ */
+#ifndef LogInfo
+    #define LogInfo( message )
+#endif
+
+/**
+ * @brief Macro that is called in the SNTP library for logging "Debug" level
+ * messages.
+ *
+ * To enable debug level logging in the SNTP library, this macro should be
+ * mapped to the application-specific logging implementation that supports
+ * debug logging.
+ *
+ * @note This logging macro is called in the SNTP library with parameters
+ * wrapped in double parentheses to be ISO C89/C90 standard compliant.
+ *
+ * <b>Default value</b>: Debug logging is turned off, and no code is generated
+ * for calls to the macro in the SNTP library on compilation.
+ */
+#ifndef LogDebug
+    #define LogDebug( message )
+#endif
+
+/**
+ * @brief The interval at which a message that the SNTP library logs repeatedly,
+ * such as the rejection of server responses, is logged again: the first
+ * occurrence at each place of the library is logged, and then every
+ * SNTP_LOG_REPEAT_INTERVAL-th occurrence.
+ *
+ * Rate limiting keeps a count of occurrences at each place, so it should only
+ * be enabled together with the levels that it limits.
+ *
+ * <b>Possible values:</b> Any positive 32 bit integer. @n
+ * <b>Default value:</b> `1`, which logs every occurrence without keeping a
+ * count.
+ */
+#ifndef SNTP_LOG_REPEAT_INTERVAL
+    #define SNTP_LOG_REPEAT_INTERVAL    ( 1U )
+#endif
+
+/**
+ * @brief Macro that is called in the SNTP library for logging repeated
+ * messages with one of the logging macros, rate limited with
+ * #SNTP_LOG_REPEAT_INTERVAL.
+ *
+ * @param[in] logMacro The logging macro, such as #LogWarn.
+ * @param[in] message The parameters of the logging macro, wrapped in
+ * parentheses.
+ */
+#ifndef SNTP_LOG_RATE_LIMITED
+    #define SNTP_LOG_RATE_LIMITED( logMacro, message )                    \
+    do                                                                    \
+    {                                                                     \
+        if( SNTP_LOG_REPEAT_INTERVAL > 1U )                               \
+        {                                                                 \
+            static uint32_t occurrences = 0U;                             \
+                                                                          \
+            if( ( occurrences % ( uint32_t ) SNTP_LOG_REPEAT_INTERVAL ) == 0U ) \
+            {                                                             \
+                logMacro( message );                                      \
+            }                                                             \
+                                                                          \
+            occurrences++;                                                \
+        }                                                                 \
+        else                                                              \
+        {                                                                 \
+            logMacro( message );                                          \
+        }                                                                 \
+    } while( 0 )
+#endif
+
+/**
+ * @brief Value of #SNTP_BYTE_ORDER for byte-order conversion with byte
+ * operations, which works on any target.
+ */
+#define SNTP_BYTE_ORDER_PORTABLE         ( 0 )
+
+/**
+ * @brief Value of #SNTP_BYTE_ORDER for little-endian targets, which convert
+ * the byte order with the `__builtin_bswap32` intrinsic of GCC and Clang.
+ */
+#define SNTP_BYTE_ORDER_LITTLE_ENDIAN    ( 1 )
+
+/**
+ * @brief Value of #SNTP_BYTE_ORDER for big-endian targets, which use the
+ * network byte order natively.
+ */
+#define SNTP_BYTE_ORDER_BIG_ENDIAN       ( 2 )
+
+/**
+ * @brief The byte order of the target, which selects how the SNTP library
+ * reads and writes the 32-bit words of SNTP packets in network byte order.
+ *
+ * All values produce bit-identical packets. The endian-specific values
+ * replace the four byte operations for each word with a single load or
+ * store (and a byte swap on little-endian targets).
+ *
+ * <b>Possible values:</b> #SNTP_BYTE_ORDER_PORTABLE,
+ * #SNTP_BYTE_ORDER_LITTLE_ENDIAN or #SNTP_BYTE_ORDER_BIG_ENDIAN. @n
+ * <b>Default value:</b> Detected from the `__BYTE_ORDER__` macro of GCC and
+ * Clang; #SNTP_BYTE_ORDER_PORTABLE with other compilers.
+ */
+#ifndef SNTP_BYTE_ORDER
+    #if defined( __GNUC__ ) && defined( __BYTE_ORDER__ ) && defined( __ORDER_LITTLE_ENDIAN__ ) && \
+    ( __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__ )
+        #define SNTP_BYTE_ORDER    SNTP_BYTE_ORDER_LITTLE_ENDIAN
+    #elif defined( __GNUC__ ) && defined( __BYTE_ORDER__ ) && defined( __ORDER_BIG_ENDIAN__ ) && \
+    ( __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__ )
+        #define SNTP_BYTE_ORDER    SNTP_BYTE_ORDER_BIG_ENDIAN
+    #else
+        #define SNTP_BYTE_ORDER    SNTP_BYTE_ORDER_PORTABLE
+    #endif
+#endif
+
+#endif /* ifndef CORE_SNTP_CONFIG_DEFAULTS_H_ */
@@ -0,0 +1,311 @@
+/*
+ * coreSNTP v1.0.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file core_sntp_coroutine.hpp
+ * @brief Header-only C++20 coroutine interface of the coreSNTP library, which
+ * runs time queries on the non-blocking client of @ref core_sntp_client.hpp
+ * without a thread per query.
+ *
+ * A query sends a time request, and then suspends on a reactor until the
+ * response can be read. The reactor is the application's event loop, for
+ * example, on epoll or io_uring, and provides one member function:
+ *
+ * @code{cpp}
+ * // Returns an awaitable that resumes the awaiting coroutine when the UDP
+ * // transport of the context is readable, or after the timeout at most.
+ * auto waitForResponse( const SntpContext_t & context, std::chrono::milliseconds timeout );
+ * @endcode
+ *
+ * The timeout passed to the reactor is the wait time of
+ * @ref Sntp_GetResponseWaitTime, which ends at the response timeout estimated
+ * for the current server, if any, rather than the timeout of the query, or
+ * when the request is due to be hedged, see @ref Sntp_SetHedging.
+ *
+ * With epoll, the awaitable registers the socket of the transport for EPOLLIN
+ * with a timer of the timeout, and the event loop resumes the coroutine handle
+ * on either event. Spurious resumptions are allowed: the query reads again
+ * until a response is received or the response timeout expires.
+ *
+ * Failover and bursts are plain loops in a coroutine:
+ *
+ * @code{cpp}
+ * sntp::Task<SntpStatus_t> synchronize( sntp::AsyncClient<Reactor> & client )
+ * {
+ *     SntpStatus_t status = SntpErrorNetworkFailure;
+ *
+ *     // The client moves to the next server after each failure.
+ *     for( std::size_t i = 0U; ( i < numOfServers ) && ( status != SntpSuccess ); i++ )
+ *     {
+ *         status = co_await client.query( random(), std::chrono::seconds { 3 } );
+ *     }
+ *
+ *     co_return status;
+ * }
+ * @endcode
+ */
+
+#ifndef CORE_SNTP_COROUTINE_HPP_
+#define CORE_SNTP_COROUTINE_HPP_
+
+/* Standard includes. */
+#include <chrono>
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <utility>
+
+/* coreSNTP C++ interface. */
+#include "core_sntp_client.hpp"
+
+namespace sntp
+{
+    /**
+     * @brief A lazily started coroutine that produces a value, and resumes the
+     * coroutine that awaits it on completion.
+     *
+     * @tparam T The type of the value, which MUST be default constructible.
+     */
+    template<typename T>
+    class Task
+    {
+        public:
+
+            /**
+             * @brief The promise of the coroutine.
+             */
+            struct promise_type
+            {
+                T value {};                           /**< @brief The value of the coroutine. */
+                std::coroutine_handle<> continuation; /**< @brief The awaiting coroutine. */
+
+                /**
+                 * @brief Resumes the awaiting coroutine, if any, on completion.
+                 */
+                struct FinalAwaiter
+                {
+                    bool await_ready() const noexcept
+                    {
+                        return false;
+                    }
+
+                    std::coroutine_handle<> await_suspend( std::coroutine_handle<promise_type> handle ) noexcept
+                    {
+                        std::coroutine_handle<> continuation = handle.promise().continuation;
+
+                        return ( continuation ) ? continuation : std::noop_coroutine();
+                    }
+
+                    void await_resume() const noexcept
+                    {
+                    }
+                };
+
+                Task get_return_object() noexcept
+                {
+                    return Task { std::coroutine_handle<promise_type>::from_promise( *this ) };
+                }
+
+                std::suspend_always initial_suspend() const noexcept
+                {
+                    return {};
+                }
+
+                FinalAwaiter final_suspend() const noexcept
+                {
+                    return {};
+                }
+
+                void return_value( T result ) noexcept
+                {
+                    value = std::move( result );
+                }
+
+                void unhandled_exception() const noexcept
+                {
+                    std::terminate();
+                }
+            };
+
+            Task( Task && other ) noexcept : handle_ { std::exchange( other.handle_, {} ) }
+            {
+            }
+
+            Task & operator=( Task && other ) noexcept
+            {
+                if( this != &other )
+                {
+                    destroy();
+                    handle_ = std::exchange( other.handle_, {} );
+                }
+
+                return *this;
+            }
+
+            Task( const Task & ) = delete;
+            Task & operator=( const Task & ) = delete;
+
+            ~Task()
+            {
+                destroy();
+            }
+
+            /**
+             * @brief Starts a top-level task, which runs until its first
+             * suspension.
+             */
+            void start() noexcept
+            {
+                handle_.resume();
+            }
+
+            /**
+             * @brief Whether the task has completed.
+             */
+            bool done() const noexcept
+            {
+                return handle_.done();
+            }
+
+            /**
+             * @brief The value of a completed task.
+             */
+            const T & result() const noexcept
+            {
+                return handle_.promise().value;
+            }
+
+            /**
+             * @brief Awaiting a task starts it, and resumes the awaiting
+             * coroutine with its value on completion.
+             */
+            bool await_ready() const noexcept
+            {
+                return handle_.done();
+            }
+
+            std::coroutine_handle<> await_suspend( std::coroutine_handle<> awaiting ) noexcept
+            {
+                handle_.promise().continuation = awaiting;
+
+                return handle_;
+            }
+
+            T await_resume() noexcept
+            {
+                return std::move( handle_.promise().value );
+            }
+
+        private:
+            explicit Task( std::coroutine_handle<promise_type> handle ) noexcept : handle_ { handle }
+            {
+            }
+
+            void destroy() noexcept
+            {
+                if( handle_ )
+                {
+                    handle_.destroy();
+                }
+            }
+
+            std::coroutine_handle<promise_type> handle_; /**< @brief The coroutine. */
+    };
+
+    /**
+     * @brief The requirement of the reactors of @ref AsyncClient.
+     */
+    template<typename Reactor>
+    concept ResponseReactor = requires( Reactor & reactor,
+                                        const SntpContext_t & context,
+                                        std::chrono::milliseconds timeout )
+    {
+        reactor.waitForResponse( context, timeout );
+    };
+
+    /**
+     * @brief Time queries of a client as coroutines, which suspend on a reactor
+     * while waiting for server responses.
+     *
+     * @tparam Reactor The event loop, as described in
+     * @ref core_sntp_coroutine.hpp.
+     * @tparam BufferSize The network buffer size of the client.
+     */
+    template<ResponseReactor Reactor, std::size_t BufferSize = SNTP_PACKET_BASE_SIZE>
+    class AsyncClient
+    {
+        public:
+
+            /**
+             * @brief Runs the queries of a client on a reactor. The client and
+             * the reactor MUST outlive the queries.
+             */
+            AsyncClient( Client<BufferSize> & client,
+                         Reactor & reactor ) noexcept : client_ { client }, reactor_ { reactor }
+            {
+            }
+
+            /**
+             * @brief Queries the current server of the client for time.
+             *
+             * The status of the query is the status of @ref Sntp_SendTimeRequest
+             * if the request fails, or of the final @ref Sntp_ReceiveTimeResponse,
+             * after which the client has moved to the next server on failure,
+             * as with the C API.
+             *
+             * @param[in] randomNumber The random number of the request.
+             * @param[in] timeout The timeout of the response.
+             */
+            Task<SntpStatus_t> query( std::uint32_t randomNumber,
+                                      std::chrono::milliseconds timeout )
+            {
+                SntpStatus_t status = client_.sendTimeRequest( randomNumber );
+
+                if( status == SntpSuccess )
+                {
+                    status = SntpNoResponseReceived;
+                }
+
+                while( status == SntpNoResponseReceived )
+                {
+                    co_await reactor_.waitForResponse( client_.context(), client_.responseWaitTime( timeout ) );
+                    status = client_.receiveTimeResponse( timeout );
+                }
+
+                co_return status;
+            }
+
+            /**
+             * @brief The client of the queries.
+             */
+            Client<BufferSize> & client() noexcept
+            {
+                return client_;
+            }
+
+        private:
+            Client<BufferSize> & client_; /**< @brief The client. */
+            Reactor & reactor_;           /**< @brief The reactor. */
+    };
+}
+
+#endif /* ifndef CORE_SNTP_COROUTINE_HPP_ */
@@ -0,0 +1,199 @@
+/*
+ * coreSNTP v1.0.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file core_sntp_filter.h
+ * @brief API of an outlier gate that rejects clock offset samples that deviate
+ * too far from recent samples, before they are used to correct time.
+ *
+ * A single response delayed in a congested network queue can produce a large,
+ * false clock offset (a "popcorn spike"). The outlier gate keeps a short history
+ * of the clock offsets and round-trip delays of accepted samples, and rejects a
+ * sample whose offset or delay deviates from the history by more than a multiple
+ * of the jitter measured in it. If samples keep deviating for a configurable
+ * number of polls, the change is assumed to be real (for example, a network
+ * route change or a step of the system clock), and the gate restarts its history
+ * from the deviating sample.
+ */
+
+#ifndef CORE_SNTP_FILTER_H_
+#define CORE_SNTP_FILTER_H_
+
+/* Standard include. */
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/* Include coreSNTP Serializer header. */
+#include "core_sntp_serializer.h"
+
+/**
+ * @brief The number of accepted samples kept in the history of an outlier gate.
+ */
+#define SNTP_OUTLIER_GATE_HISTORY_SIZE               ( 8U )
+
+/**
+ * @brief The number of accepted samples needed in the history before the
+ * outlier gate starts rejecting samples. Samples are accepted as is until then.
+ */
+#define SNTP_OUTLIER_GATE_MIN_SAMPLES                ( 4U )
+
+/**
+ * @brief The default multiple of the measured jitter beyond which a sample is
+ * rejected.
+ *
+ * @note This is the same value as the spike gate (SGATE) of the NTP reference
+ * implementation.
+ */
+#define SNTP_OUTLIER_GATE_DEFAULT_THRESHOLD          ( 3U )
+
+/**
+ * @brief The default number of consecutive samples that the outlier gate rejects
+ * before it accepts a persistent deviation.
+ */
+#define SNTP_OUTLIER_GATE_DEFAULT_MAX_REJECTIONS     ( 4U )
+
+/**
+ * @brief The lowest jitter, in microseconds, used by the outlier gate, so that
+ * a history of nearly identical samples does not reject the normal variation of
+ * later samples.
+ */
+#define SNTP_OUTLIER_GATE_MIN_JITTER_US              ( 100U )
+
+/**
+ * @ingroup core_sntp_struct_types
+ * @brief Structure representing an outlier gate for clock offset samples.
+ *
+ * @note The members of this structure SHOULD NOT be accessed directly by the
+ * application.
+ */
+typedef struct SntpOutlierGate
+{
+    /**
+     * @brief The clock offsets, in units of SNTP timestamp fractions, of the
+     * accepted samples, in a circular buffer.
+     */
+    int64_t offsetHistory[ SNTP_OUTLIER_GATE_HISTORY_SIZE ];
+
+    /**
+     * @brief The round-trip delays, in units of SNTP timestamp fractions, of the
+     * accepted samples, in a circular buffer.
+     */
+    int64_t delayHistory[ SNTP_OUTLIER_GATE_HISTORY_SIZE ];
+
+    /**
+     * @brief The number of samples in the history.
+     */
+    size_t numOfSamples;
+
+    /**
+     * @brief The position in the history buffers for the next accepted sample.
+     */
+    size_t nextSampleIndex;
+
+    /**
+     * @brief The multiple of the measured jitter beyond which a sample is
+     * rejected.
+     */
+    uint32_t thresholdMultiplier;
+
+    /**
+     * @brief The number of consecutive samples rejected before a deviating
+     * sample is accepted.
+     */
+    uint32_t maxConsecutiveRejections;
+
+    /**
+     * @brief The number of samples rejected since the last accepted sample.
+     */
+    uint32_t consecutiveRejections;
+} SntpOutlierGate_t;
+
+/**
+ * @brief Initializes an outlier gate with an empty history.
+ *
+ * @param[out] pGate The outlier gate to initialize.
+ * @param[in] thresholdMultiplier The multiple of the measured jitter beyond
+ * which a sample is rejected, for example, #SNTP_OUTLIER_GATE_DEFAULT_THRESHOLD.
+ * @param[in] maxConsecutiveRejections The number of consecutive samples to
+ * reject before a persistent deviation is accepted, for example,
+ * #SNTP_OUTLIER_GATE_DEFAULT_MAX_REJECTIONS. A value of zero accepts every
+ * sample.
+ *
+ * @return This function returns one of the following:
+ * - #SntpSuccess if the outlier gate is initialized.
+ * - #SntpErrorBadParameter if @p pGate is NULL, or @p thresholdMultiplier is
+ * zero.
+ */
+/* @[define_sntp_initoutliergate] */
+SntpStatus_t Sntp_InitOutlierGate( SntpOutlierGate_t * pGate,
+                                   uint32_t thresholdMultiplier,
+                                   uint32_t maxConsecutiveRejections );
+/* @[define_sntp_initoutliergate] */
+
+/**
+ * @brief Clears the history of an outlier gate, for example, when the samples
+ * come from a different time server.
+ *
+ * @param[in, out] pGate The outlier gate.
+ *
+ * @return This function returns one of the following:
+ * - #SntpSuccess if the history is cleared.
+ * - #SntpErrorBadParameter if @p pGate is NULL.
+ */
+/* @[define_sntp_resetoutliergate] */
+SntpStatus_t Sntp_ResetOutlierGate( SntpOutlierGate_t * pGate );
+/* @[define_sntp_resetoutliergate] */
+
+/**
+ * @brief Checks a clock offset sample against the history of the outlier gate,
+ * and adds it to the history if it is accepted.
+ *
+ * A sample is an outlier if either:
+ * - its clock offset differs from the offset of the last accepted sample by more
+ * than the threshold multiple of the offset jitter, i.e. the average difference
+ * between successive offsets in the history, or
+ * - its round-trip delay exceeds the lowest delay in the history by more than
+ * the threshold multiple of the delay jitter, i.e. the average excess of the
+ * delays in the history over the lowest delay.
+ *
+ * Jitter values lower than #SNTP_OUTLIER_GATE_MIN_JITTER_US are raised to it.
+ *
+ * @param[in, out] pGate The outlier gate.
+ * @param[in] clockOffset The clock offset of the sample, in units of SNTP
+ * timestamp fractions, as calculated in #SntpResponseData_t.clockOffsetFractions.
+ * @param[in] roundTripDelay The round-trip delay of the sample, in units of SNTP
+ * timestamp fractions, as calculated in #SntpResponseData_t.roundTripDelayFractions.
+ *
+ * @return This function returns one of the following:
+ * - #SntpSuccess if the sample is accepted.
+ * - #SntpRejectedResponseOutlier if the sample is an outlier, and SHOULD NOT be
+ * used to correct time.
+ * - #SntpErrorBadParameter if @p pGate is NULL.
+ */
+/* @[define_sntp_filtersample] */
+SntpStatus_t Sntp_FilterSample( SntpOutlierGate_t * pGate,
+                                int64_t clockOffset,
+                                int64_t roundTripDelay );
+/* @[define_sntp_filtersample] */
+
+#endif /* ifndef CORE_SNTP_FILTER_H_ */
@@ -0,0 +1,192 @@
+/*
+ * coreSNTP v1.0.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file core_sntp_fixed_point.h
+ * @brief API for arithmetic on SNTP timestamps in the 64-bit 32.32 fixed-point
+ * format, which is shared by the modules of the coreSNTP library.
+ *
+ * An SNTP timestamp counts seconds modulo 2^32, so its value wraps around at the
+ * start of each SNTP era (the first wrap is on 7 Feb 2036). As a 64-bit unsigned
+ * value in units of 2^(-32) seconds, the modulo 2^64 arithmetic of unsigned
+ * integers handles the wrap-around: the difference of two times that are less
+ * than 68 years apart is correct as a signed value, regardless of their eras.
+ *
+ * The conversion and arithmetic functions have no branches on the values of
+ * their parameters, so they take the same time for all inputs, and compile to a
+ * few instructions.
+ */
+
+#ifndef CORE_SNTP_FIXED_POINT_H_
+#define CORE_SNTP_FIXED_POINT_H_
+
+/* Standard include. */
+#include <stdint.h>
+
+/* Include coreSNTP Serializer header. */
+#include "core_sntp_serializer.h"
+
+/**
+ * @ingroup core_sntp_struct_types
+ * @brief Type representing an SNTP time in the 64-bit fixed-point format: the
+ * seconds of the SNTP timestamp in the upper 32 bits, and the fractions in the
+ * lower 32 bits.
+ */
+typedef uint64_t SntpFixedTime_t;
+
+/**
+ * @brief A duration of one second, in units of SNTP timestamp fractions.
+ */
+#define SNTP_FIXED_SECOND    ( ( int64_t ) 1 << 32 )
+
+/**
+ * @brief Converts an SNTP timestamp into the 64-bit fixed-point format.
+ *
+ * @param[in] time The SNTP timestamp.
+ *
+ * @return The fixed-point representation of @p time.
+ */
+/* @[define_sntp_fixedfromtimestamp] */
+SntpFixedTime_t Sntp_FixedFromTimestamp( SntpTimestamp_t time );
+/* @[define_sntp_fixedfromtimestamp] */
+
+/**
+ * @brief Converts a time in the 64-bit fixed-point format into an SNTP
+ * timestamp.
+ *
+ * @param[in] time The fixed-point time.
+ *
+ * @return The SNTP timestamp of @p time.
+ */
+/* @[define_sntp_fixedtotimestamp] */
+SntpTimestamp_t Sntp_FixedToTimestamp( SntpFixedTime_t time );
+/* @[define_sntp_fixedtotimestamp] */
+
+/**
+ * @brief Calculates the signed duration between two times, across SNTP eras.
+ *
+ * @param[in] later The end of the duration.
+ * @param[in] earlier The start of the duration.
+ *
+ * @return The duration ( @p later - @p earlier ), in units of SNTP timestamp
+ * fractions. It is negative if @p later precedes @p earlier.
+ *
+ * @note The result is correct if the times are less than 2^31 seconds (~68
+ * years) apart; otherwise, the times are taken to be in the eras that are
+ * closest to each other.
+ */
+/* @[define_sntp_fixeddifference] */
+int64_t Sntp_FixedDifference( SntpFixedTime_t later,
+                              SntpFixedTime_t earlier );
+/* @[define_sntp_fixeddifference] */
+
+/**
+ * @brief Calculates the time halfway between two times, across SNTP eras.
+ *
+ * @param[in] first The first time.
+ * @param[in] second The second time.
+ *
+ * @return The time halfway between @p first and @p second, truncated towards
+ * @p first to a whole number of fractions.
+ *
+ * @note As for @ref Sntp_FixedDifference, the times MUST be less than 2^31
+ * seconds apart.
+ */
+/* @[define_sntp_fixedmidpoint] */
+SntpFixedTime_t Sntp_FixedMidpoint( SntpFixedTime_t first,
+                                    SntpFixedTime_t second );
+/* @[define_sntp_fixedmidpoint] */
+
+/**
+ * @brief Compares two times, across SNTP eras.
+ *
+ * @param[in] first The first time.
+ * @param[in] second The second time.
+ *
+ * @return A negative value if @p first precedes @p second, zero if the times
+ * are equal, and a positive value if @p first follows @p second.
+ *
+ * @note As for @ref Sntp_FixedDifference, the times MUST be less than 2^31
+ * seconds apart.
+ */
+/* @[define_sntp_fixedcompare] */
+int32_t Sntp_FixedCompare( SntpFixedTime_t first,
+                           SntpFixedTime_t second );
+/* @[define_sntp_fixedcompare] */
+
+/**
+ * @brief Calculates the magnitude of a signed duration.
+ *
+ * @param[in] duration The duration, in units of SNTP timestamp fractions.
+ *
+ * @return The magnitude of @p duration, which is correct for INT64_MIN too.
+ */
+/* @[define_sntp_fixedmagnitude] */
+uint64_t Sntp_FixedMagnitude( int64_t duration );
+/* @[define_sntp_fixedmagnitude] */
+
+/**
+ * @brief Scales a duration by a 32-bit factor in units of 2^(-32), without
+ * overflow.
+ *
+ * The factor can be a fraction of the duration, such as a random phase of a
+ * polling interval, or a number of units per second, which converts the
+ * duration into whole sub-second units.
+ *
+ * @param[in] duration The duration, in units of SNTP timestamp fractions.
+ * @param[in] factor The factor, in units of 2^(-32).
+ *
+ * @return ( @p duration * @p factor / 2^32 ), truncated.
+ */
+/* @[define_sntp_fixedscale] */
+uint64_t Sntp_FixedScale( uint64_t duration,
+                          uint32_t factor );
+/* @[define_sntp_fixedscale] */
+
+/**
+ * @brief Converts a signed duration in units of SNTP timestamp fractions into
+ * nanoseconds.
+ *
+ * @param[in] duration The duration, in units of SNTP timestamp fractions.
+ *
+ * @return The duration in nanoseconds, truncated towards zero. Every 64-bit
+ * duration can be represented.
+ */
+/* @[define_sntp_fixedtonanoseconds] */
+int64_t Sntp_FixedToNanoseconds( int64_t duration );
+/* @[define_sntp_fixedtonanoseconds] */
+
+/**
+ * @brief Converts a signed duration in nanoseconds into units of SNTP
+ * timestamp fractions.
+ *
+ * @param[in] nanoseconds The duration in nanoseconds. Its magnitude MUST be
+ * less than 2^31 seconds (~68 years).
+ *
+ * @return The duration in units of SNTP timestamp fractions, truncated towards
+ * zero.
+ */
+/* @[define_sntp_fixedfromnanoseconds] */
+int64_t Sntp_FixedFromNanoseconds( int64_t nanoseconds );
+/* @[define_sntp_fixedfromnanoseconds] */
+
+#endif /* ifndef CORE_SNTP_FIXED_POINT_H_ */
@@ -0,0 +1,281 @@
+/*
+ * coreSNTP v1.0.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file core_sntp_health.h
+ * @brief API of health scores of time servers, built from the outcomes of the
+ * time requests to each server, so that the client prefers consistently good
+ * servers over the static priority order of the configured servers.
+ *
+ * The health of a server is made of exponentially decaying averages of its
+ * success rate, its Kiss-o'-Death rate, and its round-trip delay and jitter.
+ * They are combined into a score, and the server with the highest score is
+ * selected. The health of the servers can be saved, for example to
+ * non-volatile memory, and restored after a restart, so that the client starts
+ * with a known-good server.
+ */
+
+#ifndef CORE_SNTP_HEALTH_H_
+#define CORE_SNTP_HEALTH_H_
+
+/* Standard include. */
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/* Include coreSNTP Serializer header. */
+#include "core_sntp_serializer.h"
+
+/**
+ * @brief The highest health score, of a server that always responds with no
+ * delay. It is also the scale of the rates of #SntpServerHealth_t.
+ */
+#define SNTP_HEALTH_MAX_SCORE           ( 65536U )
+
+/**
+ * @brief The health score of a server without any recorded outcome. A server
+ * whose score falls below it is tried after the servers that have not been
+ * used yet.
+ */
+#define SNTP_HEALTH_UNKNOWN_SCORE       ( SNTP_HEALTH_MAX_SCORE / 2U )
+
+/**
+ * @brief The base-2 logarithm of the number of outcomes over which the health
+ * averages decay, so that every outcome has a weight of 1/8.
+ */
+#define SNTP_HEALTH_DECAY_SHIFT         ( 3U )
+
+/**
+ * @brief The round-trip delay, in microseconds, that halves the health score
+ * of a server, including #SNTP_HEALTH_JITTER_MULTIPLIER times its jitter.
+ */
+#define SNTP_HEALTH_REFERENCE_DELAY_US  ( 100000U )
+
+/**
+ * @brief The multiple of the jitter of a server added to its round-trip delay
+ * for its health score.
+ */
+#define SNTP_HEALTH_JITTER_MULTIPLIER   ( 4U )
+
+/**
+ * @brief The margin by which the health score of another server must exceed the
+ * score of the current server for the client to switch to it, so that servers
+ * of similar health are not alternated.
+ */
+#define SNTP_HEALTH_SWITCH_MARGIN       ( SNTP_HEALTH_MAX_SCORE / 16U )
+
+/**
+ * @brief The size, in bytes, of the saved health of a number of servers, for
+ * @ref Sntp_SaveServerHealth.
+ */
+#define SNTP_HEALTH_SAVED_SIZE( numOfServers )    ( 8U + ( ( size_t ) ( numOfServers ) * 24U ) )
+
+/**
+ * @ingroup core_sntp_struct_types
+ * @brief Structure representing the health of a time server.
+ *
+ * @note The members of this structure SHOULD NOT be accessed directly by the
+ * application.
+ */
+typedef struct SntpServerHealth
+{
+    /**
+     * @brief The identifier of the server, which matches saved health to the
+     * server. The client sets it from the name of the server.
+     */
+    uint32_t serverId;
+
+    /**
+     * @brief The decaying average of the successful outcomes, in parts of
+     * #SNTP_HEALTH_MAX_SCORE.
+     */
+    uint32_t successRate;
+
+    /**
+     * @brief The decaying average of the Kiss-o'-Death responses, in parts of
+     * #SNTP_HEALTH_MAX_SCORE.
+     */
+    uint32_t kissOfDeathRate;
+
+    /**
+     * @brief The decaying average of the round-trip delay, in microseconds.
+     */
+    uint32_t roundTripDelayUs;
+
+    /**
+     * @brief The decaying average of the deviation of the round-trip delay
+     * from its average, in microseconds.
+     */
+    uint32_t jitterUs;
+
+    /**
+     * @brief The number of responses whose delay is recorded, up to
+     * UINT32_MAX.
+     */
+    uint32_t numOfResponses;
+} SntpServerHealth_t;
+
+/**
+ * @brief Initializes the health of a list of time servers, without any
+ * recorded outcome.
+ *
+ * @param[out] pHealth The array of health records to initialize.
+ * @param[in] numOfServers The number of elements of @p pHealth.
+ *
+ * @return This function returns one of the following:
+ * - #SntpSuccess if the health records are initialized.
+ * - #SntpErrorBadParameter if @p pHealth is NULL or @p numOfServers is 0.
+ */
+/* @[define_sntp_initserverhealth] */
+SntpStatus_t Sntp_InitServerHealth( SntpServerHealth_t * pHealth,
+                                    size_t numOfServers );
+/* @[define_sntp_initserverhealth] */
+
+/**
+ * @brief Records the outcome of a time request in the health of its server.
+ *
+ * The outcomes are counted as follows:
+ * - #SntpSuccess, #SntpClockOffsetOverflow and #SntpRejectedResponseOutlier
+ * are successful responses, whose round-trip delay is recorded.
+ * - #SntpRejectedResponseChangeServer, #SntpRejectedResponseRetryWithBackoff
+ * and #SntpRejectedResponseOtherCode are Kiss-o'-Death responses, which are
+ * also failures.
+ * - #SntpErrorResponseTimeout, #SntpErrorNetworkFailure,
+ * #SntpErrorDnsFailure, #SntpInvalidResponse and #SntpServerNotAuthenticated
+ * are failures.
+ * - Any other status, which does not depend on the server, is not recorded.
+ *
+ * @param[in, out] pHealth The health of the server.
+ * @param[in] status The outcome of the time request.
+ * @param[in] roundTripDelayFractions The round-trip delay of a successful
+ * response, in SNTP timestamp fractions (2^-32 seconds), as in
+ * #SntpResponseData_t. It is ignored for other outcomes.
+ *
+ * @return This function returns one of the following:
+ * - #SntpSuccess if the outcome is recorded, or not counted.
+ * - #SntpErrorBadParameter if @p pHealth is NULL.
+ */
+/* @[define_sntp_recordserverhealth] */
+SntpStatus_t Sntp_RecordServerHealth( SntpServerHealth_t * pHealth,
+                                      SntpStatus_t status,
+                                      int64_t roundTripDelayFractions );
+/* @[define_sntp_recordserverhealth] */
+
+/**
+ * @brief Calculates the health score of a server.
+ *
+ * The score is the product of the success rate, the complement of the
+ * Kiss-o'-Death rate, and R / (R + D), where D is the round-trip delay plus
+ * #SNTP_HEALTH_JITTER_MULTIPLIER times the jitter, and R is
+ * #SNTP_HEALTH_REFERENCE_DELAY_US.
+ *
+ * @param[in] pHealth The health of the server.
+ * @param[out] pScore The score, from 0 to #SNTP_HEALTH_MAX_SCORE.
+ *
+ * @return This function returns one of the following:
+ * - #SntpSuccess if the score is calculated.
+ * - #SntpErrorBadParameter if @p pHealth or @p pScore is NULL.
+ */
+/* @[define_sntp_getserverhealthscore] */
+SntpStatus_t Sntp_GetServerHealthScore( const SntpServerHealth_t * pHealth,
+                                        uint32_t * pScore );
+/* @[define_sntp_getserverhealthscore] */
+
+/**
+ * @brief Selects the server with the highest health score.
+ *
+ * Servers with equal scores are selected in their order of priority, starting
+ * after @p excludedIndex, so that servers of unknown health are tried in turn.
+ *
+ * @param[in] pHealth The array of the health of the servers.
+ * @param[in] numOfServers The number of elements of @p pHealth.
+ * @param[in] excludedIndex The index of a server that is not selected, for
+ * example the server that just failed, or @p numOfServers to consider every
+ * server. It is still selected if it is the only server.
+ * @param[out] pServerIndex The index of the selected server.
+ *
+ * @return This function returns one of the following:
+ * - #SntpSuccess if a server is selected.
+ * - #SntpErrorBadParameter if @p pHealth or @p pServerIndex is NULL,
+ * @p numOfServers is 0, or @p excludedIndex is greater than @p numOfServers.
+ */
+/* @[define_sntp_selecthealthiestserver] */
+SntpStatus_t Sntp_SelectHealthiestServer( const SntpServerHealth_t * pHealth,
+                                          size_t numOfServers,
+                                          size_t excludedIndex,
+                                          size_t * pServerIndex );
+/* @[define_sntp_selecthealthiestserver] */
+
+/**
+ * @brief Saves the health of a list of servers to a buffer, in a portable
+ * format, for example to write it to non-volatile memory.
+ *
+ * @param[in] pHealth The array of the health of the servers.
+ * @param[in] numOfServers The number of elements of @p pHealth.
+ * @param[out] pBuffer The buffer for the saved health.
+ * @param[in] bufferSize The size of @p pBuffer, which MUST be at least
+ * #SNTP_HEALTH_SAVED_SIZE of @p numOfServers.
+ * @param[out] pSavedSize The number of bytes written to @p pBuffer.
+ *
+ * @return This function returns one of the following:
+ * - #SntpSuccess if the health is saved.
+ * - #SntpErrorBadParameter if any pointer is NULL or @p numOfServers is 0.
+ * - #SntpErrorBufferTooSmall if @p pBuffer is too small.
+ */
+/* @[define_sntp_saveserverhealth] */
+SntpStatus_t Sntp_SaveServerHealth( const SntpServerHealth_t * pHealth,
+                                    size_t numOfServers,
+                                    uint8_t * pBuffer,
+                                    size_t bufferSize,
+                                    size_t * pSavedSize );
+/* @[define_sntp_saveserverhealth] */
+
+/**
+ * @brief Restores the health of a list of servers saved with
+ * @ref Sntp_SaveServerHealth.
+ *
+ * The saved health of each server is matched to the server by its identifier,
+ * so that the list of servers can change between saving and restoring. The
+ * health of servers that are not in the saved health is not changed.
+ *
+ * @note The identifiers of the servers MUST be set before restoring, with
+ * @ref Sntp_SetServerHealth.
+ *
+ * @param[in, out] pHealth The array of the health of the servers.
+ * @param[in] numOfServers The number of elements of @p pHealth.
+ * @param[in] pBuffer The saved health.
+ * @param[in] savedSize The size of the saved health.
+ *
+ * @return This function returns one of the following:
+ * - #SntpSuccess if the health is restored.
+ * - #SntpErrorBadParameter if any pointer is NULL, @p numOfServers is 0, or
+ * the saved health is not valid. The health of the servers is then not
+ * changed.
+ */
+/* @[define_sntp_restoreserverhealth] */
+SntpStatus_t Sntp_RestoreServerHealth( SntpServerHealth_t * pHealth,
+                                       size_t numOfServers,
+                                       const uint8_t * pBuffer,
+                                       size_t savedSize );
+/* @[define_sntp_restoreserverhealth] */
+
+#endif /* ifndef CORE_SNTP_HEALTH_H_ */
@@ -0,0 +1,255 @@
+/*
+ * coreSNTP v1.0.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file core_sntp_histogram.h
+ * @brief API of fixed-memory histograms of the round-trip delay, clock offset
+ * and response latency of time servers.
+ *
+ * The histograms are log-linear, in the manner of HDR histograms: values below
+ * 2 * #SNTP_HISTOGRAM_SUB_BUCKETS microseconds are counted exactly, and every
+ * higher power of 2 range of values is split into #SNTP_HISTOGRAM_SUB_BUCKETS
+ * buckets of equal width. A percentile is therefore reported with a relative
+ * error below 1 / #SNTP_HISTOGRAM_SUB_BUCKETS over the whole range, with a
+ * fixed amount of memory, so that the tail of the distributions (for example,
+ * the 99th percentile of the round-trip delay) can be monitored on a device.
+ */
+
+#ifndef CORE_SNTP_HISTOGRAM_H_
+#define CORE_SNTP_HISTOGRAM_H_
+
+/* Standard include. */
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/* Include coreSNTP Serializer header. */
+#include "core_sntp_serializer.h"
+
+/**
+ * @brief The base-2 logarithm of the number of buckets in every power of 2
+ * range of values, which sets the precision of the histograms.
+ */
+#define SNTP_HISTOGRAM_SUB_BUCKET_BITS    ( 4U )
+
+/**
+ * @brief The number of buckets in every power of 2 range of values.
+ */
+#define SNTP_HISTOGRAM_SUB_BUCKETS        ( 1U << SNTP_HISTOGRAM_SUB_BUCKET_BITS )
+
+/**
+ * @brief The number of bits of the largest value, in microseconds, that the
+ * histograms distinguish (about 67 seconds). Larger values are counted in the
+ * last bucket.
+ */
+#define SNTP_HISTOGRAM_VALUE_BITS         ( 26U )
+
+/**
+ * @brief The number of buckets of a histogram.
+ */
+#define SNTP_HISTOGRAM_NUM_BUCKETS                                                 \
+    ( SNTP_HISTOGRAM_SUB_BUCKETS * ( ( SNTP_HISTOGRAM_VALUE_BITS + 1U ) - \
+                                     SNTP_HISTOGRAM_SUB_BUCKET_BITS ) )
+
+/**
+ * @brief The largest percentile, in parts per million, for reading the largest
+ * recorded value.
+ */
+#define SNTP_HISTOGRAM_MAX_PERCENTILE     ( 1000000U )
+
+/**
+ * @ingroup core_sntp_struct_types
+ * @brief Structure representing a histogram of values in microseconds.
+ *
+ * @note The members of this structure SHOULD NOT be accessed directly by the
+ * application.
+ */
+typedef struct SntpHistogram
+{
+    /**
+     * @brief The number of values in each bucket.
+     */
+    uint32_t counts[ SNTP_HISTOGRAM_NUM_BUCKETS ];
+
+    /**
+     * @brief The number of values in the histogram. Once it reaches UINT32_MAX,
+     * further values are discarded.
+     */
+    uint32_t totalCount;
+
+    /**
+     * @brief The smallest value, in microseconds.
+     */
+    uint32_t minValue;
+
+    /**
+     * @brief The largest value, in microseconds.
+     */
+    uint32_t maxValue;
+} SntpHistogram_t;
+
+/**
+ * @ingroup core_sntp_struct_types
+ * @brief Structure representing the histograms of a time server.
+ *
+ * The histograms are updated by the @ref Sntp_ReceiveTimeResponse API when set
+ * with @ref Sntp_SetServerHistograms, and read with
+ * @ref Sntp_GetHistogramPercentile.
+ */
+typedef struct SntpServerHistograms
+{
+    /**
+     * @brief The round-trip network delay of the responses, excluding the
+     * processing time of the server.
+     */
+    SntpHistogram_t roundTripDelay;
+
+    /**
+     * @brief The magnitude of the clock offset of the responses.
+     */
+    SntpHistogram_t clockOffset;
+
+    /**
+     * @brief The time from sending a request to receiving its response,
+     * including the processing time of the server, as measured with the system
+     * time.
+     */
+    SntpHistogram_t responseLatency;
+} SntpServerHistograms_t;
+
+/**
+ * @brief Initializes a histogram without any values.
+ *
+ * @param[out] pHistogram The histogram to initialize.
+ *
+ * @return This function returns one of the following:
+ * - #SntpSuccess if the histogram is initialized.
+ * - #SntpErrorBadParameter if @p pHistogram is NULL.
+ */
+/* @[define_sntp_inithistogram] */
+SntpStatus_t Sntp_InitHistogram( SntpHistogram_t * pHistogram );
+/* @[define_sntp_inithistogram] */
+
+/**
+ * @brief Initializes the histograms of a list of time servers.
+ *
+ * @param[out] pHistograms The array of histograms to initialize.
+ * @param[in] numOfServers The number of elements of @p pHistograms.
+ *
+ * @return This function returns one of the following:
+ * - #SntpSuccess if the histograms are initialized.
+ * - #SntpErrorBadParameter if @p pHistograms is NULL or @p numOfServers is 0.
+ */
+/* @[define_sntp_initserverhistograms] */
+SntpStatus_t Sntp_InitServerHistograms( SntpServerHistograms_t * pHistograms,
+                                        size_t numOfServers );
+/* @[define_sntp_initserverhistograms] */
+
+/**
+ * @brief Records a value in a histogram.
+ *
+ * @param[in, out] pHistogram The histogram.
+ * @param[in] valueUs The value, in microseconds.
+ *
+ * @return This function returns one of the following:
+ * - #SntpSuccess if the value is recorded.
+ * - #SntpErrorBadParameter if @p pHistogram is NULL.
+ */
+/* @[define_sntp_recordhistogramvalue] */
+SntpStatus_t Sntp_RecordHistogramValue( SntpHistogram_t * pHistogram,
+                                        uint32_t valueUs );
+/* @[define_sntp_recordhistogramvalue] */
+
+/**
+ * @brief Records a duration in SNTP timestamp fractions in a histogram. A
+ * negative duration is recorded as its magnitude.
+ *
+ * @param[in, out] pHistogram The histogram.
+ * @param[in] durationFractions The duration, in SNTP timestamp fractions
+ * (2^-32 seconds), as in #SntpResponseData_t.
+ *
+ * @return This function returns one of the following:
+ * - #SntpSuccess if the duration is recorded.
+ * - #SntpErrorBadParameter if @p pHistogram is NULL.
+ */
+/* @[define_sntp_recordhistogramduration] */
+SntpStatus_t Sntp_RecordHistogramDuration( SntpHistogram_t * pHistogram,
+                                           int64_t durationFractions );
+/* @[define_sntp_recordhistogramduration] */
+
+/**
+ * @brief Adds the values of a histogram to another, for example, to combine
+ * the histograms of several servers or devices.
+ *
+ * @param[in, out] pTotal The histogram to add to.
+ * @param[in] pPart The histogram to add.
+ *
+ * @return This function returns one of the following:
+ * - #SntpSuccess if the histograms are merged.
+ * - #SntpErrorBadParameter if @p pTotal or @p pPart is NULL.
+ */
+/* @[define_sntp_mergehistograms] */
+SntpStatus_t Sntp_MergeHistograms( SntpHistogram_t * pTotal,
+                                   const SntpHistogram_t * pPart );
+/* @[define_sntp_mergehistograms] */
+
+/**
+ * @brief Reads the number of values in a histogram.
+ *
+ * @param[in] pHistogram The histogram.
+ * @param[out] pCount The number of values.
+ *
+ * @return This function returns one of the following:
+ * - #SntpSuccess if the count is read.
+ * - #SntpErrorBadParameter if @p pHistogram or @p pCount is NULL.
+ */
+/* @[define_sntp_gethistogramcount] */
+SntpStatus_t Sntp_GetHistogramCount( const SntpHistogram_t * pHistogram,
+                                     uint32_t * pCount );
+/* @[define_sntp_gethistogramcount] */
+
+/**
+ * @brief Reads a percentile of the values in a histogram.
+ *
+ * The reported value is the highest value of the bucket that holds the
+ * percentile, so that it is not lower than the exact percentile, and is
+ * within the recorded range of values. The percentile 0 reports the smallest
+ * value, and #SNTP_HISTOGRAM_MAX_PERCENTILE reports the largest value.
+ *
+ * @param[in] pHistogram The histogram.
+ * @param[in] percentilePpm The percentile, in parts per million of the values.
+ * For example, 990000 for the 99th percentile.
+ * @param[out] pValueUs The value at the percentile, in microseconds.
+ *
+ * @return This function returns one of the following:
+ * - #SntpSuccess if the percentile is read.
+ * - #SntpErrorBadParameter if @p pHistogram or @p pValueUs is NULL, or
+ * @p percentilePpm is greater than #SNTP_HISTOGRAM_MAX_PERCENTILE.
+ * - #SntpInsufficientSamples if the histogram has no values.
+ */
+/* @[define_sntp_gethistogrampercentile] */
+SntpStatus_t Sntp_GetHistogramPercentile( const SntpHistogram_t * pHistogram,
+                                          uint32_t percentilePpm,
+                                          uint32_t * pValueUs );
+/* @[define_sntp_gethistogrampercentile] */
+
+#endif /* ifndef CORE_SNTP_HISTOGRAM_H_ */
@@ -0,0 +1,47 @@
+/*
+ * coreSNTP v1.0.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file core_sntp_math.h
+ * @brief Integer math utilities that are shared by the modules of the coreSNTP
+ * library.
+ *
+ * These functions are internal to the library, and are not part of its API.
+ */
+
+#ifndef CORE_SNTP_MATH_H_
+#define CORE_SNTP_MATH_H_
+
+/* Standard include. */
+#include <stdint.h>
+
+/**
+ * @brief Calculates the integer square root of a 64-bit value, such as the
+ * deviation of a variance.
+ *
+ * @param[in] value The value.
+ *
+ * @return The largest integer whose square is lower than or equal to @p value.
+ */
+uint64_t Sntp_SquareRoot64( uint64_t value );
+
+#endif /* ifndef CORE_SNTP_MATH_H_ */
@@ -0,0 +1,302 @@
+/*
+ * coreSNTP v1.0.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file core_sntp_metrics.h
+ * @brief API of the statistics of an SNTP client, and of their rendering in the
+ * Prometheus text exposition format.
+ *
+ * The statistics are kept for the context as a whole and for each configured
+ * server, in structures with public members that the application can read
+ * directly. The client updates them when set with @ref Sntp_SetMetrics, and
+ * @ref Sntp_RenderMetrics writes them into a buffer of the application without
+ * allocating memory, for example, to serve them over HTTP.
+ */
+
+#ifndef CORE_SNTP_METRICS_H_
+#define CORE_SNTP_METRICS_H_
+
+/* Standard include. */
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/* Include coreSNTP Serializer header. */
+#include "core_sntp_serializer.h"
+
+/**
+ * @ingroup core_sntp_enum_types
+ * @brief The Kiss-o'-Death codes that are counted separately.
+ */
+typedef enum SntpMetricsKissCode
+{
+    SntpMetricsKissDeny = 0,  /**< @brief The "DENY" code: access denied by the server. */
+    SntpMetricsKissRstr,      /**< @brief The "RSTR" code: access restricted by the server. */
+    SntpMetricsKissRate,      /**< @brief The "RATE" code: the poll rate is too high. */
+    SntpMetricsKissOther,     /**< @brief Any other code. */
+    SntpMetricsNumOfKissCodes /**< @brief The number of counted codes. */
+} SntpMetricsKissCode_t;
+
+/**
+ * @ingroup core_sntp_enum_types
+ * @brief The reasons for which server responses are not used.
+ */
+typedef enum SntpMetricsInvalidReason
+{
+    SntpMetricsInvalidMalformed = 0,   /**< @brief The response is shorter than an SNTP packet. */
+    SntpMetricsInvalidProtocol,        /**< @brief The response fails the protocol checks, for
+                                        * example, it does not match the last request. */
+    SntpMetricsInvalidUnauthenticated, /**< @brief The server cannot be authenticated. */
+    SntpMetricsInvalidOutlier,         /**< @brief The response is rejected by the outlier gate. */
+    SntpMetricsNumOfInvalidReasons     /**< @brief The number of reasons. */
+} SntpMetricsInvalidReason_t;
+
+/**
+ * @ingroup core_sntp_struct_types
+ * @brief Structure representing the statistics of a server, or of all the
+ * servers of a context.
+ *
+ * The members of this structure can be read directly by the application.
+ */
+typedef struct SntpServerMetrics
+{
+    /**
+     * @brief The DNS name of the server, or NULL for the statistics of the
+     * context.
+     */
+    const char * pServerName;
+
+    /**
+     * @brief The number of time requests sent (polls).
+     */
+    uint64_t requests;
+
+    /**
+     * @brief The number of responses used to correct time (successes).
+     */
+    uint64_t acceptedResponses;
+
+    /**
+     * @brief The number of requests without a response within the response
+     * timeout.
+     */
+    uint64_t timeouts;
+
+    /**
+     * @brief The number of failures to send a request or receive a response.
+     */
+    uint64_t networkErrors;
+
+    /**
+     * @brief The number of failures to resolve the DNS name of the server.
+     */
+    uint64_t dnsFailures;
+
+    /**
+     * @brief The number of Kiss-o'-Death responses, by code.
+     */
+    uint64_t kissOfDeath[ SntpMetricsNumOfKissCodes ];
+
+    /**
+     * @brief The number of responses that are not used, by reason.
+     */
+    uint64_t invalidResponses[ SntpMetricsNumOfInvalidReasons ];
+
+    /**
+     * @brief Whether a response has been accepted, so that the following
+     * members are valid.
+     */
+    bool isSynchronized;
+
+    /**
+     * @brief The clock offset of the last accepted response, in nanoseconds.
+     * It is not updated by a response whose clock offset overflows.
+     */
+    int64_t clockOffsetNs;
+
+    /**
+     * @brief The jitter of the clock offsets, in nanoseconds: the root mean
+     * square of the differences between successive offsets, exponentially
+     * averaged.
+     */
+    int64_t jitterNs;
+
+    /**
+     * @brief The mean square of the differences between successive offsets, in
+     * squared nanoseconds, from which #SntpServerMetrics_t.jitterNs is
+     * calculated.
+     */
+    uint64_t jitterVariance;
+
+    /**
+     * @brief The round-trip delay of the last accepted response, in
+     * nanoseconds.
+     */
+    int64_t roundTripDelayNs;
+
+    /**
+     * @brief The stratum of the server in the last accepted response.
+     */
+    uint8_t stratum;
+
+    /**
+     * @brief The system time of receiving the last accepted response, from
+     * which the age of the last synchronization is calculated.
+     */
+    SntpTimestamp_t lastSyncTime;
+} SntpServerMetrics_t;
+
+/**
+ * @ingroup core_sntp_struct_types
+ * @brief Structure representing the statistics of a client context and of its
+ * servers.
+ *
+ * The members of this structure can be read directly by the application.
+ */
+typedef struct SntpMetrics
+{
+    /**
+     * @brief The statistics of all the servers of the context. The clock
+     * offset, jitter, delay and stratum are those of the last accepted
+     * response of any server.
+     */
+    SntpServerMetrics_t context;
+
+    /**
+     * @brief The statistics of each server, in the order of configuration of
+     * the servers, or NULL to keep the statistics of the context only.
+     */
+    SntpServerMetrics_t * pServers;
+
+    /**
+     * @brief The number of elements of #SntpMetrics.pServers.
+     */
+    size_t numOfServers;
+
+    /**
+     * @brief The index of the server of the last request or response.
+     */
+    size_t currentServerIndex;
+} SntpMetrics_t;
+
+/**
+ * @brief Initializes the statistics of a context, with all counters at zero.
+ *
+ * @param[out] pMetrics The statistics to initialize.
+ * @param[out] pServerMetrics The array of statistics of each server, or NULL to
+ * keep the statistics of the context only. The array MUST stay in scope for
+ * all the time of use of @p pMetrics.
+ * @param[in] numOfServers The number of elements of @p pServerMetrics.
+ *
+ * @return This function returns one of the following:
+ * - #SntpSuccess if the statistics are initialized.
+ * - #SntpErrorBadParameter if @p pMetrics is NULL, or @p numOfServers is 0 with
+ * a @p pServerMetrics array, or not 0 without it.
+ */
+/* @[define_sntp_initmetrics] */
+SntpStatus_t Sntp_InitMetrics( SntpMetrics_t * pMetrics,
+                               SntpServerMetrics_t * pServerMetrics,
+                               size_t numOfServers );
+/* @[define_sntp_initmetrics] */
+
+/**
+ * @brief Records the outcome of sending a time request to a server.
+ *
+ * This function is called by the @ref Sntp_SendTimeRequest API for the
+ * statistics set with @ref Sntp_SetMetrics.
+ *
+ * @param[in, out] pMetrics The statistics.
+ * @param[in] serverIndex The index of the server.
+ * @param[in] status The status returned by @ref Sntp_SendTimeRequest. Only
+ * #SntpSuccess, #SntpErrorDnsFailure and #SntpErrorNetworkFailure are counted.
+ *
+ * @return This function returns one of the following:
+ * - #SntpSuccess if the outcome is recorded.
+ * - #SntpErrorBadParameter if @p pMetrics is NULL.
+ */
+/* @[define_sntp_recordrequestmetrics] */
+SntpStatus_t Sntp_RecordRequestMetrics( SntpMetrics_t * pMetrics,
+                                        size_t serverIndex,
+                                        SntpStatus_t status );
+/* @[define_sntp_recordrequestmetrics] */
+
+/**
+ * @brief Records the outcome of waiting for the response of a server.
+ *
+ * This function is called by the @ref Sntp_ReceiveTimeResponse API for the
+ * statistics set with @ref Sntp_SetMetrics.
+ *
+ * @param[in, out] pMetrics The statistics.
+ * @param[in] serverIndex The index of the server.
+ * @param[in] status The status of the response, as returned by
+ * @ref Sntp_ReceiveTimeResponse.
+ * @param[in] pParsedResponse The parsed response, for the statuses of accepted
+ * and Kiss-o'-Death responses. It can be NULL for other statuses.
+ * @param[in] pResponseRxTime The system time of receiving the response, for the
+ * statuses of accepted responses. It can be NULL for other statuses.
+ *
+ * @return This function returns one of the following:
+ * - #SntpSuccess if the outcome is recorded.
+ * - #SntpErrorBadParameter if @p pMetrics is NULL, or @p pParsedResponse or
+ * @p pResponseRxTime is NULL for a status that needs it.
+ */
+/* @[define_sntp_recordresponsemetrics] */
+SntpStatus_t Sntp_RecordResponseMetrics( SntpMetrics_t * pMetrics,
+                                         size_t serverIndex,
+                                         SntpStatus_t status,
+                                         const SntpResponseData_t * pParsedResponse,
+                                         const SntpTimestamp_t * pResponseRxTime );
+/* @[define_sntp_recordresponsemetrics] */
+
+/**
+ * @brief Writes the statistics of a context in the Prometheus text exposition
+ * format, terminated with a NUL character.
+ *
+ * The statistics of the context are named `sntp_client_*`, and those of each
+ * server `sntp_server_*` with a `server` label. The gauges of the offset,
+ * jitter, delay, stratum and age of the last synchronization are omitted until
+ * a response is accepted.
+ *
+ * @param[in] pMetrics The statistics.
+ * @param[in] pCurrentTime The current system time, for the age of the last
+ * synchronization, or NULL to omit the age.
+ * @param[out] pBuffer The buffer to write into.
+ * @param[in] bufferSize The size of @p pBuffer.
+ * @param[out] pTextLength The length of the text, excluding the NUL character.
+ * If @p pBuffer is too small, the length that the text would have.
+ *
+ * @return This function returns one of the following:
+ * - #SntpSuccess if the statistics are written.
+ * - #SntpErrorBadParameter if @p pMetrics, @p pBuffer or @p pTextLength is
+ * NULL.
+ * - #SntpErrorBufferTooSmall if @p pBuffer cannot hold the text and the NUL
+ * character. The buffer then holds as much of the text as fits.
+ */
+/* @[define_sntp_rendermetrics] */
+SntpStatus_t Sntp_RenderMetrics( const SntpMetrics_t * pMetrics,
+                                 const SntpTimestamp_t * pCurrentTime,
+                                 char * pBuffer,
+                                 size_t bufferSize,
+                                 size_t * pTextLength );
+/* @[define_sntp_rendermetrics] */
+
+#endif /* ifndef CORE_SNTP_METRICS_H_ */
@@ -0,0 +1,177 @@
+/*
+ * coreSNTP v1.0.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file core_sntp_poll_planner.h
+ * @brief API of a planner of the times of periodic time queries, which spreads
+ * the queries of a fleet of devices evenly over the poll interval.
+ *
+ * Devices that start together (for example, after a power outage at a site) and
+ * calculate the same poll interval, with @ref Sntp_CalculatePollInterval, would
+ * otherwise query the time servers in synchronized bursts at every interval. The
+ * planner places the polls of each device on a grid of the poll interval in SNTP
+ * time, at a phase that is derived from an identifier of the device, such as its
+ * MAC address or serial number. The phase is deterministic, so the load of the
+ * fleet stays evenly spread over the interval across restarts of the devices,
+ * regardless of their start times. Each poll is also delayed by a bounded random
+ * jitter, so that devices with close phases do not stay synchronized.
+ */
+
+#ifndef CORE_SNTP_POLL_PLANNER_H_
+#define CORE_SNTP_POLL_PLANNER_H_
+
+/* Standard include. */
+#include <stdint.h>
+#include <stddef.h>
+
+/* Include coreSNTP Serializer header. */
+#include "core_sntp_serializer.h"
+
+/**
+ * @brief The largest jitter of the polls, as a percentage of the poll interval,
+ * that can be configured in a poll planner.
+ *
+ * The jitter only delays the polls, so successive polls are at least three
+ * quarters of the poll interval apart.
+ */
+#define SNTP_POLL_PLANNER_MAX_JITTER_PERCENT    ( 25U )
+
+/**
+ * @brief The default jitter of the polls, as a percentage of the poll interval.
+ */
+#define SNTP_POLL_PLANNER_DEFAULT_JITTER_PERCENT    ( 5U )
+
+/**
+ * @brief The largest poll interval, in seconds, of a poll planner, which is
+ * half of an SNTP era.
+ */
+#define SNTP_POLL_PLANNER_MAX_INTERVAL_SECS    ( 0x7FFFFFFFU )
+
+/**
+ * @ingroup core_sntp_struct_types
+ * @brief Structure representing the poll schedule of a device.
+ *
+ * @note The members of this structure SHOULD NOT be accessed directly by the
+ * application.
+ */
+typedef struct SntpPollPlanner
+{
+    /**
+     * @brief The hash of the identifier of the device, which sets the phase of
+     * the polls within the poll interval.
+     */
+    uint32_t deviceHash;
+
+    /**
+     * @brief The state of the pseudo-random generator of the jitter, which is
+     * seeded from the identifier of the device.
+     */
+    uint32_t jitterState;
+
+    /**
+     * @brief The poll interval, in seconds.
+     */
+    uint32_t pollIntervalSecs;
+
+    /**
+     * @brief The largest jitter of the polls, as a percentage of the poll
+     * interval.
+     */
+    uint32_t jitterPercent;
+} SntpPollPlanner_t;
+
+/**
+ * @brief Initializes the poll schedule of a device.
+ *
+ * @param[out] pPlanner The poll planner to initialize.
+ * @param[in] pDeviceId An identifier of the device that is unique in the fleet,
+ * such as its MAC address or serial number.
+ * @param[in] deviceIdLength The length of @p pDeviceId in bytes.
+ * @param[in] pollIntervalSecs The poll interval in seconds, for example, as
+ * calculated with @ref Sntp_CalculatePollInterval. It MUST be non-zero, and at
+ * most #SNTP_POLL_PLANNER_MAX_INTERVAL_SECS.
+ * @param[in] jitterPercent The largest delay of the polls, as a percentage of
+ * the poll interval, for example, #SNTP_POLL_PLANNER_DEFAULT_JITTER_PERCENT. It
+ * MUST be at most #SNTP_POLL_PLANNER_MAX_JITTER_PERCENT.
+ *
+ * @return This function returns one of the following:
+ * - #SntpSuccess if the poll planner is initialized.
+ * - #SntpErrorBadParameter for an invalid parameter.
+ */
+/* @[define_sntp_initpollplanner] */
+SntpStatus_t Sntp_InitPollPlanner( SntpPollPlanner_t * pPlanner,
+                                   const void * pDeviceId,
+                                   size_t deviceIdLength,
+                                   uint32_t pollIntervalSecs,
+                                   uint32_t jitterPercent );
+/* @[define_sntp_initpollplanner] */
+
+/**
+ * @brief Changes the poll interval of a poll schedule, for example, when the
+ * interval is adapted to the stability of the local clock.
+ *
+ * The phase of the device keeps its relative position within the new interval,
+ * so the load of the fleet remains evenly spread.
+ *
+ * @param[in, out] pPlanner The poll planner.
+ * @param[in] pollIntervalSecs The poll interval in seconds. It MUST be non-zero,
+ * and at most #SNTP_POLL_PLANNER_MAX_INTERVAL_SECS.
+ *
+ * @return This function returns one of the following:
+ * - #SntpSuccess if the poll interval is changed.
+ * - #SntpErrorBadParameter for an invalid parameter.
+ */
+/* @[define_sntp_setpollplannerinterval] */
+SntpStatus_t Sntp_SetPollPlannerInterval( SntpPollPlanner_t * pPlanner,
+                                          uint32_t pollIntervalSecs );
+/* @[define_sntp_setpollplannerinterval] */
+
+/**
+ * @brief Plans the time of the next poll of a device.
+ *
+ * The next poll is at the first slot of the device that is later than the
+ * current time, delayed by a random jitter of up to the configured percentage
+ * of the poll interval. Calling this function right after each poll gives one
+ * poll per interval.
+ *
+ * @note The first poll after the start of a device is also placed at its
+ * phase, so a fleet that starts together spreads its first queries over one
+ * poll interval. An application that cannot wait for the time at start-up can
+ * query a time server once before following the schedule.
+ *
+ * @param[in, out] pPlanner The poll planner.
+ * @param[in] pCurrentTime The current time of the system, expressed as time
+ * since the SNTP epoch.
+ * @param[out] pNextPollTime This is filled with the time of the next poll, in
+ * the same timescale as @p pCurrentTime.
+ *
+ * @return This function returns one of the following:
+ * - #SntpSuccess if the next poll is planned.
+ * - #SntpErrorBadParameter for an invalid parameter.
+ */
+/* @[define_sntp_plannextpoll] */
+SntpStatus_t Sntp_PlanNextPoll( SntpPollPlanner_t * pPlanner,
+                                const SntpTimestamp_t * pCurrentTime,
+                                SntpTimestamp_t * pNextPollTime );
+/* @[define_sntp_plannextpoll] */
+
+#endif /* ifndef CORE_SNTP_POLL_PLANNER_H_ */
@@ -31,8 +31,12 @@
 #ifndef CORE_SNTP_SERIALIZER_H_
 #define CORE_SNTP_SERIALIZER_H_
 
-/* Standard include. */
+/* Standard includes. */
 #include <stdint.h>
+#include <stddef.h>
+
+/* Include config defaults header to get default values of configurations. */
+#include "core_sntp_config_defaults.h"
 
 /**
  * @brief The base packet size of request and response of the (S)NTP protocol.
@@ -97,6 +101,24 @@
  */
 #define UNIX_TIME_SECS_AT_SNTP_ERA_1_SMALLEST_TIME    ( 2085978496U )
 
+/**
+ * @brief The default pivot time, in Unix seconds, for resolving the SNTP era of
+ * timestamps with @ref Sntp_ConvertToUnixTime64. This is 1 Jan 2021 0:00:00 UTC,
+ * which resolves timestamps between Dec 1952 and Jan 2089.
+ *
+ * @note Applications that run past 2089 SHOULD use a later pivot time, for
+ * example, the build time of the application. For more information, refer to
+ * [RFC 5905 Section 6](https://tools.ietf.org/html/rfc5905#section-6).
+ */
+#define SNTP_DEFAULT_ERA_PIVOT_UNIX_SECS              ( ( int64_t ) 1609459200 )
+
+/**
+ * @brief The magnitude of the largest pivot time, in Unix seconds, supported by
+ * @ref Sntp_ConvertToUnixTime64, which keeps the converted time within 64 bits
+ * (about 292 billion years).
+ */
+#define SNTP_MAX_ERA_PIVOT_UNIX_SECS                  ( INT64_MAX / 2 )
+
 /**
  * @brief The fixed-length of any Kiss-o'-Death message ASCII code sent
  * in an SNTP server response.
@@ -211,7 +233,55 @@ typedef enum SntpStatus
      * in either generating authentication data for SNTP request OR validating the authentication
      * data in SNTP response from server.
      */
-    SntpErrorAuthFailure
+    SntpErrorAuthFailure,
+
+    /**
+     * @brief A virtual clock has not yet received a clock offset sample from a
+     * time server, and therefore, cannot provide corrected time.
+     */
+    SntpClockNotSynchronized,
+
+    /**
+     * @brief A platform call for reading or adjusting the system clock failed.
+     */
+    SntpErrorSystemClockFailure,
+
+    /**
+     * @brief Failure from the user-supplied DNS resolution interface,
+     * @ref SntpResolveDns_t, in resolving the address of the time server.
+     */
+    SntpErrorDnsFailure,
+
+    /**
+     * @brief Failure from the user-supplied transport interface,
+     * @ref UdpTransportInterface_t, in sending a time request or receiving a
+     * time response.
+     */
+    SntpErrorNetworkFailure,
+
+    /**
+     * @brief No response has yet been received from the server for the last time
+     * request, and the response timeout has not expired.
+     */
+    SntpNoResponseReceived,
+
+    /**
+     * @brief No response has been received from the server for the last time
+     * request within the response timeout.
+     */
+    SntpErrorResponseTimeout,
+
+    /**
+     * @brief A server response has been rejected by the outlier gate, as its
+     * clock offset or round-trip delay deviates too far from recent samples.
+     */
+    SntpRejectedResponseOutlier,
+
+    /**
+     * @brief Not enough clock offset samples have been received to calculate
+     * the requested estimate.
+     */
+    SntpInsufficientSamples
 } SntpStatus_t;
 
 /**
@@ -301,8 +371,77 @@ typedef struct SntpResponse
      * API will return #SntpClockOffsetOverflow.
      */
     int32_t clockOffsetSec;
+
+    /**
+     * @brief The offset of the system clock relative to the server time, in
+     * units of SNTP timestamp fractions (i.e. 2^(-32) seconds), calculated with
+     * the full resolution of the SNTP timestamps.
+     *
+     * This is the same on-wire offset as #SntpResponseData_t.clockOffsetSec,
+     * but without truncation to whole seconds. It can be used for sub-second
+     * clock discipline, for example, with the @ref Sntp_UpdateVirtualClock API.
+     *
+     * @note If the clock offset cannot be calculated due to overflow (i.e.
+     * #SntpResponseData_t.clockOffsetSec is #SNTP_CLOCK_OFFSET_OVERFLOW), this
+     * value will be zero.
+     */
+    int64_t clockOffsetFractions;
+
+    /**
+     * @brief The round-trip delay of the request and response packets on the
+     * network, in units of SNTP timestamp fractions, excluding the processing
+     * time of the server.
+     *
+     * A sample with a large delay, for example, from a congested network
+     * queue, usually has a large error in its clock offset. The delay can be
+     * used to reject such samples with the @ref Sntp_FilterSample API.
+     *
+     * @note If the timestamps of the response are inconsistent, which results
+     * in a negative delay, this value will be zero.
+     */
+    int64_t roundTripDelayFractions;
+
+    /**
+     * @brief The stratum of the server: 1 for a server with a reference clock,
+     * and one more than the stratum of its upstream server otherwise. This
+     * value is 0 for a Kiss-o'-Death response.
+     */
+    uint8_t stratum;
 } SntpResponseData_t;
 
+/**
+ * @ingroup core_sntp_struct_types
+ * @brief Structure representing one contiguous segment of an SNTP packet,
+ * for scatter-gather I/O.
+ *
+ * A packet is an array of segments, for example, the header, the extension
+ * fields and the Message Authentication Code (MAC), each in its own buffer.
+ * The members match those of the POSIX `struct iovec`, so the array maps
+ * directly onto the `msg_iov` array of the `sendmsg` and `recvmsg` calls.
+ */
+typedef struct SntpIoVector
+{
+    void * pBase;  /**< @brief The start of the segment. */
+    size_t length; /**< @brief The size of the segment in bytes. */
+} SntpIoVector_t;
+
+/**
+ * @ingroup core_sntp_struct_types
+ * @brief Structure representing the location of the bytes that follow the
+ * header of a packet received into an array of segments, such as extension
+ * fields and the Message Authentication Code (MAC).
+ *
+ * The bytes start at #SntpPacketTail_t.offset in the segment at
+ * #SntpPacketTail_t.segmentIndex, and continue across the following segments,
+ * so that they can be authenticated in place.
+ */
+typedef struct SntpPacketTail
+{
+    size_t segmentIndex; /**< @brief The segment of the first byte after the header. */
+    size_t offset;       /**< @brief The offset of that byte in its segment. */
+    size_t length;       /**< @brief The number of received bytes after the header. */
+} SntpPacketTail_t;
+
 
 /**
  * @brief Serializes an SNTP request packet to use for querying a
@@ -405,6 +544,84 @@ SntpStatus_t Sntp_DeserializeResponse( const SntpTimestamp_t * pRequestTime,
                                        SntpResponseData_t * pParsedResponse );
 /* @[define_sntp_deserializeresponse] */
 
+/**
+ * @brief Serializes an SNTP request packet into an array of segments, for
+ * sending with scatter-gather I/O.
+ *
+ * The request header is serialized, as with @ref Sntp_SerializeRequest, into
+ * the first segment, which holds exactly the #SNTP_PACKET_BASE_SIZE bytes of
+ * the header. The remaining segments of the packet, such as extension fields
+ * and authentication data, are not modified, so the application can build them
+ * in place in their own buffers, without copying them after the header.
+ *
+ * @param[in, out] pRequestTime The current time of the system, expressed as time
+ * since the SNTP epoch. The function will use this parameter to return the
+ * timestamp serialized in the SNTP request.
+ * @param[in] randomNumber A random number for use in the SNTP request packet to
+ * protect against replay attacks.
+ * @param[in] pSegments The segments of the packet, in order. The first segment
+ * MUST be #SNTP_PACKET_BASE_SIZE bytes in size.
+ * @param[in] segmentCount The number of segments in @p pSegments.
+ * @param[out] pPacketSize This is filled with the total size of the packet.
+ *
+ * @note NTP extension fields and MACs are aligned to 32 bits, so the size of
+ * each segment MUST be a multiple of 4 bytes.
+ *
+ * @return This function returns one of the following:
+ * - #SntpSuccess when serialization operation is successful.
+ * - #SntpErrorBadParameter if an invalid parameter is passed, a segment has no
+ * memory, the size of a segment is not a multiple of 4 bytes, or the first
+ * segment is larger than #SNTP_PACKET_BASE_SIZE bytes.
+ * - #SntpErrorBufferTooSmall if the first segment does not have the minimum size
+ * for serializing an SNTP request packet.
+ */
+/* @[define_sntp_serializerequestvector] */
+SntpStatus_t Sntp_SerializeRequestVector( SntpTimestamp_t * pRequestTime,
+                                          uint32_t randomNumber,
+                                          const SntpIoVector_t * pSegments,
+                                          size_t segmentCount,
+                                          size_t * pPacketSize );
+/* @[define_sntp_serializerequestvector] */
+
+/**
+ * @brief De-serializes an SNTP response received with scatter-gather I/O into
+ * an array of segments.
+ *
+ * The response is validated and parsed as with @ref Sntp_DeserializeResponse.
+ * When the first segment holds the whole #SNTP_PACKET_BASE_SIZE bytes header,
+ * the header is parsed in place; otherwise, it is gathered from the segments
+ * into a temporary copy. The remaining bytes of the packet, such as extension
+ * fields and authentication data, are left to the application in their own
+ * segments, at the location returned in @p pTail.
+ *
+ * @param[in] pRequestTime The system time used in the SNTP request packet
+ * that is associated with the server response.
+ * @param[in] pResponseRxTime The time of the system, expressed as time since the
+ * SNTP epoch, at receiving SNTP response from server.
+ * @param[in] pSegments The segments that the response was received into, in order.
+ * @param[in] segmentCount The number of segments in @p pSegments.
+ * @param[in] receivedSize The number of bytes received into the segments, for
+ * example, as returned by `recvmsg`.
+ * @param[out] pParsedResponse The information parsed from the SNTP response packet.
+ * @param[out] pTail This is filled with the location of the received bytes
+ * after the header when the whole header is received, including for a rejected
+ * response. It can be NULL if the application does not use these bytes.
+ *
+ * @return This function returns the same codes as @ref Sntp_DeserializeResponse.
+ * The #SntpErrorBadParameter code is also returned if a segment of non-zero size
+ * has no memory, and the #SntpErrorBufferTooSmall code if fewer than
+ * #SNTP_PACKET_BASE_SIZE bytes were received in the segments.
+ */
+/* @[define_sntp_deserializeresponsevector] */
+SntpStatus_t Sntp_DeserializeResponseVector( const SntpTimestamp_t * pRequestTime,
+                                             const SntpTimestamp_t * pResponseRxTime,
+                                             const SntpIoVector_t * pSegments,
+                                             size_t segmentCount,
+                                             size_t receivedSize,
+                                             SntpResponseData_t * pParsedResponse,
+                                             SntpPacketTail_t * pTail );
+/* @[define_sntp_deserializeresponsevector] */
+
 /**
  * @brief Utility to calculate the poll interval of sending periodic time queries
  * to servers to achieve a desired system clock accuracy for a given
@@ -479,4 +696,66 @@ SntpStatus_t Sntp_ConvertToUnixTime( const SntpTimestamp_t * pSntpTime,
                                      uint32_t * pUnixTimeMicrosecs );
 /* @[define_sntp_ConvertToUnixTime] */
 
+/**
+ * @brief Utility to convert an SNTP timestamp to 64-bit UNIX time with
+ * nanoseconds resolution, for any SNTP era.
+ *
+ * An SNTP timestamp represents time modulo 2^32 seconds (~136 years), so the
+ * SNTP era of the timestamp is resolved with a pivot time: the timestamp is
+ * converted to the time within 2^31 seconds (~68 years) before or after the
+ * pivot time. For example, with the pivot time of
+ * #SNTP_DEFAULT_ERA_PIVOT_UNIX_SECS, timestamps of SNTP era 1 (from
+ * 7 Feb 2036 6h 28m 16s) are converted up to Jan 2089, beyond the limits of
+ * 32-bit UNIX time in 2038 and 2106.
+ *
+ * @param[in] pSntpTime The SNTP timestamp to convert to UNIX time.
+ * @param[in] pivotUnixTimeSecs The pivot time, in UNIX seconds, which MUST be
+ * within +/- #SNTP_MAX_ERA_PIVOT_UNIX_SECS.
+ * @param[out] pUnixTimeSecs This will be filled with the seconds part of the
+ * UNIX time equivalent of the SNTP time, @p pSntpTime. It is negative for times
+ * before the UNIX epoch.
+ * @param[out] pUnixTimeNanosecs This will be filled with the nanoseconds part
+ * of the UNIX time equivalent of the SNTP time, @p pSntpTime, truncated from the
+ * exact value.
+ *
+ * @return Returns one of the following:
+ *  - #SntpSuccess if conversion to UNIX time is successful
+ *  - #SntpErrorBadParameter if any of the pointer parameters are NULL, or
+ * @p pivotUnixTimeSecs is out of range.
+ */
+/* @[define_sntp_converttounixtime64] */
+SntpStatus_t Sntp_ConvertToUnixTime64( const SntpTimestamp_t * pSntpTime,
+                                       int64_t pivotUnixTimeSecs,
+                                       int64_t * pUnixTimeSecs,
+                                       uint32_t * pUnixTimeNanosecs );
+/* @[define_sntp_converttounixtime64] */
+
+/**
+ * @brief Utility to convert 64-bit UNIX time with nanoseconds resolution to an
+ * SNTP timestamp, for example, in the @ref SntpGetTime_t interface function.
+ *
+ * Times past the end of an SNTP era wrap around into the next era, as in the
+ * timestamps of SNTP packets.
+ *
+ * @note The conversion of the nanoseconds to SNTP timestamp fractions rounds up,
+ * so that @ref Sntp_ConvertToUnixTime64 converts the timestamp back to the same
+ * nanoseconds value.
+ *
+ * @param[in] unixTimeSecs The seconds part of the UNIX time.
+ * @param[in] unixTimeNanosecs The nanoseconds part of the UNIX time, which MUST
+ * be less than a second.
+ * @param[out] pSntpTime This will be filled with the SNTP timestamp equivalent
+ * of the UNIX time.
+ *
+ * @return Returns one of the following:
+ *  - #SntpSuccess if conversion to SNTP time is successful
+ *  - #SntpErrorBadParameter if @p pSntpTime is NULL, or @p unixTimeNanosecs is
+ * not less than a second.
+ */
+/* @[define_sntp_convertfromunixtime64] */
+SntpStatus_t Sntp_ConvertFromUnixTime64( int64_t unixTimeSecs,
+                                         uint32_t unixTimeNanosecs,
+                                         SntpTimestamp_t * pSntpTime );
+/* @[define_sntp_convertfromunixtime64] */
+
 #endif /* ifndef CORE_SNTP_SERIALIZER_H_ */
@@ -0,0 +1,262 @@
+/*
+ * coreSNTP v1.0.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file core_sntp_stability.h
+ * @brief API of an online estimator of the frequency stability of the local
+ * clock, as the Allan deviation at several averaging times (tau).
+ *
+ * The Allan deviation at an averaging time tau is the typical change of the
+ * frequency error of the local clock between successive intervals of length
+ * tau. Short intervals are dominated by the jitter of the clock offset samples,
+ * and long intervals by the wander of the local oscillator. The estimates of
+ * a particular device can be used to choose the poll interval, with
+ * @ref Sntp_CalculateAdaptivePollInterval, instead of a static frequency
+ * tolerance for all devices.
+ *
+ * The estimator uses a fixed amount of memory. Level k of the estimator uses
+ * every 2^k-th sample, so that the averaging times of the levels are the
+ * powers of 2 multiples of the sampling interval.
+ */
+
+#ifndef CORE_SNTP_STABILITY_H_
+#define CORE_SNTP_STABILITY_H_
+
+/* Standard include. */
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/* Include coreSNTP Serializer header. */
+#include "core_sntp_serializer.h"
+
+/**
+ * @brief The number of averaging times at which the Allan deviation is
+ * estimated, i.e. the number of levels of the estimator.
+ */
+#define SNTP_STABILITY_NUM_TAUS              ( 8U )
+
+/**
+ * @brief The number of frequency differences needed at a level before its
+ * Allan deviation is reported.
+ */
+#define SNTP_STABILITY_MIN_SAMPLES           ( 3U )
+
+/**
+ * @brief The number of the most recent frequency differences of a level that
+ * are weighted the most in its Allan deviation. Until a level receives this
+ * many differences, its Allan deviation is their plain average.
+ */
+#define SNTP_STABILITY_AVERAGE_SAMPLES       ( 16U )
+
+/**
+ * @ingroup core_sntp_struct_types
+ * @brief Structure representing the state of the estimator for a single
+ * averaging time.
+ *
+ * @note The members of this structure SHOULD NOT be accessed directly by the
+ * application.
+ */
+typedef struct SntpStabilityLevel
+{
+    /**
+     * @brief The local time, in SNTP timestamp fractions, of the last sample
+     * used by the level.
+     */
+    uint64_t lastTime;
+
+    /**
+     * @brief The clock offset, in SNTP timestamp fractions, of the last sample
+     * used by the level.
+     */
+    int64_t lastOffset;
+
+    /**
+     * @brief The frequency error, in parts per trillion, measured over the last
+     * interval of the level.
+     */
+    int64_t lastFrequency;
+
+    /**
+     * @brief The number of successive samples (up to 2) available for
+     * measuring the next frequency difference.
+     */
+    uint32_t numOfPoints;
+
+    /**
+     * @brief The number of frequency differences included in the averages,
+     * up to #SNTP_STABILITY_AVERAGE_SAMPLES.
+     */
+    uint32_t numOfSamples;
+
+    /**
+     * @brief The average interval, in milliseconds, between the samples of the
+     * level.
+     */
+    uint64_t averageIntervalMs;
+
+    /**
+     * @brief The Allan variance, in squared parts per trillion.
+     */
+    uint64_t allanVariance;
+} SntpStabilityLevel_t;
+
+/**
+ * @ingroup core_sntp_struct_types
+ * @brief Structure representing an estimator of the Allan deviation of the
+ * local clock.
+ *
+ * @note The members of this structure SHOULD NOT be accessed directly by the
+ * application.
+ */
+typedef struct SntpStabilityEstimator
+{
+    /**
+     * @brief The estimator state of each averaging time, from the shortest to
+     * the longest.
+     */
+    SntpStabilityLevel_t levels[ SNTP_STABILITY_NUM_TAUS ];
+
+    /**
+     * @brief The number of samples received by the estimator, which selects the
+     * levels that use the next sample.
+     */
+    uint32_t sampleCount;
+} SntpStabilityEstimator_t;
+
+/**
+ * @brief Initializes an estimator without any samples.
+ *
+ * @param[out] pEstimator The estimator to initialize.
+ *
+ * @return This function returns one of the following:
+ * - #SntpSuccess if the estimator is initialized.
+ * - #SntpErrorBadParameter if @p pEstimator is NULL.
+ */
+/* @[define_sntp_initstabilityestimator] */
+SntpStatus_t Sntp_InitStabilityEstimator( SntpStabilityEstimator_t * pEstimator );
+/* @[define_sntp_initstabilityestimator] */
+
+/**
+ * @brief Updates the estimator with the clock offset of an accepted server
+ * response.
+ *
+ * @note The clock offsets MUST be measured against a local clock whose time is
+ * not corrected with the offsets, for example, the local time of a virtual
+ * clock (@ref Sntp_UpdateVirtualClock). Any other discontinuity in the offsets,
+ * such as a change of time server, SHOULD be reported with
+ * @ref Sntp_MarkStabilityDiscontinuity.
+ *
+ * @note A sample that implies a frequency error beyond 0.1% relative to the
+ * previous sample of a level is treated as a discontinuity of that level.
+ *
+ * @param[in, out] pEstimator The estimator.
+ * @param[in] pLocalTime The local time of receiving the server response.
+ * @param[in] clockOffset The clock offset of the local clock relative to server
+ * time, in units of SNTP timestamp fractions, as calculated in
+ * #SntpResponseData_t.clockOffsetFractions.
+ *
+ * @return This function returns one of the following:
+ * - #SntpSuccess if the estimator is updated.
+ * - #SntpErrorBadParameter if @p pEstimator or @p pLocalTime is NULL.
+ */
+/* @[define_sntp_updatestabilityestimator] */
+SntpStatus_t Sntp_UpdateStabilityEstimator( SntpStabilityEstimator_t * pEstimator,
+                                            const SntpTimestamp_t * pLocalTime,
+                                            int64_t clockOffset );
+/* @[define_sntp_updatestabilityestimator] */
+
+/**
+ * @brief Marks a discontinuity in the clock offset samples, for example, after a
+ * change of time server or a step of the local clock. The estimates are kept,
+ * and the next sample starts new frequency measurements.
+ *
+ * @param[in, out] pEstimator The estimator.
+ *
+ * @return This function returns one of the following:
+ * - #SntpSuccess if the discontinuity is marked.
+ * - #SntpErrorBadParameter if @p pEstimator is NULL.
+ */
+/* @[define_sntp_markstabilitydiscontinuity] */
+SntpStatus_t Sntp_MarkStabilityDiscontinuity( SntpStabilityEstimator_t * pEstimator );
+/* @[define_sntp_markstabilitydiscontinuity] */
+
+/**
+ * @brief Reads the Allan deviation estimated at an averaging time.
+ *
+ * @param[in] pEstimator The estimator.
+ * @param[in] tauIndex The index of the averaging time, from 0 (the sampling
+ * interval) to #SNTP_STABILITY_NUM_TAUS - 1 (2^7 times the sampling interval).
+ * @param[out] pTauMs This is filled with the averaging time in milliseconds,
+ * i.e. the average interval between the samples of the level.
+ * @param[out] pAllanDeviation This is filled with the Allan deviation in parts
+ * per trillion (10^-12).
+ *
+ * @return This function returns one of the following:
+ * - #SntpSuccess if the Allan deviation is read.
+ * - #SntpErrorBadParameter if any pointer parameter is NULL, or @p tauIndex is
+ * out of range.
+ * - #SntpInsufficientSamples if the level has fewer than
+ * #SNTP_STABILITY_MIN_SAMPLES frequency differences.
+ */
+/* @[define_sntp_getallandeviation] */
+SntpStatus_t Sntp_GetAllanDeviation( const SntpStabilityEstimator_t * pEstimator,
+                                     size_t tauIndex,
+                                     uint64_t * pTauMs,
+                                     uint64_t * pAllanDeviation );
+/* @[define_sntp_getallandeviation] */
+
+/**
+ * @brief Calculates the poll interval that achieves a desired clock accuracy
+ * from the measured stability of the local clock.
+ *
+ * This is an alternative to @ref Sntp_CalculatePollInterval, which assumes a
+ * static frequency tolerance. The time error accumulated over an averaging time
+ * tau is estimated as tau times the Allan deviation at tau, and the poll
+ * interval is the longest measured averaging time within the desired accuracy.
+ * As the averaging times are multiples of the poll interval, the poll interval
+ * can grow by up to 2^7 times with each calculation while the accuracy allows.
+ *
+ * @note The poll interval also sets the time constant of clock discipline, for
+ * example, in the Linux clock backend.
+ *
+ * @param[in] pEstimator The estimator.
+ * @param[in] desiredAccuracy The acceptable maximum drift, in milliseconds,
+ * for the clock. This parameter MUST be non-zero.
+ * @param[out] pPollInterval This is filled with the poll interval, in seconds,
+ * as the closest power of 2 value lower than or equal to the selected averaging
+ * time. If no averaging time achieves the desired accuracy, the shortest
+ * measured averaging time is used.
+ *
+ * @return This function returns one of the following:
+ * - #SntpSuccess if the poll interval is calculated.
+ * - #SntpErrorBadParameter for an invalid parameter passed to the function.
+ * - #SntpInsufficientSamples if no Allan deviation has been estimated yet.
+ * - #SntpZeroPollInterval if the selected averaging time is less than 1 second.
+ */
+/* @[define_sntp_calculateadaptivepollinterval] */
+SntpStatus_t Sntp_CalculateAdaptivePollInterval( const SntpStabilityEstimator_t * pEstimator,
+                                                 uint16_t desiredAccuracy,
+                                                 uint32_t * pPollInterval );
+/* @[define_sntp_calculateadaptivepollinterval] */
+
+#endif /* ifndef CORE_SNTP_STABILITY_H_ */
@@ -0,0 +1,170 @@
+/*
+ * coreSNTP v1.0.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file core_sntp_timeout.h
+ * @brief API of an estimator of the response timeout of a time server, from
+ * the response latencies measured by the client.
+ *
+ * A fixed response timeout is too long for a nearby server, which delays the
+ * detection of a dead server, and too short for a distant one, which causes
+ * spurious failovers. The estimator calculates the timeout like the
+ * retransmission timeout of TCP ([RFC 6298](https://tools.ietf.org/html/rfc6298)):
+ * the smoothed round-trip time plus a multiple of its variation. A timeout
+ * doubles the estimated timeout until the next measured response.
+ *
+ * @note Unlike TCP, the responses of repeated time requests are not ambiguous,
+ * as the "originate timestamp" of every request is unique, so every response
+ * latency is a valid sample.
+ */
+
+#ifndef CORE_SNTP_TIMEOUT_H_
+#define CORE_SNTP_TIMEOUT_H_
+
+/* Standard include. */
+#include <stdint.h>
+#include <stddef.h>
+
+/* Include coreSNTP Serializer header. */
+#include "core_sntp_serializer.h"
+
+/**
+ * @brief The multiple of the round-trip time variation added to the smoothed
+ * round-trip time for the response timeout (K of RFC 6298).
+ */
+#define SNTP_TIMEOUT_VARIATION_MULTIPLIER    ( 4U )
+
+/**
+ * @brief The lowest response timeout, in milliseconds, so that the scheduling
+ * delays of a lightly loaded system do not cause spurious timeouts with a
+ * server on the local network.
+ */
+#define SNTP_TIMEOUT_MIN_MS                  ( 10U )
+
+/**
+ * @brief The highest response timeout, in milliseconds, including after
+ * timeouts double it.
+ */
+#define SNTP_TIMEOUT_MAX_MS                  ( 60000U )
+
+/**
+ * @ingroup core_sntp_struct_types
+ * @brief Structure representing the response timeout estimator of a time
+ * server.
+ *
+ * @note The members of this structure SHOULD NOT be accessed directly by the
+ * application.
+ */
+typedef struct SntpTimeoutEstimator
+{
+    /**
+     * @brief The smoothed round-trip time (SRTT), in microseconds.
+     */
+    uint32_t smoothedRttUs;
+
+    /**
+     * @brief The round-trip time variation (RTTVAR), in microseconds.
+     */
+    uint32_t rttVariationUs;
+
+    /**
+     * @brief The response timeout, in milliseconds, or zero before the first
+     * response latency is measured.
+     */
+    uint32_t timeoutMs;
+} SntpTimeoutEstimator_t;
+
+/**
+ * @brief Initializes the response timeout estimators of a list of time servers,
+ * without any measured response latency.
+ *
+ * @param[out] pEstimators The array of estimators to initialize.
+ * @param[in] numOfServers The number of elements of @p pEstimators.
+ *
+ * @return This function returns one of the following:
+ * - #SntpSuccess if the estimators are initialized.
+ * - #SntpErrorBadParameter if @p pEstimators is NULL or @p numOfServers is 0.
+ */
+/* @[define_sntp_inittimeoutestimators] */
+SntpStatus_t Sntp_InitTimeoutEstimators( SntpTimeoutEstimator_t * pEstimators,
+                                         size_t numOfServers );
+/* @[define_sntp_inittimeoutestimators] */
+
+/**
+ * @brief Updates a response timeout estimator with the latency of a response,
+ * the time from sending a time request to receiving its response.
+ *
+ * The first latency sets the smoothed round-trip time, and half of it the
+ * variation. Later latencies update them with gains of 1/8 and 1/4. The
+ * response timeout is then recalculated, which also ends any doubling of the
+ * timeout by @ref Sntp_BackOffTimeoutEstimator.
+ *
+ * @param[in, out] pEstimator The estimator.
+ * @param[in] latencyFractions The response latency, in SNTP timestamp fractions
+ * (2^-32 seconds).
+ *
+ * @return This function returns one of the following:
+ * - #SntpSuccess if the estimator is updated.
+ * - #SntpErrorBadParameter if @p pEstimator is NULL, or @p latencyFractions is
+ * negative, as measured across a backward step of system time.
+ */
+/* @[define_sntp_updatetimeoutestimator] */
+SntpStatus_t Sntp_UpdateTimeoutEstimator( SntpTimeoutEstimator_t * pEstimator,
+                                          int64_t latencyFractions );
+/* @[define_sntp_updatetimeoutestimator] */
+
+/**
+ * @brief Doubles the response timeout of an estimator after a timeout, up to
+ * #SNTP_TIMEOUT_MAX_MS, so that a server whose latency has grown is not
+ * repeatedly timed out before its response.
+ *
+ * An estimator without a measured response latency is not changed.
+ *
+ * @param[in, out] pEstimator The estimator.
+ *
+ * @return This function returns one of the following:
+ * - #SntpSuccess if the timeout is doubled, or there is no timeout to double.
+ * - #SntpErrorBadParameter if @p pEstimator is NULL.
+ */
+/* @[define_sntp_backofftimeoutestimator] */
+SntpStatus_t Sntp_BackOffTimeoutEstimator( SntpTimeoutEstimator_t * pEstimator );
+/* @[define_sntp_backofftimeoutestimator] */
+
+/**
+ * @brief Reads the response timeout of an estimator.
+ *
+ * @param[in] pEstimator The estimator.
+ * @param[in] defaultTimeoutMs The timeout, in milliseconds, to report when no
+ * response latency has been measured yet.
+ * @param[out] pTimeoutMs The response timeout, in milliseconds.
+ *
+ * @return This function returns one of the following:
+ * - #SntpSuccess if the timeout is read.
+ * - #SntpErrorBadParameter if @p pEstimator or @p pTimeoutMs is NULL.
+ */
+/* @[define_sntp_getresponsetimeout] */
+SntpStatus_t Sntp_GetResponseTimeout( const SntpTimeoutEstimator_t * pEstimator,
+                                      uint32_t defaultTimeoutMs,
+                                      uint32_t * pTimeoutMs );
+/* @[define_sntp_getresponsetimeout] */
+
+#endif /* ifndef CORE_SNTP_TIMEOUT_H_ */
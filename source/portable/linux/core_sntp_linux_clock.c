@@ -0,0 +1,452 @@
+/*
+ * coreSNTP v1.0.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file core_sntp_linux_clock.c
+ * @brief Implementation of the Linux clock discipline backend of the coreSNTP
+ * library.
+ */
+
+/* The clock_adjtime system call is a Linux extension. */
+#ifndef _GNU_SOURCE
+    #define _GNU_SOURCE
+#endif
+
+/* Standard includes. */
+#include <string.h>
+#include <assert.h>
+
+/* Include API header. */
+#include "core_sntp_linux_clock.h"
+#include "core_sntp_fixed_point.h"
+
+/**
+ * @brief The number of nanoseconds in a second.
+ */
+#define NANOSECONDS_PER_SECOND        ( 1000000000L )
+
+/**
+ * @brief The maximum clock offset, in nanoseconds, that the kernel slews in a
+ * single adjustment (MAXPHASE of the kernel clock discipline).
+ */
+#define MAX_SLEW_OFFSET_NS            ( 500000000L )
+
+/**
+ * @brief The maximum time constant of the kernel PLL (MAXTC of the kernel clock
+ * discipline).
+ */
+#define MAX_TIME_CONSTANT             ( 10L )
+
+/**
+ * @brief The maximum frequency correction supported by the kernel, in units of
+ * the `freq` member of `struct timex` (i.e. PPM with a 16-bit fraction).
+ */
+#define MAX_KERNEL_FREQUENCY          ( ( int64_t ) 500 << 16 )
+
+/**
+ * @brief The clock backend used by the #SntpGetTime_t and #SntpSetTime_t
+ * interface implementations.
+ */
+static SntpLinuxClock_t * pRegisteredClock = NULL;
+
+/**
+ * @brief Calculates the time constant of the kernel PLL for a polling interval.
+ *
+ * The time constant is the base-2 logarithm of the polling interval, which
+ * matches the loop bandwidth of the PLL to the interval between clock offsets
+ * when the kernel operates in nanosecond mode.
+ *
+ * @param[in] pollIntervalSec The non-zero polling interval in seconds.
+ *
+ * @return The time constant, limited to the range supported by the kernel.
+ */
+static long calculateTimeConstant( uint32_t pollIntervalSec )
+{
+    long timeConstant = 0L;
+    uint32_t interval = pollIntervalSec;
+
+    assert( pollIntervalSec != 0U );
+
+    while( ( interval > 1U ) && ( timeConstant < MAX_TIME_CONSTANT ) )
+    {
+        interval >>= 1;
+        timeConstant++;
+    }
+
+    return timeConstant;
+}
+
+/**
+ * @brief Steps the clock by a clock offset.
+ *
+ * @param[in] pClock The clock backend.
+ * @param[in] clockOffset The clock offset, in units of SNTP timestamp fractions.
+ *
+ * @return #SntpSuccess if the clock is stepped; #SntpErrorSystemClockFailure
+ * otherwise.
+ */
+static SntpStatus_t stepClock( const SntpLinuxClock_t * pClock,
+                               int64_t clockOffset )
+{
+    SntpStatus_t status = SntpSuccess;
+    struct timex timex;
+    int64_t offsetNs = Sntp_FixedToNanoseconds( clockOffset );
+    long seconds = ( long ) ( offsetNs / NANOSECONDS_PER_SECOND );
+    long nanoseconds = ( long ) ( offsetNs % NANOSECONDS_PER_SECOND );
+
+    assert( pClock != NULL );
+
+    ( void ) memset( &timex, 0, sizeof( timex ) );
+
+    /* Clear any pending slew of the kernel PLL, which is made obsolete by the
+     * step, along with stepping the clock. With ADJ_NANO, the tv_usec member
+     * represents nanoseconds. */
+    timex.modes = ADJ_SETOFFSET | ADJ_NANO | ADJ_OFFSET;
+    timex.offset = 0L;
+
+    /* The kernel requires the sub-second part of the offset to be a positive
+     * value, so a negative remainder borrows a second. */
+    if( nanoseconds < 0L )
+    {
+        seconds -= 1L;
+        nanoseconds += NANOSECONDS_PER_SECOND;
+    }
+
+    timex.time.tv_sec = seconds;
+    timex.time.tv_usec = nanoseconds;
+
+    if( pClock->syscalls.clockAdjTime( pClock->clockId, &timex ) < 0 )
+    {
+        status = SntpErrorSystemClockFailure;
+    }
+
+    return status;
+}
+
+/**
+ * @brief Slews the clock by a clock offset with the kernel PLL.
+ *
+ * @param[in] pClock The clock backend.
+ * @param[in] clockOffset The clock offset, in units of SNTP timestamp fractions.
+ *
+ * @return #SntpSuccess if the offset is passed to the kernel;
+ * #SntpErrorSystemClockFailure otherwise.
+ */
+static SntpStatus_t slewClock( const SntpLinuxClock_t * pClock,
+                               int64_t clockOffset )
+{
+    SntpStatus_t status = SntpSuccess;
+    struct timex timex;
+    uint64_t offsetMagnitude = Sntp_FixedMagnitude( clockOffset );
+    long offsetNs = MAX_SLEW_OFFSET_NS;
+    int kernelStatus;
+
+    assert( pClock != NULL );
+
+    /* Offsets beyond the kernel limit are slewed by the limit. */
+    if( offsetMagnitude < ( uint64_t ) ( SNTP_FIXED_SECOND / 2 ) )
+    {
+        offsetNs = ( long ) Sntp_FixedToNanoseconds( ( int64_t ) offsetMagnitude );
+    }
+
+    /* Read the current status of the kernel clock discipline, so that the status
+     * bits not related to the PLL (for example, leap second bits) are kept. */
+    ( void ) memset( &timex, 0, sizeof( timex ) );
+
+    if( pClock->syscalls.clockAdjTime( pClock->clockId, &timex ) < 0 )
+    {
+        status = SntpErrorSystemClockFailure;
+    }
+    else
+    {
+        kernelStatus = ( timex.status | STA_PLL ) & ~( STA_UNSYNC | STA_FLL | STA_FREQHOLD );
+
+        ( void ) memset( &timex, 0, sizeof( timex ) );
+
+        /* Enable the PLL in nanosecond mode with the clock offset. The offset also
+         * serves as the error estimate of the clock, which keeps the kernel in
+         * synchronized state. */
+        timex.modes = ADJ_STATUS | ADJ_NANO | ADJ_OFFSET | ADJ_MAXERROR | ADJ_ESTERROR;
+        timex.status = kernelStatus;
+        timex.offset = ( clockOffset < 0 ) ? -offsetNs : offsetNs;
+        timex.maxerror = offsetNs / 1000L;
+        timex.esterror = offsetNs / 1000L;
+
+        /* Without a polling interval, the kernel time constant is kept. */
+        if( pClock->pollIntervalSec != 0U )
+        {
+            timex.modes |= ADJ_TIMECONST;
+            timex.constant = calculateTimeConstant( pClock->pollIntervalSec );
+        }
+
+        if( pClock->syscalls.clockAdjTime( pClock->clockId, &timex ) < 0 )
+        {
+            status = SntpErrorSystemClockFailure;
+        }
+    }
+
+    return status;
+}
+
+SntpStatus_t SntpLinuxClock_Init( SntpLinuxClock_t * pClock,
+                                  const SntpLinuxClockSyscalls_t * pSyscalls,
+                                  clockid_t clockId,
+                                  uint32_t stepThresholdMs )
+{
+    SntpStatus_t status = SntpSuccess;
+
+    if( pClock == NULL )
+    {
+        status = SntpErrorBadParameter;
+    }
+    else if( ( pSyscalls != NULL ) &&
+             ( ( pSyscalls->clockAdjTime == NULL ) ||
+               ( pSyscalls->clockGetTime == NULL ) ||
+               ( pSyscalls->clockSetTime == NULL ) ) )
+    {
+        status = SntpErrorBadParameter;
+    }
+    else
+    {
+        ( void ) memset( pClock, 0, sizeof( SntpLinuxClock_t ) );
+
+        if( pSyscalls != NULL )
+        {
+            pClock->syscalls = *pSyscalls;
+        }
+        else
+        {
+            pClock->syscalls.clockAdjTime = clock_adjtime;
+            pClock->syscalls.clockGetTime = clock_gettime;
+            pClock->syscalls.clockSetTime = clock_settime;
+        }
+
+        pClock->clockId = clockId;
+
+        /* Convert the threshold to fractions in parts to avoid overflow. */
+        pClock->stepThreshold = Sntp_FixedFromNanoseconds( ( int64_t ) stepThresholdMs * 1000000 );
+
+        pClock->pollIntervalSec = 0U;
+    }
+
+    return status;
+}
+
+SntpStatus_t SntpLinuxClock_Discipline( SntpLinuxClock_t * pClock,
+                                        int64_t clockOffset,
+                                        uint32_t pollIntervalSec )
+{
+    SntpStatus_t status = SntpSuccess;
+
+    if( pClock == NULL )
+    {
+        status = SntpErrorBadParameter;
+    }
+    else
+    {
+        if( pollIntervalSec != 0U )
+        {
+            pClock->pollIntervalSec = pollIntervalSec;
+        }
+
+        if( Sntp_FixedMagnitude( clockOffset ) > ( uint64_t ) pClock->stepThreshold )
+        {
+            status = stepClock( pClock, clockOffset );
+        }
+        else
+        {
+            status = slewClock( pClock, clockOffset );
+        }
+    }
+
+    return status;
+}
+
+SntpStatus_t SntpLinuxClock_SetPollInterval( SntpLinuxClock_t * pClock,
+                                             uint32_t pollIntervalSec )
+{
+    SntpStatus_t status = SntpSuccess;
+
+    if( pClock == NULL )
+    {
+        status = SntpErrorBadParameter;
+    }
+    else
+    {
+        pClock->pollIntervalSec = pollIntervalSec;
+    }
+
+    return status;
+}
+
+SntpStatus_t SntpLinuxClock_SetFrequency( const SntpLinuxClock_t * pClock,
+                                          int32_t frequency )
+{
+    SntpStatus_t status = SntpSuccess;
+    struct timex timex;
+    int64_t kernelFrequency;
+
+    if( pClock == NULL )
+    {
+        status = SntpErrorBadParameter;
+    }
+    else
+    {
+        /* Convert fractions per second to PPM with a 16-bit fraction, i.e.
+         * frequency * 10^6 * 2^16 / 2^32, which reduces to the factor below. */
+        kernelFrequency = ( ( int64_t ) frequency * 15625 ) / 1024;
+
+        if( kernelFrequency > MAX_KERNEL_FREQUENCY )
+        {
+            kernelFrequency = MAX_KERNEL_FREQUENCY;
+        }
+        else if( kernelFrequency < -MAX_KERNEL_FREQUENCY )
+        {
+            kernelFrequency = -MAX_KERNEL_FREQUENCY;
+        }
+        else
+        {
+            /* Empty else MISRA 15.7 */
+        }
+
+        ( void ) memset( &timex, 0, sizeof( timex ) );
+        timex.modes = ADJ_FREQUENCY;
+        timex.freq = ( long ) kernelFrequency;
+
+        if( pClock->syscalls.clockAdjTime( pClock->clockId, &timex ) < 0 )
+        {
+            status = SntpErrorSystemClockFailure;
+        }
+    }
+
+    return status;
+}
+
+SntpStatus_t SntpLinuxClock_ConvertFromTimespec( const struct timespec * pTime,
+                                                 SntpTimestamp_t * pSntpTime )
+{
+    SntpStatus_t status = SntpErrorBadParameter;
+
+    if( ( pTime != NULL ) && ( pTime->tv_nsec >= 0L ) && ( pTime->tv_nsec < NANOSECONDS_PER_SECOND ) )
+    {
+        status = Sntp_ConvertFromUnixTime64( ( int64_t ) pTime->tv_sec,
+                                             ( uint32_t ) pTime->tv_nsec,
+                                             pSntpTime );
+    }
+
+    return status;
+}
+
+SntpStatus_t SntpLinuxClock_ConvertToTimespec( const SntpTimestamp_t * pSntpTime,
+                                               struct timespec * pTime )
+{
+    SntpStatus_t status = SntpErrorBadParameter;
+    int64_t unixTimeSecs;
+    uint32_t unixTimeNanosecs;
+
+    if( pTime != NULL )
+    {
+        status = Sntp_ConvertToUnixTime64( pSntpTime,
+                                           SNTP_DEFAULT_ERA_PIVOT_UNIX_SECS,
+                                           &unixTimeSecs,
+                                           &unixTimeNanosecs );
+    }
+
+    if( status != SntpSuccess )
+    {
+        /* Invalid parameters. */
+    }
+    else if( ( unixTimeSecs < 0 ) || ( ( int64_t ) ( time_t ) unixTimeSecs != unixTimeSecs ) )
+    {
+        /* The system clock cannot be set before the UNIX epoch, and a 32-bit
+         * time_t cannot represent time past 2038. */
+        status = SntpErrorTimeNotSupported;
+    }
+    else
+    {
+        pTime->tv_sec = ( time_t ) unixTimeSecs;
+        pTime->tv_nsec = ( long ) unixTimeNanosecs;
+    }
+
+    return status;
+}
+
+void SntpLinuxClock_Register( SntpLinuxClock_t * pClock )
+{
+    pRegisteredClock = pClock;
+}
+
+bool SntpLinuxClock_GetTime( SntpTimestamp_t * pCurrentTime )
+{
+    bool success = false;
+    struct timespec currentTime;
+
+    if( ( pRegisteredClock != NULL ) && ( pCurrentTime != NULL ) &&
+        ( pRegisteredClock->syscalls.clockGetTime( pRegisteredClock->clockId, &currentTime ) == 0 ) )
+    {
+        /* The seconds value wraps around into the next SNTP era. */
+        success = ( SntpLinuxClock_ConvertFromTimespec( &currentTime, pCurrentTime ) == SntpSuccess );
+    }
+
+    return success;
+}
+
+bool SntpLinuxClock_SetTime( const char * pTimeServer,
+                             const SntpTimestamp_t * pServerTime,
+                             int32_t clockOffsetSec )
+{
+    bool success = false;
+    struct timespec serverTime;
+    SntpTimestamp_t currentTime;
+    int64_t clockOffset;
+
+    ( void ) pTimeServer;
+
+    if( pRegisteredClock == NULL )
+    {
+        /* No clock backend to discipline. */
+    }
+    else if( clockOffsetSec != SNTP_CLOCK_OFFSET_OVERFLOW )
+    {
+        /* The clock offset in seconds loses any offset under a second, so the
+         * offset is measured from the server time instead, in fractions. */
+        if( ( pServerTime != NULL ) && ( SntpLinuxClock_GetTime( &currentTime ) == true ) )
+        {
+            clockOffset = Sntp_FixedDifference( Sntp_FixedFromTimestamp( *pServerTime ),
+                                                Sntp_FixedFromTimestamp( currentTime ) );
+            success = ( SntpLinuxClock_Discipline( pRegisteredClock, clockOffset,
+                                                   pRegisteredClock->pollIntervalSec ) == SntpSuccess );
+        }
+    }
+    else if( SntpLinuxClock_ConvertToTimespec( pServerTime, &serverTime ) == SntpSuccess )
+    {
+        /* The system clock is too far from server time for an offset, so set
+         * the clock to the server time. */
+        success = ( pRegisteredClock->syscalls.clockSetTime( pRegisteredClock->clockId, &serverTime ) == 0 );
+    }
+    else
+    {
+        /* Server time cannot be represented as system time. */
+    }
+
+    return success;
+}
@@ -0,0 +1,325 @@
+/*
+ * coreSNTP v1.0.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file core_sntp_linux_clock.h
+ * @brief Reference clock discipline backend of the coreSNTP library for Linux,
+ * which corrects the system clock with the kernel clock discipline through the
+ * `clock_adjtime` system call.
+ *
+ * Clock offsets within a configurable step threshold are corrected by slewing
+ * the clock with the phase-locked loop (PLL) of the kernel, which also corrects
+ * the frequency error of the clock over successive offsets. Only offsets beyond
+ * the threshold step the clock.
+ *
+ * The system calls are accessed through the @ref SntpLinuxClockSyscalls_t table
+ * so that the discipline logic can be tested without the CAP_SYS_TIME
+ * capability.
+ */
+
+#ifndef CORE_SNTP_LINUX_CLOCK_H_
+#define CORE_SNTP_LINUX_CLOCK_H_
+
+/* Standard include. */
+#include <stdint.h>
+#include <stdbool.h>
+
+/* POSIX and Linux includes. */
+#include <time.h>
+#include <sys/timex.h>
+
+/* Include coreSNTP client header. */
+#include "core_sntp_client.h"
+
+/**
+ * @brief The default threshold, in milliseconds, of clock offsets beyond which
+ * the system clock is stepped instead of slewed.
+ *
+ * @note This is the same step threshold that is used by the NTP reference
+ * implementation.
+ */
+#define SNTP_LINUX_CLOCK_DEFAULT_STEP_THRESHOLD_MS    ( 128U )
+
+/**
+ * @ingroup core_sntp_callback_types
+ * @brief Interface for the `clock_adjtime` system call.
+ */
+typedef int ( * SntpLinuxClockAdjTime_t )( clockid_t clockId,
+                                           struct timex * pTimex );
+
+/**
+ * @ingroup core_sntp_callback_types
+ * @brief Interface for the `clock_gettime` system call.
+ */
+typedef int ( * SntpLinuxClockGetTime_t )( clockid_t clockId,
+                                           struct timespec * pTime );
+
+/**
+ * @ingroup core_sntp_callback_types
+ * @brief Interface for the `clock_settime` system call.
+ */
+typedef int ( * SntpLinuxClockSetTime_t )( clockid_t clockId,
+                                           const struct timespec * pTime );
+
+/**
+ * @ingroup core_sntp_struct_types
+ * @brief Structure representing the system calls used by the Linux clock
+ * backend. The functions follow the semantics of the system calls, and return
+ * zero or a positive value on success, and -1 on failure.
+ */
+typedef struct SntpLinuxClockSyscalls
+{
+    SntpLinuxClockAdjTime_t clockAdjTime; /**< @brief Reads and adjusts the kernel clock discipline. */
+    SntpLinuxClockGetTime_t clockGetTime; /**< @brief Reads the clock time. */
+    SntpLinuxClockSetTime_t clockSetTime; /**< @brief Sets the clock time. */
+} SntpLinuxClockSyscalls_t;
+
+/**
+ * @ingroup core_sntp_struct_types
+ * @brief Structure representing a system clock disciplined by the Linux clock
+ * backend.
+ *
+ * @note The members of this structure SHOULD NOT be accessed directly by the
+ * application.
+ */
+typedef struct SntpLinuxClock
+{
+    /**
+     * @brief The system calls for accessing the clock.
+     */
+    SntpLinuxClockSyscalls_t syscalls;
+
+    /**
+     * @brief The identifier of the disciplined clock.
+     */
+    clockid_t clockId;
+
+    /**
+     * @brief The threshold of clock offsets, in units of SNTP timestamp fractions,
+     * beyond which the clock is stepped.
+     */
+    int64_t stepThreshold;
+
+    /**
+     * @brief The polling interval, in seconds, from which the time constant of
+     * the kernel PLL is derived. Zero keeps the kernel time constant.
+     */
+    uint32_t pollIntervalSec;
+} SntpLinuxClock_t;
+
+/**
+ * @brief Initializes a Linux clock backend for disciplining a clock.
+ *
+ * @param[out] pClock The clock backend to initialize.
+ * @param[in] pSyscalls The system calls to use for accessing the clock. If NULL,
+ * the `clock_adjtime`, `clock_gettime` and `clock_settime` functions of the C
+ * library are used.
+ * @param[in] clockId The clock to discipline, which is usually `CLOCK_REALTIME`.
+ * @param[in] stepThresholdMs The threshold, in milliseconds, of clock offsets
+ * beyond which the clock is stepped instead of slewed. A value of zero steps
+ * the clock for every non-zero clock offset.
+ *
+ * @note The kernel limits the clock offset that can be slewed in a single
+ * adjustment to 0.5 seconds. If @p stepThresholdMs is higher, offsets between
+ * 0.5 seconds and the threshold are slewed by 0.5 seconds.
+ *
+ * @return This function returns one of the following:
+ * - #SntpSuccess if the clock backend is initialized.
+ * - #SntpErrorBadParameter if @p pClock is NULL, or any member of @p pSyscalls
+ * is NULL.
+ */
+/* @[define_sntplinuxclock_init] */
+SntpStatus_t SntpLinuxClock_Init( SntpLinuxClock_t * pClock,
+                                  const SntpLinuxClockSyscalls_t * pSyscalls,
+                                  clockid_t clockId,
+                                  uint32_t stepThresholdMs );
+/* @[define_sntplinuxclock_init] */
+
+/**
+ * @brief Corrects the clock for a clock offset calculated from a server
+ * response.
+ *
+ * If the magnitude of the clock offset is beyond the step threshold, the clock
+ * is stepped by the offset. Otherwise, the offset is passed to the kernel PLL,
+ * which slews the clock and corrects its frequency over successive offsets.
+ *
+ * @param[in, out] pClock The clock backend.
+ * @param[in] clockOffset The offset of the clock relative to server time, in
+ * units of SNTP timestamp fractions, as calculated in the
+ * #SntpResponseData_t.clockOffsetFractions member by the
+ * @ref Sntp_DeserializeResponse API.
+ * @param[in] pollIntervalSec The polling interval, in seconds, at which clock
+ * offsets are measured, as calculated by the @ref Sntp_CalculatePollInterval
+ * API. The time constant of the kernel PLL is set from this value, which is
+ * kept for later offsets. A value of zero keeps the previously set polling
+ * interval.
+ *
+ * @return This function returns one of the following:
+ * - #SntpSuccess if the clock is corrected.
+ * - #SntpErrorBadParameter if @p pClock is NULL.
+ * - #SntpErrorSystemClockFailure if a system call for adjusting the clock
+ * fails.
+ */
+/* @[define_sntplinuxclock_discipline] */
+SntpStatus_t SntpLinuxClock_Discipline( SntpLinuxClock_t * pClock,
+                                        int64_t clockOffset,
+                                        uint32_t pollIntervalSec );
+/* @[define_sntplinuxclock_discipline] */
+
+/**
+ * @brief Sets the polling interval from which the time constant of the kernel
+ * PLL is derived, without correcting the clock.
+ *
+ * The @ref SntpLinuxClock_SetTime interface has no polling interval parameter,
+ * so an application that disciplines the clock through the coreSNTP client
+ * calls this function whenever its polling interval changes, for example,
+ * after @ref Sntp_CalculateAdaptivePollInterval.
+ *
+ * @param[in, out] pClock The clock backend.
+ * @param[in] pollIntervalSec The polling interval in seconds, as for
+ * @ref SntpLinuxClock_Discipline. A value of zero keeps the kernel time
+ * constant for later offsets.
+ *
+ * @return This function returns one of the following:
+ * - #SntpSuccess if the polling interval is set.
+ * - #SntpErrorBadParameter if @p pClock is NULL.
+ */
+/* @[define_sntplinuxclock_setpollinterval] */
+SntpStatus_t SntpLinuxClock_SetPollInterval( SntpLinuxClock_t * pClock,
+                                             uint32_t pollIntervalSec );
+/* @[define_sntplinuxclock_setpollinterval] */
+
+/**
+ * @brief Sets the frequency correction of the clock directly, for example, from
+ * the frequency estimated by a virtual clock (@ref SntpClockModel_t.frequency).
+ *
+ * @param[in] pClock The clock backend.
+ * @param[in] frequency The frequency correction, in units of SNTP timestamp
+ * fractions per second. The value is limited to the +/-500 PPM range
+ * supported by the kernel.
+ *
+ * @return This function returns one of the following:
+ * - #SntpSuccess if the frequency correction is set.
+ * - #SntpErrorBadParameter if @p pClock is NULL.
+ * - #SntpErrorSystemClockFailure if the system call for adjusting the clock
+ * fails.
+ */
+/* @[define_sntplinuxclock_setfrequency] */
+SntpStatus_t SntpLinuxClock_SetFrequency( const SntpLinuxClock_t * pClock,
+                                          int32_t frequency );
+/* @[define_sntplinuxclock_setfrequency] */
+
+/**
+ * @brief Converts a POSIX `struct timespec` of UNIX time to an SNTP timestamp
+ * with @ref Sntp_ConvertFromUnixTime64.
+ *
+ * @param[in] pTime The UNIX time to convert.
+ * @param[out] pSntpTime This will be filled with the equivalent SNTP timestamp.
+ *
+ * @return This function returns one of the following:
+ * - #SntpSuccess if the time is converted.
+ * - #SntpErrorBadParameter if any parameter is NULL, or the nanoseconds of
+ * @p pTime are not in the range [0, 10^9).
+ */
+/* @[define_sntplinuxclock_convertfromtimespec] */
+SntpStatus_t SntpLinuxClock_ConvertFromTimespec( const struct timespec * pTime,
+                                                 SntpTimestamp_t * pSntpTime );
+/* @[define_sntplinuxclock_convertfromtimespec] */
+
+/**
+ * @brief Converts an SNTP timestamp to a POSIX `struct timespec` of UNIX time
+ * with @ref Sntp_ConvertToUnixTime64, resolving the SNTP era with the
+ * #SNTP_DEFAULT_ERA_PIVOT_UNIX_SECS pivot time.
+ *
+ * @param[in] pSntpTime The SNTP timestamp to convert.
+ * @param[out] pTime This will be filled with the equivalent UNIX time.
+ *
+ * @return This function returns one of the following:
+ * - #SntpSuccess if the time is converted.
+ * - #SntpErrorBadParameter if any parameter is NULL.
+ * - #SntpErrorTimeNotSupported if the time is before the UNIX epoch, or cannot
+ * be represented in `time_t`.
+ */
+/* @[define_sntplinuxclock_converttotimespec] */
+SntpStatus_t SntpLinuxClock_ConvertToTimespec( const SntpTimestamp_t * pSntpTime,
+                                               struct timespec * pTime );
+/* @[define_sntplinuxclock_converttotimespec] */
+
+/**
+ * @brief Sets the clock backend used by the @ref SntpLinuxClock_GetTime and
+ * @ref SntpLinuxClock_SetTime functions, which do not take a clock backend
+ * parameter.
+ *
+ * @param[in] pClock The initialized clock backend, or NULL to remove the
+ * previously set backend.
+ */
+/* @[define_sntplinuxclock_register] */
+void SntpLinuxClock_Register( SntpLinuxClock_t * pClock );
+/* @[define_sntplinuxclock_register] */
+
+/**
+ * @brief Reference implementation of the @ref SntpGetTime_t interface that
+ * reads the time of the clock set with @ref SntpLinuxClock_Register.
+ *
+ * @param[out] pCurrentTime This will be filled with the current time of the
+ * clock in SNTP timestamp format.
+ *
+ * @return `true` if the time is read; `false` if no clock backend is set or the
+ * system call fails.
+ */
+/* @[define_sntplinuxclock_gettime] */
+bool SntpLinuxClock_GetTime( SntpTimestamp_t * pCurrentTime );
+/* @[define_sntplinuxclock_gettime] */
+
+/**
+ * @brief Reference implementation of the @ref SntpSetTime_t interface that
+ * disciplines the clock set with @ref SntpLinuxClock_Register.
+ *
+ * The @ref SntpSetTime_t interface only provides the clock offset with a
+ * resolution of seconds, so the clock offset is measured as the difference of
+ * @p pServerTime and the time of the clock when this function is called, in
+ * SNTP timestamp fractions. The clock is disciplined with
+ * @ref SntpLinuxClock_Discipline for this offset, and the polling interval
+ * set by the last call to that function or to
+ * @ref SntpLinuxClock_SetPollInterval. If the clock offset cannot be calculated due
+ * to overflow (i.e. @p clockOffsetSec is #SNTP_CLOCK_OFFSET_OVERFLOW), the clock
+ * is set to @p pServerTime.
+ *
+ * @note The measured offset is short of the clock offset by the network delay
+ * of the server response. For full accuracy, use @ref SntpLinuxClock_Discipline
+ * with the #SntpResponseData_t.clockOffsetFractions value instead.
+ *
+ * @param[in] pTimeServer The time server used to request time.
+ * @param[in] pServerTime The current time returned by the @p pTimeServer.
+ * @param[in] clockOffsetSec The calculated clock offset of the system relative
+ * to the server time.
+ *
+ * @return `true` if the clock is corrected; `false` if no clock backend is set,
+ * @p pServerTime is NULL, or a system call fails.
+ */
+/* @[define_sntplinuxclock_settime] */
+bool SntpLinuxClock_SetTime( const char * pTimeServer,
+                             const SntpTimestamp_t * pServerTime,
+                             int32_t clockOffsetSec );
+/* @[define_sntplinuxclock_settime] */
+
+#endif /* ifndef CORE_SNTP_LINUX_CLOCK_H_ */
@@ -0,0 +1,499 @@
+/*
+ * coreSNTP v1.0.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file core_sntp_coroutine_test.cpp
+ * @brief Tests of the C++20 coroutine interface of the coreSNTP library.
+ */
+
+/* Standard includes. */
+#include <array>
+#include <chrono>
+#include <coroutine>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <vector>
+
+/* coreSNTP coroutine interface. */
+#include "core_sntp_coroutine.hpp"
+
+/**
+ * @brief The network context of the test transport, which answers the requests
+ * to the servers that are up with a response one second ahead of the system
+ * time, when the reactor polls the network.
+ */
+struct NetworkContext
+{
+    std::array<std::uint8_t, SNTP_PACKET_BASE_SIZE> request; /**< @brief The last request. */
+    const SntpServerInfo_t * pServer;                        /**< @brief The server of the request. */
+    bool isReadable;                                         /**< @brief Whether a response can be read. */
+    std::uint32_t numOfReads;                                /**< @brief The number of reads. */
+};
+
+namespace
+{
+    /**
+     * @brief The system time of the test, in SNTP era 0.
+     */
+    constexpr std::uint32_t testStartTimeSecs = 3900000000U;
+
+    /**
+     * @brief The timeout of the responses.
+     */
+    constexpr std::chrono::milliseconds testTimeout { 3000 };
+
+    /**
+     * @brief The server that does not answer.
+     */
+    const char * const downServerName = "down.example.com";
+
+    /**
+     * @brief The servers of the clients.
+     */
+    const SntpServerInfo_t testServers[] =
+    {
+        { "down.example.com", SNTP_DEFAULT_SERVER_PORT },
+        { "up.example.com",   SNTP_DEFAULT_SERVER_PORT }
+    };
+
+    /**
+     * @brief The system time of the test, in seconds.
+     */
+    std::uint32_t testTimeSecs = testStartTimeSecs;
+
+    /**
+     * @brief The number of system time updates.
+     */
+    std::uint32_t setTimeCount = 0U;
+
+    /**
+     * @brief The number of failed checks.
+     */
+    int failures = 0;
+
+    /**
+     * @brief Counts and reports a failed check.
+     */
+    void check( bool condition,
+                const char * pDescription )
+    {
+        if( !condition )
+        {
+            std::printf( "FAIL: %s\n", pDescription );
+            failures++;
+        }
+    }
+
+    bool resolveDns( const char * pServerAddr,
+                     std::uint32_t * pIpV4Addr )
+    {
+        ( void ) pServerAddr;
+        *pIpV4Addr = 0x7F000001U;
+
+        return true;
+    }
+
+    bool getTime( SntpTimestamp_t * pCurrentTime )
+    {
+        pCurrentTime->seconds = testTimeSecs;
+        pCurrentTime->fractions = 0U;
+
+        return true;
+    }
+
+    bool setTime( const char * pTimeServer,
+                  const SntpTimestamp_t * pServerTime,
+                  std::int32_t clockOffsetSec )
+    {
+        ( void ) pTimeServer;
+        ( void ) pServerTime;
+        ( void ) clockOffsetSec;
+        setTimeCount++;
+
+        return true;
+    }
+
+    std::int32_t sendTo( NetworkContext_t * pNetworkContext,
+                         const SntpServerInfo_t * pTimeServer,
+                         const void * pBuffer,
+                         std::size_t bytesToSend )
+    {
+        std::memcpy( pNetworkContext->request.data(), pBuffer, SNTP_PACKET_BASE_SIZE );
+        pNetworkContext->pServer = pTimeServer;
+        pNetworkContext->isReadable = false;
+
+        return static_cast<std::int32_t>( bytesToSend );
+    }
+
+    std::int32_t recvFrom( NetworkContext_t * pNetworkContext,
+                           SntpServerInfo_t * pTimeServer,
+                           void * pBuffer,
+                           std::size_t bytesToRecv )
+    {
+        auto * pResponse = static_cast<std::uint8_t *>( pBuffer );
+        std::int32_t bytesReceived = 0;
+
+        pNetworkContext->numOfReads++;
+
+        /* Only the server of the last request answers. */
+        if( pNetworkContext->isReadable &&
+            ( std::strcmp( pTimeServer->pServerName, pNetworkContext->pServer->pServerName ) == 0 ) )
+        {
+            pNetworkContext->isReadable = false;
+            std::memset( pResponse, 0, bytesToRecv );
+
+            /* Version 4 server mode response of a stratum 1 server. */
+            pResponse[ 0 ] = 0x24U;
+            pResponse[ 1 ] = 1U;
+            std::memcpy( &pResponse[ 24 ], &pNetworkContext->request[ 40 ], 8U );
+            std::memcpy( &pResponse[ 32 ], &pNetworkContext->request[ 40 ], 8U );
+            pResponse[ 35 ]++;
+            std::memcpy( &pResponse[ 40 ], &pResponse[ 32 ], 8U );
+            bytesReceived = static_cast<std::int32_t>( bytesToRecv );
+        }
+
+        return bytesReceived;
+    }
+
+    /**
+     * @brief Reactor of the tests, in virtual time. Each step advances the
+     * time by a second, delivers the responses of the servers that are up,
+     * and resumes the coroutines waiting for a response.
+     */
+    class TestReactor
+    {
+        public:
+
+            /**
+             * @brief Suspends the awaiting coroutine until the next step.
+             */
+            class Awaiter
+            {
+                public:
+                    Awaiter( TestReactor & reactor,
+                             NetworkContext_t * pNetwork ) noexcept : reactor_ { reactor }, pNetwork_ { pNetwork }
+                    {
+                    }
+
+                    bool await_ready() const noexcept
+                    {
+                        return false;
+                    }
+
+                    void await_suspend( std::coroutine_handle<> handle )
+                    {
+                        reactor_.waiting_.push_back( Waiter { handle, pNetwork_ } );
+                    }
+
+                    void await_resume() const noexcept
+                    {
+                    }
+
+                private:
+                    TestReactor & reactor_;
+                    NetworkContext_t * pNetwork_;
+            };
+
+            Awaiter waitForResponse( const SntpContext_t & context,
+                                     std::chrono::milliseconds timeout )
+            {
+                check( timeout <= testTimeout, "Timeout passed to the reactor" );
+                waitTimeouts_.push_back( timeout );
+
+                return Awaiter { *this, context.networkIntf.pUserContext };
+            }
+
+            /**
+             * @brief Runs steps until no coroutine waits.
+             *
+             * @return The number of steps.
+             */
+            std::uint32_t run()
+            {
+                std::uint32_t steps = 0U;
+
+                while( !waiting_.empty() )
+                {
+                    std::deque<Waiter> ready;
+
+                    ready.swap( waiting_ );
+                    testTimeSecs++;
+                    steps++;
+
+                    for( Waiter & waiter : ready )
+                    {
+                        if( std::strcmp( waiter.pNetwork->pServer->pServerName, downServerName ) != 0 )
+                        {
+                            waiter.pNetwork->isReadable = true;
+                        }
+
+                        waiter.handle.resume();
+                    }
+
+                    maxWaiting_ = ( ready.size() > maxWaiting_ ) ? ready.size() : maxWaiting_;
+                }
+
+                return steps;
+            }
+
+            /**
+             * @brief The largest number of coroutines that waited together.
+             */
+            std::size_t maxWaiting() const noexcept
+            {
+                return maxWaiting_;
+            }
+
+            /**
+             * @brief The timeout of a wait, in the order of the waits, or a
+             * negative timeout past the recorded waits.
+             */
+            std::chrono::milliseconds waitTimeout( std::size_t index ) const noexcept
+            {
+                return ( index < waitTimeouts_.size() ) ? waitTimeouts_[ index ] : std::chrono::milliseconds { -1 };
+            }
+
+        private:
+
+            /**
+             * @brief A coroutine waiting for the response of a transport.
+             */
+            struct Waiter
+            {
+                std::coroutine_handle<> handle;
+                NetworkContext_t * pNetwork;
+            };
+
+            std::deque<Waiter> waiting_;
+            std::size_t maxWaiting_ = 0U;
+            std::vector<std::chrono::milliseconds> waitTimeouts_;
+    };
+
+    using TestClient = sntp::AsyncClient<TestReactor>;
+
+    /**
+     * @brief Queries every server in turn until one answers.
+     */
+    sntp::Task<SntpStatus_t> synchronize( TestClient & client )
+    {
+        SntpStatus_t status = SntpErrorNetworkFailure;
+        std::size_t attempt;
+
+        for( attempt = 0U; ( attempt < std::size( testServers ) ) && ( status != SntpSuccess ); attempt++ )
+        {
+            status = co_await client.query( 0x12345678U, testTimeout );
+        }
+
+        co_return status;
+    }
+
+    /**
+     * @brief Sends a burst of queries, and counts the successful ones.
+     */
+    sntp::Task<std::uint32_t> burst( TestClient & client,
+                                     std::uint32_t numOfQueries )
+    {
+        std::uint32_t numOfSuccesses = 0U;
+        std::uint32_t query;
+
+        for( query = 0U; query < numOfQueries; query++ )
+        {
+            if( co_await client.query( query, testTimeout ) == SntpSuccess )
+            {
+                numOfSuccesses++;
+            }
+        }
+
+        co_return numOfSuccesses;
+    }
+
+    /**
+     * @brief Test concurrent queries of two clients on one thread.
+     */
+    void testConcurrentQueries()
+    {
+        NetworkContext_t networks[ 2 ] {};
+        UdpTransportInterface_t transports[ 2 ] = { { &networks[ 0 ], sendTo, recvFrom },
+                                                    { &networks[ 1 ], sendTo, recvFrom } };
+        sntp::Client<> first( &testServers[ 1 ], 1U, resolveDns, getTime, setTime, transports[ 0 ] );
+        sntp::Client<> second( &testServers[ 1 ], 1U, resolveDns, getTime, setTime, transports[ 1 ] );
+        TestReactor reactor;
+        TestClient firstAsync( first, reactor );
+        TestClient secondAsync( second, reactor );
+        sntp::Task<SntpStatus_t> firstQuery = firstAsync.query( 1U, testTimeout );
+        sntp::Task<SntpStatus_t> secondQuery = secondAsync.query( 2U, testTimeout );
+
+        setTimeCount = 0U;
+        firstQuery.start();
+        secondQuery.start();
+        check( !firstQuery.done() && !secondQuery.done(), "Queries suspend until the responses" );
+        check( reactor.run() == 1U, "Queries complete in one step" );
+        check( reactor.maxWaiting() == 2U, "Queries wait together" );
+        check( firstQuery.done() && ( firstQuery.result() == SntpSuccess ), "First query succeeds" );
+        check( secondQuery.done() && ( secondQuery.result() == SntpSuccess ), "Second query succeeds" );
+        check( setTimeCount == 2U, "System time updated by both queries" );
+    }
+
+    /**
+     * @brief Test the failover from a server that does not answer.
+     */
+    void testFailover()
+    {
+        NetworkContext_t network {};
+        UdpTransportInterface_t transport { &network, sendTo, recvFrom };
+        sntp::Client<> client( testServers, resolveDns, getTime, setTime, transport );
+        TestReactor reactor;
+        TestClient async( client, reactor );
+        sntp::Task<SntpStatus_t> task = synchronize( async );
+
+        task.start();
+        /* The random bits of the request time delay the timeout to the fourth step. */
+        check( reactor.run() == 5U, "Timeout of the first server, and response of the second" );
+        check( task.done() && ( task.result() == SntpSuccess ), "Failover succeeds" );
+        check( client.context().currentServerIndex == 1U, "Client moved to the second server" );
+        check( network.numOfReads == 5U, "Reads on each resumption" );
+    }
+
+    /**
+     * @brief Test a burst of queries.
+     */
+    void testBurst()
+    {
+        NetworkContext_t network {};
+        UdpTransportInterface_t transport { &network, sendTo, recvFrom };
+        sntp::Client<> client( &testServers[ 1 ], 1U, resolveDns, getTime, setTime, transport );
+        TestReactor reactor;
+        TestClient async( client, reactor );
+        sntp::Task<std::uint32_t> task = burst( async, 4U );
+
+        task.start();
+        check( reactor.run() == 4U, "One step per query of the burst" );
+        check( task.done() && ( task.result() == 4U ), "All queries of the burst succeed" );
+    }
+
+    /**
+     * @brief Test a query whose request fails.
+     */
+    void testFailedRequest()
+    {
+        NetworkContext_t network {};
+        UdpTransportInterface_t transport { &network, sendTo, recvFrom };
+        sntp::Client<> client( &testServers[ 1 ], 1U, resolveDns,
+                               []( SntpTimestamp_t * ) { return false; }, setTime, transport );
+        TestReactor reactor;
+        TestClient async( client, reactor );
+        sntp::Task<SntpStatus_t> task = async.query( 0U, testTimeout );
+
+        task.start();
+        check( task.done() && ( task.result() == SntpErrorSystemClockFailure ), "Failed request completes" );
+        check( reactor.run() == 0U, "Failed request does not wait" );
+    }
+
+    /**
+     * @brief Test the failover from a server that does not answer within the
+     * response timeout estimated from its latency, which is shorter than the
+     * timeout of the query.
+     */
+    void testEstimatedTimeout()
+    {
+        NetworkContext_t network {};
+        UdpTransportInterface_t transport { &network, sendTo, recvFrom };
+        sntp::Client<> client( testServers, resolveDns, getTime, setTime, transport );
+        SntpTimeoutEstimator_t estimators[ std::size( testServers ) ];
+        TestReactor reactor;
+        TestClient async( client, reactor );
+        sntp::Task<SntpStatus_t> task = synchronize( async );
+
+        /* A latency of 300 milliseconds estimates a timeout of 900 milliseconds. */
+        check( Sntp_InitTimeoutEstimators( estimators, std::size( estimators ) ) == SntpSuccess,
+               "Estimators initialized" );
+        check( Sntp_UpdateTimeoutEstimator( &estimators[ 0 ], ( INT64_C( 3 ) << 32 ) / 10 ) == SntpSuccess,
+               "Latency recorded" );
+        check( Sntp_SetTimeoutEstimators( &client.context(), estimators ) == SntpSuccess, "Estimators set" );
+
+        task.start();
+        check( ( reactor.waitTimeout( 0U ) > std::chrono::milliseconds { 800 } ) &&
+               ( reactor.waitTimeout( 0U ) <= std::chrono::milliseconds { 900 } ),
+               "Reactor waits for the estimated timeout" );
+        check( reactor.run() == 2U, "Timeout of the first server after one step, and response of the second" );
+        check( reactor.waitTimeout( 1U ) == testTimeout, "Reactor waits for the query timeout without an estimate" );
+        check( task.done() && ( task.result() == SntpSuccess ), "Failover succeeds" );
+        check( client.context().currentServerIndex == 1U, "Client moved to the second server" );
+    }
+
+    /**
+     * @brief Test that a query wakes when its request is due to be hedged, and
+     * accepts the hedged response.
+     */
+    void testHedging()
+    {
+        NetworkContext_t network {};
+        UdpTransportInterface_t transport { &network, sendTo, recvFrom };
+        sntp::Client<> client( testServers, resolveDns, getTime, setTime, transport );
+        SntpServerHistograms_t histograms[ std::size( testServers ) ];
+        TestReactor reactor;
+        TestClient async( client, reactor );
+        sntp::Task<SntpStatus_t> task = async.query( 0U, testTimeout );
+        std::uint32_t setTimes = setTimeCount;
+
+        /* Requests to the first server are hedged after about 100 milliseconds. */
+        check( Sntp_InitServerHistograms( histograms, std::size( histograms ) ) == SntpSuccess,
+               "Histograms initialized" );
+
+        for( std::uint32_t i = 0U; i < SNTP_HEDGE_MIN_SAMPLES; i++ )
+        {
+            check( Sntp_RecordHistogramValue( &histograms[ 0 ].responseLatency, 100000U ) == SntpSuccess,
+                   "Latency recorded" );
+        }
+
+        check( Sntp_SetServerHistograms( &client.context(), histograms ) == SntpSuccess, "Histograms set" );
+        check( Sntp_SetHedging( &client.context(), SNTP_MAX_HEDGE_PERCENT ) == SntpSuccess, "Hedging set" );
+
+        task.start();
+        check( ( reactor.waitTimeout( 0U ) > std::chrono::milliseconds { 0 } ) &&
+               ( reactor.waitTimeout( 0U ) < std::chrono::milliseconds { 200 } ),
+               "Reactor wakes when the request is due to be hedged" );
+        check( reactor.run() == 2U, "Hedge after one step, and hedged response after another" );
+        check( reactor.waitTimeout( 1U ) == testTimeout - std::chrono::seconds { 1 },
+               "Reactor waits for the response timeout once hedged" );
+        check( task.done() && ( task.result() == SntpSuccess ), "Hedged query succeeds" );
+        check( setTimeCount == setTimes + 1U, "Hedged response corrects the time" );
+        check( client.context().currentServerIndex == 0U, "Hedged response keeps the current server" );
+    }
+}
+
+int main()
+{
+    testConcurrentQueries();
+    testFailover();
+    testBurst();
+    testFailedRequest();
+    testEstimatedTimeout();
+    testHedging();
+
+    std::printf( "%s\n", ( failures == 0 ) ? "PASS" : "FAIL" );
+
+    return ( failures == 0 ) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,244 @@
+/*
+ * coreSNTP v1.0.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file core_sntp_cpp_test.cpp
+ * @brief Tests of the C++ interface of the coreSNTP library.
+ */
+
+/* Standard includes. */
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+/* coreSNTP C++ interface. */
+#include "core_sntp_client.hpp"
+
+/**
+ * @brief The network context of the test transport, which answers every
+ * request with a response one second ahead of the system time.
+ */
+struct NetworkContext
+{
+    std::array<std::uint8_t, SNTP_PACKET_BASE_SIZE> request;  /**< @brief The last request. */
+    bool hasRequest;                                          /**< @brief Whether a request is pending. */
+};
+
+namespace
+{
+    /* The request template is built at compile time. */
+    static_assert( sntp::defaultRequest.bytes()[ 0 ] == 0x23U, "Version 4 client mode." );
+    static_assert( sntp::defaultRequest.version( 3U ).poll( 6 ).bytes()[ 0 ] == 0x1BU, "Version 3 client mode." );
+    static_assert( sntp::defaultRequest.poll( 6 ).bytes()[ 2 ] == 6U, "Poll exponent." );
+    static_assert( sntp::RequestTemplate::size == SNTP_PACKET_BASE_SIZE, "Packet size." );
+
+    /**
+     * @brief The system time of the test, in SNTP era 0.
+     */
+    constexpr std::uint32_t testSystemTimeSecs = 3900000000U;
+
+    /**
+     * @brief The number of failed checks.
+     */
+    int failures = 0;
+
+    /**
+     * @brief The clock offset passed to the set time function.
+     */
+    std::int32_t setTimeOffsetSecs = 0;
+
+    /**
+     * @brief Counts and reports a failed check.
+     */
+    void check( bool condition,
+                const char * pDescription )
+    {
+        if( !condition )
+        {
+            std::printf( "FAIL: %s\n", pDescription );
+            failures++;
+        }
+    }
+
+    bool resolveDns( const char * pServerAddr,
+                     std::uint32_t * pIpV4Addr )
+    {
+        ( void ) pServerAddr;
+        *pIpV4Addr = 0x7F000001U;
+
+        return true;
+    }
+
+    bool getTime( SntpTimestamp_t * pCurrentTime )
+    {
+        pCurrentTime->seconds = testSystemTimeSecs;
+        pCurrentTime->fractions = 0U;
+
+        return true;
+    }
+
+    bool setTime( const char * pTimeServer,
+                  const SntpTimestamp_t * pServerTime,
+                  std::int32_t clockOffsetSec )
+    {
+        ( void ) pTimeServer;
+        ( void ) pServerTime;
+        setTimeOffsetSecs = clockOffsetSec;
+
+        return true;
+    }
+
+    std::int32_t sendTo( NetworkContext_t * pNetworkContext,
+                         const SntpServerInfo_t * pTimeServer,
+                         const void * pBuffer,
+                         std::size_t bytesToSend )
+    {
+        ( void ) pTimeServer;
+        std::memcpy( pNetworkContext->request.data(), pBuffer, SNTP_PACKET_BASE_SIZE );
+        pNetworkContext->hasRequest = true;
+
+        return static_cast<std::int32_t>( bytesToSend );
+    }
+
+    std::int32_t recvFrom( NetworkContext_t * pNetworkContext,
+                           SntpServerInfo_t * pTimeServer,
+                           void * pBuffer,
+                           std::size_t bytesToRecv )
+    {
+        auto * pResponse = static_cast<std::uint8_t *>( pBuffer );
+        std::int32_t bytesReceived = 0;
+
+        ( void ) pTimeServer;
+
+        if( pNetworkContext->hasRequest )
+        {
+            pNetworkContext->hasRequest = false;
+            std::memset( pResponse, 0, bytesToRecv );
+
+            /* Version 4 server mode response of a stratum 1 server, with the
+             * transmit time of the request as originate time, and receive and
+             * transmit times one second later. */
+            pResponse[ 0 ] = 0x24U;
+            pResponse[ 1 ] = 1U;
+            std::memcpy( &pResponse[ 24 ], &pNetworkContext->request[ 40 ], 8U );
+            std::memcpy( &pResponse[ 32 ], &pNetworkContext->request[ 40 ], 8U );
+            pResponse[ 35 ]++;
+            std::memcpy( &pResponse[ 40 ], &pResponse[ 32 ], 8U );
+            bytesReceived = static_cast<std::int32_t>( bytesToRecv );
+        }
+
+        return bytesReceived;
+    }
+
+    /**
+     * @brief Test that the request template serializes the same requests as
+     * the C API.
+     */
+    void testRequestTemplate()
+    {
+        std::array<std::uint8_t, SNTP_PACKET_BASE_SIZE> expected {};
+        std::array<std::uint8_t, SNTP_PACKET_BASE_SIZE> actual {};
+        SntpTimestamp_t expectedTime { testSystemTimeSecs, 0x12340000U };
+        SntpTimestamp_t actualTime = expectedTime;
+
+        check( Sntp_SerializeRequest( &expectedTime, 0xABCD1234U, expected.data(), expected.size() ) == SntpSuccess,
+               "C request serialized" );
+        check( sntp::defaultRequest.serialize( actualTime, 0xABCD1234U, actual.data(), actual.size() ) == SntpSuccess,
+               "Template request serialized" );
+        check( expected == actual, "Template request matches the C request" );
+        check( ( expectedTime.fractions == actualTime.fractions ), "Random bits added to the request time" );
+
+        check( sntp::defaultRequest.serialize( actualTime, 0U, nullptr, actual.size() ) == SntpErrorBadParameter,
+               "Template rejects a NULL buffer" );
+        check( sntp::defaultRequest.serialize( actualTime, 0U, actual.data(), actual.size() - 1U ) ==
+               SntpErrorBufferTooSmall, "Template rejects a small buffer" );
+    }
+
+    /**
+     * @brief Test the conversions of times and durations.
+     */
+    void testConversions()
+    {
+        using namespace std::chrono;
+        SntpResponseData_t response {};
+        SntpTimestamp_t timestamp {};
+        sntp::SystemTime time {};
+        seconds interval {};
+
+        response.clockOffsetFractions = -( static_cast<std::int64_t>( 1 ) << 31 );
+        response.roundTripDelayFractions = static_cast<std::int64_t>( 1 ) << 30;
+        check( sntp::clockOffset( response ) == milliseconds { -500 }, "Clock offset duration" );
+        check( duration_cast<milliseconds>( sntp::roundTripDelay( response ) ) == milliseconds { 250 },
+               "Round-trip delay duration" );
+
+        /* Times before the UNIX epoch round down to whole seconds. */
+        check( sntp::fromSystemTime( sntp::SystemTime { nanoseconds { -1 } }, timestamp ) == SntpSuccess,
+               "Conversion from system time" );
+        check( timestamp.seconds == ( SNTP_TIME_AT_UNIX_EPOCH_SECS - 1U ), "Seconds before the UNIX epoch" );
+        check( sntp::toSystemTime( timestamp, time, seconds { 0 } ) == SntpSuccess, "Conversion to system time" );
+        check( time == sntp::SystemTime { nanoseconds { -1 } }, "Round trip of system time" );
+        check( sntp::toSystemTime( timestamp, time, seconds { SNTP_MAX_ERA_PIVOT_UNIX_SECS } + seconds { 1 } ) ==
+               SntpErrorBadParameter, "Pivot out of range" );
+
+        check( sntp::pollInterval( 200U, minutes { 1 }, interval ) == SntpSuccess, "Poll interval" );
+        check( interval == seconds { 1L << 18 }, "Poll interval of 200 PPM and 1 minute" );
+        check( sntp::pollInterval( 200U, milliseconds { 70000 }, interval ) == SntpErrorBadParameter,
+               "Accuracy out of range" );
+    }
+
+    /**
+     * @brief Test a time request with the client.
+     */
+    void testClient()
+    {
+        static const SntpServerInfo_t servers[] = { { "time.example.com", SNTP_DEFAULT_SERVER_PORT } };
+        NetworkContext_t network {};
+        UdpTransportInterface_t transport { &network, sendTo, recvFrom };
+
+        sntp::Client<> invalid( nullptr, 0U, resolveDns, getTime, setTime, transport );
+        check( !invalid, "Client without servers is not initialized" );
+        check( invalid.status() == SntpErrorBadParameter, "Status of the client without servers" );
+
+        sntp::Client<64U> client( servers, resolveDns, getTime, setTime, transport );
+        check( static_cast<bool>( client ), "Client initialized" );
+        check( client.context().pTimeServers == servers, "Client servers" );
+        check( client.sendTimeRequest( 0x5555AAAAU ) == SntpSuccess, "Request sent" );
+        check( client.receiveTimeResponse( std::chrono::seconds { 5 } ) == SntpSuccess, "Response received" );
+        check( setTimeOffsetSecs == 1, "Clock offset of the response" );
+        check( client.receiveTimeResponse( std::chrono::hours { 24 * 365 * 200 } ) == SntpNoResponseReceived,
+               "Long timeouts are limited" );
+    }
+}
+
+int main()
+{
+    testRequestTemplate();
+    testConversions();
+    testClient();
+
+    std::printf( "%s\n", ( failures == 0 ) ? "PASS" : "FAIL" );
+
+    return ( failures == 0 ) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,40 @@
+# Runs the pcap analyzer on a capture of generate_captures.py, and checks the
+# statistics that it prints.
+#
+# Variables:
+# - ANALYZER: The path of the analyzer.
+# - CAPTURE: The path of the capture.
+# - OVERSIZED_PACKETS: The number of packets of the capture that are too large
+#   for the analyzer.
+
+# Two workers, so that the statistics of the workers are merged.
+execute_process( COMMAND ${ANALYZER} -j 2 ${CAPTURE}
+                 RESULT_VARIABLE __RESULT
+                 OUTPUT_VARIABLE __OUTPUT
+                 ERROR_VARIABLE __ERROR )
+
+if( NOT ${__RESULT} EQUAL 0 )
+    message( FATAL_ERROR "The analyzer failed (${__RESULT}):\n${__ERROR}" )
+endif()
+
+# The truncated record at the end of the capture is reported, and the packets
+# before it are analyzed.
+set( __EXPECTED_ERROR "capture is truncated or corrupt" )
+
+# The snapshot of one packet is too short for an NTP packet.
+set( __EXPECTED_OUTPUT
+     "9 packets, 8 NTP packets, ${OVERSIZED_PACKETS} oversized packets skipped"
+     # Offsets of 5, 15 and 10 ms, and delays of 20, 40 and 30 ms.
+     "198\\.51\\.100\\.1 +3 +3 +0 +0 +0 +0/ +0/ +0/ +0 +10\\.000/ +5\\.000/ +5\\.000/ +15\\.000 +30\\.000/ +20\\.000/ +40\\.000"
+     # A RATE Kiss-o'-Death, without offset or delay.
+     "198\\.51\\.100\\.2 +1 +1 +0 +0 +0 +0/ +0/ +1/ +0 " )
+
+if( NOT "${__ERROR}" MATCHES "${__EXPECTED_ERROR}" )
+    message( FATAL_ERROR "Expected \"${__EXPECTED_ERROR}\" in the errors:\n${__ERROR}" )
+endif()
+
+foreach( __EXPECTED ${__EXPECTED_OUTPUT} )
+    if( NOT "${__OUTPUT}" MATCHES "${__EXPECTED}" )
+        message( FATAL_ERROR "Expected \"${__EXPECTED}\" in the output:\n${__OUTPUT}" )
+    endif()
+endforeach()
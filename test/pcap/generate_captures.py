@@ -0,0 +1,141 @@
+#!/usr/bin/env python3
+#
+# Generates the captures of the tests of the pcap analyzer. Run from this
+# directory after changing the traffic, and update the expected output in
+# CMakeLists.txt.
+#
+# Both captures hold the same traffic, on Ethernet:
+# - Three request and response pairs between 192.0.2.10 and 198.51.100.1, with
+#   clock offsets of 5, 15 and 10 ms, and round-trip delays of 20, 40 and 30 ms.
+# - A request to 198.51.100.2, answered by a RATE Kiss-o'-Death.
+# - A response cut short by the snapshot length, which is not an NTP packet.
+# - A last record that is cut short by the end of the file: a packet in the pcap
+#   capture, and a packet larger than the analyzer reads in the pcapng capture.
+
+import struct
+
+CLIENT = bytes( [ 192, 0, 2, 10 ] )
+SERVER = bytes( [ 198, 51, 100, 1 ] )
+RATE_SERVER = bytes( [ 198, 51, 100, 2 ] )
+
+# 2021-01-01T00:00:00Z, in UNIX and NTP time.
+START_UNIX_SECS = 1609459200
+START_NTP_SECS = START_UNIX_SECS + 2208988800
+
+NANOSECONDS_PER_SECOND = 1000000000
+
+
+def ntp_timestamp( nanoseconds ):
+    """ Returns the NTP timestamp of nanoseconds since the start time. """
+    seconds, remainder = divmod( nanoseconds, NANOSECONDS_PER_SECOND )
+    fractions = ( remainder << 32 ) // NANOSECONDS_PER_SECOND
+
+    return struct.pack( ">II", START_NTP_SECS + seconds, fractions )
+
+
+def ntp_packet( mode, stratum = 0, reference = b"\0\0\0\0", origin = b"\0" * 8,
+                receive = b"\0" * 8, transmit = b"\0" * 8 ):
+    """ Returns a version 4 NTP packet without extensions. """
+    return struct.pack( ">BBbbII4s8s8s8s8s", ( 4 << 3 ) | mode, stratum, 4, -20, 0, 0,
+                        reference, receive, origin, receive, transmit )
+
+
+def frame( source, destination, sourcePort, destinationPort, payload ):
+    """ Returns the Ethernet frame of a UDP datagram over IPv4. """
+    udp = struct.pack( ">HHHH", sourcePort, destinationPort, 8 + len( payload ), 0 ) + payload
+    ip = struct.pack( ">BBHHHBBH4s4s", 0x45, 0, 20 + len( udp ), 0, 0x4000, 64, 17, 0,
+                      source, destination ) + udp
+
+    return b"\x02\0\0\0\0\x02" + b"\x02\0\0\0\0\x01" + b"\x08\x00" + ip
+
+
+def packets():
+    """ Returns the captured packets, as pairs of capture time and frame. """
+    result = []
+    port = 40000
+
+    # The request is sent, and captured, at the client clock time.
+    for index, ( offsetMs, delayMs ) in enumerate( [ ( 5, 20 ), ( 15, 40 ), ( 10, 30 ) ] ):
+        requestNs = index * NANOSECONDS_PER_SECOND
+        serverNs = requestNs + ( delayMs + 2 * offsetMs ) * 500000
+        request = ntp_timestamp( requestNs )
+        response = ntp_packet( 4, 1, b"GPS\0", request, ntp_timestamp( serverNs ), ntp_timestamp( serverNs ) )
+
+        result.append( ( requestNs, frame( CLIENT, SERVER, port + index, 123, ntp_packet( 3, transmit = request ) ) ) )
+        result.append( ( requestNs + delayMs * 1000000,
+                         frame( SERVER, CLIENT, 123, port + index, response ) ) )
+
+    requestNs = 3 * NANOSECONDS_PER_SECOND
+    request = ntp_timestamp( requestNs )
+    result.append( ( requestNs, frame( CLIENT, RATE_SERVER, port + 3, 123, ntp_packet( 3, transmit = request ) ) ) )
+    result.append( ( requestNs + 25000000,
+                     frame( RATE_SERVER, CLIENT, 123, port + 3,
+                            ntp_packet( 4, 0, b"RATE", request, b"\0" * 8, request ) ) ) )
+
+    return result
+
+
+def truncated_packet():
+    """ Returns a response cut short by the snapshot length, and its length. """
+    data = frame( SERVER, CLIENT, 123, 40004, ntp_packet( 4, 1, b"GPS\0" ) )
+
+    return ( 4 * NANOSECONDS_PER_SECOND, data[ :60 ], len( data ) )
+
+
+def write_pcap( path ):
+    """ Writes the pcap capture, with microsecond timestamps. """
+    with open( path, "wb" ) as capture:
+        capture.write( struct.pack( "<IHHiIII", 0xA1B2C3D4, 2, 4, 0, 0, 65535, 1 ) )
+
+        for timeNs, data in packets():
+            capture.write( struct.pack( "<IIII", START_UNIX_SECS + timeNs // NANOSECONDS_PER_SECOND,
+                                        ( timeNs % NANOSECONDS_PER_SECOND ) // 1000, len( data ), len( data ) ) )
+            capture.write( data )
+
+        timeNs, data, length = truncated_packet()
+        capture.write( struct.pack( "<IIII", START_UNIX_SECS + timeNs // NANOSECONDS_PER_SECOND, 0,
+                                    len( data ), length ) )
+        capture.write( data )
+
+        # The file ends in the middle of the last packet.
+        capture.write( struct.pack( "<IIII", START_UNIX_SECS + 5, 0, 90, 90 ) )
+        capture.write( b"\0" * 10 )
+
+
+def pcapng_block( blockType, body ):
+    """ Returns a pcapng block, with its body padded to 32 bits. """
+    body += b"\0" * ( -len( body ) % 4 )
+    length = 12 + len( body )
+
+    return struct.pack( "<II", blockType, length ) + body + struct.pack( "<I", length )
+
+
+def enhanced_packet_block( timeNs, data, length ):
+    """ Returns an enhanced packet block, with nanosecond timestamps. """
+    timestamp = START_UNIX_SECS * NANOSECONDS_PER_SECOND + timeNs
+
+    return pcapng_block( 6, struct.pack( "<IIIII", 0, timestamp >> 32, timestamp & 0xFFFFFFFF,
+                                         len( data ), length ) + data )
+
+
+def write_pcapng( path ):
+    """ Writes the pcapng capture, with nanosecond timestamps. """
+    with open( path, "wb" ) as capture:
+        capture.write( pcapng_block( 0x0A0D0D0A, struct.pack( "<IHHq", 0x1A2B3C4D, 1, 0, -1 ) ) )
+
+        # An interface with the if_tsresol option of nanoseconds.
+        capture.write( pcapng_block( 1, struct.pack( "<HHI", 1, 0, 0 ) +
+                                     struct.pack( "<HHB3x", 9, 1, 9 ) + struct.pack( "<HH", 0, 0 ) ) )
+
+        for timeNs, data in packets():
+            capture.write( enhanced_packet_block( timeNs, data, len( data ) ) )
+
+        capture.write( enhanced_packet_block( *truncated_packet() ) )
+
+        # The file ends in the middle of a packet larger than the analyzer reads.
+        capture.write( struct.pack( "<II", 6, 12 + 20 + 1048576 ) )
+        capture.write( b"\0" * 10 )
+
+
+write_pcap( "ntp_traffic.pcap" )
+write_pcapng( "ntp_traffic.pcapng" )
@@ -0,0 +1,349 @@
+/*
+ * coreSNTP v1.0.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file core_sntp_fleet_benchmark.c
+ * @brief Benchmark of the per-context costs of the coreSNTP client, with fleets
+ * of client contexts polling in-process simulated servers.
+ *
+ * Each member of the fleet has its own #SntpContext_t, network buffer,
+ * transport interface and virtual clock, and all of them share the servers and
+ * network of one simulator. A scheduler, a binary heap of the next poll times,
+ * runs the polls of the fleet in virtual time. For each fleet size, the program
+ * reports:
+ * - the CPU time per time synchronization, in total, and in the library calls
+ *   that send a request and process its response;
+ * - the time per poll spent in the scheduler;
+ * - the memory per member of the fleet, both the size of its structures and the
+ *   growth of the resident memory of the process.
+ *
+ * The command line arguments are the fleet sizes (10000, 30000 and 100000 by
+ * default). The program exits with a failure status if any time
+ * synchronization fails, so that it can run as a test.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <time.h>
+
+/* Include coreSNTP headers. */
+#include "core_sntp_client.h"
+#include "core_sntp_clock.h"
+
+/* Include simulator header. */
+#include "core_sntp_simulator.h"
+
+/* The number of nanoseconds in a microsecond and in a second. */
+#define NS_PER_US              ( ( int64_t ) 1000 )
+#define NS_PER_SEC             ( ( int64_t ) 1000000000 )
+
+/* The interval between the polls of each member, in virtual time. */
+#define POLL_INTERVAL_SECS     ( 64 )
+
+/* The number of polls of each member. */
+#define NUM_OF_POLLS           ( 4 )
+
+/* The time to wait for each response. */
+#define RESPONSE_TIMEOUT_MS    ( 2000U )
+
+/* The number of simulated servers, which the members are spread over. */
+#define NUM_OF_SERVERS         ( 4U )
+
+/* The default fleet sizes. */
+static const size_t defaultFleetSizes[] = { 10000U, 30000U, 100000U };
+
+/**
+ * @brief A member of the fleet.
+ */
+typedef struct FleetMember
+{
+    SntpContext_t context;
+    NetworkContext_t networkContext;
+    UdpTransportInterface_t transportIntf;
+    SntpVirtualClock_t virtualClock;
+    uint8_t networkBuffer[ SNTP_PACKET_BASE_SIZE ];
+} FleetMember_t;
+
+/**
+ * @brief An entry of the scheduler heap.
+ */
+typedef struct PollEvent
+{
+    int64_t pollTimeNs;  /* The virtual time of the next poll. */
+    size_t member;       /* The index of the member. */
+} PollEvent_t;
+
+/* The simulated servers, with a LAN-like network path and no loss, so that
+ * virtual time stays close to the poll schedule of a large fleet. */
+static const SntpSimServer_t servers[ NUM_OF_SERVERS ] =
+{
+    { "a.sim.test", 0x0A000001U, false, { SntpSimDelayUniform, 20U, 20U },
+      { SntpSimDelayUniform, 20U, 20U }, 5U, 0U, 0U, 0U, 0, 0 },
+    { "b.sim.test", 0x0A000002U, false, { SntpSimDelayUniform, 20U, 20U },
+      { SntpSimDelayUniform, 20U, 20U }, 5U, 0U, 0U, 0U, 0, 0 },
+    { "c.sim.test", 0x0A000003U, false, { SntpSimDelayUniform, 20U, 20U },
+      { SntpSimDelayUniform, 20U, 20U }, 5U, 0U, 0U, 0U, 0, 0 },
+    { "d.sim.test", 0x0A000004U, false, { SntpSimDelayUniform, 20U, 20U },
+      { SntpSimDelayUniform, 20U, 20U }, 5U, 0U, 0U, 0U, 0, 0 }
+};
+
+/**
+ * @brief Reads a clock, in nanoseconds.
+ */
+static int64_t readClockNs( clockid_t clockId )
+{
+    struct timespec now;
+
+    ( void ) clock_gettime( clockId, &now );
+
+    return ( ( int64_t ) now.tv_sec * NS_PER_SEC ) + now.tv_nsec;
+}
+
+/**
+ * @brief Reads the resident memory of the process, in bytes, or 0 when it is
+ * not available.
+ */
+static int64_t readResidentBytes( void )
+{
+    FILE * pFile = fopen( "/proc/self/statm", "r" );
+    long totalPages = 0;
+    long residentPages = 0;
+
+    if( pFile != NULL )
+    {
+        if( fscanf( pFile, "%ld %ld", &totalPages, &residentPages ) != 2 )
+        {
+            residentPages = 0;
+        }
+
+        ( void ) fclose( pFile );
+    }
+
+    return ( int64_t ) residentPages * 4096;
+}
+
+/**
+ * @brief Moves the first entry of the scheduler heap down to its place.
+ */
+static void siftDown( PollEvent_t * pHeap,
+                      size_t count )
+{
+    PollEvent_t event = pHeap[ 0 ];
+    size_t index = 0U;
+    size_t child = 1U;
+
+    while( child < count )
+    {
+        if( ( ( child + 1U ) < count ) && ( pHeap[ child + 1U ].pollTimeNs < pHeap[ child ].pollTimeNs ) )
+        {
+            child++;
+        }
+
+        if( pHeap[ child ].pollTimeNs >= event.pollTimeNs )
+        {
+            break;
+        }
+
+        pHeap[ index ] = pHeap[ child ];
+        index = child;
+        child = ( 2U * index ) + 1U;
+    }
+
+    pHeap[ index ] = event;
+}
+
+/**
+ * @brief Runs the polls of a fleet, and prints its costs.
+ *
+ * @return `true` if every time synchronization succeeds.
+ */
+static bool runFleet( size_t fleetSize )
+{
+    static SntpServerInfo_t serverInfo[ 2U * NUM_OF_SERVERS ];
+    SntpSimulator_t simulator;
+    SntpSimConfig_t config;
+    FleetMember_t * pFleet;
+    FleetMember_t * pMember;
+    PollEvent_t * pHeap;
+    SntpStatus_t status;
+    int64_t residentBefore;
+    int64_t residentAfter;
+    int64_t cpuStartNs;
+    int64_t cpuNs;
+    int64_t syncStartNs;
+    int64_t syncNs = 0;
+    int64_t loopNs;
+    uint64_t numOfSyncs = 0U;
+    uint64_t numOfFailures = 0U;
+    uint64_t numOfPolls = ( uint64_t ) fleetSize * NUM_OF_POLLS;
+    uint64_t poll;
+    size_t index;
+
+    config.seed = 0xF1EE7U + fleetSize;
+    config.startUnixTimeSecs = SNTP_DEFAULT_ERA_PIVOT_UNIX_SECS;
+    config.clockOffsetNs = 0;
+    config.clockDriftPpb = 0;
+    config.stepClockOnSetTime = false;
+    config.recvBlockTimeUs = 100U;
+    config.pServers = servers;
+    config.numOfServers = NUM_OF_SERVERS;
+
+    SntpSim_Init( &simulator, &config );
+
+    /* The list of servers is repeated, so that each member can start its list
+     * at a different server. */
+    for( index = 0U; index < ( 2U * NUM_OF_SERVERS ); index++ )
+    {
+        serverInfo[ index ].pServerName = servers[ index % NUM_OF_SERVERS ].pServerName;
+        serverInfo[ index ].port = SNTP_DEFAULT_SERVER_PORT;
+    }
+
+    /* Create the fleet, with the first polls spread over a poll interval. */
+    residentBefore = readResidentBytes();
+    pFleet = malloc( fleetSize * sizeof( FleetMember_t ) );
+    pHeap = malloc( fleetSize * sizeof( PollEvent_t ) );
+
+    if( ( pFleet == NULL ) || ( pHeap == NULL ) )
+    {
+        printf( "%10lu out of memory\n", ( unsigned long ) fleetSize );
+        free( pFleet );
+        free( pHeap );
+
+        return false;
+    }
+
+    for( index = 0U; index < fleetSize; index++ )
+    {
+        pMember = &pFleet[ index ];
+        SntpSim_InitTransportInterface( &simulator, &pMember->networkContext, &pMember->transportIntf );
+
+        ( void ) Sntp_Init( &pMember->context, &serverInfo[ index % NUM_OF_SERVERS ], NUM_OF_SERVERS,
+                            pMember->networkBuffer, sizeof( pMember->networkBuffer ),
+                            SntpSim_ResolveDns, SntpSim_GetTime, SntpSim_SetTime,
+                            &pMember->transportIntf, NULL );
+        ( void ) Sntp_InitVirtualClock( &pMember->virtualClock );
+        ( void ) Sntp_SetVirtualClock( &pMember->context, &pMember->virtualClock );
+
+        /* A heap sorted by poll time needs no sifting. */
+        pHeap[ index ].pollTimeNs = ( int64_t ) ( ( ( double ) index / ( double ) fleetSize ) *
+                                                  ( double ) ( POLL_INTERVAL_SECS * NS_PER_SEC ) );
+        pHeap[ index ].member = index;
+    }
+
+    residentAfter = readResidentBytes();
+
+    /* Run the polls in virtual time. */
+    cpuStartNs = readClockNs( CLOCK_PROCESS_CPUTIME_ID );
+    loopNs = readClockNs( CLOCK_MONOTONIC );
+
+    for( poll = 0U; poll < numOfPolls; poll++ )
+    {
+        pMember = &pFleet[ pHeap[ 0 ].member ];
+
+        if( pHeap[ 0 ].pollTimeNs > simulator.trueTimeNs )
+        {
+            SntpSim_AdvanceTime( &simulator, ( uint64_t ) ( pHeap[ 0 ].pollTimeNs - simulator.trueTimeNs ) );
+        }
+
+        syncStartNs = readClockNs( CLOCK_MONOTONIC );
+        status = Sntp_SendTimeRequest( &pMember->context, ( uint32_t ) poll );
+
+        while( ( status == SntpSuccess ) || ( status == SntpNoResponseReceived ) || ( status == SntpInvalidResponse ) )
+        {
+            status = Sntp_ReceiveTimeResponse( &pMember->context, RESPONSE_TIMEOUT_MS );
+
+            if( status == SntpSuccess )
+            {
+                break;
+            }
+        }
+
+        syncNs += readClockNs( CLOCK_MONOTONIC ) - syncStartNs;
+        numOfSyncs++;
+        numOfFailures += ( status == SntpSuccess ) ? 0U : 1U;
+
+        pHeap[ 0 ].pollTimeNs += POLL_INTERVAL_SECS * NS_PER_SEC;
+        siftDown( pHeap, fleetSize );
+    }
+
+    loopNs = readClockNs( CLOCK_MONOTONIC ) - loopNs;
+    cpuNs = readClockNs( CLOCK_PROCESS_CPUTIME_ID ) - cpuStartNs;
+
+    printf( "%10lu %10" PRIu64 " %10.2f %10.2f %12.1f %10lu %10.1f %8" PRIu64 "\n",
+            ( unsigned long ) fleetSize,
+            numOfSyncs,
+            ( double ) cpuNs / ( double ) numOfSyncs / ( double ) NS_PER_US,
+            ( double ) syncNs / ( double ) numOfSyncs / ( double ) NS_PER_US,
+            ( double ) ( loopNs - syncNs ) / ( double ) numOfSyncs,
+            ( unsigned long ) ( sizeof( FleetMember_t ) + sizeof( PollEvent_t ) ),
+            ( double ) ( residentAfter - residentBefore ) / ( double ) fleetSize,
+            numOfFailures );
+
+    free( pFleet );
+    free( pHeap );
+
+    return numOfFailures == 0U;
+}
+
+int main( int argc,
+          char ** argv )
+{
+    bool success = true;
+    size_t fleetSize;
+    int index;
+
+    printf( "%d polls of each member, every %d s; sizes in bytes: context %lu, "
+            "virtual clock %lu, transport %lu, network buffer %d\n\n",
+            NUM_OF_POLLS, POLL_INTERVAL_SECS,
+            ( unsigned long ) sizeof( SntpContext_t ),
+            ( unsigned long ) sizeof( SntpVirtualClock_t ),
+            ( unsigned long ) ( sizeof( UdpTransportInterface_t ) + sizeof( NetworkContext_t ) ),
+            SNTP_PACKET_BASE_SIZE );
+    printf( "%10s %10s %10s %10s %12s %10s %10s %8s\n",
+            "fleet", "syncs", "cpu us", "sync us", "sched ns", "bytes", "rss bytes", "failed" );
+
+    if( argc > 1 )
+    {
+        for( index = 1; index < argc; index++ )
+        {
+            fleetSize = ( size_t ) strtoul( argv[ index ], NULL, 10 );
+            success = ( fleetSize > 0U ) && runFleet( fleetSize ) && success;
+        }
+    }
+    else
+    {
+        for( index = 0; index < ( int ) ( sizeof( defaultFleetSizes ) / sizeof( defaultFleetSizes[ 0 ] ) ); index++ )
+        {
+            success = runFleet( defaultFleetSizes[ index ] ) && success;
+        }
+    }
+
+    printf( "\ncpu us: process CPU time per sync; sync us: time per sync in the library and\n"
+            "simulated network; sched ns: time per poll outside the sync (scheduler heap and\n"
+            "virtual time); bytes: structures per member; rss bytes: resident memory growth\n"
+            "per member\n" );
+
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
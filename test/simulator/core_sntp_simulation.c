@@ -0,0 +1,272 @@
+/*
+ * coreSNTP v1.0.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file core_sntp_simulation.c
+ * @brief Scenarios that run the coreSNTP client against the network and clock
+ * simulator, and report the convergence time and accuracy of the time corrected
+ * by a virtual clock.
+ *
+ * The program exits with a failure status if the accuracy of any scenario is
+ * worse than expected, so that it can run as a test. An optional command line
+ * argument sets the seed of the simulations.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <stdlib.h>
+#include <inttypes.h>
+#include <time.h>
+#include <math.h>
+
+/* Include coreSNTP headers. */
+#include "core_sntp_client.h"
+#include "core_sntp_clock.h"
+#include "core_sntp_filter.h"
+#include "core_sntp_stability.h"
+
+/* Include simulator header. */
+#include "core_sntp_simulator.h"
+
+/* The number of nanoseconds in a millisecond and in a second. */
+#define NS_PER_MS             ( ( int64_t ) 1000000 )
+#define NS_PER_SEC            ( ( int64_t ) 1000000000 )
+
+/* The interval between polls, in virtual time. */
+#define POLL_INTERVAL_SECS    ( 16 )
+
+/* The number of polls of each scenario (a little over an hour). */
+#define NUM_OF_POLLS          ( 256 )
+
+/* The time to wait for each response. */
+#define RESPONSE_TIMEOUT_MS   ( 2000U )
+
+/* The default seed of the simulations. */
+#define DEFAULT_SEED          ( 0x5EEDU )
+
+/**
+ * @brief A simulation scenario.
+ */
+typedef struct Scenario
+{
+    const char * pName;                  /* The name printed in the report. */
+    SntpSimServer_t servers[ SNTP_SIM_MAX_SERVERS ];
+    size_t numOfServers;
+    int64_t clockOffsetNs;               /* The initial error of the local clock. */
+    int32_t clockDriftPpb;               /* The frequency error of the local clock. */
+    bool useOutlierGate;                 /* Whether the client filters outliers. */
+    int64_t toleranceNs;                 /* The expected accuracy after convergence. */
+} Scenario_t;
+
+/* The scenarios. The servers have 1 ms of error, to check that the client
+ * follows server time rather than true time. */
+static const Scenario_t scenarios[] =
+{
+    {
+        "lan",
+        {
+            { "lan.server", 0x0A000001U, false,
+              { SntpSimDelayUniform, 100U, 200U }, { SntpSimDelayUniform, 100U, 200U },
+              20U, 0U, 0U, 0U, NS_PER_MS, 0 }
+        },
+        1U, 300 * NS_PER_MS, 20000, false, NS_PER_MS / 5
+    },
+    {
+        "wan-asymmetric-lossy",
+        {
+            { "wan.server", 0x0A000002U, false,
+              { SntpSimDelayUniform, 12000U, 2000U }, { SntpSimDelayUniform, 4000U, 2000U },
+              50U, 20U, 0U, 0U, NS_PER_MS, 0 }
+        },
+        1U, 2 * NS_PER_SEC, -35000, false, 6 * NS_PER_MS
+    },
+    {
+        "congested-reordering",
+        {
+            { "busy.server", 0x0A000003U, false,
+              { SntpSimDelayExponential, 5000U, 2000U }, { SntpSimDelayExponential, 5000U, 2000U },
+              50U, 10U, 50U, 2500000U, NS_PER_MS, 0 }
+        },
+        1U, -NS_PER_SEC, 10000, true, 10 * NS_PER_MS
+    },
+    {
+        "failover",
+        {
+            { "down.server", 0x0A000004U, true,
+              { SntpSimDelayConstant, 1000U, 0U }, { SntpSimDelayConstant, 1000U, 0U },
+              0U, 0U, 0U, 0U, 0, 0 },
+            { "up.server", 0x0A000005U, false,
+              { SntpSimDelayUniform, 1000U, 500U }, { SntpSimDelayUniform, 1000U, 500U },
+              20U, 0U, 0U, 0U, NS_PER_MS, 0 }
+        },
+        2U, 50 * NS_PER_MS, -5000, true, NS_PER_MS
+    }
+};
+
+/**
+ * @brief Runs a scenario, and prints its report.
+ *
+ * @param[in] pScenario The scenario.
+ * @param[in] seed The seed of the simulation.
+ *
+ * @return `true` if the accuracy is within the tolerance of the scenario.
+ */
+static bool runScenario( const Scenario_t * pScenario,
+                         uint64_t seed )
+{
+    SntpSimulator_t simulator;
+    SntpSimConfig_t config;
+    NetworkContext_t networkContext;
+    UdpTransportInterface_t transportIntf;
+    SntpServerInfo_t serverInfo[ SNTP_SIM_MAX_SERVERS ];
+    uint8_t networkBuffer[ SNTP_PACKET_BASE_SIZE ];
+    SntpContext_t context;
+    SntpVirtualClock_t virtualClock;
+    SntpOutlierGate_t outlierGate;
+    SntpStabilityEstimator_t estimator;
+    SntpTimestamp_t localTime;
+    SntpTimestamp_t correctedTime;
+    SntpStatus_t status;
+    int64_t pollStartNs;
+    int64_t errorNs;
+    int64_t convergenceTimeNs = 0;
+    int64_t maxErrorNs = 0;
+    double sumOfSquares = 0.0;
+    int numOfSamples = 0;
+    int poll;
+    size_t index;
+
+    config.seed = seed;
+    config.startUnixTimeSecs = SNTP_DEFAULT_ERA_PIVOT_UNIX_SECS;
+    config.clockOffsetNs = pScenario->clockOffsetNs;
+    config.clockDriftPpb = pScenario->clockDriftPpb;
+    config.stepClockOnSetTime = false;
+    config.recvBlockTimeUs = 10000U;
+    config.pServers = pScenario->servers;
+    config.numOfServers = pScenario->numOfServers;
+
+    SntpSim_Init( &simulator, &config );
+    SntpSim_InitTransportInterface( &simulator, &networkContext, &transportIntf );
+
+    for( index = 0U; index < pScenario->numOfServers; index++ )
+    {
+        serverInfo[ index ].pServerName = pScenario->servers[ index ].pServerName;
+        serverInfo[ index ].port = SNTP_DEFAULT_SERVER_PORT;
+    }
+
+    ( void ) Sntp_Init( &context, serverInfo, pScenario->numOfServers,
+                        networkBuffer, sizeof( networkBuffer ),
+                        SntpSim_ResolveDns, SntpSim_GetTime, SntpSim_SetTime,
+                        &transportIntf, NULL );
+    ( void ) Sntp_InitVirtualClock( &virtualClock );
+    ( void ) Sntp_SetVirtualClock( &context, &virtualClock );
+    ( void ) Sntp_InitStabilityEstimator( &estimator );
+    ( void ) Sntp_SetStabilityEstimator( &context, &estimator );
+
+    if( pScenario->useOutlierGate == true )
+    {
+        ( void ) Sntp_InitOutlierGate( &outlierGate,
+                                       SNTP_OUTLIER_GATE_DEFAULT_THRESHOLD,
+                                       SNTP_OUTLIER_GATE_DEFAULT_MAX_REJECTIONS );
+        ( void ) Sntp_SetOutlierGate( &context, &outlierGate );
+    }
+
+    for( poll = 0; poll < NUM_OF_POLLS; poll++ )
+    {
+        pollStartNs = simulator.trueTimeNs;
+
+        if( Sntp_SendTimeRequest( &context, ( uint32_t ) rand() ) == SntpSuccess )
+        {
+            /* Late responses to earlier requests are invalid for the current
+             * request, and are skipped to wait for its response. */
+            do
+            {
+                status = Sntp_ReceiveTimeResponse( &context, RESPONSE_TIMEOUT_MS );
+            } while( ( status == SntpNoResponseReceived ) || ( status == SntpInvalidResponse ) );
+        }
+
+        /* Measure the error of the corrected time against server time. */
+        ( void ) SntpSim_GetTime( &localTime );
+
+        if( Sntp_GetCorrectedTime( &virtualClock, &localTime, &correctedTime ) == SntpSuccess )
+        {
+            errorNs = SntpSim_GetTimeErrorNs( &simulator, &correctedTime ) - NS_PER_MS;
+
+            if( llabs( errorNs ) > pScenario->toleranceNs )
+            {
+                convergenceTimeNs = simulator.trueTimeNs;
+            }
+
+            /* The accuracy is measured over the second half of the scenario. */
+            if( poll >= ( NUM_OF_POLLS / 2 ) )
+            {
+                maxErrorNs = ( llabs( errorNs ) > maxErrorNs ) ? llabs( errorNs ) : maxErrorNs;
+                sumOfSquares += ( double ) errorNs * ( double ) errorNs;
+                numOfSamples++;
+            }
+        }
+
+        SntpSim_AdvanceTime( &simulator, ( uint64_t ) ( ( POLL_INTERVAL_SECS * NS_PER_SEC ) -
+                                                       ( simulator.trueTimeNs - pollStartNs ) ) );
+    }
+
+    printf( "%-22s %10.1f %12.1f %12.1f %6" PRIu32 "/%-6" PRIu32 " %6" PRIu32 " %s\n",
+            pScenario->pName,
+            ( double ) convergenceTimeNs / ( double ) NS_PER_SEC,
+            ( numOfSamples > 0 ) ? sqrt( sumOfSquares / numOfSamples ) / 1000.0 : 0.0,
+            ( double ) maxErrorNs / 1000.0,
+            simulator.stats.responsesDelivered,
+            simulator.stats.requestsSent,
+            simulator.stats.packetsLost,
+            ( ( numOfSamples > 0 ) && ( maxErrorNs <= pScenario->toleranceNs ) ) ? "ok" : "FAILED" );
+
+    return ( numOfSamples > 0 ) && ( maxErrorNs <= pScenario->toleranceNs );
+}
+
+int main( int argc,
+          char ** argv )
+{
+    uint64_t seed = DEFAULT_SEED;
+    clock_t cpuStart = clock();
+    bool success = true;
+    size_t index;
+
+    if( argc > 1 )
+    {
+        seed = ( uint64_t ) strtoull( argv[ 1 ], NULL, 0 );
+    }
+
+    srand( ( unsigned int ) seed );
+
+    printf( "seed 0x%" PRIx64 ", %d polls every %d s\n", seed, NUM_OF_POLLS, POLL_INTERVAL_SECS );
+    printf( "%-22s %10s %12s %12s %13s %6s\n",
+            "scenario", "converge_s", "rms_err_us", "max_err_us", "resp/req", "lost" );
+
+    for( index = 0U; index < ( sizeof( scenarios ) / sizeof( scenarios[ 0 ] ) ); index++ )
+    {
+        success = runScenario( &scenarios[ index ], seed + index ) && success;
+    }
+
+    printf( "cpu time %.3f s\n", ( double ) ( clock() - cpuStart ) / ( double ) CLOCKS_PER_SEC );
+
+    return ( success == true ) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,475 @@
+/*
+ * coreSNTP v1.0.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file core_sntp_simulator.c
+ * @brief Implementation of the network and clock simulator for the coreSNTP
+ * client.
+ */
+
+/* Standard includes. */
+#include <string.h>
+#include <assert.h>
+#include <math.h>
+
+/* Include coreSNTP batch conversion API header. */
+#include "core_sntp_batch.h"
+
+/* Include simulator header. */
+#include "core_sntp_simulator.h"
+
+/**
+ * @brief The number of nanoseconds in a second.
+ */
+#define NANOSECONDS_PER_SECOND         ( ( int64_t ) 1000000000 )
+
+/**
+ * @brief The number of nanoseconds in a microsecond.
+ */
+#define NANOSECONDS_PER_MICROSECOND    ( ( int64_t ) 1000 )
+
+/**
+ * @brief The first byte of simulated responses: no leap second warning, version
+ * 4 and server mode.
+ */
+#define RESPONSE_LEAP_VERSION_MODE     ( ( 4U << 3 ) | 4U )
+
+/**
+ * @brief The stratum of the simulated servers.
+ */
+#define RESPONSE_STRATUM               ( 1U )
+
+/**
+ * @brief The offsets of the fields of an SNTP packet used by the simulator.
+ */
+#define PACKET_STRATUM_OFFSET          ( 1U )
+#define PACKET_REF_ID_OFFSET           ( 12U )
+#define PACKET_REF_TIME_OFFSET         ( 16U )
+#define PACKET_ORIGIN_TIME_OFFSET      ( 24U )
+#define PACKET_RX_TIME_OFFSET          ( 32U )
+#define PACKET_TX_TIME_OFFSET          ( 40U )
+
+/**
+ * @brief The simulator used by the callback functions, which have no context
+ * parameter.
+ */
+static SntpSimulator_t * pActiveSimulator = NULL;
+
+/**
+ * @brief Returns the next value of the xorshift pseudo-random sequence of a
+ * simulator.
+ *
+ * @param[in, out] pSimulator The simulator.
+ *
+ * @return The next pseudo-random value.
+ */
+static uint64_t nextRandom( SntpSimulator_t * pSimulator )
+{
+    uint64_t state = pSimulator->randomState;
+
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    pSimulator->randomState = state;
+
+    return state;
+}
+
+/**
+ * @brief Decides whether an event with a given probability happens.
+ *
+ * @param[in, out] pSimulator The simulator.
+ * @param[in] perMille The probability of the event, in units of 0.1%.
+ *
+ * @return `true` if the event happens; `false` otherwise.
+ */
+static bool randomEvent( SntpSimulator_t * pSimulator,
+                         uint16_t perMille )
+{
+    return ( perMille > 0U ) && ( ( nextRandom( pSimulator ) % 1000U ) < perMille );
+}
+
+/**
+ * @brief Draws a network delay from a delay distribution.
+ *
+ * @param[in, out] pSimulator The simulator.
+ * @param[in] pDelay The delay distribution.
+ *
+ * @return The delay, in nanoseconds.
+ */
+static int64_t sampleDelay( SntpSimulator_t * pSimulator,
+                            const SntpSimDelay_t * pDelay )
+{
+    int64_t delayNs = ( int64_t ) pDelay->minDelayUs * NANOSECONDS_PER_MICROSECOND;
+    double uniform;
+
+    switch( pDelay->distribution )
+    {
+        case SntpSimDelayUniform:
+            delayNs += ( int64_t ) ( nextRandom( pSimulator ) %
+                                     ( ( uint64_t ) pDelay->spreadUs * NANOSECONDS_PER_MICROSECOND + 1U ) );
+            break;
+
+        case SntpSimDelayExponential:
+            /* A uniform value in ( 0, 1 ] from the upper 53 bits. */
+            uniform = ( ( double ) ( nextRandom( pSimulator ) >> 11 ) + 1.0 ) / 9007199254740992.0;
+            delayNs += ( int64_t ) ( -log( uniform ) * ( double ) pDelay->spreadUs *
+                                     ( double ) NANOSECONDS_PER_MICROSECOND );
+            break;
+
+        default:
+            /* Constant delay. */
+            break;
+    }
+
+    return delayNs;
+}
+
+/**
+ * @brief Calculates the drift of a clock over an elapsed time, without
+ * overflow for long simulations.
+ *
+ * @param[in] elapsedNs The elapsed true time.
+ * @param[in] driftPpb The frequency error of the clock, in parts per billion.
+ *
+ * @return The drift, in nanoseconds.
+ */
+static int64_t calculateDrift( int64_t elapsedNs,
+                               int32_t driftPpb )
+{
+    return ( ( elapsedNs / NANOSECONDS_PER_SECOND ) * driftPpb ) +
+           ( ( ( elapsedNs % NANOSECONDS_PER_SECOND ) * driftPpb ) / NANOSECONDS_PER_SECOND );
+}
+
+/**
+ * @brief Reads the UNIX time, in nanoseconds, of the local clock.
+ *
+ * @param[in] pSimulator The simulator.
+ *
+ * @return The local time.
+ */
+static int64_t readLocalClock( const SntpSimulator_t * pSimulator )
+{
+    int64_t elapsedNs = pSimulator->trueTimeNs - pSimulator->localOriginTrueNs;
+
+    return pSimulator->localOriginUnixNs + elapsedNs +
+           calculateDrift( elapsedNs, pSimulator->config.clockDriftPpb );
+}
+
+/**
+ * @brief Reads the UNIX time, in nanoseconds, of the clock of a server at a
+ * true time.
+ *
+ * @param[in] pSimulator The simulator.
+ * @param[in] pServer The server.
+ * @param[in] trueTimeNs The true time since the start of the simulation.
+ *
+ * @return The server time.
+ */
+static int64_t readServerClock( const SntpSimulator_t * pSimulator,
+                                const SntpSimServer_t * pServer,
+                                int64_t trueTimeNs )
+{
+    return ( pSimulator->config.startUnixTimeSecs * NANOSECONDS_PER_SECOND ) + trueTimeNs +
+           pServer->clockOffsetNs + calculateDrift( trueTimeNs, pServer->clockDriftPpb );
+}
+
+/**
+ * @brief Writes a UNIX time, in nanoseconds, as an SNTP timestamp in network
+ * byte order.
+ *
+ * @param[out] pBuffer The buffer to write the 8 bytes of the timestamp to.
+ * @param[in] unixTimeNs The time to write.
+ */
+static void writeTimestamp( uint8_t * pBuffer,
+                            int64_t unixTimeNs )
+{
+    SntpTimestamp_t timestamp;
+    int i;
+
+    ( void ) Sntp_ConvertFromUnixNanosecsBatch( &unixTimeNs, 1U, &timestamp );
+
+    for( i = 0; i < 4; i++ )
+    {
+        pBuffer[ i ] = ( uint8_t ) ( timestamp.seconds >> ( 24 - ( 8 * i ) ) );
+        pBuffer[ i + 4 ] = ( uint8_t ) ( timestamp.fractions >> ( 24 - ( 8 * i ) ) );
+    }
+}
+
+/**
+ * @brief Finds a simulated server by name.
+ *
+ * @param[in] pSimulator The simulator.
+ * @param[in] pServerName The name of the server.
+ *
+ * @return The server, or NULL if there is no server with the name.
+ */
+static const SntpSimServer_t * findServer( const SntpSimulator_t * pSimulator,
+                                           const char * pServerName )
+{
+    const SntpSimServer_t * pServer = NULL;
+    size_t index;
+
+    for( index = 0U; ( index < pSimulator->config.numOfServers ) && ( pServer == NULL ); index++ )
+    {
+        if( strcmp( pSimulator->config.pServers[ index ].pServerName, pServerName ) == 0 )
+        {
+            pServer = &pSimulator->config.pServers[ index ];
+        }
+    }
+
+    return pServer;
+}
+
+/**
+ * @brief Finds the response in flight that arrives first.
+ *
+ * @param[in] pSimulator The simulator.
+ *
+ * @return The response, or NULL if no response is in flight.
+ */
+static SntpSimPacket_t * findNextResponse( SntpSimulator_t * pSimulator )
+{
+    SntpSimPacket_t * pNext = NULL;
+    size_t index;
+
+    for( index = 0U; index < SNTP_SIM_MAX_IN_FLIGHT; index++ )
+    {
+        if( ( pSimulator->inFlight[ index ].inUse == true ) &&
+            ( ( pNext == NULL ) || ( pSimulator->inFlight[ index ].deliveryTimeNs < pNext->deliveryTimeNs ) ) )
+        {
+            pNext = &pSimulator->inFlight[ index ];
+        }
+    }
+
+    return pNext;
+}
+
+void SntpSim_Init( SntpSimulator_t * pSimulator,
+                   const SntpSimConfig_t * pConfig )
+{
+    assert( pSimulator != NULL );
+    assert( pConfig != NULL );
+    assert( pConfig->numOfServers <= SNTP_SIM_MAX_SERVERS );
+
+    ( void ) memset( pSimulator, 0, sizeof( SntpSimulator_t ) );
+    pSimulator->config = *pConfig;
+
+    /* The xorshift sequence must not start from zero. */
+    pSimulator->randomState = ( pConfig->seed != 0U ) ? pConfig->seed : 1U;
+
+    pSimulator->localOriginUnixNs = ( pConfig->startUnixTimeSecs * NANOSECONDS_PER_SECOND ) +
+                                    pConfig->clockOffsetNs;
+
+    pActiveSimulator = pSimulator;
+}
+
+void SntpSim_InitTransportInterface( SntpSimulator_t * pSimulator,
+                                     NetworkContext_t * pNetworkContext,
+                                     UdpTransportInterface_t * pTransportIntf )
+{
+    assert( pSimulator != NULL );
+    assert( pNetworkContext != NULL );
+    assert( pTransportIntf != NULL );
+
+    pNetworkContext->pSimulator = pSimulator;
+    pTransportIntf->pUserContext = pNetworkContext;
+    pTransportIntf->sendTo = SntpSim_SendTo;
+    pTransportIntf->recvFrom = SntpSim_RecvFrom;
+}
+
+void SntpSim_AdvanceTime( SntpSimulator_t * pSimulator,
+                          uint64_t durationNs )
+{
+    assert( pSimulator != NULL );
+
+    pSimulator->trueTimeNs += ( int64_t ) durationNs;
+}
+
+int64_t SntpSim_GetTimeErrorNs( const SntpSimulator_t * pSimulator,
+                                const SntpTimestamp_t * pTime )
+{
+    int64_t unixTimeNs;
+
+    assert( pSimulator != NULL );
+    assert( pTime != NULL );
+
+    ( void ) Sntp_ConvertToUnixNanosecsBatch( pTime, 1U, pSimulator->config.startUnixTimeSecs, &unixTimeNs );
+
+    return unixTimeNs - ( ( pSimulator->config.startUnixTimeSecs * NANOSECONDS_PER_SECOND ) +
+                          pSimulator->trueTimeNs );
+}
+
+bool SntpSim_ResolveDns( const char * pServerAddr,
+                         uint32_t * pIpV4Addr )
+{
+    const SntpSimServer_t * pServer = NULL;
+
+    if( pActiveSimulator != NULL )
+    {
+        pServer = findServer( pActiveSimulator, pServerAddr );
+    }
+
+    if( ( pServer != NULL ) && ( pServer->dnsFailure == false ) )
+    {
+        *pIpV4Addr = pServer->ipV4Addr;
+    }
+
+    return ( pServer != NULL ) && ( pServer->dnsFailure == false );
+}
+
+bool SntpSim_GetTime( SntpTimestamp_t * pCurrentTime )
+{
+    int64_t localTimeNs;
+
+    if( pActiveSimulator != NULL )
+    {
+        localTimeNs = readLocalClock( pActiveSimulator );
+        ( void ) Sntp_ConvertFromUnixNanosecsBatch( &localTimeNs, 1U, pCurrentTime );
+    }
+
+    return pActiveSimulator != NULL;
+}
+
+bool SntpSim_SetTime( const char * pTimeServer,
+                      const SntpTimestamp_t * pServerTime,
+                      int32_t clockOffsetSec )
+{
+    ( void ) pTimeServer;
+    ( void ) clockOffsetSec;
+
+    if( pActiveSimulator != NULL )
+    {
+        pActiveSimulator->stats.setTimeCalls++;
+
+        if( pActiveSimulator->config.stepClockOnSetTime == true )
+        {
+            /* Step the local clock to the server time. */
+            ( void ) Sntp_ConvertToUnixNanosecsBatch( pServerTime, 1U,
+                                                      pActiveSimulator->config.startUnixTimeSecs,
+                                                      &pActiveSimulator->localOriginUnixNs );
+            pActiveSimulator->localOriginTrueNs = pActiveSimulator->trueTimeNs;
+        }
+    }
+
+    return pActiveSimulator != NULL;
+}
+
+int32_t SntpSim_SendTo( NetworkContext_t * pNetworkContext,
+                        const SntpServerInfo_t * pTimeServer,
+                        const void * pBuffer,
+                        size_t bytesToSend )
+{
+    SntpSimulator_t * pSimulator = pNetworkContext->pSimulator;
+    const SntpSimServer_t * pServer = findServer( pSimulator, pTimeServer->pServerName );
+    SntpSimPacket_t * pResponse = NULL;
+    int64_t serverRxTimeNs;
+    size_t index;
+
+    assert( pServer != NULL );
+    assert( bytesToSend >= SNTP_PACKET_BASE_SIZE );
+
+    pSimulator->stats.requestsSent++;
+
+    for( index = 0U; ( index < SNTP_SIM_MAX_IN_FLIGHT ) && ( pResponse == NULL ); index++ )
+    {
+        if( pSimulator->inFlight[ index ].inUse == false )
+        {
+            pResponse = &pSimulator->inFlight[ index ];
+        }
+    }
+
+    /* The request or the response can be lost. */
+    if( ( pResponse == NULL ) || randomEvent( pSimulator, pServer->lossPerMille ) ||
+        randomEvent( pSimulator, pServer->lossPerMille ) )
+    {
+        pSimulator->stats.packetsLost++;
+    }
+    else
+    {
+        serverRxTimeNs = pSimulator->trueTimeNs + sampleDelay( pSimulator, &pServer->requestDelay );
+
+        ( void ) memset( pResponse, 0, sizeof( SntpSimPacket_t ) );
+        pResponse->inUse = true;
+        pResponse->deliveryTimeNs = serverRxTimeNs +
+                                    ( ( int64_t ) pServer->processingTimeUs * NANOSECONDS_PER_MICROSECOND ) +
+                                    sampleDelay( pSimulator, &pServer->responseDelay );
+
+        if( randomEvent( pSimulator, pServer->reorderPerMille ) )
+        {
+            pSimulator->stats.responsesReordered++;
+            pResponse->deliveryTimeNs += ( int64_t ) pServer->reorderDelayUs * NANOSECONDS_PER_MICROSECOND;
+        }
+
+        pResponse->data[ 0 ] = ( uint8_t ) RESPONSE_LEAP_VERSION_MODE;
+        pResponse->data[ PACKET_STRATUM_OFFSET ] = ( uint8_t ) RESPONSE_STRATUM;
+        ( void ) memcpy( &pResponse->data[ PACKET_REF_ID_OFFSET ], "SIM", 3U );
+
+        /* The server returns the transmit time of the request as the origin
+         * time of the response. */
+        ( void ) memcpy( &pResponse->data[ PACKET_ORIGIN_TIME_OFFSET ],
+                         &( ( const uint8_t * ) pBuffer )[ PACKET_TX_TIME_OFFSET ], 8U );
+        writeTimestamp( &pResponse->data[ PACKET_REF_TIME_OFFSET ],
+                        readServerClock( pSimulator, pServer, serverRxTimeNs ) );
+        writeTimestamp( &pResponse->data[ PACKET_RX_TIME_OFFSET ],
+                        readServerClock( pSimulator, pServer, serverRxTimeNs ) );
+        writeTimestamp( &pResponse->data[ PACKET_TX_TIME_OFFSET ],
+                        readServerClock( pSimulator, pServer,
+                                         serverRxTimeNs + ( ( int64_t ) pServer->processingTimeUs *
+                                                            NANOSECONDS_PER_MICROSECOND ) ) );
+    }
+
+    return ( int32_t ) bytesToSend;
+}
+
+int32_t SntpSim_RecvFrom( NetworkContext_t * pNetworkContext,
+                          SntpServerInfo_t * pTimeServer,
+                          void * pBuffer,
+                          size_t bytesToRecv )
+{
+    SntpSimulator_t * pSimulator = pNetworkContext->pSimulator;
+    SntpSimPacket_t * pResponse = findNextResponse( pSimulator );
+    int64_t blockEndTimeNs = pSimulator->trueTimeNs +
+                             ( ( int64_t ) pSimulator->config.recvBlockTimeUs * NANOSECONDS_PER_MICROSECOND );
+    int32_t bytesReceived = 0;
+
+    ( void ) pTimeServer;
+
+    if( ( pResponse != NULL ) && ( pResponse->deliveryTimeNs <= pSimulator->trueTimeNs ) )
+    {
+        bytesReceived = ( int32_t ) ( ( bytesToRecv < SNTP_PACKET_BASE_SIZE ) ? bytesToRecv : SNTP_PACKET_BASE_SIZE );
+        ( void ) memcpy( pBuffer, pResponse->data, ( size_t ) bytesReceived );
+        pResponse->inUse = false;
+        pSimulator->stats.responsesDelivered++;
+    }
+    else if( ( pResponse != NULL ) && ( pResponse->deliveryTimeNs < blockEndTimeNs ) )
+    {
+        /* Wait for the response to arrive. */
+        pSimulator->trueTimeNs = pResponse->deliveryTimeNs;
+    }
+    else
+    {
+        pSimulator->trueTimeNs = blockEndTimeNs;
+    }
+
+    return bytesReceived;
+}
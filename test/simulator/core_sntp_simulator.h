@@ -0,0 +1,273 @@
+/*
+ * coreSNTP v1.0.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file core_sntp_simulator.h
+ * @brief A deterministic simulator of a network of SNTP servers and of the
+ * local clock, for testing and benchmarking the coreSNTP client in virtual time.
+ *
+ * The simulator implements the @ref SntpResolveDns_t, @ref SntpGetTime_t,
+ * @ref SntpSetTime_t and #UdpTransportInterface_t interfaces of the client
+ * library over simulated servers. Time only advances when the application
+ * calls @ref SntpSim_AdvanceTime, or when the client waits for a response that
+ * is still in flight, so a simulation of hours of polling completes in a
+ * fraction of a second of CPU time. All random choices (network delays, packet
+ * loss and reordering) come from a pseudo-random sequence seeded by the
+ * configuration, so a simulation is repeatable.
+ *
+ * As the callback interfaces of the client library have no context parameter,
+ * only one simulator can be active at a time: the one most recently
+ * initialized with @ref SntpSim_Init.
+ */
+
+#ifndef CORE_SNTP_SIMULATOR_H_
+#define CORE_SNTP_SIMULATOR_H_
+
+/* Standard include. */
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/* Include coreSNTP Client header. */
+#include "core_sntp_client.h"
+
+/**
+ * @brief The maximum number of servers in a simulation.
+ */
+#define SNTP_SIM_MAX_SERVERS      ( 4U )
+
+/**
+ * @brief The maximum number of packets in flight at a time. Packets sent while
+ * all slots are in use are lost.
+ */
+#define SNTP_SIM_MAX_IN_FLIGHT    ( 16U )
+
+/**
+ * @brief The distributions of simulated network delays.
+ */
+typedef enum SntpSimDelayDistribution
+{
+    SntpSimDelayConstant = 0, /**< @brief Every packet has the minimum delay. */
+    SntpSimDelayUniform,      /**< @brief Delays are uniform over [minimum, minimum + spread]. */
+    SntpSimDelayExponential   /**< @brief Delays are the minimum plus an exponential
+                               * delay with a mean of the spread, which models
+                               * queuing in congested networks. */
+} SntpSimDelayDistribution_t;
+
+/**
+ * @brief The configuration of the delay of one direction of a simulated network
+ * path.
+ */
+typedef struct SntpSimDelay
+{
+    SntpSimDelayDistribution_t distribution; /**< @brief The distribution of the delays. */
+    uint32_t minDelayUs;                     /**< @brief The smallest delay, in microseconds. */
+    uint32_t spreadUs;                       /**< @brief The spread of the delays above the
+                                              * minimum, in microseconds. */
+} SntpSimDelay_t;
+
+/**
+ * @brief The configuration of a simulated server and of the network path to it.
+ *
+ * An asymmetric path is configured with different request and response delays.
+ */
+typedef struct SntpSimServer
+{
+    const char * pServerName;    /**< @brief The DNS name of the server. */
+    uint32_t ipV4Addr;           /**< @brief The IPv4 address that the name resolves to. */
+    bool dnsFailure;             /**< @brief Whether resolving the name fails. */
+    SntpSimDelay_t requestDelay; /**< @brief The delay from the client to the server. */
+    SntpSimDelay_t responseDelay; /**< @brief The delay from the server to the client. */
+    uint32_t processingTimeUs;   /**< @brief The time between the receive and transmit
+                                  * timestamps of the server. */
+    uint16_t lossPerMille;       /**< @brief The probability, in units of 0.1%, that
+                                  * a packet in either direction is lost. */
+    uint16_t reorderPerMille;    /**< @brief The probability, in units of 0.1%, that
+                                  * a response is held back, so that later
+                                  * responses can overtake it. */
+    uint32_t reorderDelayUs;     /**< @brief The extra delay of a held back response. */
+    int64_t clockOffsetNs;       /**< @brief The error of the server clock relative
+                                  * to true time at the start of the simulation. */
+    int32_t clockDriftPpb;       /**< @brief The frequency error of the server clock,
+                                  * in parts per billion. */
+} SntpSimServer_t;
+
+/**
+ * @brief The configuration of a simulation.
+ */
+typedef struct SntpSimConfig
+{
+    uint64_t seed;                    /**< @brief The seed of the pseudo-random sequence. */
+    int64_t startUnixTimeSecs;        /**< @brief The true UNIX time at the start of the
+                                       * simulation. It is also the pivot time for
+                                       * resolving SNTP eras. */
+    int64_t clockOffsetNs;            /**< @brief The error of the local clock relative to
+                                       * true time at the start of the simulation. */
+    int32_t clockDriftPpb;            /**< @brief The frequency error of the local clock,
+                                       * in parts per billion. */
+    bool stepClockOnSetTime;          /**< @brief Whether the @ref SntpSetTime_t
+                                       * implementation steps the local clock to the
+                                       * server time. Otherwise, the local clock runs
+                                       * free, as when time is corrected by a virtual
+                                       * clock. */
+    uint32_t recvBlockTimeUs;         /**< @brief The virtual time that passes in a receive
+                                       * call when no response has arrived. */
+    const SntpSimServer_t * pServers; /**< @brief The simulated servers. */
+    size_t numOfServers;              /**< @brief The number of simulated servers. */
+} SntpSimConfig_t;
+
+/**
+ * @brief Counters of the events of a simulation.
+ */
+typedef struct SntpSimStats
+{
+    uint32_t requestsSent;       /**< @brief The number of requests sent by the client. */
+    uint32_t responsesDelivered; /**< @brief The number of responses received by the client. */
+    uint32_t packetsLost;        /**< @brief The number of requests and responses lost. */
+    uint32_t responsesReordered; /**< @brief The number of responses held back. */
+    uint32_t setTimeCalls;       /**< @brief The number of calls to @ref SntpSim_SetTime. */
+} SntpSimStats_t;
+
+/**
+ * @brief A packet in flight in the simulated network.
+ */
+typedef struct SntpSimPacket
+{
+    bool inUse;                              /**< @brief Whether the slot holds a packet. */
+    int64_t deliveryTimeNs;                  /**< @brief The true time at which the response
+                                              * arrives at the client. */
+    uint8_t data[ SNTP_PACKET_BASE_SIZE ];   /**< @brief The response packet. */
+} SntpSimPacket_t;
+
+/**
+ * @brief The state of a simulation.
+ *
+ * @note The members of this structure SHOULD NOT be accessed directly by the
+ * application.
+ */
+typedef struct SntpSimulator
+{
+    SntpSimConfig_t config;                           /**< @brief The configuration. */
+    int64_t trueTimeNs;                               /**< @brief The true time since the start. */
+    int64_t localOriginTrueNs;                        /**< @brief The true time when the local
+                                                       * clock was last set. */
+    int64_t localOriginUnixNs;                        /**< @brief The local UNIX time, in
+                                                       * nanoseconds, when the local clock
+                                                       * was last set. */
+    uint64_t randomState;                             /**< @brief The pseudo-random sequence state. */
+    SntpSimPacket_t inFlight[ SNTP_SIM_MAX_IN_FLIGHT ]; /**< @brief The responses in flight. */
+    SntpSimStats_t stats;                             /**< @brief The event counters. */
+} SntpSimulator_t;
+
+/**
+ * @brief The network context of the simulated transport interface.
+ */
+struct NetworkContext
+{
+    SntpSimulator_t * pSimulator; /**< @brief The simulator of the network. */
+};
+
+/**
+ * @brief Initializes a simulator, and makes it the active simulator used by the
+ * callback functions.
+ *
+ * @param[out] pSimulator The simulator to initialize.
+ * @param[in] pConfig The configuration of the simulation. The array of servers
+ * MUST stay in scope for the whole simulation.
+ */
+void SntpSim_Init( SntpSimulator_t * pSimulator,
+                   const SntpSimConfig_t * pConfig );
+
+/**
+ * @brief Initializes a transport interface that sends and receives over the
+ * simulated network of a simulator.
+ *
+ * @param[in] pSimulator The simulator.
+ * @param[out] pNetworkContext The network context to initialize. It MUST stay
+ * in scope for the whole simulation.
+ * @param[out] pTransportIntf The transport interface to initialize.
+ */
+void SntpSim_InitTransportInterface( SntpSimulator_t * pSimulator,
+                                     NetworkContext_t * pNetworkContext,
+                                     UdpTransportInterface_t * pTransportIntf );
+
+/**
+ * @brief Advances the virtual time of a simulator, for example, to wait for
+ * the next poll.
+ *
+ * @param[in, out] pSimulator The simulator.
+ * @param[in] durationNs The time to advance, in nanoseconds.
+ */
+void SntpSim_AdvanceTime( SntpSimulator_t * pSimulator,
+                          uint64_t durationNs );
+
+/**
+ * @brief Calculates the error of a time, relative to the true time now.
+ *
+ * @param[in] pSimulator The simulator.
+ * @param[in] pTime The time to check, for example, the corrected time of a
+ * virtual clock.
+ *
+ * @return The error of @p pTime, in nanoseconds.
+ */
+int64_t SntpSim_GetTimeErrorNs( const SntpSimulator_t * pSimulator,
+                                const SntpTimestamp_t * pTime );
+
+/**
+ * @brief Implementation of @ref SntpResolveDns_t over the active simulator.
+ */
+bool SntpSim_ResolveDns( const char * pServerAddr,
+                         uint32_t * pIpV4Addr );
+
+/**
+ * @brief Implementation of @ref SntpGetTime_t that reads the local clock of
+ * the active simulator.
+ */
+bool SntpSim_GetTime( SntpTimestamp_t * pCurrentTime );
+
+/**
+ * @brief Implementation of @ref SntpSetTime_t over the active simulator.
+ */
+bool SntpSim_SetTime( const char * pTimeServer,
+                      const SntpTimestamp_t * pServerTime,
+                      int32_t clockOffsetSec );
+
+/**
+ * @brief Implementation of @ref UdpTransportSendTo_t over a simulated network.
+ */
+int32_t SntpSim_SendTo( NetworkContext_t * pNetworkContext,
+                        const SntpServerInfo_t * pTimeServer,
+                        const void * pBuffer,
+                        size_t bytesToSend );
+
+/**
+ * @brief Implementation of @ref UdpTransportRecvFrom_t over a simulated network.
+ *
+ * If no response has arrived, the virtual time advances to the arrival of the
+ * next response, or by #SntpSimConfig_t.recvBlockTimeUs, whichever is earlier.
+ */
+int32_t SntpSim_RecvFrom( NetworkContext_t * pNetworkContext,
+                          SntpServerInfo_t * pTimeServer,
+                          void * pBuffer,
+                          size_t bytesToRecv );
+
+#endif /* ifndef CORE_SNTP_SIMULATOR_H_ */
@@ -0,0 +1,268 @@
+/*
+ * coreSNTP v1.0.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Standard includes. */
+#include <string.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+/* Unity include. */
+#include "unity.h"
+
+/* coreSNTP Batch Conversion API include */
+#include "core_sntp_batch.h"
+
+/* Number of timestamps in the test arrays. Not a multiple of the vector kernel
+ * width, so that the scalar tail is exercised. */
+#define TEST_BATCH_SIZE    ( 1003U )
+
+/* Number of nanoseconds in a second. */
+#define NS_PER_SEC         ( ( int64_t ) 1000000000 )
+
+/* Global variables common to test cases. */
+static SntpTimestamp_t sntpTimes[ TEST_BATCH_SIZE ];
+static int64_t unixTimesNs[ TEST_BATCH_SIZE ];
+static uint64_t randomState;
+
+/* ============================ Helper Functions ============================ */
+
+/* Returns the next value of a xorshift pseudo-random sequence, so that test
+ * runs are repeatable. */
+static uint64_t nextRandom( void )
+{
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 7;
+    randomState ^= randomState << 17;
+
+    return randomState;
+}
+
+/* Fills the SNTP timestamps with edge values followed by random values. */
+static void fillSntpTimes( void )
+{
+    static const uint32_t edgeValues[] =
+    {
+        0U,                                   1U,                          0x7FFFFFFFU, 0x80000000U, 0x80000001U,
+        UINT32_MAX - 1U,                      UINT32_MAX,
+        SNTP_TIME_AT_UNIX_EPOCH_SECS - 1U,    SNTP_TIME_AT_UNIX_EPOCH_SECS,
+        SNTP_TIME_AT_LARGEST_UNIX_TIME_SECS,
+        SNTP_TIME_AT_LARGEST_UNIX_TIME_SECS + 1U
+    };
+    size_t numOfEdgeValues = sizeof( edgeValues ) / sizeof( edgeValues[ 0 ] );
+    size_t i;
+
+    for( i = 0U; i < TEST_BATCH_SIZE; i++ )
+    {
+        if( i < ( numOfEdgeValues * numOfEdgeValues ) )
+        {
+            sntpTimes[ i ].seconds = edgeValues[ i / numOfEdgeValues ];
+            sntpTimes[ i ].fractions = edgeValues[ i % numOfEdgeValues ];
+        }
+        else
+        {
+            sntpTimes[ i ].seconds = ( uint32_t ) nextRandom();
+            sntpTimes[ i ].fractions = ( uint32_t ) nextRandom();
+        }
+    }
+}
+
+/* Converts the SNTP timestamps with the batch API, and checks the results
+ * against Sntp_ConvertToUnixTime64 for each element. */
+static void verifyToUnixNanosecsBatch( int64_t pivotUnixTimeSecs )
+{
+    int64_t unixTimeSecs;
+    uint32_t unixTimeNanosecs;
+    size_t i;
+
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_ConvertToUnixNanosecsBatch( sntpTimes, TEST_BATCH_SIZE,
+                                                                     pivotUnixTimeSecs, unixTimesNs ) );
+
+    for( i = 0U; i < TEST_BATCH_SIZE; i++ )
+    {
+        TEST_ASSERT_EQUAL( SntpSuccess, Sntp_ConvertToUnixTime64( &sntpTimes[ i ], pivotUnixTimeSecs,
+                                                                  &unixTimeSecs, &unixTimeNanosecs ) );
+        TEST_ASSERT_EQUAL_INT64( ( unixTimeSecs * NS_PER_SEC ) + ( int64_t ) unixTimeNanosecs, unixTimesNs[ i ] );
+    }
+}
+
+/* ============================   UNITY FIXTURES ============================ */
+
+/* Called before each test method. */
+void setUp()
+{
+    randomState = 0x2545F491U;
+    ( void ) memset( sntpTimes, 0, sizeof( sntpTimes ) );
+    ( void ) memset( unixTimesNs, 0, sizeof( unixTimesNs ) );
+}
+
+/* Called at the beginning of the whole suite. */
+void suiteSetUp()
+{
+}
+
+/* Called at the end of the whole suite. */
+int suiteTearDown( int numFailures )
+{
+    return numFailures;
+}
+
+/* ========================================================================== */
+
+/**
+ * @brief Test the batch conversion API functions with invalid parameters.
+ */
+void test_Batch_InvalidParams( void )
+{
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_ConvertToUnixNanosecsBatch( NULL, 1U, 0, unixTimesNs ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_ConvertToUnixNanosecsBatch( sntpTimes, 1U, 0, NULL ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_ConvertToUnixNanosecsBatch( sntpTimes, 1U,
+                                                                               SNTP_MAX_BATCH_PIVOT_UNIX_SECS + 1,
+                                                                               unixTimesNs ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_ConvertToUnixNanosecsBatch( sntpTimes, 1U,
+                                                                               -SNTP_MAX_BATCH_PIVOT_UNIX_SECS - 1,
+                                                                               unixTimesNs ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_ConvertFromUnixNanosecsBatch( NULL, 1U, sntpTimes ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_ConvertFromUnixNanosecsBatch( unixTimesNs, 1U, NULL ) );
+
+    /* Empty arrays need no buffers. */
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_ConvertToUnixNanosecsBatch( NULL, 0U, 0, NULL ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_ConvertFromUnixNanosecsBatch( NULL, 0U, NULL ) );
+}
+
+/**
+ * @brief Test that the conversion to UNIX time matches the scalar API for every
+ * element, with pivot times across the supported range.
+ */
+void test_Batch_ToUnixNanosecs_MatchesScalar( void )
+{
+    fillSntpTimes();
+
+    verifyToUnixNanosecsBatch( SNTP_DEFAULT_ERA_PIVOT_UNIX_SECS );
+    verifyToUnixNanosecsBatch( 0 );
+    verifyToUnixNanosecsBatch( -( int64_t ) SNTP_TIME_AT_UNIX_EPOCH_SECS );
+    verifyToUnixNanosecsBatch( ( int64_t ) UINT32_MAX + 1 );
+    verifyToUnixNanosecsBatch( SNTP_MAX_BATCH_PIVOT_UNIX_SECS );
+    verifyToUnixNanosecsBatch( -SNTP_MAX_BATCH_PIVOT_UNIX_SECS );
+}
+
+/**
+ * @brief Test that every array length, including the lengths shorter than the
+ * vector kernels, is converted without writing past the end of the output.
+ */
+void test_Batch_ToUnixNanosecs_Lengths( void )
+{
+    size_t count;
+    size_t i;
+
+    fillSntpTimes();
+
+    for( count = 0U; count <= 9U; count++ )
+    {
+        for( i = 0U; i < TEST_BATCH_SIZE; i++ )
+        {
+            unixTimesNs[ i ] = -1;
+        }
+
+        TEST_ASSERT_EQUAL( SntpSuccess, Sntp_ConvertToUnixNanosecsBatch( sntpTimes, count,
+                                                                         SNTP_DEFAULT_ERA_PIVOT_UNIX_SECS,
+                                                                         unixTimesNs ) );
+
+        for( i = 0U; i < count; i++ )
+        {
+            TEST_ASSERT_TRUE( unixTimesNs[ i ] != -1 );
+        }
+
+        TEST_ASSERT_EQUAL_INT64( -1, unixTimesNs[ count ] );
+    }
+}
+
+/**
+ * @brief Test that the conversion from UNIX time matches the scalar API for
+ * every element, including negative times and the limits of the input range.
+ */
+void test_Batch_FromUnixNanosecs_MatchesScalar( void )
+{
+    static const int64_t edgeValues[] =
+    {
+        0,  1,  -1,  NS_PER_SEC - 1, NS_PER_SEC, -NS_PER_SEC, -NS_PER_SEC - 1, -NS_PER_SEC + 1,
+        INT64_MAX, INT64_MIN, INT64_MIN + 1
+    };
+    size_t numOfEdgeValues = sizeof( edgeValues ) / sizeof( edgeValues[ 0 ] );
+    SntpTimestamp_t expected;
+    int64_t unixTimeSecs;
+    int64_t unixTimeNanosecs;
+    size_t i;
+
+    for( i = 0U; i < TEST_BATCH_SIZE; i++ )
+    {
+        unixTimesNs[ i ] = ( i < numOfEdgeValues ) ? edgeValues[ i ] : ( int64_t ) nextRandom();
+    }
+
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_ConvertFromUnixNanosecsBatch( unixTimesNs, TEST_BATCH_SIZE, sntpTimes ) );
+
+    for( i = 0U; i < TEST_BATCH_SIZE; i++ )
+    {
+        /* Split the time with the seconds rounded down. */
+        unixTimeSecs = unixTimesNs[ i ] / NS_PER_SEC;
+        unixTimeNanosecs = unixTimesNs[ i ] % NS_PER_SEC;
+
+        if( unixTimeNanosecs < 0 )
+        {
+            unixTimeSecs -= 1;
+            unixTimeNanosecs += NS_PER_SEC;
+        }
+
+        TEST_ASSERT_EQUAL( SntpSuccess, Sntp_ConvertFromUnixTime64( unixTimeSecs, ( uint32_t ) unixTimeNanosecs,
+                                                                    &expected ) );
+        TEST_ASSERT_EQUAL_UINT32( expected.seconds, sntpTimes[ i ].seconds );
+        TEST_ASSERT_EQUAL_UINT32( expected.fractions, sntpTimes[ i ].fractions );
+    }
+}
+
+/**
+ * @brief Test that times within half an SNTP era of the pivot survive a round
+ * trip through both batch conversions.
+ */
+void test_Batch_RoundTrip( void )
+{
+    int64_t original[ TEST_BATCH_SIZE ];
+    int64_t halfEraNs = ( int64_t ) 0x80000000U * NS_PER_SEC;
+    size_t i;
+
+    for( i = 0U; i < TEST_BATCH_SIZE; i++ )
+    {
+        /* Random times within [pivot - half era, pivot + half era). */
+        original[ i ] = ( ( int64_t ) SNTP_DEFAULT_ERA_PIVOT_UNIX_SECS * NS_PER_SEC ) - halfEraNs +
+                        ( int64_t ) ( nextRandom() % ( uint64_t ) ( 2 * halfEraNs ) );
+    }
+
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_ConvertFromUnixNanosecsBatch( original, TEST_BATCH_SIZE, sntpTimes ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_ConvertToUnixNanosecsBatch( sntpTimes, TEST_BATCH_SIZE,
+                                                                     SNTP_DEFAULT_ERA_PIVOT_UNIX_SECS,
+                                                                     unixTimesNs ) );
+
+    for( i = 0U; i < TEST_BATCH_SIZE; i++ )
+    {
+        TEST_ASSERT_EQUAL_INT64( original[ i ], unixTimesNs[ i ] );
+    }
+}
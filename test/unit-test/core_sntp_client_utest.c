@@ -36,7 +36,20 @@
 #include "core_sntp_client.h"
 
 /* Test IPv4 address for time server. */
-#define TEST_SERVER_ADDR    ( 0xAABBCCDD )
+#define TEST_SERVER_ADDR           ( 0xAABBCCDD )
+
+/* Number of SNTP timestamp fractions in a second. */
+#define FRACTIONS_PER_SECOND       ( ( int64_t ) 0x100000000 )
+
+/* System time used in tests. */
+#define TEST_SYSTEM_TIME_SECS      ( SNTP_TIME_AT_UNIX_EPOCH_SECS + 1000U )
+
+/* Response timeout used in tests. */
+#define TEST_RESPONSE_TIMEOUT_MS    ( 5000U )
+
+/* Kiss-o'-Death codes used in tests. */
+#define TEST_KOD_CODE_DENY          ( 0x44454E59U ) /* "DENY" */
+#define TEST_KOD_CODE_RATE          ( 0x52415445U ) /* "RATE" */
 
 typedef struct NetworkContext
 {
@@ -74,6 +87,20 @@ static bool getTimeRetCode = true;
 static bool setTimeRetCode = true;
 static int32_t UpdSendRetCode = 0;
 static int32_t UpdRecvCode = 0;
+static SntpTimestamp_t testSystemTime;
+static size_t setTimeCallCount = 0;
+static int32_t setTimeOffsetSec = 0;
+static uint8_t testResponse[ sizeof( testBuffer ) ];
+static size_t authCodeSize = 0;
+static SntpStatus_t generateAuthRetCode = SntpSuccess;
+static SntpStatus_t validateAuthRetCode = SntpSuccess;
+static SntpVirtualClock_t testClock;
+static const SntpServerInfo_t * pLastSentServer = NULL;
+static int32_t hedgeRecvCode = 0;
+static uint8_t hedgeResponse[ sizeof( testBuffer ) ];
+
+/* The size of the last read of the transport receive interface. */
+static size_t lastBytesToRecv;
 
 /* ========================= Helper Functions ============================ */
 
@@ -94,6 +121,8 @@ bool getTime( SntpTimestamp_t * pCurrentTime )
 {
     TEST_ASSERT_NOT_NULL( pCurrentTime );
 
+    *pCurrentTime = testSystemTime;
+
     return getTimeRetCode;
 }
 
@@ -104,7 +133,9 @@ bool setTime( const char * pTimeServer,
 {
     TEST_ASSERT_NOT_NULL( pTimeServer );
     TEST_ASSERT_NOT_NULL( pServerTime );
-    ( void ) clockOffsetSec;
+
+    setTimeCallCount++;
+    setTimeOffsetSec = clockOffsetSec;
 
     return setTimeRetCode;
 }
@@ -120,6 +151,8 @@ int32_t UdpSendTo( NetworkContext_t * pNetworkContext,
     TEST_ASSERT_NOT_NULL( pBuffer );
     TEST_ASSERT_GREATER_OR_EQUAL( SNTP_PACKET_BASE_SIZE, bytesToSend );
 
+    pLastSentServer = pTimeServer;
+
     return UpdSendRetCode;
 }
 
@@ -134,6 +167,25 @@ int32_t UdpRecvFrom( NetworkContext_t * pNetworkContext,
     TEST_ASSERT_NOT_NULL( pBuffer );
     TEST_ASSERT_GREATER_OR_EQUAL( SNTP_PACKET_BASE_SIZE, bytesToRecv );
 
+    lastBytesToRecv = bytesToRecv;
+
+    /* The server of a pending hedged request has its own response. */
+    if( ( context.isHedgePending == true ) &&
+        ( pTimeServer->pServerName == testServers[ context.hedgeServerIndex ].pServerName ) )
+    {
+        if( hedgeRecvCode > 0 )
+        {
+            memcpy( pBuffer, hedgeResponse, ( size_t ) hedgeRecvCode );
+        }
+
+        return hedgeRecvCode;
+    }
+
+    if( UpdRecvCode > 0 )
+    {
+        memcpy( pBuffer, testResponse, ( size_t ) UpdRecvCode );
+    }
+
     return UpdRecvCode;
 }
 
@@ -150,7 +202,9 @@ SntpStatus_t generateClientAuth( SntpAuthContext_t * pContext,
     TEST_ASSERT_NOT_NULL( pAuthCodeSize );
     TEST_ASSERT_GREATER_OR_EQUAL( SNTP_PACKET_BASE_SIZE, bufferSize );
 
-    return SntpSuccess;
+    *pAuthCodeSize = authCodeSize;
+
+    return generateAuthRetCode;
 }
 
 /* Test definition for @ref SntpValidateAuthCode_t interface. */
@@ -164,7 +218,68 @@ SntpStatus_t validateServer( SntpAuthContext_t * pContext,
     TEST_ASSERT_NOT_NULL( pResponseData );
     TEST_ASSERT_GREATER_OR_EQUAL( SNTP_PACKET_BASE_SIZE, responseSize );
 
-    return SntpSuccess;
+    return validateAuthRetCode;
+}
+
+/* Writes a 32-bit value in network byte order. */
+static void writeWord( uint8_t * pBuffer,
+                       uint32_t value )
+{
+    pBuffer[ 0 ] = ( uint8_t ) ( value >> 24 );
+    pBuffer[ 1 ] = ( uint8_t ) ( value >> 16 );
+    pBuffer[ 2 ] = ( uint8_t ) ( value >> 8 );
+    pBuffer[ 3 ] = ( uint8_t ) value;
+}
+
+/* Fills a response to a request sent at the passed time, with the server time
+ * ahead of the request time by the passed offset. A non-zero kiss code makes
+ * the response a Kiss-o'-Death message. */
+static void fillResponse( uint8_t * pResponse,
+                          const SntpTimestamp_t * pRequestTime,
+                          int32_t offsetSecs,
+                          uint8_t leapIndicator,
+                          uint32_t kissCode )
+{
+    memset( pResponse, 0, sizeof( testResponse ) );
+
+    /* Leap indicator, version 4, and server mode. */
+    pResponse[ 0 ] = ( uint8_t ) ( ( leapIndicator << 6 ) | ( 4U << 3 ) | 4U );
+    pResponse[ 1 ] = ( kissCode == 0U ) ? 1U : 0U;
+    writeWord( &pResponse[ 12 ], kissCode );
+
+    /* Originate, receive and transmit timestamps. */
+    writeWord( &pResponse[ 24 ], pRequestTime->seconds );
+    writeWord( &pResponse[ 28 ], pRequestTime->fractions );
+    writeWord( &pResponse[ 32 ], pRequestTime->seconds + ( uint32_t ) offsetSecs );
+    writeWord( &pResponse[ 36 ], pRequestTime->fractions );
+    writeWord( &pResponse[ 40 ], pRequestTime->seconds + ( uint32_t ) offsetSecs );
+    writeWord( &pResponse[ 44 ], pRequestTime->fractions );
+}
+
+/* Fills the test response for the last time request of the context, with the
+ * server time ahead of the system time by the passed offset. A non-zero kiss
+ * code makes the response a Kiss-o'-Death message. */
+static void fillTestResponse( int32_t offsetSecs,
+                              uint8_t leapIndicator,
+                              uint32_t kissCode )
+{
+    fillResponse( testResponse, &context.lastRequestTime, offsetSecs, leapIndicator, kissCode );
+}
+
+/* Initializes the context with the test interface functions. */
+static void initContext( const SntpAuthenticationInterface_t * pAuthIntf )
+{
+    TEST_ASSERT_EQUAL( SntpSuccess,
+                       Sntp_Init( &context,
+                                  testServers,
+                                  sizeof( testServers ) / sizeof( SntpServerInfo_t ),
+                                  testBuffer,
+                                  sizeof( testBuffer ),
+                                  dnsResolve,
+                                  getTime,
+                                  setTime,
+                                  &transportIntf,
+                                  pAuthIntf ) );
 }
 
 /* ============================   UNITY FIXTURES ============================ */
@@ -177,8 +292,17 @@ void setUp()
     dnsResolveAddr = TEST_SERVER_ADDR;
     getTimeRetCode = true;
     setTimeRetCode = true;
-    UpdSendRetCode = 0;
+    UpdSendRetCode = SNTP_PACKET_BASE_SIZE;
     UpdRecvCode = 0;
+    testSystemTime.seconds = TEST_SYSTEM_TIME_SECS;
+    testSystemTime.fractions = 0U;
+    setTimeCallCount = 0U;
+    setTimeOffsetSec = 0;
+    authCodeSize = 0U;
+    generateAuthRetCode = SntpSuccess;
+    validateAuthRetCode = SntpSuccess;
+    pLastSentServer = NULL;
+    hedgeRecvCode = 0;
 
     /* Set the transport interface object. */
     transportIntf.pUserContext = &netContext;
@@ -436,3 +560,1251 @@ void test_Init_Nominal( void )
     /* Test with a valid authentication interface. */
     TEST_SNTP_INIT_SUCCESS( &authIntf );
 }
+
+/**
+ * @brief Test the client API functions with invalid parameters.
+ */
+void test_ClientApis_InvalidParams( void )
+{
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_SetVirtualClock( NULL, &testClock ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_SendTimeRequest( NULL, 0U ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_ReceiveTimeResponse( NULL, TEST_RESPONSE_TIMEOUT_MS ) );
+}
+
+/**
+ * @brief Test that @ref Sntp_SendTimeRequest sends a serialized request, with
+ * authentication data if an authentication interface is configured.
+ */
+void test_SendTimeRequest_Nominal( void )
+{
+    initContext( NULL );
+
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SendTimeRequest( &context, 0xFFFFFFFFU ) );
+    TEST_ASSERT_EQUAL( TEST_SERVER_ADDR, context.currentServerIpV4Addr );
+    TEST_ASSERT_EQUAL( TEST_SYSTEM_TIME_SECS, context.lastRequestTime.seconds );
+    TEST_ASSERT_EQUAL( 0xFFFFU, context.lastRequestTime.fractions );
+    TEST_ASSERT_EQUAL( SNTP_PACKET_BASE_SIZE, context.sntpPacketSize );
+
+    /* Version 4 and client mode. */
+    TEST_ASSERT_EQUAL( 0x23, testBuffer[ 0 ] );
+
+    /* The request includes the authentication data. */
+    initContext( &authIntf );
+    authCodeSize = 20U;
+    UpdSendRetCode = SNTP_PACKET_BASE_SIZE + 20;
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SendTimeRequest( &context, 0U ) );
+    TEST_ASSERT_EQUAL( SNTP_PACKET_BASE_SIZE + 20U, context.sntpPacketSize );
+}
+
+/**
+ * @brief Test that @ref Sntp_SendTimeRequest reports failures, and moves to
+ * the next server for server failures.
+ */
+void test_SendTimeRequest_Failures( void )
+{
+    initContext( &authIntf );
+
+    /* DNS failure moves to the next server. */
+    dnsResolveRetCode = false;
+    TEST_ASSERT_EQUAL( SntpErrorDnsFailure, Sntp_SendTimeRequest( &context, 0U ) );
+    TEST_ASSERT_EQUAL( 1U, context.currentServerIndex );
+    dnsResolveRetCode = true;
+
+    getTimeRetCode = false;
+    TEST_ASSERT_EQUAL( SntpErrorSystemClockFailure, Sntp_SendTimeRequest( &context, 0U ) );
+    getTimeRetCode = true;
+
+    generateAuthRetCode = SntpErrorAuthFailure;
+    TEST_ASSERT_EQUAL( SntpErrorAuthFailure, Sntp_SendTimeRequest( &context, 0U ) );
+    generateAuthRetCode = SntpSuccess;
+
+    authCodeSize = sizeof( testBuffer );
+    TEST_ASSERT_EQUAL( SntpErrorBufferTooSmall, Sntp_SendTimeRequest( &context, 0U ) );
+    authCodeSize = 0U;
+    TEST_ASSERT_EQUAL( 1U, context.currentServerIndex );
+
+    /* Network failures move to the next server, wrapping around the list. */
+    UpdSendRetCode = -2;
+    TEST_ASSERT_EQUAL( SntpErrorNetworkFailure, Sntp_SendTimeRequest( &context, 0U ) );
+    TEST_ASSERT_EQUAL( 0U, context.currentServerIndex );
+
+    UpdSendRetCode = 0;
+    TEST_ASSERT_EQUAL( SntpErrorNetworkFailure, Sntp_SendTimeRequest( &context, 0U ) );
+    UpdSendRetCode = SNTP_PACKET_BASE_SIZE - 1;
+    TEST_ASSERT_EQUAL( SntpErrorNetworkFailure, Sntp_SendTimeRequest( &context, 0U ) );
+}
+
+/**
+ * @brief Test that @ref Sntp_ReceiveTimeResponse corrects system time and the
+ * virtual clock with an accepted server response.
+ */
+void test_ReceiveTimeResponse_Accepted( void )
+{
+    SntpTimestamp_t correctedTime;
+
+    initContext( &authIntf );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_InitVirtualClock( &testClock ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SetVirtualClock( &context, &testClock ) );
+
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SendTimeRequest( &context, 0U ) );
+
+    /* Server time is 2 seconds ahead, and announces a leap second. */
+    fillTestResponse( 2, 1U, 0U );
+    UpdRecvCode = SNTP_PACKET_BASE_SIZE;
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    TEST_ASSERT_EQUAL( 1U, setTimeCallCount );
+    TEST_ASSERT_EQUAL( 2, setTimeOffsetSec );
+
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_GetCorrectedTime( &testClock, &testSystemTime, &correctedTime ) );
+    TEST_ASSERT_EQUAL( TEST_SYSTEM_TIME_SECS + 2U, correctedTime.seconds );
+    TEST_ASSERT_EQUAL( 1, testClock.model.leapSmear.leapSeconds );
+
+    /* Failure to correct system time. */
+    setTimeRetCode = false;
+    TEST_ASSERT_EQUAL( SntpErrorSystemClockFailure,
+                       Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    setTimeRetCode = true;
+
+    /* Failure to obtain the receive time. */
+    getTimeRetCode = false;
+    TEST_ASSERT_EQUAL( SntpErrorSystemClockFailure,
+                       Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    getTimeRetCode = true;
+
+    /* Clock offset overflow still corrects system time, without updating the
+     * virtual clock. */
+    fillTestResponse( INT32_MIN, 0U, 0U );
+    TEST_ASSERT_EQUAL( SntpClockOffsetOverflow,
+                       Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    TEST_ASSERT_EQUAL( SNTP_CLOCK_OFFSET_OVERFLOW, setTimeOffsetSec );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_GetCorrectedTime( &testClock, &testSystemTime, &correctedTime ) );
+    TEST_ASSERT_EQUAL( TEST_SYSTEM_TIME_SECS + 2U, correctedTime.seconds );
+
+    /* Invalid responses are reported without changing the server. */
+    testResponse[ 24 ]++;
+    TEST_ASSERT_EQUAL( SntpInvalidResponse, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    UpdRecvCode = SNTP_PACKET_BASE_SIZE - 1;
+    TEST_ASSERT_EQUAL( SntpErrorBufferTooSmall, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    TEST_ASSERT_EQUAL( 0U, context.currentServerIndex );
+}
+
+/**
+ * @brief Test that @ref Sntp_ReceiveTimeResponse waits for the response until
+ * the response timeout, and then moves to the next server.
+ */
+void test_ReceiveTimeResponse_Timeout( void )
+{
+    initContext( NULL );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SendTimeRequest( &context, 0U ) );
+
+    UpdRecvCode = 0;
+    testSystemTime.seconds += ( TEST_RESPONSE_TIMEOUT_MS / 1000U ) - 1U;
+    TEST_ASSERT_EQUAL( SntpNoResponseReceived, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    TEST_ASSERT_EQUAL( 0U, context.currentServerIndex );
+
+    getTimeRetCode = false;
+    TEST_ASSERT_EQUAL( SntpErrorSystemClockFailure,
+                       Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    getTimeRetCode = true;
+
+    testSystemTime.seconds += 1U;
+    TEST_ASSERT_EQUAL( SntpErrorResponseTimeout, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    TEST_ASSERT_EQUAL( 1U, context.currentServerIndex );
+
+    /* A step of system time back also expires the timeout. */
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SendTimeRequest( &context, 0U ) );
+    testSystemTime.seconds -= 100U;
+    TEST_ASSERT_EQUAL( SntpErrorResponseTimeout, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    TEST_ASSERT_EQUAL( 0U, context.currentServerIndex );
+
+    /* Network failure moves to the next server. */
+    UpdRecvCode = -2;
+    TEST_ASSERT_EQUAL( SntpErrorNetworkFailure, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    TEST_ASSERT_EQUAL( 1U, context.currentServerIndex );
+}
+
+/**
+ * @brief Test that @ref Sntp_ReceiveTimeResponse moves to the next server only
+ * for rejections that prohibit further requests to the server.
+ */
+void test_ReceiveTimeResponse_Rejected( void )
+{
+    initContext( &authIntf );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SendTimeRequest( &context, 0U ) );
+    UpdRecvCode = SNTP_PACKET_BASE_SIZE;
+
+    fillTestResponse( 0, 0U, TEST_KOD_CODE_RATE );
+    TEST_ASSERT_EQUAL( SntpRejectedResponseRetryWithBackoff,
+                       Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    TEST_ASSERT_EQUAL( 0U, context.currentServerIndex );
+
+    fillTestResponse( 0, 0U, TEST_KOD_CODE_DENY );
+    TEST_ASSERT_EQUAL( SntpRejectedResponseChangeServer,
+                       Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    TEST_ASSERT_EQUAL( 1U, context.currentServerIndex );
+
+    validateAuthRetCode = SntpServerNotAuthenticated;
+    TEST_ASSERT_EQUAL( SntpServerNotAuthenticated,
+                       Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    TEST_ASSERT_EQUAL( 0U, context.currentServerIndex );
+
+    validateAuthRetCode = SntpErrorAuthFailure;
+    TEST_ASSERT_EQUAL( SntpErrorAuthFailure, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    TEST_ASSERT_EQUAL( 0U, context.currentServerIndex );
+    TEST_ASSERT_EQUAL( 0U, setTimeCallCount );
+}
+
+/**
+ * @brief Test that the virtual clock enters holdover when all servers fail,
+ * with a growing error bound, and leaves holdover when a server responds.
+ */
+void test_ReceiveTimeResponse_Holdover( void )
+{
+    SntpClockState_t state;
+    uint64_t errorBound, previousErrorBound;
+    SntpTimestamp_t correctedTime;
+    int i;
+
+    initContext( NULL );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_InitVirtualClock( &testClock ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SetVirtualClock( &context, &testClock ) );
+
+    /* Failure of all servers does not affect an unsynchronized clock. */
+    UpdSendRetCode = -2;
+    TEST_ASSERT_EQUAL( SntpErrorNetworkFailure, Sntp_SendTimeRequest( &context, 0U ) );
+    TEST_ASSERT_EQUAL( SntpErrorNetworkFailure, Sntp_SendTimeRequest( &context, 0U ) );
+    TEST_ASSERT_EQUAL( SntpClockNotSynchronized,
+                       Sntp_GetVirtualClockErrorBound( &testClock, &testSystemTime, &state, &errorBound ) );
+    TEST_ASSERT_EQUAL( SntpClockStateUnsynchronized, state );
+    UpdSendRetCode = SNTP_PACKET_BASE_SIZE;
+
+    /* Synchronize the clock with a few responses. */
+    for( i = 0; i < 3; i++ )
+    {
+        testSystemTime.seconds += 64U;
+        TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SendTimeRequest( &context, 0U ) );
+        fillTestResponse( 1, 0U, 0U );
+        UpdRecvCode = SNTP_PACKET_BASE_SIZE;
+        TEST_ASSERT_EQUAL( SntpSuccess, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    }
+
+    TEST_ASSERT_EQUAL( 0U, context.consecutiveServerFailures );
+    TEST_ASSERT_EQUAL( SntpSuccess,
+                       Sntp_GetVirtualClockErrorBound( &testClock, &testSystemTime, &state, &errorBound ) );
+    TEST_ASSERT_EQUAL( SntpClockStateSynchronized, state );
+
+    /* The first server times out, which is not yet holdover. */
+    UpdRecvCode = 0;
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SendTimeRequest( &context, 0U ) );
+    testSystemTime.seconds += 10U;
+    TEST_ASSERT_EQUAL( SntpErrorResponseTimeout, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    TEST_ASSERT_EQUAL( SntpSuccess,
+                       Sntp_GetVirtualClockErrorBound( &testClock, &testSystemTime, &state, &errorBound ) );
+    TEST_ASSERT_EQUAL( SntpClockStateSynchronized, state );
+
+    /* The second server times out, so all servers have failed. */
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SendTimeRequest( &context, 0U ) );
+    testSystemTime.seconds += 10U;
+    TEST_ASSERT_EQUAL( SntpErrorResponseTimeout, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+
+    /* The clock keeps providing time, with a growing error bound. */
+    previousErrorBound = 0U;
+
+    for( i = 0; i < 3; i++ )
+    {
+        TEST_ASSERT_EQUAL( SntpSuccess,
+                           Sntp_GetVirtualClockErrorBound( &testClock, &testSystemTime, &state, &errorBound ) );
+        TEST_ASSERT_EQUAL( SntpClockStateHoldover, state );
+        TEST_ASSERT_GREATER_THAN_UINT64( previousErrorBound, errorBound );
+        previousErrorBound = errorBound;
+
+        TEST_ASSERT_EQUAL( SntpSuccess, Sntp_GetCorrectedTime( &testClock, &testSystemTime, &correctedTime ) );
+        TEST_ASSERT_EQUAL( testSystemTime.seconds + 1U, correctedTime.seconds );
+
+        testSystemTime.seconds += 3600U;
+    }
+
+    /* The clock leaves holdover when a server responds. */
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SendTimeRequest( &context, 0U ) );
+    fillTestResponse( 1, 0U, 0U );
+    UpdRecvCode = SNTP_PACKET_BASE_SIZE;
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    TEST_ASSERT_EQUAL( SntpSuccess,
+                       Sntp_GetVirtualClockErrorBound( &testClock, &testSystemTime, &state, &errorBound ) );
+    TEST_ASSERT_EQUAL( SntpClockStateSynchronized, state );
+    TEST_ASSERT_LESS_THAN_UINT64( previousErrorBound, errorBound );
+}
+
+/**
+ * @brief Test that @ref Sntp_ReceiveTimeResponse does not correct time with a
+ * response rejected by the outlier gate, and that the gate is reset when the
+ * client moves to the next server.
+ */
+void test_ReceiveTimeResponse_OutlierGate( void )
+{
+    SntpOutlierGate_t gate;
+    size_t i;
+
+    initContext( NULL );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_SetOutlierGate( NULL, &gate ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_InitOutlierGate( &gate,
+                                                          SNTP_OUTLIER_GATE_DEFAULT_THRESHOLD,
+                                                          SNTP_OUTLIER_GATE_DEFAULT_MAX_REJECTIONS ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SetOutlierGate( &context, &gate ) );
+
+    UpdRecvCode = SNTP_PACKET_BASE_SIZE;
+
+    for( i = 0U; i < SNTP_OUTLIER_GATE_MIN_SAMPLES; i++ )
+    {
+        TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SendTimeRequest( &context, 0U ) );
+        fillTestResponse( 1, 0U, 0U );
+        TEST_ASSERT_EQUAL( SntpSuccess, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    }
+
+    TEST_ASSERT_EQUAL( SNTP_OUTLIER_GATE_MIN_SAMPLES, setTimeCallCount );
+
+    /* A sample with a spike in the clock offset does not correct time, and
+     * does not count as a server failure. */
+    context.consecutiveServerFailures = 1U;
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SendTimeRequest( &context, 0U ) );
+    fillTestResponse( 3, 0U, 0U );
+    TEST_ASSERT_EQUAL( SntpRejectedResponseOutlier,
+                       Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    TEST_ASSERT_EQUAL( SNTP_OUTLIER_GATE_MIN_SAMPLES, setTimeCallCount );
+    TEST_ASSERT_EQUAL( 0U, context.consecutiveServerFailures );
+    TEST_ASSERT_EQUAL( 0U, context.currentServerIndex );
+
+    /* Moving to the next server clears the history of the gate. */
+    UpdRecvCode = -2;
+    TEST_ASSERT_EQUAL( SntpErrorNetworkFailure, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    TEST_ASSERT_EQUAL( 0U, gate.numOfSamples );
+
+    UpdRecvCode = SNTP_PACKET_BASE_SIZE;
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SendTimeRequest( &context, 0U ) );
+    fillTestResponse( 3, 0U, 0U );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    TEST_ASSERT_EQUAL( 3, setTimeOffsetSec );
+}
+
+/**
+ * @brief Test that @ref Sntp_ReceiveTimeResponse updates the clock stability
+ * estimator with accepted responses, and marks a discontinuity when the client
+ * moves to the next server.
+ */
+void test_ReceiveTimeResponse_StabilityEstimator( void )
+{
+    SntpStabilityEstimator_t estimator;
+    uint64_t tauMs, allanDeviation;
+    size_t i;
+
+    initContext( NULL );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_SetStabilityEstimator( NULL, &estimator ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_InitStabilityEstimator( &estimator ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SetStabilityEstimator( &context, &estimator ) );
+
+    UpdRecvCode = SNTP_PACKET_BASE_SIZE;
+
+    for( i = 0U; i < ( SNTP_STABILITY_MIN_SAMPLES + 2U ); i++ )
+    {
+        testSystemTime.seconds += 16U;
+        TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SendTimeRequest( &context, 0U ) );
+        fillTestResponse( 1, 0U, 0U );
+        TEST_ASSERT_EQUAL( SntpSuccess, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    }
+
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_GetAllanDeviation( &estimator, 0U, &tauMs, &allanDeviation ) );
+    TEST_ASSERT_EQUAL_UINT64( 16000U, tauMs );
+    TEST_ASSERT_EQUAL_UINT64( 0U, allanDeviation );
+
+    UpdRecvCode = -2;
+    TEST_ASSERT_EQUAL( SntpErrorNetworkFailure, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    TEST_ASSERT_EQUAL( 0U, estimator.levels[ 0 ].numOfPoints );
+}
+
+/**
+ * @brief Test that @ref Sntp_ReceiveTimeResponse records the round-trip delay,
+ * clock offset and response latency of valid responses in the histograms of
+ * the current server.
+ */
+void test_ReceiveTimeResponse_ServerHistograms( void )
+{
+    SntpServerHistograms_t histograms[ sizeof( testServers ) / sizeof( SntpServerInfo_t ) ];
+    uint32_t value, count;
+
+    initContext( NULL );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_SetServerHistograms( NULL, histograms ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_InitServerHistograms( histograms, sizeof( testServers ) /
+                                                               sizeof( SntpServerInfo_t ) ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SetServerHistograms( &context, histograms ) );
+
+    UpdRecvCode = SNTP_PACKET_BASE_SIZE;
+
+    /* The response arrives 250 ms after the request, with server time 1 second
+     * ahead at both the receive and transmit time. */
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SendTimeRequest( &context, 0U ) );
+    fillTestResponse( 1, 0U, 0U );
+    testSystemTime.fractions += ( uint32_t ) ( FRACTIONS_PER_SECOND / 4 );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_GetHistogramPercentile( &histograms[ 0 ].roundTripDelay, 990000U, &value ) );
+    TEST_ASSERT_EQUAL( 250000U, value );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_GetHistogramPercentile( &histograms[ 0 ].clockOffset, 990000U, &value ) );
+    TEST_ASSERT_EQUAL( 875000U, value );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_GetHistogramPercentile( &histograms[ 0 ].responseLatency, 990000U, &value ) );
+    TEST_ASSERT_EQUAL( 250000U, value );
+
+    /* A response whose clock offset overflows records the delay and latency
+     * only, and invalid responses are not recorded. */
+    fillTestResponse( INT32_MIN, 0U, 0U );
+    TEST_ASSERT_EQUAL( SntpClockOffsetOverflow, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    testResponse[ 24 ]++;
+    TEST_ASSERT_EQUAL( SntpInvalidResponse, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_GetHistogramCount( &histograms[ 0 ].roundTripDelay, &count ) );
+    TEST_ASSERT_EQUAL( 2U, count );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_GetHistogramCount( &histograms[ 0 ].clockOffset, &count ) );
+    TEST_ASSERT_EQUAL( 1U, count );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_GetHistogramCount( &histograms[ 0 ].responseLatency, &count ) );
+    TEST_ASSERT_EQUAL( 2U, count );
+
+    /* The latency is not recorded across a backward step of system time. */
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SendTimeRequest( &context, 0U ) );
+    fillTestResponse( 0, 0U, 0U );
+    testSystemTime.seconds -= 1U;
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_GetHistogramCount( &histograms[ 0 ].responseLatency, &count ) );
+    TEST_ASSERT_EQUAL( 2U, count );
+
+    /* Responses of the next server are recorded in its histograms. */
+    UpdRecvCode = -2;
+    TEST_ASSERT_EQUAL( SntpErrorNetworkFailure, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    UpdRecvCode = SNTP_PACKET_BASE_SIZE;
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SendTimeRequest( &context, 0U ) );
+    fillTestResponse( 0, 0U, 0U );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_GetHistogramCount( &histograms[ 1 ].roundTripDelay, &count ) );
+    TEST_ASSERT_EQUAL( 1U, count );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_GetHistogramPercentile( &histograms[ 1 ].clockOffset, 0U, &value ) );
+    TEST_ASSERT_EQUAL( 0U, value );
+}
+
+/**
+ * @brief Test that the statistics count the outcome of requests and responses
+ * for the context and for the server of each outcome.
+ */
+void test_ReceiveTimeResponse_Metrics( void )
+{
+    SntpMetrics_t metrics;
+    SntpServerMetrics_t serverMetrics[ sizeof( testServers ) / sizeof( SntpServerInfo_t ) ];
+
+    initContext( NULL );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_InitMetrics( &metrics, serverMetrics, 1U ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_SetMetrics( NULL, &metrics ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_SetMetrics( &context, &metrics ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_InitMetrics( &metrics, serverMetrics, sizeof( testServers ) /
+                                                      sizeof( SntpServerInfo_t ) ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SetMetrics( &context, &metrics ) );
+    TEST_ASSERT_EQUAL_STRING( testServers[ 1 ].pServerName, serverMetrics[ 1 ].pServerName );
+
+    /* An accepted response with the server 1 second ahead. */
+    UpdRecvCode = SNTP_PACKET_BASE_SIZE;
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SendTimeRequest( &context, 0U ) );
+    fillTestResponse( 1, 0U, 0U );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    TEST_ASSERT_EQUAL( 1U, serverMetrics[ 0 ].requests );
+    TEST_ASSERT_EQUAL( 1U, serverMetrics[ 0 ].acceptedResponses );
+    TEST_ASSERT_TRUE( serverMetrics[ 0 ].isSynchronized );
+    TEST_ASSERT_EQUAL_INT64( 1000000000, serverMetrics[ 0 ].clockOffsetNs );
+    TEST_ASSERT_EQUAL( 1U, serverMetrics[ 0 ].stratum );
+
+    /* A rate limiting Kiss-o'-Death response and an invalid response. */
+    fillTestResponse( 0, 0U, 0x52415445U );
+    TEST_ASSERT_EQUAL( SntpRejectedResponseRetryWithBackoff,
+                       Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    fillTestResponse( 0, 0U, 0U );
+    testResponse[ 24 ]++;
+    TEST_ASSERT_EQUAL( SntpInvalidResponse, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    TEST_ASSERT_EQUAL( 1U, serverMetrics[ 0 ].kissOfDeath[ SntpMetricsKissRate ] );
+    TEST_ASSERT_EQUAL( 1U, serverMetrics[ 0 ].invalidResponses[ SntpMetricsInvalidProtocol ] );
+
+    /* A network failure is counted for the server that failed, before the
+     * client moves to the next server, which then fails to resolve. */
+    UpdRecvCode = -1;
+    TEST_ASSERT_EQUAL( SntpErrorNetworkFailure, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    dnsResolveRetCode = false;
+    TEST_ASSERT_EQUAL( SntpErrorDnsFailure, Sntp_SendTimeRequest( &context, 0U ) );
+    dnsResolveRetCode = true;
+    TEST_ASSERT_EQUAL( 1U, serverMetrics[ 0 ].networkErrors );
+    TEST_ASSERT_EQUAL( 1U, serverMetrics[ 1 ].dnsFailures );
+    TEST_ASSERT_EQUAL( 0U, serverMetrics[ 1 ].requests );
+
+    /* A response timeout of the first server. */
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SendTimeRequest( &context, 0U ) );
+    UpdRecvCode = 0;
+    testSystemTime.seconds += TEST_RESPONSE_TIMEOUT_MS / 1000U;
+    TEST_ASSERT_EQUAL( SntpErrorResponseTimeout, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    TEST_ASSERT_EQUAL( 1U, serverMetrics[ 0 ].timeouts );
+
+    /* The context counts the outcomes of all servers. */
+    TEST_ASSERT_EQUAL( 2U, metrics.context.requests );
+    TEST_ASSERT_EQUAL( 1U, metrics.context.dnsFailures );
+    TEST_ASSERT_EQUAL( 1U, metrics.context.timeouts );
+    TEST_ASSERT_EQUAL( 0U, metrics.currentServerIndex );
+}
+
+/* Number of servers of the tests. */
+#define TEST_NUM_SERVERS           ( sizeof( testServers ) / sizeof( SntpServerInfo_t ) )
+
+/* Response latency of the first server recorded in the hedging tests. */
+#define TEST_HEDGE_LATENCY_US      ( 100000U )
+
+/* System time fractions after which the requests of the hedging tests are
+ * late, about 200 milliseconds. */
+#define TEST_HEDGE_LATE_FRACTIONS  ( 0x33333333U )
+
+/* Initializes the context for hedging, with enough response latencies of the
+ * first server recorded in the passed histograms. */
+static void initHedging( SntpServerHistograms_t * pHistograms,
+                         uint32_t maxHedgePercent )
+{
+    uint32_t i;
+
+    initContext( NULL );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_InitServerHistograms( pHistograms, TEST_NUM_SERVERS ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SetServerHistograms( &context, pHistograms ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SetHedging( &context, maxHedgePercent ) );
+
+    for( i = 0U; i < SNTP_HEDGE_MIN_SAMPLES; i++ )
+    {
+        TEST_ASSERT_EQUAL( SntpSuccess, Sntp_RecordHistogramValue( &pHistograms[ 0 ].responseLatency,
+                                                                   TEST_HEDGE_LATENCY_US ) );
+    }
+}
+
+/* Sends a time request at the start of the test second, and checks whether it
+ * is hedged once the response is late. */
+static bool isLateRequestHedged( void )
+{
+    testSystemTime.fractions = 0U;
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SendTimeRequest( &context, 0xA5A51234U ) );
+    TEST_ASSERT_EQUAL_PTR( &testServers[ context.currentServerIndex ], pLastSentServer );
+
+    testSystemTime.fractions = TEST_HEDGE_LATE_FRACTIONS;
+    TEST_ASSERT_EQUAL( SntpNoResponseReceived, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+
+    return ( pLastSentServer != &testServers[ context.currentServerIndex ] ) ? true : false;
+}
+
+/**
+ * @brief Test that a late time request is hedged to the next server, and that
+ * the first valid response is used.
+ */
+void test_ReceiveTimeResponse_Hedging( void )
+{
+    SntpServerHistograms_t histograms[ TEST_NUM_SERVERS ];
+    uint32_t count;
+
+    initHedging( histograms, SNTP_MAX_HEDGE_PERCENT );
+
+    /* The request is not hedged within the 95th percentile of the latency. */
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SendTimeRequest( &context, 0xA5A51234U ) );
+    TEST_ASSERT_EQUAL( SntpNoResponseReceived, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    TEST_ASSERT_EQUAL_PTR( &testServers[ 0 ], pLastSentServer );
+    TEST_ASSERT_FALSE( context.isHedgePending );
+
+    /* The late request is hedged to the next server, only once. */
+    testSystemTime.fractions = TEST_HEDGE_LATE_FRACTIONS;
+    TEST_ASSERT_EQUAL( SntpNoResponseReceived, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    TEST_ASSERT_EQUAL_PTR( &testServers[ 1 ], pLastSentServer );
+    TEST_ASSERT_TRUE( context.isHedgePending );
+    pLastSentServer = NULL;
+    TEST_ASSERT_EQUAL( SntpNoResponseReceived, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    TEST_ASSERT_NULL( pLastSentServer );
+
+    /* The hedged request has its own originate timestamp. */
+    TEST_ASSERT_NOT_EQUAL( context.lastRequestTime.fractions, context.hedgeRequestTime.fractions );
+
+    /* The hedged response arrives first, and corrects time without changing
+     * the current server. */
+    fillResponse( hedgeResponse, &context.hedgeRequestTime, 3, 0U, 0U );
+    hedgeRecvCode = SNTP_PACKET_BASE_SIZE;
+    testSystemTime.fractions += TEST_HEDGE_LATE_FRACTIONS;
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    TEST_ASSERT_EQUAL( 1U, setTimeCallCount );
+    TEST_ASSERT_EQUAL( 2, setTimeOffsetSec );
+    TEST_ASSERT_EQUAL( 0U, context.currentServerIndex );
+    TEST_ASSERT_FALSE( context.isHedgePending );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_GetHistogramCount( &histograms[ 1 ].responseLatency, &count ) );
+    TEST_ASSERT_EQUAL( 1U, count );
+
+    /* The response of the current server is used when it arrives first. */
+    TEST_ASSERT_TRUE( isLateRequestHedged() );
+    fillTestResponse( 5, 0U, 0U );
+    UpdRecvCode = SNTP_PACKET_BASE_SIZE;
+    fillResponse( hedgeResponse, &context.hedgeRequestTime, 3, 0U, 0U );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    TEST_ASSERT_EQUAL( 2U, setTimeCallCount );
+    TEST_ASSERT_EQUAL( 4, setTimeOffsetSec );
+    TEST_ASSERT_FALSE( context.isHedgePending );
+}
+
+/**
+ * @brief Test that @ref Sntp_GetResponseWaitTime ends the wait when the time
+ * request is due to be hedged, until the hedged request is sent.
+ */
+void test_GetResponseWaitTime_Hedging( void )
+{
+    SntpServerHistograms_t histograms[ TEST_NUM_SERVERS ];
+    uint32_t latencyUs = 0U;
+    uint32_t waitTimeMs = 0U;
+
+    initHedging( histograms, SNTP_MAX_HEDGE_PERCENT );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_GetHistogramPercentile( &histograms[ 0 ].responseLatency,
+                                                                 SNTP_HEDGE_LATENCY_PERCENTILE, &latencyUs ) );
+
+    testSystemTime.fractions = 0U;
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SendTimeRequest( &context, 0U ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_GetResponseWaitTime( &context, TEST_RESPONSE_TIMEOUT_MS, &waitTimeMs ) );
+    TEST_ASSERT_EQUAL( ( latencyUs + 999U ) / 1000U, waitTimeMs );
+
+    /* The late request has to be hedged now. */
+    testSystemTime.fractions = TEST_HEDGE_LATE_FRACTIONS;
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_GetResponseWaitTime( &context, TEST_RESPONSE_TIMEOUT_MS, &waitTimeMs ) );
+    TEST_ASSERT_EQUAL( 0U, waitTimeMs );
+
+    /* Once hedged, the wait ends at the response timeout. */
+    TEST_ASSERT_EQUAL( SntpNoResponseReceived, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    TEST_ASSERT_TRUE( context.isHedgePending );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_GetResponseWaitTime( &context, TEST_RESPONSE_TIMEOUT_MS, &waitTimeMs ) );
+    TEST_ASSERT_EQUAL( TEST_RESPONSE_TIMEOUT_MS - 200U, waitTimeMs );
+}
+
+/**
+ * @brief Test that failures of the hedged request do not end the time request
+ * or change the current server.
+ */
+void test_ReceiveTimeResponse_HedgingFailures( void )
+{
+    SntpServerHistograms_t histograms[ TEST_NUM_SERVERS ];
+    SntpServerMetrics_t serverMetrics[ TEST_NUM_SERVERS ];
+    SntpMetrics_t metrics;
+    SntpTimeoutEstimator_t estimators[ TEST_NUM_SERVERS ];
+    uint32_t waitTimeMs = 0U;
+
+    initHedging( histograms, SNTP_MAX_HEDGE_PERCENT );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_InitMetrics( &metrics, serverMetrics, TEST_NUM_SERVERS ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SetMetrics( &context, &metrics ) );
+
+    /* A rejected hedged response is ignored, and the request is not hedged
+     * again. */
+    TEST_ASSERT_TRUE( isLateRequestHedged() );
+    fillResponse( hedgeResponse, &context.hedgeRequestTime, 0, 0U, TEST_KOD_CODE_DENY );
+    hedgeRecvCode = SNTP_PACKET_BASE_SIZE;
+    TEST_ASSERT_EQUAL( SntpNoResponseReceived, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    TEST_ASSERT_FALSE( context.isHedgePending );
+    TEST_ASSERT_EQUAL( 0U, context.currentServerIndex );
+    pLastSentServer = NULL;
+    TEST_ASSERT_EQUAL( SntpNoResponseReceived, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    TEST_ASSERT_NULL( pLastSentServer );
+    fillTestResponse( 1, 0U, 0U );
+    UpdRecvCode = SNTP_PACKET_BASE_SIZE;
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    UpdRecvCode = 0;
+
+    /* A failure to read the hedged response is ignored, and counted for the
+     * server of the hedged request. */
+    TEST_ASSERT_TRUE( isLateRequestHedged() );
+    hedgeRecvCode = -1;
+    TEST_ASSERT_EQUAL( SntpNoResponseReceived, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    TEST_ASSERT_FALSE( context.isHedgePending );
+    TEST_ASSERT_EQUAL( 0U, context.currentServerIndex );
+    TEST_ASSERT_EQUAL( 0U, serverMetrics[ 0 ].networkErrors );
+    TEST_ASSERT_EQUAL( 1U, serverMetrics[ 1 ].networkErrors );
+    TEST_ASSERT_EQUAL( 2U, serverMetrics[ 1 ].requests );
+
+    /* A failure to send the hedged request does not change the server. */
+    testSystemTime.fractions = 0U;
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SendTimeRequest( &context, 0U ) );
+    testSystemTime.fractions = TEST_HEDGE_LATE_FRACTIONS;
+    dnsResolveRetCode = false;
+    TEST_ASSERT_EQUAL( SntpNoResponseReceived, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    dnsResolveRetCode = true;
+    TEST_ASSERT_TRUE( context.isHedgeSent );
+    TEST_ASSERT_FALSE( context.isHedgePending );
+    TEST_ASSERT_EQUAL( 0U, context.currentServerIndex );
+
+    /* A failure of the system clock after the time request has failed also
+     * ends the hedged request. */
+    hedgeRecvCode = 0;
+    TEST_ASSERT_TRUE( isLateRequestHedged() );
+    fillTestResponse( 0, 0U, 0U );
+    testResponse[ 0 ] = ( uint8_t ) ( ( 4U << 3 ) | 3U );
+    UpdRecvCode = SNTP_PACKET_BASE_SIZE;
+    TEST_ASSERT_EQUAL( SntpNoResponseReceived, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    UpdRecvCode = 0;
+    getTimeRetCode = false;
+    TEST_ASSERT_EQUAL( SntpErrorSystemClockFailure, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    getTimeRetCode = true;
+    TEST_ASSERT_FALSE( context.isHedgePending );
+    TEST_ASSERT_EQUAL( SntpSuccess, context.requestFailureStatus );
+
+    /* The timeout of the time request waits for the hedged request, until its
+     * own timeout, which is estimated for its server. */
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_InitTimeoutEstimators( estimators, TEST_NUM_SERVERS ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SetTimeoutEstimators( &context, estimators ) );
+    TEST_ASSERT_TRUE( isLateRequestHedged() );
+    testSystemTime.seconds += TEST_RESPONSE_TIMEOUT_MS / 1000U;
+    testSystemTime.fractions = TEST_HEDGE_LATE_FRACTIONS / 2U;
+    TEST_ASSERT_EQUAL( SntpNoResponseReceived, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    TEST_ASSERT_TRUE( context.isHedgePending );
+    TEST_ASSERT_EQUAL( 1U, context.currentServerIndex );
+    TEST_ASSERT_EQUAL( 1U, serverMetrics[ 0 ].timeouts );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_GetResponseWaitTime( &context, TEST_RESPONSE_TIMEOUT_MS, &waitTimeMs ) );
+    TEST_ASSERT_UINT32_WITHIN( 1U, 100U, waitTimeMs );
+    testSystemTime.fractions = TEST_HEDGE_LATE_FRACTIONS + ( TEST_HEDGE_LATE_FRACTIONS / 2U );
+    TEST_ASSERT_EQUAL( SntpErrorResponseTimeout, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    TEST_ASSERT_FALSE( context.isHedgePending );
+    TEST_ASSERT_EQUAL( 1U, serverMetrics[ 1 ].timeouts );
+}
+
+/**
+ * @brief Test that an invalid response of the time request waits for its
+ * hedged request, which can still correct time.
+ */
+void test_ReceiveTimeResponse_HedgingInvalidResponse( void )
+{
+    SntpServerHistograms_t histograms[ TEST_NUM_SERVERS ];
+    SntpServerMetrics_t serverMetrics[ TEST_NUM_SERVERS ];
+    SntpMetrics_t metrics;
+
+    initHedging( histograms, SNTP_MAX_HEDGE_PERCENT );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_InitMetrics( &metrics, serverMetrics, TEST_NUM_SERVERS ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SetMetrics( &context, &metrics ) );
+
+    /* The malformed response of the time request, in client mode, is counted
+     * for its server while the hedged request is still awaited. */
+    TEST_ASSERT_TRUE( isLateRequestHedged() );
+    fillTestResponse( 0, 0U, 0U );
+    testResponse[ 0 ] = ( uint8_t ) ( ( 4U << 3 ) | 3U );
+    UpdRecvCode = SNTP_PACKET_BASE_SIZE;
+    TEST_ASSERT_EQUAL( SntpNoResponseReceived, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    TEST_ASSERT_TRUE( context.isHedgePending );
+    TEST_ASSERT_EQUAL( 1U, serverMetrics[ 0 ].invalidResponses[ SntpMetricsInvalidProtocol ] );
+    UpdRecvCode = 0;
+    TEST_ASSERT_EQUAL( SntpNoResponseReceived, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+
+    /* The valid hedged response then corrects time. */
+    fillResponse( hedgeResponse, &context.hedgeRequestTime, 3, 0U, 0U );
+    hedgeRecvCode = SNTP_PACKET_BASE_SIZE;
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    TEST_ASSERT_EQUAL( 1U, setTimeCallCount );
+    TEST_ASSERT_FALSE( context.isHedgePending );
+    TEST_ASSERT_EQUAL( 0U, context.currentServerIndex );
+    TEST_ASSERT_EQUAL( 1U, serverMetrics[ 1 ].acceptedResponses );
+
+    /* The failure of the time request is returned once the hedged response is
+     * rejected too. */
+    hedgeRecvCode = 0;
+    TEST_ASSERT_TRUE( isLateRequestHedged() );
+    fillTestResponse( 0, 0U, 0U );
+    testResponse[ 0 ] = ( uint8_t ) ( ( 4U << 3 ) | 3U );
+    UpdRecvCode = SNTP_PACKET_BASE_SIZE;
+    TEST_ASSERT_EQUAL( SntpNoResponseReceived, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    fillResponse( hedgeResponse, &context.hedgeRequestTime, 0, 0U, TEST_KOD_CODE_DENY );
+    hedgeRecvCode = SNTP_PACKET_BASE_SIZE;
+    TEST_ASSERT_EQUAL( SntpInvalidResponse, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    TEST_ASSERT_FALSE( context.isHedgePending );
+    TEST_ASSERT_EQUAL( 1U, setTimeCallCount );
+    TEST_ASSERT_EQUAL( 1U, serverMetrics[ 1 ].kissOfDeath[ SntpMetricsKissDeny ] );
+
+    /* The next time request is awaited again. */
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SendTimeRequest( &context, 0U ) );
+    fillTestResponse( 1, 0U, 0U );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+}
+
+/**
+ * @brief Test that responses are attributed to the time request or to its
+ * hedged request by their originate timestamp, whichever server read returns
+ * them, for a transport with a single socket.
+ */
+void test_ReceiveTimeResponse_HedgingSingleSocket( void )
+{
+    SntpServerHistograms_t histograms[ TEST_NUM_SERVERS ];
+    SntpServerMetrics_t serverMetrics[ TEST_NUM_SERVERS ];
+    SntpMetrics_t metrics;
+
+    initHedging( histograms, SNTP_MAX_HEDGE_PERCENT );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_InitMetrics( &metrics, serverMetrics, TEST_NUM_SERVERS ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SetMetrics( &context, &metrics ) );
+    context.authIntf = authIntf;
+
+    /* The hedged response, with authentication data, is read for the server
+     * of the time request, and counted for the server of the hedged request. */
+    testSystemTime.fractions = 0U;
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SendTimeRequest( &context, 0xA5A51234U ) );
+    authCodeSize = 16U;
+    UpdSendRetCode = SNTP_PACKET_BASE_SIZE + 16;
+    testSystemTime.fractions = TEST_HEDGE_LATE_FRACTIONS;
+    TEST_ASSERT_EQUAL( SntpNoResponseReceived, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    TEST_ASSERT_TRUE( context.isHedgePending );
+    fillResponse( testResponse, &context.hedgeRequestTime, 3, 0U, 0U );
+    UpdRecvCode = SNTP_PACKET_BASE_SIZE + 16;
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    TEST_ASSERT_EQUAL( SNTP_PACKET_BASE_SIZE + 16U, lastBytesToRecv );
+    TEST_ASSERT_FALSE( context.isHedgePending );
+    TEST_ASSERT_EQUAL( 0U, serverMetrics[ 0 ].invalidResponses[ SntpMetricsInvalidProtocol ] );
+    TEST_ASSERT_EQUAL( 1U, serverMetrics[ 1 ].acceptedResponses );
+    UpdRecvCode = 0;
+    authCodeSize = 0U;
+    UpdSendRetCode = SNTP_PACKET_BASE_SIZE;
+    context.authIntf.validateServer = NULL;
+
+    /* The response of the time request is read for the server of the hedged
+     * request. */
+    TEST_ASSERT_TRUE( isLateRequestHedged() );
+    fillResponse( hedgeResponse, &context.lastRequestTime, 5, 0U, 0U );
+    hedgeRecvCode = SNTP_PACKET_BASE_SIZE;
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    TEST_ASSERT_EQUAL( 4, setTimeOffsetSec );
+    TEST_ASSERT_EQUAL( 1U, serverMetrics[ 0 ].acceptedResponses );
+    TEST_ASSERT_FALSE( context.isHedgePending );
+
+    /* A rejection of the time request read for the server of the hedged
+     * request fails it, and a duplicate of the rejection is discarded. */
+    hedgeRecvCode = 0;
+    TEST_ASSERT_TRUE( isLateRequestHedged() );
+    fillResponse( hedgeResponse, &context.lastRequestTime, 0, 0U, TEST_KOD_CODE_DENY );
+    hedgeRecvCode = SNTP_PACKET_BASE_SIZE;
+    TEST_ASSERT_EQUAL( SntpNoResponseReceived, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    TEST_ASSERT_TRUE( context.isHedgePending );
+    TEST_ASSERT_EQUAL( 1U, context.currentServerIndex );
+    TEST_ASSERT_EQUAL( SntpNoResponseReceived, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    TEST_ASSERT_EQUAL( 1U, serverMetrics[ 0 ].kissOfDeath[ SntpMetricsKissDeny ] );
+
+    /* The failure is returned once reading the hedged response fails. */
+    hedgeRecvCode = -1;
+    TEST_ASSERT_EQUAL( SntpRejectedResponseChangeServer,
+                       Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    TEST_ASSERT_FALSE( context.isHedgePending );
+    TEST_ASSERT_EQUAL( 1U, serverMetrics[ 1 ].networkErrors );
+}
+
+/**
+ * @brief Test the conditions and the budget of hedged requests.
+ */
+void test_ReceiveTimeResponse_HedgingBudget( void )
+{
+    SntpServerHistograms_t histograms[ TEST_NUM_SERVERS ];
+    size_t hedgedRequests = 0U;
+    size_t i;
+
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_SetHedging( NULL, 10U ) );
+    initHedging( histograms, 50U );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_SetHedging( &context, SNTP_MAX_HEDGE_PERCENT + 1U ) );
+
+    /* Half of the requests are hedged, and the credit of unhedged requests
+     * does not accumulate beyond a single hedged request. */
+    for( i = 0U; i < 10U; i++ )
+    {
+        hedgedRequests += ( isLateRequestHedged() == true ) ? 1U : 0U;
+    }
+
+    TEST_ASSERT_EQUAL( 5U, hedgedRequests );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SetHedging( &context, 0U ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SetHedging( &context, 50U ) );
+    TEST_ASSERT_FALSE( isLateRequestHedged() );
+    TEST_ASSERT_TRUE( isLateRequestHedged() );
+
+    /* Requests are not hedged when disabled, after a backward step of system
+     * time, without the histograms, or with too few recorded latencies. */
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SetHedging( &context, 0U ) );
+    TEST_ASSERT_FALSE( isLateRequestHedged() );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SetHedging( &context, SNTP_MAX_HEDGE_PERCENT ) );
+    testSystemTime.fractions = 0U;
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SendTimeRequest( &context, 0U ) );
+    testSystemTime.seconds--;
+    testSystemTime.fractions = TEST_HEDGE_LATE_FRACTIONS;
+    TEST_ASSERT_EQUAL( SntpNoResponseReceived, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    TEST_ASSERT_EQUAL_PTR( &testServers[ 0 ], pLastSentServer );
+    testSystemTime.seconds++;
+    TEST_ASSERT_EQUAL( SntpNoResponseReceived, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    TEST_ASSERT_EQUAL_PTR( &testServers[ 1 ], pLastSentServer );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SetServerHistograms( &context, NULL ) );
+    TEST_ASSERT_FALSE( isLateRequestHedged() );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_InitServerHistograms( histograms, TEST_NUM_SERVERS ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SetServerHistograms( &context, histograms ) );
+    TEST_ASSERT_FALSE( isLateRequestHedged() );
+
+    /* A single server cannot be hedged. */
+    TEST_ASSERT_EQUAL( SntpSuccess,
+                       Sntp_Init( &context, testServers, 1U, testBuffer, sizeof( testBuffer ), dnsResolve,
+                                  getTime, setTime, &transportIntf, NULL ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SetHedging( &context, SNTP_MAX_HEDGE_PERCENT ) );
+    TEST_ASSERT_FALSE( isLateRequestHedged() );
+    TEST_ASSERT_FALSE( isLateRequestHedged() );
+}
+
+/**
+ * @brief Test that the response timeout of each server adapts to its response
+ * latency with the timeout estimators.
+ */
+void test_ReceiveTimeResponse_TimeoutEstimators( void )
+{
+    SntpTimeoutEstimator_t estimators[ TEST_NUM_SERVERS ];
+    uint32_t timeoutMs;
+
+    initContext( NULL );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_InitTimeoutEstimators( estimators, TEST_NUM_SERVERS ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_SetTimeoutEstimators( NULL, estimators ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SetTimeoutEstimators( &context, estimators ) );
+
+    /* The response arrives 100 ms after the request, for an estimated timeout
+     * of 300 ms. */
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SendTimeRequest( &context, 0U ) );
+    fillTestResponse( 0, 0U, 0U );
+    UpdRecvCode = SNTP_PACKET_BASE_SIZE;
+    testSystemTime.fractions += ( uint32_t ) ( FRACTIONS_PER_SECOND / 10 );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_GetResponseTimeout( &estimators[ 0 ], 0U, &timeoutMs ) );
+    TEST_ASSERT_EQUAL( 300U, timeoutMs );
+
+    /* A latency measured across a backward step of system time is ignored. */
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SendTimeRequest( &context, 0U ) );
+    fillTestResponse( 0, 0U, 0U );
+    testSystemTime.seconds -= 1U;
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_GetResponseTimeout( &estimators[ 0 ], 0U, &timeoutMs ) );
+    TEST_ASSERT_EQUAL( 300U, timeoutMs );
+
+    /* The server times out well before the passed timeout, and its estimated
+     * timeout is doubled. */
+    UpdRecvCode = 0;
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SendTimeRequest( &context, 0U ) );
+    testSystemTime.fractions += ( uint32_t ) ( FRACTIONS_PER_SECOND / 5 );
+    TEST_ASSERT_EQUAL( SntpNoResponseReceived, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    testSystemTime.fractions += ( uint32_t ) ( FRACTIONS_PER_SECOND / 5 );
+    TEST_ASSERT_EQUAL( SntpErrorResponseTimeout, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    TEST_ASSERT_EQUAL( 1U, context.currentServerIndex );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_GetResponseTimeout( &estimators[ 0 ], 0U, &timeoutMs ) );
+    TEST_ASSERT_EQUAL( 600U, timeoutMs );
+
+    /* The next server uses the passed timeout until its latency is measured. */
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SendTimeRequest( &context, 0U ) );
+    testSystemTime.seconds += TEST_RESPONSE_TIMEOUT_MS / 1000U - 1U;
+    TEST_ASSERT_EQUAL( SntpNoResponseReceived, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    testSystemTime.seconds += 1U;
+    TEST_ASSERT_EQUAL( SntpErrorResponseTimeout, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_GetResponseTimeout( &estimators[ 1 ], 0U, &timeoutMs ) );
+    TEST_ASSERT_EQUAL( 0U, timeoutMs );
+}
+
+/**
+ * @brief Test that @ref Sntp_GetResponseWaitTime returns the time remaining
+ * until the response timeout, shortened by the estimated timeout of the server.
+ */
+void test_GetResponseWaitTime( void )
+{
+    SntpTimeoutEstimator_t estimators[ TEST_NUM_SERVERS ];
+    uint32_t waitTimeMs = 0U;
+
+    initContext( NULL );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_GetResponseWaitTime( NULL, TEST_RESPONSE_TIMEOUT_MS, &waitTimeMs ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_GetResponseWaitTime( &context, TEST_RESPONSE_TIMEOUT_MS, NULL ) );
+
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SendTimeRequest( &context, 0U ) );
+    getTimeRetCode = false;
+    TEST_ASSERT_EQUAL( SntpErrorSystemClockFailure,
+                       Sntp_GetResponseWaitTime( &context, TEST_RESPONSE_TIMEOUT_MS, &waitTimeMs ) );
+    getTimeRetCode = true;
+
+    /* The wait ends at the passed timeout, rounded up to whole milliseconds. */
+    testSystemTime.seconds += 1U;
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_GetResponseWaitTime( &context, TEST_RESPONSE_TIMEOUT_MS, &waitTimeMs ) );
+    TEST_ASSERT_EQUAL( TEST_RESPONSE_TIMEOUT_MS - 1000U, waitTimeMs );
+    testSystemTime.fractions += ( uint32_t ) ( FRACTIONS_PER_SECOND / 1000 ) + 1U;
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_GetResponseWaitTime( &context, TEST_RESPONSE_TIMEOUT_MS, &waitTimeMs ) );
+    TEST_ASSERT_EQUAL( TEST_RESPONSE_TIMEOUT_MS - 1001U, waitTimeMs );
+
+    /* There is no wait once the timeout has expired, including after a step of
+     * system time back. */
+    testSystemTime.seconds += TEST_RESPONSE_TIMEOUT_MS / 1000U;
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_GetResponseWaitTime( &context, TEST_RESPONSE_TIMEOUT_MS, &waitTimeMs ) );
+    TEST_ASSERT_EQUAL( 0U, waitTimeMs );
+    testSystemTime.seconds -= 100U;
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_GetResponseWaitTime( &context, TEST_RESPONSE_TIMEOUT_MS, &waitTimeMs ) );
+    TEST_ASSERT_EQUAL( 0U, waitTimeMs );
+
+    /* An estimated timeout of 300 ms shortens the wait. */
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_InitTimeoutEstimators( estimators, TEST_NUM_SERVERS ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_UpdateTimeoutEstimator( &estimators[ 0 ], FRACTIONS_PER_SECOND / 10 ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SetTimeoutEstimators( &context, estimators ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SendTimeRequest( &context, 0U ) );
+    testSystemTime.fractions += ( uint32_t ) ( FRACTIONS_PER_SECOND / 10 );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_GetResponseWaitTime( &context, TEST_RESPONSE_TIMEOUT_MS, &waitTimeMs ) );
+    TEST_ASSERT_EQUAL( 200U, waitTimeMs );
+}
+
+/**
+ * @brief Test that the client records the outcomes of the requests in the
+ * health of the servers, and uses the healthiest server.
+ */
+void test_SendReceive_ServerHealth( void )
+{
+    SntpServerHealth_t health[ TEST_NUM_SERVERS ];
+    uint8_t savedHealth[ SNTP_HEALTH_SAVED_SIZE( TEST_NUM_SERVERS ) ];
+    size_t savedSize = 0U;
+
+    initContext( NULL );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_InitServerHealth( health, TEST_NUM_SERVERS ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_SetServerHealth( NULL, health ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SetServerHealth( &context, health ) );
+
+    /* The servers are identified by their names. */
+    TEST_ASSERT_NOT_EQUAL( 0U, health[ 0 ].serverId );
+    TEST_ASSERT_NOT_EQUAL( health[ 0 ].serverId, health[ 1 ].serverId );
+
+    /* The health saved before a restart is restored after the identifiers are
+     * set, and the healthiest server is used from the first request. */
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_RecordServerHealth( &health[ 1 ], SntpSuccess, 0 ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SaveServerHealth( health, TEST_NUM_SERVERS, savedHealth,
+                                                           sizeof( savedHealth ), &savedSize ) );
+    initContext( NULL );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_InitServerHealth( health, TEST_NUM_SERVERS ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SetServerHealth( &context, health ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_RestoreServerHealth( health, TEST_NUM_SERVERS, savedHealth, savedSize ) );
+    TEST_ASSERT_EQUAL( 1U, health[ 1 ].numOfResponses );
+
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SendTimeRequest( &context, 0U ) );
+    TEST_ASSERT_EQUAL_PTR( &testServers[ 1 ], pLastSentServer );
+    TEST_ASSERT_EQUAL( 1U, context.currentServerIndex );
+
+    /* The round-trip delay of 100 ms of the response is recorded. */
+    fillTestResponse( 0, 0U, 0U );
+    UpdRecvCode = SNTP_PACKET_BASE_SIZE;
+    testSystemTime.fractions += ( uint32_t ) ( FRACTIONS_PER_SECOND / 10 );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    TEST_ASSERT_EQUAL( 2U, health[ 1 ].numOfResponses );
+    TEST_ASSERT_UINT32_WITHIN( 1U, 12500U, health[ 1 ].roundTripDelayUs );
+    TEST_ASSERT_EQUAL( 40448U, health[ 1 ].successRate );
+
+    /* Server 1 now scores below the unknown health of server 0 by more than
+     * the margin, so server 0 is tried, until it fails. */
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SendTimeRequest( &context, 0U ) );
+    TEST_ASSERT_EQUAL_PTR( &testServers[ 0 ], pLastSentServer );
+    UpdRecvCode = 0;
+    testSystemTime.seconds += TEST_RESPONSE_TIMEOUT_MS / 1000U;
+    TEST_ASSERT_EQUAL( SntpErrorResponseTimeout, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    TEST_ASSERT_EQUAL( 28672U, health[ 0 ].successRate );
+    TEST_ASSERT_EQUAL( 1U, context.currentServerIndex );
+
+    /* Kiss-o'-Death responses and failures to send are recorded. */
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SendTimeRequest( &context, 0U ) );
+    TEST_ASSERT_EQUAL_PTR( &testServers[ 1 ], pLastSentServer );
+    fillTestResponse( 0, 0U, TEST_KOD_CODE_DENY );
+    UpdRecvCode = SNTP_PACKET_BASE_SIZE;
+    TEST_ASSERT_EQUAL( SntpRejectedResponseChangeServer,
+                       Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    TEST_ASSERT_EQUAL( 8192U, health[ 1 ].kissOfDeathRate );
+    TEST_ASSERT_EQUAL( 35392U, health[ 1 ].successRate );
+    TEST_ASSERT_EQUAL( 0U, context.currentServerIndex );
+
+    UpdSendRetCode = -1;
+    TEST_ASSERT_EQUAL( SntpErrorNetworkFailure, Sntp_SendTimeRequest( &context, 0U ) );
+    TEST_ASSERT_EQUAL( 25088U, health[ 0 ].successRate );
+    TEST_ASSERT_EQUAL( 1U, context.currentServerIndex );
+
+    /* Failures that do not depend on the server are not recorded, although
+     * the healthier server 0 is selected for the request. */
+    UpdSendRetCode = SNTP_PACKET_BASE_SIZE;
+    getTimeRetCode = false;
+    TEST_ASSERT_EQUAL( SntpErrorSystemClockFailure, Sntp_SendTimeRequest( &context, 0U ) );
+    getTimeRetCode = true;
+    TEST_ASSERT_EQUAL( 0U, context.currentServerIndex );
+    TEST_ASSERT_EQUAL( 25088U, health[ 0 ].successRate );
+
+    /* Without server health, the servers are used in their order. */
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SetServerHealth( &context, NULL ) );
+    TEST_ASSERT_FALSE( context.isServerSelectionPending );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SendTimeRequest( &context, 0U ) );
+    TEST_ASSERT_EQUAL_PTR( &testServers[ 0 ], pLastSentServer );
+}
+
+/**
+ * @brief Test that the client switches from a server that keeps responding,
+ * but slowly, to a faster server, and not between servers of similar health.
+ */
+void test_SendReceive_ServerHealthSwitch( void )
+{
+    SntpServerHealth_t health[ TEST_NUM_SERVERS ];
+    uint32_t slowScore = 0U;
+    uint32_t fastScore = 0U;
+    size_t slowResponses = 0U;
+    size_t i;
+
+    initContext( NULL );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_InitServerHealth( health, TEST_NUM_SERVERS ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SetServerHealth( &context, health ) );
+
+    /* Both servers are known to respond within 10 ms, so the first server is
+     * selected. */
+    for( i = 0U; i < 8U; i++ )
+    {
+        TEST_ASSERT_EQUAL( SntpSuccess, Sntp_RecordServerHealth( &health[ 0 ], SntpSuccess,
+                                                                 FRACTIONS_PER_SECOND / 100 ) );
+        TEST_ASSERT_EQUAL( SntpSuccess, Sntp_RecordServerHealth( &health[ 1 ], SntpSuccess,
+                                                                 FRACTIONS_PER_SECOND / 100 ) );
+    }
+
+    /* Server 0 keeps responding after 400 ms, until its score falls below the
+     * score of server 1 by the margin. */
+    do
+    {
+        TEST_ASSERT_EQUAL( SntpSuccess, Sntp_GetServerHealthScore( &health[ 0 ], &slowScore ) );
+        TEST_ASSERT_EQUAL( SntpSuccess, Sntp_GetServerHealthScore( &health[ 1 ], &fastScore ) );
+        TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SendTimeRequest( &context, 0U ) );
+
+        if( fastScore > ( slowScore + SNTP_HEALTH_SWITCH_MARGIN ) )
+        {
+            TEST_ASSERT_EQUAL_PTR( &testServers[ 1 ], pLastSentServer );
+        }
+        else
+        {
+            TEST_ASSERT_EQUAL_PTR( &testServers[ 0 ], pLastSentServer );
+            fillTestResponse( 0, 0U, 0U );
+            UpdRecvCode = SNTP_PACKET_BASE_SIZE;
+            testSystemTime.fractions += ( uint32_t ) ( ( FRACTIONS_PER_SECOND * 2 ) / 5 );
+            TEST_ASSERT_EQUAL( SntpSuccess, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+            slowResponses++;
+        }
+    } while( ( pLastSentServer == &testServers[ 0 ] ) && ( slowResponses < 10U ) );
+
+    TEST_ASSERT_EQUAL( 1U, context.currentServerIndex );
+    TEST_ASSERT_GREATER_THAN( 0U, slowResponses );
+    TEST_ASSERT_LESS_THAN( 10U, slowResponses );
+    TEST_ASSERT_EQUAL( 0U, context.consecutiveServerFailures );
+
+    /* A server that is only slightly healthier than the current server is not
+     * switched to. */
+    health[ 0 ] = health[ 1 ];
+    health[ 0 ].successRate += SNTP_HEALTH_SWITCH_MARGIN / 2U;
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_GetServerHealthScore( &health[ 0 ], &slowScore ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_GetServerHealthScore( &health[ 1 ], &fastScore ) );
+    TEST_ASSERT_GREATER_THAN( fastScore, slowScore );
+    TEST_ASSERT_LESS_OR_EQUAL( fastScore + SNTP_HEALTH_SWITCH_MARGIN, slowScore );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SendTimeRequest( &context, 0U ) );
+    TEST_ASSERT_EQUAL_PTR( &testServers[ 1 ], pLastSentServer );
+}
+
+/* Maximum number of events kept by the trace function of the tests. */
+#define TEST_MAX_TRACE_EVENTS    ( 8U )
+
+/* Events received by the trace function of the tests. */
+static SntpTraceEvent_t testTraceEvents[ TEST_MAX_TRACE_EVENTS ];
+static size_t testTraceEventCount;
+
+/* Trace function of the tests, which keeps the events. */
+static void traceEvent( void * pTraceContext,
+                        const SntpTraceEvent_t * pEvent )
+{
+    TEST_ASSERT_EQUAL_PTR( &testTraceEventCount, pTraceContext );
+    TEST_ASSERT_LESS_THAN( TEST_MAX_TRACE_EVENTS, testTraceEventCount );
+
+    testTraceEvents[ testTraceEventCount ] = *pEvent;
+    testTraceEventCount++;
+}
+
+/* Checks the type and status of a traced event. */
+static void assertTraceEvent( size_t index,
+                              SntpTraceEventType_t type,
+                              SntpStatus_t status )
+{
+    TEST_ASSERT_LESS_THAN( testTraceEventCount, index );
+    TEST_ASSERT_EQUAL( type, testTraceEvents[ index ].type );
+    TEST_ASSERT_EQUAL( status, testTraceEvents[ index ].status );
+}
+
+/**
+ * @brief Test the events traced for requests and responses.
+ */
+void test_SendReceive_Tracing( void )
+{
+    initContext( NULL );
+    testTraceEventCount = 0U;
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_SetTraceCallback( NULL, traceEvent, NULL ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SetTraceCallback( &context, traceEvent, &testTraceEventCount ) );
+
+    /* An accepted response, with the time of each event. */
+    UpdRecvCode = SNTP_PACKET_BASE_SIZE;
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SendTimeRequest( &context, 0U ) );
+    fillTestResponse( 1, 0U, 0U );
+    testSystemTime.seconds += 1U;
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+
+    TEST_ASSERT_EQUAL( 5U, testTraceEventCount );
+    assertTraceEvent( 0U, SntpTraceRequestSerialized, SntpSuccess );
+    assertTraceEvent( 1U, SntpTraceRequestSent, SntpSuccess );
+    assertTraceEvent( 2U, SntpTraceResponseReceived, SntpSuccess );
+    assertTraceEvent( 3U, SntpTraceResponseValidated, SntpSuccess );
+    assertTraceEvent( 4U, SntpTraceClockUpdated, SntpSuccess );
+    TEST_ASSERT_EQUAL_PTR( &testServers[ 0 ], testTraceEvents[ 1 ].pServer );
+    TEST_ASSERT_EQUAL( SNTP_PACKET_BASE_SIZE, testTraceEvents[ 1 ].packetSize );
+    TEST_ASSERT_EQUAL( TEST_SYSTEM_TIME_SECS, testTraceEvents[ 1 ].time.seconds );
+    TEST_ASSERT_EQUAL( TEST_SYSTEM_TIME_SECS + 1U, testTraceEvents[ 2 ].time.seconds );
+
+    /* A Kiss-o'-Death response. */
+    testTraceEventCount = 0U;
+    fillTestResponse( 0, 0U, 0x52415445U );
+    TEST_ASSERT_EQUAL( SntpRejectedResponseRetryWithBackoff,
+                       Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    assertTraceEvent( 1U, SntpTraceResponseRejected, SntpRejectedResponseRetryWithBackoff );
+    TEST_ASSERT_EQUAL_HEX32( 0x52415445U, testTraceEvents[ 1 ].rejectedResponseCode );
+
+    /* A response whose clock offset overflows corrects the clock, and an
+     * invalid response has no Kiss-o'-Death code. */
+    testTraceEventCount = 0U;
+    fillTestResponse( INT32_MIN, 0U, 0U );
+    TEST_ASSERT_EQUAL( SntpClockOffsetOverflow, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    assertTraceEvent( 2U, SntpTraceClockUpdated, SntpClockOffsetOverflow );
+    testTraceEventCount = 0U;
+    testResponse[ 24 ]++;
+    TEST_ASSERT_EQUAL( SntpInvalidResponse, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    assertTraceEvent( 1U, SntpTraceResponseRejected, SntpInvalidResponse );
+    TEST_ASSERT_EQUAL( SNTP_KISS_OF_DEATH_CODE_NONE, testTraceEvents[ 1 ].rejectedResponseCode );
+
+    /* Failures of the request and of the response. */
+    testTraceEventCount = 0U;
+    UpdRecvCode = -1;
+    TEST_ASSERT_EQUAL( SntpErrorNetworkFailure, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    dnsResolveRetCode = false;
+    TEST_ASSERT_EQUAL( SntpErrorDnsFailure, Sntp_SendTimeRequest( &context, 0U ) );
+    dnsResolveRetCode = true;
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SendTimeRequest( &context, 0U ) );
+    UpdRecvCode = 0;
+    testSystemTime.seconds += TEST_RESPONSE_TIMEOUT_MS / 1000U;
+    getTimeRetCode = false;
+    TEST_ASSERT_EQUAL( SntpErrorSystemClockFailure, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+    getTimeRetCode = true;
+    TEST_ASSERT_EQUAL( SntpErrorResponseTimeout, Sntp_ReceiveTimeResponse( &context, TEST_RESPONSE_TIMEOUT_MS ) );
+
+    TEST_ASSERT_EQUAL( 5U, testTraceEventCount );
+    assertTraceEvent( 0U, SntpTraceResponseFailed, SntpErrorNetworkFailure );
+    assertTraceEvent( 1U, SntpTraceRequestFailed, SntpErrorDnsFailure );
+    TEST_ASSERT_EQUAL_PTR( &testServers[ 1 ], testTraceEvents[ 1 ].pServer );
+    assertTraceEvent( 4U, SntpTraceResponseFailed, SntpErrorResponseTimeout );
+
+    /* An event is traced with no time when the system time cannot be read. */
+    testTraceEventCount = 0U;
+    getTimeRetCode = false;
+    TEST_ASSERT_EQUAL( SntpErrorSystemClockFailure, Sntp_SendTimeRequest( &context, 0U ) );
+    getTimeRetCode = true;
+    assertTraceEvent( 0U, SntpTraceRequestFailed, SntpErrorSystemClockFailure );
+    TEST_ASSERT_EQUAL( 0U, testTraceEvents[ 0 ].time.seconds );
+    TEST_ASSERT_EQUAL( 0U, testTraceEvents[ 0 ].time.fractions );
+
+    /* No events are traced without a trace function. */
+    testTraceEventCount = 0U;
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SetTraceCallback( &context, NULL, NULL ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SendTimeRequest( &context, 0U ) );
+    TEST_ASSERT_EQUAL( 0U, testTraceEventCount );
+}
@@ -0,0 +1,685 @@
+/*
+ * coreSNTP v1.0.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Standard includes. */
+#include <string.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+/* Unity include. */
+#include "unity.h"
+
+/* coreSNTP Virtual Clock API include */
+#include "core_sntp_clock.h"
+
+/* Number of SNTP timestamp fractions in a second. */
+#define FRACTIONS_PER_SECOND    ( ( int64_t ) 0x100000000 )
+
+/* Number of SNTP timestamp fractions per second for a 1 PPM frequency error. */
+#define FRACTIONS_PER_PPM       ( FRACTIONS_PER_SECOND / 1000000 )
+
+/* Local time used as the starting time in tests. */
+#define TEST_LOCAL_TIME_SECS    ( SNTP_TIME_AT_UNIX_EPOCH_SECS + 1000U )
+
+/* SNTP time of 1st Jan 2017 0:00:00 UTC, the end of month with a leap second. */
+#define TEST_LEAP_TIME_SECS     ( 3692217600U )
+
+/* Smear window used in tests. */
+#define TEST_SMEAR_WINDOW_SECS    ( 1000U )
+
+/* Global variables common to test cases. */
+static SntpVirtualClock_t testClock;
+
+/* ============================ Helper Functions ============================ */
+
+/* Converts an SNTP timestamp to a 64-bit fixed-point value. */
+static uint64_t toFixed( const SntpTimestamp_t * pTime )
+{
+    return ( ( uint64_t ) pTime->seconds << 32 ) | pTime->fractions;
+}
+
+/* Converts a 64-bit fixed-point value to an SNTP timestamp. */
+static SntpTimestamp_t toTimestamp( uint64_t fixedTime )
+{
+    SntpTimestamp_t time;
+
+    time.seconds = ( uint32_t ) ( fixedTime >> 32 );
+    time.fractions = ( uint32_t ) fixedTime;
+
+    return time;
+}
+
+/* ============================   UNITY FIXTURES ============================ */
+
+/* Called before each test method. */
+void setUp()
+{
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_InitVirtualClock( &testClock ) );
+}
+
+/* Called at the beginning of the whole suite. */
+void suiteSetUp()
+{
+}
+
+/* Called at the end of the whole suite. */
+int suiteTearDown( int numFailures )
+{
+    return numFailures;
+}
+
+/* ========================================================================== */
+
+/**
+ * @brief Test the virtual clock API functions with invalid parameters.
+ */
+void test_VirtualClock_InvalidParams( void )
+{
+    SntpTimestamp_t localTime = { TEST_LOCAL_TIME_SECS, 0 };
+    SntpTimestamp_t correctedTime;
+    uint32_t unixSecs, unixMicrosecs;
+
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_InitVirtualClock( NULL ) );
+
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_UpdateVirtualClock( NULL, &localTime, 0 ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_UpdateVirtualClock( &testClock, NULL, 0 ) );
+
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_GetCorrectedTime( NULL, &localTime, &correctedTime ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_GetCorrectedTime( &testClock, NULL, &correctedTime ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_GetCorrectedTime( &testClock, &localTime, NULL ) );
+
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_GetCorrectedUnixTime( NULL, &localTime,
+                                                                         &unixSecs, &unixMicrosecs ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_GetCorrectedUnixTime( &testClock, &localTime,
+                                                                         NULL, &unixMicrosecs ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_GetCorrectedUnixTime( &testClock, &localTime,
+                                                                         &unixSecs, NULL ) );
+}
+
+/**
+ * @brief Test that the virtual clock does not provide time before it receives
+ * a clock offset sample.
+ */
+void test_VirtualClock_NotSynchronized( void )
+{
+    SntpTimestamp_t localTime = { TEST_LOCAL_TIME_SECS, 0 };
+    SntpTimestamp_t correctedTime;
+    uint32_t unixSecs, unixMicrosecs;
+
+    TEST_ASSERT_EQUAL( SntpClockNotSynchronized, Sntp_GetCorrectedTime( &testClock,
+                                                                        &localTime,
+                                                                        &correctedTime ) );
+    TEST_ASSERT_EQUAL( SntpClockNotSynchronized, Sntp_GetCorrectedUnixTime( &testClock,
+                                                                            &localTime,
+                                                                            &unixSecs,
+                                                                            &unixMicrosecs ) );
+}
+
+/**
+ * @brief Test that the first clock offset sample is applied to the local time
+ * as is, including negative offsets.
+ */
+void test_VirtualClock_FirstSample( void )
+{
+    SntpTimestamp_t localTime = { TEST_LOCAL_TIME_SECS, 0 };
+    SntpTimestamp_t correctedTime;
+
+    /* Apply a positive offset of 2.5 seconds. */
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_UpdateVirtualClock( &testClock,
+                                                             &localTime,
+                                                             ( 5 * FRACTIONS_PER_SECOND ) / 2 ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_GetCorrectedTime( &testClock, &localTime, &correctedTime ) );
+    TEST_ASSERT_EQUAL_UINT32( TEST_LOCAL_TIME_SECS + 2U, correctedTime.seconds );
+    TEST_ASSERT_EQUAL_UINT32( 0x80000000U, correctedTime.fractions );
+
+    /* Without frequency correction, the offset stays constant as local time advances. */
+    localTime.seconds += 100U;
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_GetCorrectedTime( &testClock, &localTime, &correctedTime ) );
+    TEST_ASSERT_EQUAL_UINT32( TEST_LOCAL_TIME_SECS + 102U, correctedTime.seconds );
+    TEST_ASSERT_EQUAL_UINT32( 0x80000000U, correctedTime.fractions );
+
+    /* Apply a negative offset on a fresh clock. */
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_InitVirtualClock( &testClock ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_UpdateVirtualClock( &testClock,
+                                                             &localTime,
+                                                             -FRACTIONS_PER_SECOND / 4 ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_GetCorrectedTime( &testClock, &localTime, &correctedTime ) );
+    TEST_ASSERT_EQUAL_UINT32( TEST_LOCAL_TIME_SECS + 99U, correctedTime.seconds );
+    TEST_ASSERT_EQUAL_UINT32( 0xC0000000U, correctedTime.fractions );
+}
+
+/**
+ * @brief Test that the virtual clock learns the frequency error of a local clock
+ * and corrects time between clock offset samples.
+ */
+void test_VirtualClock_FrequencyCorrection( void )
+{
+    /* The local clock runs 100 PPM slow relative to server time, i.e. the clock
+     * offset grows by 100 microseconds every second. */
+    const int64_t driftPerSecond = 100 * FRACTIONS_PER_PPM;
+    const uint32_t pollIntervalSecs = 64U;
+    uint64_t localTime = ( uint64_t ) TEST_LOCAL_TIME_SECS << 32;
+    int64_t trueOffset = FRACTIONS_PER_SECOND;
+    SntpTimestamp_t localTimestamp;
+    SntpTimestamp_t correctedTime;
+    int i;
+
+    for( i = 0; i < 40; i++ )
+    {
+        localTimestamp = toTimestamp( localTime );
+        TEST_ASSERT_EQUAL( SntpSuccess, Sntp_UpdateVirtualClock( &testClock,
+                                                                 &localTimestamp,
+                                                                 trueOffset ) );
+        localTime += ( uint64_t ) pollIntervalSecs << 32;
+        trueOffset += driftPerSecond * pollIntervalSecs;
+    }
+
+    /* The frequency correction should have converged on the drift rate. */
+    TEST_ASSERT_INT64_WITHIN( FRACTIONS_PER_PPM, driftPerSecond, testClock.model.frequency );
+
+    /* Half way to the next sample, the corrected time should account for the
+     * drift accumulated since the last sample. */
+    localTime -= ( uint64_t ) ( pollIntervalSecs / 2U ) << 32;
+    localTimestamp = toTimestamp( localTime );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_GetCorrectedTime( &testClock, &localTimestamp, &correctedTime ) );
+    TEST_ASSERT_INT64_WITHIN( 10 * FRACTIONS_PER_PPM,
+                              trueOffset - ( driftPerSecond * ( pollIntervalSecs / 2U ) ),
+                              ( int64_t ) ( toFixed( &correctedTime ) - localTime ) );
+
+    /* Corrected time for a local time before the last update is also supported. */
+    localTime -= ( uint64_t ) pollIntervalSecs << 32;
+    localTimestamp = toTimestamp( localTime );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_GetCorrectedTime( &testClock, &localTimestamp, &correctedTime ) );
+    TEST_ASSERT_INT64_WITHIN( 10 * FRACTIONS_PER_PPM,
+                              trueOffset - ( driftPerSecond * ( pollIntervalSecs + ( pollIntervalSecs / 2U ) ) ),
+                              ( int64_t ) ( toFixed( &correctedTime ) - localTime ) );
+}
+
+/**
+ * @brief Test that the virtual clock ignores frequency error for samples less
+ * than a second apart, and limits the frequency correction to
+ * #SNTP_CLOCK_MAX_FREQUENCY_PPM.
+ */
+void test_VirtualClock_FrequencyLimits( void )
+{
+    SntpTimestamp_t localTime = { TEST_LOCAL_TIME_SECS, 0 };
+    int i;
+
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_UpdateVirtualClock( &testClock, &localTime, 0 ) );
+
+    /* A large change in offset within a second does not change frequency. */
+    localTime.fractions = 0x80000000U;
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_UpdateVirtualClock( &testClock, &localTime, FRACTIONS_PER_SECOND ) );
+    TEST_ASSERT_EQUAL( 0, testClock.model.frequency );
+
+    /* A local time earlier than the last update does not change frequency. */
+    localTime.seconds -= 10U;
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_UpdateVirtualClock( &testClock, &localTime, 0 ) );
+    TEST_ASSERT_EQUAL( 0, testClock.model.frequency );
+
+    /* Large offset changes saturate the frequency correction. */
+    for( i = 0; i < 10; i++ )
+    {
+        localTime.seconds += 1U;
+        TEST_ASSERT_EQUAL( SntpSuccess, Sntp_UpdateVirtualClock( &testClock,
+                                                                 &localTime,
+                                                                 ( i + 1 ) * FRACTIONS_PER_SECOND ) );
+    }
+
+    TEST_ASSERT_EQUAL( SNTP_CLOCK_MAX_FREQUENCY_PPM * ( int32_t ) SNTP_FRACTION_VALUE_PER_MICROSECOND,
+                       testClock.model.frequency );
+
+    for( i = 0; i < 10; i++ )
+    {
+        localTime.seconds += 1U;
+        TEST_ASSERT_EQUAL( SntpSuccess, Sntp_UpdateVirtualClock( &testClock,
+                                                                 &localTime,
+                                                                 -( i + 1 ) * FRACTIONS_PER_SECOND ) );
+    }
+
+    TEST_ASSERT_EQUAL( -SNTP_CLOCK_MAX_FREQUENCY_PPM * ( int32_t ) SNTP_FRACTION_VALUE_PER_MICROSECOND,
+                       testClock.model.frequency );
+}
+
+/**
+ * @brief Test that the corrected time handles the wrap-around of SNTP era 0
+ * into era 1, and that it can be read in UNIX time format.
+ */
+void test_VirtualClock_EraWrapAndUnixTime( void )
+{
+    SntpTimestamp_t localTime = { UINT32_MAX, 0x80000000U };
+    SntpTimestamp_t correctedTime;
+    uint32_t unixSecs, unixMicrosecs;
+
+    /* Offset of 1 second moves the corrected time into SNTP era 1. */
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_UpdateVirtualClock( &testClock, &localTime, FRACTIONS_PER_SECOND ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_GetCorrectedTime( &testClock, &localTime, &correctedTime ) );
+    TEST_ASSERT_EQUAL_UINT32( 0U, correctedTime.seconds );
+    TEST_ASSERT_EQUAL_UINT32( 0x80000000U, correctedTime.fractions );
+
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_GetCorrectedUnixTime( &testClock, &localTime,
+                                                               &unixSecs, &unixMicrosecs ) );
+    TEST_ASSERT_EQUAL_UINT32( UNIX_TIME_SECS_AT_SNTP_ERA_1_SMALLEST_TIME, unixSecs );
+    TEST_ASSERT_EQUAL_UINT32( 500000U, unixMicrosecs );
+
+    /* Corrected time outside the supported UNIX time range is reported. */
+    localTime.seconds = SNTP_TIME_AT_UNIX_EPOCH_SECS - 10U;
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_InitVirtualClock( &testClock ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_UpdateVirtualClock( &testClock, &localTime, 0 ) );
+    TEST_ASSERT_EQUAL( SntpErrorTimeNotSupported, Sntp_GetCorrectedUnixTime( &testClock, &localTime,
+                                                                             &unixSecs, &unixMicrosecs ) );
+}
+
+/**
+ * @brief Test the leap smear API functions with invalid parameters.
+ */
+void test_LeapSmear_InvalidParams( void )
+{
+    SntpLeapSmear_t leapSmear;
+    SntpTimestamp_t time = { TEST_LEAP_TIME_SECS, 0 };
+
+    ( void ) memset( &leapSmear, 0, sizeof( leapSmear ) );
+
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_SetVirtualClockLeapSmear( NULL, SntpLeapSmearLinear, 1U ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_SetVirtualClockLeapSmear( &testClock,
+                                                                             ( SntpLeapSmearType_t ) 3, 1U ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_SetVirtualClockLeapSmear( &testClock, SntpLeapSmearCosine, 0U ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SetVirtualClockLeapSmear( &testClock, SntpLeapSmearNone, 0U ) );
+
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_ScheduleVirtualClockLeapSecond( NULL, &time,
+                                                                                   LastMinuteHas61Seconds ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_ScheduleVirtualClockLeapSecond( &testClock, NULL,
+                                                                                   LastMinuteHas61Seconds ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_ScheduleLeapSecond( NULL, &time, NoLeapSecond ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_ScheduleLeapSecond( &leapSmear, &time,
+                                                                       ( SntpLeapSecondInfo_t ) 4 ) );
+
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_ApplyLeapSmear( NULL, &time, &time ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_ApplyLeapSmear( &leapSmear, NULL, &time ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_ApplyLeapSmear( &leapSmear, &time, NULL ) );
+
+    leapSmear.type = ( SntpLeapSmearType_t ) 3;
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_ApplyLeapSmear( &leapSmear, &time, &time ) );
+    leapSmear.type = SntpLeapSmearLinear;
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_ApplyLeapSmear( &leapSmear, &time, &time ) );
+    leapSmear.windowSecs = 1U;
+    leapSmear.leapSeconds = 2;
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_ApplyLeapSmear( &leapSmear, &time, &time ) );
+    leapSmear.leapSeconds = -2;
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_ApplyLeapSmear( &leapSmear, &time, &time ) );
+}
+
+/**
+ * @brief Test that the leap second instant is the end of the UTC month of the
+ * server time.
+ */
+void test_LeapSmear_ScheduleLeapSecond( void )
+{
+    SntpLeapSmear_t leapSmear;
+    SntpTimestamp_t serverTime;
+    size_t i;
+
+    /* Pairs of server time and the start of the following month. */
+    static const uint32_t testTimes[][ 2 ] =
+    {
+        { 3690748800U, 3692217600U }, /* 15 Dec 2016 -> 1 Jan 2017 */
+        { 3692217599U, 3692217600U }, /* 31 Dec 2016 23:59:59 -> 1 Jan 2017 */
+        { 3644611200U, 3644697600U }, /* 30 Jun 2015 -> 1 Jul 2015 */
+        { 3644697600U, 3647376000U }, /* 1 Jul 2015 -> 1 Aug 2015 */
+        { 3916512000U, 3918240000U }, /* 10 Feb 2024 -> 1 Mar 2024 (leap year) */
+        { 3884976000U, 3886617600U }, /* 10 Feb 2023 -> 1 Mar 2023 */
+        { 3160771200U, 3160857600U }, /* 29 Feb 2000 -> 1 Mar 2000 */
+        { 0U, 1963904U },             /* 7 Feb 2036 (SNTP era 1) -> 1 Mar 2036 */
+        { 3173504U, 4642304U }        /* 15 Mar 2036 (SNTP era 1) -> 1 Apr 2036 */
+    };
+
+    ( void ) memset( &leapSmear, 0, sizeof( leapSmear ) );
+    serverTime.fractions = 0x12345678U;
+
+    for( i = 0; i < sizeof( testTimes ) / sizeof( testTimes[ 0 ] ); i++ )
+    {
+        serverTime.seconds = testTimes[ i ][ 0 ];
+        TEST_ASSERT_EQUAL( SntpSuccess, Sntp_ScheduleLeapSecond( &leapSmear, &serverTime,
+                                                                 LastMinuteHas61Seconds ) );
+        TEST_ASSERT_EQUAL_UINT32( testTimes[ i ][ 1 ], leapSmear.leapTime.seconds );
+        TEST_ASSERT_EQUAL_UINT32( 0U, leapSmear.leapTime.fractions );
+        TEST_ASSERT_EQUAL( 1, leapSmear.leapSeconds );
+    }
+
+    /* A deleted leap second steps time at the start of the last second. */
+    serverTime.seconds = 3690748800U;
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_ScheduleLeapSecond( &leapSmear, &serverTime, LastMinuteHas59Seconds ) );
+    TEST_ASSERT_EQUAL_UINT32( TEST_LEAP_TIME_SECS - 1U, leapSmear.leapTime.seconds );
+    TEST_ASSERT_EQUAL( -1, leapSmear.leapSeconds );
+
+    /* Alarm conditions do not change the leap second. */
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_ScheduleLeapSecond( &leapSmear, &serverTime,
+                                                             AlarmServerNotSynchronized ) );
+    TEST_ASSERT_EQUAL( -1, leapSmear.leapSeconds );
+
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_ScheduleLeapSecond( &leapSmear, &serverTime, NoLeapSecond ) );
+    TEST_ASSERT_EQUAL( 0, leapSmear.leapSeconds );
+}
+
+/**
+ * @brief Test the leap second profiles of the leap smear methods.
+ */
+void test_LeapSmear_ApplyLeapSmear( void )
+{
+    SntpLeapSmear_t leapSmear;
+    SntpTimestamp_t leapTime = { TEST_LEAP_TIME_SECS, 0 };
+    uint64_t leap = toFixed( &leapTime );
+    uint64_t halfWindow = ( uint64_t ) ( TEST_SMEAR_WINDOW_SECS / 2U ) * FRACTIONS_PER_SECOND;
+    SntpTimestamp_t time, smearedTime;
+
+    leapSmear.type = SntpLeapSmearNone;
+    leapSmear.windowSecs = 0U;
+    leapSmear.leapTime = leapTime;
+    leapSmear.leapSeconds = 1;
+
+    /* A step is applied at the leap second instant. */
+    time = toTimestamp( leap - 1U );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_ApplyLeapSmear( &leapSmear, &time, &smearedTime ) );
+    TEST_ASSERT_EQUAL_UINT64( leap - 1U, toFixed( &smearedTime ) );
+    time = toTimestamp( leap );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_ApplyLeapSmear( &leapSmear, &time, &smearedTime ) );
+    TEST_ASSERT_EQUAL_UINT64( leap - FRACTIONS_PER_SECOND, toFixed( &smearedTime ) );
+
+    /* Linear smear is applied in proportion to the position in the window. */
+    leapSmear.type = SntpLeapSmearLinear;
+    leapSmear.windowSecs = TEST_SMEAR_WINDOW_SECS;
+
+    time = toTimestamp( leap - halfWindow );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_ApplyLeapSmear( &leapSmear, &time, &smearedTime ) );
+    TEST_ASSERT_EQUAL_UINT64( leap - halfWindow, toFixed( &smearedTime ) );
+
+    time = toTimestamp( leap );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_ApplyLeapSmear( &leapSmear, &time, &smearedTime ) );
+    TEST_ASSERT_EQUAL_UINT64( leap - ( FRACTIONS_PER_SECOND / 2 ), toFixed( &smearedTime ) );
+
+    time = toTimestamp( leap + ( halfWindow / 2U ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_ApplyLeapSmear( &leapSmear, &time, &smearedTime ) );
+    TEST_ASSERT_EQUAL_UINT64( leap + ( halfWindow / 2U ) - ( ( 3 * FRACTIONS_PER_SECOND ) / 4 ),
+                              toFixed( &smearedTime ) );
+
+    time = toTimestamp( leap + halfWindow );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_ApplyLeapSmear( &leapSmear, &time, &smearedTime ) );
+    TEST_ASSERT_EQUAL_UINT64( leap + halfWindow - FRACTIONS_PER_SECOND, toFixed( &smearedTime ) );
+
+    /* Cosine smear is half applied at the leap second instant, with a slower
+     * start than linear smear. */
+    leapSmear.type = SntpLeapSmearCosine;
+
+    time = toTimestamp( leap );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_ApplyLeapSmear( &leapSmear, &time, &smearedTime ) );
+    TEST_ASSERT_EQUAL_UINT64( leap - ( FRACTIONS_PER_SECOND / 2 ), toFixed( &smearedTime ) );
+
+    /* ( 1 - cos( pi / 4 ) ) / 2 = 0.1464... */
+    time = toTimestamp( leap - ( halfWindow / 2U ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_ApplyLeapSmear( &leapSmear, &time, &smearedTime ) );
+    TEST_ASSERT_UINT64_WITHIN( FRACTIONS_PER_SECOND / 10000,
+                               leap - ( halfWindow / 2U ) - ( uint64_t ) ( 0.1464466 * FRACTIONS_PER_SECOND ),
+                               toFixed( &smearedTime ) );
+
+    /* A deleted leap second moves time forward. */
+    leapSmear.leapSeconds = -1;
+    time = toTimestamp( leap );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_ApplyLeapSmear( &leapSmear, &time, &smearedTime ) );
+    TEST_ASSERT_EQUAL_UINT64( leap + ( FRACTIONS_PER_SECOND / 2 ), toFixed( &smearedTime ) );
+
+    /* Time is unchanged without a leap second. */
+    leapSmear.leapSeconds = 0;
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_ApplyLeapSmear( &leapSmear, &time, &smearedTime ) );
+    TEST_ASSERT_EQUAL_UINT64( leap, toFixed( &smearedTime ) );
+}
+
+/**
+ * @brief Test that smeared time is monotonic and never runs faster or slower
+ * than the smear allows.
+ */
+void test_LeapSmear_Monotonic( void )
+{
+    SntpLeapSmear_t leapSmear;
+    SntpTimestamp_t leapTime = { TEST_LEAP_TIME_SECS, 0 };
+    uint64_t leap = toFixed( &leapTime );
+    uint64_t step = FRACTIONS_PER_SECOND / 4;
+    uint64_t time, previous, current;
+    SntpTimestamp_t timestamp, smearedTime;
+    int type;
+
+    leapSmear.windowSecs = TEST_SMEAR_WINDOW_SECS;
+    leapSmear.leapTime = leapTime;
+    leapSmear.leapSeconds = 1;
+
+    for( type = SntpLeapSmearLinear; type <= SntpLeapSmearCosine; type++ )
+    {
+        leapSmear.type = ( SntpLeapSmearType_t ) type;
+        previous = leap - ( TEST_SMEAR_WINDOW_SECS * FRACTIONS_PER_SECOND ) - step;
+
+        for( time = leap - ( TEST_SMEAR_WINDOW_SECS * FRACTIONS_PER_SECOND );
+             time < leap + ( TEST_SMEAR_WINDOW_SECS * FRACTIONS_PER_SECOND );
+             time += step )
+        {
+            timestamp = toTimestamp( time );
+            TEST_ASSERT_EQUAL( SntpSuccess, Sntp_ApplyLeapSmear( &leapSmear, &timestamp, &smearedTime ) );
+            current = toFixed( &smearedTime );
+
+            /* The rate of time never exceeds twice the linear smear rate. */
+            TEST_ASSERT_LESS_OR_EQUAL_UINT64( step, current - previous );
+            TEST_ASSERT_GREATER_OR_EQUAL_UINT64( step - ( ( 2 * step ) / TEST_SMEAR_WINDOW_SECS ) - 1U,
+                                                 current - previous );
+            previous = current;
+        }
+    }
+}
+
+/**
+ * @brief Test that the virtual clock smears a leap second into the corrected
+ * time, and tracks the step of server time after the leap second.
+ */
+void test_VirtualClock_LeapSmear( void )
+{
+    SntpTimestamp_t serverTime = { TEST_LEAP_TIME_SECS - 86400U, 0 };
+    SntpTimestamp_t localTime, correctedTime;
+    uint64_t leap = ( uint64_t ) TEST_LEAP_TIME_SECS << 32;
+    uint64_t halfWindow = ( uint64_t ) ( TEST_SMEAR_WINDOW_SECS / 2U ) * FRACTIONS_PER_SECOND;
+
+    /* The local clock is 10 seconds behind server time. */
+    localTime = toTimestamp( leap - ( 2 * halfWindow ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_UpdateVirtualClock( &testClock, &localTime, 10 * FRACTIONS_PER_SECOND ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SetVirtualClockLeapSmear( &testClock, SntpLeapSmearLinear,
+                                                                   TEST_SMEAR_WINDOW_SECS ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_ScheduleVirtualClockLeapSecond( &testClock, &serverTime,
+                                                                         LastMinuteHas61Seconds ) );
+
+    /* Smear is half applied at the leap second instant. */
+    localTime = toTimestamp( leap - ( 10 * FRACTIONS_PER_SECOND ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_GetCorrectedTime( &testClock, &localTime, &correctedTime ) );
+    TEST_ASSERT_EQUAL_UINT64( leap - ( FRACTIONS_PER_SECOND / 2 ), toFixed( &correctedTime ) );
+
+    /* Server time has stepped back after the leap second, and the clock offset
+     * includes the step. */
+    localTime = toTimestamp( leap - ( 10 * FRACTIONS_PER_SECOND ) + ( halfWindow / 2U ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_UpdateVirtualClock( &testClock, &localTime, 9 * FRACTIONS_PER_SECOND ) );
+    TEST_ASSERT_TRUE( testClock.model.isLeapApplied );
+    TEST_ASSERT_EQUAL( 0, testClock.model.frequency );
+
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_GetCorrectedTime( &testClock, &localTime, &correctedTime ) );
+    TEST_ASSERT_EQUAL_UINT64( leap + ( halfWindow / 2U ) - ( ( 3 * FRACTIONS_PER_SECOND ) / 4 ),
+                              toFixed( &correctedTime ) );
+
+    /* Leap second announcements are ignored while the leap second is applied. */
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_ScheduleVirtualClockLeapSecond( &testClock, &serverTime, NoLeapSecond ) );
+    TEST_ASSERT_EQUAL( 1, testClock.model.leapSmear.leapSeconds );
+
+    /* The leap second is cleared after the smear window. */
+    localTime = toTimestamp( leap - ( 10 * FRACTIONS_PER_SECOND ) + ( 2 * halfWindow ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_UpdateVirtualClock( &testClock, &localTime, 9 * FRACTIONS_PER_SECOND ) );
+    TEST_ASSERT_EQUAL( 0, testClock.model.leapSmear.leapSeconds );
+    TEST_ASSERT_FALSE( testClock.model.isLeapApplied );
+    TEST_ASSERT_EQUAL( 0, testClock.model.frequency );
+
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_GetCorrectedTime( &testClock, &localTime, &correctedTime ) );
+    TEST_ASSERT_EQUAL_UINT64( leap + ( 2 * halfWindow ) - ( 10 * FRACTIONS_PER_SECOND ) +
+                              ( 9 * FRACTIONS_PER_SECOND ), toFixed( &correctedTime ) );
+}
+
+/**
+ * @brief Test that a leap second step is applied to the corrected time at the
+ * leap second instant without smearing.
+ */
+void test_VirtualClock_LeapStep( void )
+{
+    SntpTimestamp_t serverTime = { TEST_LEAP_TIME_SECS - 86400U, 0 };
+    SntpTimestamp_t localTime, correctedTime;
+    uint64_t leap = ( uint64_t ) TEST_LEAP_TIME_SECS << 32;
+
+    localTime = toTimestamp( leap - ( 100 * FRACTIONS_PER_SECOND ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_UpdateVirtualClock( &testClock, &localTime, 0 ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_ScheduleVirtualClockLeapSecond( &testClock, &serverTime,
+                                                                         LastMinuteHas59Seconds ) );
+
+    /* The deleted leap second steps time forward a second before the end of
+     * the month. */
+    localTime = toTimestamp( leap - FRACTIONS_PER_SECOND - 1U );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_GetCorrectedTime( &testClock, &localTime, &correctedTime ) );
+    TEST_ASSERT_EQUAL_UINT64( leap - FRACTIONS_PER_SECOND - 1U, toFixed( &correctedTime ) );
+
+    localTime = toTimestamp( leap - FRACTIONS_PER_SECOND );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_GetCorrectedTime( &testClock, &localTime, &correctedTime ) );
+    TEST_ASSERT_EQUAL_UINT64( leap, toFixed( &correctedTime ) );
+
+    /* A cancelled leap second is not applied. */
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_ScheduleVirtualClockLeapSecond( &testClock, &serverTime, NoLeapSecond ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_GetCorrectedTime( &testClock, &localTime, &correctedTime ) );
+    TEST_ASSERT_EQUAL_UINT64( leap - FRACTIONS_PER_SECOND, toFixed( &correctedTime ) );
+
+    /* The step is included in the clock offset of the first sample after the
+     * leap second, and the leap second is then cleared. */
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_ScheduleVirtualClockLeapSecond( &testClock, &serverTime,
+                                                                         LastMinuteHas59Seconds ) );
+    localTime = toTimestamp( leap + ( 10 * FRACTIONS_PER_SECOND ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_UpdateVirtualClock( &testClock, &localTime, FRACTIONS_PER_SECOND ) );
+    TEST_ASSERT_EQUAL( 0, testClock.model.frequency );
+    TEST_ASSERT_EQUAL( 0, testClock.model.leapSmear.leapSeconds );
+
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_GetCorrectedTime( &testClock, &localTime, &correctedTime ) );
+    TEST_ASSERT_EQUAL_UINT64( leap + ( 11 * FRACTIONS_PER_SECOND ), toFixed( &correctedTime ) );
+}
+
+/**
+ * @brief Test the holdover API functions with invalid parameters, and before
+ * the virtual clock is synchronized.
+ */
+void test_Holdover_InvalidParams( void )
+{
+    SntpTimestamp_t localTime = { TEST_LOCAL_TIME_SECS, 0 };
+    SntpClockState_t state;
+    uint64_t errorBound;
+
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_EnterVirtualClockHoldover( NULL ) );
+
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_GetVirtualClockErrorBound( NULL, &localTime,
+                                                                              &state, &errorBound ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_GetVirtualClockErrorBound( &testClock, NULL,
+                                                                              &state, &errorBound ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_GetVirtualClockErrorBound( &testClock, &localTime,
+                                                                              NULL, &errorBound ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_GetVirtualClockErrorBound( &testClock, &localTime,
+                                                                              &state, NULL ) );
+
+    TEST_ASSERT_EQUAL( SntpClockNotSynchronized, Sntp_EnterVirtualClockHoldover( &testClock ) );
+    TEST_ASSERT_EQUAL( SntpClockNotSynchronized, Sntp_GetVirtualClockErrorBound( &testClock, &localTime,
+                                                                                 &state, &errorBound ) );
+    TEST_ASSERT_EQUAL( SntpClockStateUnsynchronized, state );
+}
+
+/**
+ * @brief Test that the error bound of the virtual clock starts from the initial
+ * frequency uncertainty, and grows with the time since the last sample.
+ */
+void test_Holdover_ErrorBound( void )
+{
+    SntpTimestamp_t localTime = { TEST_LOCAL_TIME_SECS, 0 };
+    SntpClockState_t state;
+    uint64_t errorBound;
+
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_UpdateVirtualClock( &testClock, &localTime, FRACTIONS_PER_SECOND ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_GetVirtualClockErrorBound( &testClock, &localTime,
+                                                                    &state, &errorBound ) );
+    TEST_ASSERT_EQUAL( SntpClockStateSynchronized, state );
+    TEST_ASSERT_EQUAL_UINT64( 0U, errorBound );
+
+    /* After 1000 seconds, the bound is the initial uncertainty of 15 PPM. */
+    localTime.seconds += 1000U;
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_GetVirtualClockErrorBound( &testClock, &localTime,
+                                                                    &state, &errorBound ) );
+    TEST_ASSERT_INT64_WITHIN( 10 * FRACTIONS_PER_PPM,
+                              1000 * SNTP_CLOCK_INITIAL_FREQUENCY_UNCERTAINTY_PPM * FRACTIONS_PER_PPM,
+                              ( int64_t ) errorBound );
+
+    /* The bound also grows for local times before the last sample. */
+    localTime.seconds -= 2000U;
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_GetVirtualClockErrorBound( &testClock, &localTime,
+                                                                    &state, &errorBound ) );
+    TEST_ASSERT_INT64_WITHIN( 10 * FRACTIONS_PER_PPM,
+                              1000 * SNTP_CLOCK_INITIAL_FREQUENCY_UNCERTAINTY_PPM * FRACTIONS_PER_PPM,
+                              ( int64_t ) errorBound );
+
+    /* A sample that deviates from the prediction adds to the jitter. */
+    localTime.seconds += 1064U;
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_UpdateVirtualClock( &testClock, &localTime,
+                                                             FRACTIONS_PER_SECOND + ( 64 * FRACTIONS_PER_PPM ) ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_GetVirtualClockErrorBound( &testClock, &localTime,
+                                                                    &state, &errorBound ) );
+    TEST_ASSERT_GREATER_THAN_UINT64( 0U, testClock.model.jitter );
+    TEST_ASSERT_EQUAL_UINT64( testClock.model.jitter, errorBound );
+}
+
+/**
+ * @brief Test that the virtual clock keeps providing time in holdover, and
+ * leaves holdover with the next sample.
+ */
+void test_Holdover_EnterAndExit( void )
+{
+    SntpTimestamp_t localTime = { TEST_LOCAL_TIME_SECS, 0 };
+    SntpTimestamp_t correctedTime;
+    SntpClockState_t state;
+    uint64_t errorBound;
+
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_UpdateVirtualClock( &testClock, &localTime, FRACTIONS_PER_SECOND ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_EnterVirtualClockHoldover( &testClock ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_EnterVirtualClockHoldover( &testClock ) );
+
+    localTime.seconds += 3600U;
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_GetVirtualClockErrorBound( &testClock, &localTime,
+                                                                    &state, &errorBound ) );
+    TEST_ASSERT_EQUAL( SntpClockStateHoldover, state );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_GetCorrectedTime( &testClock, &localTime, &correctedTime ) );
+    TEST_ASSERT_EQUAL_UINT32( localTime.seconds + 1U, correctedTime.seconds );
+
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_UpdateVirtualClock( &testClock, &localTime, FRACTIONS_PER_SECOND ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_GetVirtualClockErrorBound( &testClock, &localTime,
+                                                                    &state, &errorBound ) );
+    TEST_ASSERT_EQUAL( SntpClockStateSynchronized, state );
+}
@@ -0,0 +1,52 @@
+/*
+ * coreSNTP v1.0.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file core_sntp_config.h
+ * @brief The configuration of the coreSNTP library for the unit tests.
+ */
+
+#ifndef CORE_SNTP_CONFIG_H_
+#define CORE_SNTP_CONFIG_H_
+
+/* Standard include. */
+#include <stdio.h>
+
+/**
+ * @brief Logging macro of the unit tests, which compiles the logging calls of
+ * the library, and checks their format strings, without printing the messages.
+ *
+ * @param[in] message The format string and its arguments, in parentheses.
+ */
+#define UNIT_TEST_LOG( message )    ( void ) ( ( 0 != 0 ) && ( printf message > 0 ) )
+
+/* Map the logging macros of all levels to the unit test logging macro. */
+#define LogError( message )         UNIT_TEST_LOG( message )
+#define LogWarn( message )          UNIT_TEST_LOG( message )
+#define LogInfo( message )          UNIT_TEST_LOG( message )
+#define LogDebug( message )         UNIT_TEST_LOG( message )
+
+/* Rate limit repeated messages, so that the unit tests cover the rate
+ * limiting. */
+#define SNTP_LOG_REPEAT_INTERVAL    ( 4U )
+
+#endif /* ifndef CORE_SNTP_CONFIG_H_ */
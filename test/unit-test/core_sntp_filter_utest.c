@@ -0,0 +1,250 @@
+/*
+ * coreSNTP v1.0.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Standard includes. */
+#include <string.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+/* Unity include. */
+#include "unity.h"
+
+/* coreSNTP Outlier Gate API include */
+#include "core_sntp_filter.h"
+
+/* Number of SNTP timestamp fractions in a millisecond. */
+#define FRACTIONS_PER_MS         ( ( int64_t ) 0x100000000 / 1000 )
+
+/* Number of SNTP timestamp fractions in a microsecond. */
+#define FRACTIONS_PER_US         ( ( int64_t ) SNTP_FRACTION_VALUE_PER_MICROSECOND )
+
+/* Clock offset of the samples in tests. */
+#define TEST_OFFSET              ( 2 * FRACTIONS_PER_MS )
+
+/* Round-trip delay of the samples in tests. */
+#define TEST_DELAY               ( 20 * FRACTIONS_PER_MS )
+
+/* Global variables common to test cases. */
+static SntpOutlierGate_t testGate;
+
+/* ============================ Helper Functions ============================ */
+
+/* Fills the history of the test gate with samples that alternate by 1 ms
+ * around the test offset and delay. */
+static void fillHistory( void )
+{
+    int i;
+    int64_t variation;
+
+    for( i = 0; i < ( int ) SNTP_OUTLIER_GATE_HISTORY_SIZE; i++ )
+    {
+        variation = ( ( i % 2 ) == 0 ) ? 0 : FRACTIONS_PER_MS;
+        TEST_ASSERT_EQUAL( SntpSuccess, Sntp_FilterSample( &testGate,
+                                                           TEST_OFFSET + variation,
+                                                           TEST_DELAY + variation ) );
+    }
+}
+
+/* ============================   UNITY FIXTURES ============================ */
+
+/* Called before each test method. */
+void setUp()
+{
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_InitOutlierGate( &testGate,
+                                                          SNTP_OUTLIER_GATE_DEFAULT_THRESHOLD,
+                                                          SNTP_OUTLIER_GATE_DEFAULT_MAX_REJECTIONS ) );
+}
+
+/* Called at the beginning of the whole suite. */
+void suiteSetUp()
+{
+}
+
+/* Called at the end of the whole suite. */
+int suiteTearDown( int numFailures )
+{
+    return numFailures;
+}
+
+/* ========================================================================== */
+
+/**
+ * @brief Test the outlier gate API functions with invalid parameters.
+ */
+void test_OutlierGate_InvalidParams( void )
+{
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_InitOutlierGate( NULL, 1U, 1U ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_InitOutlierGate( &testGate, 0U, 1U ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_ResetOutlierGate( NULL ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_FilterSample( NULL, 0, 0 ) );
+}
+
+/**
+ * @brief Test that the outlier gate accepts every sample until its history has
+ * #SNTP_OUTLIER_GATE_MIN_SAMPLES samples.
+ */
+void test_OutlierGate_MinSamples( void )
+{
+    int64_t offset = 0;
+    size_t i;
+
+    for( i = 0U; i < SNTP_OUTLIER_GATE_MIN_SAMPLES; i++ )
+    {
+        TEST_ASSERT_EQUAL( SntpSuccess, Sntp_FilterSample( &testGate, offset, TEST_DELAY ) );
+        offset += 1000 * FRACTIONS_PER_MS;
+    }
+
+    /* Resetting the gate restarts the count. */
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_ResetOutlierGate( &testGate ) );
+    fillHistory();
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_ResetOutlierGate( &testGate ) );
+
+    for( i = 0U; i < SNTP_OUTLIER_GATE_MIN_SAMPLES; i++ )
+    {
+        TEST_ASSERT_EQUAL( SntpSuccess, Sntp_FilterSample( &testGate, offset, TEST_DELAY ) );
+        offset = -offset;
+    }
+}
+
+/**
+ * @brief Test that the outlier gate rejects a sample whose clock offset deviates
+ * beyond the threshold multiple of the offset jitter.
+ */
+void test_OutlierGate_OffsetSpike( void )
+{
+    /* The offset jitter is 1 ms, and the last offset is 1 ms above the test
+     * offset, so offsets within 3 ms of it are accepted. */
+    fillHistory();
+
+    TEST_ASSERT_EQUAL( SntpRejectedResponseOutlier,
+                       Sntp_FilterSample( &testGate, TEST_OFFSET + ( 5 * FRACTIONS_PER_MS ), TEST_DELAY ) );
+    TEST_ASSERT_EQUAL( SntpRejectedResponseOutlier,
+                       Sntp_FilterSample( &testGate, TEST_OFFSET - ( 3 * FRACTIONS_PER_MS ), TEST_DELAY ) );
+    TEST_ASSERT_EQUAL( SntpSuccess,
+                       Sntp_FilterSample( &testGate, TEST_OFFSET + ( 3 * FRACTIONS_PER_MS ), TEST_DELAY ) );
+    TEST_ASSERT_EQUAL( 0U, testGate.consecutiveRejections );
+}
+
+/**
+ * @brief Test that the outlier gate rejects a sample whose round-trip delay
+ * exceeds the lowest delay beyond the threshold multiple of the delay jitter.
+ */
+void test_OutlierGate_DelaySpike( void )
+{
+    /* The delay jitter is 0.5 ms, so delays up to 1.5 ms above the lowest delay
+     * are accepted. */
+    fillHistory();
+
+    TEST_ASSERT_EQUAL( SntpRejectedResponseOutlier,
+                       Sntp_FilterSample( &testGate, TEST_OFFSET, TEST_DELAY + ( 2 * FRACTIONS_PER_MS ) ) );
+    TEST_ASSERT_EQUAL( SntpSuccess,
+                       Sntp_FilterSample( &testGate, TEST_OFFSET, TEST_DELAY + FRACTIONS_PER_MS ) );
+
+    /* A delay lower than the history is always accepted. */
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_FilterSample( &testGate, TEST_OFFSET, 0 ) );
+}
+
+/**
+ * @brief Test that the outlier gate accepts a persistent deviation after
+ * rejecting the configured number of consecutive samples, and restarts its
+ * history from it.
+ */
+void test_OutlierGate_PersistentDeviation( void )
+{
+    const int64_t steppedOffset = TEST_OFFSET + ( 100 * FRACTIONS_PER_MS );
+    uint32_t i;
+
+    fillHistory();
+
+    for( i = 0U; i < SNTP_OUTLIER_GATE_DEFAULT_MAX_REJECTIONS; i++ )
+    {
+        TEST_ASSERT_EQUAL( SntpRejectedResponseOutlier,
+                           Sntp_FilterSample( &testGate, steppedOffset, TEST_DELAY ) );
+    }
+
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_FilterSample( &testGate, steppedOffset, TEST_DELAY ) );
+    TEST_ASSERT_EQUAL( 1U, testGate.numOfSamples );
+
+    /* The samples at the previous offset are now accepted while the history
+     * restarts. */
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_FilterSample( &testGate, TEST_OFFSET, TEST_DELAY ) );
+
+    /* A gate without escape accepts every sample. */
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_InitOutlierGate( &testGate, 1U, 0U ) );
+    fillHistory();
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_FilterSample( &testGate, steppedOffset, TEST_DELAY ) );
+    TEST_ASSERT_EQUAL( 1U, testGate.numOfSamples );
+}
+
+/**
+ * @brief Test that the outlier gate raises low jitter to
+ * #SNTP_OUTLIER_GATE_MIN_JITTER_US, and follows the trend of drifting offsets.
+ */
+void test_OutlierGate_MinJitterAndTrend( void )
+{
+    const int64_t minThreshold = SNTP_OUTLIER_GATE_DEFAULT_THRESHOLD *
+                                 SNTP_OUTLIER_GATE_MIN_JITTER_US * FRACTIONS_PER_US;
+    int64_t offset = TEST_OFFSET;
+    size_t i;
+
+    for( i = 0U; i < SNTP_OUTLIER_GATE_HISTORY_SIZE; i++ )
+    {
+        TEST_ASSERT_EQUAL( SntpSuccess, Sntp_FilterSample( &testGate, TEST_OFFSET, TEST_DELAY ) );
+    }
+
+    TEST_ASSERT_EQUAL( SntpRejectedResponseOutlier,
+                       Sntp_FilterSample( &testGate, TEST_OFFSET + minThreshold + FRACTIONS_PER_US, TEST_DELAY ) );
+    TEST_ASSERT_EQUAL( SntpRejectedResponseOutlier,
+                       Sntp_FilterSample( &testGate, TEST_OFFSET, TEST_DELAY + minThreshold + FRACTIONS_PER_US ) );
+    TEST_ASSERT_EQUAL( SntpSuccess,
+                       Sntp_FilterSample( &testGate, TEST_OFFSET + minThreshold, TEST_DELAY + minThreshold ) );
+
+    /* Offsets that drift steadily by 10 ms per sample are accepted, as the
+     * offset is compared with the last accepted offset. */
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_ResetOutlierGate( &testGate ) );
+
+    for( i = 0U; i < ( 2U * SNTP_OUTLIER_GATE_HISTORY_SIZE ); i++ )
+    {
+        TEST_ASSERT_EQUAL( SntpSuccess, Sntp_FilterSample( &testGate, offset, TEST_DELAY ) );
+        offset += 10 * FRACTIONS_PER_MS;
+    }
+}
+
+/**
+ * @brief Test that the outlier gate handles clock offsets at the limits of the
+ * 64-bit range without overflow.
+ */
+void test_OutlierGate_LargeValues( void )
+{
+    size_t i;
+
+    for( i = 0U; i < SNTP_OUTLIER_GATE_HISTORY_SIZE; i++ )
+    {
+        TEST_ASSERT_EQUAL( SntpSuccess,
+                           Sntp_FilterSample( &testGate, ( ( i % 2U ) == 0U ) ? INT64_MAX : INT64_MIN, TEST_DELAY ) );
+    }
+
+    /* The jitter saturates the threshold, so any offset is accepted. */
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_FilterSample( &testGate, INT64_MAX, TEST_DELAY ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_FilterSample( &testGate, 0, TEST_DELAY ) );
+}
@@ -0,0 +1,182 @@
+/*
+ * coreSNTP v1.0.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Standard includes. */
+#include <string.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+/* Unity include. */
+#include "unity.h"
+
+/* coreSNTP Fixed-Point Time API include */
+#include "core_sntp_fixed_point.h"
+
+/* Number of SNTP timestamp fractions in a second. */
+#define FRACTIONS_PER_SECOND    ( ( int64_t ) 0x100000000 )
+
+/* Number of nanoseconds in a second. */
+#define NS_PER_SECOND           ( ( int64_t ) 1000000000 )
+
+/* The last SNTP time of era 0, 7 Feb 2036 6:28:15.999... UTC. */
+#define END_OF_ERA_0            ( ( SntpFixedTime_t ) UINT64_MAX )
+
+/* ============================   UNITY FIXTURES ============================ */
+
+/* Called before each test method. */
+void setUp()
+{
+}
+
+/* Called at the beginning of the whole suite. */
+void suiteSetUp()
+{
+}
+
+/* Called at the end of the whole suite. */
+int suiteTearDown( int numFailures )
+{
+    return numFailures;
+}
+
+/* ========================================================================== */
+
+/**
+ * @brief Test the conversions between SNTP timestamps and fixed-point times.
+ */
+void test_FixedPoint_TimestampConversion( void )
+{
+    SntpTimestamp_t timestamp = { 0x01020304U, 0x05060708U };
+
+    TEST_ASSERT_EQUAL_HEX64( 0x0102030405060708U, Sntp_FixedFromTimestamp( timestamp ) );
+
+    timestamp = Sntp_FixedToTimestamp( 0xFFFFFFFE00000001U );
+    TEST_ASSERT_EQUAL_HEX32( 0xFFFFFFFEU, timestamp.seconds );
+    TEST_ASSERT_EQUAL_HEX32( 0x00000001U, timestamp.fractions );
+}
+
+/**
+ * @brief Test the difference and comparison of times, within and across SNTP
+ * eras.
+ */
+void test_FixedPoint_DifferenceAndCompare( void )
+{
+    SntpFixedTime_t time = ( SntpFixedTime_t ) 3900000000U * FRACTIONS_PER_SECOND;
+
+    TEST_ASSERT_EQUAL_INT64( 5 * FRACTIONS_PER_SECOND,
+                             Sntp_FixedDifference( time + ( 5 * FRACTIONS_PER_SECOND ), time ) );
+    TEST_ASSERT_EQUAL_INT64( -1, Sntp_FixedDifference( time - 1U, time ) );
+    TEST_ASSERT_EQUAL( 1, Sntp_FixedCompare( time + 1U, time ) );
+    TEST_ASSERT_EQUAL( -1, Sntp_FixedCompare( time, time + 1U ) );
+    TEST_ASSERT_EQUAL( 0, Sntp_FixedCompare( time, time ) );
+
+    /* The first time of era 1 follows the last time of era 0. */
+    TEST_ASSERT_EQUAL_INT64( 2, Sntp_FixedDifference( 1U, END_OF_ERA_0 ) );
+    TEST_ASSERT_EQUAL_INT64( -2, Sntp_FixedDifference( END_OF_ERA_0, 1U ) );
+    TEST_ASSERT_EQUAL( 1, Sntp_FixedCompare( 0U, END_OF_ERA_0 ) );
+    TEST_ASSERT_EQUAL( -1, Sntp_FixedCompare( END_OF_ERA_0, 0U ) );
+
+    /* Times up to 68 years apart are ordered correctly. */
+    TEST_ASSERT_EQUAL_INT64( INT64_MAX, Sntp_FixedDifference( time + INT64_MAX, time ) );
+    TEST_ASSERT_EQUAL_INT64( INT64_MIN + 1, Sntp_FixedDifference( time - INT64_MAX, time ) );
+}
+
+/**
+ * @brief Test the magnitude of durations.
+ */
+void test_FixedPoint_Magnitude( void )
+{
+    TEST_ASSERT_EQUAL_UINT64( SNTP_FIXED_SECOND, Sntp_FixedMagnitude( SNTP_FIXED_SECOND ) );
+    TEST_ASSERT_EQUAL_UINT64( SNTP_FIXED_SECOND, Sntp_FixedMagnitude( -SNTP_FIXED_SECOND ) );
+    TEST_ASSERT_EQUAL_UINT64( 0U, Sntp_FixedMagnitude( 0 ) );
+    TEST_ASSERT_EQUAL_UINT64( INT64_MAX, Sntp_FixedMagnitude( INT64_MAX ) );
+    TEST_ASSERT_EQUAL_UINT64( ( uint64_t ) 1 << 63, Sntp_FixedMagnitude( INT64_MIN ) );
+}
+
+/**
+ * @brief Test the scaling of durations by 32-bit factors.
+ */
+void test_FixedPoint_Scale( void )
+{
+    /* A fraction of a duration. */
+    TEST_ASSERT_EQUAL_UINT64( 5 * FRACTIONS_PER_SECOND, Sntp_FixedScale( 10 * FRACTIONS_PER_SECOND, 0x80000000U ) );
+    TEST_ASSERT_EQUAL_UINT64( 0U, Sntp_FixedScale( 10 * FRACTIONS_PER_SECOND, 0U ) );
+
+    /* A conversion into sub-second units, truncated. */
+    TEST_ASSERT_EQUAL_UINT64( 1500U, Sntp_FixedScale( FRACTIONS_PER_SECOND + ( FRACTIONS_PER_SECOND / 2 ), 1000U ) );
+    TEST_ASSERT_EQUAL_UINT64( 0U, Sntp_FixedScale( 1U, 1000U ) );
+
+    /* The largest values do not overflow. */
+    TEST_ASSERT_EQUAL_HEX64( 0xFFFFFFFEFFFFFFFFU, Sntp_FixedScale( UINT64_MAX, UINT32_MAX ) );
+}
+
+/**
+ * @brief Test the midpoint of times, within and across SNTP eras.
+ */
+void test_FixedPoint_Midpoint( void )
+{
+    SntpFixedTime_t time = ( SntpFixedTime_t ) 3900000000U * FRACTIONS_PER_SECOND;
+
+    TEST_ASSERT_EQUAL_HEX64( time + FRACTIONS_PER_SECOND,
+                             Sntp_FixedMidpoint( time, time + ( 2 * FRACTIONS_PER_SECOND ) ) );
+    TEST_ASSERT_EQUAL_HEX64( time + FRACTIONS_PER_SECOND,
+                             Sntp_FixedMidpoint( time + ( 2 * FRACTIONS_PER_SECOND ), time ) );
+
+    /* Odd durations are truncated towards the first time. */
+    TEST_ASSERT_EQUAL_HEX64( time, Sntp_FixedMidpoint( time, time + 1U ) );
+    TEST_ASSERT_EQUAL_HEX64( time + 1U, Sntp_FixedMidpoint( time + 1U, time ) );
+
+    /* The midpoint of times in different eras. */
+    TEST_ASSERT_EQUAL_HEX64( 0U, Sntp_FixedMidpoint( END_OF_ERA_0, 1U ) );
+    TEST_ASSERT_EQUAL_HEX64( 0U, Sntp_FixedMidpoint( 1U, END_OF_ERA_0 ) );
+
+    /* The most distant times. */
+    TEST_ASSERT_EQUAL_HEX64( time - ( ( uint64_t ) 1 << 62 ),
+                             Sntp_FixedMidpoint( time, time - ( ( uint64_t ) 1 << 63 ) ) );
+}
+
+/**
+ * @brief Test the conversions between durations and nanoseconds.
+ */
+void test_FixedPoint_Nanoseconds( void )
+{
+    /* Whole and half seconds convert exactly. */
+    TEST_ASSERT_EQUAL_INT64( 3 * NS_PER_SECOND, Sntp_FixedToNanoseconds( 3 * FRACTIONS_PER_SECOND ) );
+    TEST_ASSERT_EQUAL_INT64( -NS_PER_SECOND / 2, Sntp_FixedToNanoseconds( -FRACTIONS_PER_SECOND / 2 ) );
+    TEST_ASSERT_EQUAL_INT64( 3 * FRACTIONS_PER_SECOND, Sntp_FixedFromNanoseconds( 3 * NS_PER_SECOND ) );
+    TEST_ASSERT_EQUAL_INT64( -FRACTIONS_PER_SECOND / 2, Sntp_FixedFromNanoseconds( -NS_PER_SECOND / 2 ) );
+
+    /* Values are truncated towards zero, in both directions. */
+    TEST_ASSERT_EQUAL_INT64( 0, Sntp_FixedToNanoseconds( 4 ) );
+    TEST_ASSERT_EQUAL_INT64( 0, Sntp_FixedToNanoseconds( -4 ) );
+    TEST_ASSERT_EQUAL_INT64( 1, Sntp_FixedToNanoseconds( 5 ) );
+    TEST_ASSERT_EQUAL_INT64( -1, Sntp_FixedToNanoseconds( -5 ) );
+    TEST_ASSERT_EQUAL_INT64( 4, Sntp_FixedFromNanoseconds( 1 ) );
+    TEST_ASSERT_EQUAL_INT64( -4, Sntp_FixedFromNanoseconds( -1 ) );
+    TEST_ASSERT_EQUAL_INT64( 4294967, Sntp_FixedFromNanoseconds( 1000000 ) );
+
+    /* The extreme durations. */
+    TEST_ASSERT_EQUAL_INT64( -( ( int64_t ) 1 << 31 ) * NS_PER_SECOND, Sntp_FixedToNanoseconds( INT64_MIN ) );
+    TEST_ASSERT_EQUAL_INT64( ( ( ( int64_t ) 1 << 31 ) * NS_PER_SECOND ) - 1, Sntp_FixedToNanoseconds( INT64_MAX ) );
+    TEST_ASSERT_EQUAL_INT64( INT64_MAX - 4U, Sntp_FixedFromNanoseconds( Sntp_FixedToNanoseconds( INT64_MAX ) ) );
+}
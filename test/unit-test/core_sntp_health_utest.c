@@ -0,0 +1,457 @@
+/*
+ * coreSNTP v1.0.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Standard includes. */
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Unity include. */
+#include "unity.h"
+
+/* coreSNTP Server Health API include */
+#include "core_sntp_health.h"
+
+/* Number of SNTP timestamp fractions in a second. */
+#define FRACTIONS_PER_SECOND    ( ( int64_t ) 0x100000000 )
+
+/* Converts a duration in microseconds to SNTP timestamp fractions, rounded up
+ * so that it converts back exactly. */
+#define US_TO_FRACTIONS( us )    ( ( ( ( int64_t ) ( us ) * FRACTIONS_PER_SECOND ) + 999999 ) / 1000000 )
+
+/* Number of servers of the tests. */
+#define TEST_NUM_SERVERS         ( 3U )
+
+/* Global variables common to test cases. */
+static SntpServerHealth_t testHealth[ TEST_NUM_SERVERS ];
+static uint8_t testBuffer[ SNTP_HEALTH_SAVED_SIZE( TEST_NUM_SERVERS ) ];
+
+/* ============================ Helper Functions ============================ */
+
+/* Records an outcome in the health of a server of the tests. */
+static void recordOutcome( size_t serverIndex,
+                           SntpStatus_t status,
+                           uint32_t delayUs )
+{
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_RecordServerHealth( &testHealth[ serverIndex ], status,
+                                                             US_TO_FRACTIONS( delayUs ) ) );
+}
+
+/* Reads the health score of a server of the tests. */
+static uint32_t getScore( size_t serverIndex )
+{
+    uint32_t score = 0U;
+
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_GetServerHealthScore( &testHealth[ serverIndex ], &score ) );
+
+    return score;
+}
+
+/* Selects the healthiest server of the tests other than a server. */
+static size_t selectServer( size_t excludedIndex )
+{
+    size_t serverIndex = TEST_NUM_SERVERS;
+
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SelectHealthiestServer( testHealth, TEST_NUM_SERVERS,
+                                                                 excludedIndex, &serverIndex ) );
+
+    return serverIndex;
+}
+
+/* Initializes the health of the servers of the tests, with their identifiers. */
+static void initHealth( void )
+{
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_InitServerHealth( testHealth, TEST_NUM_SERVERS ) );
+    testHealth[ 0 ].serverId = 0x1000U;
+    testHealth[ 1 ].serverId = 0x2000U;
+    testHealth[ 2 ].serverId = 0x3000U;
+}
+
+/* ============================   UNITY FIXTURES ============================ */
+
+/* Called before each test method. */
+void setUp()
+{
+    initHealth();
+    ( void ) memset( testBuffer, 0, sizeof( testBuffer ) );
+}
+
+/* Called at the beginning of the whole suite. */
+void suiteSetUp()
+{
+}
+
+/* Called at the end of the whole suite. */
+int suiteTearDown( int numFailures )
+{
+    return numFailures;
+}
+
+/* ========================================================================== */
+
+/**
+ * @brief Test the APIs with invalid parameters.
+ */
+void test_Health_InvalidParams( void )
+{
+    uint32_t score;
+    size_t index;
+    size_t savedSize;
+
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_InitServerHealth( NULL, 1U ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_InitServerHealth( testHealth, 0U ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_RecordServerHealth( NULL, SntpSuccess, 0 ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_GetServerHealthScore( NULL, &score ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_GetServerHealthScore( testHealth, NULL ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_SelectHealthiestServer( NULL, 1U, 1U, &index ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_SelectHealthiestServer( testHealth, 1U, 1U, NULL ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_SelectHealthiestServer( testHealth, 0U, 0U, &index ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_SelectHealthiestServer( testHealth, 1U, 2U, &index ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_SaveServerHealth( NULL, 1U, testBuffer,
+                                                                     sizeof( testBuffer ), &savedSize ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_SaveServerHealth( testHealth, 1U, NULL,
+                                                                     sizeof( testBuffer ), &savedSize ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_SaveServerHealth( testHealth, 1U, testBuffer,
+                                                                     sizeof( testBuffer ), NULL ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_SaveServerHealth( testHealth, 0U, testBuffer,
+                                                                     sizeof( testBuffer ), &savedSize ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_RestoreServerHealth( NULL, 1U, testBuffer,
+                                                                        sizeof( testBuffer ) ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_RestoreServerHealth( testHealth, 1U, NULL,
+                                                                        sizeof( testBuffer ) ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_RestoreServerHealth( testHealth, 0U, testBuffer,
+                                                                        sizeof( testBuffer ) ) );
+}
+
+/**
+ * @brief Test the health of a server without any recorded outcome.
+ */
+void test_Health_Unknown( void )
+{
+    TEST_ASSERT_EQUAL( 0x1000U, testHealth[ 0 ].serverId );
+    TEST_ASSERT_EQUAL( SNTP_HEALTH_UNKNOWN_SCORE, testHealth[ 0 ].successRate );
+    TEST_ASSERT_EQUAL( 0U, testHealth[ 0 ].kissOfDeathRate );
+    TEST_ASSERT_EQUAL( 0U, testHealth[ 0 ].roundTripDelayUs );
+    TEST_ASSERT_EQUAL( 0U, testHealth[ 0 ].jitterUs );
+    TEST_ASSERT_EQUAL( 0U, testHealth[ 0 ].numOfResponses );
+    TEST_ASSERT_EQUAL( SNTP_HEALTH_UNKNOWN_SCORE, getScore( 0U ) );
+
+    /* A server that always responds with no delay has the highest score. */
+    testHealth[ 0 ].successRate = SNTP_HEALTH_MAX_SCORE;
+    TEST_ASSERT_EQUAL( SNTP_HEALTH_MAX_SCORE, getScore( 0U ) );
+}
+
+/**
+ * @brief Test the decay of the rates with the outcomes of the requests.
+ */
+void test_Health_Rates( void )
+{
+    size_t index;
+
+    /* Every outcome has a weight of 1/8. */
+    recordOutcome( 0U, SntpSuccess, 0U );
+    TEST_ASSERT_EQUAL( 36864U, testHealth[ 0 ].successRate );
+    TEST_ASSERT_EQUAL( 0U, testHealth[ 0 ].kissOfDeathRate );
+
+    recordOutcome( 0U, SntpErrorResponseTimeout, 0U );
+    TEST_ASSERT_EQUAL( 32256U, testHealth[ 0 ].successRate );
+    TEST_ASSERT_EQUAL( 0U, testHealth[ 0 ].kissOfDeathRate );
+
+    recordOutcome( 0U, SntpRejectedResponseRetryWithBackoff, 0U );
+    TEST_ASSERT_EQUAL( 28224U, testHealth[ 0 ].successRate );
+    TEST_ASSERT_EQUAL( 8192U, testHealth[ 0 ].kissOfDeathRate );
+
+    recordOutcome( 0U, SntpSuccess, 0U );
+    TEST_ASSERT_EQUAL( 32888U, testHealth[ 0 ].successRate );
+    TEST_ASSERT_EQUAL( 7168U, testHealth[ 0 ].kissOfDeathRate );
+
+    /* The rates reach their limits. */
+    for( index = 0U; index < 200U; index++ )
+    {
+        recordOutcome( 0U, SntpSuccess, 0U );
+        recordOutcome( 1U, SntpErrorNetworkFailure, 0U );
+    }
+
+    TEST_ASSERT_EQUAL( SNTP_HEALTH_MAX_SCORE, testHealth[ 0 ].successRate );
+    TEST_ASSERT_EQUAL( 0U, testHealth[ 0 ].kissOfDeathRate );
+    TEST_ASSERT_EQUAL( SNTP_HEALTH_MAX_SCORE, getScore( 0U ) );
+    TEST_ASSERT_EQUAL( 0U, testHealth[ 1 ].successRate );
+    TEST_ASSERT_EQUAL( 0U, getScore( 1U ) );
+}
+
+/**
+ * @brief Test the outcomes counted for each status.
+ */
+void test_Health_Statuses( void )
+{
+    static const SntpStatus_t successes[] =
+    {
+        SntpSuccess, SntpClockOffsetOverflow, SntpRejectedResponseOutlier
+    };
+    static const SntpStatus_t kissOfDeaths[] =
+    {
+        SntpRejectedResponseChangeServer, SntpRejectedResponseRetryWithBackoff, SntpRejectedResponseOtherCode
+    };
+    static const SntpStatus_t failures[] =
+    {
+        SntpErrorResponseTimeout, SntpErrorNetworkFailure, SntpErrorDnsFailure,
+        SntpInvalidResponse,      SntpServerNotAuthenticated
+    };
+    static const SntpStatus_t ignored[] =
+    {
+        SntpErrorBadParameter,       SntpErrorBufferTooSmall, SntpZeroPollInterval,
+        SntpErrorTimeNotSupported,   SntpErrorAuthFailure,    SntpClockNotSynchronized,
+        SntpErrorSystemClockFailure, SntpNoResponseReceived,  SntpInsufficientSamples
+    };
+    SntpServerHealth_t initial;
+    size_t index;
+
+    initial = testHealth[ 0 ];
+
+    for( index = 0U; index < ( sizeof( successes ) / sizeof( successes[ 0 ] ) ); index++ )
+    {
+        initHealth();
+        recordOutcome( 0U, successes[ index ], 1000U );
+        TEST_ASSERT_EQUAL( 36864U, testHealth[ 0 ].successRate );
+        TEST_ASSERT_EQUAL( 0U, testHealth[ 0 ].kissOfDeathRate );
+        TEST_ASSERT_EQUAL( 1000U, testHealth[ 0 ].roundTripDelayUs );
+        TEST_ASSERT_EQUAL( 1U, testHealth[ 0 ].numOfResponses );
+    }
+
+    for( index = 0U; index < ( sizeof( kissOfDeaths ) / sizeof( kissOfDeaths[ 0 ] ) ); index++ )
+    {
+        initHealth();
+        recordOutcome( 0U, kissOfDeaths[ index ], 1000U );
+        TEST_ASSERT_EQUAL( 28672U, testHealth[ 0 ].successRate );
+        TEST_ASSERT_EQUAL( 8192U, testHealth[ 0 ].kissOfDeathRate );
+        TEST_ASSERT_EQUAL( 0U, testHealth[ 0 ].numOfResponses );
+    }
+
+    for( index = 0U; index < ( sizeof( failures ) / sizeof( failures[ 0 ] ) ); index++ )
+    {
+        initHealth();
+        recordOutcome( 0U, failures[ index ], 1000U );
+        TEST_ASSERT_EQUAL( 28672U, testHealth[ 0 ].successRate );
+        TEST_ASSERT_EQUAL( 0U, testHealth[ 0 ].kissOfDeathRate );
+        TEST_ASSERT_EQUAL( 0U, testHealth[ 0 ].numOfResponses );
+    }
+
+    for( index = 0U; index < ( sizeof( ignored ) / sizeof( ignored[ 0 ] ) ); index++ )
+    {
+        initHealth();
+        recordOutcome( 0U, ignored[ index ], 1000U );
+        TEST_ASSERT_EQUAL_MEMORY( &initial, &testHealth[ 0 ], sizeof( initial ) );
+    }
+}
+
+/**
+ * @brief Test the averages of the round-trip delay and its jitter, and their
+ * effect on the score.
+ */
+void test_Health_RoundTripDelay( void )
+{
+    /* The first delay is the average, without jitter. */
+    recordOutcome( 0U, SntpSuccess, 20000U );
+    TEST_ASSERT_EQUAL( 20000U, testHealth[ 0 ].roundTripDelayUs );
+    TEST_ASSERT_EQUAL( 0U, testHealth[ 0 ].jitterUs );
+
+    /* 36864 * 100000 / ( 100000 + 20000 ). */
+    TEST_ASSERT_EQUAL( 30720U, getScore( 0U ) );
+
+    /* The jitter is updated with the deviation from the previous average. */
+    recordOutcome( 0U, SntpSuccess, 28000U );
+    TEST_ASSERT_EQUAL( 21000U, testHealth[ 0 ].roundTripDelayUs );
+    TEST_ASSERT_EQUAL( 1000U, testHealth[ 0 ].jitterUs );
+
+    recordOutcome( 0U, SntpSuccess, 13000U );
+    TEST_ASSERT_EQUAL( 20000U, testHealth[ 0 ].roundTripDelayUs );
+    TEST_ASSERT_EQUAL( 1875U, testHealth[ 0 ].jitterUs );
+    TEST_ASSERT_EQUAL( 3U, testHealth[ 0 ].numOfResponses );
+
+    /* A server with the same success rate and a lower delay and jitter has a
+     * higher score. */
+    testHealth[ 1 ] = testHealth[ 0 ];
+    testHealth[ 1 ].jitterUs = 0U;
+    TEST_ASSERT_GREATER_THAN( getScore( 0U ), getScore( 1U ) );
+    testHealth[ 1 ].roundTripDelayUs = 10000U;
+    testHealth[ 1 ].jitterUs = 1875U;
+    TEST_ASSERT_GREATER_THAN( getScore( 0U ), getScore( 1U ) );
+
+    /* Kiss-o'-Death responses lower the score more than other failures. */
+    testHealth[ 1 ] = testHealth[ 0 ];
+    recordOutcome( 0U, SntpErrorResponseTimeout, 0U );
+    recordOutcome( 1U, SntpRejectedResponseOtherCode, 0U );
+    TEST_ASSERT_GREATER_THAN( getScore( 1U ), getScore( 0U ) );
+}
+
+/**
+ * @brief Test the limits of the round-trip delay.
+ */
+void test_Health_RoundTripDelayLimits( void )
+{
+    /* A negative delay, from a backward step of the server clock, counts as
+     * no delay. */
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_RecordServerHealth( &testHealth[ 0 ], SntpSuccess,
+                                                             -FRACTIONS_PER_SECOND ) );
+    TEST_ASSERT_EQUAL( 0U, testHealth[ 0 ].roundTripDelayUs );
+
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_RecordServerHealth( &testHealth[ 1 ], SntpSuccess,
+                                                             5000 * FRACTIONS_PER_SECOND ) );
+    TEST_ASSERT_EQUAL( UINT32_MAX, testHealth[ 1 ].roundTripDelayUs );
+    TEST_ASSERT_EQUAL( 0U, getScore( 1U ) );
+
+    /* The number of responses saturates. */
+    testHealth[ 0 ].numOfResponses = UINT32_MAX;
+    recordOutcome( 0U, SntpSuccess, 8000U );
+    TEST_ASSERT_EQUAL( UINT32_MAX, testHealth[ 0 ].numOfResponses );
+    TEST_ASSERT_EQUAL( 1000U, testHealth[ 0 ].roundTripDelayUs );
+}
+
+/**
+ * @brief Test the selection of the healthiest server.
+ */
+void test_Health_Select( void )
+{
+    size_t serverIndex = 0U;
+
+    /* Servers of equal health are selected in order, after the excluded
+     * server. */
+    TEST_ASSERT_EQUAL( 0U, selectServer( TEST_NUM_SERVERS ) );
+    TEST_ASSERT_EQUAL( 1U, selectServer( 0U ) );
+    TEST_ASSERT_EQUAL( 2U, selectServer( 1U ) );
+    TEST_ASSERT_EQUAL( 0U, selectServer( 2U ) );
+
+    /* The healthiest server is selected, unless it is excluded. */
+    recordOutcome( 2U, SntpSuccess, 0U );
+    TEST_ASSERT_EQUAL( 2U, selectServer( TEST_NUM_SERVERS ) );
+    TEST_ASSERT_EQUAL( 2U, selectServer( 0U ) );
+    TEST_ASSERT_EQUAL( 0U, selectServer( 2U ) );
+
+    /* A failed server is selected after the servers of unknown health. */
+    recordOutcome( 0U, SntpErrorResponseTimeout, 0U );
+    TEST_ASSERT_EQUAL( 1U, selectServer( 2U ) );
+
+    /* A single server is selected even if it is excluded. */
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SelectHealthiestServer( testHealth, 1U, 0U, &serverIndex ) );
+    TEST_ASSERT_EQUAL( 0U, serverIndex );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SelectHealthiestServer( testHealth, 1U, 1U, &serverIndex ) );
+    TEST_ASSERT_EQUAL( 0U, serverIndex );
+}
+
+/**
+ * @brief Test saving and restoring the health of the servers.
+ */
+void test_Health_SaveRestore( void )
+{
+    SntpServerHealth_t saved[ TEST_NUM_SERVERS ];
+    size_t savedSize = 0U;
+
+    recordOutcome( 0U, SntpSuccess, 20000U );
+    recordOutcome( 1U, SntpRejectedResponseOtherCode, 0U );
+    recordOutcome( 2U, SntpSuccess, 10000U );
+    recordOutcome( 2U, SntpSuccess, 12000U );
+    ( void ) memcpy( saved, testHealth, sizeof( saved ) );
+
+    /* The buffer is checked for the size of the saved health. */
+    TEST_ASSERT_EQUAL( SntpErrorBufferTooSmall,
+                       Sntp_SaveServerHealth( testHealth, TEST_NUM_SERVERS, testBuffer,
+                                              SNTP_HEALTH_SAVED_SIZE( TEST_NUM_SERVERS ) - 1U, &savedSize ) );
+    TEST_ASSERT_EQUAL( SntpErrorBufferTooSmall,
+                       Sntp_SaveServerHealth( testHealth, TEST_NUM_SERVERS, testBuffer, 7U, &savedSize ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SaveServerHealth( testHealth, TEST_NUM_SERVERS, testBuffer,
+                                                           sizeof( testBuffer ), &savedSize ) );
+    TEST_ASSERT_EQUAL( SNTP_HEALTH_SAVED_SIZE( TEST_NUM_SERVERS ), savedSize );
+
+    /* The saved health is in network byte order. */
+    TEST_ASSERT_EQUAL_MEMORY( "SNH1", testBuffer, 4U );
+    TEST_ASSERT_EQUAL( TEST_NUM_SERVERS, testBuffer[ 7 ] );
+    TEST_ASSERT_EQUAL( 0x10U, testBuffer[ 10 ] );
+
+    /* The health is restored into initialized health records. */
+    initHealth();
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_RestoreServerHealth( testHealth, TEST_NUM_SERVERS, testBuffer, savedSize ) );
+    TEST_ASSERT_EQUAL_MEMORY( saved, testHealth, sizeof( saved ) );
+    TEST_ASSERT_EQUAL( 2U, selectServer( TEST_NUM_SERVERS ) );
+}
+
+/**
+ * @brief Test restoring health saved for a different list of servers.
+ */
+void test_Health_RestoreChangedServers( void )
+{
+    SntpServerHealth_t saved;
+    size_t savedSize = 0U;
+
+    recordOutcome( 1U, SntpSuccess, 20000U );
+    saved = testHealth[ 1 ];
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SaveServerHealth( testHealth, 2U, testBuffer,
+                                                           sizeof( testBuffer ), &savedSize ) );
+
+    /* The second server is now the first, and the other servers are new. */
+    initHealth();
+    testHealth[ 0 ].serverId = 0x2000U;
+    testHealth[ 1 ].serverId = 0x4000U;
+    testHealth[ 2 ].serverId = 0x5000U;
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_RestoreServerHealth( testHealth, TEST_NUM_SERVERS, testBuffer, savedSize ) );
+    TEST_ASSERT_EQUAL_MEMORY( &saved, &testHealth[ 0 ], sizeof( saved ) );
+    TEST_ASSERT_EQUAL( SNTP_HEALTH_UNKNOWN_SCORE, testHealth[ 1 ].successRate );
+    TEST_ASSERT_EQUAL( 0x4000U, testHealth[ 1 ].serverId );
+    TEST_ASSERT_EQUAL( SNTP_HEALTH_UNKNOWN_SCORE, testHealth[ 2 ].successRate );
+}
+
+/**
+ * @brief Test restoring invalid saved health, which does not change the
+ * health of the servers.
+ */
+void test_Health_RestoreInvalid( void )
+{
+    SntpServerHealth_t initial[ TEST_NUM_SERVERS ];
+    size_t savedSize = 0U;
+
+    recordOutcome( 0U, SntpSuccess, 20000U );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SaveServerHealth( testHealth, TEST_NUM_SERVERS, testBuffer,
+                                                           sizeof( testBuffer ), &savedSize ) );
+    initHealth();
+    ( void ) memcpy( initial, testHealth, sizeof( initial ) );
+
+    /* Truncated saved health. */
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_RestoreServerHealth( testHealth, TEST_NUM_SERVERS, testBuffer, 7U ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_RestoreServerHealth( testHealth, TEST_NUM_SERVERS, testBuffer,
+                                                                        savedSize - 1U ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_RestoreServerHealth( testHealth, TEST_NUM_SERVERS, testBuffer,
+                                                                        savedSize - 24U ) );
+
+    /* Corrupted magic word. */
+    testBuffer[ 3 ] ^= 1U;
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_RestoreServerHealth( testHealth, TEST_NUM_SERVERS, testBuffer, savedSize ) );
+    testBuffer[ 3 ] ^= 1U;
+
+    /* Rates out of range, in the last saved server so that the first one is
+     * not restored either. */
+    testBuffer[ savedSize - 20U ] = 0xFFU;
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_RestoreServerHealth( testHealth, TEST_NUM_SERVERS, testBuffer, savedSize ) );
+    testBuffer[ savedSize - 20U ] = 0U;
+    testBuffer[ savedSize - 16U ] = 0xFFU;
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_RestoreServerHealth( testHealth, TEST_NUM_SERVERS, testBuffer, savedSize ) );
+
+    TEST_ASSERT_EQUAL_MEMORY( initial, testHealth, sizeof( initial ) );
+}
@@ -0,0 +1,327 @@
+/*
+ * coreSNTP v1.0.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file core_sntp_histogram_utest.c
+ * @brief Unit tests of the histogram API of the coreSNTP library.
+ */
+
+/* Standard includes. */
+#include <string.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+/* Unity include. */
+#include "unity.h"
+
+/* coreSNTP Histogram API include */
+#include "core_sntp_histogram.h"
+
+/* Number of SNTP timestamp fractions in a second. */
+#define FRACTIONS_PER_SECOND        ( ( int64_t ) 0x100000000 )
+
+/* Largest value distinguished by the histograms. */
+#define TEST_MAX_VALUE              ( ( 1U << SNTP_HISTOGRAM_VALUE_BITS ) - 1U )
+
+/* Lowest value of the last bucket, which also counts larger values. */
+#define TEST_LAST_BUCKET_VALUE                \
+    ( ( ( 2U * SNTP_HISTOGRAM_SUB_BUCKETS ) - 1U ) << \
+      ( SNTP_HISTOGRAM_VALUE_BITS - SNTP_HISTOGRAM_SUB_BUCKET_BITS - 1U ) )
+
+/* Number of random values in the tests of percentiles. */
+#define TEST_NUM_OF_VALUES          ( 10000U )
+
+/* Global variables common to test cases. */
+static SntpHistogram_t testHistogram;
+static uint32_t testValues[ TEST_NUM_OF_VALUES ];
+static uint32_t randomState;
+
+/* ============================ Helper Functions ============================ */
+
+/* Generates a pseudo-random value, spread evenly over the powers of 2 up to
+ * the largest value of the histograms. */
+static uint32_t randomValue( void )
+{
+    uint32_t bits;
+
+    randomState = ( randomState * 1103515245U ) + 12345U;
+    bits = ( randomState >> 16 ) % ( SNTP_HISTOGRAM_VALUE_BITS + 1U );
+    randomState = ( randomState * 1103515245U ) + 12345U;
+
+    return ( bits == 0U ) ? 0U : ( ( randomState >> 1 ) & ( ( 1U << bits ) - 1U ) );
+}
+
+/* Orders values for qsort. */
+static int compareValues( const void * pFirst,
+                          const void * pSecond )
+{
+    uint32_t first = *( const uint32_t * ) pFirst;
+    uint32_t second = *( const uint32_t * ) pSecond;
+
+    return ( first < second ) ? -1 : ( ( first > second ) ? 1 : 0 );
+}
+
+/* Reads a percentile of the test histogram. */
+static uint32_t readPercentile( uint32_t percentilePpm )
+{
+    uint32_t value = 0U;
+
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_GetHistogramPercentile( &testHistogram, percentilePpm, &value ) );
+
+    return value;
+}
+
+/* ============================   UNITY FIXTURES ============================ */
+
+/* Called before each test method. */
+void setUp()
+{
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_InitHistogram( &testHistogram ) );
+    randomState = 1U;
+}
+
+/* Called at the beginning of the whole suite. */
+void suiteSetUp()
+{
+}
+
+/* Called at the end of the whole suite. */
+int suiteTearDown( int numFailures )
+{
+    return numFailures;
+}
+
+/* ========================================================================== */
+
+/**
+ * @brief Test the histogram API functions with invalid parameters.
+ */
+void test_Histogram_InvalidParams( void )
+{
+    SntpServerHistograms_t histograms;
+    uint32_t value;
+
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_InitHistogram( NULL ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_InitServerHistograms( NULL, 1U ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_InitServerHistograms( &histograms, 0U ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_RecordHistogramValue( NULL, 0U ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_RecordHistogramDuration( NULL, 0 ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_MergeHistograms( NULL, &testHistogram ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_MergeHistograms( &testHistogram, NULL ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_GetHistogramCount( NULL, &value ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_GetHistogramCount( &testHistogram, NULL ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_GetHistogramPercentile( NULL, 0U, &value ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_GetHistogramPercentile( &testHistogram, 0U, NULL ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter,
+                       Sntp_GetHistogramPercentile( &testHistogram, SNTP_HISTOGRAM_MAX_PERCENTILE + 1U, &value ) );
+
+    /* An empty histogram has no percentiles. */
+    TEST_ASSERT_EQUAL( SntpInsufficientSamples, Sntp_GetHistogramPercentile( &testHistogram, 0U, &value ) );
+
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_InitServerHistograms( &histograms, 1U ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_GetHistogramCount( &histograms.responseLatency, &value ) );
+    TEST_ASSERT_EQUAL( 0U, value );
+}
+
+/**
+ * @brief Test that small values are counted exactly.
+ */
+void test_Histogram_SmallValuesExact( void )
+{
+    uint32_t value;
+    uint32_t count;
+
+    for( value = 0U; value < ( 2U * SNTP_HISTOGRAM_SUB_BUCKETS ); value++ )
+    {
+        TEST_ASSERT_EQUAL( SntpSuccess, Sntp_RecordHistogramValue( &testHistogram, value ) );
+    }
+
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_GetHistogramCount( &testHistogram, &count ) );
+    TEST_ASSERT_EQUAL( 2U * SNTP_HISTOGRAM_SUB_BUCKETS, count );
+
+    /* The value of rank r is r - 1. */
+    for( value = 0U; value < ( 2U * SNTP_HISTOGRAM_SUB_BUCKETS ); value++ )
+    {
+        TEST_ASSERT_EQUAL( value, readPercentile( ( ( value + 1U ) * SNTP_HISTOGRAM_MAX_PERCENTILE ) /
+                                                  ( 2U * SNTP_HISTOGRAM_SUB_BUCKETS ) ) );
+    }
+
+    TEST_ASSERT_EQUAL( 0U, readPercentile( 0U ) );
+    TEST_ASSERT_EQUAL( ( 2U * SNTP_HISTOGRAM_SUB_BUCKETS ) - 1U, readPercentile( SNTP_HISTOGRAM_MAX_PERCENTILE ) );
+}
+
+/**
+ * @brief Test that every value below the last bucket is reported as the
+ * highest value of its bucket, which is within the precision of the histogram
+ * above the value, and that the buckets are contiguous.
+ */
+void test_Histogram_BucketPrecision( void )
+{
+    uint32_t value;
+    uint32_t reported;
+    uint32_t previous = 0U;
+
+    for( value = 1U; value < TEST_LAST_BUCKET_VALUE; value += ( value / 64U ) + 1U )
+    {
+        TEST_ASSERT_EQUAL( SntpSuccess, Sntp_InitHistogram( &testHistogram ) );
+        TEST_ASSERT_EQUAL( SntpSuccess, Sntp_RecordHistogramValue( &testHistogram, value ) );
+        TEST_ASSERT_EQUAL( SntpSuccess, Sntp_RecordHistogramValue( &testHistogram, UINT32_MAX ) );
+
+        /* The lower of the two values is reported as its bucket. */
+        reported = readPercentile( SNTP_HISTOGRAM_MAX_PERCENTILE / 2U );
+        TEST_ASSERT_GREATER_OR_EQUAL_UINT32( value, reported );
+        TEST_ASSERT_LESS_OR_EQUAL_UINT32( value / SNTP_HISTOGRAM_SUB_BUCKETS, reported - value );
+        TEST_ASSERT_GREATER_OR_EQUAL_UINT32( previous, reported );
+        previous = reported;
+    }
+
+    /* The bucket before the last ends where the last begins. */
+    TEST_ASSERT_EQUAL( TEST_LAST_BUCKET_VALUE - 1U, previous );
+}
+
+/**
+ * @brief Test the percentiles of random values against the exact percentiles.
+ */
+void test_Histogram_Percentiles( void )
+{
+    static const uint32_t percentiles[] = { 1U, 10000U, 250000U, 500000U, 900000U, 990000U, 999000U };
+    uint32_t exact;
+    uint32_t reported;
+    size_t i;
+
+    for( i = 0U; i < TEST_NUM_OF_VALUES; i++ )
+    {
+        testValues[ i ] = randomValue();
+        TEST_ASSERT_EQUAL( SntpSuccess, Sntp_RecordHistogramValue( &testHistogram, testValues[ i ] ) );
+    }
+
+    qsort( testValues, TEST_NUM_OF_VALUES, sizeof( testValues[ 0 ] ), compareValues );
+
+    for( i = 0U; i < ( sizeof( percentiles ) / sizeof( percentiles[ 0 ] ) ); i++ )
+    {
+        exact = testValues[ ( ( ( uint64_t ) TEST_NUM_OF_VALUES * percentiles[ i ] ) +
+                              SNTP_HISTOGRAM_MAX_PERCENTILE - 1U ) / SNTP_HISTOGRAM_MAX_PERCENTILE - 1U ];
+        reported = readPercentile( percentiles[ i ] );
+
+        TEST_ASSERT_GREATER_OR_EQUAL_UINT32( exact, reported );
+        TEST_ASSERT_LESS_OR_EQUAL_UINT32( exact / SNTP_HISTOGRAM_SUB_BUCKETS, reported - exact );
+    }
+
+    /* The extremes are exact. */
+    TEST_ASSERT_EQUAL( testValues[ 0 ], readPercentile( 0U ) );
+    TEST_ASSERT_EQUAL( testValues[ TEST_NUM_OF_VALUES - 1U ], readPercentile( SNTP_HISTOGRAM_MAX_PERCENTILE ) );
+}
+
+/**
+ * @brief Test that values beyond the range of the buckets are counted in the
+ * last bucket, with the largest value reported exactly.
+ */
+void test_Histogram_LargeValues( void )
+{
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_RecordHistogramValue( &testHistogram, TEST_LAST_BUCKET_VALUE ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_RecordHistogramValue( &testHistogram, TEST_MAX_VALUE + 1U ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_RecordHistogramValue( &testHistogram, UINT32_MAX ) );
+
+    TEST_ASSERT_EQUAL( TEST_LAST_BUCKET_VALUE, readPercentile( 0U ) );
+    TEST_ASSERT_EQUAL( UINT32_MAX, readPercentile( SNTP_HISTOGRAM_MAX_PERCENTILE / 3U ) );
+    TEST_ASSERT_EQUAL( UINT32_MAX, readPercentile( SNTP_HISTOGRAM_MAX_PERCENTILE ) );
+    TEST_ASSERT_EQUAL( 3U, testHistogram.counts[ SNTP_HISTOGRAM_NUM_BUCKETS - 1U ] );
+
+    /* The last bucket is reported up to the largest value. */
+    testHistogram.maxValue = TEST_MAX_VALUE + 1U;
+    TEST_ASSERT_EQUAL( TEST_MAX_VALUE + 1U, readPercentile( SNTP_HISTOGRAM_MAX_PERCENTILE / 3U ) );
+
+    /* The count saturates, and further values are discarded. */
+    testHistogram.totalCount = UINT32_MAX;
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_RecordHistogramValue( &testHistogram, 0U ) );
+    TEST_ASSERT_EQUAL( UINT32_MAX, testHistogram.totalCount );
+    TEST_ASSERT_EQUAL( 0U, testHistogram.counts[ 0 ] );
+}
+
+/**
+ * @brief Test the conversion of durations in SNTP timestamp fractions.
+ */
+void test_Histogram_RecordDuration( void )
+{
+    /* 1.5 seconds, as a negative clock offset. */
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_RecordHistogramDuration( &testHistogram, -( FRACTIONS_PER_SECOND * 3 ) / 2 ) );
+    TEST_ASSERT_EQUAL( 1500000U, readPercentile( 0U ) );
+
+    /* 250 microseconds, truncated. */
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_InitHistogram( &testHistogram ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_RecordHistogramDuration( &testHistogram, ( FRACTIONS_PER_SECOND / 4000 ) + 1 ) );
+    TEST_ASSERT_EQUAL( 250U, readPercentile( 0U ) );
+
+    /* Durations beyond the range of 32 bits saturate. */
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_RecordHistogramDuration( &testHistogram, INT64_MIN ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_RecordHistogramDuration( &testHistogram, FRACTIONS_PER_SECOND * 5000 ) );
+    TEST_ASSERT_EQUAL( UINT32_MAX, readPercentile( SNTP_HISTOGRAM_MAX_PERCENTILE ) );
+    TEST_ASSERT_EQUAL( UINT32_MAX, readPercentile( SNTP_HISTOGRAM_MAX_PERCENTILE / 2U ) );
+}
+
+/**
+ * @brief Test that merging histograms is equivalent to recording all the
+ * values in one histogram.
+ */
+void test_Histogram_Merge( void )
+{
+    SntpHistogram_t first;
+    SntpHistogram_t second;
+    uint32_t value;
+    size_t i;
+
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_InitHistogram( &first ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_InitHistogram( &second ) );
+
+    /* Merging an empty histogram changes nothing. */
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_MergeHistograms( &first, &second ) );
+    TEST_ASSERT_EQUAL( 0U, first.totalCount );
+
+    for( i = 0U; i < TEST_NUM_OF_VALUES; i++ )
+    {
+        value = randomValue();
+        TEST_ASSERT_EQUAL( SntpSuccess, Sntp_RecordHistogramValue( &testHistogram, value ) );
+        TEST_ASSERT_EQUAL( SntpSuccess, Sntp_RecordHistogramValue( ( ( i % 3U ) == 0U ) ? &first : &second, value ) );
+    }
+
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_MergeHistograms( &first, &second ) );
+    TEST_ASSERT_EQUAL_MEMORY( &testHistogram, &first, sizeof( SntpHistogram_t ) );
+
+    /* A merge into an empty histogram copies it. */
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_InitHistogram( &second ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_MergeHistograms( &second, &first ) );
+    TEST_ASSERT_EQUAL_MEMORY( &first, &second, sizeof( SntpHistogram_t ) );
+
+    /* Counts saturate, and the largest value is reported if the buckets fall
+     * short of the rank. */
+    first.counts[ 0 ] = UINT32_MAX;
+    first.totalCount = UINT32_MAX;
+    second.counts[ 0 ] = 1U;
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_MergeHistograms( &second, &first ) );
+    TEST_ASSERT_EQUAL( UINT32_MAX, second.counts[ 0 ] );
+    TEST_ASSERT_EQUAL( UINT32_MAX, second.totalCount );
+
+    ( void ) memset( second.counts, 0, sizeof( second.counts ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_GetHistogramPercentile( &second, 1U, &value ) );
+    TEST_ASSERT_EQUAL( second.maxValue, value );
+}
@@ -0,0 +1,479 @@
+/*
+ * coreSNTP v1.0.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* The clock_adjtime system call is a Linux extension. */
+#define _GNU_SOURCE
+
+/* Standard includes. */
+#include <string.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+/* Unity include. */
+#include "unity.h"
+
+/* coreSNTP Linux clock backend API include */
+#include "core_sntp_linux_clock.h"
+
+/* Number of SNTP timestamp fractions in a second. */
+#define FRACTIONS_PER_SECOND        ( ( int64_t ) 0x100000000 )
+
+/* Number of SNTP timestamp fractions in a millisecond (rounded down). */
+#define FRACTIONS_PER_MILLISECOND    ( FRACTIONS_PER_SECOND / 1000 )
+
+/* Maximum number of system calls recorded by the fake system call layer. */
+#define MAX_RECORDED_CALLS           ( 4 )
+
+/* Step threshold used in tests. */
+#define TEST_STEP_THRESHOLD_MS       ( 100U )
+
+/* Global variables common to test cases. */
+static SntpLinuxClock_t testClock;
+static SntpLinuxClockSyscalls_t fakeSyscalls;
+static struct timex adjTimeCalls[ MAX_RECORDED_CALLS ];
+static size_t adjTimeCallCount;
+static int adjTimeReturnValue;
+static size_t adjTimeFailingCall;
+static int kernelStatus;
+static struct timespec getTimeValue;
+static int getTimeReturnValue;
+static struct timespec setTimeValue;
+static size_t setTimeCallCount;
+static int setTimeReturnValue;
+
+/* ========================== Fake System Calls ============================ */
+
+/* Fake clock_adjtime that records the requested adjustments. */
+static int fakeClockAdjTime( clockid_t clockId,
+                             struct timex * pTimex )
+{
+    TEST_ASSERT_EQUAL( CLOCK_REALTIME, clockId );
+    TEST_ASSERT_LESS_THAN( MAX_RECORDED_CALLS, adjTimeCallCount );
+
+    adjTimeCalls[ adjTimeCallCount++ ] = *pTimex;
+
+    /* Report the kernel status for read requests. */
+    if( pTimex->modes == 0 )
+    {
+        pTimex->status = kernelStatus;
+    }
+
+    return ( adjTimeCallCount == adjTimeFailingCall ) ? -1 : adjTimeReturnValue;
+}
+
+/* Fake clock_gettime that returns a configured time. */
+static int fakeClockGetTime( clockid_t clockId,
+                             struct timespec * pTime )
+{
+    TEST_ASSERT_EQUAL( CLOCK_REALTIME, clockId );
+
+    *pTime = getTimeValue;
+
+    return getTimeReturnValue;
+}
+
+/* Fake clock_settime that records the requested time. */
+static int fakeClockSetTime( clockid_t clockId,
+                             const struct timespec * pTime )
+{
+    TEST_ASSERT_EQUAL( CLOCK_REALTIME, clockId );
+
+    setTimeValue = *pTime;
+    setTimeCallCount++;
+
+    return setTimeReturnValue;
+}
+
+/* ============================   UNITY FIXTURES ============================ */
+
+/* Called before each test method. */
+void setUp()
+{
+    ( void ) memset( adjTimeCalls, 0, sizeof( adjTimeCalls ) );
+    adjTimeCallCount = 0U;
+    adjTimeReturnValue = TIME_OK;
+    adjTimeFailingCall = 0U;
+    kernelStatus = STA_UNSYNC | STA_INS;
+    getTimeReturnValue = 0;
+    setTimeCallCount = 0U;
+    setTimeReturnValue = 0;
+
+    fakeSyscalls.clockAdjTime = fakeClockAdjTime;
+    fakeSyscalls.clockGetTime = fakeClockGetTime;
+    fakeSyscalls.clockSetTime = fakeClockSetTime;
+
+    TEST_ASSERT_EQUAL( SntpSuccess, SntpLinuxClock_Init( &testClock,
+                                                         &fakeSyscalls,
+                                                         CLOCK_REALTIME,
+                                                         TEST_STEP_THRESHOLD_MS ) );
+    SntpLinuxClock_Register( &testClock );
+}
+
+/* Called at the beginning of the whole suite. */
+void suiteSetUp()
+{
+}
+
+/* Called at the end of the whole suite. */
+int suiteTearDown( int numFailures )
+{
+    return numFailures;
+}
+
+/* ========================================================================== */
+
+/**
+ * @brief Test the Linux clock backend API functions with invalid parameters.
+ */
+void test_LinuxClock_InvalidParams( void )
+{
+    SntpLinuxClockSyscalls_t syscalls = fakeSyscalls;
+    SntpTimestamp_t time;
+
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, SntpLinuxClock_Init( NULL, &fakeSyscalls,
+                                                                   CLOCK_REALTIME, 0U ) );
+
+    syscalls.clockAdjTime = NULL;
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, SntpLinuxClock_Init( &testClock, &syscalls,
+                                                                   CLOCK_REALTIME, 0U ) );
+    syscalls = fakeSyscalls;
+    syscalls.clockGetTime = NULL;
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, SntpLinuxClock_Init( &testClock, &syscalls,
+                                                                   CLOCK_REALTIME, 0U ) );
+    syscalls = fakeSyscalls;
+    syscalls.clockSetTime = NULL;
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, SntpLinuxClock_Init( &testClock, &syscalls,
+                                                                   CLOCK_REALTIME, 0U ) );
+
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, SntpLinuxClock_Discipline( NULL, 0, 0U ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, SntpLinuxClock_SetPollInterval( NULL, 64U ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, SntpLinuxClock_SetFrequency( NULL, 0 ) );
+    TEST_ASSERT_FALSE( SntpLinuxClock_GetTime( NULL ) );
+    TEST_ASSERT_EQUAL( 0U, adjTimeCallCount );
+
+    /* The interface implementations fail without a registered clock backend. */
+    SntpLinuxClock_Register( NULL );
+    TEST_ASSERT_FALSE( SntpLinuxClock_GetTime( &time ) );
+    TEST_ASSERT_FALSE( SntpLinuxClock_SetTime( "time.server", &time, 0 ) );
+}
+
+/**
+ * @brief Test that the real system calls are used when no system call table
+ * is passed. The system calls are not invoked, as that requires privileges.
+ */
+void test_LinuxClock_Init_DefaultSyscalls( void )
+{
+    TEST_ASSERT_EQUAL( SntpSuccess, SntpLinuxClock_Init( &testClock, NULL, CLOCK_REALTIME,
+                                                         SNTP_LINUX_CLOCK_DEFAULT_STEP_THRESHOLD_MS ) );
+
+    TEST_ASSERT_TRUE( testClock.syscalls.clockAdjTime == clock_adjtime );
+    TEST_ASSERT_TRUE( testClock.syscalls.clockGetTime == clock_gettime );
+    TEST_ASSERT_TRUE( testClock.syscalls.clockSetTime == clock_settime );
+}
+
+/**
+ * @brief Test that clock offsets within the step threshold are slewed with the
+ * kernel PLL, and the unrelated kernel status bits are kept.
+ */
+void test_LinuxClock_Discipline_Slew( void )
+{
+    /* +50 ms offset at a 64 second polling interval. */
+    TEST_ASSERT_EQUAL( SntpSuccess, SntpLinuxClock_Discipline( &testClock,
+                                                               50 * FRACTIONS_PER_MILLISECOND,
+                                                               64U ) );
+
+    TEST_ASSERT_EQUAL( 2U, adjTimeCallCount );
+    TEST_ASSERT_EQUAL( 0, adjTimeCalls[ 0 ].modes );
+    TEST_ASSERT_EQUAL( ADJ_STATUS | ADJ_NANO | ADJ_OFFSET | ADJ_MAXERROR | ADJ_ESTERROR | ADJ_TIMECONST,
+                       adjTimeCalls[ 1 ].modes );
+    TEST_ASSERT_EQUAL( STA_PLL | STA_INS, adjTimeCalls[ 1 ].status );
+    TEST_ASSERT_INT_WITHIN( 10, 50000000, adjTimeCalls[ 1 ].offset );
+    TEST_ASSERT_INT_WITHIN( 1, 50000, adjTimeCalls[ 1 ].maxerror );
+    TEST_ASSERT_EQUAL( 6, adjTimeCalls[ 1 ].constant );
+
+    /* -50 ms offset without a polling interval keeps the time constant. */
+    adjTimeCallCount = 0U;
+    TEST_ASSERT_EQUAL( SntpSuccess, SntpLinuxClock_Discipline( &testClock,
+                                                               -50 * FRACTIONS_PER_MILLISECOND,
+                                                               0U ) );
+    TEST_ASSERT_INT_WITHIN( 10, -50000000, adjTimeCalls[ 1 ].offset );
+    TEST_ASSERT_EQUAL( 6, adjTimeCalls[ 1 ].constant );
+
+    /* The time constant is limited to the kernel maximum. */
+    adjTimeCallCount = 0U;
+    TEST_ASSERT_EQUAL( SntpSuccess, SntpLinuxClock_Discipline( &testClock, 0, 65536U ) );
+    TEST_ASSERT_EQUAL( 0, adjTimeCalls[ 1 ].offset );
+    TEST_ASSERT_EQUAL( 10, adjTimeCalls[ 1 ].constant );
+
+    /* Without any polling interval, the kernel time constant is not changed. */
+    TEST_ASSERT_EQUAL( SntpSuccess, SntpLinuxClock_Init( &testClock, &fakeSyscalls, CLOCK_REALTIME,
+                                                         TEST_STEP_THRESHOLD_MS ) );
+    adjTimeCallCount = 0U;
+    TEST_ASSERT_EQUAL( SntpSuccess, SntpLinuxClock_Discipline( &testClock,
+                                                               TEST_STEP_THRESHOLD_MS * FRACTIONS_PER_MILLISECOND,
+                                                               0U ) );
+    TEST_ASSERT_EQUAL( 0, adjTimeCalls[ 1 ].modes & ADJ_TIMECONST );
+}
+
+/**
+ * @brief Test that slewed offsets are limited to the kernel limit when the
+ * step threshold is higher than the limit.
+ */
+void test_LinuxClock_Discipline_SlewLimit( void )
+{
+    TEST_ASSERT_EQUAL( SntpSuccess, SntpLinuxClock_Init( &testClock, &fakeSyscalls, CLOCK_REALTIME,
+                                                         2000U ) );
+
+    TEST_ASSERT_EQUAL( SntpSuccess, SntpLinuxClock_Discipline( &testClock, -FRACTIONS_PER_SECOND, 0U ) );
+
+    TEST_ASSERT_EQUAL( 2U, adjTimeCallCount );
+    TEST_ASSERT_EQUAL( -500000000, adjTimeCalls[ 1 ].offset );
+}
+
+/**
+ * @brief Test that clock offsets beyond the step threshold step the clock.
+ */
+void test_LinuxClock_Discipline_Step( void )
+{
+    /* +2.5 seconds. */
+    TEST_ASSERT_EQUAL( SntpSuccess, SntpLinuxClock_Discipline( &testClock,
+                                                               ( 5 * FRACTIONS_PER_SECOND ) / 2,
+                                                               0U ) );
+    TEST_ASSERT_EQUAL( 1U, adjTimeCallCount );
+    TEST_ASSERT_EQUAL( ADJ_SETOFFSET | ADJ_NANO | ADJ_OFFSET, adjTimeCalls[ 0 ].modes );
+    TEST_ASSERT_EQUAL( 0, adjTimeCalls[ 0 ].offset );
+    TEST_ASSERT_EQUAL( 2, adjTimeCalls[ 0 ].time.tv_sec );
+    TEST_ASSERT_EQUAL( 500000000, adjTimeCalls[ 0 ].time.tv_usec );
+
+    /* -2.5 seconds is represented with a positive sub-second part. */
+    adjTimeCallCount = 0U;
+    TEST_ASSERT_EQUAL( SntpSuccess, SntpLinuxClock_Discipline( &testClock,
+                                                               -( 5 * FRACTIONS_PER_SECOND ) / 2,
+                                                               0U ) );
+    TEST_ASSERT_EQUAL( -3, adjTimeCalls[ 0 ].time.tv_sec );
+    TEST_ASSERT_EQUAL( 500000000, adjTimeCalls[ 0 ].time.tv_usec );
+
+    /* -3 seconds. */
+    adjTimeCallCount = 0U;
+    TEST_ASSERT_EQUAL( SntpSuccess, SntpLinuxClock_Discipline( &testClock,
+                                                               -3 * FRACTIONS_PER_SECOND,
+                                                               0U ) );
+    TEST_ASSERT_EQUAL( -3, adjTimeCalls[ 0 ].time.tv_sec );
+    TEST_ASSERT_EQUAL( 0, adjTimeCalls[ 0 ].time.tv_usec );
+
+    /* Just beyond the threshold. */
+    adjTimeCallCount = 0U;
+    TEST_ASSERT_EQUAL( SntpSuccess, SntpLinuxClock_Discipline( &testClock,
+                                                               ( TEST_STEP_THRESHOLD_MS + 1 ) * FRACTIONS_PER_MILLISECOND,
+                                                               0U ) );
+    TEST_ASSERT_EQUAL( 1U, adjTimeCallCount );
+    TEST_ASSERT_EQUAL( 0, adjTimeCalls[ 0 ].time.tv_sec );
+    TEST_ASSERT_INT_WITHIN( 1000, 101000000, adjTimeCalls[ 0 ].time.tv_usec );
+}
+
+/**
+ * @brief Test that failures of the system calls are reported.
+ */
+void test_LinuxClock_Discipline_SyscallFailure( void )
+{
+    adjTimeReturnValue = -1;
+
+    TEST_ASSERT_EQUAL( SntpErrorSystemClockFailure,
+                       SntpLinuxClock_Discipline( &testClock, 10 * FRACTIONS_PER_SECOND, 0U ) );
+    TEST_ASSERT_EQUAL( SntpErrorSystemClockFailure,
+                       SntpLinuxClock_Discipline( &testClock, FRACTIONS_PER_MILLISECOND, 0U ) );
+    TEST_ASSERT_EQUAL( SntpErrorSystemClockFailure,
+                       SntpLinuxClock_SetFrequency( &testClock, 0 ) );
+
+    /* Failure of the adjustment after reading the kernel status. */
+    adjTimeReturnValue = TIME_OK;
+    adjTimeCallCount = 0U;
+    adjTimeFailingCall = 2U;
+    TEST_ASSERT_EQUAL( SntpErrorSystemClockFailure,
+                       SntpLinuxClock_Discipline( &testClock, FRACTIONS_PER_MILLISECOND, 0U ) );
+    TEST_ASSERT_EQUAL( 2U, adjTimeCallCount );
+}
+
+/**
+ * @brief Test the conversion of frequency corrections to the kernel format.
+ */
+void test_LinuxClock_SetFrequency( void )
+{
+    /* 100 PPM is 429497 fractions per second, and 100 << 16 in kernel units. */
+    TEST_ASSERT_EQUAL( SntpSuccess, SntpLinuxClock_SetFrequency( &testClock, 429497 ) );
+    TEST_ASSERT_EQUAL( ADJ_FREQUENCY, adjTimeCalls[ 0 ].modes );
+    TEST_ASSERT_INT_WITHIN( 10, 100 << 16, adjTimeCalls[ 0 ].freq );
+
+    TEST_ASSERT_EQUAL( SntpSuccess, SntpLinuxClock_SetFrequency( &testClock, -429497 ) );
+    TEST_ASSERT_INT_WITHIN( 10, -( 100 << 16 ), adjTimeCalls[ 1 ].freq );
+
+    /* Values beyond 500 PPM are limited. */
+    TEST_ASSERT_EQUAL( SntpSuccess, SntpLinuxClock_SetFrequency( &testClock, INT32_MAX ) );
+    TEST_ASSERT_EQUAL( 500 << 16, adjTimeCalls[ 2 ].freq );
+
+    TEST_ASSERT_EQUAL( SntpSuccess, SntpLinuxClock_SetFrequency( &testClock, INT32_MIN ) );
+    TEST_ASSERT_EQUAL( -( 500 << 16 ), adjTimeCalls[ 3 ].freq );
+}
+
+/**
+ * @brief Test the reference implementation of the SntpGetTime_t interface.
+ */
+void test_LinuxClock_GetTime( void )
+{
+    SntpTimestamp_t time;
+
+    getTimeValue.tv_sec = 1000;
+    getTimeValue.tv_nsec = 500000000;
+    TEST_ASSERT_TRUE( SntpLinuxClock_GetTime( &time ) );
+    TEST_ASSERT_EQUAL_UINT32( SNTP_TIME_AT_UNIX_EPOCH_SECS + 1000U, time.seconds );
+    TEST_ASSERT_EQUAL_UINT32( 0x80000000U, time.fractions );
+
+    /* Time in SNTP era 1. */
+    getTimeValue.tv_sec = UNIX_TIME_SECS_AT_SNTP_ERA_1_SMALLEST_TIME + 10U;
+    getTimeValue.tv_nsec = 0;
+    TEST_ASSERT_TRUE( SntpLinuxClock_GetTime( &time ) );
+    TEST_ASSERT_EQUAL_UINT32( 10U, time.seconds );
+    TEST_ASSERT_EQUAL_UINT32( 0U, time.fractions );
+
+    getTimeReturnValue = -1;
+    TEST_ASSERT_FALSE( SntpLinuxClock_GetTime( &time ) );
+}
+
+/**
+ * @brief Test the reference implementation of the SntpSetTime_t interface.
+ */
+void test_LinuxClock_SetTime( void )
+{
+    SntpTimestamp_t serverTime = { SNTP_TIME_AT_UNIX_EPOCH_SECS + 1000U, 0x80000000U };
+
+    /* The offset under a second, which the offset in seconds truncates to
+     * zero, is measured from the server time and slewed. */
+    getTimeValue.tv_sec = 1000;
+    getTimeValue.tv_nsec = 450000000;
+    TEST_ASSERT_TRUE( SntpLinuxClock_SetTime( "time.server", &serverTime, 0 ) );
+    TEST_ASSERT_EQUAL( 2U, adjTimeCallCount );
+    TEST_ASSERT_INT_WITHIN( 10, 50000000, adjTimeCalls[ 1 ].offset );
+    TEST_ASSERT_INT_WITHIN( 1, 50000, adjTimeCalls[ 1 ].maxerror );
+
+    adjTimeCallCount = 0U;
+    getTimeValue.tv_nsec = 520000000;
+    TEST_ASSERT_TRUE( SntpLinuxClock_SetTime( "time.server", &serverTime, 0 ) );
+    TEST_ASSERT_INT_WITHIN( 10, -20000000, adjTimeCalls[ 1 ].offset );
+    TEST_ASSERT_EQUAL( 0, adjTimeCalls[ 1 ].modes & ADJ_TIMECONST );
+
+    /* The time constant follows the polling interval set for the client. */
+    adjTimeCallCount = 0U;
+    TEST_ASSERT_EQUAL( SntpSuccess, SntpLinuxClock_SetPollInterval( &testClock, 256U ) );
+    TEST_ASSERT_EQUAL( 0U, adjTimeCallCount );
+    TEST_ASSERT_TRUE( SntpLinuxClock_SetTime( "time.server", &serverTime, 0 ) );
+    TEST_ASSERT_EQUAL( ADJ_TIMECONST, adjTimeCalls[ 1 ].modes & ADJ_TIMECONST );
+    TEST_ASSERT_EQUAL( 8, adjTimeCalls[ 1 ].constant );
+
+    /* And the polling interval of the last disciplined offset is kept. */
+    TEST_ASSERT_EQUAL( SntpSuccess, SntpLinuxClock_Discipline( &testClock, 0, 32U ) );
+    adjTimeCallCount = 0U;
+    TEST_ASSERT_TRUE( SntpLinuxClock_SetTime( "time.server", &serverTime, 0 ) );
+    TEST_ASSERT_EQUAL( 5, adjTimeCalls[ 1 ].constant );
+
+    /* Offsets beyond the threshold are stepped, with their sub-second part. */
+    adjTimeCallCount = 0U;
+    getTimeValue.tv_sec = 1005;
+    getTimeValue.tv_nsec = 750000000;
+    TEST_ASSERT_TRUE( SntpLinuxClock_SetTime( "time.server", &serverTime, -5 ) );
+    TEST_ASSERT_EQUAL( 1U, adjTimeCallCount );
+    TEST_ASSERT_EQUAL( -6, adjTimeCalls[ 0 ].time.tv_sec );
+    TEST_ASSERT_INT_WITHIN( 10, 750000000, adjTimeCalls[ 0 ].time.tv_usec );
+
+    /* The clock offset cannot be measured without the clock time. */
+    adjTimeCallCount = 0U;
+    getTimeReturnValue = -1;
+    TEST_ASSERT_FALSE( SntpLinuxClock_SetTime( "time.server", &serverTime, -5 ) );
+    TEST_ASSERT_FALSE( SntpLinuxClock_SetTime( "time.server", NULL, -5 ) );
+    TEST_ASSERT_EQUAL( 0U, adjTimeCallCount );
+    getTimeReturnValue = 0;
+
+    adjTimeReturnValue = -1;
+    TEST_ASSERT_FALSE( SntpLinuxClock_SetTime( "time.server", &serverTime, -5 ) );
+
+    /* Without a clock offset, the clock is set to the server time. */
+    TEST_ASSERT_TRUE( SntpLinuxClock_SetTime( "time.server", &serverTime, SNTP_CLOCK_OFFSET_OVERFLOW ) );
+    TEST_ASSERT_EQUAL( 1U, setTimeCallCount );
+    TEST_ASSERT_EQUAL( 1000, setTimeValue.tv_sec );
+    TEST_ASSERT_EQUAL( 500000000, setTimeValue.tv_nsec );
+
+    setTimeReturnValue = -1;
+    TEST_ASSERT_FALSE( SntpLinuxClock_SetTime( "time.server", &serverTime, SNTP_CLOCK_OFFSET_OVERFLOW ) );
+
+    /* Server time that cannot be converted to UNIX time. */
+    setTimeCallCount = 0U;
+    serverTime.seconds = SNTP_TIME_AT_UNIX_EPOCH_SECS - 1U;
+    TEST_ASSERT_FALSE( SntpLinuxClock_SetTime( "time.server", &serverTime, SNTP_CLOCK_OFFSET_OVERFLOW ) );
+    TEST_ASSERT_FALSE( SntpLinuxClock_SetTime( "time.server", NULL, SNTP_CLOCK_OFFSET_OVERFLOW ) );
+    TEST_ASSERT_EQUAL( 0U, setTimeCallCount );
+}
+
+/**
+ * @brief Test the conversions between struct timespec and SNTP timestamps.
+ */
+void test_LinuxClock_TimespecConversion( void )
+{
+    struct timespec time = { 1000, 999999999L };
+    SntpTimestamp_t sntpTime;
+
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, SntpLinuxClock_ConvertFromTimespec( NULL, &sntpTime ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, SntpLinuxClock_ConvertFromTimespec( &time, NULL ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, SntpLinuxClock_ConvertToTimespec( NULL, &time ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, SntpLinuxClock_ConvertToTimespec( &sntpTime, NULL ) );
+
+    time.tv_nsec = -1L;
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, SntpLinuxClock_ConvertFromTimespec( &time, &sntpTime ) );
+    time.tv_nsec = 1000000000L;
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, SntpLinuxClock_ConvertFromTimespec( &time, &sntpTime ) );
+
+    /* The conversion is exact in both directions. */
+    time.tv_nsec = 999999999L;
+    TEST_ASSERT_EQUAL( SntpSuccess, SntpLinuxClock_ConvertFromTimespec( &time, &sntpTime ) );
+    TEST_ASSERT_EQUAL_UINT32( SNTP_TIME_AT_UNIX_EPOCH_SECS + 1000U, sntpTime.seconds );
+    time.tv_sec = 0;
+    time.tv_nsec = 0L;
+    TEST_ASSERT_EQUAL( SntpSuccess, SntpLinuxClock_ConvertToTimespec( &sntpTime, &time ) );
+    TEST_ASSERT_EQUAL( 1000, time.tv_sec );
+    TEST_ASSERT_EQUAL( 999999999L, time.tv_nsec );
+
+    /* Times before the UNIX epoch are not supported by the system clock. */
+    sntpTime.seconds = SNTP_TIME_AT_UNIX_EPOCH_SECS - 1U;
+    TEST_ASSERT_EQUAL( SntpErrorTimeNotSupported, SntpLinuxClock_ConvertToTimespec( &sntpTime, &time ) );
+
+    /* Time past 2038 in SNTP era 1 is supported with a 64-bit time_t. */
+    sntpTime.seconds = SNTP_TIME_AT_LARGEST_UNIX_TIME_SECS + 1U;
+
+    if( sizeof( time_t ) >= sizeof( int64_t ) )
+    {
+        TEST_ASSERT_EQUAL( SntpSuccess, SntpLinuxClock_ConvertToTimespec( &sntpTime, &time ) );
+        TEST_ASSERT_EQUAL_INT64( ( int64_t ) INT32_MAX + 1, ( int64_t ) time.tv_sec );
+    }
+    else
+    {
+        TEST_ASSERT_EQUAL( SntpErrorTimeNotSupported, SntpLinuxClock_ConvertToTimespec( &sntpTime, &time ) );
+    }
+}
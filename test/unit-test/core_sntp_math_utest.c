@@ -0,0 +1,65 @@
+/*
+ * coreSNTP v1.0.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Standard includes. */
+#include <stdint.h>
+
+/* Unity include. */
+#include "unity.h"
+
+/* coreSNTP math utilities include */
+#include "core_sntp_math.h"
+
+/* ============================   UNITY FIXTURES ============================ */
+
+/* Called before each test method. */
+void setUp()
+{
+}
+
+/* Called at the beginning of the whole suite. */
+void suiteSetUp()
+{
+}
+
+/* Called at the end of the whole suite. */
+int suiteTearDown( int numFailures )
+{
+    return numFailures;
+}
+
+/* ========================================================================== */
+
+/**
+ * @brief Test the integer square root.
+ */
+void test_Math_SquareRoot64( void )
+{
+    TEST_ASSERT_EQUAL_UINT64( 0U, Sntp_SquareRoot64( 0U ) );
+    TEST_ASSERT_EQUAL_UINT64( 1U, Sntp_SquareRoot64( 3U ) );
+    TEST_ASSERT_EQUAL_UINT64( 2U, Sntp_SquareRoot64( 4U ) );
+    TEST_ASSERT_EQUAL_UINT64( 999U, Sntp_SquareRoot64( 999999U ) );
+    TEST_ASSERT_EQUAL_UINT64( 1000U, Sntp_SquareRoot64( 1000000U ) );
+
+    /* The largest value. */
+    TEST_ASSERT_EQUAL_UINT64( UINT32_MAX, Sntp_SquareRoot64( UINT64_MAX ) );
+}
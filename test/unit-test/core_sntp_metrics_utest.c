@@ -0,0 +1,396 @@
+/*
+ * coreSNTP v1.0.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file core_sntp_metrics_utest.c
+ * @brief Unit tests of the statistics API of the coreSNTP library.
+ */
+
+/* Standard includes. */
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Unity include. */
+#include "unity.h"
+
+/* coreSNTP Metrics API include */
+#include "core_sntp_metrics.h"
+
+/* Number of SNTP timestamp fractions in a second. */
+#define FRACTIONS_PER_SECOND    ( ( int64_t ) 0x100000000 )
+
+/* Number of servers of the tests. */
+#define TEST_NUM_OF_SERVERS     ( 2U )
+
+/* Kiss-o'-Death codes of the tests. */
+#define TEST_KISS_CODE_DENY     ( 0x44454E59U )
+#define TEST_KISS_CODE_RSTR     ( 0x52535452U )
+#define TEST_KISS_CODE_RATE     ( 0x52415445U )
+#define TEST_KISS_CODE_OTHER    ( 0x58595A5AU )
+
+/* Global variables common to test cases. */
+static SntpMetrics_t testMetrics;
+static SntpServerMetrics_t testServerMetrics[ TEST_NUM_OF_SERVERS ];
+static SntpResponseData_t testResponse;
+static SntpTimestamp_t testRxTime;
+static char testText[ 8192 ];
+
+/* ============================ Helper Functions ============================ */
+
+/* Records an accepted response with a clock offset, in SNTP timestamp fractions. */
+static void recordOffset( size_t serverIndex,
+                          int64_t offsetFractions )
+{
+    testResponse.clockOffsetFractions = offsetFractions;
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_RecordResponseMetrics( &testMetrics, serverIndex, SntpSuccess,
+                                                                &testResponse, &testRxTime ) );
+}
+
+/* Records a Kiss-o'-Death response with a code. */
+static void recordKissOfDeath( SntpStatus_t status,
+                               uint32_t kissCode )
+{
+    testResponse.rejectedResponseCode = kissCode;
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_RecordResponseMetrics( &testMetrics, 1U, status,
+                                                                &testResponse, NULL ) );
+}
+
+/* Renders the statistics into the test buffer and checks that the text
+ * contains a line. */
+static void assertRenderedLine( const SntpTimestamp_t * pCurrentTime,
+                                const char * pLine )
+{
+    size_t length;
+
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_RenderMetrics( &testMetrics, pCurrentTime, testText,
+                                                        sizeof( testText ), &length ) );
+    TEST_ASSERT_EQUAL( strlen( testText ), length );
+    TEST_ASSERT_NOT_NULL( strstr( testText, pLine ) );
+}
+
+/* ============================ UNITY FIXTURES ============================== */
+
+/* Called before each test method. */
+void setUp()
+{
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_InitMetrics( &testMetrics, testServerMetrics, TEST_NUM_OF_SERVERS ) );
+    testServerMetrics[ 0 ].pServerName = "time.example.com";
+    testServerMetrics[ 1 ].pServerName = "pool \"a\\b\"\n";
+
+    memset( &testResponse, 0, sizeof( testResponse ) );
+    testResponse.roundTripDelayFractions = FRACTIONS_PER_SECOND / 4;
+    testResponse.stratum = 2U;
+    testRxTime.seconds = 1000U;
+    testRxTime.fractions = 0U;
+    memset( testText, 0, sizeof( testText ) );
+}
+
+/* Called at the beginning of the whole suite. */
+void suiteSetUp()
+{
+}
+
+/* Called at the end of the whole suite. */
+int suiteTearDown( int numFailures )
+{
+    return numFailures;
+}
+
+/* ========================================================================== */
+
+/**
+ * @brief Test @ref Sntp_InitMetrics with invalid parameters.
+ */
+void test_InitMetrics_InvalidParams( void )
+{
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_InitMetrics( NULL, testServerMetrics, 1U ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_InitMetrics( &testMetrics, testServerMetrics, 0U ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_InitMetrics( &testMetrics, NULL, 1U ) );
+
+    /* The statistics of the context alone. */
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_InitMetrics( &testMetrics, NULL, 0U ) );
+    TEST_ASSERT_NULL( testMetrics.pServers );
+}
+
+/**
+ * @brief Test that @ref Sntp_InitMetrics clears all statistics.
+ */
+void test_InitMetrics_Clear( void )
+{
+    testServerMetrics[ 1 ].requests = 5U;
+    testMetrics.context.timeouts = 3U;
+
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_InitMetrics( &testMetrics, testServerMetrics, TEST_NUM_OF_SERVERS ) );
+    TEST_ASSERT_EQUAL( 0U, testServerMetrics[ 1 ].requests );
+    TEST_ASSERT_EQUAL( 0U, testMetrics.context.timeouts );
+    TEST_ASSERT_FALSE( testServerMetrics[ 1 ].isSynchronized );
+    TEST_ASSERT_EQUAL( TEST_NUM_OF_SERVERS, testMetrics.numOfServers );
+}
+
+/**
+ * @brief Test that @ref Sntp_RecordRequestMetrics counts the outcomes of
+ * requests.
+ */
+void test_RecordRequestMetrics( void )
+{
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_RecordRequestMetrics( NULL, 0U, SntpSuccess ) );
+
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_RecordRequestMetrics( &testMetrics, 0U, SntpSuccess ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_RecordRequestMetrics( &testMetrics, 1U, SntpErrorDnsFailure ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_RecordRequestMetrics( &testMetrics, 1U, SntpErrorNetworkFailure ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_RecordRequestMetrics( &testMetrics, 1U, SntpErrorSystemClockFailure ) );
+
+    TEST_ASSERT_EQUAL( 1U, testServerMetrics[ 0 ].requests );
+    TEST_ASSERT_EQUAL( 0U, testServerMetrics[ 1 ].requests );
+    TEST_ASSERT_EQUAL( 1U, testServerMetrics[ 1 ].dnsFailures );
+    TEST_ASSERT_EQUAL( 1U, testServerMetrics[ 1 ].networkErrors );
+    TEST_ASSERT_EQUAL( 1U, testMetrics.context.requests );
+    TEST_ASSERT_EQUAL( 1U, testMetrics.context.dnsFailures );
+    TEST_ASSERT_EQUAL( 1U, testMetrics.context.networkErrors );
+    TEST_ASSERT_EQUAL( 1U, testMetrics.currentServerIndex );
+
+    /* An index without per-server statistics counts for the context only. */
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_RecordRequestMetrics( &testMetrics, TEST_NUM_OF_SERVERS, SntpSuccess ) );
+    TEST_ASSERT_EQUAL( 2U, testMetrics.context.requests );
+    TEST_ASSERT_EQUAL( 1U, testServerMetrics[ 0 ].requests );
+}
+
+/**
+ * @brief Test @ref Sntp_RecordResponseMetrics with invalid parameters.
+ */
+void test_RecordResponseMetrics_InvalidParams( void )
+{
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_RecordResponseMetrics( NULL, 0U, SntpSuccess,
+                                                                          &testResponse, &testRxTime ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_RecordResponseMetrics( &testMetrics, 0U, SntpSuccess,
+                                                                          NULL, &testRxTime ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_RecordResponseMetrics( &testMetrics, 0U, SntpSuccess,
+                                                                          &testResponse, NULL ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_RecordResponseMetrics( &testMetrics, 0U,
+                                                                          SntpRejectedResponseChangeServer,
+                                                                          NULL, NULL ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_RecordResponseMetrics( &testMetrics, 0U,
+                                                                          SntpRejectedResponseRetryWithBackoff,
+                                                                          NULL, NULL ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_RecordResponseMetrics( &testMetrics, 0U,
+                                                                          SntpRejectedResponseOtherCode,
+                                                                          NULL, NULL ) );
+    TEST_ASSERT_EQUAL( 0U, testMetrics.context.acceptedResponses );
+}
+
+/**
+ * @brief Test that @ref Sntp_RecordResponseMetrics counts the outcomes of
+ * responses that are not accepted.
+ */
+void test_RecordResponseMetrics_Failures( void )
+{
+    recordKissOfDeath( SntpRejectedResponseChangeServer, TEST_KISS_CODE_DENY );
+    recordKissOfDeath( SntpRejectedResponseChangeServer, TEST_KISS_CODE_RSTR );
+    recordKissOfDeath( SntpRejectedResponseRetryWithBackoff, TEST_KISS_CODE_RATE );
+    recordKissOfDeath( SntpRejectedResponseOtherCode, TEST_KISS_CODE_OTHER );
+    recordKissOfDeath( SntpRejectedResponseOtherCode, TEST_KISS_CODE_OTHER );
+
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_RecordResponseMetrics( &testMetrics, 1U, SntpErrorBufferTooSmall,
+                                                                NULL, NULL ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_RecordResponseMetrics( &testMetrics, 1U, SntpInvalidResponse,
+                                                                &testResponse, NULL ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_RecordResponseMetrics( &testMetrics, 1U, SntpServerNotAuthenticated,
+                                                                NULL, NULL ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_RecordResponseMetrics( &testMetrics, 1U, SntpRejectedResponseOutlier,
+                                                                &testResponse, &testRxTime ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_RecordResponseMetrics( &testMetrics, 1U, SntpErrorResponseTimeout,
+                                                                NULL, NULL ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_RecordResponseMetrics( &testMetrics, 1U, SntpErrorNetworkFailure,
+                                                                NULL, NULL ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_RecordResponseMetrics( &testMetrics, 1U, SntpNoResponseReceived,
+                                                                NULL, NULL ) );
+
+    TEST_ASSERT_EQUAL( 1U, testServerMetrics[ 1 ].kissOfDeath[ SntpMetricsKissDeny ] );
+    TEST_ASSERT_EQUAL( 1U, testServerMetrics[ 1 ].kissOfDeath[ SntpMetricsKissRstr ] );
+    TEST_ASSERT_EQUAL( 1U, testServerMetrics[ 1 ].kissOfDeath[ SntpMetricsKissRate ] );
+    TEST_ASSERT_EQUAL( 2U, testServerMetrics[ 1 ].kissOfDeath[ SntpMetricsKissOther ] );
+    TEST_ASSERT_EQUAL( 1U, testServerMetrics[ 1 ].invalidResponses[ SntpMetricsInvalidMalformed ] );
+    TEST_ASSERT_EQUAL( 1U, testServerMetrics[ 1 ].invalidResponses[ SntpMetricsInvalidProtocol ] );
+    TEST_ASSERT_EQUAL( 1U, testServerMetrics[ 1 ].invalidResponses[ SntpMetricsInvalidUnauthenticated ] );
+    TEST_ASSERT_EQUAL( 1U, testServerMetrics[ 1 ].invalidResponses[ SntpMetricsInvalidOutlier ] );
+    TEST_ASSERT_EQUAL( 1U, testServerMetrics[ 1 ].timeouts );
+    TEST_ASSERT_EQUAL( 1U, testServerMetrics[ 1 ].networkErrors );
+    TEST_ASSERT_EQUAL( 0U, testServerMetrics[ 1 ].acceptedResponses );
+    TEST_ASSERT_FALSE( testServerMetrics[ 1 ].isSynchronized );
+    TEST_ASSERT_EQUAL( 2U, testMetrics.context.kissOfDeath[ SntpMetricsKissOther ] );
+    TEST_ASSERT_EQUAL( 0U, testServerMetrics[ 0 ].timeouts );
+}
+
+/**
+ * @brief Test that @ref Sntp_RecordResponseMetrics keeps the clock offset,
+ * round-trip delay and stratum of accepted responses.
+ */
+void test_RecordResponseMetrics_Accepted( void )
+{
+    recordOffset( 0U, -( FRACTIONS_PER_SECOND / 2 ) );
+
+    TEST_ASSERT_EQUAL( 1U, testServerMetrics[ 0 ].acceptedResponses );
+    TEST_ASSERT_TRUE( testServerMetrics[ 0 ].isSynchronized );
+    TEST_ASSERT_EQUAL_INT64( -500000000, testServerMetrics[ 0 ].clockOffsetNs );
+    TEST_ASSERT_EQUAL_INT64( 250000000, testServerMetrics[ 0 ].roundTripDelayNs );
+    TEST_ASSERT_EQUAL_INT64( 0, testServerMetrics[ 0 ].jitterNs );
+    TEST_ASSERT_EQUAL( 2U, testServerMetrics[ 0 ].stratum );
+    TEST_ASSERT_EQUAL( 1000U, testServerMetrics[ 0 ].lastSyncTime.seconds );
+    TEST_ASSERT_EQUAL_INT64( -500000000, testMetrics.context.clockOffsetNs );
+
+    /* A response whose clock offset overflows is accepted without one. */
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_RecordResponseMetrics( &testMetrics, 0U, SntpClockOffsetOverflow,
+                                                                &testResponse, &testRxTime ) );
+    TEST_ASSERT_EQUAL( 2U, testServerMetrics[ 0 ].acceptedResponses );
+    TEST_ASSERT_EQUAL_INT64( -500000000, testServerMetrics[ 0 ].clockOffsetNs );
+    TEST_ASSERT_FALSE( testServerMetrics[ 1 ].isSynchronized );
+}
+
+/**
+ * @brief Test the jitter of successive clock offsets.
+ */
+void test_RecordResponseMetrics_Jitter( void )
+{
+    recordOffset( 0U, 0 );
+    recordOffset( 0U, FRACTIONS_PER_SECOND );
+    TEST_ASSERT_EQUAL_UINT64( 250000000000000000U, testServerMetrics[ 0 ].jitterVariance );
+    TEST_ASSERT_EQUAL_INT64( 500000000, testServerMetrics[ 0 ].jitterNs );
+
+    recordOffset( 0U, FRACTIONS_PER_SECOND );
+    TEST_ASSERT_EQUAL_UINT64( 187500000000000000U, testServerMetrics[ 0 ].jitterVariance );
+    TEST_ASSERT_EQUAL_INT64( 433012701, testServerMetrics[ 0 ].jitterNs );
+
+    /* Large differences are limited so that their square does not overflow. */
+    recordOffset( 0U, 10 * FRACTIONS_PER_SECOND );
+    TEST_ASSERT_EQUAL_UINT64( 1293546503533105152U, testServerMetrics[ 0 ].jitterVariance );
+    TEST_ASSERT_EQUAL_INT64( 1137341858, testServerMetrics[ 0 ].jitterNs );
+
+    recordOffset( 0U, -10 * FRACTIONS_PER_SECOND );
+    TEST_ASSERT_TRUE( testServerMetrics[ 0 ].jitterNs > 1137341858 );
+}
+
+/**
+ * @brief Test @ref Sntp_RenderMetrics with invalid parameters.
+ */
+void test_RenderMetrics_InvalidParams( void )
+{
+    size_t length;
+
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_RenderMetrics( NULL, NULL, testText,
+                                                                  sizeof( testText ), &length ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_RenderMetrics( &testMetrics, NULL, NULL,
+                                                                  sizeof( testText ), &length ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_RenderMetrics( &testMetrics, NULL, testText,
+                                                                  sizeof( testText ), NULL ) );
+}
+
+/**
+ * @brief Test the text of the statistics of the context alone.
+ */
+void test_RenderMetrics_Context( void )
+{
+    size_t length;
+
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_InitMetrics( &testMetrics, NULL, 0U ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_RecordRequestMetrics( &testMetrics, 0U, SntpSuccess ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_RenderMetrics( &testMetrics, NULL, testText,
+                                                        sizeof( testText ), &length ) );
+
+    TEST_ASSERT_EQUAL_STRING_LEN( "# HELP sntp_client_requests_total Time requests sent.\n"
+                                  "# TYPE sntp_client_requests_total counter\n"
+                                  "sntp_client_requests_total 1\n"
+                                  "# HELP sntp_client_responses_accepted_total ",
+                                  testText, 169U );
+    TEST_ASSERT_NOT_NULL( strstr( testText, "sntp_client_kiss_of_death_total{code=\"other\"} 0\n" ) );
+    TEST_ASSERT_NOT_NULL( strstr( testText, "sntp_client_current_server_index 0\n" ) );
+
+    /* No server statistics, and no gauges before an accepted response. */
+    TEST_ASSERT_NULL( strstr( testText, "sntp_server_" ) );
+    TEST_ASSERT_NULL( strstr( testText, "\nsntp_client_offset_seconds " ) );
+}
+
+/**
+ * @brief Test the text of the statistics of the servers.
+ */
+void test_RenderMetrics_Servers( void )
+{
+    SntpTimestamp_t currentTime = { 1002U, 0x80000000U };
+
+    recordOffset( 0U, -( FRACTIONS_PER_SECOND / 2 ) );
+    recordKissOfDeath( SntpRejectedResponseRetryWithBackoff, TEST_KISS_CODE_RATE );
+
+    assertRenderedLine( NULL, "sntp_server_requests_total{server=\"time.example.com\"} 0\n" );
+    assertRenderedLine( NULL, "sntp_server_offset_seconds{server=\"time.example.com\"} -0.500000000\n" );
+    assertRenderedLine( NULL, "sntp_client_round_trip_delay_seconds 0.250000000\n" );
+    assertRenderedLine( NULL, "sntp_server_stratum{server=\"time.example.com\"} 2\n" );
+    assertRenderedLine( NULL, "sntp_server_kiss_of_death_total{server=\"pool \\\"a\\\\b\\\"\\n\",code=\"RATE\"} 1\n" );
+    assertRenderedLine( NULL, "sntp_client_current_server_index 1\n" );
+    TEST_ASSERT_NULL( strstr( testText, "last_sync_age_seconds{" ) );
+    TEST_ASSERT_NULL( strstr( testText, "sntp_server_current_server_index" ) );
+
+    /* The age of the last accepted response needs the current time. */
+    assertRenderedLine( &currentTime, "sntp_server_last_sync_age_seconds{server=\"time.example.com\"} 2.500000000\n" );
+    TEST_ASSERT_NULL( strstr( testText, "sntp_server_last_sync_age_seconds{server=\"pool" ) );
+
+    /* A step of system time back is reported as no age. */
+    currentTime.seconds = 999U;
+    assertRenderedLine( &currentTime, "sntp_client_last_sync_age_seconds 0.000000000\n" );
+}
+
+/**
+ * @brief Test that an unnamed server has an empty server label.
+ */
+void test_RenderMetrics_UnnamedServer( void )
+{
+    testServerMetrics[ 1 ].pServerName = NULL;
+
+    assertRenderedLine( NULL, "sntp_server_timeouts_total{server=\"\"} 0\n" );
+}
+
+/**
+ * @brief Test @ref Sntp_RenderMetrics with buffers too small for the text.
+ */
+void test_RenderMetrics_BufferTooSmall( void )
+{
+    size_t length;
+    size_t requiredLength;
+
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_RenderMetrics( &testMetrics, NULL, testText,
+                                                        sizeof( testText ), &requiredLength ) );
+
+    /* The text needs room for the terminating character. */
+    TEST_ASSERT_EQUAL( SntpErrorBufferTooSmall, Sntp_RenderMetrics( &testMetrics, NULL, testText,
+                                                                    requiredLength, &length ) );
+    TEST_ASSERT_EQUAL( requiredLength, length );
+    TEST_ASSERT_EQUAL( requiredLength - 1U, strlen( testText ) );
+
+    testText[ 0 ] = 'x';
+    TEST_ASSERT_EQUAL( SntpErrorBufferTooSmall, Sntp_RenderMetrics( &testMetrics, NULL, testText,
+                                                                    0U, &length ) );
+    TEST_ASSERT_EQUAL( requiredLength, length );
+    TEST_ASSERT_EQUAL( 'x', testText[ 0 ] );
+
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_RenderMetrics( &testMetrics, NULL, testText,
+                                                        requiredLength + 1U, &length ) );
+    TEST_ASSERT_EQUAL( requiredLength, length );
+}
@@ -0,0 +1,262 @@
+/*
+ * coreSNTP v1.0.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Standard includes. */
+#include <string.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/* Unity include. */
+#include "unity.h"
+
+/* coreSNTP Poll Planner API include */
+#include "core_sntp_poll_planner.h"
+#include "core_sntp_fixed_point.h"
+
+/* Number of SNTP timestamp fractions in a second. */
+#define FRACTIONS_PER_SECOND    ( ( int64_t ) 0x100000000 )
+
+/* Poll interval of the tests, in seconds. */
+#define TEST_INTERVAL_SECS      ( 64U )
+
+/* Poll interval of the tests, in SNTP timestamp fractions. */
+#define TEST_INTERVAL           ( ( int64_t ) TEST_INTERVAL_SECS * FRACTIONS_PER_SECOND )
+
+/* Number of devices in the fleet tests. */
+#define FLEET_SIZE              ( 4096U )
+
+/* Number of equal parts of the poll interval in which polls are counted. */
+#define NUM_OF_BUCKETS          ( 16U )
+
+/* Identifier of the device of the tests. */
+#define TEST_DEVICE_ID          "00:1A:2B:3C:4D:5E"
+
+/* Global variables common to test cases. */
+static SntpPollPlanner_t testPlanner;
+static SntpTimestamp_t testTime = { 3900000000U, 0x12345678U };
+
+/* ============================ Helper Functions ============================ */
+
+/* Initializes a planner with the identifier of a device of the fleet. */
+static void initFleetDevice( SntpPollPlanner_t * pPlanner,
+                             uint32_t device,
+                             uint32_t jitterPercent )
+{
+    char deviceId[ 16 ];
+
+    ( void ) snprintf( deviceId, sizeof( deviceId ), "SN-%08u", ( unsigned int ) device );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_InitPollPlanner( pPlanner, deviceId, strlen( deviceId ),
+                                                          TEST_INTERVAL_SECS, jitterPercent ) );
+}
+
+/* Calculates the delay from the test time to the next poll. */
+static int64_t planDelay( SntpPollPlanner_t * pPlanner,
+                          const SntpTimestamp_t * pCurrentTime )
+{
+    SntpTimestamp_t nextPollTime;
+
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_PlanNextPoll( pPlanner, pCurrentTime, &nextPollTime ) );
+
+    return Sntp_FixedDifference( Sntp_FixedFromTimestamp( nextPollTime ),
+                                 Sntp_FixedFromTimestamp( *pCurrentTime ) );
+}
+
+/* ============================   UNITY FIXTURES ============================ */
+
+/* Called before each test method. */
+void setUp()
+{
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_InitPollPlanner( &testPlanner, TEST_DEVICE_ID, strlen( TEST_DEVICE_ID ),
+                                                          TEST_INTERVAL_SECS,
+                                                          SNTP_POLL_PLANNER_DEFAULT_JITTER_PERCENT ) );
+}
+
+/* Called at the beginning of the whole suite. */
+void suiteSetUp()
+{
+}
+
+/* Called at the end of the whole suite. */
+int suiteTearDown( int numFailures )
+{
+    return numFailures;
+}
+
+/* ========================================================================== */
+
+/**
+ * @brief Test the poll planner API functions with invalid parameters.
+ */
+void test_PollPlanner_InvalidParams( void )
+{
+    SntpTimestamp_t nextPollTime;
+
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_InitPollPlanner( NULL, "id", 2U, 64U, 5U ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_InitPollPlanner( &testPlanner, NULL, 2U, 64U, 5U ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_InitPollPlanner( &testPlanner, "id", 2U, 0U, 5U ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter,
+                       Sntp_InitPollPlanner( &testPlanner, "id", 2U, SNTP_POLL_PLANNER_MAX_INTERVAL_SECS + 1U, 5U ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter,
+                       Sntp_InitPollPlanner( &testPlanner, "id", 2U, 64U, SNTP_POLL_PLANNER_MAX_JITTER_PERCENT + 1U ) );
+
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_SetPollPlannerInterval( NULL, 64U ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_SetPollPlannerInterval( &testPlanner, 0U ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter,
+                       Sntp_SetPollPlannerInterval( &testPlanner, SNTP_POLL_PLANNER_MAX_INTERVAL_SECS + 1U ) );
+
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_PlanNextPoll( NULL, &testTime, &nextPollTime ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_PlanNextPoll( &testPlanner, NULL, &nextPollTime ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_PlanNextPoll( &testPlanner, &testTime, NULL ) );
+}
+
+/**
+ * @brief Test that successive polls follow the grid of the device, one per
+ * interval, with a bounded jitter.
+ */
+void test_PollPlanner_SuccessivePolls( void )
+{
+    SntpTimestamp_t pollTime = testTime;
+    SntpFixedTime_t firstSlot;
+    int64_t slotDelay;
+    int64_t delay;
+    uint32_t poll;
+
+    /* Without jitter, the polls are exactly one interval apart. */
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_InitPollPlanner( &testPlanner, TEST_DEVICE_ID, strlen( TEST_DEVICE_ID ),
+                                                          TEST_INTERVAL_SECS, 0U ) );
+    delay = planDelay( &testPlanner, &testTime );
+    TEST_ASSERT_TRUE( ( delay > 0 ) && ( delay <= TEST_INTERVAL ) );
+    firstSlot = Sntp_FixedFromTimestamp( testTime ) + ( uint64_t ) delay;
+    pollTime = Sntp_FixedToTimestamp( firstSlot );
+    TEST_ASSERT_EQUAL_INT64( TEST_INTERVAL, planDelay( &testPlanner, &pollTime ) );
+
+    /* With jitter, each poll is delayed from its slot by up to the jitter. */
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_InitPollPlanner( &testPlanner, TEST_DEVICE_ID, strlen( TEST_DEVICE_ID ),
+                                                          TEST_INTERVAL_SECS, SNTP_POLL_PLANNER_MAX_JITTER_PERCENT ) );
+    pollTime = testTime;
+
+    for( poll = 0U; poll < 100U; poll++ )
+    {
+        delay = planDelay( &testPlanner, &pollTime );
+        pollTime = Sntp_FixedToTimestamp( Sntp_FixedFromTimestamp( pollTime ) + ( uint64_t ) delay );
+        slotDelay = Sntp_FixedDifference( Sntp_FixedFromTimestamp( pollTime ),
+                                          firstSlot + ( ( uint64_t ) poll * ( uint64_t ) TEST_INTERVAL ) );
+
+        TEST_ASSERT_TRUE( slotDelay >= 0 );
+        TEST_ASSERT_TRUE( slotDelay < ( TEST_INTERVAL / 4 ) );
+
+        if( poll > 0U )
+        {
+            TEST_ASSERT_TRUE( delay >= ( ( TEST_INTERVAL * 3 ) / 4 ) );
+        }
+    }
+}
+
+/**
+ * @brief Test that the schedule of a device is deterministic, and that
+ * devices have different phases.
+ */
+void test_PollPlanner_Deterministic( void )
+{
+    SntpPollPlanner_t otherPlanner;
+    uint32_t poll;
+
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_InitPollPlanner( &otherPlanner, TEST_DEVICE_ID, strlen( TEST_DEVICE_ID ),
+                                                          TEST_INTERVAL_SECS,
+                                                          SNTP_POLL_PLANNER_DEFAULT_JITTER_PERCENT ) );
+
+    for( poll = 0U; poll < 10U; poll++ )
+    {
+        TEST_ASSERT_EQUAL_INT64( planDelay( &testPlanner, &testTime ), planDelay( &otherPlanner, &testTime ) );
+    }
+
+    /* A device identifier that differs in one bit. */
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_InitPollPlanner( &otherPlanner, "00:1A:2B:3C:4D:5F",
+                                                          strlen( TEST_DEVICE_ID ), TEST_INTERVAL_SECS,
+                                                          SNTP_POLL_PLANNER_DEFAULT_JITTER_PERCENT ) );
+    TEST_ASSERT_TRUE( planDelay( &testPlanner, &testTime ) != planDelay( &otherPlanner, &testTime ) );
+}
+
+/**
+ * @brief Test that the first polls of a fleet of devices that start together
+ * are spread evenly over the poll interval.
+ */
+void test_PollPlanner_FleetSpread( void )
+{
+    uint32_t buckets[ NUM_OF_BUCKETS ] = { 0U };
+    SntpPollPlanner_t planner;
+    uint32_t device;
+    uint32_t bucket;
+    int64_t delay;
+
+    for( device = 0U; device < FLEET_SIZE; device++ )
+    {
+        initFleetDevice( &planner, device, SNTP_POLL_PLANNER_DEFAULT_JITTER_PERCENT );
+        delay = planDelay( &planner, &testTime );
+
+        TEST_ASSERT_TRUE( delay > 0 );
+        TEST_ASSERT_TRUE( delay < ( TEST_INTERVAL + ( TEST_INTERVAL / 20 ) ) );
+
+        buckets[ ( uint32_t ) ( delay / ( TEST_INTERVAL / NUM_OF_BUCKETS ) ) % NUM_OF_BUCKETS ]++;
+    }
+
+    /* Each part of the interval gets its share of the polls, within 25 %. */
+    for( bucket = 0U; bucket < NUM_OF_BUCKETS; bucket++ )
+    {
+        TEST_ASSERT_UINT32_WITHIN( ( FLEET_SIZE / NUM_OF_BUCKETS ) / 4U, FLEET_SIZE / NUM_OF_BUCKETS,
+                                   buckets[ bucket ] );
+    }
+}
+
+/**
+ * @brief Test that a device keeps the relative position of its phase when the
+ * poll interval changes.
+ */
+void test_PollPlanner_ChangeInterval( void )
+{
+    SntpTimestamp_t startOfGrid = { 0U, 0U };
+    int64_t delay;
+
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_InitPollPlanner( &testPlanner, TEST_DEVICE_ID, strlen( TEST_DEVICE_ID ),
+                                                          TEST_INTERVAL_SECS, 0U ) );
+
+    /* From the start of the SNTP era, the delay is the phase of the device. */
+    delay = planDelay( &testPlanner, &startOfGrid );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_SetPollPlannerInterval( &testPlanner, 2U * TEST_INTERVAL_SECS ) );
+    TEST_ASSERT_INT64_WITHIN( 1, 2 * delay, planDelay( &testPlanner, &startOfGrid ) );
+}
+
+/**
+ * @brief Test the planning of a poll across the SNTP era wrap-around.
+ */
+void test_PollPlanner_EraWrapAround( void )
+{
+    SntpTimestamp_t endOfEra = { UINT32_MAX, UINT32_MAX };
+    SntpTimestamp_t nextPollTime;
+
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_PlanNextPoll( &testPlanner, &endOfEra, &nextPollTime ) );
+
+    /* The next poll is in era 1, within an interval and its jitter. */
+    TEST_ASSERT_TRUE( nextPollTime.seconds < ( TEST_INTERVAL_SECS + ( TEST_INTERVAL_SECS / 20U ) ) );
+}
@@ -74,6 +74,9 @@
 #define YEARS_20_IN_SECONDS                        ( ( 20 * 365 + 20 / 4 ) * 24 * 3600 )
 #define YEARS_40_IN_SECONDS                        ( ( 40 * 365 + 40 / 4 ) * 24 * 3600 )
 
+/* Number of SNTP timestamp fractions in a second. */
+#define FRACTIONS_PER_SECOND                       ( ( int64_t ) 0x100000000 )
+
 /* Macro utility to convert the fixed-size Kiss-o'-Death ASCII code
  * to integer.*/
 #define INTEGER_VAL_OF_KOD_CODE( codePtr )                 \
@@ -155,9 +158,22 @@ static void testClockOffsetCalculation( SntpTimestamp_t * clientTxTime,
      * clock-offset could not be calculated. */
     TEST_ASSERT_EQUAL( expectedClockOffset, parsedData.clockOffsetSec );
 
+    /* Make sure that the full resolution clock offset agrees with the seconds
+     * value as the test cases use equal fractions part in all timestamps. */
+    if( expectedClockOffset == SNTP_CLOCK_OFFSET_OVERFLOW )
+    {
+        TEST_ASSERT_EQUAL_INT64( 0, parsedData.clockOffsetFractions );
+    }
+    else
+    {
+        TEST_ASSERT_EQUAL_INT64( expectedClockOffset * FRACTIONS_PER_SECOND,
+                                 parsedData.clockOffsetFractions );
+    }
+
     /* Validate other fields in the output parameter. */
     TEST_ASSERT_EQUAL( 0, memcmp( &parsedData.serverTime, serverTxTime, sizeof( SntpTimestamp_t ) ) );
     TEST_ASSERT_EQUAL( NoLeapSecond, parsedData.leapSecondType );
+    TEST_ASSERT_EQUAL( SNTP_PACKET_STRATUM_SECONDARY_SERVER, parsedData.stratum );
     TEST_ASSERT_EQUAL( SNTP_KISS_OF_DEATH_CODE_NONE, parsedData.rejectedResponseCode );
 }
 
@@ -268,6 +284,46 @@ void test_SerializeRequest_NominalCase( void )
 }
 
 
+/**
+ * @brief Validate the byte order of the serialized request and parsed response
+ * with timestamps of distinct bytes, at an unaligned offset in the buffers.
+ */
+void test_SerializeDeserialize_ByteOrder( void )
+{
+    SntpTimestamp_t requestTime = { 0x01020304U, 0x05060000U };
+    SntpTimestamp_t serverTime = { 0x01020305U, 0x090A0B0CU };
+    SntpTimestamp_t responseRxTime = { 0x01020306U, 0x0D0E0F10U };
+    uint8_t unalignedBuffer[ SNTP_PACKET_BASE_SIZE + 1U ];
+    uint8_t * pPacket = &unalignedBuffer[ 1 ];
+    const uint8_t expectedTxTime[ 8 ] = { 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08 };
+
+    /* The random bits fill the lowest 16 bits of the fractions. */
+    TEST_ASSERT_EQUAL( SntpSuccess,
+                       Sntp_SerializeRequest( &requestTime, 0x07080000U, pPacket, SNTP_PACKET_BASE_SIZE ) );
+    TEST_ASSERT_EQUAL_UINT8_ARRAY( expectedTxTime, &pPacket[ SNTP_PACKET_TX_TIMESTAMP_FIRST_BYTE_POS ], 8U );
+    TEST_ASSERT_EQUAL_HEX32( 0x05060708U, requestTime.fractions );
+
+    fillValidSntpResponseData( pPacket, &requestTime );
+    addTimestampToResponseBuffer( &serverTime, pPacket, SNTP_PACKET_RX_TIMESTAMP_FIRST_BYTE_POS );
+    addTimestampToResponseBuffer( &serverTime, pPacket, SNTP_PACKET_TX_TIMESTAMP_FIRST_BYTE_POS );
+    pPacket[ SNTP_PACKET_STRATUM_BYTE_POS ] = SNTP_PACKET_STRATUM_KOD;
+    memcpy( &pPacket[ SNTP_PACKET_KOD_CODE_FIRST_BYTE_POS ], KOD_CODE_OTHER_EXAMPLE_1, 4U );
+
+    TEST_ASSERT_EQUAL( SntpRejectedResponseOtherCode,
+                       Sntp_DeserializeResponse( &requestTime, &responseRxTime, pPacket,
+                                                 SNTP_PACKET_BASE_SIZE, &parsedData ) );
+    TEST_ASSERT_EQUAL_HEX32( INTEGER_VAL_OF_KOD_CODE( KOD_CODE_OTHER_EXAMPLE_1 ),
+                             parsedData.rejectedResponseCode );
+
+    /* An accepted response parses the server transmit time. */
+    pPacket[ SNTP_PACKET_STRATUM_BYTE_POS ] = SNTP_PACKET_STRATUM_SECONDARY_SERVER;
+    TEST_ASSERT_EQUAL( SntpSuccess,
+                       Sntp_DeserializeResponse( &requestTime, &responseRxTime, pPacket,
+                                                 SNTP_PACKET_BASE_SIZE, &parsedData ) );
+    TEST_ASSERT_EQUAL_HEX32( serverTime.seconds, parsedData.serverTime.seconds );
+    TEST_ASSERT_EQUAL_HEX32( serverTime.fractions, parsedData.serverTime.fractions );
+}
+
 /**
  * @brief Test @ref Sntp_DeserializeResponse with invalid parameters.
  */
@@ -419,6 +475,7 @@ void test_DeserializeResponse_KoD_packets( void )
          * KoD code. */                                       \
         TEST_ASSERT_EQUAL( INTEGER_VAL_OF_KOD_CODE( code ),   \
                            parsedData.rejectedResponseCode ); \
+        TEST_ASSERT_EQUAL( 0U, parsedData.stratum );          \
                                                               \
     } while( 0 )
 
@@ -527,6 +584,135 @@ void test_DeserializeResponse_AcceptedResponse_Nominal_Case( void )
                                 SntpSuccess, expectedOffset );
 }
 
+/**
+ * @brief Test that @ref Sntp_DeserializeResponse API calculates the clock offset
+ * with sub-second resolution in the #SntpResponseData_t.clockOffsetFractions
+ * member, including when the timestamps lie in different SNTP eras.
+ */
+void test_DeserializeResponse_AcceptedResponse_SubSecondOffset( void )
+{
+    SntpTimestamp_t clientTxTime = { 1000, 0 };
+    SntpTimestamp_t serverRxTime = { 1000, 0x80000000 };
+    SntpTimestamp_t serverTxTime = { 1000, 0xC0000000 };
+    SntpTimestamp_t clientRxTime = { 1000, 0x40000000 };
+
+    fillValidSntpResponseData( testBuffer, &clientTxTime );
+    addTimestampToResponseBuffer( &serverRxTime,
+                                  testBuffer,
+                                  SNTP_PACKET_RX_TIMESTAMP_FIRST_BYTE_POS );
+    addTimestampToResponseBuffer( &serverTxTime,
+                                  testBuffer,
+                                  SNTP_PACKET_TX_TIMESTAMP_FIRST_BYTE_POS );
+
+    /* Offset = [ ( T2 - T1 ) + ( T3 - T4 ) ] / 2 = [ 0.5 + 0.5 ] / 2 = 0.5 seconds. */
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_DeserializeResponse( &clientTxTime,
+                                                              &clientRxTime,
+                                                              testBuffer,
+                                                              sizeof( testBuffer ),
+                                                              &parsedData ) );
+    TEST_ASSERT_EQUAL( 0, parsedData.clockOffsetSec );
+    TEST_ASSERT_EQUAL_INT64( FRACTIONS_PER_SECOND / 2, parsedData.clockOffsetFractions );
+
+    /* Test a negative sub-second offset by swapping the client and server times. */
+    clientTxTime.fractions = 0x80000000;
+    serverRxTime.fractions = 0;
+    serverTxTime.fractions = 0x40000000;
+    clientRxTime.fractions = 0xC0000000;
+    fillValidSntpResponseData( testBuffer, &clientTxTime );
+    addTimestampToResponseBuffer( &serverRxTime,
+                                  testBuffer,
+                                  SNTP_PACKET_RX_TIMESTAMP_FIRST_BYTE_POS );
+    addTimestampToResponseBuffer( &serverTxTime,
+                                  testBuffer,
+                                  SNTP_PACKET_TX_TIMESTAMP_FIRST_BYTE_POS );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_DeserializeResponse( &clientTxTime,
+                                                              &clientRxTime,
+                                                              testBuffer,
+                                                              sizeof( testBuffer ),
+                                                              &parsedData ) );
+    TEST_ASSERT_EQUAL_INT64( -FRACTIONS_PER_SECOND / 2, parsedData.clockOffsetFractions );
+
+    /* Test when the client time is at the end of SNTP era 0 and the server
+     * time is at the beginning of SNTP era 1. */
+    clientTxTime.seconds = UINT32_MAX;
+    clientTxTime.fractions = 0xF0000000;
+    clientRxTime = clientTxTime;
+    serverRxTime.seconds = 0;
+    serverRxTime.fractions = 0x10000000;
+    serverTxTime = serverRxTime;
+    fillValidSntpResponseData( testBuffer, &clientTxTime );
+    addTimestampToResponseBuffer( &serverRxTime,
+                                  testBuffer,
+                                  SNTP_PACKET_RX_TIMESTAMP_FIRST_BYTE_POS );
+    addTimestampToResponseBuffer( &serverTxTime,
+                                  testBuffer,
+                                  SNTP_PACKET_TX_TIMESTAMP_FIRST_BYTE_POS );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_DeserializeResponse( &clientTxTime,
+                                                              &clientRxTime,
+                                                              testBuffer,
+                                                              sizeof( testBuffer ),
+                                                              &parsedData ) );
+    TEST_ASSERT_EQUAL_INT64( FRACTIONS_PER_SECOND / 8, parsedData.clockOffsetFractions );
+}
+
+/**
+ * @brief Test that @ref Sntp_DeserializeResponse API calculates the round-trip
+ * delay of the request and response, excluding the server processing time.
+ */
+void test_DeserializeResponse_AcceptedResponse_RoundTripDelay( void )
+{
+    SntpTimestamp_t clientTxTime = { UINT32_MAX, 0xC0000000 };
+    SntpTimestamp_t serverRxTime = { 5000, 0 };
+    SntpTimestamp_t serverTxTime = { 5000, 0x40000000 };
+    SntpTimestamp_t clientRxTime = { 1, 0 };
+
+    fillValidSntpResponseData( testBuffer, &clientTxTime );
+    addTimestampToResponseBuffer( &serverRxTime,
+                                  testBuffer,
+                                  SNTP_PACKET_RX_TIMESTAMP_FIRST_BYTE_POS );
+    addTimestampToResponseBuffer( &serverTxTime,
+                                  testBuffer,
+                                  SNTP_PACKET_TX_TIMESTAMP_FIRST_BYTE_POS );
+
+    /* Delay = ( T4 - T1 ) - ( T3 - T2 ) = 1.25 - 0.25 = 1 second, with the
+     * client timestamps in different SNTP eras. */
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_DeserializeResponse( &clientTxTime,
+                                                              &clientRxTime,
+                                                              testBuffer,
+                                                              sizeof( testBuffer ),
+                                                              &parsedData ) );
+    TEST_ASSERT_EQUAL_INT64( FRACTIONS_PER_SECOND, parsedData.roundTripDelayFractions );
+
+    /* The delay is calculated even when the clock offset overflows. */
+    serverRxTime.seconds = clientRxTime.seconds + ( UINT32_MAX / 2U );
+    serverTxTime.seconds = serverRxTime.seconds;
+    addTimestampToResponseBuffer( &serverRxTime,
+                                  testBuffer,
+                                  SNTP_PACKET_RX_TIMESTAMP_FIRST_BYTE_POS );
+    addTimestampToResponseBuffer( &serverTxTime,
+                                  testBuffer,
+                                  SNTP_PACKET_TX_TIMESTAMP_FIRST_BYTE_POS );
+    TEST_ASSERT_EQUAL( SntpClockOffsetOverflow, Sntp_DeserializeResponse( &clientTxTime,
+                                                                          &clientRxTime,
+                                                                          testBuffer,
+                                                                          sizeof( testBuffer ),
+                                                                          &parsedData ) );
+    TEST_ASSERT_EQUAL_INT64( FRACTIONS_PER_SECOND, parsedData.roundTripDelayFractions );
+
+    /* A server processing time longer than the round-trip time results in
+     * zero delay. */
+    serverTxTime.seconds = serverRxTime.seconds + 2U;
+    addTimestampToResponseBuffer( &serverTxTime,
+                                  testBuffer,
+                                  SNTP_PACKET_TX_TIMESTAMP_FIRST_BYTE_POS );
+    TEST_ASSERT_EQUAL( SntpClockOffsetOverflow, Sntp_DeserializeResponse( &clientTxTime,
+                                                                          &clientRxTime,
+                                                                          testBuffer,
+                                                                          sizeof( testBuffer ),
+                                                                          &parsedData ) );
+    TEST_ASSERT_EQUAL_INT64( 0, parsedData.roundTripDelayFractions );
+}
+
 /**
  * @brief Test that @ref Sntp_DeserializeResponse API can de-serialize leap-second
  * information in an accepted SNTP response packet from a server.
@@ -576,6 +762,262 @@ void test_DeserializeResponse_AcceptedResponse_LeapSecond( void )
     TEST_LEAP_SECOND_DESERIALIZATION( LastMinuteHas59Seconds );
 }
 
+/**
+ * @brief Test @ref Sntp_SerializeRequestVector with invalid parameters.
+ */
+void test_SerializeRequestVector_InvalidParams( void )
+{
+    SntpTimestamp_t testTime = TEST_TIMESTAMP;
+    uint8_t macBuffer[ 20 ];
+    SntpIoVector_t segments[ 2 ] =
+    {
+        { testBuffer, sizeof( testBuffer ) },
+        { macBuffer,  sizeof( macBuffer )  }
+    };
+    size_t packetSize = 0U;
+
+    /* Pass invalid packet size. */
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter,
+                       Sntp_SerializeRequestVector( &testTime, 0U, segments, 2U, NULL ) );
+
+    /* Pass invalid segments. */
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter,
+                       Sntp_SerializeRequestVector( &testTime, 0U, NULL, 2U, &packetSize ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter,
+                       Sntp_SerializeRequestVector( &testTime, 0U, segments, 0U, &packetSize ) );
+
+    /* Pass a first segment without memory. */
+    segments[ 0 ].pBase = NULL;
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter,
+                       Sntp_SerializeRequestVector( &testTime, 0U, segments, 2U, &packetSize ) );
+    segments[ 0 ].pBase = testBuffer;
+
+    /* Pass a later segment of non-zero size without memory. */
+    segments[ 1 ].pBase = NULL;
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter,
+                       Sntp_SerializeRequestVector( &testTime, 0U, segments, 2U, &packetSize ) );
+    segments[ 1 ].pBase = macBuffer;
+
+    /* Pass a segment whose size is not a multiple of 4 bytes. */
+    segments[ 1 ].length = sizeof( macBuffer ) - 2U;
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter,
+                       Sntp_SerializeRequestVector( &testTime, 0U, segments, 2U, &packetSize ) );
+    segments[ 1 ].length = sizeof( macBuffer );
+
+    /* Pass a first segment larger than the packet header. */
+    segments[ 0 ].length = SNTP_PACKET_BASE_SIZE + 4U;
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter,
+                       Sntp_SerializeRequestVector( &testTime, 0U, segments, 2U, &packetSize ) );
+
+    /* Pass a first segment smaller than the packet header. */
+    segments[ 0 ].length = SNTP_PACKET_BASE_SIZE - 4U;
+    TEST_ASSERT_EQUAL( SntpErrorBufferTooSmall,
+                       Sntp_SerializeRequestVector( &testTime, 0U, segments, 2U, &packetSize ) );
+    segments[ 0 ].length = sizeof( testBuffer );
+
+    /* Pass invalid time object. */
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter,
+                       Sntp_SerializeRequestVector( NULL, 0U, segments, 2U, &packetSize ) );
+
+    /* Check that the packet size is not updated on failure. */
+    TEST_ASSERT_EQUAL( 0U, packetSize );
+}
+
+/**
+ * @brief Validate that @ref Sntp_SerializeRequestVector serializes the packet
+ * header into the first segment, and leaves the other segments untouched.
+ */
+void test_SerializeRequestVector_NominalCase( void )
+{
+    SntpTimestamp_t vectorTime = TEST_TIMESTAMP;
+    SntpTimestamp_t contiguousTime = TEST_TIMESTAMP;
+    const uint32_t randomVal = 0xAABBCCDD;
+    uint8_t expectedHeader[ SNTP_PACKET_BASE_SIZE ];
+    uint8_t extensionField[ 16 ];
+    uint8_t expectedExtensionField[ 16 ];
+    uint8_t macBuffer[ 20 ];
+    uint8_t expectedMac[ 20 ];
+    SntpIoVector_t segments[ 4 ] =
+    {
+        { testBuffer,     sizeof( testBuffer )     },
+        { extensionField, sizeof( extensionField ) },
+        { NULL,           0U                       },
+        { macBuffer,      sizeof( macBuffer )      }
+    };
+    size_t packetSize = 0U;
+
+    memset( extensionField, 0xA5, sizeof( extensionField ) );
+    memset( expectedExtensionField, 0xA5, sizeof( expectedExtensionField ) );
+    memset( macBuffer, 0x5A, sizeof( macBuffer ) );
+    memset( expectedMac, 0x5A, sizeof( expectedMac ) );
+
+    TEST_ASSERT_EQUAL( SntpSuccess,
+                       Sntp_SerializeRequest( &contiguousTime,
+                                              randomVal,
+                                              expectedHeader,
+                                              sizeof( expectedHeader ) ) );
+
+    /* Call the API under test. */
+    TEST_ASSERT_EQUAL( SntpSuccess,
+                       Sntp_SerializeRequestVector( &vectorTime,
+                                                    randomVal,
+                                                    segments,
+                                                    4U,
+                                                    &packetSize ) );
+
+    /* The header and request time match those of the contiguous serialization. */
+    TEST_ASSERT_EQUAL_UINT8_ARRAY( expectedHeader, testBuffer, SNTP_PACKET_BASE_SIZE );
+    TEST_ASSERT_EQUAL( 0, memcmp( &contiguousTime, &vectorTime, sizeof( SntpTimestamp_t ) ) );
+
+    /* The extension field and MAC are not modified. */
+    TEST_ASSERT_EQUAL_UINT8_ARRAY( expectedExtensionField, extensionField, sizeof( extensionField ) );
+    TEST_ASSERT_EQUAL_UINT8_ARRAY( expectedMac, macBuffer, sizeof( macBuffer ) );
+
+    TEST_ASSERT_EQUAL( SNTP_PACKET_BASE_SIZE + sizeof( extensionField ) + sizeof( macBuffer ), packetSize );
+}
+
+/**
+ * @brief Test @ref Sntp_DeserializeResponseVector with invalid parameters.
+ */
+void test_DeserializeResponseVector_InvalidParams( void )
+{
+    SntpTimestamp_t testTime = TEST_TIMESTAMP;
+    uint8_t macBuffer[ 20 ];
+    SntpIoVector_t segments[ 2 ] =
+    {
+        { testBuffer, 20U },
+        { macBuffer,  sizeof( macBuffer ) }
+    };
+
+    fillValidSntpResponseData( testBuffer, &testTime );
+
+    /* Pass invalid segments. */
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter,
+                       Sntp_DeserializeResponseVector( &testTime, &testTime, NULL, 2U,
+                                                       SNTP_PACKET_BASE_SIZE, &parsedData, NULL ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter,
+                       Sntp_DeserializeResponseVector( &testTime, &testTime, segments, 0U,
+                                                       SNTP_PACKET_BASE_SIZE, &parsedData, NULL ) );
+
+    /* Pass a later segment of non-zero size without memory. */
+    segments[ 1 ].pBase = NULL;
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter,
+                       Sntp_DeserializeResponseVector( &testTime, &testTime, segments, 2U,
+                                                       SNTP_PACKET_BASE_SIZE, &parsedData, NULL ) );
+    segments[ 1 ].pBase = macBuffer;
+
+    /* Receive fewer bytes than the packet header into segments that can hold it. */
+    segments[ 0 ].length = sizeof( testBuffer );
+    TEST_ASSERT_EQUAL( SntpErrorBufferTooSmall,
+                       Sntp_DeserializeResponseVector( &testTime, &testTime, segments, 2U,
+                                                       SNTP_PACKET_BASE_SIZE - 1U, &parsedData, NULL ) );
+    segments[ 0 ].length = 20U;
+
+    /* Segments smaller than the packet header. */
+    TEST_ASSERT_EQUAL( SntpErrorBufferTooSmall,
+                       Sntp_DeserializeResponseVector( &testTime, &testTime, segments, 1U,
+                                                       SNTP_PACKET_BASE_SIZE, &parsedData, NULL ) );
+
+    /* Pass invalid time object and output parameter. */
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter,
+                       Sntp_DeserializeResponseVector( NULL, &testTime, segments, 2U,
+                                                       SNTP_PACKET_BASE_SIZE, &parsedData, NULL ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter,
+                       Sntp_DeserializeResponseVector( &testTime, &testTime, segments, 2U,
+                                                       SNTP_PACKET_BASE_SIZE, NULL, NULL ) );
+}
+
+/**
+ * @brief Validate that @ref Sntp_DeserializeResponseVector parses the packet
+ * header in place, or gathered across segments, as the contiguous API does.
+ */
+void test_DeserializeResponseVector_NominalCase( void )
+{
+    SntpTimestamp_t clientTxTime = TEST_TIMESTAMP;
+    SntpTimestamp_t serverTime = { clientTxTime.seconds + 3U, 0x12345678U };
+    SntpTimestamp_t clientRxTime = { clientTxTime.seconds + 1U, clientTxTime.fractions };
+    SntpResponseData_t expectedData;
+    uint8_t packet[ SNTP_PACKET_BASE_SIZE + 20U ];
+    SntpIoVector_t segments[ 4 ];
+    SntpPacketTail_t tail;
+
+    fillValidSntpResponseData( packet, &clientTxTime );
+    addTimestampToResponseBuffer( &serverTime, packet, SNTP_PACKET_RX_TIMESTAMP_FIRST_BYTE_POS );
+    addTimestampToResponseBuffer( &serverTime, packet, SNTP_PACKET_TX_TIMESTAMP_FIRST_BYTE_POS );
+    memset( &packet[ SNTP_PACKET_BASE_SIZE ], 0x5A, 20U );
+
+    TEST_ASSERT_EQUAL( SntpSuccess,
+                       Sntp_DeserializeResponse( &clientTxTime, &clientRxTime, packet,
+                                                 SNTP_PACKET_BASE_SIZE, &expectedData ) );
+
+    /* Header in place in the first segment, followed by the MAC. */
+    segments[ 0 ].pBase = packet;
+    segments[ 0 ].length = SNTP_PACKET_BASE_SIZE;
+    segments[ 1 ].pBase = &packet[ SNTP_PACKET_BASE_SIZE ];
+    segments[ 1 ].length = 20U;
+    TEST_ASSERT_EQUAL( SntpSuccess,
+                       Sntp_DeserializeResponseVector( &clientTxTime, &clientRxTime, segments, 2U,
+                                                       sizeof( packet ), &parsedData, &tail ) );
+    TEST_ASSERT_EQUAL( 0, memcmp( &expectedData, &parsedData, sizeof( parsedData ) ) );
+    TEST_ASSERT_EQUAL( 1U, tail.segmentIndex );
+    TEST_ASSERT_EQUAL( 0U, tail.offset );
+    TEST_ASSERT_EQUAL( 20U, tail.length );
+
+    /* Whole packet in the first segment, with the MAC after the header. */
+    segments[ 0 ].length = sizeof( packet );
+    TEST_ASSERT_EQUAL( SntpSuccess,
+                       Sntp_DeserializeResponseVector( &clientTxTime, &clientRxTime, segments, 1U,
+                                                       sizeof( packet ), &parsedData, &tail ) );
+    TEST_ASSERT_EQUAL( 0U, tail.segmentIndex );
+    TEST_ASSERT_EQUAL( SNTP_PACKET_BASE_SIZE, tail.offset );
+    TEST_ASSERT_EQUAL( 20U, tail.length );
+
+    /* Only the received bytes after the header are counted. */
+    TEST_ASSERT_EQUAL( SntpSuccess,
+                       Sntp_DeserializeResponseVector( &clientTxTime, &clientRxTime, segments, 1U,
+                                                       SNTP_PACKET_BASE_SIZE + 8U, &parsedData, NULL ) );
+    TEST_ASSERT_EQUAL( SntpSuccess,
+                       Sntp_DeserializeResponseVector( &clientTxTime, &clientRxTime, segments, 1U,
+                                                       SNTP_PACKET_BASE_SIZE + 8U, &parsedData, &tail ) );
+    TEST_ASSERT_EQUAL( 8U, tail.length );
+
+    /* Header split across segments, including an empty segment. */
+    segments[ 0 ].length = 20U;
+    segments[ 1 ].pBase = NULL;
+    segments[ 1 ].length = 0U;
+    segments[ 2 ].pBase = &packet[ 20 ];
+    segments[ 2 ].length = 16U;
+    segments[ 3 ].pBase = &packet[ 36 ];
+    segments[ 3 ].length = sizeof( packet ) - 36U;
+    memset( &parsedData, 0, sizeof( parsedData ) );
+    TEST_ASSERT_EQUAL( SntpSuccess,
+                       Sntp_DeserializeResponseVector( &clientTxTime, &clientRxTime, segments, 4U,
+                                                       sizeof( packet ), &parsedData, &tail ) );
+    TEST_ASSERT_EQUAL( 0, memcmp( &expectedData, &parsedData, sizeof( parsedData ) ) );
+    TEST_ASSERT_EQUAL( 3U, tail.segmentIndex );
+    TEST_ASSERT_EQUAL( 12U, tail.offset );
+    TEST_ASSERT_EQUAL( 20U, tail.length );
+
+    /* The validation of the response applies to the gathered header. */
+    packet[ 0 ] = SNTP_PACKET_VERSION_VAL | SNTP_PACKET_MODE_CLIENT;
+    TEST_ASSERT_EQUAL( SntpInvalidResponse,
+                       Sntp_DeserializeResponseVector( &clientTxTime, &clientRxTime, segments, 4U,
+                                                       sizeof( packet ), &parsedData, &tail ) );
+
+    /* The bytes after the header are located for a rejected response too. */
+    TEST_ASSERT_EQUAL( 3U, tail.segmentIndex );
+    TEST_ASSERT_EQUAL( 12U, tail.offset );
+
+    /* Without bytes after the header, the location is past the last segment. */
+    segments[ 3 ].length = 12U;
+    TEST_ASSERT_EQUAL( SntpInvalidResponse,
+                       Sntp_DeserializeResponseVector( &clientTxTime, &clientRxTime, segments, 4U,
+                                                       sizeof( packet ), &parsedData, &tail ) );
+    TEST_ASSERT_EQUAL( 4U, tail.segmentIndex );
+    TEST_ASSERT_EQUAL( 0U, tail.offset );
+    TEST_ASSERT_EQUAL( 0U, tail.length );
+}
+
 /**
  * @brief Tests the @ref Sntp_CalculatePollInterval utility function returns
  * error for invalid parameters passed to the API.
@@ -744,3 +1186,134 @@ void test_ConvertToUnixTime_Nominal( void )
                                   INT32_MAX, /* Unix Seconds */
                                   0 /* Unix Microseconds */ );
 }
+
+/**
+ * @brief Tests the @ref Sntp_ConvertToUnixTime64 utility function returns
+ * expected error when invalid parameters are passed.
+ */
+void test_ConvertToUnixTime64_InvalidParams( void )
+{
+    SntpTimestamp_t sntpTime = TEST_TIMESTAMP;
+    int64_t unixTimeSecs;
+    uint32_t unixTimeNanosecs;
+
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_ConvertToUnixTime64( NULL,
+                                                                        SNTP_DEFAULT_ERA_PIVOT_UNIX_SECS,
+                                                                        &unixTimeSecs,
+                                                                        &unixTimeNanosecs ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_ConvertToUnixTime64( &sntpTime,
+                                                                        SNTP_DEFAULT_ERA_PIVOT_UNIX_SECS,
+                                                                        NULL,
+                                                                        &unixTimeNanosecs ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_ConvertToUnixTime64( &sntpTime,
+                                                                        SNTP_DEFAULT_ERA_PIVOT_UNIX_SECS,
+                                                                        &unixTimeSecs,
+                                                                        NULL ) );
+
+    /* Pivot times outside the supported range. */
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_ConvertToUnixTime64( &sntpTime,
+                                                                        SNTP_MAX_ERA_PIVOT_UNIX_SECS + 1,
+                                                                        &unixTimeSecs,
+                                                                        &unixTimeNanosecs ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_ConvertToUnixTime64( &sntpTime,
+                                                                        -SNTP_MAX_ERA_PIVOT_UNIX_SECS - 1,
+                                                                        &unixTimeSecs,
+                                                                        &unixTimeNanosecs ) );
+}
+
+/**
+ * @brief Tests the @ref Sntp_ConvertToUnixTime64 utility function resolves
+ * the SNTP era relative to the pivot time, and converts fractions to
+ * nanoseconds.
+ */
+void test_ConvertToUnixTime64_Nominal( void )
+{
+    SntpTimestamp_t sntpTime = TEST_TIMESTAMP;
+    int64_t unixTimeSecs;
+    uint32_t unixTimeNanosecs;
+
+#define TEST_SNTP_TO_UNIX64_CONVERSION( sntpTimeSecs, sntpTimeFracs, pivot,                \
+                                        expectedUnixTimeSecs, expectedUnixTimeNs )         \
+    do {                                                                                   \
+        sntpTime.seconds = sntpTimeSecs;                                                   \
+        sntpTime.fractions = sntpTimeFracs;                                                \
+                                                                                           \
+        TEST_ASSERT_EQUAL( SntpSuccess, Sntp_ConvertToUnixTime64( &sntpTime,               \
+                                                                  pivot,                   \
+                                                                  &unixTimeSecs,           \
+                                                                  &unixTimeNanosecs ) );   \
+        TEST_ASSERT_EQUAL_INT64( ( int64_t ) ( expectedUnixTimeSecs ), unixTimeSecs );     \
+        TEST_ASSERT_EQUAL_UINT32( expectedUnixTimeNs, unixTimeNanosecs );                  \
+    } while( 0 )
+
+    /* UNIX epoch, and the nanoseconds conversion. */
+    TEST_SNTP_TO_UNIX64_CONVERSION( SNTP_TIME_AT_UNIX_EPOCH_SECS, 0U,
+                                    SNTP_DEFAULT_ERA_PIVOT_UNIX_SECS, 0, 0U );
+    TEST_SNTP_TO_UNIX64_CONVERSION( SNTP_TIME_AT_UNIX_EPOCH_SECS + 1000U, 0x80000000U,
+                                    SNTP_DEFAULT_ERA_PIVOT_UNIX_SECS, 1000, 500000000U );
+    TEST_SNTP_TO_UNIX64_CONVERSION( SNTP_TIME_AT_UNIX_EPOCH_SECS, UINT32_MAX,
+                                    SNTP_DEFAULT_ERA_PIVOT_UNIX_SECS, 0, 999999999U );
+
+    /* Times before the UNIX epoch are negative. */
+    TEST_SNTP_TO_UNIX64_CONVERSION( SNTP_TIME_AT_UNIX_EPOCH_SECS - 1U, 0U,
+                                    SNTP_DEFAULT_ERA_PIVOT_UNIX_SECS, -1, 0U );
+
+    /* The default pivot resolves timestamps after 7 Feb 2036 to SNTP era 1. */
+    TEST_SNTP_TO_UNIX64_CONVERSION( 0U, 0U,
+                                    SNTP_DEFAULT_ERA_PIVOT_UNIX_SECS,
+                                    UNIX_TIME_SECS_AT_SNTP_ERA_1_SMALLEST_TIME, 0U );
+    TEST_SNTP_TO_UNIX64_CONVERSION( SNTP_TIME_AT_LARGEST_UNIX_TIME_SECS + 1U, 0U,
+                                    SNTP_DEFAULT_ERA_PIVOT_UNIX_SECS,
+                                    ( int64_t ) INT32_MAX + 1, 0U );
+
+    /* A pivot in 2100 resolves timestamps past 2106 (the 32-bit unsigned UNIX
+     * time limit) in SNTP era 1. */
+    TEST_SNTP_TO_UNIX64_CONVERSION( SNTP_TIME_AT_UNIX_EPOCH_SECS, 0U,
+                                    ( int64_t ) 4102444800,
+                                    ( int64_t ) UINT32_MAX + 1, 0U );
+
+    /* A pivot in 1900 resolves timestamps to SNTP era 0. */
+    TEST_SNTP_TO_UNIX64_CONVERSION( 0U, 0U,
+                                    -( int64_t ) SNTP_TIME_AT_UNIX_EPOCH_SECS,
+                                    -( int64_t ) SNTP_TIME_AT_UNIX_EPOCH_SECS, 0U );
+}
+
+/**
+ * @brief Tests the @ref Sntp_ConvertFromUnixTime64 utility function.
+ */
+void test_ConvertFromUnixTime64( void )
+{
+    SntpTimestamp_t sntpTime;
+    int64_t unixTimeSecs;
+    uint32_t unixTimeNanosecs;
+    uint32_t nanosecs;
+
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_ConvertFromUnixTime64( 0, 0U, NULL ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_ConvertFromUnixTime64( 0, 1000000000U, &sntpTime ) );
+
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_ConvertFromUnixTime64( 1000, 500000000U, &sntpTime ) );
+    TEST_ASSERT_EQUAL_UINT32( SNTP_TIME_AT_UNIX_EPOCH_SECS + 1000U, sntpTime.seconds );
+    TEST_ASSERT_EQUAL_UINT32( 0x80000000U, sntpTime.fractions );
+
+    /* Times in SNTP era 1 wrap around the seconds. */
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_ConvertFromUnixTime64( ( int64_t ) UINT32_MAX + 1, 0U, &sntpTime ) );
+    TEST_ASSERT_EQUAL_UINT32( SNTP_TIME_AT_UNIX_EPOCH_SECS, sntpTime.seconds );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_ConvertFromUnixTime64( UNIX_TIME_SECS_AT_SNTP_ERA_1_SMALLEST_TIME, 0U, &sntpTime ) );
+    TEST_ASSERT_EQUAL_UINT32( 0U, sntpTime.seconds );
+
+    /* Times before the UNIX epoch. */
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_ConvertFromUnixTime64( -( int64_t ) SNTP_TIME_AT_UNIX_EPOCH_SECS, 0U, &sntpTime ) );
+    TEST_ASSERT_EQUAL_UINT32( 0U, sntpTime.seconds );
+
+    /* The nanoseconds survive a round trip through SNTP fractions. */
+    for( nanosecs = 0U; nanosecs < 1000000000U; nanosecs += 999983U )
+    {
+        TEST_ASSERT_EQUAL( SntpSuccess, Sntp_ConvertFromUnixTime64( 1000, nanosecs, &sntpTime ) );
+        TEST_ASSERT_EQUAL( SntpSuccess, Sntp_ConvertToUnixTime64( &sntpTime,
+                                                                  SNTP_DEFAULT_ERA_PIVOT_UNIX_SECS,
+                                                                  &unixTimeSecs,
+                                                                  &unixTimeNanosecs ) );
+        TEST_ASSERT_EQUAL_INT64( 1000, unixTimeSecs );
+        TEST_ASSERT_EQUAL_UINT32( nanosecs, unixTimeNanosecs );
+    }
+}
@@ -0,0 +1,325 @@
+/*
+ * coreSNTP v1.0.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Standard includes. */
+#include <string.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+/* Unity include. */
+#include "unity.h"
+
+/* coreSNTP Clock Stability API include */
+#include "core_sntp_stability.h"
+
+/* Number of SNTP timestamp fractions in a millisecond. */
+#define FRACTIONS_PER_MS            ( ( int64_t ) 0x100000000 / 1000 )
+
+/* Number of SNTP timestamp fractions per second for a 1 PPM frequency error. */
+#define FRACTIONS_PER_PPM           ( ( int64_t ) 0x100000000 / 1000000 )
+
+/* Local time used as the starting time in tests. */
+#define TEST_LOCAL_TIME_SECS        ( SNTP_TIME_AT_UNIX_EPOCH_SECS + 1000U )
+
+/* Sampling interval used in tests. */
+#define TEST_INTERVAL_SECS          ( 16U )
+
+/* Number of samples for every level of the estimator to report its estimate. */
+#define TEST_SAMPLES_FOR_ALL_TAUS    ( ( SNTP_STABILITY_MIN_SAMPLES + 2U ) << ( SNTP_STABILITY_NUM_TAUS - 1U ) )
+
+/* Global variables common to test cases. */
+static SntpStabilityEstimator_t testEstimator;
+static SntpTimestamp_t testLocalTime;
+static uint32_t randomState;
+
+/* ============================ Helper Functions ============================ */
+
+/* Feeds a sample to the test estimator, and advances the local time by the
+ * passed interval in milliseconds. */
+static void feedSample( int64_t clockOffset,
+                        uint32_t intervalMs )
+{
+    uint64_t localTime;
+
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_UpdateStabilityEstimator( &testEstimator,
+                                                                   &testLocalTime,
+                                                                   clockOffset ) );
+
+    localTime = ( ( uint64_t ) testLocalTime.seconds << 32 ) | testLocalTime.fractions;
+    localTime += ( ( uint64_t ) intervalMs << 32 ) / 1000U;
+    testLocalTime.seconds = ( uint32_t ) ( localTime >> 32 );
+    testLocalTime.fractions = ( uint32_t ) localTime;
+}
+
+/* Generates a pseudo-random clock offset noise within +/- the passed amplitude
+ * in milliseconds. */
+static int64_t randomNoise( uint32_t amplitudeMs )
+{
+    randomState = ( randomState * 1103515245U ) + 12345U;
+
+    return ( ( int64_t ) ( ( randomState >> 8 ) % ( 2U * amplitudeMs * 1000U ) ) -
+             ( int64_t ) ( amplitudeMs * 1000U ) ) * ( FRACTIONS_PER_MS / 1000 );
+}
+
+/* ============================   UNITY FIXTURES ============================ */
+
+/* Called before each test method. */
+void setUp()
+{
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_InitStabilityEstimator( &testEstimator ) );
+    testLocalTime.seconds = TEST_LOCAL_TIME_SECS;
+    testLocalTime.fractions = 0U;
+    randomState = 1U;
+}
+
+/* Called at the beginning of the whole suite. */
+void suiteSetUp()
+{
+}
+
+/* Called at the end of the whole suite. */
+int suiteTearDown( int numFailures )
+{
+    return numFailures;
+}
+
+/* ========================================================================== */
+
+/**
+ * @brief Test the clock stability API functions with invalid parameters.
+ */
+void test_Stability_InvalidParams( void )
+{
+    uint64_t tauMs, allanDeviation;
+    uint32_t pollInterval;
+
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_InitStabilityEstimator( NULL ) );
+
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_UpdateStabilityEstimator( NULL, &testLocalTime, 0 ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_UpdateStabilityEstimator( &testEstimator, NULL, 0 ) );
+
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_MarkStabilityDiscontinuity( NULL ) );
+
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_GetAllanDeviation( NULL, 0U, &tauMs, &allanDeviation ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_GetAllanDeviation( &testEstimator,
+                                                                      SNTP_STABILITY_NUM_TAUS,
+                                                                      &tauMs, &allanDeviation ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_GetAllanDeviation( &testEstimator, 0U,
+                                                                      NULL, &allanDeviation ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_GetAllanDeviation( &testEstimator, 0U,
+                                                                      &tauMs, NULL ) );
+
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_CalculateAdaptivePollInterval( NULL, 1U, &pollInterval ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_CalculateAdaptivePollInterval( &testEstimator,
+                                                                                  0U, &pollInterval ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_CalculateAdaptivePollInterval( &testEstimator,
+                                                                                  1U, NULL ) );
+}
+
+/**
+ * @brief Test that the estimates are reported once a level has
+ * #SNTP_STABILITY_MIN_SAMPLES frequency differences.
+ */
+void test_Stability_InsufficientSamples( void )
+{
+    uint64_t tauMs, allanDeviation;
+    uint32_t pollInterval;
+    uint32_t i;
+
+    /* The first two samples measure the first frequency, and every later
+     * sample measures a frequency difference. */
+    for( i = 0U; i < ( SNTP_STABILITY_MIN_SAMPLES + 1U ); i++ )
+    {
+        feedSample( 0, TEST_INTERVAL_SECS * 1000U );
+    }
+
+    TEST_ASSERT_EQUAL( SntpInsufficientSamples, Sntp_GetAllanDeviation( &testEstimator, 0U,
+                                                                        &tauMs, &allanDeviation ) );
+    TEST_ASSERT_EQUAL( SntpInsufficientSamples, Sntp_CalculateAdaptivePollInterval( &testEstimator,
+                                                                                    1U, &pollInterval ) );
+
+    feedSample( 0, TEST_INTERVAL_SECS * 1000U );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_GetAllanDeviation( &testEstimator, 0U, &tauMs, &allanDeviation ) );
+    TEST_ASSERT_EQUAL( SntpInsufficientSamples, Sntp_GetAllanDeviation( &testEstimator, 1U,
+                                                                        &tauMs, &allanDeviation ) );
+}
+
+/**
+ * @brief Test that a constant frequency error of the local clock results in
+ * zero Allan deviation at every averaging time, which are the powers of 2
+ * multiples of the sampling interval.
+ */
+void test_Stability_ConstantFrequency( void )
+{
+    uint64_t tauMs, allanDeviation;
+    int64_t clockOffset = -( 1000 * FRACTIONS_PER_MS );
+    uint32_t i;
+
+    for( i = 0U; i < TEST_SAMPLES_FOR_ALL_TAUS; i++ )
+    {
+        feedSample( clockOffset, TEST_INTERVAL_SECS * 1000U );
+        clockOffset += 100 * FRACTIONS_PER_PPM * ( int64_t ) TEST_INTERVAL_SECS;
+    }
+
+    for( i = 0U; i < SNTP_STABILITY_NUM_TAUS; i++ )
+    {
+        TEST_ASSERT_EQUAL( SntpSuccess, Sntp_GetAllanDeviation( &testEstimator, i, &tauMs, &allanDeviation ) );
+        TEST_ASSERT_EQUAL_UINT64( ( uint64_t ) TEST_INTERVAL_SECS * 1000U << i, tauMs );
+
+        /* The frequency is measured with a resolution of 1 nanosecond per interval. */
+        TEST_ASSERT_LESS_OR_EQUAL_UINT64( 1000U, allanDeviation );
+    }
+
+    /* The frequency error is 100 PPM in parts per trillion, within the
+     * truncation of the test constant. */
+    TEST_ASSERT_INT64_WITHIN( 100000, 100000000, testEstimator.levels[ 0 ].lastFrequency );
+}
+
+/**
+ * @brief Test the Allan deviation of white phase noise, which decreases with
+ * the averaging time.
+ */
+void test_Stability_AlternatingOffset( void )
+{
+    uint64_t tauMs, allanDeviation;
+    uint32_t i;
+
+    /* Offsets alternate by 1 ms between samples, so the frequency alternates
+     * by +/- 1 ms per 16 seconds (62.5 PPM), and the Allan deviation at the
+     * sampling interval is ( 2 * 62.5 PPM ) / sqrt( 2 ). Every other sample has
+     * the same offset, so the longer averaging times have zero deviation. */
+    for( i = 0U; i < TEST_SAMPLES_FOR_ALL_TAUS; i++ )
+    {
+        feedSample( ( ( i % 2U ) == 0U ) ? 0 : FRACTIONS_PER_MS, TEST_INTERVAL_SECS * 1000U );
+    }
+
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_GetAllanDeviation( &testEstimator, 0U, &tauMs, &allanDeviation ) );
+    TEST_ASSERT_UINT64_WITHIN( 10000U, 88388347U, allanDeviation );
+
+    for( i = 1U; i < SNTP_STABILITY_NUM_TAUS; i++ )
+    {
+        TEST_ASSERT_EQUAL( SntpSuccess, Sntp_GetAllanDeviation( &testEstimator, i, &tauMs, &allanDeviation ) );
+        TEST_ASSERT_EQUAL_UINT64( 0U, allanDeviation );
+    }
+}
+
+/**
+ * @brief Test that changes in clock offset beyond 0.1% of the interval, and
+ * marked discontinuities, do not affect the estimates.
+ */
+void test_Stability_Discontinuity( void )
+{
+    uint64_t tauMs, allanDeviation;
+    int64_t clockOffset = 0;
+    uint32_t i;
+
+    for( i = 0U; i < TEST_SAMPLES_FOR_ALL_TAUS; i++ )
+    {
+        /* Step the offset by 10 seconds every 10 samples. */
+        if( ( i % 10U ) == 9U )
+        {
+            clockOffset += 10000 * FRACTIONS_PER_MS;
+        }
+
+        /* Step the offset by 10 milliseconds every 7 samples, and mark the
+         * discontinuity. */
+        if( ( i % 7U ) == 6U )
+        {
+            clockOffset += 10 * FRACTIONS_PER_MS;
+            TEST_ASSERT_EQUAL( SntpSuccess, Sntp_MarkStabilityDiscontinuity( &testEstimator ) );
+        }
+
+        feedSample( clockOffset, TEST_INTERVAL_SECS * 1000U );
+    }
+
+    /* A local time before the last sample is also a discontinuity. */
+    testLocalTime.seconds -= 1000U;
+    feedSample( clockOffset, 0U );
+
+    /* The longer averaging times are interrupted by the discontinuities before
+     * they measure enough frequency differences. */
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_GetAllanDeviation( &testEstimator, 0U, &tauMs, &allanDeviation ) );
+    TEST_ASSERT_EQUAL_UINT64( 0U, allanDeviation );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_GetAllanDeviation( &testEstimator, 1U, &tauMs, &allanDeviation ) );
+    TEST_ASSERT_EQUAL_UINT64( 0U, allanDeviation );
+    TEST_ASSERT_EQUAL( SntpInsufficientSamples, Sntp_GetAllanDeviation( &testEstimator,
+                                                                        SNTP_STABILITY_NUM_TAUS - 1U,
+                                                                        &tauMs, &allanDeviation ) );
+}
+
+/**
+ * @brief Test that the adaptive poll interval is the longest averaging time
+ * within the desired accuracy.
+ */
+void test_Stability_AdaptivePollInterval( void )
+{
+    uint32_t pollInterval;
+    uint32_t i;
+
+    /* With alternating offsets, only the shortest averaging time has a time
+     * error of ( 16 seconds * 88 PPM ), i.e. about 1.4 milliseconds. */
+    for( i = 0U; i < TEST_SAMPLES_FOR_ALL_TAUS; i++ )
+    {
+        feedSample( ( ( i % 2U ) == 0U ) ? 0 : FRACTIONS_PER_MS, TEST_INTERVAL_SECS * 1000U );
+    }
+
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_CalculateAdaptivePollInterval( &testEstimator, 1U, &pollInterval ) );
+    TEST_ASSERT_EQUAL_UINT32( TEST_INTERVAL_SECS << ( SNTP_STABILITY_NUM_TAUS - 1U ), pollInterval );
+
+    /* With random offsets of +/- 5 milliseconds, the time error is a few
+     * milliseconds at every averaging time. */
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_InitStabilityEstimator( &testEstimator ) );
+
+    for( i = 0U; i < TEST_SAMPLES_FOR_ALL_TAUS; i++ )
+    {
+        feedSample( randomNoise( 5U ), TEST_INTERVAL_SECS * 1000U );
+    }
+
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_CalculateAdaptivePollInterval( &testEstimator, 1U, &pollInterval ) );
+    TEST_ASSERT_EQUAL_UINT32( TEST_INTERVAL_SECS, pollInterval );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_CalculateAdaptivePollInterval( &testEstimator, UINT16_MAX,
+                                                                        &pollInterval ) );
+    TEST_ASSERT_EQUAL_UINT32( TEST_INTERVAL_SECS << ( SNTP_STABILITY_NUM_TAUS - 1U ), pollInterval );
+
+    /* The poll interval is rounded down to a power of 2. */
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_InitStabilityEstimator( &testEstimator ) );
+
+    for( i = 0U; i < ( SNTP_STABILITY_MIN_SAMPLES + 2U ); i++ )
+    {
+        feedSample( randomNoise( 5U ), 23000U );
+    }
+
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_CalculateAdaptivePollInterval( &testEstimator, 1U, &pollInterval ) );
+    TEST_ASSERT_EQUAL_UINT32( 16U, pollInterval );
+
+    /* Averaging times below a second are not supported. */
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_InitStabilityEstimator( &testEstimator ) );
+
+    for( i = 0U; i < ( SNTP_STABILITY_MIN_SAMPLES + 2U ); i++ )
+    {
+        feedSample( randomNoise( 1U ) / 10, 500U );
+    }
+
+    TEST_ASSERT_EQUAL( SntpZeroPollInterval, Sntp_CalculateAdaptivePollInterval( &testEstimator, 1U,
+                                                                                 &pollInterval ) );
+}
@@ -0,0 +1,203 @@
+/*
+ * coreSNTP v1.0.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Standard includes. */
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Unity include. */
+#include "unity.h"
+
+/* coreSNTP Response Timeout Estimator API include */
+#include "core_sntp_timeout.h"
+
+/* Number of SNTP timestamp fractions in a second. */
+#define FRACTIONS_PER_SECOND    ( ( int64_t ) 0x100000000 )
+
+/* Converts a duration in microseconds to SNTP timestamp fractions, rounded up
+ * so that it converts back exactly. */
+#define US_TO_FRACTIONS( us )    ( ( ( ( int64_t ) ( us ) * FRACTIONS_PER_SECOND ) + 999999 ) / 1000000 )
+
+/* Default response timeout of the tests, in milliseconds. */
+#define TEST_DEFAULT_TIMEOUT_MS    ( 5000U )
+
+/* Global variables common to test cases. */
+static SntpTimeoutEstimator_t testEstimator;
+
+/* ============================ Helper Functions ============================ */
+
+/* Updates the estimator of the tests with a latency in microseconds. */
+static void updateLatency( uint32_t latencyUs )
+{
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_UpdateTimeoutEstimator( &testEstimator, US_TO_FRACTIONS( latencyUs ) ) );
+}
+
+/* Reads the timeout of the estimator of the tests. */
+static uint32_t getTimeout( void )
+{
+    uint32_t timeoutMs = 0U;
+
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_GetResponseTimeout( &testEstimator, TEST_DEFAULT_TIMEOUT_MS, &timeoutMs ) );
+
+    return timeoutMs;
+}
+
+/* ============================   UNITY FIXTURES ============================ */
+
+/* Called before each test method. */
+void setUp()
+{
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_InitTimeoutEstimators( &testEstimator, 1U ) );
+}
+
+/* Called at the beginning of the whole suite. */
+void suiteSetUp()
+{
+}
+
+/* Called at the end of the whole suite. */
+int suiteTearDown( int numFailures )
+{
+    return numFailures;
+}
+
+/* ========================================================================== */
+
+/**
+ * @brief Test the APIs with invalid parameters.
+ */
+void test_Timeout_InvalidParams( void )
+{
+    uint32_t timeoutMs;
+
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_InitTimeoutEstimators( NULL, 1U ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_InitTimeoutEstimators( &testEstimator, 0U ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_UpdateTimeoutEstimator( NULL, 0 ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_UpdateTimeoutEstimator( &testEstimator, -1 ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_BackOffTimeoutEstimator( NULL ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_GetResponseTimeout( NULL, 0U, &timeoutMs ) );
+    TEST_ASSERT_EQUAL( SntpErrorBadParameter, Sntp_GetResponseTimeout( &testEstimator, 0U, NULL ) );
+
+    /* A rejected latency does not change the estimator. */
+    TEST_ASSERT_EQUAL( TEST_DEFAULT_TIMEOUT_MS, getTimeout() );
+}
+
+/**
+ * @brief Test the timeout of the first response latency, and of a server
+ * without any latency.
+ */
+void test_Timeout_FirstLatency( void )
+{
+    /* The default timeout is used until a latency is measured, and backing off
+     * does not change it. */
+    TEST_ASSERT_EQUAL( TEST_DEFAULT_TIMEOUT_MS, getTimeout() );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_BackOffTimeoutEstimator( &testEstimator ) );
+    TEST_ASSERT_EQUAL( TEST_DEFAULT_TIMEOUT_MS, getTimeout() );
+
+    /* The first latency counts as the round-trip time, with a variation of
+     * half of it: 100 + 4 * 50 milliseconds. */
+    updateLatency( 100000U );
+    TEST_ASSERT_EQUAL( 100000U, testEstimator.smoothedRttUs );
+    TEST_ASSERT_EQUAL( 50000U, testEstimator.rttVariationUs );
+    TEST_ASSERT_EQUAL( 300U, getTimeout() );
+
+    /* The timeout is rounded up to whole milliseconds. */
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_InitTimeoutEstimators( &testEstimator, 1U ) );
+    updateLatency( 33333U );
+    TEST_ASSERT_EQUAL( 100U, getTimeout() );
+}
+
+/**
+ * @brief Test that a server on the local network gets the lowest timeout.
+ */
+void test_Timeout_LocalNetwork( void )
+{
+    uint32_t i;
+
+    for( i = 0U; i < 50U; i++ )
+    {
+        updateLatency( 300U + ( ( i % 2U ) * 200U ) );
+        TEST_ASSERT_EQUAL( SNTP_TIMEOUT_MIN_MS, getTimeout() );
+    }
+
+    TEST_ASSERT_UINT32_WITHIN( 100U, 400U, testEstimator.smoothedRttUs );
+}
+
+/**
+ * @brief Test that the timeout of a distant server with a varying latency
+ * stays above its latencies.
+ */
+void test_Timeout_WideAreaNetwork( void )
+{
+    uint32_t latencyUs;
+    uint32_t i;
+
+    for( i = 0U; i < 200U; i++ )
+    {
+        /* Latencies between 150 and 290 milliseconds. */
+        latencyUs = 150000U + ( ( ( i * 7U ) % 8U ) * 20000U );
+        updateLatency( latencyUs );
+        TEST_ASSERT_GREATER_THAN( latencyUs / 1000U, getTimeout() );
+    }
+
+    TEST_ASSERT_UINT32_WITHIN( 20000U, 220000U, testEstimator.smoothedRttUs );
+    TEST_ASSERT_LESS_THAN( 600U, getTimeout() );
+
+    /* A spike of the latency raises the variation, and so the timeout. */
+    updateLatency( 600000U );
+    TEST_ASSERT_GREATER_THAN( 600U, getTimeout() );
+}
+
+/**
+ * @brief Test the limits of the timeout, and the doubling of the timeout after
+ * a timeout.
+ */
+void test_Timeout_BackOff( void )
+{
+    updateLatency( 100000U );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_BackOffTimeoutEstimator( &testEstimator ) );
+    TEST_ASSERT_EQUAL( 600U, getTimeout() );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_BackOffTimeoutEstimator( &testEstimator ) );
+    TEST_ASSERT_EQUAL( 1200U, getTimeout() );
+
+    /* The next latency ends the doubling. */
+    updateLatency( 100000U );
+    TEST_ASSERT_LESS_THAN( 300U, getTimeout() );
+
+    /* The doubled timeout is limited. */
+    while( getTimeout() < SNTP_TIMEOUT_MAX_MS )
+    {
+        TEST_ASSERT_EQUAL( SntpSuccess, Sntp_BackOffTimeoutEstimator( &testEstimator ) );
+    }
+
+    TEST_ASSERT_EQUAL( SNTP_TIMEOUT_MAX_MS, getTimeout() );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_BackOffTimeoutEstimator( &testEstimator ) );
+    TEST_ASSERT_EQUAL( SNTP_TIMEOUT_MAX_MS, getTimeout() );
+
+    /* So is the timeout of a very long latency, which is itself limited to
+     * the range of the estimator. */
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_InitTimeoutEstimators( &testEstimator, 1U ) );
+    TEST_ASSERT_EQUAL( SntpSuccess, Sntp_UpdateTimeoutEstimator( &testEstimator, INT64_MAX ) );
+    TEST_ASSERT_EQUAL( UINT32_MAX, testEstimator.smoothedRttUs );
+    TEST_ASSERT_EQUAL( SNTP_TIMEOUT_MAX_MS, getTimeout() );
+}
@@ -0,0 +1,1054 @@
+/*
+ * coreSNTP v1.0.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file sntp_pcap_analyzer.c
+ * @brief Offline analyzer of captured NTP traffic.
+ *
+ * The analyzer streams a pcap or pcapng file, pairs client requests with server
+ * responses, runs each response through @ref Sntp_DeserializeResponse, and
+ * prints the clock offset, round-trip delay and Kiss-o'-Death statistics of
+ * each server.
+ *
+ * The capture is read by one thread, which decodes the NTP packets and hands
+ * them to worker threads by a hash of their flow (client and server addresses
+ * and ports), so that a request and its response are always handled by the same
+ * worker. Each worker has fixed-size tables of outstanding requests and of
+ * server statistics, so a capture of any size is analyzed in constant memory.
+ *
+ * The clock offset is that of the client clock: the request time is the
+ * transmit timestamp of the request, and the response receive time is the
+ * request time advanced by the time between the capture of the request and of
+ * the response. The capture should be taken on or near the clients for accurate
+ * delays.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+/* POSIX includes. */
+#include <pthread.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+
+/* Include coreSNTP Serializer header. */
+#include "core_sntp_serializer.h"
+
+/* Include reader header. */
+#include "sntp_pcap_reader.h"
+
+/**
+ * @brief The UDP port of NTP.
+ */
+#define NTP_PORT                  ( 123U )
+
+/**
+ * @brief The NTP modes of client requests and server responses.
+ */
+#define NTP_MODE_CLIENT           ( 3U )
+#define NTP_MODE_SERVER           ( 4U )
+
+/**
+ * @brief The offsets of the timestamps in an NTP packet.
+ */
+#define NTP_ORIGIN_TIME_OFFSET    ( 24U )
+#define NTP_TX_TIME_OFFSET        ( 40U )
+
+/**
+ * @brief The largest number of worker threads.
+ */
+#define MAX_WORKERS               ( 64U )
+
+/**
+ * @brief The number of packets handed to a worker at a time, and the number of
+ * batches queued for each worker.
+ */
+#define BATCH_SIZE                ( 512U )
+#define BATCHES_PER_WORKER        ( 8U )
+
+/**
+ * @brief The number of buckets, and the entries in each, of the table of
+ * outstanding requests of each worker.
+ */
+#define PENDING_BUCKETS           ( 16384U )
+#define PENDING_WAYS              ( 4U )
+
+/**
+ * @brief The time after which an outstanding request is considered
+ * unanswered, and its entry can be reused.
+ */
+#define PENDING_TIMEOUT_NS        ( ( int64_t ) 10 * NANOSECONDS_PER_SECOND )
+
+/**
+ * @brief The number of servers for which separate statistics are kept. The
+ * statistics of further servers are combined.
+ */
+#define MAX_SERVERS               ( 4096U )
+
+/**
+ * @brief The number of nanoseconds in a second.
+ */
+#define NANOSECONDS_PER_SECOND    ( ( int64_t ) 1000000000 )
+
+/**
+ * @brief The number of SNTP timestamp fractions in a second.
+ */
+#define FRACTIONS_PER_SECOND      ( 4294967296.0 )
+
+/**
+ * @brief Kiss-o'-Death codes that are counted separately.
+ */
+#define KOD_CODE( a, b, c, d )    ( ( ( uint32_t ) ( a ) << 24 ) | ( ( uint32_t ) ( b ) << 16 ) | \
+                                    ( ( uint32_t ) ( c ) << 8 ) | ( uint32_t ) ( d ) )
+#define KOD_DENY                  KOD_CODE( 'D', 'E', 'N', 'Y' )
+#define KOD_RSTR                  KOD_CODE( 'R', 'S', 'T', 'R' )
+#define KOD_RATE                  KOD_CODE( 'R', 'A', 'T', 'E' )
+
+/**
+ * @brief An IPv4 or IPv6 address.
+ */
+typedef struct NtpAddress
+{
+    uint8_t family;        /**< @brief 4 or 6, or 0 for the combined statistics. */
+    uint8_t bytes[ 16 ];   /**< @brief The address, of 4 or 16 bytes. */
+} NtpAddress_t;
+
+/**
+ * @brief A decoded NTP packet.
+ */
+typedef struct NtpEvent
+{
+    int64_t captureTimeNs;                      /**< @brief The capture time. */
+    NtpAddress_t client;                        /**< @brief The client address. */
+    NtpAddress_t server;                        /**< @brief The server address. */
+    uint16_t clientPort;                        /**< @brief The client UDP port. */
+    uint16_t serverPort;                        /**< @brief The server UDP port. */
+    bool isRequest;                             /**< @brief Whether the packet is a request. */
+    uint8_t payload[ SNTP_PACKET_BASE_SIZE ];   /**< @brief The NTP packet. */
+} NtpEvent_t;
+
+/**
+ * @brief A batch of packets handed to a worker.
+ */
+typedef struct EventBatch
+{
+    size_t count;                     /**< @brief The number of packets. */
+    NtpEvent_t events[ BATCH_SIZE ];  /**< @brief The packets. */
+} EventBatch_t;
+
+/**
+ * @brief An outstanding request.
+ */
+typedef struct PendingRequest
+{
+    bool inUse;                /**< @brief Whether the entry holds a request. */
+    NtpAddress_t client;       /**< @brief The client address. */
+    NtpAddress_t server;       /**< @brief The server address. */
+    uint16_t clientPort;       /**< @brief The client UDP port. */
+    uint16_t serverPort;       /**< @brief The server UDP port. */
+    uint8_t txTime[ 8 ];       /**< @brief The transmit timestamp of the request. */
+    int64_t captureTimeNs;     /**< @brief The capture time of the request. */
+} PendingRequest_t;
+
+/**
+ * @brief Running statistics of a series of values (Welford's algorithm).
+ */
+typedef struct RunningStats
+{
+    uint64_t count;  /**< @brief The number of values. */
+    double mean;     /**< @brief The mean of the values. */
+    double m2;       /**< @brief The sum of squared differences from the mean. */
+    double min;      /**< @brief The smallest value. */
+    double max;      /**< @brief The largest value. */
+} RunningStats_t;
+
+/**
+ * @brief The statistics of a server.
+ */
+typedef struct ServerStats
+{
+    bool inUse;                  /**< @brief Whether the entry holds a server. */
+    NtpAddress_t address;        /**< @brief The server address. */
+    uint64_t requests;           /**< @brief The requests sent to the server. */
+    uint64_t responses;          /**< @brief The responses paired with a request. */
+    uint64_t unanswered;         /**< @brief The requests without a response. */
+    uint64_t unmatched;          /**< @brief The responses without a request. */
+    uint64_t invalid;            /**< @brief The responses rejected as invalid. */
+    uint64_t offsetOverflows;    /**< @brief The responses with an offset over 34 years. */
+    uint64_t kodDeny;            /**< @brief The DENY Kiss-o'-Death responses. */
+    uint64_t kodRstr;            /**< @brief The RSTR Kiss-o'-Death responses. */
+    uint64_t kodRate;            /**< @brief The RATE Kiss-o'-Death responses. */
+    uint64_t kodOther;           /**< @brief The other Kiss-o'-Death responses. */
+    RunningStats_t offsetMs;     /**< @brief The clock offsets, in milliseconds. */
+    RunningStats_t delayMs;      /**< @brief The round-trip delays, in milliseconds. */
+} ServerStats_t;
+
+/**
+ * @brief A table of server statistics.
+ */
+typedef struct ServerTable
+{
+    ServerStats_t entries[ MAX_SERVERS ]; /**< @brief The servers, by address hash. */
+    ServerStats_t others;                 /**< @brief The combined statistics of the
+                                           * servers that do not fit. */
+} ServerTable_t;
+
+/**
+ * @brief A worker thread and its queue of batches.
+ */
+typedef struct Worker
+{
+    pthread_t thread;                                /**< @brief The thread. */
+    pthread_mutex_t lock;                            /**< @brief The lock of the queue. */
+    pthread_cond_t changed;                          /**< @brief Signalled when the queue changes. */
+    EventBatch_t batches[ BATCHES_PER_WORKER ];      /**< @brief The ring of batches. The batch after
+                                                      * the queued ones is filled by the reader. */
+    size_t head;                                     /**< @brief The first queued batch. */
+    size_t queued;                                   /**< @brief The number of queued batches. */
+    size_t tail;                                     /**< @brief The batch filled by the reader,
+                                                      * which only the reader uses. */
+    bool done;                                       /**< @brief Whether the reader has finished. */
+    PendingRequest_t ( * pPending )[ PENDING_WAYS ]; /**< @brief The outstanding requests. */
+    ServerTable_t * pServers;                        /**< @brief The server statistics. */
+} Worker_t;
+
+/**
+ * @brief Calculates the FNV-1a hash of bytes, continuing from a previous hash.
+ */
+static uint32_t hashBytes( uint32_t hash,
+                           const uint8_t * pBytes,
+                           size_t length )
+{
+    size_t i;
+
+    for( i = 0U; i < length; i++ )
+    {
+        hash = ( hash ^ pBytes[ i ] ) * 16777619U;
+    }
+
+    return hash;
+}
+
+/**
+ * @brief Calculates the hash of the flow of a request or response.
+ */
+static uint32_t hashFlow( const NtpAddress_t * pClient,
+                          const NtpAddress_t * pServer,
+                          uint16_t clientPort,
+                          uint16_t serverPort )
+{
+    uint8_t ports[ 4 ];
+    uint32_t hash = 2166136261U;
+
+    ports[ 0 ] = ( uint8_t ) ( clientPort >> 8 );
+    ports[ 1 ] = ( uint8_t ) clientPort;
+    ports[ 2 ] = ( uint8_t ) ( serverPort >> 8 );
+    ports[ 3 ] = ( uint8_t ) serverPort;
+
+    hash = hashBytes( hash, ( const uint8_t * ) pClient, sizeof( NtpAddress_t ) );
+    hash = hashBytes( hash, ( const uint8_t * ) pServer, sizeof( NtpAddress_t ) );
+
+    return hashBytes( hash, ports, sizeof( ports ) );
+}
+
+/**
+ * @brief Reads a big-endian 16-bit value.
+ */
+static uint16_t readBigEndian16( const uint8_t * pData )
+{
+    return ( uint16_t ) ( ( ( uint16_t ) pData[ 0 ] << 8 ) | pData[ 1 ] );
+}
+
+/**
+ * @brief Reads a big-endian 32-bit value.
+ */
+static uint32_t readBigEndian32( const uint8_t * pData )
+{
+    return ( ( uint32_t ) pData[ 0 ] << 24 ) | ( ( uint32_t ) pData[ 1 ] << 16 ) |
+           ( ( uint32_t ) pData[ 2 ] << 8 ) | pData[ 3 ];
+}
+
+/**
+ * @brief Decodes a captured packet into an NTP event, if it is an NTP client
+ * request or server response over UDP.
+ *
+ * @param[in] pPacket The captured packet.
+ * @param[out] pEvent The decoded packet.
+ *
+ * @return `true` if the packet is an NTP request or response.
+ */
+static bool decodePacket( const PcapPacket_t * pPacket,
+                          NtpEvent_t * pEvent )
+{
+    const uint8_t * pData = pPacket->pData;
+    size_t length = pPacket->capturedLength;
+    size_t offset = 0U;
+    uint16_t etherType = 0U;
+    uint8_t version;
+    uint8_t protocol = 0U;
+    size_t headerLength;
+    uint16_t sourcePort;
+    uint16_t destinationPort;
+    uint8_t mode;
+    NtpAddress_t source;
+    NtpAddress_t destination;
+    bool isValid = true;
+
+    ( void ) memset( &source, 0, sizeof( source ) );
+    ( void ) memset( &destination, 0, sizeof( destination ) );
+
+    /* Find the start of the IP packet. */
+    switch( pPacket->linkType )
+    {
+        case PCAP_LINKTYPE_ETHERNET:
+            offset = 14U;
+            etherType = ( length >= offset ) ? readBigEndian16( &pData[ 12 ] ) : 0U;
+
+            /* Skip VLAN tags. */
+            while( ( ( etherType == 0x8100U ) || ( etherType == 0x88A8U ) ) && ( length >= ( offset + 4U ) ) )
+            {
+                etherType = readBigEndian16( &pData[ offset + 2U ] );
+                offset += 4U;
+            }
+
+            break;
+
+        case PCAP_LINKTYPE_LINUX_SLL:
+            offset = 16U;
+            etherType = ( length >= offset ) ? readBigEndian16( &pData[ 14 ] ) : 0U;
+            break;
+
+        case PCAP_LINKTYPE_LINUX_SLL2:
+            offset = 20U;
+            etherType = ( length >= offset ) ? readBigEndian16( pData ) : 0U;
+            break;
+
+        case PCAP_LINKTYPE_NULL:
+            /* The address family is in the byte order of the capturing host,
+             * and IP packets are told apart by their version instead. */
+            offset = 4U;
+            break;
+
+        case PCAP_LINKTYPE_RAW:
+        case PCAP_LINKTYPE_RAW_OLD:
+        case PCAP_LINKTYPE_IPV4:
+        case PCAP_LINKTYPE_IPV6:
+            break;
+
+        default:
+            isValid = false;
+            break;
+    }
+
+    if( ( isValid == false ) || ( length <= offset ) )
+    {
+        isValid = false;
+    }
+    else if( ( etherType != 0U ) && ( etherType != 0x0800U ) && ( etherType != 0x86DDU ) )
+    {
+        isValid = false;
+    }
+    else
+    {
+        version = pData[ offset ] >> 4;
+
+        if( ( version == 4U ) && ( length >= ( offset + 20U ) ) )
+        {
+            headerLength = ( size_t ) ( pData[ offset ] & 0x0FU ) * 4U;
+            protocol = pData[ offset + 9U ];
+
+            /* Fragments other than the first cannot be decoded. */
+            isValid = ( headerLength >= 20U ) &&
+                      ( ( readBigEndian16( &pData[ offset + 6U ] ) & 0x3FFFU ) == 0U );
+            source.family = 4U;
+            destination.family = 4U;
+            ( void ) memcpy( source.bytes, &pData[ offset + 12U ], 4U );
+            ( void ) memcpy( destination.bytes, &pData[ offset + 16U ], 4U );
+            offset += headerLength;
+        }
+        else if( ( version == 6U ) && ( length >= ( offset + 40U ) ) )
+        {
+            protocol = pData[ offset + 6U ];
+            source.family = 6U;
+            destination.family = 6U;
+            ( void ) memcpy( source.bytes, &pData[ offset + 8U ], 16U );
+            ( void ) memcpy( destination.bytes, &pData[ offset + 24U ], 16U );
+            offset += 40U;
+
+            /* Skip the hop-by-hop, routing and destination options headers. */
+            while( ( ( protocol == 0U ) || ( protocol == 43U ) || ( protocol == 60U ) ) &&
+                   ( length >= ( offset + 8U ) ) )
+            {
+                protocol = pData[ offset ];
+                offset += ( ( size_t ) pData[ offset + 1U ] + 1U ) * 8U;
+            }
+        }
+        else
+        {
+            isValid = false;
+        }
+    }
+
+    /* The UDP header is followed by at least an NTP packet without extensions. */
+    if( ( isValid == false ) || ( protocol != 17U ) ||
+        ( length < ( offset + 8U + SNTP_PACKET_BASE_SIZE ) ) )
+    {
+        isValid = false;
+    }
+    else
+    {
+        sourcePort = readBigEndian16( &pData[ offset ] );
+        destinationPort = readBigEndian16( &pData[ offset + 2U ] );
+        offset += 8U;
+        mode = pData[ offset ] & 0x07U;
+
+        if( ( mode == NTP_MODE_CLIENT ) && ( destinationPort == NTP_PORT ) )
+        {
+            pEvent->isRequest = true;
+            pEvent->client = source;
+            pEvent->server = destination;
+            pEvent->clientPort = sourcePort;
+            pEvent->serverPort = destinationPort;
+        }
+        else if( ( mode == NTP_MODE_SERVER ) && ( sourcePort == NTP_PORT ) )
+        {
+            pEvent->isRequest = false;
+            pEvent->client = destination;
+            pEvent->server = source;
+            pEvent->clientPort = destinationPort;
+            pEvent->serverPort = sourcePort;
+        }
+        else
+        {
+            isValid = false;
+        }
+
+        pEvent->captureTimeNs = pPacket->timestampNs;
+        ( void ) memcpy( pEvent->payload, &pData[ offset ], SNTP_PACKET_BASE_SIZE );
+    }
+
+    return isValid;
+}
+
+/**
+ * @brief Adds a value to running statistics.
+ */
+static void addValue( RunningStats_t * pStats,
+                      double value )
+{
+    double delta = value - pStats->mean;
+
+    pStats->min = ( ( pStats->count == 0U ) || ( value < pStats->min ) ) ? value : pStats->min;
+    pStats->max = ( ( pStats->count == 0U ) || ( value > pStats->max ) ) ? value : pStats->max;
+    pStats->count++;
+    pStats->mean += delta / ( double ) pStats->count;
+    pStats->m2 += delta * ( value - pStats->mean );
+}
+
+/**
+ * @brief Combines running statistics (Chan's parallel algorithm).
+ */
+static void mergeStats( RunningStats_t * pTotal,
+                        const RunningStats_t * pPart )
+{
+    double count;
+    double delta;
+
+    if( pPart->count > 0U )
+    {
+        count = ( double ) pTotal->count + ( double ) pPart->count;
+        delta = pPart->mean - pTotal->mean;
+
+        pTotal->min = ( ( pTotal->count == 0U ) || ( pPart->min < pTotal->min ) ) ? pPart->min : pTotal->min;
+        pTotal->max = ( ( pTotal->count == 0U ) || ( pPart->max > pTotal->max ) ) ? pPart->max : pTotal->max;
+        pTotal->m2 += pPart->m2 + ( delta * delta * ( double ) pTotal->count * ( double ) pPart->count / count );
+        pTotal->mean += delta * ( double ) pPart->count / count;
+        pTotal->count += pPart->count;
+    }
+}
+
+/**
+ * @brief Finds the statistics of a server, adding the server if needed.
+ */
+static ServerStats_t * findServer( ServerTable_t * pTable,
+                                   const NtpAddress_t * pAddress )
+{
+    uint32_t index = hashBytes( 2166136261U, ( const uint8_t * ) pAddress, sizeof( NtpAddress_t ) ) % MAX_SERVERS;
+    ServerStats_t * pStats = NULL;
+    uint32_t probes;
+
+    if( pAddress->family == 0U )
+    {
+        pStats = &pTable->others;
+    }
+
+    for( probes = 0U; ( probes < MAX_SERVERS ) && ( pStats == NULL ); probes++ )
+    {
+        if( pTable->entries[ index ].inUse == false )
+        {
+            pStats = &pTable->entries[ index ];
+            pStats->inUse = true;
+            pStats->address = *pAddress;
+        }
+        else if( memcmp( &pTable->entries[ index ].address, pAddress, sizeof( NtpAddress_t ) ) == 0 )
+        {
+            pStats = &pTable->entries[ index ];
+        }
+        else
+        {
+            index = ( index + 1U ) % MAX_SERVERS;
+        }
+    }
+
+    return ( pStats != NULL ) ? pStats : &pTable->others;
+}
+
+/**
+ * @brief Records an outstanding request.
+ */
+static void addRequest( Worker_t * pWorker,
+                        const NtpEvent_t * pEvent )
+{
+    uint32_t hash = hashFlow( &pEvent->client, &pEvent->server, pEvent->clientPort, pEvent->serverPort );
+    PendingRequest_t * pBucket;
+    PendingRequest_t * pEntry;
+    size_t way;
+
+    hash = hashBytes( hash, &pEvent->payload[ NTP_TX_TIME_OFFSET ], 8U );
+    pBucket = pWorker->pPending[ hash % PENDING_BUCKETS ];
+    pEntry = &pBucket[ 0 ];
+
+    /* Use a free entry, or else the oldest. */
+    for( way = 0U; ( way < PENDING_WAYS ) && ( pEntry->inUse == true ); way++ )
+    {
+        if( ( pBucket[ way ].inUse == false ) || ( pBucket[ way ].captureTimeNs < pEntry->captureTimeNs ) )
+        {
+            pEntry = &pBucket[ way ];
+        }
+    }
+
+    if( pEntry->inUse == true )
+    {
+        findServer( pWorker->pServers, &pEntry->server )->unanswered++;
+    }
+
+    pEntry->inUse = true;
+    pEntry->client = pEvent->client;
+    pEntry->server = pEvent->server;
+    pEntry->clientPort = pEvent->clientPort;
+    pEntry->serverPort = pEvent->serverPort;
+    pEntry->captureTimeNs = pEvent->captureTimeNs;
+    ( void ) memcpy( pEntry->txTime, &pEvent->payload[ NTP_TX_TIME_OFFSET ], 8U );
+
+    findServer( pWorker->pServers, &pEvent->server )->requests++;
+}
+
+/**
+ * @brief Finds and removes the outstanding request of a response.
+ *
+ * @return `true` if the request is found, and copied to @p pRequest.
+ */
+static bool takeRequest( Worker_t * pWorker,
+                         const NtpEvent_t * pEvent,
+                         PendingRequest_t * pRequest )
+{
+    uint32_t hash = hashFlow( &pEvent->client, &pEvent->server, pEvent->clientPort, pEvent->serverPort );
+    PendingRequest_t * pBucket;
+    bool found = false;
+    size_t way;
+
+    /* The origin timestamp of the response is the transmit timestamp of the
+     * request. */
+    hash = hashBytes( hash, &pEvent->payload[ NTP_ORIGIN_TIME_OFFSET ], 8U );
+    pBucket = pWorker->pPending[ hash % PENDING_BUCKETS ];
+
+    for( way = 0U; ( way < PENDING_WAYS ) && ( found == false ); way++ )
+    {
+        if( ( pBucket[ way ].inUse == true ) &&
+            ( memcmp( pBucket[ way ].txTime, &pEvent->payload[ NTP_ORIGIN_TIME_OFFSET ], 8U ) == 0 ) &&
+            ( memcmp( &pBucket[ way ].client, &pEvent->client, sizeof( NtpAddress_t ) ) == 0 ) &&
+            ( memcmp( &pBucket[ way ].server, &pEvent->server, sizeof( NtpAddress_t ) ) == 0 ) &&
+            ( pBucket[ way ].clientPort == pEvent->clientPort ) &&
+            ( pBucket[ way ].serverPort == pEvent->serverPort ) &&
+            ( ( pEvent->captureTimeNs - pBucket[ way ].captureTimeNs ) <= PENDING_TIMEOUT_NS ) )
+        {
+            *pRequest = pBucket[ way ];
+            pBucket[ way ].inUse = false;
+            found = true;
+        }
+    }
+
+    return found;
+}
+
+/**
+ * @brief Processes a response paired with its request.
+ */
+static void processResponse( Worker_t * pWorker,
+                             const NtpEvent_t * pEvent,
+                             const PendingRequest_t * pRequest )
+{
+    ServerStats_t * pStats = findServer( pWorker->pServers, &pEvent->server );
+    SntpTimestamp_t requestTime;
+    SntpTimestamp_t responseRxTime;
+    SntpResponseData_t parsedResponse;
+    int64_t elapsedNs = pEvent->captureTimeNs - pRequest->captureTimeNs;
+    uint64_t time;
+
+    /* The response receive time, in the client clock, is the request time
+     * advanced by the time between the captures. */
+    elapsedNs = ( elapsedNs < 0 ) ? 0 : elapsedNs;
+    requestTime.seconds = readBigEndian32( pRequest->txTime );
+    requestTime.fractions = readBigEndian32( &pRequest->txTime[ 4 ] );
+    time = ( ( uint64_t ) requestTime.seconds << 32 ) | requestTime.fractions;
+    time += ( ( uint64_t ) ( elapsedNs / NANOSECONDS_PER_SECOND ) << 32 ) +
+            ( ( ( uint64_t ) ( elapsedNs % NANOSECONDS_PER_SECOND ) << 32 ) / ( uint64_t ) NANOSECONDS_PER_SECOND );
+    responseRxTime.seconds = ( uint32_t ) ( time >> 32 );
+    responseRxTime.fractions = ( uint32_t ) time;
+
+    pStats->responses++;
+
+    switch( Sntp_DeserializeResponse( &requestTime, &responseRxTime, pEvent->payload,
+                                      SNTP_PACKET_BASE_SIZE, &parsedResponse ) )
+    {
+        case SntpSuccess:
+            addValue( &pStats->offsetMs, ( double ) parsedResponse.clockOffsetFractions * 1000.0 / FRACTIONS_PER_SECOND );
+            addValue( &pStats->delayMs, ( double ) parsedResponse.roundTripDelayFractions * 1000.0 / FRACTIONS_PER_SECOND );
+            break;
+
+        case SntpClockOffsetOverflow:
+            pStats->offsetOverflows++;
+            addValue( &pStats->delayMs, ( double ) parsedResponse.roundTripDelayFractions * 1000.0 / FRACTIONS_PER_SECOND );
+            break;
+
+        case SntpRejectedResponseChangeServer:
+        case SntpRejectedResponseRetryWithBackoff:
+        case SntpRejectedResponseOtherCode:
+
+            if( parsedResponse.rejectedResponseCode == KOD_DENY )
+            {
+                pStats->kodDeny++;
+            }
+            else if( parsedResponse.rejectedResponseCode == KOD_RSTR )
+            {
+                pStats->kodRstr++;
+            }
+            else if( parsedResponse.rejectedResponseCode == KOD_RATE )
+            {
+                pStats->kodRate++;
+            }
+            else
+            {
+                pStats->kodOther++;
+            }
+
+            break;
+
+        default:
+            pStats->invalid++;
+            break;
+    }
+}
+
+/**
+ * @brief The thread function of a worker.
+ */
+static void * runWorker( void * pArgument )
+{
+    Worker_t * pWorker = pArgument;
+    EventBatch_t * pBatch;
+    PendingRequest_t request;
+    bool running = true;
+    size_t i;
+
+    while( running == true )
+    {
+        ( void ) pthread_mutex_lock( &pWorker->lock );
+
+        while( ( pWorker->queued == 0U ) && ( pWorker->done == false ) )
+        {
+            ( void ) pthread_cond_wait( &pWorker->changed, &pWorker->lock );
+        }
+
+        running = ( pWorker->queued > 0U );
+        pBatch = &pWorker->batches[ pWorker->head ];
+        ( void ) pthread_mutex_unlock( &pWorker->lock );
+
+        if( running == true )
+        {
+            for( i = 0U; i < pBatch->count; i++ )
+            {
+                if( pBatch->events[ i ].isRequest == true )
+                {
+                    addRequest( pWorker, &pBatch->events[ i ] );
+                }
+                else if( takeRequest( pWorker, &pBatch->events[ i ], &request ) == true )
+                {
+                    processResponse( pWorker, &pBatch->events[ i ], &request );
+                }
+                else
+                {
+                    findServer( pWorker->pServers, &pBatch->events[ i ].server )->unmatched++;
+                }
+            }
+
+            ( void ) pthread_mutex_lock( &pWorker->lock );
+            pWorker->head = ( pWorker->head + 1U ) % BATCHES_PER_WORKER;
+            pWorker->queued--;
+            ( void ) pthread_cond_broadcast( &pWorker->changed );
+            ( void ) pthread_mutex_unlock( &pWorker->lock );
+        }
+    }
+
+    /* The requests still outstanding are unanswered. */
+    for( i = 0U; i < ( PENDING_BUCKETS * PENDING_WAYS ); i++ )
+    {
+        if( pWorker->pPending[ i / PENDING_WAYS ][ i % PENDING_WAYS ].inUse == true )
+        {
+            findServer( pWorker->pServers, &pWorker->pPending[ i / PENDING_WAYS ][ i % PENDING_WAYS ].server )->unanswered++;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Returns the batch of a worker that the reader fills.
+ */
+static EventBatch_t * getFillBatch( Worker_t * pWorker )
+{
+    return &pWorker->batches[ pWorker->tail ];
+}
+
+/**
+ * @brief Hands the batch being filled to a worker, and waits for the next
+ * batch to be free.
+ */
+static void queueBatch( Worker_t * pWorker )
+{
+    ( void ) pthread_mutex_lock( &pWorker->lock );
+    pWorker->queued++;
+    pWorker->tail = ( pWorker->tail + 1U ) % BATCHES_PER_WORKER;
+    ( void ) pthread_cond_broadcast( &pWorker->changed );
+
+    while( pWorker->queued == BATCHES_PER_WORKER )
+    {
+        ( void ) pthread_cond_wait( &pWorker->changed, &pWorker->lock );
+    }
+
+    ( void ) pthread_mutex_unlock( &pWorker->lock );
+    getFillBatch( pWorker )->count = 0U;
+}
+
+/**
+ * @brief Formats an address for printing.
+ */
+static const char * formatAddress( const NtpAddress_t * pAddress,
+                                   char * pBuffer,
+                                   size_t bufferSize )
+{
+    if( pAddress->family == 0U )
+    {
+        ( void ) snprintf( pBuffer, bufferSize, "(other servers)" );
+    }
+    else if( inet_ntop( ( pAddress->family == 4U ) ? AF_INET : AF_INET6,
+                        pAddress->bytes, pBuffer, ( socklen_t ) bufferSize ) == NULL )
+    {
+        ( void ) snprintf( pBuffer, bufferSize, "?" );
+    }
+
+    return pBuffer;
+}
+
+/**
+ * @brief Orders servers by the number of responses, most first.
+ */
+static int compareServers( const void * pFirst,
+                           const void * pSecond )
+{
+    const ServerStats_t * pA = *( const ServerStats_t * const * ) pFirst;
+    const ServerStats_t * pB = *( const ServerStats_t * const * ) pSecond;
+
+    return ( pA->responses < pB->responses ) ? 1 : ( ( pA->responses > pB->responses ) ? -1 : 0 );
+}
+
+/**
+ * @brief Prints the statistics of the servers.
+ */
+static void printServers( ServerTable_t * pTable,
+                          bool csv )
+{
+    static ServerStats_t * sorted[ MAX_SERVERS + 1U ];
+    char address[ INET6_ADDRSTRLEN ];
+    const ServerStats_t * pStats;
+    size_t numOfServers = 0U;
+    size_t i;
+
+    for( i = 0U; i < MAX_SERVERS; i++ )
+    {
+        if( pTable->entries[ i ].inUse == true )
+        {
+            sorted[ numOfServers ] = &pTable->entries[ i ];
+            numOfServers++;
+        }
+    }
+
+    if( ( pTable->others.requests > 0U ) || ( pTable->others.responses > 0U ) || ( pTable->others.unmatched > 0U ) )
+    {
+        sorted[ numOfServers ] = &pTable->others;
+        numOfServers++;
+    }
+
+    qsort( sorted, numOfServers, sizeof( sorted[ 0 ] ), compareServers );
+
+    if( csv == true )
+    {
+        printf( "server,requests,responses,unanswered,unmatched,invalid,offset_overflow,"
+                "kod_deny,kod_rstr,kod_rate,kod_other,offset_samples,offset_mean_ms,offset_sd_ms,"
+                "offset_min_ms,offset_max_ms,delay_mean_ms,delay_min_ms,delay_max_ms\n" );
+    }
+    else
+    {
+        printf( "%-39s %9s %9s %9s %9s %7s %23s %31s %29s\n",
+                "server", "requests", "responses", "unanswrd", "unmatched", "invalid",
+                "kod deny/rstr/rate/other", "offset ms mean/sd/min/max", "delay ms mean/min/max" );
+    }
+
+    for( i = 0U; i < numOfServers; i++ )
+    {
+        pStats = sorted[ i ];
+        ( void ) formatAddress( &pStats->address, address, sizeof( address ) );
+
+        if( csv == true )
+        {
+            printf( "%s,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f\n",
+                    address,
+                    ( unsigned long long ) pStats->requests, ( unsigned long long ) pStats->responses,
+                    ( unsigned long long ) pStats->unanswered, ( unsigned long long ) pStats->unmatched,
+                    ( unsigned long long ) pStats->invalid, ( unsigned long long ) pStats->offsetOverflows,
+                    ( unsigned long long ) pStats->kodDeny, ( unsigned long long ) pStats->kodRstr,
+                    ( unsigned long long ) pStats->kodRate, ( unsigned long long ) pStats->kodOther,
+                    ( unsigned long long ) pStats->offsetMs.count, pStats->offsetMs.mean,
+                    ( pStats->offsetMs.count > 1U ) ? sqrt( pStats->offsetMs.m2 / ( double ) ( pStats->offsetMs.count - 1U ) ) : 0.0,
+                    pStats->offsetMs.min, pStats->offsetMs.max,
+                    pStats->delayMs.mean, pStats->delayMs.min, pStats->delayMs.max );
+        }
+        else
+        {
+            printf( "%-39s %9llu %9llu %9llu %9llu %7llu %5llu/%5llu/%5llu/%5llu %7.3f/%7.3f/%7.3f/%7.3f %9.3f/%9.3f/%9.3f\n",
+                    address,
+                    ( unsigned long long ) pStats->requests, ( unsigned long long ) pStats->responses,
+                    ( unsigned long long ) pStats->unanswered, ( unsigned long long ) pStats->unmatched,
+                    ( unsigned long long ) pStats->invalid,
+                    ( unsigned long long ) pStats->kodDeny, ( unsigned long long ) pStats->kodRstr,
+                    ( unsigned long long ) pStats->kodRate, ( unsigned long long ) pStats->kodOther,
+                    pStats->offsetMs.mean,
+                    ( pStats->offsetMs.count > 1U ) ? sqrt( pStats->offsetMs.m2 / ( double ) ( pStats->offsetMs.count - 1U ) ) : 0.0,
+                    pStats->offsetMs.min, pStats->offsetMs.max,
+                    pStats->delayMs.mean, pStats->delayMs.min, pStats->delayMs.max );
+        }
+    }
+}
+
+/**
+ * @brief Prints the usage of the program.
+ */
+static void printUsage( const char * pProgram )
+{
+    fprintf( stderr,
+             "Usage: %s [-j threads] [-c] <capture.pcap|capture.pcapng|->\n"
+             "  -j threads  Number of worker threads (default: number of cores).\n"
+             "  -c          Print CSV instead of a table.\n",
+             pProgram );
+}
+
+int main( int argc,
+          char ** argv )
+{
+    static Worker_t workers[ MAX_WORKERS ];
+    static ServerTable_t total;
+    PcapReader_t reader;
+    PcapPacket_t packet;
+    PcapStatus_t status;
+    NtpEvent_t * pEvent;
+    EventBatch_t * pBatch;
+    Worker_t * pWorker;
+    long numOfCores = sysconf( _SC_NPROCESSORS_ONLN );
+    size_t numOfWorkers = ( numOfCores > 1L ) ? ( size_t ) numOfCores : 1U;
+    unsigned long long numOfPackets = 0U;
+    unsigned long long numOfNtpPackets = 0U;
+    bool csv = false;
+    int option;
+    size_t i;
+    size_t j;
+
+    while( ( option = getopt( argc, argv, "j:ch" ) ) != -1 )
+    {
+        if( option == 'j' )
+        {
+            numOfWorkers = ( size_t ) strtoul( optarg, NULL, 10 );
+        }
+        else if( option == 'c' )
+        {
+            csv = true;
+        }
+        else
+        {
+            printUsage( argv[ 0 ] );
+            return EXIT_FAILURE;
+        }
+    }
+
+    if( optind != ( argc - 1 ) )
+    {
+        printUsage( argv[ 0 ] );
+        return EXIT_FAILURE;
+    }
+
+    numOfWorkers = ( numOfWorkers < 1U ) ? 1U : ( ( numOfWorkers > MAX_WORKERS ) ? MAX_WORKERS : numOfWorkers );
+    status = PcapReader_Open( &reader, argv[ optind ] );
+
+    if( status != PcapSuccess )
+    {
+        fprintf( stderr, "%s: cannot read capture (error %d).\n", argv[ optind ], ( int ) status );
+        return EXIT_FAILURE;
+    }
+
+    for( i = 0U; i < numOfWorkers; i++ )
+    {
+        pWorker = &workers[ i ];
+        pWorker->pPending = calloc( PENDING_BUCKETS, sizeof( pWorker->pPending[ 0 ] ) );
+        pWorker->pServers = calloc( 1U, sizeof( ServerTable_t ) );
+
+        if( ( pWorker->pPending == NULL ) || ( pWorker->pServers == NULL ) )
+        {
+            fprintf( stderr, "Out of memory.\n" );
+            return EXIT_FAILURE;
+        }
+
+        ( void ) pthread_mutex_init( &pWorker->lock, NULL );
+        ( void ) pthread_cond_init( &pWorker->changed, NULL );
+        ( void ) pthread_create( &pWorker->thread, NULL, runWorker, pWorker );
+    }
+
+    /* Decode the packets, and hand them to the workers by flow. */
+    while( ( status = PcapReader_Next( &reader, &packet ) ) == PcapSuccess )
+    {
+        numOfPackets++;
+
+        /* The reader owns the batch after the queued batches of each worker. */
+        pWorker = &workers[ 0 ];
+        pBatch = getFillBatch( pWorker );
+        pEvent = &pBatch->events[ pBatch->count ];
+
+        if( decodePacket( &packet, pEvent ) == true )
+        {
+            numOfNtpPackets++;
+            pWorker = &workers[ hashFlow( &pEvent->client, &pEvent->server,
+                                          pEvent->clientPort, pEvent->serverPort ) % numOfWorkers ];
+
+            if( pWorker != &workers[ 0 ] )
+            {
+                pBatch = getFillBatch( pWorker );
+                pBatch->events[ pBatch->count ] = *pEvent;
+            }
+
+            pBatch->count++;
+
+            if( pBatch->count == BATCH_SIZE )
+            {
+                queueBatch( pWorker );
+            }
+        }
+    }
+
+    if( status != PcapEndOfFile )
+    {
+        fprintf( stderr, "%s: capture is truncated or corrupt (error %d); "
+                         "reporting the packets read so far.\n", argv[ optind ], ( int ) status );
+    }
+
+    for( i = 0U; i < numOfWorkers; i++ )
+    {
+        pWorker = &workers[ i ];
+
+        ( void ) pthread_mutex_lock( &pWorker->lock );
+
+        if( getFillBatch( pWorker )->count > 0U )
+        {
+            pWorker->queued++;
+        }
+
+        pWorker->done = true;
+        ( void ) pthread_cond_broadcast( &pWorker->changed );
+        ( void ) pthread_mutex_unlock( &pWorker->lock );
+    }
+
+    /* Merge the statistics of the workers. */
+    for( i = 0U; i < numOfWorkers; i++ )
+    {
+        ( void ) pthread_join( workers[ i ].thread, NULL );
+
+        for( j = 0U; j <= MAX_SERVERS; j++ )
+        {
+            const ServerStats_t * pPart = ( j < MAX_SERVERS ) ? &workers[ i ].pServers->entries[ j ] :
+                                          &workers[ i ].pServers->others;
+            ServerStats_t * pTotal;
+
+            if( ( pPart->inUse == true ) || ( j == MAX_SERVERS ) )
+            {
+                pTotal = findServer( &total, &pPart->address );
+                pTotal->requests += pPart->requests;
+                pTotal->responses += pPart->responses;
+                pTotal->unanswered += pPart->unanswered;
+                pTotal->unmatched += pPart->unmatched;
+                pTotal->invalid += pPart->invalid;
+                pTotal->offsetOverflows += pPart->offsetOverflows;
+                pTotal->kodDeny += pPart->kodDeny;
+                pTotal->kodRstr += pPart->kodRstr;
+                pTotal->kodRate += pPart->kodRate;
+                pTotal->kodOther += pPart->kodOther;
+                mergeStats( &pTotal->offsetMs, &pPart->offsetMs );
+                mergeStats( &pTotal->delayMs, &pPart->delayMs );
+            }
+        }
+
+        free( workers[ i ].pPending );
+        free( workers[ i ].pServers );
+    }
+
+    if( csv == false )
+    {
+        printf( "%llu packets, %llu NTP packets, %llu oversized packets skipped, %u worker threads\n\n",
+                numOfPackets, numOfNtpPackets, ( unsigned long long ) reader.skippedPackets,
+                ( unsigned int ) numOfWorkers );
+    }
+
+    printServers( &total, csv );
+    PcapReader_Close( &reader );
+
+    return EXIT_SUCCESS;
+}
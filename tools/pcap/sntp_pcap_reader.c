@@ -0,0 +1,555 @@
+/*
+ * coreSNTP v1.0.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file sntp_pcap_reader.c
+ * @brief Implementation of the streaming reader of pcap and pcapng files.
+ */
+
+/* Standard includes. */
+#include <stdlib.h>
+#include <string.h>
+
+/* Include reader header. */
+#include "sntp_pcap_reader.h"
+
+/**
+ * @brief The magic numbers of pcap files with microsecond and nanosecond
+ * timestamps, as read in little-endian byte order.
+ */
+#define PCAP_MAGIC_MICROSECONDS       ( 0xA1B2C3D4U )
+#define PCAP_MAGIC_NANOSECONDS        ( 0xA1B23C4DU )
+#define PCAP_MAGIC_MICROSECONDS_BE    ( 0xD4C3B2A1U )
+#define PCAP_MAGIC_NANOSECONDS_BE     ( 0x4D3CB2A1U )
+
+/**
+ * @brief The sizes of the pcap file header and record header.
+ */
+#define PCAP_FILE_HEADER_SIZE         ( 24U )
+#define PCAP_RECORD_HEADER_SIZE       ( 16U )
+
+/**
+ * @brief The pcapng block types read by the reader.
+ */
+#define PCAPNG_SECTION_HEADER_BLOCK   ( 0x0A0D0D0AU )
+#define PCAPNG_INTERFACE_BLOCK        ( 1U )
+#define PCAPNG_PACKET_BLOCK           ( 2U )
+#define PCAPNG_ENHANCED_PACKET_BLOCK  ( 6U )
+
+/**
+ * @brief The byte order magic of pcapng section headers, as read in
+ * little-endian byte order.
+ */
+#define PCAPNG_BYTE_ORDER_MAGIC       ( 0x1A2B3C4DU )
+#define PCAPNG_BYTE_ORDER_MAGIC_BE    ( 0x4D3C2B1AU )
+
+/**
+ * @brief The pcapng interface options read by the reader.
+ */
+#define PCAPNG_OPTION_END             ( 0U )
+#define PCAPNG_OPTION_TSRESOL         ( 9U )
+#define PCAPNG_OPTION_TSOFFSET        ( 14U )
+
+/**
+ * @brief The default pcapng timestamp resolution, microseconds.
+ */
+#define PCAPNG_DEFAULT_TSRESOL        ( 6U )
+
+/**
+ * @brief The size of the fixed fields of the packet blocks, before the data.
+ */
+#define PCAPNG_PACKET_FIELDS_SIZE     ( 20U )
+
+/**
+ * @brief The largest pcapng block read into the buffer; larger blocks are
+ * skipped.
+ */
+#define PCAPNG_MAX_BLOCK_BODY_SIZE    ( PCAP_MAX_PACKET_SIZE + 256U )
+
+/**
+ * @brief The size of the stdio buffer of the capture file.
+ */
+#define FILE_BUFFER_SIZE              ( 1U << 20 )
+
+/**
+ * @brief The number of nanoseconds in a second.
+ */
+#define NANOSECONDS_PER_SECOND        ( 1000000000U )
+
+/**
+ * @brief Decodes a 16-bit value in the byte order of the file.
+ */
+static uint16_t read16( const PcapReader_t * pReader,
+                        const uint8_t * pData )
+{
+    return ( pReader->isBigEndian == true ) ?
+           ( uint16_t ) ( ( ( uint16_t ) pData[ 0 ] << 8 ) | pData[ 1 ] ) :
+           ( uint16_t ) ( ( ( uint16_t ) pData[ 1 ] << 8 ) | pData[ 0 ] );
+}
+
+/**
+ * @brief Decodes a 32-bit value in the byte order of the file.
+ */
+static uint32_t read32( const PcapReader_t * pReader,
+                        const uint8_t * pData )
+{
+    return ( pReader->isBigEndian == true ) ?
+           ( ( ( uint32_t ) pData[ 0 ] << 24 ) | ( ( uint32_t ) pData[ 1 ] << 16 ) |
+             ( ( uint32_t ) pData[ 2 ] << 8 ) | pData[ 3 ] ) :
+           ( ( ( uint32_t ) pData[ 3 ] << 24 ) | ( ( uint32_t ) pData[ 2 ] << 16 ) |
+             ( ( uint32_t ) pData[ 1 ] << 8 ) | pData[ 0 ] );
+}
+
+/**
+ * @brief Decodes a 32-bit value in little-endian byte order, for magic numbers.
+ */
+static uint32_t read32LittleEndian( const uint8_t * pData )
+{
+    return ( ( uint32_t ) pData[ 3 ] << 24 ) | ( ( uint32_t ) pData[ 2 ] << 16 ) |
+           ( ( uint32_t ) pData[ 1 ] << 8 ) | pData[ 0 ];
+}
+
+/**
+ * @brief Reads bytes from the file.
+ *
+ * @return #PcapSuccess if all bytes are read, #PcapEndOfFile if no byte is
+ * read at the end of the file, or #PcapErrorTruncated if only some are read.
+ */
+static PcapStatus_t readBytes( PcapReader_t * pReader,
+                               uint8_t * pBuffer,
+                               size_t length )
+{
+    size_t bytesRead = fread( pBuffer, 1U, length, pReader->pFile );
+
+    return ( bytesRead == length ) ? PcapSuccess :
+           ( ( bytesRead == 0U ) ? PcapEndOfFile : PcapErrorTruncated );
+}
+
+/**
+ * @brief Skips bytes of the file. The file may not be seekable (for example, a
+ * pipe), so the bytes are read through the buffer.
+ */
+static PcapStatus_t skipBytes( PcapReader_t * pReader,
+                               size_t length )
+{
+    PcapStatus_t status = PcapSuccess;
+    size_t chunk;
+
+    while( ( length > 0U ) && ( status == PcapSuccess ) )
+    {
+        chunk = ( length < PCAP_MAX_PACKET_SIZE ) ? length : PCAP_MAX_PACKET_SIZE;
+        status = ( readBytes( pReader, pReader->pBuffer, chunk ) == PcapSuccess ) ?
+                 PcapSuccess : PcapErrorTruncated;
+        length -= chunk;
+    }
+
+    return status;
+}
+
+/**
+ * @brief Converts a pcapng timestamp to nanoseconds.
+ *
+ * @param[in] timestamp The timestamp, in units of the resolution.
+ * @param[in] resolution The if_tsresol value of the interface.
+ *
+ * @return The timestamp in nanoseconds.
+ */
+static int64_t convertTimestamp( uint64_t timestamp,
+                                 uint8_t resolution )
+{
+    uint32_t exponent = ( uint32_t ) resolution & 0x7FU;
+    uint64_t scale = 1U;
+    uint64_t nanosecs;
+    uint64_t fraction;
+    uint32_t i;
+
+    if( ( resolution & 0x80U ) != 0U )
+    {
+        /* A resolution of 2^-exponent seconds. */
+        if( exponent >= 64U )
+        {
+            nanosecs = 0U;
+        }
+        else
+        {
+            fraction = timestamp & ( ( ( uint64_t ) 1U << exponent ) - 1U );
+            nanosecs = ( timestamp >> exponent ) * NANOSECONDS_PER_SECOND;
+
+            /* Keep the product of the fraction within 64 bits. */
+            nanosecs += ( exponent <= 32U ) ?
+                        ( ( fraction * NANOSECONDS_PER_SECOND ) >> exponent ) :
+                        ( ( ( fraction >> ( exponent - 32U ) ) * NANOSECONDS_PER_SECOND ) >> 32 );
+        }
+    }
+    else if( exponent <= 9U )
+    {
+        for( i = exponent; i < 9U; i++ )
+        {
+            scale *= 10U;
+        }
+
+        nanosecs = timestamp * scale;
+    }
+    else
+    {
+        for( i = 9U; ( i < exponent ) && ( i < 28U ); i++ )
+        {
+            scale *= 10U;
+        }
+
+        nanosecs = ( exponent < 28U ) ? ( timestamp / scale ) : 0U;
+    }
+
+    return ( int64_t ) nanosecs;
+}
+
+/**
+ * @brief Reads the rest of a pcapng section header block, after its type and
+ * length.
+ *
+ * @param[in, out] pReader The reader.
+ * @param[in] pRawLength The 4 bytes of the block length, which are decoded once
+ * the byte order of the section is known.
+ */
+static PcapStatus_t readSectionHeader( PcapReader_t * pReader,
+                                       const uint8_t * pRawLength )
+{
+    uint8_t byteOrderMagic[ 4 ];
+    PcapStatus_t status = readBytes( pReader, byteOrderMagic, sizeof( byteOrderMagic ) );
+    uint32_t magic = read32LittleEndian( byteOrderMagic );
+    uint32_t blockLength;
+
+    if( status == PcapEndOfFile )
+    {
+        status = PcapErrorTruncated;
+    }
+    else if( status != PcapSuccess )
+    {
+        /* Truncated. */
+    }
+    else if( ( magic != PCAPNG_BYTE_ORDER_MAGIC ) && ( magic != PCAPNG_BYTE_ORDER_MAGIC_BE ) )
+    {
+        status = PcapErrorFormat;
+    }
+    else
+    {
+        pReader->isBigEndian = ( magic == PCAPNG_BYTE_ORDER_MAGIC_BE );
+        pReader->numOfInterfaces = 0U;
+        blockLength = read32( pReader, pRawLength );
+
+        /* The type, length and byte order magic are read. */
+        status = ( ( blockLength < 28U ) || ( ( blockLength % 4U ) != 0U ) ) ?
+                 PcapErrorFormat : skipBytes( pReader, blockLength - 12U );
+    }
+
+    return status;
+}
+
+/**
+ * @brief Adds an interface from the body of a pcapng interface description
+ * block.
+ */
+static void addInterface( PcapReader_t * pReader,
+                          const uint8_t * pBody,
+                          size_t bodyLength )
+{
+    PcapInterface_t * pInterface;
+    size_t offset = 8U;
+    uint16_t optionCode;
+    uint16_t optionLength;
+    uint32_t high;
+    uint32_t low;
+
+    if( ( pReader->numOfInterfaces < PCAP_MAX_INTERFACES ) && ( bodyLength >= 8U ) )
+    {
+        pInterface = &pReader->interfaces[ pReader->numOfInterfaces ];
+        pReader->numOfInterfaces++;
+
+        pInterface->linkType = read16( pReader, pBody );
+        pInterface->tsResolution = PCAPNG_DEFAULT_TSRESOL;
+        pInterface->tsOffsetSecs = 0;
+
+        while( ( offset + 4U ) <= bodyLength )
+        {
+            optionCode = read16( pReader, &pBody[ offset ] );
+            optionLength = read16( pReader, &pBody[ offset + 2U ] );
+            offset += 4U;
+
+            if( ( optionCode == PCAPNG_OPTION_END ) || ( ( offset + optionLength ) > bodyLength ) )
+            {
+                break;
+            }
+
+            if( ( optionCode == PCAPNG_OPTION_TSRESOL ) && ( optionLength >= 1U ) )
+            {
+                pInterface->tsResolution = pBody[ offset ];
+            }
+            else if( ( optionCode == PCAPNG_OPTION_TSOFFSET ) && ( optionLength >= 8U ) )
+            {
+                high = read32( pReader, &pBody[ offset + ( ( pReader->isBigEndian == true ) ? 0U : 4U ) ] );
+                low = read32( pReader, &pBody[ offset + ( ( pReader->isBigEndian == true ) ? 4U : 0U ) ] );
+                pInterface->tsOffsetSecs = ( int64_t ) ( ( ( uint64_t ) high << 32 ) | low );
+            }
+            else
+            {
+                /* Other options are not used. */
+            }
+
+            /* Options are padded to 32 bits. */
+            offset += ( ( size_t ) optionLength + 3U ) & ~( size_t ) 3U;
+        }
+    }
+}
+
+/**
+ * @brief Reads the next packet of a pcap file.
+ */
+static PcapStatus_t readPcapPacket( PcapReader_t * pReader,
+                                    PcapPacket_t * pPacket )
+{
+    uint8_t header[ PCAP_RECORD_HEADER_SIZE ];
+    PcapStatus_t status;
+    uint32_t capturedLength;
+    bool found = false;
+
+    do
+    {
+        status = readBytes( pReader, header, sizeof( header ) );
+
+        if( status == PcapSuccess )
+        {
+            capturedLength = read32( pReader, &header[ 8 ] );
+
+            if( capturedLength > PCAP_MAX_PACKET_SIZE )
+            {
+                pReader->skippedPackets++;
+                status = skipBytes( pReader, capturedLength );
+            }
+            else
+            {
+                status = readBytes( pReader, pReader->pBuffer, capturedLength );
+                status = ( status == PcapEndOfFile ) ? PcapErrorTruncated : status;
+                found = true;
+            }
+        }
+    } while( ( status == PcapSuccess ) && ( found == false ) );
+
+    if( status == PcapSuccess )
+    {
+        pPacket->timestampNs = ( ( int64_t ) read32( pReader, header ) * NANOSECONDS_PER_SECOND ) +
+                               ( ( pReader->isNanosecond == true ) ?
+                                 ( int64_t ) read32( pReader, &header[ 4 ] ) :
+                                 ( ( int64_t ) read32( pReader, &header[ 4 ] ) * 1000 ) );
+        pPacket->linkType = pReader->linkType;
+        pPacket->pData = pReader->pBuffer;
+        pPacket->capturedLength = capturedLength;
+    }
+
+    return status;
+}
+
+/**
+ * @brief Reads the next packet of a pcapng file.
+ */
+static PcapStatus_t readPcapngPacket( PcapReader_t * pReader,
+                                      PcapPacket_t * pPacket )
+{
+    uint8_t header[ 8 ];
+    PcapStatus_t status;
+    uint32_t blockType;
+    uint32_t bodyLength;
+    uint32_t interfaceId;
+    uint32_t capturedLength;
+    const PcapInterface_t * pInterface;
+    uint64_t timestamp;
+    bool found = false;
+
+    do
+    {
+        status = readBytes( pReader, header, sizeof( header ) );
+        blockType = read32( pReader, header );
+
+        if( status != PcapSuccess )
+        {
+            /* End of file, or truncated. */
+        }
+        else if( blockType == PCAPNG_SECTION_HEADER_BLOCK )
+        {
+            status = readSectionHeader( pReader, &header[ 4 ] );
+        }
+        else
+        {
+            bodyLength = read32( pReader, &header[ 4 ] );
+
+            if( ( bodyLength < 12U ) || ( ( bodyLength % 4U ) != 0U ) )
+            {
+                status = PcapErrorFormat;
+            }
+            else
+            {
+                /* The body is followed by the repeated block length. */
+                bodyLength -= 12U;
+
+                if( bodyLength > PCAPNG_MAX_BLOCK_BODY_SIZE )
+                {
+                    pReader->skippedPackets += ( ( blockType == PCAPNG_ENHANCED_PACKET_BLOCK ) ||
+                                                 ( blockType == PCAPNG_PACKET_BLOCK ) ) ? 1U : 0U;
+                    status = skipBytes( pReader, ( size_t ) bodyLength + 4U );
+                }
+                else
+                {
+                    status = readBytes( pReader, pReader->pBuffer, ( size_t ) bodyLength + 4U );
+                    status = ( status == PcapEndOfFile ) ? PcapErrorTruncated : status;
+                }
+            }
+
+            if( ( status != PcapSuccess ) || ( bodyLength > PCAPNG_MAX_BLOCK_BODY_SIZE ) )
+            {
+                /* Error, or a skipped block. */
+            }
+            else if( blockType == PCAPNG_INTERFACE_BLOCK )
+            {
+                addInterface( pReader, pReader->pBuffer, bodyLength );
+            }
+            else if( ( ( blockType == PCAPNG_ENHANCED_PACKET_BLOCK ) || ( blockType == PCAPNG_PACKET_BLOCK ) ) &&
+                     ( bodyLength >= PCAPNG_PACKET_FIELDS_SIZE ) )
+            {
+                interfaceId = ( blockType == PCAPNG_ENHANCED_PACKET_BLOCK ) ?
+                              read32( pReader, pReader->pBuffer ) :
+                              read16( pReader, pReader->pBuffer );
+                capturedLength = read32( pReader, &pReader->pBuffer[ 12 ] );
+
+                if( ( interfaceId < pReader->numOfInterfaces ) &&
+                    ( capturedLength <= ( bodyLength - PCAPNG_PACKET_FIELDS_SIZE ) ) )
+                {
+                    pInterface = &pReader->interfaces[ interfaceId ];
+                    timestamp = ( ( uint64_t ) read32( pReader, &pReader->pBuffer[ 4 ] ) << 32 ) |
+                                read32( pReader, &pReader->pBuffer[ 8 ] );
+
+                    pPacket->timestampNs = convertTimestamp( timestamp, pInterface->tsResolution ) +
+                                           ( pInterface->tsOffsetSecs * ( int64_t ) NANOSECONDS_PER_SECOND );
+                    pPacket->linkType = pInterface->linkType;
+                    pPacket->pData = &pReader->pBuffer[ PCAPNG_PACKET_FIELDS_SIZE ];
+                    pPacket->capturedLength = capturedLength;
+                    found = true;
+                }
+            }
+            else
+            {
+                /* Other blocks (including simple packet blocks, which have no
+                 * timestamp) are not used. */
+            }
+        }
+    } while( ( status == PcapSuccess ) && ( found == false ) );
+
+    return status;
+}
+
+PcapStatus_t PcapReader_Open( PcapReader_t * pReader,
+                              const char * pPath )
+{
+    PcapStatus_t status = PcapSuccess;
+    uint8_t header[ PCAP_FILE_HEADER_SIZE ];
+    uint32_t magic;
+
+    ( void ) memset( pReader, 0, sizeof( PcapReader_t ) );
+
+    if( strcmp( pPath, "-" ) == 0 )
+    {
+        pReader->pFile = stdin;
+    }
+    else
+    {
+        pReader->pFile = fopen( pPath, "rb" );
+        pReader->closeFile = true;
+    }
+
+    if( pReader->pFile == NULL )
+    {
+        status = PcapErrorOpen;
+    }
+    else
+    {
+        ( void ) setvbuf( pReader->pFile, NULL, _IOFBF, FILE_BUFFER_SIZE );
+        pReader->pBuffer = malloc( PCAPNG_MAX_BLOCK_BODY_SIZE + 4U );
+        status = ( pReader->pBuffer == NULL ) ? PcapErrorNoMemory : readBytes( pReader, header, 8U );
+    }
+
+    if( status == PcapSuccess )
+    {
+        magic = read32LittleEndian( header );
+
+        if( magic == PCAPNG_SECTION_HEADER_BLOCK )
+        {
+            pReader->isPcapng = true;
+            status = readSectionHeader( pReader, &header[ 4 ] );
+        }
+        else if( ( magic == PCAP_MAGIC_MICROSECONDS ) || ( magic == PCAP_MAGIC_NANOSECONDS ) ||
+                 ( magic == PCAP_MAGIC_MICROSECONDS_BE ) || ( magic == PCAP_MAGIC_NANOSECONDS_BE ) )
+        {
+            pReader->isBigEndian = ( magic == PCAP_MAGIC_MICROSECONDS_BE ) || ( magic == PCAP_MAGIC_NANOSECONDS_BE );
+            pReader->isNanosecond = ( magic == PCAP_MAGIC_NANOSECONDS ) || ( magic == PCAP_MAGIC_NANOSECONDS_BE );
+            status = readBytes( pReader, &header[ 8 ], PCAP_FILE_HEADER_SIZE - 8U );
+
+            /* The upper bits of the link type field hold FCS information. */
+            pReader->linkType = read32( pReader, &header[ 20 ] ) & 0xFFFFU;
+        }
+        else
+        {
+            status = PcapErrorFormat;
+        }
+    }
+    else if( status == PcapEndOfFile )
+    {
+        status = PcapErrorFormat;
+    }
+    else
+    {
+        /* Empty else MISRA 15.7 */
+    }
+
+    if( ( status != PcapSuccess ) && ( status != PcapErrorOpen ) )
+    {
+        PcapReader_Close( pReader );
+    }
+
+    return ( status == PcapEndOfFile ) ? PcapErrorTruncated : status;
+}
+
+PcapStatus_t PcapReader_Next( PcapReader_t * pReader,
+                              PcapPacket_t * pPacket )
+{
+    return ( pReader->isPcapng == true ) ? readPcapngPacket( pReader, pPacket ) :
+           readPcapPacket( pReader, pPacket );
+}
+
+void PcapReader_Close( PcapReader_t * pReader )
+{
+    if( ( pReader->pFile != NULL ) && ( pReader->closeFile == true ) )
+    {
+        ( void ) fclose( pReader->pFile );
+    }
+
+    free( pReader->pBuffer );
+    pReader->pFile = NULL;
+    pReader->pBuffer = NULL;
+}
@@ -0,0 +1,148 @@
+/*
+ * coreSNTP v1.0.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file sntp_pcap_reader.h
+ * @brief Streaming reader of packet capture files in the pcap and pcapng
+ * formats.
+ *
+ * The reader holds one packet at a time in a fixed-size buffer, so files of
+ * any size are read in constant memory. Packets larger than the buffer are
+ * skipped.
+ */
+
+#ifndef SNTP_PCAP_READER_H_
+#define SNTP_PCAP_READER_H_
+
+/* Standard includes. */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief The largest captured packet length that the reader returns.
+ */
+#define PCAP_MAX_PACKET_SIZE      ( 262144U )
+
+/**
+ * @brief The largest number of interfaces in a pcapng section.
+ */
+#define PCAP_MAX_INTERFACES       ( 64U )
+
+/**
+ * @brief The link types of captured packets supported by the analyzer.
+ */
+#define PCAP_LINKTYPE_NULL        ( 0U )   /**< @brief BSD loopback. */
+#define PCAP_LINKTYPE_ETHERNET    ( 1U )   /**< @brief Ethernet. */
+#define PCAP_LINKTYPE_RAW_OLD     ( 12U )  /**< @brief Raw IP on some platforms. */
+#define PCAP_LINKTYPE_RAW         ( 101U ) /**< @brief Raw IP. */
+#define PCAP_LINKTYPE_LINUX_SLL   ( 113U ) /**< @brief Linux cooked capture. */
+#define PCAP_LINKTYPE_IPV4        ( 228U ) /**< @brief Raw IPv4. */
+#define PCAP_LINKTYPE_IPV6        ( 229U ) /**< @brief Raw IPv6. */
+#define PCAP_LINKTYPE_LINUX_SLL2  ( 276U ) /**< @brief Linux cooked capture v2. */
+
+/**
+ * @brief The status codes of the reader.
+ */
+typedef enum PcapStatus
+{
+    PcapSuccess = 0,    /**< @brief A packet is returned. */
+    PcapEndOfFile,      /**< @brief There are no more packets. */
+    PcapErrorOpen,      /**< @brief The file cannot be opened. */
+    PcapErrorFormat,    /**< @brief The file is not a supported capture format. */
+    PcapErrorTruncated, /**< @brief The file ends in the middle of a record. */
+    PcapErrorNoMemory   /**< @brief The buffer cannot be allocated. */
+} PcapStatus_t;
+
+/**
+ * @brief The properties of an interface of a pcapng section.
+ */
+typedef struct PcapInterface
+{
+    uint32_t linkType;      /**< @brief The link type of the interface. */
+    uint8_t tsResolution;   /**< @brief The if_tsresol option: a power of 10, or of
+                             * 2 if the top bit is set. */
+    int64_t tsOffsetSecs;   /**< @brief The if_tsoffset option, in seconds. */
+} PcapInterface_t;
+
+/**
+ * @brief A packet read from a capture file.
+ */
+typedef struct PcapPacket
+{
+    int64_t timestampNs;     /**< @brief The capture time, in nanoseconds of UNIX time. */
+    uint32_t linkType;       /**< @brief The link type of the packet data. */
+    const uint8_t * pData;   /**< @brief The captured data, valid until the next read. */
+    uint32_t capturedLength; /**< @brief The length of the captured data. */
+} PcapPacket_t;
+
+/**
+ * @brief The state of a capture file reader.
+ */
+typedef struct PcapReader
+{
+    FILE * pFile;                                     /**< @brief The capture file. */
+    bool closeFile;                                   /**< @brief Whether the file is closed by the reader. */
+    uint8_t * pBuffer;                                /**< @brief The buffer of the current record. */
+    bool isPcapng;                                    /**< @brief Whether the file is pcapng. */
+    bool isBigEndian;                                 /**< @brief Whether the file (or pcapng
+                                                       * section) is in big-endian byte order. */
+    bool isNanosecond;                                /**< @brief Whether pcap timestamps are in
+                                                       * nanoseconds (rather than microseconds). */
+    uint32_t linkType;                                /**< @brief The link type of a pcap file. */
+    PcapInterface_t interfaces[ PCAP_MAX_INTERFACES ]; /**< @brief The interfaces of the pcapng section. */
+    uint32_t numOfInterfaces;                         /**< @brief The number of interfaces. */
+    uint64_t skippedPackets;                          /**< @brief The number of packets skipped
+                                                       * for being larger than the buffer. */
+} PcapReader_t;
+
+/**
+ * @brief Opens a capture file for reading, and reads its header.
+ *
+ * @param[out] pReader The reader to initialize.
+ * @param[in] pPath The path of the file, or "-" for the standard input.
+ *
+ * @return #PcapSuccess if the file is opened; otherwise, an error status.
+ */
+PcapStatus_t PcapReader_Open( PcapReader_t * pReader,
+                              const char * pPath );
+
+/**
+ * @brief Reads the next packet of a capture file.
+ *
+ * @param[in, out] pReader The reader.
+ * @param[out] pPacket This will be filled with the packet.
+ *
+ * @return #PcapSuccess if a packet is read, #PcapEndOfFile at the end of the
+ * file; otherwise, an error status.
+ */
+PcapStatus_t PcapReader_Next( PcapReader_t * pReader,
+                              PcapPacket_t * pPacket );
+
+/**
+ * @brief Closes a capture file reader.
+ *
+ * @param[in, out] pReader The reader.
+ */
+void PcapReader_Close( PcapReader_t * pReader );
+
+#endif /* ifndef SNTP_PCAP_READER_H_ */